@@ -0,0 +1,75 @@
+"""
+Command batching for the eyebrows driver.
+
+The submodules write their commands through `write_bytes_to_address()` here. Normally that writes
+straight away, but while a `CommandBatch` is open on the thread, the commands are kept instead, and
+`send()` sends them: one frame per MCU (see the cmds library's Frames), all in one
+I2C transfer. A latched batch stages its frames, and nothing happens until `commit()` (see the cmds
+library's Staged Frames), so several MCUs, or several drivers' MCUs, change together.
+"""
+from artie_i2c import i2c
+from artie_util import artie_logging as alog
+import threading
+
+# See the cmds library's cmds.h
+CMDS_FRAME_HEADER = 0xC0
+CMDS_FRAME_MAX_LEN = 0x3F
+CMDS_STAGE = CMDS_FRAME_HEADER
+CMDS_COMMIT = CMDS_FRAME_HEADER | (CMDS_FRAME_MAX_LEN - 1)
+
+# The I2C general call address. The eyebrow firmware answers it (cmds_accept_general_call()), so one commit reaches both.
+I2C_GENERAL_CALL_ADDRESS = 0x00
+
+_open_batch = threading.local()
+
+def write_bytes_to_address(address: int, data) -> bool:
+    """Write now, as i2c.write_bytes_to_address(), or keep the bytes for the open batch (and return True)."""
+    batch = getattr(_open_batch, "batch", None)
+    if batch is None:
+        return i2c.write_bytes_to_address(address, data)
+    batch.add(address, data)
+    return True
+
+def commit() -> bool:
+    """Have every MCU act on the frame it has staged. Returns False if we couldn't send the commit."""
+    return i2c.write_bytes_to_address(I2C_GENERAL_CALL_ADDRESS, CMDS_COMMIT)
+
+class CommandBatch:
+    """
+    Keeps the commands the submodules write on this thread while open (`with CommandBatch() as batch:`).
+    Call `send()` once they are all in.
+    """
+    def __init__(self) -> None:
+        self._commands: dict[int, list[int]] = {}
+
+    def __enter__(self) -> 'CommandBatch':
+        _open_batch.batch = self
+        return self
+
+    def __exit__(self, *exc):
+        _open_batch.batch = None
+
+    def add(self, address: int, data):
+        try:
+            self._commands.setdefault(address, []).extend(data)
+        except TypeError:
+            self._commands.setdefault(address, []).append(data)
+
+    def send(self, latch: bool) -> bool:
+        """
+        Send what we have, a frame per MCU, in one transfer. If `latch`, stage the frames instead, for
+        `commit()`. Returns False if we couldn't, in which case some MCUs may have had theirs.
+        """
+        writes = []
+        for address, commands in self._commands.items():
+            if latch:
+                commands = [CMDS_STAGE] + commands
+            if len(commands) > CMDS_FRAME_MAX_LEN:
+                # Only a staged frame must be one frame, but keeping to one each keeps the MCUs from seeing half a batch
+                alog.error(f"Too many commands for MCU 0x{address:02X} in one batch: {len(commands)} bytes, but a frame holds {CMDS_FRAME_MAX_LEN}.")
+                return False
+            writes.append(i2c.Write(address, [CMDS_FRAME_HEADER | len(commands)] + commands))
+
+        if not writes:
+            return True
+        return i2c.transfer(writes) is not None
@@ -18,6 +18,9 @@ MCU_ADDRESS_MAP = {
     EyebrowSides.RIGHT: board.I2C_ADDRESS_EYEBROWS_MCU_RIGHT,
 }
 
+# I2C bus rate (Hz) the eyebrow firmware is built for (its CMDS_I2C_BAUDRATE)
+MCU_I2C_SPEED_HZ = 100_000
+
 def get_address(side: str):
     """
     Return the address corresponding to the given `side`.
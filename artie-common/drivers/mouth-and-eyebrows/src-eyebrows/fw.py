@@ -39,6 +39,7 @@ class FirmwareSubmodule:
             self._set_mcu_status(mcu, constants.SubmoduleStatuses.NOT_WORKING)
             return False
         else:
+            i2c.negotiate_bus_speed(addr, ebcommon.MCU_I2C_SPEED_HZ)
             self._set_mcu_status(mcu, constants.SubmoduleStatuses.WORKING)
             return True
 
@@ -0,0 +1,203 @@
+"""
+Firmware log code for the eyebrows driver.
+
+The MCUs queue their log messages (see the errors library) instead of printing them, and we take
+them out over the command bus (CMD_QUERY_LOG) and log them here. Each message comes unformatted:
+the address of its format string and its arguments. The strings are read out of the firmware's ELF,
+so the MCU spends nothing on formatting and doesn't need USB.
+"""
+from artie_i2c import i2c
+from artie_util import artie_logging as alog
+from artie_util import util
+import dataclasses
+import re
+import struct
+import threading
+import time
+
+# See the firmware's board/types.h, cmds.h, and the errors library's errors.h
+CMD_QUERY_LOG = 0x2C
+CMDS_REGISTER_MAX_LEN = 32
+LOG_PACKED_HEADER_LEN = 2
+LOG_PACKED_RECORD_LEN = 10
+LOG_PACKED_FLAG_CORE1 = 0x04
+LOG_LEVEL_MASK = 0x03
+
+# How often to take each MCU's messages. It holds 16 a core, so this is about how fast it can log without dropping any.
+PULL_INTERVAL_S = 1.0
+
+# Time between asking for messages and reading them, for the MCU's main loop to load them
+RESPONSE_DELAY_S = 0.005
+
+# Most reads in one pull, so an MCU logging flat out doesn't keep us from the others
+MAX_READS_PER_PULL = 32
+
+# ELF section header flag for sections loaded into memory
+SHF_ALLOC = 0x2
+
+# A conversion specification, as the firmware's next_conversion() reads them
+CONVERSION = re.compile(r"%([-+ #0-9.]*)(hh|h|ll|l|j|z|t)?(.?)")
+
+@dataclasses.dataclass
+class LogMessage:
+    """One message, as log_pack() packed it."""
+    timestamp_us: int
+    core: int
+    level: int          # loglevel_t
+    format_address: int
+    args: bytes
+
+def unpack_messages(raw: list[int]) -> tuple[list[LogMessage], int]:
+    """What log_pack() wrote: its messages, and how many were dropped before them."""
+    count, dropped = raw[0], raw[1]
+    messages = []
+    pos = LOG_PACKED_HEADER_LEN
+    for _ in range(count):
+        if pos + LOG_PACKED_RECORD_LEN > len(raw):
+            raise ValueError(f"Says it holds {count} messages, but is only {len(raw)} bytes")
+        timestamp_us, format_address, flags, arglen = struct.unpack_from("<IIBB", bytes(raw), pos)
+        pos += LOG_PACKED_RECORD_LEN
+        if pos + arglen > len(raw):
+            raise ValueError(f"A message's arguments run past the end of its {len(raw)} bytes")
+        messages.append(LogMessage(timestamp_us, 1 if flags & LOG_PACKED_FLAG_CORE1 else 0, flags & LOG_LEVEL_MASK,
+                                   format_address, bytes(raw[pos:pos + arglen])))
+        pos += arglen
+    return messages, dropped
+
+class FirmwareStrings:
+    """The strings in a firmware image, by the address they are at on the MCU."""
+    def __init__(self, elf_fpath: str):
+        with open(elf_fpath, "rb") as f:
+            elf = f.read()
+        if elf[:4] != b"\x7fELF" or elf[5] != 1:
+            raise ValueError(f"{elf_fpath} is not a little-endian ELF file")
+
+        # Only the section headers matter: every section loaded into memory, where it is, and its bytes
+        if elf[4] == 1:
+            shoff, = struct.unpack_from("<I", elf, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+            header = "<IIIIII"
+        else:
+            shoff, = struct.unpack_from("<Q", elf, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", elf, 0x3A)
+            header = "<IIQQQQ"
+        self._sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(header, elf, shoff + i * shentsize)
+            # NOBITS sections (.bss) have nothing in the file
+            if flags & SHF_ALLOC and sh_type != 8 and size > 0:
+                self._sections.append((addr, elf[offset:offset + size]))
+
+    def string(self, address: int) -> str|None:
+        """The string at this address on the MCU, or None if it isn't in the image (one built at run time, say)."""
+        for start, data in self._sections:
+            if start <= address < start + len(data):
+                end = data.find(b"\0", address - start)
+                return data[address - start:end if end >= 0 else len(data)].decode("utf-8", errors="replace")
+        return None
+
+def format_message(message: LogMessage, strings: FirmwareStrings|None) -> str:
+    """The message as the MCU would have printed it. Conversions past the arguments it kept are left as written."""
+    fmt = strings.string(message.format_address) if strings is not None else None
+    if fmt is None:
+        return f"<format at 0x{message.format_address:08X}> {message.args.hex()}"
+
+    out = []
+    pos = 0
+    args = message.args
+    for match in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:match.start()])
+        pos = match.end()
+        flags, length, conversion = match.groups()
+        if conversion == "%":
+            out.append("%")
+            continue
+
+        size = 8 if length in ("ll", "j") or conversion in "fFeEgG" else 4
+        if not conversion or conversion not in "diouxXcfFeEgGsp" or len(args) < size:
+            # Nothing kept for it, so the rest as written
+            pos = match.start()
+            break
+        raw, args = args[:size], args[size:]
+
+        if conversion in "di":
+            value, = struct.unpack("<q" if size == 8 else "<i", raw)
+            out.append(f"%{flags}d" % value)
+        elif conversion in "fFeEgG":
+            value, = struct.unpack("<d", raw)
+            out.append(f"%{flags}{conversion}" % value)
+        elif conversion == "s":
+            address = int.from_bytes(raw, "little")
+            value = strings.string(address)
+            out.append(f"%{flags}s" % (value if value is not None else f"<0x{address:08X}>"))
+        elif conversion == "p":
+            out.append(f"0x{int.from_bytes(raw, 'little'):08X}")
+        else:
+            value = int.from_bytes(raw, "little")
+            out.append(f"%{flags}{'d' if conversion == 'u' else conversion}" % value)
+    out.append(fmt[pos:])
+    return "".join(out).rstrip("\n")
+
+class FirmwareLogPuller:
+    """
+    Takes every MCU's queued log messages every PULL_INTERVAL_S and logs them through alog, at their
+    own level, so the MCUs' logs end up alongside the driver's.
+    """
+    def __init__(self, mcu_addresses: dict[str, int], fw_fpath: str):
+        self._mcu_addresses = mcu_addresses
+        self._fw_fpath = fw_fpath
+        self._strings: FirmwareStrings = None
+        self._stop_event = threading.Event()
+        self._thread: threading.Thread = None
+
+    def start(self):
+        """Start pulling. Nothing to pull in test mode."""
+        if util.in_test_mode():
+            alog.test("Mocking MCU log pulling.", tests=[])
+            return
+
+        try:
+            self._strings = FirmwareStrings(self._fw_fpath)
+        except (OSError, ValueError) as e:
+            alog.warning(f"Can't read the format strings out of {self._fw_fpath} ({e}). MCU logs will show their addresses instead.")
+
+        self._thread = threading.Thread(target=self._pull, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        self._stop_event.set()
+
+    def _read(self, address: int) -> tuple[list[LogMessage], int]|None:
+        if not i2c.write_bytes_to_address(address, CMD_QUERY_LOG):
+            return None
+        time.sleep(RESPONSE_DELAY_S)
+        raw = i2c.read_bytes_from_address(address, CMDS_REGISTER_MAX_LEN)
+        if raw is None or len(raw) < LOG_PACKED_HEADER_LEN:
+            return None
+        try:
+            return unpack_messages(raw)
+        except ValueError as e:
+            alog.debug(f"Garbled log read: {e}")
+            return None
+
+    def _pull_mcu(self, mcu: str, address: int):
+        """Read until the MCU has nothing left (or MAX_READS_PER_PULL)."""
+        log_functions = [alog.debug, alog.info, alog.warning, alog.error]
+        for _ in range(MAX_READS_PER_PULL):
+            result = self._read(address)
+            if result is None:
+                alog.debug(f"Could not read logs from {mcu}.")
+                return
+            messages, dropped = result
+            if dropped:
+                alog.warning(f"[{mcu}] dropped {dropped} log messages before we read them.")
+            for message in messages:
+                log_functions[message.level](f"[{mcu} core {message.core} {message.timestamp_us / 1e6:.6f}] {format_message(message, self._strings)}")
+            if not messages:
+                return
+
+    def _pull(self):
+        while not self._stop_event.is_set():
+            for mcu, address in self._mcu_addresses.items():
+                self._pull_mcu(mcu, address)
+            self._stop_event.wait(PULL_INTERVAL_S)
@@ -1,8 +1,8 @@
 """
 All the code pertaining to the LCD submodule.
 """
+from . import batch
 from . import ebcommon
-from artie_i2c import i2c
 from artie_util import artie_logging as alog
 from artie_util import constants
 
@@ -61,7 +61,7 @@ class LcdSubmodule:
         alog.test(f"Received request for {side} LCD -> TEST.", tests=['eyebrows-driver-unit-tests:lcd-test'])
         address = ebcommon.get_address(side)
         lcd_test_bytes = CMD_MODULE_ID_LCD | 0x11
-        wrote = i2c.write_bytes_to_address(address, lcd_test_bytes)
+        wrote = batch.write_bytes_to_address(address, lcd_test_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_display_state = 'test'
         else:
@@ -73,7 +73,7 @@ class LcdSubmodule:
         alog.test(f"Received request for {side} LCD -> OFF.", tests=['eyebrows-driver-unit-tests:lcd-off'])
         address = ebcommon.get_address(side)
         lcd_off_bytes = CMD_MODULE_ID_LCD | 0x22
-        wrote = i2c.write_bytes_to_address(address, lcd_off_bytes)
+        wrote = batch.write_bytes_to_address(address, lcd_off_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_display_state = 'clear'
         else:
@@ -110,7 +110,7 @@ class LcdSubmodule:
                 eyebrow_state_bytes |= (0x01 << i)
 
         lcd_draw_bytes = CMD_MODULE_ID_LCD | eyebrow_state_bytes
-        wrote = i2c.write_bytes_to_address(address, lcd_draw_bytes)
+        wrote = batch.write_bytes_to_address(address, lcd_draw_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_display_state = eyebrow_state
         else:
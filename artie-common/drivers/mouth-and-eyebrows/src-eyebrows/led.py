@@ -1,8 +1,8 @@
 """
 Code pertaining to the LED Submodule.
 """
+from . import batch
 from . import ebcommon
-from artie_i2c import i2c
 from artie_util import artie_logging as alog
 from artie_util import constants
 import time
@@ -61,7 +61,7 @@ class LedSubmodule:
         alog.test(f"Received request for {side} LED -> ON.", tests=['eyebrows-driver-unit-tests:led-on'])
         address = ebcommon.get_address(side)
         led_on_bytes = CMD_MODULE_ID_LEDS | 0x00
-        wrote = i2c.write_bytes_to_address(address, led_on_bytes)
+        wrote = batch.write_bytes_to_address(address, led_on_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_led_state = constants.StatusLEDStates.ON
         else:
@@ -73,7 +73,7 @@ class LedSubmodule:
         alog.test(f"Received request for {side} LED -> OFF.", tests=['eyebrows-driver-unit-tests:led-off'])
         address = ebcommon.get_address(side)
         led_on_bytes = CMD_MODULE_ID_LEDS | 0x01
-        wrote = i2c.write_bytes_to_address(address, led_on_bytes)
+        wrote = batch.write_bytes_to_address(address, led_on_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_led_state = constants.StatusLEDStates.OFF
         else:
@@ -85,7 +85,7 @@ class LedSubmodule:
         alog.test(f"Received request for {side} LED -> HEARTBEAT.", tests=['eyebrows-driver-unit-tests:led-heartbeat'])
         address = ebcommon.get_address(side)
         led_heartbeat_bytes = CMD_MODULE_ID_LEDS | 0x02
-        wrote = i2c.write_bytes_to_address(address, led_heartbeat_bytes)
+        wrote = batch.write_bytes_to_address(address, led_heartbeat_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_led_state = constants.StatusLEDStates.HEARTBEAT
         else:
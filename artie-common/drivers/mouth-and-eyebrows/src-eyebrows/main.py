@@ -19,8 +19,10 @@ from artie_util import constants
 from artie_util import util
 from artie_service_client import artie_service
 from artie_service_client import interfaces
+from . import batch
 from . import ebcommon
 from . import fw
+from . import fwlog
 from . import lcd
 from . import led
 from . import metrics
@@ -55,6 +57,14 @@ class DriverServer(
         self._led_submodule.initialize()
         self._lcd_submodule.initialize()
 
+        # Publish the MCUs' own metrics
+        self._metrics_scraper = metrics.FirmwareMetricsScraper({side.value: address for side, address in ebcommon.MCU_ADDRESS_MAP.items()})
+        self._metrics_scraper.start()
+
+        # And their logs
+        self._log_puller = fwlog.FirmwareLogPuller({side.value: address for side, address in ebcommon.MCU_ADDRESS_MAP.items()}, fw_fpath)
+        self._log_puller.start()
+
     @rpyc.exposed
     @alog.function_counter("status", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.DriverInterfaceV1.__interface_name__})
     @interfaces.interface_method(interfaces.DriverInterfaceV1)
@@ -211,6 +221,54 @@ class DriverServer(
         """
         return self._lcd_submodule.off(side)
 
+    def _batch_operation(self, operation) -> bool:
+        """Carry out one of mcu_batch()'s operations (into the open batch). False if it isn't valid."""
+        try:
+            kind, which, value = operation
+            match kind:
+                case 'display':
+                    return self.display_set(which, value)
+                case 'display-clear':
+                    return self.display_clear(which)
+                case 'servo':
+                    return self.servo_set(which, float(value))
+                case 'led':
+                    return self.led_set(which, value)
+        except (TypeError, ValueError) as e:
+            alog.error(f"Invalid batch operation {operation}: {e}")
+            return False
+        alog.error(f"Invalid batch operation kind: {kind}")
+        return False
+
+    @rpyc.exposed
+    @alog.function_counter("mcu_batch", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
+    @interfaces.interface_method(interfaces.MCUInterfaceV1)
+    def mcu_batch(self, operations: tuple, latch: bool) -> tuple:
+        """
+        Carry out several operations on both eyebrows together: one frame to each MCU, in one I2C transfer.
+
+        * *Parameters*:
+            * `operations`: `(kind, which, value)` tuples, where `kind` is 'display', 'display-clear', 'servo', or 'led'
+              and `which` is 'eyebrow-left' or 'eyebrow-right'.
+            * `latch`: Stage the frames until `mcu_commit()` instead.
+
+        *Returns*: Whether each operation was valid and sent.
+        """
+        with batch.CommandBatch() as commands:
+            valid = [self._batch_operation(operation) for operation in operations]
+        sent = commands.send(latch)
+        return tuple(v and sent for v in valid)
+
+    @rpyc.exposed
+    @alog.function_counter("mcu_commit", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
+    @interfaces.interface_method(interfaces.MCUInterfaceV1)
+    def mcu_commit(self) -> bool:
+        """
+        Have the MCUs act on their staged frames. Sent as a general call, so every MCU that answers one
+        (both eyebrows, and any other driver's that does) acts on it at the same moment.
+        """
+        return batch.commit()
+
     @rpyc.exposed
     @alog.function_counter("mcu_fw_load", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.SUBMODULE: metrics.SubmoduleNames.FIRMWARE, alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
     @interfaces.interface_method(interfaces.MCUInterfaceV1)
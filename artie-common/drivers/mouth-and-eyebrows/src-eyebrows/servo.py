@@ -1,10 +1,10 @@
 """
 Code pertaining to the servo submodule.
 """
+from . import batch
 from . import ebcommon
 from artie_util import artie_logging as alog
 from artie_util import constants
-from artie_i2c import i2c
 from typing import Dict
 import numpy as np
 
@@ -63,7 +63,7 @@ class ServoSubmodule:
         go_val_bytes = 0b00000000 if go_val_bytes < 0b00000000 else go_val_bytes
         go_val_bytes = 0b00111111 if go_val_bytes > 0b00111111 else go_val_bytes
         servo_go_bytes = CMD_MODULE_ID_SERVO | go_val_bytes
-        wrote = i2c.write_bytes_to_address(address, servo_go_bytes)
+        wrote = batch.write_bytes_to_address(address, servo_go_bytes)
         if side == ebcommon.EyebrowSides.LEFT:
             self._left_servo_degrees = servo_degrees
         else:
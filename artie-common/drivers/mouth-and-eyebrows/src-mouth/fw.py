@@ -10,6 +10,9 @@ from artie_util import util
 import os
 import time
 
+# I2C bus rate (Hz) the mouth firmware is built for (its CMDS_I2C_BAUDRATE)
+MCU_I2C_SPEED_HZ = 100_000
+
 # TODO: Decide on proper MCU naming conventions
 MOUTH_MCU_NAME = "mouth"
 
@@ -105,5 +108,6 @@ class FirmwareSubmodule:
             alog.error("Cannot find mouth on the I2C bus. Mouth will not be available.")
             self._set_status(False)
             return False
+        i2c.negotiate_bus_speed(board.I2C_ADDRESS_MOUTH_MCU, MCU_I2C_SPEED_HZ)
         self._set_status(True)
         return True
@@ -1,7 +1,7 @@
 """
 All the code pertaining to the LCD Submodule.
 """
-from artie_i2c import i2c
+from . import batch
 from artie_util import artie_logging as alog
 from artie_util import boardconfig_controller as board
 from artie_util import constants
@@ -56,14 +56,14 @@ class LcdSubmodule:
     def test(self) -> bool:
         alog.test("Received request for mouth LCD -> TEST.", tests=['mouth-driver-unit-tests:lcd-test'])
         lcd_test_bytes = CMD_MODULE_ID_LCD | 0x11
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_test_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_test_bytes)
         self._set_status(worked)
         return worked
 
     def off(self) -> bool:
         alog.test("Received request for mouth LCD -> OFF.", tests=['mouth-driver-unit-tests:lcd-off'])
         lcd_off_bytes = CMD_MODULE_ID_LCD | 0x22
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_off_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_off_bytes)
         self._set_status(worked)
         return worked
 
@@ -78,7 +78,7 @@ class LcdSubmodule:
 
         alog.test(f"Received request for mouth LCD -> {val.upper()}", tests=['mouth-driver-*-tests:lcd-draw-*'])
 
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_draw_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, lcd_draw_bytes)
         self._current_display = val.upper()
         self._set_status(worked)
         return worked
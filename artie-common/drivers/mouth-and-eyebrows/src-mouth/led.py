@@ -1,7 +1,7 @@
 """
 Code pertaining to the LED subsystem.
 """
-from artie_i2c import i2c
+from . import batch
 from artie_util import artie_logging as alog
 from artie_util import boardconfig_controller as board
 from artie_util import constants
@@ -53,7 +53,7 @@ class LedSubmodule:
     def on(self) -> bool:
         alog.test("Received request for mouth LED -> ON.", tests=['mouth-driver-unit-tests:led-on'])
         led_on_bytes = CMD_MODULE_ID_LEDS | 0x00
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_on_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_on_bytes)
         self._led_state = 'on'
         self._set_status(worked)
         return worked
@@ -61,7 +61,7 @@ class LedSubmodule:
     def off(self) -> bool:
         alog.test("Received request for mouth LED -> OFF.", tests=['mouth-driver-unit-tests:led-off'])
         led_on_bytes = CMD_MODULE_ID_LEDS | 0x01
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_on_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_on_bytes)
         self._led_state = 'off'
         self._set_status(worked)
         return worked
@@ -69,7 +69,7 @@ class LedSubmodule:
     def heartbeat(self) -> bool:
         alog.test("Received request for mouth LED -> HEARTBEAT.", tests=['mouth-driver-unit-tests:led-heartbeat'])
         led_heartbeat_bytes = CMD_MODULE_ID_LEDS | 0x02
-        worked = i2c.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_heartbeat_bytes)
+        worked = batch.write_bytes_to_address(board.I2C_ADDRESS_MOUTH_MCU, led_heartbeat_bytes)
         self._led_state = 'heartbeat'
         self._set_status(worked)
         return worked
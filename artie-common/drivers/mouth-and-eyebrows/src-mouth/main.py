@@ -18,7 +18,9 @@ from artie_util import artie_logging as alog
 from artie_service_client import artie_service
 from artie_service_client import interfaces
 from artie_util import util
+from . import batch
 from . import fw
+from . import fwlog
 from . import lcd
 from . import led
 from . import metrics
@@ -52,6 +54,14 @@ class DriverServer(
         # Set up the LED
         self._led_submodule.heartbeat()
 
+        # Publish the MCU's own metrics
+        self._metrics_scraper = metrics.FirmwareMetricsScraper({fw.MOUTH_MCU_NAME: board.I2C_ADDRESS_MOUTH_MCU})
+        self._metrics_scraper.start()
+
+        # And its logs
+        self._log_puller = fwlog.FirmwareLogPuller({fw.MOUTH_MCU_NAME: board.I2C_ADDRESS_MOUTH_MCU}, fw_fpath)
+        self._log_puller.start()
+
     @rpyc.exposed
     @alog.function_counter("status", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.DriverInterfaceV1.__interface_name__})
     @interfaces.interface_method(interfaces.DriverInterfaceV1)
@@ -202,6 +212,49 @@ class DriverServer(
         """
         return self._lcd_submodule.off()
 
+    def _batch_operation(self, operation) -> bool:
+        """Carry out one of mcu_batch()'s operations (into the open batch). False if it isn't valid."""
+        try:
+            kind, which, value = operation
+            match kind:
+                case 'display':
+                    return self.display_set(which, value)
+                case 'display-clear':
+                    return self.display_clear(which)
+                case 'led':
+                    return self.led_set(which, value)
+        except (TypeError, ValueError) as e:
+            alog.error(f"Invalid batch operation {operation}: {e}")
+            return False
+        alog.error(f"Invalid batch operation kind: {kind}")
+        return False
+
+    @rpyc.exposed
+    @alog.function_counter("mcu_batch", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
+    @interfaces.interface_method(interfaces.MCUInterfaceV1)
+    def mcu_batch(self, operations: tuple, latch: bool) -> tuple:
+        """
+        Carry out several operations on the mouth together, as one frame.
+
+        * *Parameters*:
+            * `operations`: `(kind, which, value)` tuples, where `kind` is 'display', 'display-clear', or 'led'.
+              `which` is ignored, since there is only one display and one LED.
+            * `latch`: Stage the frame until `mcu_commit()` instead.
+
+        *Returns*: Whether each operation was valid and sent.
+        """
+        with batch.CommandBatch() as commands:
+            valid = [self._batch_operation(operation) for operation in operations]
+        sent = commands.send(latch)
+        return tuple(v and sent for v in valid)
+
+    @rpyc.exposed
+    @alog.function_counter("mcu_commit", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
+    @interfaces.interface_method(interfaces.MCUInterfaceV1)
+    def mcu_commit(self) -> bool:
+        """Have the MCU act on its staged frame."""
+        return batch.commit()
+
     @rpyc.exposed
     @alog.function_counter("mcu_fw_load", alog.MetricSWCodePathAPIOrder.CALLS, attributes={alog.KnownMetricAttributes.SUBMODULE: metrics.SubmoduleNames.FIRMWARE, alog.KnownMetricAttributes.INTERFACE_NAME: interfaces.MCUInterfaceV1.__interface_name__})
     @interfaces.interface_method(interfaces.MCUInterfaceV1)
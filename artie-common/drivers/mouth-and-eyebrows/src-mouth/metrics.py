@@ -1,11 +1,134 @@
 """
 Metrics-related code for the mouth driver.
 """
+from artie_i2c import i2c
 from artie_util import artie_logging as alog
+from artie_util import util
+from opentelemetry.metrics import Observation
+import dataclasses
 import enum
+import struct
+import threading
 
 class SubmoduleNames(enum.StrEnum):
     """Names of the submodules in the mouth driver."""
     LED = "led"
     LCD = "lcd"
     FIRMWARE = "fw"
+
+# See the firmware's cmds.h, board/types.h, and metrics.h
+CMDS_REGISTER_SELECT = 0xC0
+REG_METRICS = 0x28
+METRICS_PACKED_LEN = 20
+
+# How often to read each MCU's metrics. It keeps them over one-second windows, so this samples one window in so many.
+SCRAPE_INTERVAL_S = 5.0
+
+MCU_ATTRIBUTE = "mcu"
+CORE_ATTRIBUTE = "core"
+
+@dataclasses.dataclass
+class FirmwareMetrics:
+    """An MCU's last window of metrics (REG_METRICS)."""
+    window_s: float
+    core_busy: tuple[float, float]  # Fraction of each core's time spent working: core 0 dispatches commands, core 1 draws
+    commands_per_s: int
+    frames_per_s: int
+    drops_per_s: int                # Commands (or writes of them) turned away because a queue was full
+    flush_avg_s: float
+    flush_max_s: float
+    cmd_queue_depth: int            # Most bytes in the command queue
+    gfx_queue_depth: int            # Most work items waiting for the graphics core
+
+    @staticmethod
+    def unpack(raw: list[int]) -> 'FirmwareMetrics':
+        window_ms, busy0, busy1, commands, frames, drops, flush_avg_us, flush_max_us, cmd_queue, gfx_queue = struct.unpack("<10H", bytes(raw))
+        return FirmwareMetrics(window_ms / 1000, (busy0 / 1000, busy1 / 1000), commands, frames, drops,
+                               flush_avg_us / 1e6, flush_max_us / 1e6, cmd_queue, gfx_queue)
+
+class FirmwareMetricsScraper:
+    """
+    Reads every MCU's metrics register in one I2C transfer every SCRAPE_INTERVAL_S and publishes the latest
+    through alog, so MCU saturation shows up alongside the driver's own metrics.
+    """
+    def __init__(self, mcu_addresses: dict[str, int]):
+        self._mcu_addresses = mcu_addresses
+        self._latest: dict[str, FirmwareMetrics] = {}
+        self._lock = threading.Lock()
+        self._stop_event = threading.Event()
+        self._thread: threading.Thread = None
+
+    def start(self):
+        """Register the gauges and start scraping. Nothing to scrape in test mode."""
+        gauges = [
+            ("mcu_core_busy", alog.MetricHWSystemCPUOrder.USAGE, alog.MetricUnits.PERCENT, "Fraction of each MCU core's time spent working", self._observe_core_busy),
+            ("mcu_commands", alog.MetricSWCodePathSubmoduleOrder.COMMANDS_PROCESSED, alog.MetricUnits.HERTZ, "Commands dispatched per second", self._observer(lambda m: m.commands_per_s)),
+            ("mcu_drops", alog.MetricHWBusI2COrder.TRAFFIC, alog.MetricUnits.HERTZ, "Commands turned away per second because a queue was full", self._observer(lambda m: m.drops_per_s)),
+            ("mcu_cmd_queue_depth", alog.MetricHWBusI2COrder.TRAFFIC, alog.MetricUnits.BYTES, "Most bytes in the MCU's command queue", self._observer(lambda m: m.cmd_queue_depth)),
+            ("mcu_frames", alog.MetricHWActuatorDisplayOrder.FRAMES, alog.MetricUnits.HERTZ, "Frames drawn per second", self._observer(lambda m: m.frames_per_s)),
+            ("mcu_gfx_queue_depth", alog.MetricHWActuatorDisplayOrder.FRAMES, alog.MetricUnits.CALLS, "Most work items waiting for the graphics core", self._observer(lambda m: m.gfx_queue_depth)),
+            ("mcu_flush_avg", alog.MetricHWActuatorDisplayOrder.FLUSH, alog.MetricUnits.SECONDS, "Average time to start sending a frame to the LCD", self._observer(lambda m: m.flush_avg_s)),
+            ("mcu_flush_max", alog.MetricHWActuatorDisplayOrder.FLUSH, alog.MetricUnits.SECONDS, "Longest time to start sending a frame to the LCD", self._observer(lambda m: m.flush_max_s)),
+        ]
+        for name, taxonomy, unit, description, callback in gauges:
+            alog.create_async_gauge(callback, name, taxonomy, unit, description)
+
+        if util.in_test_mode():
+            alog.test("Mocking MCU metrics scraping.", tests=[])
+            return
+
+        self._thread = threading.Thread(target=self._scrape, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        self._stop_event.set()
+
+    def latest(self, mcu: str) -> FirmwareMetrics|None:
+        with self._lock:
+            return self._latest.get(mcu)
+
+    def _read(self, address: int) -> FirmwareMetrics|None:
+        raw = i2c.write_then_read_bytes(address, [CMDS_REGISTER_SELECT, REG_METRICS], METRICS_PACKED_LEN)
+        return self._unpack(raw)
+
+    def _unpack(self, raw: list[int]|None) -> FirmwareMetrics|None:
+        if raw is None or len(raw) != METRICS_PACKED_LEN:
+            return None
+        return FirmwareMetrics.unpack(raw)
+
+    def _read_all(self) -> dict[str, FirmwareMetrics|None]:
+        """Every MCU's metrics, in one transfer. If that fails, one MCU at a time, so one that isn't answering doesn't hide the rest."""
+        messages = []
+        for address in self._mcu_addresses.values():
+            messages += [i2c.Write(address, [CMDS_REGISTER_SELECT, REG_METRICS]), i2c.Read(address, METRICS_PACKED_LEN)]
+        raws = i2c.transfer(messages)
+        if raws is not None:
+            return {mcu: self._unpack(raw) for mcu, raw in zip(self._mcu_addresses, raws)}
+        return {mcu: self._read(address) for mcu, address in self._mcu_addresses.items()}
+
+    def _scrape(self):
+        while not self._stop_event.is_set():
+            for mcu, metrics in self._read_all().items():
+                with self._lock:
+                    if metrics is None:
+                        # Stale figures would hide an MCU that has stopped answering
+                        alog.debug(f"Could not read metrics from {mcu}.")
+                        self._latest.pop(mcu, None)
+                    else:
+                        self._latest[mcu] = metrics
+            self._stop_event.wait(SCRAPE_INTERVAL_S)
+
+    def _snapshot(self) -> dict[str, FirmwareMetrics]:
+        with self._lock:
+            return dict(self._latest)
+
+    def _observer(self, field):
+        def observe(options):
+            for mcu, metrics in self._snapshot().items():
+                yield Observation(field(metrics), {MCU_ATTRIBUTE: mcu})
+        return observe
+
+    def _observe_core_busy(self, options):
+        for mcu, metrics in self._snapshot().items():
+            for core, busy in enumerate(metrics.core_busy):
+                yield Observation(busy, {MCU_ATTRIBUTE: mcu, CORE_ATTRIBUTE: str(core)})
@@ -0,0 +1,262 @@
+/**
+ * @file bytestuff_bench.c
+ * @brief On-device benchmark of the CAN payload codec (the bytestuff_bench target).
+ *
+ * Times stuffing, unstuffing, and the checksums from the bytestuff library over payloads
+ * from one CAN frame up to a whole BWACP block, with the microsecond timer, then prints
+ * the results over USB stdio as CSV between a "# bytestuff_bench begin" and a
+ * "# bytestuff_bench end" line. Runs again every BYTESTUFF_BENCH_PERIOD_MS, so you can
+ * connect whenever you like. The table has the same columns as gfx_bench's, plus the
+ * payload size as the parameter and a throughput column, so tools/gfxbench can compare
+ * two captures of it too (with --bench bytestuff_bench).
+ *
+ * Each payload is also stuffed and unstuffed both ways and checked against the original,
+ * and a mismatch is printed as a "# mismatch" line before the table.
+ */
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "pico/stdio_usb.h"
+// Library includes
+#include <bytestuff.h>
+#include <errors.h>
+
+#ifndef BYTESTUFF_BENCH_ITERATIONS
+    /** How many times each benchmark runs. */
+    #define BYTESTUFF_BENCH_ITERATIONS 16
+#endif // BYTESTUFF_BENCH_ITERATIONS
+
+#ifndef BYTESTUFF_BENCH_PERIOD_MS
+    /** How long to wait between runs of the whole suite. */
+    #define BYTESTUFF_BENCH_PERIOD_MS 5000
+#endif // BYTESTUFF_BENCH_PERIOD_MS
+
+#ifndef HOT_PATHS_IN_RAM
+    #define HOT_PATHS_IN_RAM 0
+#endif // HOT_PATHS_IN_RAM
+
+/** Biggest payload we time: one BWACP block. */
+#define MAX_PAYLOAD_LEN 4096
+
+/** Payload sizes to time: one frame, an RPCACP buffer, a PSACP message, and a BWACP block. */
+static const size_t SIZES[] = { 8, 60, 128, 1024, MAX_PAYLOAD_LEN };
+
+/** The payload. */
+static uint8_t payload[MAX_PAYLOAD_LEN];
+
+/** Where it gets stuffed and unstuffed. */
+static uint8_t work[BYTESTUFF_STUFFED_LEN(MAX_PAYLOAD_LEN)];
+
+/** Stuffed copy of the payload, for the unstuffing benchmarks. */
+static uint8_t stuffed[BYTESTUFF_STUFFED_LEN(MAX_PAYLOAD_LEN)];
+
+/** Keeps the compiler from throwing away results nobody reads. */
+static volatile uint32_t sink;
+
+/** Something to time, over the first len bytes of the payload. */
+typedef void (*bench_fn_t)(size_t len);
+
+/** The CRC24 a bit at a time, as it was before the table, to compare against. */
+static uint32_t crc24_bitwise(uint32_t crc, uint8_t byte)
+{
+    crc ^= (uint32_t)byte << 16;
+    for (int bit = 0; bit < 8; bit++)
+    {
+        crc <<= 1;
+        if (crc & 0x1000000)
+        {
+            crc ^= 0x864CFB;
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+static void bench_encoder_next(size_t len)
+{
+    bytestuff_encoder_t encoder;
+    bytestuff_encoder_init(&encoder, payload, len);
+    size_t n = 0;
+    while (bytestuff_encoder_next(&encoder, &work[n]))
+    {
+        n++;
+    }
+    sink = n;
+}
+
+static void bench_decoder_feed(size_t len)
+{
+    bytestuff_decoder_t decoder;
+    bytestuff_decoder_init(&decoder);
+    const size_t stuffed_len = BYTESTUFF_STUFFED_LEN(len);
+    size_t n = 0;
+    for (size_t i = 0; i < stuffed_len; i++)
+    {
+        if (bytestuff_decoder_feed(&decoder, stuffed[i]) == BYTESTUFF_BYTE_DATA)
+        {
+            work[n] = stuffed[i];
+            n++;
+        }
+    }
+    sink = n;
+}
+
+static void bench_encode(size_t len)
+{
+    memcpy(work, payload, len);
+    sink = bytestuff_encode(work, len, sizeof(work));
+}
+
+static void bench_decode(size_t len)
+{
+    memcpy(work, stuffed, BYTESTUFF_STUFFED_LEN(len));
+    size_t payload_len = 0;
+    sink = bytestuff_decode(work, BYTESTUFF_STUFFED_LEN(len), &payload_len);
+}
+
+static void bench_memcpy(size_t len)
+{
+    memcpy(work, payload, len);
+    sink = work[len - 1];
+}
+
+static void bench_crc16_update(size_t len)
+{
+    uint16_t crc = CRC16_INIT;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = crc16_update(crc, payload[i]);
+    }
+    sink = crc;
+}
+
+static void bench_crc16_update_bytes(size_t len)
+{
+    sink = crc16_update_bytes(CRC16_INIT, payload, len);
+}
+
+static void bench_crc24_bitwise(size_t len)
+{
+    uint32_t crc = CRC24_INIT;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = crc24_bitwise(crc, payload[i]);
+    }
+    sink = crc;
+}
+
+static void bench_crc24_update_bytes(size_t len)
+{
+    sink = crc24_update_bytes(CRC24_INIT, payload, len);
+}
+
+/**
+ * Run fn BYTESTUFF_BENCH_ITERATIONS times over len bytes and print a row of the table for it.
+ * The throughput is payload bytes per second at the mean time.
+ */
+static void run_bench(const char *name, size_t len, bench_fn_t fn)
+{
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint64_t total_us = 0;
+    for (uint i = 0; i < BYTESTUFF_BENCH_ITERATIONS; i++)
+    {
+        const uint32_t start = time_us_32();
+        fn(len);
+        const uint32_t elapsed = time_us_32() - start;
+
+        min_us = (elapsed < min_us) ? elapsed : min_us;
+        max_us = (elapsed > max_us) ? elapsed : max_us;
+        total_us += elapsed;
+    }
+
+    const uint64_t mean_us = total_us / BYTESTUFF_BENCH_ITERATIONS;
+    const uint64_t kib_per_s = (mean_us == 0) ? 0 : ((uint64_t)len * 1000000 / 1024) / mean_us;
+    printf("%s,%u,%u,%lu,%lu,%lu,%lu\n", name, (unsigned)len, BYTESTUFF_BENCH_ITERATIONS,
+           (unsigned long)min_us, (unsigned long)mean_us, (unsigned long)max_us, (unsigned long)kib_per_s);
+}
+
+/** Stuff and unstuff len bytes of the payload both ways, and check they all agree. */
+static bool check_round_trip(size_t len)
+{
+    bench_encoder_next(len);
+    const size_t stuffed_len = BYTESTUFF_STUFFED_LEN(len);
+    memcpy(stuffed, work, stuffed_len);
+
+    memcpy(work, payload, len);
+    if ((bytestuff_encode(work, len, sizeof(work)) != stuffed_len) || (memcmp(work, stuffed, stuffed_len) != 0))
+    {
+        return false;
+    }
+
+    size_t payload_len = 0;
+    if (!bytestuff_decode(work, stuffed_len, &payload_len) || (payload_len != len) || (memcmp(work, payload, len) != 0))
+    {
+        return false;
+    }
+
+    bench_decoder_feed(len);
+    return (sink == len) && (memcmp(work, payload, len) == 0);
+}
+
+static void run_suite(uint32_t run)
+{
+    // Outside the table, so the mismatches don't get mixed up with the results
+    for (size_t i = 0; i < (sizeof(SIZES) / sizeof(SIZES[0])); i++)
+    {
+        if (!check_round_trip(SIZES[i]))
+        {
+            printf("# mismatch: len=%u\n", (unsigned)SIZES[i]);
+        }
+    }
+
+    printf("# bytestuff_bench begin: run=%lu sys_clk_hz=%lu hot_paths_in_ram=%u\n",
+           (unsigned long)run, (unsigned long)clock_get_hz(clk_sys), HOT_PATHS_IN_RAM);
+    printf("name,param,iterations,min_us,mean_us,max_us,kib_per_s\n");
+
+    for (size_t i = 0; i < (sizeof(SIZES) / sizeof(SIZES[0])); i++)
+    {
+        const size_t len = SIZES[i];
+        run_bench("memcpy", len, bench_memcpy);
+        run_bench("bytestuff_encoder_next", len, bench_encoder_next);
+        run_bench("bytestuff_encode", len, bench_encode);
+        run_bench("bytestuff_decoder_feed", len, bench_decoder_feed);
+        run_bench("bytestuff_decode", len, bench_decode);
+        run_bench("crc16_update", len, bench_crc16_update);
+        run_bench("crc16_update_bytes", len, bench_crc16_update_bytes);
+        run_bench("crc24_bitwise", len, bench_crc24_bitwise);
+        run_bench("crc24_update_bytes", len, bench_crc24_update_bytes);
+    }
+
+    printf("# bytestuff_bench end\n");
+
+    // Anything logged during the runs, after the results so it doesn't get in the way of them
+    log_flush();
+}
+
+int main()
+{
+    stdio_init_all();
+
+    // Not all the same, and not all 0xFF, so nothing gets lucky
+    for (size_t i = 0; i < MAX_PAYLOAD_LEN; i++)
+    {
+        payload[i] = (uint8_t)((i * 167) + (i >> 8));
+    }
+
+    for (uint32_t run = 0; ; run++)
+    {
+        // Nobody to print to until the host opens the port
+        while (!stdio_usb_connected())
+        {
+            sleep_ms(100);
+        }
+
+        run_suite(run);
+        sleep_ms(BYTESTUFF_BENCH_PERIOD_MS);
+    }
+}
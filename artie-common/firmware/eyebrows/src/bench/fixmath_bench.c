@@ -0,0 +1,286 @@
+/**
+ * @file fixmath_bench.c
+ * @brief On-device benchmark of the fixmath library against float (the fixmath_bench target).
+ *
+ * Times each fixmath operation over a block of inputs, next to the soft-float code it
+ * stands in for, then prints the results over USB stdio as CSV between a
+ * "# fixmath_bench begin" and a "# fixmath_bench end" line, every FIXMATH_BENCH_PERIOD_MS.
+ * The table has the same columns as gfx_bench's, plus the block size as the parameter and
+ * an operations-per-second column, so tools/gfxbench can compare two captures of it too
+ * (with --bench fixmath_bench).
+ *
+ * Each operation is also checked against float over every input first, and the worst
+ * error (in LSBs of the fixed-point result) is printed as an "# accuracy" line before the
+ * table, with "# mismatch" in front of any over its limit.
+ */
+// Stdlib includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "pico/stdio_usb.h"
+// Library includes
+#include <errors.h>
+#include <fixmath.h>
+
+#ifndef FIXMATH_BENCH_ITERATIONS
+    /** How many times each benchmark runs. */
+    #define FIXMATH_BENCH_ITERATIONS 16
+#endif // FIXMATH_BENCH_ITERATIONS
+
+#ifndef FIXMATH_BENCH_PERIOD_MS
+    /** How long to wait between runs of the whole suite. */
+    #define FIXMATH_BENCH_PERIOD_MS 5000
+#endif // FIXMATH_BENCH_PERIOD_MS
+
+#ifndef HOT_PATHS_IN_RAM
+    #define HOT_PATHS_IN_RAM 0
+#endif // HOT_PATHS_IN_RAM
+
+/** Inputs per block. */
+#define NINPUTS 256
+
+/** The inputs: Q16.16 values over a few orders of magnitude, either sign, and the same as floats. */
+static q16_t inputs_q16[NINPUTS];
+static float inputs_f[NINPUTS];
+
+/** Angles over a full turn, in fix_sin_q15()'s units and in radians. */
+static uint16_t angles[NINPUTS];
+static float angles_f[NINPUTS];
+
+/** Keeps the compiler from throwing away results nobody reads. */
+static volatile int32_t sink;
+static volatile float sink_f;
+
+/** Something to time, over a block of inputs. */
+typedef void (*bench_fn_t)(void);
+
+static void bench_q16_mul(void)
+{
+    q16_t acc = 0;
+    for (size_t i = 1; i < NINPUTS; i++)
+    {
+        acc += q16_mul(inputs_q16[i - 1], inputs_q16[i]);
+    }
+    sink = acc;
+}
+
+static void bench_float_mul(void)
+{
+    float acc = 0;
+    for (size_t i = 1; i < NINPUTS; i++)
+    {
+        acc += inputs_f[i - 1] * inputs_f[i];
+    }
+    sink_f = acc;
+}
+
+static void bench_q16_div(void)
+{
+    q16_t acc = 0;
+    for (size_t i = 1; i < NINPUTS; i++)
+    {
+        acc += q16_div(inputs_q16[i - 1], inputs_q16[i]);
+    }
+    sink = acc;
+}
+
+static void bench_float_div(void)
+{
+    float acc = 0;
+    for (size_t i = 1; i < NINPUTS; i++)
+    {
+        acc += inputs_f[i - 1] / inputs_f[i];
+    }
+    sink_f = acc;
+}
+
+static void bench_q16_sqrt(void)
+{
+    q16_t acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        acc += q16_sqrt(inputs_q16[i] & INT32_MAX);
+    }
+    sink = acc;
+}
+
+static void bench_sqrtf(void)
+{
+    float acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        acc += sqrtf(fabsf(inputs_f[i]));
+    }
+    sink_f = acc;
+}
+
+static void bench_fix_sin_q15(void)
+{
+    int32_t acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        acc += fix_sin_q15(angles[i]);
+    }
+    sink = acc;
+}
+
+static void bench_sinf(void)
+{
+    float acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        acc += sinf(angles_f[i]);
+    }
+    sink_f = acc;
+}
+
+static void bench_smoothstep_q16(void)
+{
+    uint32_t acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        acc += fix_smoothstep_q16((uint32_t)i << 8);
+    }
+    sink = (int32_t)acc;
+}
+
+static void bench_smoothstep_float(void)
+{
+    float acc = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        const float u = (float)i / NINPUTS;
+        acc += u * u * (3.0f - (2.0f * u));
+    }
+    sink_f = acc;
+}
+
+/**
+ * Run fn FIXMATH_BENCH_ITERATIONS times and print a row of the table for it.
+ * The throughput is operations (one per input) per second at the mean time, in thousands.
+ */
+static void run_bench(const char *name, bench_fn_t fn)
+{
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint64_t total_us = 0;
+    for (uint i = 0; i < FIXMATH_BENCH_ITERATIONS; i++)
+    {
+        const uint32_t start = time_us_32();
+        fn();
+        const uint32_t elapsed = time_us_32() - start;
+
+        min_us = (elapsed < min_us) ? elapsed : min_us;
+        max_us = (elapsed > max_us) ? elapsed : max_us;
+        total_us += elapsed;
+    }
+
+    const uint64_t mean_us = total_us / FIXMATH_BENCH_ITERATIONS;
+    const uint64_t kops_per_s = (mean_us == 0) ? 0 : ((uint64_t)NINPUTS * 1000) / mean_us;
+    printf("%s,%u,%u,%lu,%lu,%lu,%lu\n", name, (unsigned)NINPUTS, FIXMATH_BENCH_ITERATIONS,
+           (unsigned long)min_us, (unsigned long)mean_us, (unsigned long)max_us, (unsigned long)kops_per_s);
+}
+
+/** Print the worst error of an operation, in LSBs, and whether it's within its limit. */
+static void report_accuracy(const char *name, double worst, double limit)
+{
+    printf("#%s accuracy: %s max_err_lsb=%.2f limit=%.2f\n", (worst > limit) ? " mismatch:" : "", name, worst, limit);
+}
+
+/** Check every operation against float (in double, so the reference is exact enough) over every input. */
+static void check_accuracy(void)
+{
+    double worst_mul = 0;
+    double worst_div = 0;
+    double worst_sqrt = 0;
+    double worst_sin = 0;
+    double worst_smoothstep = 0;
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        const double a = inputs_q16[(i + NINPUTS - 1) % NINPUTS] / 65536.0;
+        const double b = inputs_q16[i] / 65536.0;
+
+        const double mul = fabs(q16_mul(inputs_q16[(i + NINPUTS - 1) % NINPUTS], inputs_q16[i]) - (a * b * 65536.0));
+        worst_mul = (mul > worst_mul) ? mul : worst_mul;
+
+        const double quotient = a / b * 65536.0;
+        if (fabs(quotient) < INT32_MAX)
+        {
+            const double div = fabs(q16_div(inputs_q16[(i + NINPUTS - 1) % NINPUTS], inputs_q16[i]) - quotient);
+            worst_div = (div > worst_div) ? div : worst_div;
+        }
+
+        const double root = fabs(q16_sqrt(inputs_q16[i] & INT32_MAX) - (sqrt((inputs_q16[i] & INT32_MAX) / 65536.0) * 65536.0));
+        worst_sqrt = (root > worst_sqrt) ? root : worst_sqrt;
+
+        const double sine = fabs(fix_sin_q15(angles[i]) - (sin(angles[i] * (2.0 * M_PI / 65536.0)) * 32767.0));
+        worst_sin = (sine > worst_sin) ? sine : worst_sin;
+
+        const double u = i / (double)NINPUTS;
+        const double step = fabs(fix_smoothstep_q16((uint32_t)i << 8) - (u * u * (3.0 - (2.0 * u)) * 65536.0));
+        worst_smoothstep = (step > worst_smoothstep) ? step : worst_smoothstep;
+    }
+
+    report_accuracy("q16_mul", worst_mul, 0.5);
+    report_accuracy("q16_div", worst_div, 1.0);
+    report_accuracy("q16_sqrt", worst_sqrt, 1.0);
+    report_accuracy("fix_sin_q15", worst_sin, 2.5);
+    report_accuracy("fix_smoothstep_q16", worst_smoothstep, 2.0);
+}
+
+static void run_suite(uint32_t run)
+{
+    // Outside the table, so the accuracy lines don't get mixed up with the results
+    check_accuracy();
+
+    printf("# fixmath_bench begin: run=%lu sys_clk_hz=%lu hot_paths_in_ram=%u\n",
+           (unsigned long)run, (unsigned long)clock_get_hz(clk_sys), HOT_PATHS_IN_RAM);
+    printf("name,param,iterations,min_us,mean_us,max_us,kops_per_s\n");
+
+    run_bench("q16_mul", bench_q16_mul);
+    run_bench("float_mul", bench_float_mul);
+    run_bench("q16_div", bench_q16_div);
+    run_bench("float_div", bench_float_div);
+    run_bench("q16_sqrt", bench_q16_sqrt);
+    run_bench("sqrtf", bench_sqrtf);
+    run_bench("fix_sin_q15", bench_fix_sin_q15);
+    run_bench("sinf", bench_sinf);
+    run_bench("fix_smoothstep_q16", bench_smoothstep_q16);
+    run_bench("smoothstep_float", bench_smoothstep_float);
+
+    printf("# fixmath_bench end\n");
+
+    // Anything logged during the runs, after the results so it doesn't get in the way of them
+    log_flush();
+}
+
+int main()
+{
+    stdio_init_all();
+
+    // From 2**-16 up to 128 (so no product saturates), either sign, and never zero
+    for (size_t i = 0; i < NINPUTS; i++)
+    {
+        const int32_t magnitude = (int32_t)((((i * 2654435761u) >> 16) & 0xFFFF) + 1) << (i % 8);
+        inputs_q16[i] = (i & 1) ? -magnitude : magnitude;
+        inputs_f[i] = inputs_q16[i] / 65536.0f;
+        angles[i] = (uint16_t)(i * 40503u);
+        angles_f[i] = angles[i] * (float)(2.0 * M_PI / 65536.0);
+    }
+
+    for (uint32_t run = 0; ; run++)
+    {
+        // Nobody to print to until the host opens the port
+        while (!stdio_usb_connected())
+        {
+            sleep_ms(100);
+        }
+
+        run_suite(run);
+        sleep_ms(FIXMATH_BENCH_PERIOD_MS);
+    }
+}
@@ -0,0 +1,208 @@
+/**
+ * @file gfx_bench.c
+ * @brief On-device benchmark of the graphics pipeline (the gfx_bench target).
+ *
+ * Times the paint primitives, every expression, and sending the paint buffer to the LCD
+ * with the microsecond timer, then prints the results over USB stdio as CSV between a
+ * "# gfx_bench begin" and a "# gfx_bench end" line. Runs again every GFX_BENCH_PERIOD_MS,
+ * so you can connect whenever you like. tools/gfxbench picks the table out of a capture
+ * and compares it against an earlier one.
+ *
+ * The expressions are always painted here, never recalled from pre-rendered frames.
+ * With GFX_BANDED, the paint benchmarks only land in the first band, and the whole
+ * mouth is timed painting and sending every band instead of sending the paint buffer.
+ */
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "graphics/commongfx.h"
+#include "graphics/faceshapes.h"
+
+#ifndef GFX_BENCH_ITERATIONS
+    /** How many times each benchmark runs. */
+    #define GFX_BENCH_ITERATIONS 16
+#endif // GFX_BENCH_ITERATIONS
+
+#ifndef GFX_BENCH_PERIOD_MS
+    /** How long to wait between runs of the whole suite. */
+    #define GFX_BENCH_PERIOD_MS 5000
+#endif // GFX_BENCH_PERIOD_MS
+
+#ifndef HOT_PATHS_IN_RAM
+    #define HOT_PATHS_IN_RAM 0
+#endif // HOT_PATHS_IN_RAM
+
+/** Border (in pixels) kept around the lines and circles we draw. */
+#define MARGIN 10
+
+/** Something to time. Gets the benchmark's parameter. */
+typedef void (*bench_fn_t)(int param);
+
+static void bench_paint_clear(int param)
+{
+    Paint_Clear(WHITE);
+}
+
+static void bench_draw_line(int param)
+{
+    Paint_DrawLine(MARGIN, MARGIN, Paint.Width - MARGIN, Paint.Height - MARGIN, BLACK, (DOT_PIXEL)param, LINE_STYLE_SOLID);
+}
+
+static void bench_draw_circle(int param)
+{
+    const UWORD radius = ((Paint.Width < Paint.Height) ? Paint.Width : Paint.Height) / 2 - MARGIN;
+    Paint_DrawCircle(Paint.Width / 2, Paint.Height / 2, radius, BLACK, LINE_WIDTH, (DRAW_FILL)param);
+}
+
+#ifdef MOUTH
+static void bench_paint_mouth(int param)
+{
+    faceshapes_paint_mouth((mouth_shape_t)param);
+}
+
+static void bench_paint_viseme(int param)
+{
+    faceshapes_paint_viseme((viseme_t)param);
+}
+#else
+static void bench_paint_eyebrow(int param)
+{
+    const eyebrow_t eyebrow = faceshapes_eyebrow_from_index((uint8_t)param);
+    faceshapes_paint_eyebrow(&eyebrow);
+}
+#endif // MOUTH
+
+#if GFX_BANDED
+static void paint_bench_mouth(uintptr_t arg)
+{
+    faceshapes_paint_mouth((mouth_shape_t)arg);
+}
+
+/** Time painting a mouth band by band and sending every band, all the way to the last byte reaching the panel. */
+static void bench_show_mouth(int param)
+{
+    gfx_lcd_reset();
+    gfx_list_begin();
+    gfx_list_add_painter(paint_bench_mouth, (uintptr_t)param);
+    gfx_fence_wait(gfx_list_show());
+}
+#else
+/** Time a send all the way to the last byte reaching the panel, not just until the DMA starts. */
+static void bench_send_paint_buffer(int param)
+{
+    gfx_fence_wait(gfx_send_paint_buffer_to_lcd());
+}
+#endif // GFX_BANDED
+
+/**
+ * Run fn GFX_BENCH_ITERATIONS times and print a row of the table for it.
+ * If clear is set, the paint buffer is wiped (untimed) before each run.
+ */
+static void run_bench(const char *name, int param, bench_fn_t fn, bool clear)
+{
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint64_t total_us = 0;
+    for (uint i = 0; i < GFX_BENCH_ITERATIONS; i++)
+    {
+        // Nothing may still be streaming out of the buffer we're about to touch
+        gfx_wait_for_lcd();
+        if (clear)
+        {
+            Paint_Clear(WHITE);
+        }
+
+        const uint32_t start = time_us_32();
+        fn(param);
+        const uint32_t elapsed = time_us_32() - start;
+
+        min_us = (elapsed < min_us) ? elapsed : min_us;
+        max_us = (elapsed > max_us) ? elapsed : max_us;
+        total_us += elapsed;
+    }
+
+    printf("%s,%d,%u,%lu,%lu,%lu\n", name, param, GFX_BENCH_ITERATIONS,
+           (unsigned long)min_us, (unsigned long)(total_us / GFX_BENCH_ITERATIONS), (unsigned long)max_us);
+}
+
+static void run_suite(uint32_t run)
+{
+#ifdef MOUTH
+    const char *lcd_name = "mouth";
+#else
+    const char *lcd_name = "eyebrows";
+#endif // MOUTH
+
+    printf("# gfx_bench begin: run=%lu lcd=%s width=%u height=%u paint_scale=%u hot_paths_in_ram=%u\n",
+           (unsigned long)run, lcd_name, gfx_lcd_width(), gfx_lcd_height(), Paint.Scale, HOT_PATHS_IN_RAM);
+    printf("name,param,iterations,min_us,mean_us,max_us\n");
+
+    run_bench("paint_clear", 0, bench_paint_clear, false);
+    for (int width = DOT_PIXEL_1X1; width <= DOT_PIXEL_8X8; width++)
+    {
+        run_bench("paint_draw_line", width, bench_draw_line, true);
+    }
+    run_bench("paint_draw_circle", DRAW_FILL_EMPTY, bench_draw_circle, true);
+    run_bench("paint_draw_circle", DRAW_FILL_FULL, bench_draw_circle, true);
+
+#ifdef MOUTH
+    for (int shape = 0; shape < NUM_MOUTH_SHAPES; shape++)
+    {
+        run_bench("paint_mouth", shape, bench_paint_mouth, true);
+    }
+    for (int viseme = 0; viseme < NUM_VISEMES; viseme++)
+    {
+        run_bench("paint_viseme", viseme, bench_paint_viseme, true);
+    }
+#else
+    for (int index = 0; index < NUM_EYEBROW_STATES; index++)
+    {
+        run_bench("paint_eyebrow", index, bench_paint_eyebrow, true);
+    }
+#endif // MOUTH
+
+#if GFX_BANDED
+    // There's no whole paint buffer to send, so time the whole frame instead
+    for (int shape = 0; shape < NUM_MOUTH_SHAPES; shape++)
+    {
+        run_bench("show_mouth", shape, bench_show_mouth, false);
+    }
+#else
+    run_bench("send_paint_buffer_to_lcd", 0, bench_send_paint_buffer, false);
+#endif // GFX_BANDED
+
+    printf("# gfx_bench end\n");
+
+    // Anything logged during the runs, after the results so it doesn't get in the way of them
+    log_flush();
+}
+
+int main()
+{
+    stdio_init_all();
+
+#ifdef MOUTH
+    gfx_init(LCD_SIZE_MOUTH);
+#else
+    gfx_init(LCD_SIZE_EYEBROWS);
+#endif // MOUTH
+
+    for (uint32_t run = 0; ; run++)
+    {
+        // Nobody to print to until the host opens the port
+        while (!stdio_usb_connected())
+        {
+            sleep_ms(100);
+        }
+
+        run_suite(run);
+        sleep_ms(GFX_BENCH_PERIOD_MS);
+    }
+}
@@ -18,6 +18,18 @@ static const uint I2C_SDA_PIN = 20;
 /** I2C SCL pin used for communicating with controller module */
 static const uint I2C_SCL_PIN = 21;
 
+/** CAN controller (MCP2515) pins on spi0, used instead of I2C when built with CMDS_USE_CAN */
+static const uint CAN_SCK_PIN = 2;
+static const uint CAN_MOSI_PIN = 3;
+static const uint CAN_MISO_PIN = 4;
+static const uint CAN_CS_PIN = 5;
+
+/** The CAN controller's (active-low) interrupt output */
+static const uint CAN_INT_PIN = 14;
+
+/** Ready line to the reset MCU. Held low until we're initialized, then let go; see signal_ready() in main.c. */
+static const uint BOOT_READY_PIN = 26;
+
 #ifndef MOUTH
 /** Servo PWM pin. Used for controlling the attached servo. */
 static const uint SERVO_PWM_PIN = 15;
@@ -32,6 +44,9 @@ static const uint LIMIT_SWITCH_RIGHT = 19;
 static const uint ADDRESS_PIN = 22;
 #endif // MOUTH
 
+/** Latency probe outputs, by trace_probe_t (received, dispatched, render start, flush end). Only driven when built with TRACE_PROBES. */
+static const uint TRACE_PROBE_PINS[4] = { 16, 17, 27, 28 };
+
 // These are used by the LCD subsystem and defined in the LCD library.
 //#define LCD_RST_PIN  12
 //#define LCD_DC_PIN   8
@@ -23,6 +23,39 @@ typedef enum {
     #define CMD_MODULE_ID_SERVO    0x80    // 0b1000 0000 // Exclusive to eyes
 #endif // MOUTH
 
+/** CMD_SEQUENCE_DEFINE, CMD_SEQUENCE_APPEND, and CMD_SEQUENCE_PLAY carry a sequence ID in their three LSbs. */
+#define CMD_SEQUENCE_MASK 0xF8
+
+#ifdef MOUTH
+    /** CMD_LCD_MOUTH_VISEME carries a viseme ID (see viseme_t in faceshapes.h) in its four LSbs. */
+    #define CMD_LCD_MOUTH_VISEME_MASK 0xF0
+#endif // MOUTH
+
+/** CMD_LCD_SET_THEME carries a theme (see gfx_theme_t in commongfx.h) in its two LSbs. */
+#define CMD_LCD_SET_THEME_MASK 0xFC
+
+#ifndef MOUTH
+    /** CMD_SERVO_SET_DURATION carries a duration index in its three LSbs. */
+    #define CMD_SERVO_SET_DURATION_MASK 0xF8
+#endif // MOUTH
+
+/** Register map (see CMDS_REGISTER_SELECT in cmds.h). */
+#define REG_ERROR_COUNTS    (CMDS_REG_FIRMWARE_FIRST + 0x00)    // Each module's error count (ERR_NUM_MODULES x 2 bytes, saturating), in err_module_id_t order
+#define REG_METRICS         (CMDS_REG_FIRMWARE_FIRST + 0x20)    // The last window of metrics (METRICS_PACKED_LEN bytes): core load, commands, frames, and drops per second, LCD flush times, queue depths; see metrics.h
+#define REG_BIST            (CMDS_REG_FIRMWARE_FIRST + 0x40)    // The boot self test's results (BIST_PACKED_LEN bytes): each check's result, median, worst, and limit; see bist.h
+#define REG_IDLE            (CMDS_REG_FIRMWARE_FIRST + 0x60)    // The LCD's idle sleeps (GRAPHICS_IDLE_PACKED_LEN bytes): how many, and the last and worst wake to first frame; see graphics.h
+
+/** Settings in the settings store (see the settings library), readable and settable with CMD_SETTING_GET and CMD_SETTING_SET. */
+#define SETTING_I2C_BAUDRATE    0x0001  // Command bus rate in Hz (100000, 400000, or 1000000) from the next boot, instead of CMDS_I2C_BAUDRATE
+#define SETTING_SERVO_LIMITS    0x0002  // Servo safe range, in us of pulse width: left | right << 16. Written by calibration; see servo.h
+#define SETTING_SYS_CLOCK_MHZ   0x0003  // System clock profile in MHz (125, 200, or 250; see the sysclock library) from the next boot, instead of SYSCLOCK_MHZ
+#define SETTING_IDLE_SLEEP_MS   0x0004  // How long the LCD waits with nothing to draw before it sleeps, in ms (0: never), from the next boot, instead of GFX_IDLE_SLEEP_MS
+
+/** Procedures a controller can call over CAN (see the rpcacp library). Built with CMDS_USE_CAN. */
+#define RPC_ID_QUERY_ERRORS 0x01    // Synchronous. No arguments. Returns MsgPack bin: the error counts and latest errors; see errors_pack()
+#define RPC_ID_QUERY_FRAME_STREAM 0x02  // Synchronous. No arguments. Returns MsgPack array: where the delta frame stream is; built with CAN_FRAMES, see can/canframes.c
+#define RPC_ID_QUERY_LOG 0x03       // Synchronous. No arguments. Returns MsgPack bin: the oldest queued log messages, unformatted; see log_pack()
+
 /**
  * @brief The types of commands we can receive and act on.
  *
@@ -32,6 +65,30 @@ typedef enum {
     CMD_LED_ON                      = (CMD_MODULE_ID_LEDS       | 0x00),
     CMD_LED_OFF                     = (CMD_MODULE_ID_LEDS       | 0x01),
     CMD_LED_HEARTBEAT               = (CMD_MODULE_ID_LEDS       | 0x02),
+    // Expression sequences (see sequence.h) share the LED route too
+    CMD_SEQUENCE_STOP               = (CMD_MODULE_ID_LEDS       | 0x03),
+    CMD_SEQUENCE_DEFINE             = (CMD_MODULE_ID_LEDS       | 0x08),    // | sequence ID. Must start a frame: the rest of the frame is the sequence's steps
+    CMD_SEQUENCE_PLAY               = (CMD_MODULE_ID_LEDS       | 0x10),    // | sequence ID
+    CMD_SEQUENCE_APPEND             = (CMD_MODULE_ID_LEDS       | 0x18),    // | sequence ID. Like CMD_SEQUENCE_DEFINE, but adds to the steps already there
+    // Tracing and error reporting (see the trace and errors libraries) share the LED route too
+    CMD_QUERY_TRACE                 = (CMD_MODULE_ID_LEDS       | 0x20),    // Loads the read register with the oldest trace events
+    CMD_DUMP_TRACE                  = (CMD_MODULE_ID_LEDS       | 0x21),    // Prints every trace event over USB stdio
+    CMD_QUERY_ERRORS                = (CMD_MODULE_ID_LEDS       | 0x22),    // Loads the read register with the error counts and latest errors; see errors_pack()
+    // Settings (see the settings library) share the LED route too
+    CMD_SETTING_GET                 = (CMD_MODULE_ID_LEDS       | 0x23),    // Must start a frame, then the key (2 bytes). Loads the read register with whether it's set (1 byte) and its value (4 bytes)
+    CMD_SETTING_SET                 = (CMD_MODULE_ID_LEDS       | 0x24),    // Must start a frame, then the key (2 bytes) and its value (4 bytes). Saved to flash
+    CMD_RESTART                     = (CMD_MODULE_ID_LEDS       | 0x25),    // Warm restart: the LCD and servo carry on where they were (see board/warmboot.h)
+    CMD_QUERY_MEMORY                = (CMD_MODULE_ID_LEDS       | 0x26),    // Loads the read register with the arenas' and heap's usage; see arena_pack()
+    CMD_QUERY_STACKS                = (CMD_MODULE_ID_LEDS       | 0x27),    // Loads the read register with each core's stack size and most used; see stackmon_pack()
+    // Every LCD code is taken on the eyebrows, so the theme lives here, but it is dispatched with the LCD commands
+    CMD_LCD_SET_THEME               = (CMD_MODULE_ID_LEDS       | 0x28),    // | theme; see gfx_set_theme()
+    // Logs (see the errors library) share the LED route too
+    CMD_QUERY_LOG                   = (CMD_MODULE_ID_LEDS       | 0x2C),    // Takes the oldest queued log messages and loads the read register with them, unformatted; see log_pack()
+#ifndef MOUTH
+    // All 64 servo codes are positions, so the servo status query lives here
+    CMD_QUERY_SERVO_STATUS          = (CMD_MODULE_ID_LEDS       | 0x30),    // Loads the read register; see servo.h for the layout
+    CMD_SERVO_SET_DURATION          = (CMD_MODULE_ID_LEDS       | 0x38),    // | duration index; see servo_set_move_duration()
+#endif // MOUTH
     // Commands for LCD
     CMD_LCD_TEST                    = (CMD_MODULE_ID_LCD        | 0x11),
     CMD_LCD_OFF                     = (CMD_MODULE_ID_LCD        | 0x22),
@@ -44,8 +101,11 @@ typedef enum {
     CMD_LCD_MOUTH_OPEN_SMILE        = (CMD_MODULE_ID_LCD        | 0x05),
     CMD_LCD_MOUTH_ZIG_ZAG           = (CMD_MODULE_ID_LCD        | 0x06),
     CMD_LCD_MOUTH_TALK              = (CMD_MODULE_ID_LCD        | 0x07),
+    CMD_LCD_MOUTH_PARAMS            = (CMD_MODULE_ID_LCD        | 0x08),    // Then curve, openness, and tilt bytes; see mouthgfx.h
+    CMD_LCD_MOUTH_VISEME            = (CMD_MODULE_ID_LCD        | 0x30),    // | viseme ID, then a hold byte; see mouthgfx.h
 #else
     CMD_LCD_DRAW                    = (CMD_MODULE_ID_LCD        | 0x30),    // See eyebrowsgfx.h for the schema
+    CMD_LCD_DRAW_VERTICES           = (CMD_MODULE_ID_LCD        | 0x09),    // Then a height byte for each vertex pair; see eyebrowsgfx.h
     // Commands for servos
     CMD_SERVO_TURN                  = (CMD_MODULE_ID_SERVO      | 0x3F)     // Servo commands accept 6 bits converted to degrees of rotation
 #endif // MOUTH
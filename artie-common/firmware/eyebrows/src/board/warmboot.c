@@ -0,0 +1,52 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/watchdog.h"
+#include "pico/stdlib.h"
+// Local includes
+#include "warmboot.h"
+
+/** In scratch register 0 while we run. Bump it if the slots change meaning, so a restart into new firmware is cold. */
+#define WARMBOOT_MAGIC 0x57524D01
+
+/** The slots as they were when we started. They're overwritten as we go. */
+static uint32_t kept[WARMBOOT_SLOT_SERVO_POSITION + 1];
+
+/** Is this a warm restart? */
+static bool warm = false;
+
+void warmboot_init(void)
+{
+    warm = WARM_BOOT && watchdog_caused_reboot() && (watchdog_hw->scratch[0] == WARMBOOT_MAGIC);
+    for (uint slot = WARMBOOT_SLOT_EXPRESSION; slot < count_of(kept); slot++)
+    {
+        kept[slot] = warm ? watchdog_hw->scratch[slot] : 0;
+        watchdog_hw->scratch[slot] = kept[slot];
+    }
+    watchdog_hw->scratch[0] = WARMBOOT_MAGIC;
+}
+
+bool warmboot_is_warm(void)
+{
+    return warm;
+}
+
+bool warmboot_get(warmboot_slot_t slot, uint32_t *value)
+{
+    if (!warm || (kept[slot] == 0))
+    {
+        return false;
+    }
+    *value = kept[slot];
+    return true;
+}
+
+void warmboot_restart(void)
+{
+    watchdog_reboot(0, 0, 0);
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
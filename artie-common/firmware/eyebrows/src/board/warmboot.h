@@ -0,0 +1,61 @@
+/**
+ * @file warmboot.h
+ * @brief Tells a warm restart (the watchdog, or CMD_RESTART) from a cold boot, and carries
+ * a little state across it in the watchdog's scratch registers, which only a power cycle
+ * or the RUN pin clears.
+ *
+ * After a warm restart the LCD is still set up and showing the last expression, and the
+ * servo's calibration still holds, so they can pick up where they left off instead of
+ * starting over.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/watchdog.h"
+
+#ifndef WARM_BOOT
+    /**
+     * Pick up where we left off after a warm restart. Needs the LCD's reset line to stay high
+     * while we restart (its breakout's pull-up does, against the RP2040's pull-down), or the
+     * picture is lost with the panel's configuration.
+     */
+    #define WARM_BOOT 1
+#endif // WARM_BOOT
+
+/** What we keep across a warm restart. Each is a watchdog scratch register (the SDK has 4 to 7). 0 means it isn't kept. */
+typedef enum {
+    WARMBOOT_SLOT_EXPRESSION        = 1,    // The LCD command for what the LCD shows (see graphics_expression())
+    WARMBOOT_SLOT_SERVO_LIMITS      = 2,    // The servo's calibrated safe range: left | right << 16, in PWM counts
+    WARMBOOT_SLOT_SERVO_POSITION    = 3,    // Where the servo was last sent, in PWM counts
+} warmboot_slot_t;
+
+/** Work out whether this is a warm restart, and take what was kept across it. Call first thing in main(). */
+void warmboot_init(void);
+
+/** Is this a warm restart (with WARM_BOOT)? */
+bool warmboot_is_warm(void);
+
+/**
+ * @brief Get something kept across the warm restart we just had.
+ *
+ * @return false after a cold boot, or if it wasn't kept.
+ */
+bool warmboot_get(warmboot_slot_t slot, uint32_t *value);
+
+/** Keep something for after the next warm restart. Safe from either core and from IRQs. */
+static inline void warmboot_set(warmboot_slot_t slot, uint32_t value)
+{
+    watchdog_hw->scratch[slot] = value;
+}
+
+/** Restart warm, through the watchdog. */
+void warmboot_restart(void) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
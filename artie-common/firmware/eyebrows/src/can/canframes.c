@@ -0,0 +1,150 @@
+// Std lib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+// Library includes
+#include <bwacp.h>
+#include <errors.h>
+#include <msgpack.h>
+#include <rpcacp.h>
+// Local includes
+#include "../board/types.h"
+#include "../graphics/commongfx.h"
+#include "../graphics/graphics.h"
+#include "canframes.h"
+
+/** A delta frame on its way through the graphics core, in the BWACP buffer it arrived in. */
+typedef struct {
+    const bwacp_block_t *block;
+    gfx_delta_t delta;
+    volatile bool busy;             ///< Posted to the graphics core, and not done with yet
+} slot_t;
+
+/** One for each BWACP buffer, so every block that arrives has somewhere to go. */
+static slot_t slots[BWACP_NUM_BUFFERS];
+
+/** A frame the graphics core had no room for yet, or NULL. */
+static slot_t *held = NULL;
+
+/** Delta frames handed to the graphics core, and blocks turned away before they got there. */
+static uint32_t frames_posted = 0;
+static uint32_t blocks_rejected = 0;
+
+/** On the graphics core: the frame's block can go back for the next one. Wake the main loop for it. */
+static void frame_done(uintptr_t arg)
+{
+    slot_t *slot = &slots[arg];
+    bwacp_release_block(slot->block);
+    slot->busy = false;
+    __dmb();
+    __sev();
+}
+
+/** Hand a frame to the graphics core. Returns false if its queue is full; try again later. */
+static bool post(slot_t *slot)
+{
+    const gfx_blit_t blit = {
+        .delta = &slot->delta,
+        .done = &frame_done,
+        .arg = (uintptr_t)(slot - slots),
+    };
+    slot->busy = true;
+    if (!graphics_blit(&blit))
+    {
+        slot->busy = false;
+        return false;
+    }
+    frames_posted++;
+    return true;
+}
+
+static slot_t *free_slot(void)
+{
+    for (size_t i = 0; i < BWACP_NUM_BUFFERS; i++)
+    {
+        if (!slots[i].busy && (&slots[i] != held))
+        {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * RPC_ID_QUERY_FRAME_STREAM: a MsgPack array of the delta frame the paint buffer holds (-1 for none),
+ * the frames handed to the graphics core and the blocks turned away since boot, the most bytes a
+ * block can have, and the format frames must be rendered at: scale, width_memory, height_memory.
+ */
+static int rpc_query_frame_stream(rpcacp_call_t *call)
+{
+    gfx_frame_t format;
+    gfx_frame_format(&format);
+
+    msgpack_writer_t writer;
+    msgpack_writer_init(&writer, call->data, RPCACP_BUFFER_LEN);
+    msgpack_write_array(&writer, 7);
+    msgpack_write_int(&writer, gfx_delta_shown());
+    msgpack_write_uint(&writer, frames_posted);
+    msgpack_write_uint(&writer, blocks_rejected);
+    msgpack_write_uint(&writer, BWACP_BLOCK_LEN);
+    msgpack_write_uint(&writer, format.scale);
+    msgpack_write_uint(&writer, format.width_memory);
+    msgpack_write_uint(&writer, format.height_memory);
+    call->len = writer.len;
+    return 0;
+}
+
+void canframes_init(void)
+{
+    if (bwacp_init(BWACP_CLASS_MCU))
+    {
+        rpcacp_register(RPC_ID_QUERY_FRAME_STREAM, &rpc_query_frame_stream);
+    }
+}
+
+void canframes_task(void)
+{
+    if (held != NULL)
+    {
+        if (!post(held))
+        {
+            // The graphics core wakes us when it takes something off its queue
+            return;
+        }
+        held = NULL;
+    }
+
+    while (true)
+    {
+        // There's a slot for every buffer, but a block's slot is only free once the graphics core says so
+        slot_t *slot = free_slot();
+        if (slot == NULL)
+        {
+            return;
+        }
+        const bwacp_block_t *block = bwacp_get_block();
+        if (block == NULL)
+        {
+            return;
+        }
+
+        if ((block->address != CANFRAMES_BLOCK_ADDRESS) || !gfx_delta_parse(block->data, (uint32_t)block->len, &slot->delta))
+        {
+            log_error("Block of %u bytes at 0x%08lX from 0x%02X is not a delta frame.\n",
+                      (unsigned)block->len, (unsigned long)block->address, block->writer);
+            set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+            blocks_rejected++;
+            bwacp_release_block(block);
+            continue;
+        }
+
+        slot->block = block;
+        if (!post(slot))
+        {
+            held = slot;
+            return;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file canframes.h
+ * @brief Takes frames rendered on the controller over CAN, when built with CAN_FRAMES: each one a
+ * BWACP block (see the bwacp library) holding a delta frame (see gfx_delta_t in commongfx.h),
+ * the tiles of the picture that changed since the frame before, which the graphics core decodes
+ * straight into the paint buffer. Only what changed goes over the bus, so animation that the
+ * faces can't draw themselves still fits in CAN's bandwidth.
+ *
+ * A block written to CANFRAMES_BLOCK_ADDRESS, at this node's address or multicast to the MCUs,
+ * is a delta frame; anything else is an error. Both eyebrows can take the same multicast frames.
+ *
+ * A delta frame only makes sense against the frame it was made from, so the controller sends a key
+ * frame first, then deltas, each against the one before. One that doesn't match what the paint
+ * buffer holds (a face command drew in between, say, or a block went missing) is turned away, and
+ * RPC_ID_QUERY_FRAME_STREAM tells the controller what frame we hold, so it knows to send a key frame.
+ *
+ * Needs the rtacp and rpcacp modules started first, and a paint buffer: a banded build (the mouth's
+ * default) turns every delta frame away.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** BWACP block address of a delta frame: "GFX" and the format's version (GFX_DELTA_VERSION). */
+#define CANFRAMES_BLOCK_ADDRESS 0x47465801UL
+
+/** Start taking blocks. Call after rtacp_init() and rpcacp_init(), and before graphics_init(). */
+void canframes_init(void);
+
+/**
+ * Hand the graphics core whatever delta frames have come in that it has room for.
+ * Call from every pass of the main loop.
+ */
+void canframes_task(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,127 +1,2524 @@
 // Std lib includes
 #include <stdio.h>
+#include <string.h>
 // SDK includes
+#include "hardware/sync.h"
+#include "pico/time.h"
 // Library includes
+#include <arena.h>
+#include <bist.h>
 #include <errors.h>
-#include "lcd/LCD/LCD_1in14.h"
-#include "lcd/LCD/LCD_2in.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include <intercore.h>
+#include <metrics.h>
+#include <trace.h>
+#include <LCD_1in14.h>
+#include <LCD_2in.h>
+#include <LCD_Panel.h>
+#include <GUI_Paint.h>
 // Local includes
 #include "commongfx.h"
 
-/** Union of two functions since they have slightly different signatures. */
-typedef union {
-    void (*display_1in14)(UWORD *);
-    void (*display_2in)(UBYTE *);
-} lcd_display_function_t;
+/**
+ * The LCD's panel, picked by gfx_init(). Everything goes through the one LCD_Panel driver,
+ * which keeps the panel's size in its current scan direction in LCD_ACTIVE.
+ */
+static const LCD_PANEL *panel = &LCD_1IN14_PANEL;
 
-/** "Class" describing the LCD. */
+/**
+ * Both faces are drawn in landscape. The LCD controller turns the picture to suit how the panel
+ * is mounted (MADCTL), so the paint buffer is laid out just like the picture and Paint draws
+ * straight into it, with no rotation.
+ */
+#define LCD_SCAN_DIR HORIZONTAL
+
+/** Size of the picture, which the paint buffer is laid out against. */
+#define LCD_PICTURE_WIDTH (panel->Scan[LCD_SCAN_DIR].Width)
+#define LCD_PICTURE_HEIGHT (panel->Scan[LCD_SCAN_DIR].Height)
+
+/**
+ * Is the panel mounted upside down from its landscape scan? The mouth's always is; the left
+ * eyebrow's is too (see gfx_set_upside_down()). The controller turns the picture over.
+ */
+#ifdef MOUTH
+static bool upside_down = true;
+#else
+static bool upside_down = false;
+#endif // MOUTH
+
+#ifndef GFX_PAINT_SCALE
+    /**
+     * Paint buffer format, using GUI_Paint's Paint_SetScale() values:
+     * 2 -> 1 bpp black/white, 4 -> 2 bpp grayscale, 65 -> RGB565.
+     * The compact formats are expanded to RGB565 through a small palette as they are sent.
+     * The faces are pure black and white, so default to 1 bpp.
+     */
+    #define GFX_PAINT_SCALE 2
+#endif // GFX_PAINT_SCALE
+
+#if (GFX_PAINT_SCALE != 2) && (GFX_PAINT_SCALE != 4) && (GFX_PAINT_SCALE != 65)
+    #error "GFX_PAINT_SCALE must be one of 2, 4, or 65"
+#endif
+
+#ifndef GFX_LCD_12BIT
+    /**
+     * Set to 1 to send the LCD 12 bits a pixel (RGB444, two pixels in three bytes) instead of
+     * RGB565, which takes a quarter off every transfer. Only the compact formats can, since they
+     * are expanded on the way out anyway, and their palette loses nothing at 4 bits a channel.
+     */
+    #if GFX_PAINT_SCALE == 65
+        #define GFX_LCD_12BIT 0
+    #else
+        #define GFX_LCD_12BIT 1
+    #endif
+#endif // GFX_LCD_12BIT
+
+#if GFX_LCD_12BIT && (GFX_PAINT_SCALE == 65)
+    #error "GFX_LCD_12BIT needs a GFX_PAINT_SCALE of 2 or 4"
+#endif
+
+#ifndef GFX_ROW_HASH
+    /**
+     * Set to 1 to keep a hash of each buffer row as it was last sent to the LCD, and only send the
+     * rows of a frame whose hash has changed, in runs. Clearing and redrawing a picture marks all of
+     * it dirty, even where it comes out the same, so this keeps a redraw of a nearly identical
+     * picture off the bus for the cost of hashing the rows.
+     */
+    #define GFX_ROW_HASH 1
+#endif // GFX_ROW_HASH
+
+#ifndef GFX_DOUBLE_BUFFER
+    /**
+     * Set to 1 to paint into a back buffer while the front buffer streams out to the LCD.
+     * Needs room for two paint buffers, which we only have with the compact formats on the mouth.
+     */
+    #if GFX_PAINT_SCALE == 65
+        #define GFX_DOUBLE_BUFFER 0
+    #else
+        #define GFX_DOUBLE_BUFFER 1
+    #endif
+#endif // GFX_DOUBLE_BUFFER
+
+#if GFX_DOUBLE_BUFFER
+    #define NUM_PAINT_BUFFERS 2
+#else
+    #define NUM_PAINT_BUFFERS 1
+#endif // GFX_DOUBLE_BUFFER
+
+/** Dimensions of the paint buffer in memory, which are the picture's. See init_paint_buffer(). */
+#ifdef MOUTH
+    #define PAINT_WIDTH_MEMORY LCD_2IN_WIDTH
+    #define PAINT_HEIGHT_MEMORY LCD_2IN_HEIGHT
+#else
+    #define PAINT_WIDTH_MEMORY LCD_1IN14_HEIGHT
+    #define PAINT_HEIGHT_MEMORY LCD_1IN14_WIDTH
+#endif // MOUTH
+
+/** Bytes per row of the paint buffer. Must agree with Paint_SetScale()'s idea of WidthByte. */
+#if GFX_PAINT_SCALE == 2
+    #define PAINT_ROW_BYTES ((PAINT_WIDTH_MEMORY + 7) / 8)
+#elif GFX_PAINT_SCALE == 4
+    #define PAINT_ROW_BYTES ((PAINT_WIDTH_MEMORY + 3) / 4)
+#else
+    #define PAINT_ROW_BYTES (PAINT_WIDTH_MEMORY * 2)
+#endif // GFX_PAINT_SCALE
+
+/** Bits a pixel takes in the paint buffer, for turning a delta tile's bytes into columns. */
+#if GFX_PAINT_SCALE == 2
+    #define PAINT_PIXEL_BITS 1
+#elif GFX_PAINT_SCALE == 4
+    #define PAINT_PIXEL_BITS 2
+#else
+    #define PAINT_PIXEL_BITS 16
+#endif // GFX_PAINT_SCALE
+
+/** Number of bytes in a paint buffer */
+#define IMAGE_SIZE (PAINT_ROW_BYTES * PAINT_HEIGHT_MEMORY)
+
+/** Number of tiles the scene is repainted in (see gfx_scene_show()). The last one may be short. */
+#define NUM_TILES ((PAINT_HEIGHT_MEMORY + GFX_BAND_ROWS - 1) / GFX_BAND_ROWS)
+
+#if GFX_BANDED
+    /** Number of bands the picture is painted in. They are the scene's tiles. */
+    #define NUM_BANDS NUM_TILES
+
+    #if (GFX_PAINT_SCALE != 65) && GFX_DUAL_CORE
+        /** Compact bands are handed to the main core to expand and send (see gfx_band_assist()). */
+        #define BAND_HANDOFF 1
+    #else
+        #define BAND_HANDOFF 0
+    #endif // GFX_PAINT_SCALE && GFX_DUAL_CORE
+
+    #if GFX_PAINT_SCALE == 65
+        /** RGB565 bands go out as they are, so one is painted while the other is on the bus. */
+        #define NUM_BAND_BUFFERS 2
+    #elif BAND_HANDOFF
+        /** One is painted while the main core expands and sends the other. */
+        #define NUM_BAND_BUFFERS 2
+    #else
+        /** Compact bands are expanded into the line buffers as they go out, so one will do. */
+        #define NUM_BAND_BUFFERS 1
+    #endif // GFX_PAINT_SCALE
+
+    /** Bytes in a band buffer */
+    #define BAND_BUFFER_SIZE (PAINT_ROW_BYTES * GFX_BAND_ROWS)
+
+    /** Where the band buffers come from */
+    ARENA_DEFINE(gfx_arena, "gfx", ARENA_SIZE_FOR(NUM_BAND_BUFFERS, BAND_BUFFER_SIZE));
+
+    /** The strips of buffer rows we paint into and send to the LCD, in place of a paint buffer */
+    static UBYTE *band_buffers[NUM_BAND_BUFFERS] = {NULL};
+
+    /** Which bands of the LCD might be showing something other than white. */
+    static bool band_inked[NUM_BANDS];
+
+    /** Index into band_buffers of the band that went out last, or -1 if none has since the reset. */
+    static int band_on_lcd = -1;
+
+    /** Is the LCD showing the display list (rather than the scene), so gfx_set_theme() replays it? */
+    static bool list_on_lcd = false;
+#else
+    #define BAND_HANDOFF 0
+
+    /** Where the paint buffers come from. In .bss, so a build whose buffers don't fit in RAM fails to link. */
+    ARENA_DEFINE(gfx_arena, "gfx", ARENA_SIZE_FOR(NUM_PAINT_BUFFERS, IMAGE_SIZE));
+
+    /** The buffers we paint into and send to the LCD for display */
+    static UBYTE *paint_buffers[NUM_PAINT_BUFFERS] = {NULL};
+#endif // GFX_BANDED
+
+/** Widest LCD row we might need to expand. */
+#define LINE_BUFFER_PIXELS ((LCD_2IN_WIDTH > LCD_1IN14_HEIGHT) ? LCD_2IN_WIDTH : LCD_1IN14_HEIGHT)
+
+/** Swap a colour's bytes so it goes out over SPI high byte first. */
+#define SPI_ORDER(color) ((UWORD)((((color) & 0xFF) << 8) | ((color) >> 8)))
+
+/** Bytes that n pixels take on the LCD bus. At RGB444, n must be even. */
+#if GFX_LCD_12BIT
+    #define LINE_BYTES(n) (((uint32_t)(n) * 3) / 2)
+#else
+    #define LINE_BYTES(n) ((uint32_t)(n) * 2)
+#endif // GFX_LCD_12BIT
+
+/** Two rows of pixels as they go to the LCD, alternated so we can expand one while the other is on the bus. */
+static UWORD line_buffers[2][LINE_BUFFER_PIXELS];
+
+#if GFX_PAINT_SCALE != 65
+/** Ink (what Paint's BLACK becomes) and paper (WHITE) of each theme, in RGB565. */
+static const struct {
+    UWORD ink;
+    UWORD paper;
+} themes[GFX_THEME_COUNT] = {
+    [GFX_THEME_DAY]     = {BLACK, WHITE},
+    [GFX_THEME_NIGHT]   = {0x7800, BLACK},
+    [GFX_THEME_WARM]    = {0x4140, 0xFEF5},
+    [GFX_THEME_COOL]    = {0x0010, 0xCEFF},
+};
+#endif // GFX_PAINT_SCALE
+
+/** The theme's paper, in RGB565: what the LCD is cleared to. */
+static UWORD paper = WHITE;
+
+/*
+ * The palettes below start out as GFX_THEME_DAY. gfx_set_theme() fills them in for the others,
+ * with the grays of the 2 bpp format a third and two thirds of the way from ink to paper.
+ */
+#if GFX_LCD_12BIT
+    /** RGB444 colour of each palette index. Index 0 is what Paint writes for BLACK. */
+    #if GFX_PAINT_SCALE == 2
+        static UWORD palette[2] = {LCD_PANEL_RGB444(BLACK), LCD_PANEL_RGB444(WHITE)};
+    #else
+        static UWORD palette[4] = {LCD_PANEL_RGB444(BLACK), LCD_PANEL_RGB444(0x52AA), LCD_PANEL_RGB444(0xAD55), LCD_PANEL_RGB444(WHITE)};
+    #endif // GFX_PAINT_SCALE
+#elif GFX_PAINT_SCALE != 65
+    /** RGB565 colour of each palette index, ready to send. Index 0 is what Paint writes for BLACK. */
+    #if GFX_PAINT_SCALE == 2
+        static UWORD palette[2] = {SPI_ORDER(BLACK), SPI_ORDER(WHITE)};
+    #else
+        static UWORD palette[4] = {SPI_ORDER(BLACK), SPI_ORDER(0x52AA), SPI_ORDER(0xAD55), SPI_ORDER(WHITE)};
+    #endif // GFX_PAINT_SCALE
+#endif // GFX_LCD_12BIT
+
+/** Time between frames of the render loop. See gfx_wait_for_frame(). */
+#define FRAME_PERIOD_US (1000000 / GFX_FRAME_RATE_HZ)
+
+/** When the next frame of the render loop is due. */
+static absolute_time_t next_frame_time;
+
+/** A PackBits decode that can stop and carry on, so a frame can be copied in a band at a time. */
+typedef struct {
+    const uint8_t *src;
+    const uint8_t *end;
+    uint32_t literal;       ///< Literal bytes left in the current run
+    uint32_t repeat;        ///< Repeats left in the current run
+    uint8_t value;          ///< The byte being repeated
+} packbits_reader_t;
+
+/** A step of the display list. */
+typedef struct {
+    const gfx_frame_t *frame;   ///< The frame to copy in, or NULL to call the painter
+    gfx_painter_t painter;
+    uintptr_t arg;
+    packbits_reader_t reader;   ///< How far the frame has been copied in
+} list_op_t;
+
+/** The display list for the next gfx_list_show(). */
+static list_op_t display_list[GFX_LIST_MAX_OPS];
+static size_t display_list_len = 0;
+
+/** An element of the scene. */
+typedef struct {
+    gfx_painter_t painter;      ///< NULL if there is no element with this ID
+    uintptr_t arg;
+    PAINT_RECT area;            ///< Its box in memory coordinates, clipped to the picture
+} scene_element_t;
+
+/** The retained picture gfx_scene_show() brings the LCD up to date with, in ID order. */
+static scene_element_t scene[GFX_SCENE_MAX_ELEMENTS];
+
+/** Which tiles (GFX_BAND_ROWS buffer rows apiece) the LCD may be showing wrong for the scene. */
+static bool tile_dirty[NUM_TILES];
+
+/** A slide in progress (see gfx_list_slide()). The LCD is scrolled by however much has come in. */
+typedef struct {
+    bool active;
+    int16_t step;               ///< Columns a step: positive in from the right, negative in from the left
+    UWORD shown;                ///< Columns of the new picture showing so far
+} slide_t;
+
+static slide_t slide = {.active = false};
+
+/** Number of the delta frame the paint buffer holds, or -1. Anything else that draws sets it back to -1. See gfx_delta_shown(). */
+static volatile int32_t delta_shown = -1;
+
+#if GFX_ABORT_FLUSH
+/** Asked between the rows of a frame going out whether there is a newer one. See gfx_set_superseded_check(). */
+static gfx_superseded_t superseded_check = NULL;
+
+/** May the frame going out be cut short? Not if the one before it was. */
+static bool flush_stoppable = true;
+#endif // GFX_ABORT_FLUSH
+
+/** Was the last frame cut short for a newer one? */
+static bool flush_stopped = false;
+
+/** A frame starts going out to the LCD. */
+static void begin_flush(void)
+{
+#if GFX_ABORT_FLUSH
+    flush_stoppable = !flush_stopped;
+#endif // GFX_ABORT_FLUSH
+    flush_stopped = false;
+}
+
+/** Between the rows of the frame going out: should it stop here, for a newer one? Once it says so, it keeps saying so. */
+static bool flush_superseded(void)
+{
+#if GFX_ABORT_FLUSH
+    if (flush_stoppable && !flush_stopped && (superseded_check != NULL) && superseded_check())
+    {
+        flush_stopped = true;
+    }
+#endif // GFX_ABORT_FLUSH
+    return flush_stopped;
+}
+
+#if GFX_PERF_OVERLAY
+/** Time spent sending the frame being drawn so far, in us. See gfx_overlay_frame(). */
+static uint32_t frame_flush_us = 0;
+#endif // GFX_PERF_OVERLAY
+
+/** Account for a flush of the picture to the LCD that took us. */
+static inline void note_flush(uint32_t us)
+{
+    metrics_timing(METRICS_TIMING_LCD_FLUSH, us);
+#if GFX_PERF_OVERLAY
+    frame_flush_us += us;
+#endif // GFX_PERF_OVERLAY
+}
+
+static void stop_slide(void);
+
+#if GFX_ROW_HASH
+/** Hash (see hash_row()) of each buffer row as the LCD shows it, or 0 if we don't know what it shows. */
+static uint32_t row_hashes[PAINT_HEIGHT_MEMORY];
+
+/** Hash a buffer row. Never 0. */
+static uint32_t HOT_FUNC(hash_row)(const UBYTE *row, size_t nbytes)
+{
+    // A word at a time: xor it in, multiply, and fold the high bits back down. Each step is
+    // one-to-one for a given word, so two rows that differ in just one word never collide.
+    uint32_t hash = 0x811C9DC5;
+    size_t i = 0;
+    for (; (i + 4) <= nbytes; i += 4)
+    {
+        uint32_t word;
+        memcpy(&word, row + i, sizeof(word));
+        hash = (hash ^ word) * 0x9E3779B1;
+        hash ^= hash >> 16;
+    }
+    for (; i < nbytes; i++)
+    {
+        hash = (hash ^ row[i]) * 0x9E3779B1;
+        hash ^= hash >> 16;
+    }
+    return hash | 0x01;
+}
+#endif // GFX_ROW_HASH
+
+/** Forget what the LCD shows in buffer rows ystart up to yend, after something has gone to it another way. */
+static void forget_rows(UWORD ystart, UWORD yend)
+{
+#if GFX_ROW_HASH
+    for (UWORD y = ystart; (y < yend) && (y < PAINT_HEIGHT_MEMORY); y++)
+    {
+        row_hashes[y] = 0;
+    }
+#endif // GFX_ROW_HASH
+}
+
+#if !GFX_BANDED
+/** Index into paint_buffers of the one we paint into. The other one (if any) is on the LCD. */
+static uint8_t back_buffer_index = 0;
+
+/** Region of the paint buffer (memory coordinates) that may hold something other than background. */
+static PAINT_RECT inked = {0, 0, 0, 0};
+
+/**
+ * Region that changed but hasn't been sent to the LCD yet, other than by drawing: wiped by
+ * gfx_clear_paint_buffer(), or left over from a frame that was cut short.
+ */
+static PAINT_RECT pending_erase = {0, 0, 0, 0};
+
+#if !GFX_DOUBLE_BUFFER
+/**
+ * Passes once the DMA has stopped reading the paint buffer. Only set when a transfer streams straight
+ * from it: the compact formats are expanded into line buffers, so the paint buffer is free once they return.
+ */
+static gfx_fence_t paint_buffer_fence = 0;
+#endif // GFX_DOUBLE_BUFFER
+
+#if (GFX_PAINT_SCALE == 65) && GFX_ABORT_FLUSH
+/** Region (memory coordinates) of the last frame's transfer straight from the paint buffer, and its fence. */
+static PAINT_RECT rows_in_flight = {0, 0, 0, 0};
+static gfx_fence_t rows_fence = 0;
+#endif // GFX_PAINT_SCALE && GFX_ABORT_FLUSH
+
+/** Dirty regions narrower than 1/DIRTY_COLUMN_CLIP_RATIO of the panel get column-clipped too (at the cost of a blocking send). */
+#define DIRTY_COLUMN_CLIP_RATIO 2
+
+/** The buffer we are currently painting into. */
+static inline UBYTE *back_buffer(void)
+{
+    return paint_buffers[back_buffer_index];
+}
+
+static void reset_dirty_tracking(void)
+{
+    Paint_ResetDirty();
+    inked = (PAINT_RECT){0, 0, 0, 0};
+    pending_erase = (PAINT_RECT){0, 0, 0, 0};
+}
+#else
+/** Mark every band of the LCD as (possibly) showing something, or as all white. */
+static void set_bands_inked(bool inked)
+{
+    for (size_t i = 0; i < NUM_BANDS; i++)
+    {
+        band_inked[i] = inked;
+    }
+}
+#endif // GFX_BANDED
+
+/** Take every element out of the scene. If repaint, the next gfx_scene_show() repaints every tile. */
+static void reset_scene(bool repaint)
+{
+    memset(scene, 0, sizeof(scene));
+    for (size_t i = 0; i < NUM_TILES; i++)
+    {
+        tile_dirty[i] = repaint;
+    }
+}
+
+/** Mark every tile the given area (memory coordinates) touches as needing a repaint. */
+static void mark_tiles_dirty(const PAINT_RECT *area)
+{
+    if (area->Yend <= area->Ystart)
+    {
+        return;
+    }
+    const size_t last = (size_t)(area->Yend - 1) / GFX_BAND_ROWS;
+    for (size_t i = area->Ystart / GFX_BAND_ROWS; (i <= last) && (i < NUM_TILES); i++)
+    {
+        tile_dirty[i] = true;
+    }
+}
+
+/** Take the paint (or band) buffers from the arena, the first time through. */
+static bool alloc_buffers(void)
+{
+#if GFX_BANDED
+    UBYTE **const buffers = band_buffers;
+    const size_t nbuffers = NUM_BAND_BUFFERS;
+    const size_t size = BAND_BUFFER_SIZE;
+#else
+    UBYTE **const buffers = paint_buffers;
+    const size_t nbuffers = NUM_PAINT_BUFFERS;
+    const size_t size = IMAGE_SIZE;
+#endif // GFX_BANDED
+
+    if (buffers[0] != NULL)
+    {
+        // gfx_resume() after gfx_init()
+        return true;
+    }
+
+    for (size_t i = 0; i < nbuffers; i++)
+    {
+        buffers[i] = (UBYTE *)arena_alloc(&gfx_arena, size);
+        if (buffers[i] == NULL)
+        {
+            log_error("Failed to allocate paint buffer %u. LCD will be unavailable.\n", (unsigned)i);
+            set_errno(ERR_ID_GRAPHICS_MODULE, ENOMEM);
+            buffers[0] = NULL;
+            return false;
+        }
+    }
+    arena_seal(&gfx_arena);
+    return true;
+}
+
+static void init_paint_buffer(void)
+{
+    if (!alloc_buffers())
+    {
+        return;
+    }
+
+#if GFX_BANDED
+    UBYTE *const first = band_buffers[0];
+#else
+    UBYTE *const first = back_buffer();
+#endif // GFX_BANDED
+
+    Paint_NewImage(first, LCD_PICTURE_WIDTH, LCD_PICTURE_HEIGHT, ROTATE_0, WHITE);
+    Paint_SetScale(GFX_PAINT_SCALE);
+    // The LCD was just cleared, or kept whatever it was showing
+    forget_rows(0, PAINT_HEIGHT_MEMORY);
+#if GFX_BANDED
+    // Between pictures, Paint is left on a band
+    Paint_SelectBand(first, 0, GFX_BAND_ROWS);
+    Paint_Clear(WHITE);
+    Paint_ResetDirty();
+#else
+    for (size_t i = 0; i < NUM_PAINT_BUFFERS; i++)
+    {
+        Paint_SelectImage(paint_buffers[i]);
+        Paint_Clear(WHITE);
+    }
+    Paint_SelectImage(back_buffer());
+    reset_dirty_tracking();
+#endif // GFX_BANDED
+}
+
+uint16_t gfx_lcd_width(void)
+{
+    return LCD_PICTURE_WIDTH;
+}
+
+uint16_t gfx_lcd_height(void)
+{
+    return LCD_PICTURE_HEIGHT;
+}
+
+void gfx_set_upside_down(bool turned)
+{
+    upside_down = turned;
+    LCD_Panel_SetRotate180(turned);
+}
+
+void gfx_frame_clock_start(void)
+{
+    next_frame_time = get_absolute_time();
+}
+
+void gfx_wait_for_frame(void)
+{
+    metrics_idle_begin();
+    const absolute_time_t now = get_absolute_time();
+    if (absolute_time_diff_us(now, next_frame_time) > 0)
+    {
+        sleep_until(next_frame_time);
+    }
+    else if (absolute_time_diff_us(next_frame_time, now) > FRAME_PERIOD_US)
+    {
+        // We fell more than a frame behind. Drop the missed frames rather than rushing to catch up.
+        next_frame_time = now;
+    }
+    next_frame_time = delayed_by_us(next_frame_time, FRAME_PERIOD_US);
+
+#if LCD_TE_PIN >= 0
+    // Start on the panel's V-blank so it never scans out a half-sent frame.
+    // Give up after a frame in case the line is missing or the panel is off.
+    DEV_TE_Wait(FRAME_PERIOD_US);
+#endif // LCD_TE_PIN
+    metrics_idle_end();
+}
+
+void gfx_wait_for_lcd(void)
+{
+    DEV_SPI_DMA_Wait();
+}
+
+/** Guards the idle sleep figures against the main core. A striped lock, like the metrics library's. */
+#define IDLE_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST + 4)
+
+/** Longest idle sleep time gfx_set_idle_sleep() takes, in ms: what fits in a uint32_t of us. */
+#define IDLE_SLEEP_MAX_MS (UINT32_MAX / 1000U)
+
+/** How long gfx_idle_receive() waits before the LCD sleeps, in us, or 0 to never sleep. */
+static uint32_t idle_sleep_us = 0;
+
+/** When the LCD last went to sleep: it has to be left LCD_PANEL_SLEEP_MS before waking. */
+static absolute_time_t slept_at;
+
+/** Is the first frame since the LCD woke still to go out? Since when (time_us_32()), if so. */
+static bool waking = false;
+static uint32_t wake_start = 0;
+
+static gfx_idle_stats_t idle_stats;
+
+/** Have idle_stats changed since gfx_idle_update() last said so? */
+static bool idle_changed = false;
+
+void gfx_set_idle_sleep(uint32_t ms)
+{
+    idle_sleep_us = ((ms > IDLE_SLEEP_MAX_MS) ? IDLE_SLEEP_MAX_MS : ms) * 1000U;
+}
+
+/** Backlight, panel, and then the bus's clock off. The panel keeps its picture. */
+static void lcd_sleep(void)
+{
+    LCD_Panel_Sleep(true);
+    DEV_Module_Sleep(true);
+    slept_at = get_absolute_time();
+
+    const uint32_t saved = spin_lock_blocking(IDLE_LOCK);
+    idle_stats.sleeps++;
+    idle_changed = true;
+    spin_unlock(IDLE_LOCK, saved);
+}
+
+/** Undo lcd_sleep(). Whatever comes next is timed until its frame is out: see gfx_flush_rest(). */
+static void lcd_wake(void)
+{
+    wake_start = time_us_32();
+    DEV_Module_Sleep(false);
+    sleep_until(delayed_by_ms(slept_at, LCD_PANEL_SLEEP_MS));
+    LCD_Panel_Sleep(false);
+    waking = true;
+}
+
+/** Keep how long the LCD took to wake, to its first frame. */
+static void note_wake(uint32_t us)
+{
+    const uint32_t saved = spin_lock_blocking(IDLE_LOCK);
+    idle_stats.last_wake_us = us;
+    if (us > idle_stats.worst_wake_us)
+    {
+        idle_stats.worst_wake_us = us;
+    }
+    idle_changed = true;
+    spin_unlock(IDLE_LOCK, saved);
+}
+
+void gfx_idle_receive(struct intercore_channel *channel, void *item)
+{
+    metrics_idle_begin();
+    const uint32_t timeout_us = idle_sleep_us;
+    if (timeout_us == 0)
+    {
+        intercore_receive_blocking(channel, item);
+        metrics_idle_end();
+        return;
+    }
+    if (intercore_receive_timeout_us(channel, item, timeout_us))
+    {
+        metrics_idle_end();
+        return;
+    }
+
+    // Nothing for a while: sleep until something comes in, then wake up to show it
+    lcd_sleep();
+    intercore_receive_blocking(channel, item);
+    metrics_idle_end();
+    lcd_wake();
+}
+
+void gfx_idle_stats(gfx_idle_stats_t *stats)
+{
+    const uint32_t saved = spin_lock_blocking(IDLE_LOCK);
+    *stats = idle_stats;
+    spin_unlock(IDLE_LOCK, saved);
+}
+
+bool gfx_idle_update(void)
+{
+    const uint32_t saved = spin_lock_blocking(IDLE_LOCK);
+    const bool was_changed = idle_changed;
+    idle_changed = false;
+    spin_unlock(IDLE_LOCK, saved);
+    return was_changed;
+}
+
+gfx_fence_t gfx_fence(void)
+{
+    return DEV_SPI_DMA_Started();
+}
+
+bool gfx_fence_passed(gfx_fence_t fence)
+{
+    // The counts are free-running, so compare them by difference
+    return (int32_t)(DEV_SPI_DMA_Finished() - fence) >= 0;
+}
+
+void gfx_fence_wait(gfx_fence_t fence)
+{
+    // Transfers go out one at a time, in order, so one that hasn't passed is in flight
+    while (!gfx_fence_passed(fence))
+    {
+        DEV_SPI_DMA_Wait();
+    }
+}
+
+void gfx_set_superseded_check(gfx_superseded_t superseded)
+{
+#if GFX_ABORT_FLUSH
+    superseded_check = superseded;
+#endif // GFX_ABORT_FLUSH
+}
+
+bool gfx_flush_stopped(void)
+{
+    return flush_stopped;
+}
+
+#if !BAND_HANDOFF
+bool gfx_band_assist(void)
+{
+    // Nothing is handed over: the graphics core sends every band itself
+    return false;
+}
+#endif // BAND_HANDOFF
+
+/** Start reading PackBits data. */
+static void packbits_begin(packbits_reader_t *reader, const uint8_t *src, uint32_t size)
+{
+    reader->src = src;
+    reader->end = src + size;
+    reader->literal = 0;
+    reader->repeat = 0;
+    reader->value = 0;
+}
+
+/**
+ * Decode the next nbytes into dst. The data must have been checked with packbits_valid();
+ * if it runs out anyway, the rest of dst is filled with background.
+ */
+static void packbits_read(packbits_reader_t *reader, UBYTE *dst, uint32_t nbytes)
+{
+    while (nbytes > 0)
+    {
+        uint32_t n;
+        if (reader->literal > 0)
+        {
+            n = (reader->literal < nbytes) ? reader->literal : nbytes;
+            memcpy(dst, reader->src, n);
+            reader->src += n;
+            reader->literal -= n;
+        }
+        else if (reader->repeat > 0)
+        {
+            n = (reader->repeat < nbytes) ? reader->repeat : nbytes;
+            memset(dst, reader->value, n);
+            reader->repeat -= n;
+        }
+        else if (reader->src < reader->end)
+        {
+            const uint8_t header = *reader->src++;
+            if (header < 128)
+            {
+                reader->literal = (uint32_t)header + 1;
+            }
+            else if ((header > 128) && (reader->src < reader->end))
+            {
+                reader->repeat = 257 - (uint32_t)header;
+                reader->value = *reader->src++;
+            }
+            // 128 is a no-op
+            continue;
+        }
+        else
+        {
+            memset(dst, 0xFF, nbytes);
+            return;
+        }
+        dst += n;
+        nbytes -= n;
+    }
+}
+
+/** Does the PackBits data decode to exactly nbytes, with nothing left over? */
+static bool packbits_valid(const uint8_t *src, uint32_t size, uint32_t nbytes)
+{
+    const uint8_t *end = src + size;
+    uint32_t decoded = 0;
+    while (src < end)
+    {
+        const uint8_t header = *src++;
+        if (header < 128)
+        {
+            // Literal run
+            const uint32_t n = (uint32_t)header + 1;
+            if ((uint32_t)(end - src) < n)
+            {
+                return false;
+            }
+            src += n;
+            decoded += n;
+        }
+        else if (header > 128)
+        {
+            // Repeated byte
+            if (src == end)
+            {
+                return false;
+            }
+            src++;
+            decoded += 257 - (uint32_t)header;
+        }
+        // 128 is a no-op
+
+        if (decoded > nbytes)
+        {
+            return false;
+        }
+    }
+    return decoded == nbytes;
+}
+
+/** Was the frame rendered for the buffer format, size, and orientation we paint at? */
+static bool frame_suits(const gfx_frame_t *frame)
+{
+    return (frame != NULL) &&
+           (frame->scale == Paint.Scale) && (frame->rotate == Paint.Rotate) &&
+           (frame->width_memory == Paint.WidthMemory) && (frame->height_memory == Paint.HeightMemory) &&
+           (frame->bounds.Yend <= Paint.HeightMemory) && (frame->bounds.Ystart <= frame->bounds.Yend) &&
+           (frame->bounds.Xend <= Paint.WidthMemory) && (frame->bounds.Xstart <= frame->bounds.Xend);
+}
+
+/** Does a frame that suits us (see frame_suits()) decode to exactly its band of rows? */
+static bool frame_valid(const gfx_frame_t *frame)
+{
+    const uint32_t nbytes = (uint32_t)(frame->bounds.Yend - frame->bounds.Ystart) * Paint.WidthByte;
+    return packbits_valid(frame->data, frame->size, nbytes);
+}
+
+/**
+ * Copy in the rows of a display list frame that fall in buffer rows ystart up to yend, into buf,
+ * which holds the rows from ystart. The frame's reader must have been started, and the rows
+ * must come in order.
+ */
+static void copy_frame_rows(list_op_t *op, UBYTE *buf, UWORD ystart, UWORD yend)
+{
+    const PAINT_RECT *bounds = &op->frame->bounds;
+    const UWORD from = (bounds->Ystart > ystart) ? bounds->Ystart : ystart;
+    const UWORD to = (bounds->Yend < yend) ? bounds->Yend : yend;
+    if (to <= from)
+    {
+        return;
+    }
+    packbits_read(&op->reader, buf + (size_t)(from - ystart) * Paint.WidthByte, (uint32_t)(to - from) * Paint.WidthByte);
+    Paint_MarkDirty(bounds->Xstart, from, bounds->Xend, to);
+}
+
+/** Add a step to the display list. Returns it, or NULL if the list is full. */
+static list_op_t *list_add(const gfx_frame_t *frame, gfx_painter_t painter, uintptr_t arg)
+{
+    if (display_list_len == GFX_LIST_MAX_OPS)
+    {
+        log_error("Display list is full.\n");
+        set_errno(ERR_ID_GRAPHICS_MODULE, ENOMEM);
+        return NULL;
+    }
+    list_op_t *op = &display_list[display_list_len++];
+    op->frame = frame;
+    op->painter = painter;
+    op->arg = arg;
+    return op;
+}
+
+void gfx_list_begin(void)
+{
+    display_list_len = 0;
+}
+
+void gfx_list_add_painter(gfx_painter_t painter, uintptr_t arg)
+{
+    if (painter != NULL)
+    {
+        list_add(NULL, painter, arg);
+    }
+}
+
+void gfx_list_add_frame(const gfx_frame_t *frame, gfx_painter_t fallback, uintptr_t arg)
+{
+    if (frame_suits(frame))
+    {
+        if (frame_valid(frame))
+        {
+            list_add(frame, NULL, 0);
+            return;
+        }
+        log_error("Pre-rendered frame is corrupt.\n");
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+    }
+    gfx_list_add_painter(fallback, arg);
+}
+
+/** Paint the display list into buf, which holds buffer rows ystart up to yend (the whole buffer, unless banded). */
+static void HOT_FUNC(replay_list)(UBYTE *buf, UWORD ystart, UWORD yend)
+{
+    for (size_t i = 0; i < display_list_len; i++)
+    {
+        list_op_t *op = &display_list[i];
+        if (op->frame != NULL)
+        {
+            copy_frame_rows(op, buf, ystart, yend);
+        }
+        else
+        {
+            op->painter(op->arg);
+        }
+    }
+}
+
+/** Start copying in each of the display list's frames from its first row. */
+static void start_list_frames(void)
+{
+    for (size_t i = 0; i < display_list_len; i++)
+    {
+        if (display_list[i].frame != NULL)
+        {
+            packbits_begin(&display_list[i].reader, display_list[i].frame->data, display_list[i].frame->size);
+        }
+    }
+}
+
+void gfx_scene_set(uint8_t id, gfx_painter_t painter, uintptr_t arg, const gfx_box_t *box)
+{
+    if (id >= GFX_SCENE_MAX_ELEMENTS)
+    {
+        log_error("Illegal scene element %u\n", id);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    if (painter == NULL)
+    {
+        gfx_scene_remove(id);
+        return;
+    }
+
+    PAINT_RECT area = {0, 0, Paint.WidthMemory, Paint.HeightMemory};
+    if ((box != NULL) && !Paint_WindowToMemory(box->xstart, box->ystart, box->xend, box->yend, &area))
+    {
+        // Entirely off the picture, so it never needs painting
+        area = (PAINT_RECT){0, 0, 0, 0};
+    }
+
+    scene_element_t *element = &scene[id];
+    if ((element->painter == painter) && (element->arg == arg) && (memcmp(&element->area, &area, sizeof(area)) == 0))
+    {
+        return;
+    }
+
+    // Repaint where it was (to wipe it) and where it is now
+    mark_tiles_dirty(&element->area);
+    mark_tiles_dirty(&area);
+    element->painter = painter;
+    element->arg = arg;
+    element->area = area;
+}
+
+void gfx_scene_remove(uint8_t id)
+{
+    if (id >= GFX_SCENE_MAX_ELEMENTS)
+    {
+        log_error("Illegal scene element %u\n", id);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    mark_tiles_dirty(&scene[id].area);
+    scene[id] = (scene_element_t){.painter = NULL};
+}
+
+/** Paint the scene elements that overlap buffer rows ystart up to yend. Paint must be clipped to those rows. */
+static void HOT_FUNC(replay_scene)(UBYTE *buf, UWORD ystart, UWORD yend)
+{
+    for (size_t i = 0; i < GFX_SCENE_MAX_ELEMENTS; i++)
+    {
+        const scene_element_t *element = &scene[i];
+        if ((element->painter != NULL) && (element->area.Ystart < yend) && (element->area.Yend > ystart))
+        {
+            element->painter(element->arg);
+        }
+    }
+}
+
+#if !GFX_BANDED
+/**
+ * A newer frame is on its way while the last one may still be streaming out of the paint buffer. If it is,
+ * and it may be cut short, stop it, and leave the rows it didn't get to for the newer frame to send.
+ */
+static void stop_superseded_rows(void)
+{
+#if (GFX_PAINT_SCALE == 65) && GFX_ABORT_FLUSH
+    if (!flush_stoppable || flush_stopped || (gfx_fence() != rows_fence) || gfx_fence_passed(rows_fence))
+    {
+        return;
+    }
+
+    // Back from LCD rows to the buffer rows they came from, the way send_region_to_lcd() went
+    const uint32_t lcd_row_bytes = (uint32_t)LCD_ACTIVE.WIDTH * 2;
+    const UWORD lcd_row = LCD_Panel_StopRows_DMA();
+    UWORD sent = (UWORD)(((uint32_t)lcd_row * lcd_row_bytes) / Paint.WidthByte);
+    if (sent < rows_in_flight.Ystart)
+    {
+        sent = rows_in_flight.Ystart;
+    }
+    if (sent >= rows_in_flight.Yend)
+    {
+        // It finished after all
+        return;
+    }
+
+    flush_stopped = true;
+    forget_rows(sent, rows_in_flight.Yend);
+    const PAINT_RECT rest = {rows_in_flight.Xstart, sent, rows_in_flight.Xend, rows_in_flight.Yend};
+    Paint_RectUnion(&pending_erase, &rest);
+#endif // GFX_PAINT_SCALE && GFX_ABORT_FLUSH
+}
+
+void gfx_wait_for_paint_buffer(void)
+{
+#if !GFX_DOUBLE_BUFFER
+    // We're about to paint a newer frame, so the last one needn't finish
+    stop_superseded_rows();
+
+    // The only buffer we have may still be streaming out. Anything sent after it can carry on.
+    gfx_fence_wait(paint_buffer_fence);
+#endif // GFX_DOUBLE_BUFFER
+}
+
+void gfx_clear_paint_buffer(void)
+{
+    stop_slide();
+    gfx_wait_for_paint_buffer();
+
+    // Only the part of the buffer we have drawn into since the last clear can be non-white.
+    // Wipe just that, and remember it so the next flush sends the erase along with whatever gets drawn.
+    PAINT_RECT already_dirty;
+    Paint_GetDirty(&already_dirty);
+    Paint_ClearMemoryWindow(&inked, WHITE);
+    Paint_RectUnion(&pending_erase, &already_dirty);
+    Paint_RectUnion(&pending_erase, &inked);
+    inked = (PAINT_RECT){0, 0, 0, 0};
+    Paint_ResetDirty();
+
+    // The scene is gone with the rest of the picture
+    reset_scene(true);
+    delta_shown = -1;
+}
+
+bool gfx_show_frame(const gfx_frame_t *frame)
+{
+    if ((back_buffer() == NULL) || !frame_suits(frame))
+    {
+        return false;
+    }
+    if (!frame_valid(frame))
+    {
+        log_error("Pre-rendered frame is corrupt.\n");
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return false;
+    }
+
+    gfx_clear_paint_buffer();
+
+    // Everything outside the band is background, which the clear just took care of.
+    // The band is whole rows, so it decodes straight into place.
+    list_op_t op = {.frame = frame};
+    packbits_begin(&op.reader, frame->data, frame->size);
+    copy_frame_rows(&op, back_buffer(), 0, Paint.HeightMemory);
+    gfx_swap_buffers();
+    return true;
+}
+#endif // GFX_BANDED
+
+#if GFX_PAINT_SCALE == 65
+    #if !GFX_BANDED
+/**
+ * Send the given region (memory coordinates) of the back buffer to the LCD. Returns the buffer row
+ * it got up to, which is always the end: a stoppable transfer is cut short later, by stop_superseded_rows().
+ */
+static UWORD send_region_to_lcd(const PAINT_RECT *r, bool stoppable)
+{
+    const UWORD panel_width = LCD_ACTIVE.WIDTH;
+    const UWORD panel_height = LCD_ACTIVE.HEIGHT;
+
+    if ((Paint.WidthMemory == panel_width) && ((r->Xend - r->Xstart) * DIRTY_COLUMN_CLIP_RATIO <= panel_width))
+    {
+        // Buffer rows line up with LCD rows and the region is narrow, so clip on both axes.
+        LCD_Panel_DisplayWindows(r->Xstart, r->Ystart, r->Xend, r->Yend, back_buffer());
+        return r->Yend;
+    }
+
+    // Otherwise send the band of full-width LCD rows that covers the dirty buffer rows.
+    // Work in bytes so this holds even if the buffer's row length differs from the LCD's.
+    const uint32_t lcd_row_bytes = (uint32_t)panel_width * 2;
+    const uint32_t first_byte = (uint32_t)r->Ystart * Paint.WidthByte;
+    const uint32_t last_byte = (uint32_t)r->Yend * Paint.WidthByte;
+    UWORD ystart = first_byte / lcd_row_bytes;
+    UWORD yend = (last_byte + lcd_row_bytes - 1) / lcd_row_bytes;
+    if (yend > panel_height)
+    {
+        yend = panel_height;
+    }
+    if (ystart >= yend)
+    {
+        return r->Yend;
+    }
+
+    // Returns as soon as the transfer has started, which goes on reading the buffer
+    LCD_Panel_DisplayRows_DMA(ystart, yend, back_buffer());
+#if !GFX_DOUBLE_BUFFER
+    paint_buffer_fence = gfx_fence();
+#endif // GFX_DOUBLE_BUFFER
+#if GFX_ABORT_FLUSH
+    if (stoppable)
+    {
+        rows_in_flight = *r;
+        rows_fence = gfx_fence();
+    }
+#endif // GFX_ABORT_FLUSH
+    return r->Yend;
+}
+    #endif // GFX_BANDED
+#else
+/** Palette index of the pixel in column x of a buffer row. */
+static inline UBYTE palette_index(const UBYTE *row, UWORD x)
+{
+    #if GFX_PAINT_SCALE == 2
+    return (row[x >> 3] >> (7 - (x & 0x07))) & 0x01;
+    #else
+    return (row[x >> 2] >> (6 - ((x & 0x03) << 1))) & 0x03;
+    #endif // GFX_PAINT_SCALE
+}
+
+    #if GFX_LCD_12BIT
+/**
+ * Pack count pixels into RGB444, two to three bytes, starting at (x, y) in buffer memory and walking
+ * row-major (wrapping onto the next memory row as needed). x, count, and the buffer's width must be
+ * even, so a pair never straddles two rows.
+ */
+static void HOT_FUNC(expand_pixels)(const UBYTE *buf, UWORD x, UWORD y, UWORD count, UWORD *out)
+{
+    const UBYTE *row = buf + (size_t)y * Paint.WidthByte;
+    UBYTE *bytes = (UBYTE *)out;
+    for (UWORD i = 0; i < count; i += 2)
+    {
+        const UWORD first = palette[palette_index(row, x)];
+        const UWORD second = palette[palette_index(row, x + 1)];
+        *bytes++ = (UBYTE)(first >> 4);
+        *bytes++ = (UBYTE)((first << 4) | (second >> 8));
+        *bytes++ = (UBYTE)second;
+
+        x += 2;
+        if (x == Paint.WidthMemory)
+        {
+            x = 0;
+            row += Paint.WidthByte;
+        }
+    }
+}
+    #else
+/**
+ * Expand count pixels to SPI-ordered RGB565, starting at (x, y) in buffer memory and walking
+ * row-major (wrapping onto the next memory row as needed).
+ */
+static void HOT_FUNC(expand_pixels)(const UBYTE *buf, UWORD x, UWORD y, UWORD count, UWORD *out)
+{
+    const UBYTE *row = buf + (size_t)y * Paint.WidthByte;
+    for (UWORD i = 0; i < count; i++)
+    {
+        out[i] = palette[palette_index(row, x)];
+
+        x++;
+        if (x == Paint.WidthMemory)
+        {
+            x = 0;
+            row += Paint.WidthByte;
+        }
+    }
+}
+    #endif // GFX_LCD_12BIT
+
+    #if !GFX_BANDED
+/**
+ * Send the given region (memory coordinates) of the back buffer to the LCD, expanding it a row at a time.
+ * Returns the buffer row it got up to: the end, unless it was stoppable and cut short for a newer frame.
+ */
+static UWORD send_region_to_lcd(const PAINT_RECT *r, bool stoppable)
+{
+    const UWORD panel_width = LCD_ACTIVE.WIDTH;
+    const UWORD panel_height = LCD_ACTIVE.HEIGHT;
+    UWORD xstart, ystart, xend, yend;
+
+    if (Paint.WidthMemory == panel_width)
+    {
+        // Buffer rows line up with LCD rows, so we can send exactly the region.
+        xstart = r->Xstart;
+        ystart = r->Ystart;
+        xend = r->Xend;
+        yend = r->Yend;
+    #if GFX_LCD_12BIT
+        // Out to even columns (the LCD's width is even), so every row is whole pairs
+        xstart &= ~0x01;
+        xend = (xend + 1) & ~0x01;
+    #endif // GFX_LCD_12BIT
+    }
+    else
+    {
+        // Otherwise send the band of full-width LCD rows covering the dirty buffer rows.
+        // The LCD consumes pixels in the same order they sit in the buffer, so go by pixel index.
+        const uint32_t first_pixel = (uint32_t)r->Ystart * Paint.WidthMemory;
+        const uint32_t last_pixel = (uint32_t)r->Yend * Paint.WidthMemory;
+        xstart = 0;
+        xend = panel_width;
+        ystart = first_pixel / panel_width;
+        yend = (last_pixel + panel_width - 1) / panel_width;
+        if (yend > panel_height)
+        {
+            yend = panel_height;
+        }
+    }
+
+    if ((xend <= xstart) || (yend <= ystart) || ((xend - xstart) > LINE_BUFFER_PIXELS))
+    {
+        return r->Yend;
+    }
+    if (stoppable && flush_superseded())
+    {
+        return r->Ystart;
+    }
+
+    // This waits for any previous transfer, so both line buffers are free after it.
+    LCD_Panel_BeginPixels(xstart, ystart, xend, yend);
+
+    const UWORD npixels = xend - xstart;
+    for (UWORD y = ystart; y < yend; y++)
+    {
+        // Index (in buffer order) of the first pixel of this LCD row
+        const uint32_t p = (uint32_t)y * panel_width + xstart;
+        if (stoppable && (y > ystart) && flush_superseded())
+        {
+            // Close the window here. The buffer row this LCD row starts in goes again, with the rest.
+            LCD_Panel_EndPixels();
+            return (UWORD)(p / Paint.WidthMemory);
+        }
+        UWORD *line = line_buffers[y & 0x01];
+        expand_pixels(back_buffer(), p % Paint.WidthMemory, p / Paint.WidthMemory, npixels, line);
+
+        // Waits for the previous row (in the other line buffer) before starting this one
+        LCD_Panel_WritePixels_DMA((const UBYTE *)line, LINE_BYTES(npixels), y == (yend - 1));
+    }
+    return r->Yend;
+}
+    #endif // GFX_BANDED
+#endif // GFX_PAINT_SCALE
+
+void gfx_send_rle_image(const PAINT_RLE_IMAGE *image, UWORD x, UWORD y, UWORD fg, UWORD bg)
+{
+    const UWORD xend = x + image->Width;
+    const UWORD yend = y + image->Height;
+    if ((image->Width == 0) || (image->Width > LINE_BUFFER_PIXELS) ||
+        (xend > LCD_ACTIVE.WIDTH) || (yend > LCD_ACTIVE.HEIGHT))
+    {
+        log_error("RLE image (%u x %u at %u, %u) does not fit the LCD.\n", image->Width, image->Height, x, y);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    forget_rows(y, yend);
+    delta_shown = -1;
+
+#if GFX_LCD_12BIT
+    const UWORD colors[2] = {LCD_PANEL_RGB444(bg), LCD_PANEL_RGB444(fg)};
+    // A row with an odd number of pixels ends half way through a byte, which the next row finishes
+    UBYTE carry = 0;
+    bool half = false;
+#else
+    const UWORD colors[2] = {SPI_ORDER(bg), SPI_ORDER(fg)};
+#endif // GFX_LCD_12BIT
+    PAINT_RLE_DECODER decoder;
+    Paint_RLE_Begin(&decoder, image);
+
+    // This waits for any previous transfer, so both line buffers are free after it.
+    LCD_Panel_BeginPixels(x, y, xend, yend);
+    for (UWORD row = 0; row < image->Height; row++)
+    {
+        UWORD *line = line_buffers[row & 0x01];
+        UWORD i = 0;
+#if GFX_LCD_12BIT
+        UBYTE *bytes = (UBYTE *)line;
+        UDOUBLE nbytes = 0;
+#endif // GFX_LCD_12BIT
+        while (i < image->Width)
+        {
+            bool foreground;
+            UWORD n = Paint_RLE_NextSpan(&decoder, image->Width - i, &foreground);
+            if (n == 0)
+            {
+                // Short data: pad with background so the LCD still gets the whole window
+                n = image->Width - i;
+                foreground = false;
+            }
+            const UWORD color = colors[foreground ? 1 : 0];
+#if GFX_LCD_12BIT
+            for (i += n; n > 0; n--)
+            {
+                if (half)
+                {
+                    bytes[nbytes++] = carry | (UBYTE)(color >> 8);
+                    bytes[nbytes++] = (UBYTE)color;
+                }
+                else
+                {
+                    bytes[nbytes++] = (UBYTE)(color >> 4);
+                    carry = (UBYTE)(color << 4);
+                }
+                half = !half;
+            }
+#else
+            for (; n > 0; n--)
+            {
+                line[i++] = color;
+            }
+#endif // GFX_LCD_12BIT
+        }
+
+        const bool last = row == (image->Height - 1);
+#if GFX_LCD_12BIT
+        if (last && half)
+        {
+            // The panel drops the padding nibble when the write ends
+            bytes[nbytes++] = carry;
+        }
+#else
+        const UDOUBLE nbytes = (UDOUBLE)image->Width * 2;
+#endif // GFX_LCD_12BIT
+
+        // Waits for the previous row (in the other line buffer) before starting this one
+        LCD_Panel_WritePixels_DMA((const UBYTE *)line, nbytes, last);
+    }
+}
+
+#if GFX_PERF_OVERLAY
+/** The overlay's font, and the size of its glyphs. */
+#define OVERLAY_FONT Font12
+#define OVERLAY_GLYPH_WIDTH 7
+#define OVERLAY_GLYPH_HEIGHT 12
+
+/** Characters of the overlay's text, which is always the same length: "30fps P12345 F12345". */
+#define OVERLAY_CHARS 19
+
+/** Size of the overlay in pixels. Its width is even, so its rows are whole pairs at RGB444. */
+#define OVERLAY_WIDTH (((OVERLAY_CHARS * OVERLAY_GLYPH_WIDTH) + 1) & ~0x01)
+#define OVERLAY_HEIGHT OVERLAY_GLYPH_HEIGHT
+
+/** Bytes per row of the overlay's buffer, at 1 bpp. */
+#define OVERLAY_ROW_BYTES ((OVERLAY_WIDTH + 7) / 8)
+
+/** Largest value each field of the overlay's text has room for. */
+#define OVERLAY_MAX_FPS 99
+#define OVERLAY_MAX_US 99999
+
+/** What the overlay is drawn into, then streamed to the LCD from. Paint's WHITE is a set bit. */
+static UBYTE overlay_buffer[OVERLAY_ROW_BYTES * OVERLAY_HEIGHT];
+
+/** Frames drawn since overlay_window_start, and the rate over the last whole window. */
+static uint32_t overlay_frames = 0;
+static uint32_t overlay_fps = 0;
+static uint32_t overlay_window_start = 0;
+
+/** Value of the overlay's pixel in column x of a buffer row: 0 for BLACK, 1 for WHITE. */
+static inline UBYTE overlay_pixel(const UBYTE *row, UWORD x)
+{
+    return (row[x >> 3] >> (7 - (x & 0x07))) & 0x01;
+}
+
+/** Clamp value to max, so it fits its field of the overlay's text. */
+static inline uint32_t overlay_clamp(uint32_t value, uint32_t max)
+{
+    return (value > max) ? max : value;
+}
+
+/** Stream the overlay's buffer to the top left corner of the LCD, white on black whatever the theme. */
+static void send_overlay(void)
+{
+    #if GFX_LCD_12BIT
+    const UWORD colors[2] = {LCD_PANEL_RGB444(BLACK), LCD_PANEL_RGB444(WHITE)};
+    #else
+    const UWORD colors[2] = {SPI_ORDER(BLACK), SPI_ORDER(WHITE)};
+    #endif // GFX_LCD_12BIT
+
+    // This waits for any previous transfer, so both line buffers are free after it.
+    LCD_Panel_BeginPixels(0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    for (UWORD y = 0; y < OVERLAY_HEIGHT; y++)
+    {
+        const UBYTE *row = overlay_buffer + (size_t)y * OVERLAY_ROW_BYTES;
+        UWORD *line = line_buffers[y & 0x01];
+    #if GFX_LCD_12BIT
+        UBYTE *bytes = (UBYTE *)line;
+        for (UWORD x = 0; x < OVERLAY_WIDTH; x += 2)
+        {
+            const UWORD first = colors[overlay_pixel(row, x)];
+            const UWORD second = colors[overlay_pixel(row, x + 1)];
+            *bytes++ = (UBYTE)(first >> 4);
+            *bytes++ = (UBYTE)((first << 4) | (second >> 8));
+            *bytes++ = (UBYTE)second;
+        }
+    #else
+        for (UWORD x = 0; x < OVERLAY_WIDTH; x++)
+        {
+            line[x] = colors[overlay_pixel(row, x)];
+        }
+    #endif // GFX_LCD_12BIT
+
+        // Waits for the previous row (in the other line buffer) before starting this one
+        LCD_Panel_WritePixels_DMA((const UBYTE *)line, LINE_BYTES(OVERLAY_WIDTH), y == (OVERLAY_HEIGHT - 1));
+    }
+}
+#endif // GFX_PERF_OVERLAY
+
+void gfx_overlay_frame(uint32_t frame_us)
+{
+#if GFX_PERF_OVERLAY
+    const uint32_t now = time_us_32();
+    const uint32_t elapsed = now - overlay_window_start;
+    overlay_frames++;
+    if (elapsed >= 1000000)
+    {
+        // Over however long the window ran, which is longer than a second if the loop was idle
+        overlay_fps = (uint32_t)(((uint64_t)overlay_frames * 1000000) / elapsed);
+        overlay_frames = 0;
+        overlay_window_start = now;
+    }
+
+    const uint32_t paint_us = (frame_us > frame_flush_us) ? (frame_us - frame_flush_us) : 0;
+    // Room for any uint32_t in each field (the compiler can't see the clamps), though each fits its width
+    char text[48];
+    snprintf(text, sizeof(text), "%2lufps P%5lu F%5lu",
+             (unsigned long)overlay_clamp(overlay_fps, OVERLAY_MAX_FPS),
+             (unsigned long)overlay_clamp(paint_us, OVERLAY_MAX_US),
+             (unsigned long)overlay_clamp(frame_flush_us, OVERLAY_MAX_US));
+    frame_flush_us = 0;
+
+    // Borrow Paint for the overlay's buffer, so the text comes from the glyph cache like any other
+    PAINT_STATE state;
+    Paint_SaveState(&state);
+    Paint_NewImage(overlay_buffer, OVERLAY_WIDTH, OVERLAY_HEIGHT, ROTATE_0, BLACK);
+    Paint_Clear(BLACK);
+    Paint_DrawString_EN(0, 0, text, &OVERLAY_FONT, WHITE, BLACK);
+    Paint_RestoreState(&state);
+
+    send_overlay();
+#endif // GFX_PERF_OVERLAY
+}
+
+#if GFX_BANDED
+/** Is the band all background? White is all ones in every format. */
+static bool HOT_FUNC(band_is_blank)(const UBYTE *buf, size_t nbytes)
+{
+    const uint32_t *words = (const uint32_t *)buf;
+    for (size_t i = 0; i < (nbytes / 4); i++)
+    {
+        if (words[i] != 0xFFFFFFFF)
+        {
+            return false;
+        }
+    }
+    for (size_t i = nbytes & ~(size_t)0x03; i < nbytes; i++)
+    {
+        if (buf[i] != 0xFF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Send columns xstart up to xend of a band (buffer rows ystart up to yend, in buf) to the LCD.
+ * Buffer rows are LCD rows, so this is its own window. At RGB444, xstart and xend must be even.
+ * Returns as soon as the last of it has started.
+ */
+static void send_band(const UBYTE *buf, UWORD ystart, UWORD yend, UWORD xstart, UWORD xend)
+{
+    const UWORD nrows = yend - ystart;
+    const UWORD npixels = xend - xstart;
+
+    // This waits for the band before, so the line buffers are free after it.
+    LCD_Panel_BeginPixels(xstart, ystart, xend, yend);
+#if GFX_PAINT_SCALE == 65
+    if (npixels == Paint.WidthMemory)
+    {
+        // Whole rows are all of the band buffer, in one go
+        LCD_Panel_WritePixels_DMA(buf, (uint32_t)nrows * Paint.WidthByte, true);
+        return;
+    }
+    for (UWORD y = 0; y < nrows; y++)
+    {
+        // Waits for the previous row before starting this one
+        LCD_Panel_WritePixels_DMA(buf + (size_t)y * Paint.WidthByte + (size_t)xstart * 2, (UDOUBLE)npixels * 2, y == (nrows - 1));
+    }
+#else
+    for (UWORD y = 0; y < nrows; y++)
+    {
+        UWORD *line = line_buffers[y & 0x01];
+        expand_pixels(buf, xstart, y, npixels, line);
+
+        // Waits for the previous row (in the other line buffer) before starting this one
+        LCD_Panel_WritePixels_DMA((const UBYTE *)line, LINE_BYTES(npixels), y == (nrows - 1));
+    }
+#endif // GFX_PAINT_SCALE
+}
+
+/**
+ * Send the whole rows of a band (buffer rows ystart up to yend, in buf) that the LCD isn't showing
+ * already, in runs. Returns false if there weren't any.
+ */
+static bool send_changed_band_rows(const UBYTE *buf, UWORD ystart, UWORD yend)
+{
+#if GFX_ROW_HASH
+    bool sent = false;
+    UWORD run_start = yend;
+    for (UWORD y = ystart; y <= yend; y++)
+    {
+        bool changed = false;
+        if (y < yend)
+        {
+            const uint32_t hash = hash_row(buf + (size_t)(y - ystart) * Paint.WidthByte, Paint.WidthByte);
+            changed = hash != row_hashes[y];
+            row_hashes[y] = hash;
+        }
+        if (changed && (run_start == yend))
+        {
+            run_start = y;
+        }
+        else if (!changed && (run_start != yend))
+        {
+            send_band(buf + (size_t)(run_start - ystart) * Paint.WidthByte, run_start, y, 0, Paint.WidthMemory);
+            run_start = yend;
+            sent = true;
+        }
+    }
+    return sent;
+#else
+    send_band(buf, ystart, yend, 0, Paint.WidthMemory);
+    return true;
+#endif // GFX_ROW_HASH
+}
+
+/** Buffer rows ystart up to yend of a band. The last one may be short. */
+static inline void band_rows(size_t band, UWORD *ystart, UWORD *yend)
+{
+    *ystart = (UWORD)(band * GFX_BAND_ROWS);
+    *yend = ((*ystart + GFX_BAND_ROWS) < Paint.HeightMemory) ? (*ystart + GFX_BAND_ROWS) : Paint.HeightMemory;
+}
+
+/**
+ * Send columns xstart up to xend of a painted band, in band buffer index, and note what the LCD shows now.
+ * Unless always, it is only sent if it has ink in it or had ink in it last time (to wipe it).
+ * With BAND_HANDOFF, runs on whichever core took the band (see take_band()).
+ */
+static void send_painted_band(int index, size_t band, UWORD xstart, UWORD xend, bool always, bool inked)
+{
+    UWORD ystart, yend;
+    band_rows(band, &ystart, &yend);
+    const UBYTE *buf = band_buffers[index];
+    if (always)
+    {
+        send_band(buf, ystart, yend, xstart, xend);
+        forget_rows(ystart, yend);
+        band_on_lcd = index;
+    }
+    else if (inked || band_inked[band])
+    {
+        TRACE_BEGIN(TRACE_ID_LCD_FLUSH, yend - ystart);
+        const uint32_t flush_start = time_us_32();
+        if (send_changed_band_rows(buf, ystart, yend))
+        {
+            band_on_lcd = index;
+        }
+        note_flush(time_us_32() - flush_start);
+        TRACE_END(TRACE_ID_LCD_FLUSH, yend - ystart);
+    }
+    band_inked[band] = inked;
+}
+
+#if BAND_HANDOFF
+/** Guards the band handoff between the cores. A striped lock, like the metrics library's. */
+#define BAND_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST + 5)
+
+/** Where a band buffer is in the handoff. */
+typedef enum {
+    BAND_FREE = 0,      ///< Can be painted into
+    BAND_PAINTED,       ///< Painted, waiting for a core to send it
+    BAND_SENDING,       ///< Being sent
+} band_state_t;
+
+/** A band buffer's band, and how to send it, once it is painted. */
 typedef struct {
-    UWORD width;
-    UWORD height;
-    void (*clear)(UWORD);
-    void (*init)(UBYTE);
-    lcd_display_function_t display;
-} lcd_t;
-
-static const lcd_display_function_t display_for_1in14_lcd = {.display_1in14 = &LCD_1IN14_Display};
-static const lcd_display_function_t display_for_2in_lcd = {.display_2in = &LCD_2IN_Display};
-
-/** If we are eyebrows, we use this LCD. */
-static const lcd_t eyebrows_lcd = {
-    .width = LCD_1IN14_WIDTH,
-    .height = LCD_1IN14_HEIGHT,
-    .clear = &LCD_1IN14_Clear,
-    .init = &LCD_1IN14_Init,
-    .display = display_for_1in14_lcd,
-};
+    volatile band_state_t state;
+    size_t band;
+    UWORD xstart;
+    UWORD xend;
+    bool always;
+    bool inked;
+} band_job_t;
+
+static band_job_t band_jobs[NUM_BAND_BUFFERS];
+
+/** Band buffer the graphics core paints into next. They are used in turn, so bands go out in order. */
+static size_t band_to_paint = 0;
+
+/** Band buffer to send next, and whether a core is sending one (only one has the bus). Under BAND_LOCK. */
+static size_t band_to_send = 0;
+static bool band_sending = false;
+
+/** Send the next painted band, unless there isn't one or a core is sending already. On either core. */
+static bool take_band(void)
+{
+    uint32_t saved = spin_lock_blocking(BAND_LOCK);
+    const size_t index = band_to_send;
+    band_job_t *job = &band_jobs[index];
+    const bool take = !band_sending && (job->state == BAND_PAINTED);
+    if (take)
+    {
+        job->state = BAND_SENDING;
+        band_sending = true;
+        band_to_send = (index + 1) % NUM_BAND_BUFFERS;
+    }
+    spin_unlock(BAND_LOCK, saved);
+    if (!take)
+    {
+        return false;
+    }
+
+    send_painted_band((int)index, job->band, job->xstart, job->xend, job->always, job->inked);
+
+    saved = spin_lock_blocking(BAND_LOCK);
+    job->state = BAND_FREE;
+    band_sending = false;
+    spin_unlock(BAND_LOCK, saved);
+    // The graphics core may be waiting for the buffer
+    __sev();
+    return true;
+}
+
+/** From the graphics core: wait until a band buffer is free, sending bands meanwhile if the main core doesn't. */
+static void wait_for_band_buffer(size_t index)
+{
+    while (band_jobs[index].state != BAND_FREE)
+    {
+        if (!take_band())
+        {
+            // The main core is sending one, and will __sev() once it's done
+            __wfe();
+        }
+    }
+}
+
+bool gfx_band_assist(void)
+{
+    return take_band();
+}
+#endif // BAND_HANDOFF
+
+/**
+ * Paint a band over white with replay (replay_list() or replay_scene()), into the next band buffer,
+ * and send columns xstart up to xend of it (see send_painted_band()). With BAND_HANDOFF, it is handed
+ * over to be sent instead, by the main core if it gets to it first, and this returns once it is painted;
+ * finish_bands() waits for the last of them.
+ */
+static void show_band(size_t band, void (*replay)(UBYTE *buf, UWORD ystart, UWORD yend), UWORD xstart, UWORD xend, bool always)
+{
+    UWORD ystart, yend;
+    band_rows(band, &ystart, &yend);
+#if BAND_HANDOFF
+    const int index = (int)band_to_paint;
+    wait_for_band_buffer(band_to_paint);
+    band_to_paint = (band_to_paint + 1) % NUM_BAND_BUFFERS;
+#else
+    // RGB565 bands go out straight from the band buffer, so paint into the one that didn't go out last.
+    // send_band() waits for the band before it, so the one before that has always finished.
+    const int index = (band_on_lcd + 1) % NUM_BAND_BUFFERS;
+#endif // BAND_HANDOFF
+    UBYTE *buf = band_buffers[index];
+
+    Paint_SelectBand(buf, ystart, yend);
+    Paint_Clear(WHITE);
+    replay(buf, ystart, yend);
+
+    const bool inked = !band_is_blank(buf, (size_t)(yend - ystart) * Paint.WidthByte);
+#if BAND_HANDOFF
+    band_job_t *job = &band_jobs[index];
+    job->band = band;
+    job->xstart = xstart;
+    job->xend = xend;
+    job->always = always;
+    job->inked = inked;
+    const uint32_t saved = spin_lock_blocking(BAND_LOCK);
+    job->state = BAND_PAINTED;
+    spin_unlock(BAND_LOCK, saved);
+    // Wake the main core to send it
+    __sev();
+#else
+    send_painted_band(index, band, xstart, xend, always, inked);
+#endif // BAND_HANDOFF
+}
+
+/** Wait until every band shown has been sent (by either core), so nothing else goes to the LCD in between. */
+static void finish_bands(void)
+{
+#if BAND_HANDOFF
+    for (size_t i = 0; i < NUM_BAND_BUFFERS; i++)
+    {
+        wait_for_band_buffer(i);
+    }
+#endif // BAND_HANDOFF
+}
+
+/** Send columns xstart up to xend of the display list, as it is painted. */
+static void send_list_columns(UWORD xstart, UWORD xend)
+{
+    start_list_frames();
+    for (size_t band = 0; band < NUM_BANDS; band++)
+    {
+        show_band(band, replay_list, xstart, xend, true);
+    }
+    finish_bands();
+}
+
+/** Start a slide: nothing to do until the steps, which paint the list as they go. */
+static void begin_slide(void)
+{
+    list_on_lcd = true;
+}
+
+/** Finish (or abandon, if the new picture isn't all in) a slide. */
+static void end_slide(bool finished)
+{
+    if (!finished)
+    {
+        // The LCD shows some of both pictures, so wipe it all next time
+        set_bands_inked(true);
+    }
+    // The steps sent the list's columns without noting them
+    forget_rows(0, PAINT_HEIGHT_MEMORY);
+    Paint_ResetDirty();
+    reset_scene(true);
+}
 
-/** If we are mouth, we use this LCD. */
-static const lcd_t mouth_lcd = {
-    .width = LCD_2IN_WIDTH,
-    .height = LCD_2IN_HEIGHT,
-    .clear = &LCD_2IN_Clear,
-    .init = &LCD_2IN_Init,
-    .display = display_for_2in_lcd,
-};
+gfx_fence_t gfx_list_show(void)
+{
+    stop_slide();
+    start_list_frames();
+    begin_flush();
+    for (size_t band = 0; band < NUM_BANDS; band++)
+    {
+        if (flush_superseded())
+        {
+            // The bands we didn't get to still show the last picture, and their notes say so
+            break;
+        }
+        show_band(band, replay_list, 0, Paint.WidthMemory, false);
+    }
+    finish_bands();
+    Paint_ResetDirty();
+    reset_scene(true);
+    list_on_lcd = true;
+    return gfx_fence();
+}
+
+gfx_fence_t gfx_scene_show(void)
+{
+    stop_slide();
+    list_on_lcd = false;
+    begin_flush();
+    for (size_t band = 0; band < NUM_BANDS; band++)
+    {
+        if (tile_dirty[band] && flush_superseded())
+        {
+            // The tiles we didn't get to stay dirty for next time
+            break;
+        }
+        if (tile_dirty[band])
+        {
+            show_band(band, replay_scene, 0, Paint.WidthMemory, false);
+            tile_dirty[band] = false;
+        }
+    }
+    finish_bands();
+    Paint_ResetDirty();
+    return gfx_fence();
+}
+#else
+/**
+ * Send the rows of the given region (memory coordinates) of the back buffer that the LCD isn't
+ * showing already, in runs. Everything that changed is inside the region, so a whole row's hash
+ * still says what the LCD shows after sending just the region's part of it.
+ */
+static void send_changed_rows(const PAINT_RECT *r)
+{
+    UWORD sent = r->Yend;
+#if GFX_ROW_HASH
+    PAINT_RECT run = *r;
+    bool in_run = false;
+    for (UWORD y = r->Ystart; y <= r->Yend; y++)
+    {
+        bool changed = false;
+        if (y < r->Yend)
+        {
+            const uint32_t hash = hash_row(back_buffer() + (size_t)y * Paint.WidthByte, Paint.WidthByte);
+            changed = hash != row_hashes[y];
+            row_hashes[y] = hash;
+        }
+        if (changed && !in_run)
+        {
+            run.Ystart = y;
+            in_run = true;
+        }
+        else if (!changed && in_run)
+        {
+            run.Yend = y;
+            in_run = false;
+            sent = send_region_to_lcd(&run, true);
+            if (sent < run.Yend)
+            {
+                // Cut short: the rows we hashed but didn't send aren't on the LCD after all
+                forget_rows(sent, run.Yend);
+                break;
+            }
+        }
+    }
+#else
+    sent = send_region_to_lcd(r, true);
+#endif // GFX_ROW_HASH
+
+    if (sent < r->Yend)
+    {
+        // The rest goes with the next frame
+        const PAINT_RECT rest = {r->Xstart, sent, r->Xend, r->Yend};
+        Paint_RectUnion(&pending_erase, &rest);
+    }
+}
 
-/** Cache the size of the LCD since it won't change at runtime after initialization. */
-static lcd_t lcd = eyebrows_lcd;
+#if GFX_DOUBLE_BUFFER
+/** Copy the buffer rows covered by the given region (memory coordinates) from src to dst. */
+static void copy_region_rows(const UBYTE *src, UBYTE *dst, const PAINT_RECT *r)
+{
+    const size_t offset = (size_t)r->Ystart * Paint.WidthByte;
+    const size_t nbytes = (size_t)(r->Yend - r->Ystart) * Paint.WidthByte;
+    memcpy(dst + offset, src + offset, nbytes);
+}
+#endif // GFX_DOUBLE_BUFFER
 
-/** Number of values in an LCD image */
-#ifdef MOUTH
-    #define IMAGE_SIZE (LCD_2IN_HEIGHT * LCD_2IN_WIDTH * 2)
-    /** The buffer we paint into and send to the LCD for display */
-    static UWORD *paint_buffer = NULL; // Too big for .bss; need to use heap
+/**
+ * Finish the frame in the back buffer: note what was drawn and, if send, send what changed to the LCD.
+ * Otherwise the LCD must already be showing it. Then, if double buffered, swap buffers.
+ */
+static void finish_frame(bool send)
+{
+    if (send)
+    {
+        // Whatever of the last frame is still going out is out of date now
+        stop_superseded_rows();
+    }
+
+    PAINT_RECT drawn;
+    Paint_GetDirty(&drawn);
+    Paint_RectUnion(&inked, &drawn);
+
+    PAINT_RECT region = pending_erase;
+    Paint_RectUnion(&region, &drawn);
+    Paint_ResetDirty();
+    pending_erase = (PAINT_RECT){0, 0, 0, 0};
+
+    if ((region.Xend <= region.Xstart) || (region.Yend <= region.Ystart))
+    {
+        // Nothing changed
+        return;
+    }
+    delta_shown = -1;
+
+    // This waits for the previous frame's transfer before starting, so once it returns,
+    // the old front buffer is no longer being read and is safe to paint into.
+    if (send)
+    {
+        begin_flush();
+        TRACE_BEGIN(TRACE_ID_LCD_FLUSH, region.Yend - region.Ystart);
+        const uint32_t flush_start = time_us_32();
+        send_changed_rows(&region);
+        note_flush(time_us_32() - flush_start);
+        TRACE_END(TRACE_ID_LCD_FLUSH, region.Yend - region.Ystart);
+    }
+
+#if GFX_DOUBLE_BUFFER
+    const UBYTE *front = back_buffer();
+    back_buffer_index ^= 1;
+    Paint_SelectImage(back_buffer());
+
+    // The new back buffer is a frame behind. Bring it up to date (reading the front
+    // while it streams out is fine) so incremental drawing and dirty tracking keep working.
+    copy_region_rows(front, back_buffer(), &region);
+#endif // GFX_DOUBLE_BUFFER
+}
+
+gfx_fence_t gfx_swap_buffers(void)
+{
+    if (back_buffer() == NULL)
+    {
+        return gfx_fence();
+    }
+    stop_slide();
+    finish_frame(true);
+    return gfx_fence();
+}
+
+gfx_fence_t gfx_flush_dirty(void)
+{
+    return gfx_swap_buffers();
+}
+
+gfx_fence_t gfx_send_paint_buffer_to_lcd(void)
+{
+    Paint_MarkAllDirty();
+    return gfx_swap_buffers();
+}
+
+gfx_fence_t gfx_list_show(void)
+{
+    if (back_buffer() == NULL)
+    {
+        return gfx_fence();
+    }
+
+    stop_slide();
+    gfx_clear_paint_buffer();
+    start_list_frames();
+    replay_list(back_buffer(), 0, Paint.HeightMemory);
+    return gfx_swap_buffers();
+}
+
+/** Send columns xstart up to xend of the display list, which begin_slide() painted into the back buffer. */
+static void send_list_columns(UWORD xstart, UWORD xend)
+{
+#if GFX_PAINT_SCALE == 65
+    // Only ever a few columns, so this is cheaper than the band of whole rows send_region_to_lcd() might send
+    LCD_Panel_DisplayWindows(xstart, 0, xend, Paint.HeightMemory, back_buffer());
 #else
-    #define IMAGE_SIZE (LCD_1IN14_HEIGHT * LCD_1IN14_WIDTH * 2)
-    /** The buffer we paint into and send to the LCD for display */
-    static UWORD paint_buffer[IMAGE_SIZE];
-#endif // MOUTH
+    const PAINT_RECT columns = {xstart, 0, xend, Paint.HeightMemory};
+    send_region_to_lcd(&columns, false);
+#endif // GFX_PAINT_SCALE
+}
 
-static void init_paint_buffer(void)
+/** Start a slide: paint the display list into the back buffer, where the steps send it from. */
+static void begin_slide(void)
 {
-#ifdef MOUTH
-    if (paint_buffer == NULL)
+    gfx_clear_paint_buffer();
+    start_list_frames();
+    replay_list(back_buffer(), 0, Paint.HeightMemory);
+}
+
+/** Finish (or abandon, if the new picture isn't all in) a slide. */
+static void end_slide(bool finished)
+{
+    if (!finished)
     {
-        // Allocate memory from the heap for paint buffer
-        paint_buffer = (UWORD *)malloc(IMAGE_SIZE);
+        // The LCD shows some of both pictures, so wipe it all next time
+        Paint_MarkAllDirty();
     }
+    forget_rows(0, PAINT_HEIGHT_MEMORY);
+    finish_frame(false);
+}
 
-    if (paint_buffer == NULL)
+gfx_fence_t gfx_scene_show(void)
+{
+    if (back_buffer() == NULL)
+    {
+        return gfx_fence();
+    }
+
+    stop_slide();
+    gfx_wait_for_paint_buffer();
+    for (size_t tile = 0; tile < NUM_TILES; tile++)
+    {
+        if (!tile_dirty[tile])
+        {
+            continue;
+        }
+        tile_dirty[tile] = false;
+
+        // Clip Paint to the tile's rows, so the elements that run on past it leave the rest alone
+        const UWORD ystart = (UWORD)(tile * GFX_BAND_ROWS);
+        const UWORD yend = ((ystart + GFX_BAND_ROWS) < Paint.HeightMemory) ? (ystart + GFX_BAND_ROWS) : Paint.HeightMemory;
+        UBYTE *rows = back_buffer() + (size_t)ystart * Paint.WidthByte;
+        const PAINT_RECT whole_rows = {0, ystart, Paint.WidthMemory, yend};
+        Paint_SelectBand(rows, ystart, yend);
+        Paint_ClearMemoryWindow(&whole_rows, WHITE);
+        replay_scene(rows, ystart, yend);
+    }
+    Paint_SelectImage(back_buffer());
+    return gfx_swap_buffers();
+}
+#endif // GFX_BANDED
+
+/** gfx_flush_rest(), but for the wake timing. */
+static gfx_fence_t send_rest(void)
+{
+    if (!flush_stopped)
+    {
+        return gfx_fence();
+    }
+#if GFX_BANDED
+    // Replaying it sends just what the LCD doesn't show yet
+    return list_on_lcd ? gfx_list_show() : gfx_scene_show();
+#else
+    // What didn't go out is waiting to go with the next frame, which this is
+    return gfx_swap_buffers();
+#endif // GFX_BANDED
+}
+
+gfx_fence_t gfx_flush_rest(void)
+{
+    const gfx_fence_t fence = send_rest();
+    if (waking)
+    {
+        // The first frame since the LCD woke. Waiting for it costs the next frame its head start, but only this once.
+        gfx_fence_wait(fence);
+        note_wake(time_us_32() - wake_start);
+        waking = false;
+    }
+    return fence;
+}
+
+void gfx_list_slide(int16_t step)
+{
+    stop_slide();
+    delta_shown = -1;
+#if !GFX_BANDED
+    if (back_buffer() == NULL)
     {
-        // If paint_buffer is still NULL, malloc failed.
-        log_error("Failed to allocate paint buffer. LCD will be unavailable.\n");
-        set_errno(ERR_ID_GRAPHICS_MODULE, ENOMEM);
         return;
     }
-#endif // MOUTH
+#endif // GFX_BANDED
 
-#ifdef MOUTH
-    uint16_t rotate = ROTATE_270;
-    Paint_NewImage((UBYTE *)paint_buffer, lcd.height, lcd.width, 90, WHITE);
+    // The controller scrolls across our pictures, which are landscape on portrait glass.
+    // If it doesn't (or can't scroll at all), there is nothing to slide with.
+    UWORD columns = (step < 0) ? (UWORD)-step : (UWORD)step;
+    if ((columns == 0) || !LCD_ACTIVE.SCROLLS_X || !LCD_Panel_SetScroll(0))
+    {
+        gfx_list_show();
+        return;
+    }
+#if GFX_LCD_12BIT
+    // RGB444 goes out in pairs of columns
+    columns = (columns + 1) & ~0x01;
+#endif // GFX_LCD_12BIT
+
+    begin_slide();
+    slide.active = true;
+    slide.step = (step < 0) ? -(int16_t)columns : (int16_t)columns;
+    slide.shown = 0;
+}
+
+bool gfx_list_slide_step(void)
+{
+    if (!slide.active)
+    {
+        return true;
+    }
+
+    // Scrolled by s, the LCD shows column (x + s) of its frame memory at x. So with the new picture
+    // written at its own columns, scrolling by however much of it is showing (or back by that much,
+    // coming in from the left) brings in exactly the columns that have been written. Once it's all
+    // in, that's a whole turn, and the LCD is unscrolled again.
+    const UWORD width = Paint.WidthMemory;
+    const UWORD from = slide.shown;
+    const UWORD columns = (slide.step < 0) ? (UWORD)-slide.step : (UWORD)slide.step;
+    const UWORD to = ((width - from) > columns) ? (from + columns) : width;
+    const bool from_right = slide.step > 0;
+
+    // Scroll first, so the columns about to be sent are the ones just come into view
+    // (and the last to be seen of the old picture), rather than the ones still showing it
+    LCD_Panel_SetScroll(from_right ? to : (width - to));
+    if (from_right)
+    {
+        send_list_columns(from, to);
+    }
+    else
+    {
+        send_list_columns(width - to, width - from);
+    }
+
+    slide.shown = to;
+    if (to == width)
+    {
+        slide.active = false;
+        end_slide(true);
+    }
+    return !slide.active;
+}
+
+/** Stop a slide where it is, if there is one, and unscroll the LCD. The next picture goes out whole. */
+static void stop_slide(void)
+{
+    if (!slide.active)
+    {
+        return;
+    }
+    slide.active = false;
+    LCD_Panel_SetScroll(0);
+    end_slide(false);
+}
+
+void gfx_set_theme(gfx_theme_t theme)
+{
+    if (theme >= GFX_THEME_COUNT)
+    {
+        log_error("No such theme: %u\n", (unsigned)theme);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+#if GFX_PAINT_SCALE == 65
+    log_error("Themes need a compact paint format\n");
+    set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
 #else
-    uint16_t rotate = ROTATE_0;
-    Paint_NewImage((UBYTE *)paint_buffer, lcd.width, lcd.height, 0, WHITE);
-#endif // MOUTH
-    Paint_SetScale(65);
-    Paint_Clear(WHITE);
-    Paint_SetRotate(rotate);
+    stop_slide();
+    // What's still going out was expanded with the old palette already, but don't change it under a row
+    gfx_wait_for_lcd();
+
+    const size_t ncolors = sizeof(palette) / sizeof(palette[0]);
+    const UWORD ink = themes[theme].ink;
+    paper = themes[theme].paper;
+    for (size_t i = 0; i < ncolors; i++)
+    {
+        // Thirds of the way from ink to paper, each channel rounded
+        const unsigned k = (unsigned)((i * 3) / (ncolors - 1));
+        const unsigned r = ((((ink >> 11) & 0x1F) * (3 - k)) + (((paper >> 11) & 0x1F) * k) + 1) / 3;
+        const unsigned g = ((((ink >> 5) & 0x3F) * (3 - k)) + (((paper >> 5) & 0x3F) * k) + 1) / 3;
+        const unsigned b = (((ink & 0x1F) * (3 - k)) + ((paper & 0x1F) * k) + 1) / 3;
+        const UWORD color = (UWORD)((r << 11) | (g << 5) | b);
+    #if GFX_LCD_12BIT
+        palette[i] = LCD_PANEL_RGB444(color);
+    #else
+        palette[i] = SPI_ORDER(color);
+    #endif // GFX_LCD_12BIT
+    }
+
+    // The buffer is the same, but every row of the LCD looks different now, blank ones too
+    forget_rows(0, PAINT_HEIGHT_MEMORY);
+    #if GFX_BANDED
+    set_bands_inked(true);
+    if (list_on_lcd)
+    {
+        start_list_frames();
+        for (size_t band = 0; band < NUM_BANDS; band++)
+        {
+            show_band(band, replay_list, 0, Paint.WidthMemory, false);
+        }
+        finish_bands();
+        Paint_ResetDirty();
+    }
+    else
+    {
+        mark_tiles_dirty(&(PAINT_RECT){0, 0, Paint.WidthMemory, Paint.HeightMemory});
+        gfx_scene_show();
+    }
+    #else
+    if (back_buffer() != NULL)
+    {
+        gfx_send_paint_buffer_to_lcd();
+    }
+    #endif // GFX_BANDED
+#endif // GFX_PAINT_SCALE
 }
 
-uint16_t gfx_lcd_width(void)
+/** Most blits that can be waiting for the graphics core. A power of two. */
+#define BLIT_QUEUE_SIZE 4
+
+/** Blits from the main core. It only posts, and the graphics core only runs them. */
+static intercore_channel_t blit_queue;
+
+/** Where blit_queue keeps them. */
+static gfx_blit_t blit_items[BLIT_QUEUE_SIZE];
+
+void gfx_blit_init(void)
 {
-    return lcd.width;
+    intercore_channel_init(&blit_queue, blit_items, sizeof(gfx_blit_t), BLIT_QUEUE_SIZE);
 }
 
-uint16_t gfx_lcd_height(void)
+bool gfx_blit_post(const gfx_blit_t *blit)
+{
+    return intercore_try_send(&blit_queue, blit);
+}
+
+uint32_t gfx_blit_count(void)
 {
-    return lcd.height;
+    return intercore_count(&blit_queue);
 }
 
-void gfx_send_paint_buffer_to_lcd(void)
+/** Show a blitted frame in place of the picture. */
+static void blit_frame(const gfx_frame_t *frame)
 {
-    if (paint_buffer == NULL)
+    if (!frame_suits(frame))
     {
+        log_error("Blitted frame (scale %u, %u x %u) does not suit the paint buffer.\n", frame->scale, frame->width_memory, frame->height_memory);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
         return;
     }
-#ifdef MOUTH
-    lcd.display.display_2in((uint8_t *)paint_buffer);
+
+#if GFX_BANDED
+    if (!frame_valid(frame))
+    {
+        log_error("Blitted frame is corrupt.\n");
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    gfx_list_begin();
+    list_add(frame, NULL, 0);
+    gfx_list_show();
+    // The frame goes back once we return, so a change of theme mustn't replay it
+    gfx_list_begin();
 #else
-    lcd.display.display_1in14(paint_buffer);
-#endif // MOUTH
+    // Says so itself if it's corrupt
+    gfx_show_frame(frame);
+#endif // GFX_BANDED
+}
+
+/** Send blitted pixels straight to their window of the LCD. */
+static void blit_pixels(const gfx_blit_t *blit)
+{
+    const PAINT_RECT *w = &blit->window;
+    if ((w->Xstart >= w->Xend) || (w->Ystart >= w->Yend) || (w->Xend > LCD_ACTIVE.WIDTH) || (w->Yend > LCD_ACTIVE.HEIGHT) ||
+        (blit->len != LCD_Panel_PixelBytes((uint32_t)(w->Xend - w->Xstart) * (w->Yend - w->Ystart))))
+    {
+        log_error("Blit of %lu bytes to (%u, %u) up to (%u, %u) does not fit the LCD.\n",
+                  (unsigned long)blit->len, w->Xstart, w->Ystart, w->Xend, w->Yend);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    stop_slide();
+
+    // The LCD no longer shows what we last sent there, so the next picture sends it again
+    forget_rows(w->Ystart, w->Yend);
+    mark_tiles_dirty(w);
+    delta_shown = -1;
+#if GFX_BANDED
+    for (size_t band = w->Ystart / GFX_BAND_ROWS; (band <= (size_t)(w->Yend - 1) / GFX_BAND_ROWS) && (band < NUM_BANDS); band++)
+    {
+        band_inked[band] = true;
+    }
+#else
+    Paint_RectUnion(&pending_erase, w);
+#endif // GFX_BANDED
+
+    // This waits for any previous transfer
+    LCD_Panel_BeginPixels(w->Xstart, w->Ystart, w->Xend, w->Yend);
+    LCD_Panel_WritePixels_DMA(blit->pixels, blit->len, true);
+
+    // The pixels go back once we return
+    gfx_fence_wait(gfx_fence());
+}
+
+/** One tile of a delta frame (see gfx_delta_t). */
+typedef struct {
+    UWORD xbyte;                ///< First byte of each row it covers
+    UWORD y;                    ///< First buffer row
+    UWORD wbytes;               ///< Bytes of each row it covers
+    UWORD height;               ///< Buffer rows
+    uint32_t size;              ///< Bytes of PackBits
+    const uint8_t *data;
+} delta_tile_t;
+
+static inline UWORD get_u16(const uint8_t *p)
+{
+    return (UWORD)(p[0] | (p[1] << 8));
+}
+
+/** Read the tile at *p, no further than end, and move *p past it. Returns false if it runs past end. */
+static bool next_delta_tile(const uint8_t **p, const uint8_t *end, delta_tile_t *tile)
+{
+    if ((uint32_t)(end - *p) < GFX_DELTA_TILE_HEADER_LEN)
+    {
+        return false;
+    }
+    const uint8_t *header = *p;
+    tile->xbyte = get_u16(&header[0]);
+    tile->y = get_u16(&header[2]);
+    tile->wbytes = get_u16(&header[4]);
+    tile->height = get_u16(&header[6]);
+    tile->size = get_u16(&header[8]);
+    tile->data = header + GFX_DELTA_TILE_HEADER_LEN;
+    if ((uint32_t)(end - tile->data) < tile->size)
+    {
+        return false;
+    }
+    *p = tile->data + tile->size;
+    return true;
+}
+
+#if !GFX_BANDED
+/** A row of a delta tile, decoded, to be XORed into the paint buffer. */
+static UBYTE delta_row[PAINT_ROW_BYTES];
+
+/** Does every tile of the delta frame fit the paint buffer and decode to exactly its bytes, with nothing left over? */
+static bool delta_valid(const gfx_delta_t *delta)
+{
+    const uint8_t *p = delta->tiles;
+    const uint8_t *end = delta->tiles + delta->size;
+    for (UWORD i = 0; i < delta->ntiles; i++)
+    {
+        delta_tile_t tile;
+        if (!next_delta_tile(&p, end, &tile) ||
+            ((uint32_t)tile.xbyte + tile.wbytes > Paint.WidthByte) || ((uint32_t)tile.y + tile.height > Paint.HeightMemory) ||
+            !packbits_valid(tile.data, tile.size, (uint32_t)tile.wbytes * tile.height))
+        {
+            return false;
+        }
+    }
+    return p == end;
+}
+
+/** Decode a tile into the paint buffer: XORed into what's there, or copied over it for a key frame. */
+static void apply_delta_tile(const delta_tile_t *tile, bool key)
+{
+    packbits_reader_t reader;
+    packbits_begin(&reader, tile->data, tile->size);
+    for (UWORD y = tile->y; y < tile->y + tile->height; y++)
+    {
+        UBYTE *row = back_buffer() + (size_t)y * Paint.WidthByte + tile->xbyte;
+        if (key)
+        {
+            packbits_read(&reader, row, tile->wbytes);
+            continue;
+        }
+        packbits_read(&reader, delta_row, tile->wbytes);
+        for (UWORD i = 0; i < tile->wbytes; i++)
+        {
+            row[i] ^= delta_row[i];
+        }
+    }
+
+    // The columns its bytes cover, for the dirty region
+    const UWORD xend = (UWORD)(((uint32_t)(tile->xbyte + tile->wbytes) * 8) / PAINT_PIXEL_BITS);
+    Paint_MarkDirty((UWORD)(((uint32_t)tile->xbyte * 8) / PAINT_PIXEL_BITS), tile->y,
+                    (xend < Paint.WidthMemory) ? xend : Paint.WidthMemory, tile->y + tile->height);
+}
+#endif // GFX_BANDED
+
+/** Decode a delta frame into the paint buffer, and send what it changed. */
+static void blit_delta(const gfx_delta_t *delta)
+{
+#if GFX_BANDED
+    // There is no picture in memory to apply it to
+    log_error("Delta frame %u needs a paint buffer, which a banded build doesn't have.\n", delta->seq);
+    set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+#else
+    if ((back_buffer() == NULL) ||
+        (delta->scale != Paint.Scale) || (delta->rotate != Paint.Rotate) ||
+        (delta->width_memory != Paint.WidthMemory) || (delta->height_memory != Paint.HeightMemory))
+    {
+        log_error("Delta frame %u (scale %u, %u x %u) does not suit the paint buffer.\n", delta->seq, delta->scale, delta->width_memory, delta->height_memory);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    if (!delta->key && ((int32_t)delta->base != delta_shown))
+    {
+        log_error("Delta frame %u is from frame %u, but the paint buffer holds %ld.\n", delta->seq, delta->base, (long)delta_shown);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+    if (!delta_valid(delta))
+    {
+        log_error("Delta frame %u is corrupt.\n", delta->seq);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+
+    if (delta->key)
+    {
+        gfx_clear_paint_buffer();
+    }
+    else
+    {
+        stop_slide();
+        gfx_wait_for_paint_buffer();
+    }
+
+    const uint8_t *p = delta->tiles;
+    for (UWORD i = 0; i < delta->ntiles; i++)
+    {
+        delta_tile_t tile;
+        if (!next_delta_tile(&p, delta->tiles + delta->size, &tile))
+        {
+            // The tiles before this one are in, so the paint buffer no longer holds any frame
+            log_error("Delta frame %u is truncated at tile %u.\n", delta->seq, i);
+            set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+            delta_shown = -1;
+            return;
+        }
+        apply_delta_tile(&tile, delta->key);
+    }
+
+    // Only the rows that came out different go (see send_changed_rows())
+    gfx_swap_buffers();
+    delta_shown = delta->seq;
+#endif // GFX_BANDED
+}
+
+void gfx_blit_run(void)
+{
+    gfx_blit_t blit;
+    if (!intercore_try_receive(&blit_queue, &blit))
+    {
+        return;
+    }
+
+#if GFX_ABORT_FLUSH
+    // The blit's data goes back once we return, so none of it can be left to send later
+    const gfx_superseded_t superseded = superseded_check;
+    superseded_check = NULL;
+#endif // GFX_ABORT_FLUSH
+    if (blit.frame != NULL)
+    {
+        blit_frame(blit.frame);
+    }
+    else if (blit.delta != NULL)
+    {
+        blit_delta(blit.delta);
+    }
+    else
+    {
+        blit_pixels(&blit);
+    }
+#if GFX_ABORT_FLUSH
+    superseded_check = superseded;
+#endif // GFX_ABORT_FLUSH
+
+    if (blit.done != NULL)
+    {
+        blit.done(blit.arg);
+    }
 }
 
-void gfx_lcd_reset(void)
+uint8_t gfx_lcd_pixel_bits(void)
 {
+    return LCD_ACTIVE.PIXEL_BITS;
+}
+
+void gfx_frame_format(gfx_frame_t *format)
+{
+    *format = (gfx_frame_t){
+        .scale = GFX_PAINT_SCALE,
+        .rotate = ROTATE_0,
+        .width_memory = PAINT_WIDTH_MEMORY,
+        .height_memory = PAINT_HEIGHT_MEMORY,
+    };
+}
+
+bool gfx_delta_parse(const uint8_t *data, uint32_t len, gfx_delta_t *delta)
+{
+    if ((len < GFX_DELTA_HEADER_LEN) || (data[0] != GFX_DELTA_VERSION))
+    {
+        return false;
+    }
+    *delta = (gfx_delta_t){
+        .key = (data[1] & GFX_DELTA_FLAG_KEY) != 0,
+        .seq = get_u16(&data[2]),
+        .base = get_u16(&data[4]),
+        .scale = data[6],
+        .rotate = get_u16(&data[8]),
+        .width_memory = get_u16(&data[10]),
+        .height_memory = get_u16(&data[12]),
+        .ntiles = get_u16(&data[14]),
+        .size = len - GFX_DELTA_HEADER_LEN,
+        .tiles = data + GFX_DELTA_HEADER_LEN,
+    };
+    return true;
+}
+
+int32_t gfx_delta_shown(void)
+{
+    return delta_shown;
+}
+
+gfx_fence_t gfx_lcd_reset(void)
+{
+    gfx_wait_for_lcd();
+    slide.active = false;
+    LCD_Panel_SetScroll(0);
     Paint_Clear(WHITE);
-    lcd.clear(WHITE);
+    LCD_Panel_Clear(paper);
 
     // Create new buffer for when we want to turn back on
     init_paint_buffer();
+#if GFX_BANDED
+    band_on_lcd = -1;
+    set_bands_inked(false);
+    list_on_lcd = false;
+#endif // GFX_BANDED
+    reset_scene(false);
+    delta_shown = -1;
+    return gfx_fence();
 }
 
-void gfx_init(lcd_size_t lcdsz)
+/** gfx_init() and gfx_resume(). */
+/** Most clearing the whole LCD can take and pass the self test, as a percentage of what its bytes take at LCD_SPI_BAUDRATE. */
+#define SELF_TEST_CLEAR_LIMIT_PERCENT 150U
+
+/**
+ * BIST_LCD_FLUSH: how long clearing the whole LCD to the paper takes, from opening the window to the last byte.
+ * Also keeps the most accesses to main RAM that had to wait on another bus master during a clear, in the
+ * uint32_t at context.
+ */
+static bool measure_clear(uint32_t *us, void *context)
+{
+    uint32_t *most_contested = context;
+    DEV_Bus_Count_Start();
+    const uint32_t start = time_us_32();
+    LCD_Panel_Clear(paper);
+    DEV_SPI_DMA_Wait();
+    *us = time_us_32() - start;
+    const uint32_t contested = DEV_Bus_Count_Contested();
+    if (contested > *most_contested)
+    {
+        *most_contested = contested;
+    }
+    return true;
+}
+
+static void gfx_start(lcd_size_t lcdsz, bool resume)
 {
     uint8_t err = DEV_Module_Init();
     if (err != 0)
@@ -136,12 +2533,12 @@ void gfx_init(lcd_size_t lcdsz)
     {
         case LCD_SIZE_EYEBROWS:
             {
-                lcd = eyebrows_lcd;
+                panel = &LCD_1IN14_PANEL;
             }
             break;
         case LCD_SIZE_MOUTH:
             {
-                lcd = mouth_lcd;
+                panel = &LCD_2IN_PANEL;
             }
             break;
         default:
@@ -150,7 +2547,55 @@ void gfx_init(lcd_size_t lcdsz)
             break;
     }
 
-    lcd.init(HORIZONTAL);
-    lcd.clear(WHITE);
+    waking = false;
+    if (resume)
+    {
+        // Tearing effect and all: the panel kept its configuration (and wakes, if it was left asleep)
+        LCD_Panel_Resume(panel, LCD_SCAN_DIR);
+        LCD_Panel_SetRotate180(upside_down);
+#if GFX_LCD_12BIT
+        LCD_Panel_SetPixelFormat(12);
+#endif // GFX_LCD_12BIT
+    }
+    else
+    {
+        LCD_Panel_Init(panel, LCD_SCAN_DIR);
+        LCD_Panel_SetRotate180(upside_down);
+#if GFX_LCD_12BIT
+        LCD_Panel_SetPixelFormat(12);
+#endif // GFX_LCD_12BIT
+#if LCD_TE_PIN >= 0
+        LCD_Panel_SetTearingEffect(true);
+#endif // LCD_TE_PIN
+        // Cleared a few times over for the self test, which looks just like clearing it once.
+        // A resumed panel keeps its picture, so it isn't tested.
+        const uint32_t bytes = LCD_Panel_PixelBytes((uint32_t)LCD_ACTIVE.WIDTH * LCD_ACTIVE.HEIGHT);
+        const uint32_t expected_us = (uint32_t)(((uint64_t)bytes * 8U * 1000000U) / LCD_SPI_BAUDRATE);
+        uint32_t most_contested = 0;
+        if (bist_run(BIST_LCD_FLUSH, &measure_clear, &most_contested, (expected_us * SELF_TEST_CLEAR_LIMIT_PERCENT) / 100U) != BIST_PASS)
+        {
+            set_errno(ERR_ID_GRAPHICS_MODULE, ETIME);
+        }
+        // What the clear's DMA shared main RAM with (see the graphics README's Memory)
+        log_info("LCD: Clear had %lu contested accesses to main RAM\n", (unsigned long)most_contested);
+    }
     init_paint_buffer();
+#if GFX_BANDED
+    // We don't know what a resumed panel is showing, so the first picture goes out whole
+    set_bands_inked(resume);
+#endif // GFX_BANDED
+    reset_scene(resume);
+    // Initializing or resuming the panel unscrolls it
+    slide.active = false;
+    gfx_frame_clock_start();
+}
+
+void gfx_init(lcd_size_t lcdsz)
+{
+    gfx_start(lcdsz, false);
+}
+
+void gfx_resume(lcd_size_t lcdsz)
+{
+    gfx_start(lcdsz, true);
 }
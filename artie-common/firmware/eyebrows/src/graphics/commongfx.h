@@ -9,6 +9,10 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <GUI_Paint.h>
+
 /** The possible sizes of LCD. */
 typedef enum {
     LCD_SIZE_EYEBROWS,
@@ -24,6 +28,12 @@ typedef enum {
 /** Macro for erasing a circle centered at (x_center, y_center) with given radius. */
 #define ERASE_CIRCLE(x_center, y_center, radius) Paint_DrawCircle((x_center), (y_center), (radius), WHITE, LINE_WIDTH, DRAW_FILL_EMPTY)
 
+/** Macro for drawing the part of a circle from start_deg to end_deg, clockwise from the right of its center. */
+#define DRAW_ARC(x_center, y_center, radius, start_deg, end_deg) Paint_DrawArc((x_center), (y_center), (radius), (start_deg), (end_deg), BLACK, LINE_WIDTH)
+
+/** Macro for drawing a curve from x0, y0 to x1, y1 that bends towards xc, yc (a quadratic Bezier). */
+#define DRAW_CURVE(x0, y0, xc, yc, x1, y1) Paint_DrawCurve((x0), (y0), (xc), (yc), (x1), (y1), BLACK, LINE_WIDTH)
+
 /** Macro for drawing a filled rectangle at (top_left_x, top_left_y) to (bottom_right_x, bottom_right_y). */
 #define ERASE_RECTANGLE(x0, y0, x1, y1) Paint_DrawRectangle((x0), (y0), (x1), (y1), WHITE, LINE_WIDTH, DRAW_FILL_FULL)
 
@@ -36,20 +46,459 @@ typedef enum {
 /** Macro for drawing text at a given point. */
 #define DRAW_TEXT(x, y, str) Paint_DrawString_EN((x), (y), (str), &Font20, BLACK, WHITE)
 
+/**
+ * A whole paint buffer rendered ahead of time (see tools/facegen), kept in flash.
+ *
+ * Only the band of buffer rows holding something other than background is stored,
+ * PackBits-encoded: a header byte n < 128 is followed by n + 1 literal bytes;
+ * n > 128 is followed by one byte to repeat 257 - n times.
+ */
+typedef struct {
+    uint8_t scale;              ///< Paint_SetScale() value the frame was rendered at
+    uint16_t rotate;            ///< Paint_SetRotate() value the frame was rendered at (ROTATE_0: the LCD turns it)
+    uint16_t width_memory;      ///< Width of the paint buffer in memory
+    uint16_t height_memory;     ///< Height of the paint buffer in memory
+    PAINT_RECT bounds;          ///< Box (memory coordinates) around everything that isn't background
+    uint32_t size;              ///< Number of bytes in data
+    const uint8_t *data;        ///< Encoded buffer rows bounds.Ystart up to bounds.Yend
+} gfx_frame_t;
+
+#ifndef GFX_FRAME_RATE_HZ
+    /** Frames per second the render loop runs at while something is animating. */
+    #define GFX_FRAME_RATE_HZ 30
+#endif // GFX_FRAME_RATE_HZ
+
+#ifndef GFX_BANDED
+    /**
+     * Set to 1 to keep no paint buffer: each picture is a display list (see gfx_list_show()),
+     * replayed into a strip of GFX_BAND_ROWS buffer rows at a time, with each strip streaming
+     * out to the LCD while the next one is painted. The paint buffer functions are left out.
+     * The mouth's buffer is the big one, so it is banded by default.
+     */
+    #ifdef MOUTH
+        #define GFX_BANDED 1
+    #else
+        #define GFX_BANDED 0
+    #endif // MOUTH
+#endif // GFX_BANDED
+
+#if GFX_BANDED && !defined(MOUTH)
+    #error "GFX_BANDED is only supported for the mouth"
+#endif
+
+#ifndef GFX_BAND_ROWS
+    /** Buffer rows (which are LCD rows) in each band, when built with GFX_BANDED. */
+    #define GFX_BAND_ROWS 16
+#endif // GFX_BAND_ROWS
+
+#ifndef GFX_DUAL_CORE
+    /**
+     * Set to 1 to have the main core help banded pictures out: the graphics core paints each band and
+     * hands it over, and the main core expands it to the LCD's format and sends it (see gfx_band_assist())
+     * while the next band is painted. A band the main core hasn't taken by the time its buffer is wanted
+     * again is sent by the graphics core itself. Only the compact formats are expanded, so RGB565 bands
+     * (which go out by DMA as they are, already alongside painting) are unaffected. On for the mouth.
+     */
+    #ifdef MOUTH
+        #define GFX_DUAL_CORE 1
+    #else
+        #define GFX_DUAL_CORE 0
+    #endif // MOUTH
+#endif // GFX_DUAL_CORE
+
+#ifndef GFX_PERF_OVERLAY
+    /**
+     * Show the frame rate and the last frame's paint and flush times in the top left corner of
+     * the LCD, for debug builds. See gfx_overlay_frame().
+     */
+    #define GFX_PERF_OVERLAY 0
+#endif // GFX_PERF_OVERLAY
+
+#ifndef GFX_ABORT_FLUSH
+    /**
+     * Set to 1 to let a newer frame cut short the one going out to the LCD, at a row boundary (a band,
+     * when banded), rather than waiting for the rest of it. The rows that didn't go out go with the next
+     * frame, from the newer picture. See gfx_set_superseded_check().
+     */
+    #define GFX_ABORT_FLUSH 1
+#endif // GFX_ABORT_FLUSH
+
+#ifndef GFX_LIST_MAX_OPS
+    /** Most steps a display list can hold. */
+    #define GFX_LIST_MAX_OPS 8
+#endif // GFX_LIST_MAX_OPS
+
+#ifndef GFX_SCENE_MAX_ELEMENTS
+    /** Most elements the scene can hold. Their IDs run from 0 to GFX_SCENE_MAX_ELEMENTS - 1. */
+    #define GFX_SCENE_MAX_ELEMENTS 4
+#endif // GFX_SCENE_MAX_ELEMENTS
+
+/** One step of a display list: paints its part of the picture. With GFX_BANDED, called once per band. */
+typedef void (*gfx_painter_t)(uintptr_t arg);
+
+/** A box in Paint's coordinates, with exclusive end points. It may run off the picture. */
+typedef struct {
+    int16_t xstart;
+    int16_t ystart;
+    int16_t xend;
+    int16_t yend;
+} gfx_box_t;
+
+/**
+ * A point in the stream of transfers to the LCD, returned by the functions that send. It has passed
+ * once everything sent up to it has been clocked out. The sending functions return as soon as their
+ * last transfer has started, so hold on to the fence, paint the next picture (into the other buffer,
+ * if double buffered), and only wait for it (or poll it) when it matters that the last one is on the glass.
+ */
+typedef uint32_t gfx_fence_t;
+
+/** Is there something newer to show than the frame going out? Called between its rows, so keep it quick. */
+typedef bool (*gfx_superseded_t)(void);
+
 /** Initialize the common GFX subsystem. */
 void gfx_init(lcd_size_t lcdsz);
 
-/** Reset the graphics stack. */
-void gfx_lcd_reset(void);
+/**
+ * Like gfx_init(), for an LCD that is still set up and showing what it was (after a warm restart):
+ * the panel isn't reset, sent its init sequence, or cleared.
+ */
+void gfx_resume(lcd_size_t lcdsz);
 
-/** Get the width of the LCD. */
+/** Reset the graphics stack. Clears the LCD and empties the scene. Returns once the clear has started. */
+gfx_fence_t gfx_lcd_reset(void);
+
+/** Get the width of the LCD, as the picture is drawn (landscape). */
 uint16_t gfx_lcd_width(void);
 
-/** Get the height of the LCD. */
+/** Get the height of the LCD, as the picture is drawn (landscape). */
 uint16_t gfx_lcd_height(void);
 
-/** Display the current paint buffer on the LCD. */
-void gfx_send_paint_buffer_to_lcd(void);
+/**
+ * Have the LCD controller turn everything sent from now on upside down, for a panel mounted
+ * that way, or back. Painting is the same either way. Kept across gfx_resume() and gfx_lcd_reset().
+ */
+void gfx_set_upside_down(bool turned);
+
+/** Colour schemes for the picture. See gfx_set_theme(). */
+typedef enum {
+    GFX_THEME_DAY,          ///< Black on white
+    GFX_THEME_NIGHT,        ///< Dim red on black, for a dark room
+    GFX_THEME_WARM,         ///< Brown on cream
+    GFX_THEME_COOL,         ///< Navy on pale blue
+    GFX_THEME_COUNT
+} gfx_theme_t;
+
+/**
+ * Recolor the picture. Paint still draws in BLACK and WHITE (and the grays between), which become
+ * the theme's ink and paper (and the shades between) as the buffer is expanded on its way to the
+ * LCD. So what the LCD shows is just sent again, without painting it again; with GFX_BANDED, where
+ * there is nothing to send it from, the last display list (or the scene) is replayed. Only the
+ * compact paint formats have a palette: at RGB565 the picture stays black on white.
+ * Kept across gfx_lcd_reset(), but not a restart.
+ */
+void gfx_set_theme(gfx_theme_t theme);
+
+/** Start a new display list, for the next picture. */
+void gfx_list_begin(void);
+
+/**
+ * Add a step to the display list. With GFX_BANDED the painter runs once for every band, with
+ * Paint clipped to it, so it must paint the same thing every time and touch nothing but Paint.
+ */
+void gfx_list_add_painter(gfx_painter_t painter, uintptr_t arg);
+
+/**
+ * Add a pre-rendered frame to the display list. It is copied in over every buffer row it covers,
+ * so add it first. If it was rendered for a different buffer format or orientation than ours
+ * (or is corrupt), the fallback painter is added instead.
+ */
+void gfx_list_add_frame(const gfx_frame_t *frame, gfx_painter_t fallback, uintptr_t arg);
+
+/**
+ * Replace what's on the LCD with the display list, painted over white. Only what changed is sent.
+ * Returns once the last of it has started streaming out. Empties the scene, and the next
+ * gfx_scene_show() repaints everything.
+ */
+gfx_fence_t gfx_list_show(void);
+
+/**
+ * Slide the display list in over what the LCD is showing, across the picture: in from the right if
+ * step is positive (everything moving left), or from the left if it is negative, |step| columns at a
+ * time. The LCD controller scrolls the picture (see LCD_Panel_SetScroll()), so each step only sends
+ * the columns that came into view. Call gfx_list_slide_step() once a frame to move it on. Showing or
+ * drawing anything else stops it where it is. If the panel can't scroll across, the list is just shown.
+ * Empties the scene, like gfx_list_show().
+ */
+void gfx_list_slide(int16_t step);
+
+/** Move a slide on by a step. Returns true once it has finished (or if there is none). */
+bool gfx_list_slide_step(void);
+
+/**
+ * Put an element in the scene, in place of whatever had its ID. The scene is a retained picture:
+ * gfx_scene_show() only repaints the tiles (bands of GFX_BAND_ROWS buffer rows) that an element
+ * has left or entered since the last show, and in each of them only replays the elements whose
+ * boxes overlap it. Elements are painted in ID order, over white.
+ *
+ * @param id Which element, below GFX_SCENE_MAX_ELEMENTS.
+ * @param painter Paints the element, as for gfx_list_add_painter(). The same arg must paint the same thing.
+ * @param arg Passed to the painter.
+ * @param box Everything the painter touches (erasing included) is inside this. NULL for the whole picture.
+ */
+void gfx_scene_set(uint8_t id, gfx_painter_t painter, uintptr_t arg, const gfx_box_t *box);
+
+/** Take an element out of the scene. The tiles it covered are repainted without it. */
+void gfx_scene_remove(uint8_t id);
+
+/** Bring the LCD up to date with the scene, repainting only what changed. Returns once the last of it has started streaming out. */
+gfx_fence_t gfx_scene_show(void);
+
+#if !GFX_BANDED
+/**
+ * Display the whole current paint buffer on the LCD.
+ *
+ * The buffer is streamed out via DMA and this returns as soon as the transfer has started.
+ * Same as marking everything dirty and calling gfx_swap_buffers().
+ */
+gfx_fence_t gfx_send_paint_buffer_to_lcd(void);
+
+/**
+ * Finish the current frame: send the parts of the paint buffer that changed since the last
+ * frame to the LCD and, if built with GFX_DOUBLE_BUFFER, make it the front buffer and start
+ * painting into the other one (which is brought up to date first).
+ *
+ * Returns as soon as the transfer has started. With double buffering you can paint the next
+ * frame straight away; without it, painting waits for the transfer (see gfx_wait_for_paint_buffer()).
+ */
+gfx_fence_t gfx_swap_buffers(void);
+
+/** Send only what changed since the last frame. Same as gfx_swap_buffers(). */
+gfx_fence_t gfx_flush_dirty(void);
+#endif // GFX_BANDED
+
+/**
+ * Restart the render loop's frame clock so the next gfx_wait_for_frame() returns right away.
+ * Call when coming out of idle, so the first frame isn't held back.
+ */
+void gfx_frame_clock_start(void);
+
+/**
+ * Block until the next frame of the render loop is due: every 1/GFX_FRAME_RATE_HZ seconds,
+ * then (if built with an LCD_TE_PIN) at the start of the panel's next V-blank.
+ * Frames missed by running late are dropped rather than run back to back.
+ */
+void gfx_wait_for_frame(void);
+
+/** Block until the last frame has finished streaming out. */
+void gfx_wait_for_lcd(void);
+
+/** A fence for everything sent to the LCD so far. */
+gfx_fence_t gfx_fence(void);
+
+/** Has everything sent up to the fence been clocked out? Doesn't block. */
+bool gfx_fence_passed(gfx_fence_t fence);
+
+/** Block until everything sent up to the fence has been clocked out. Later transfers may still be going. */
+void gfx_fence_wait(gfx_fence_t fence);
+
+/**
+ * With GFX_ABORT_FLUSH, stop sending a frame (between rows, or bands when banded) once superseded says
+ * there is a newer one, so it shows a row's time later rather than a whole frame's. An RGB565 frame,
+ * which streams out by DMA on its own, is cut short by the next frame sending (or, single buffered,
+ * painting) instead, with or without a check. Two frames in a row are never cut short, so a steady
+ * stream of commands still gets whole pictures out. NULL (the default) lets every frame finish.
+ */
+void gfx_set_superseded_check(gfx_superseded_t superseded);
+
+/** A channel from the intercore library. Declared here so the host tools that paint needn't have it. */
+struct intercore_channel;
+
+/** How the LCD's idle sleeps have gone. See gfx_idle_receive(). */
+typedef struct {
+    uint32_t sleeps;            ///< Times it has gone to sleep since boot
+    uint32_t last_wake_us;      ///< From the work that woke it last to that work's frame being out, in us
+    uint32_t worst_wake_us;     ///< The longest that has taken
+} gfx_idle_stats_t;
+
+/**
+ * Set how long gfx_idle_receive() waits before the LCD sleeps, in ms, or 0 (the default) to never
+ * sleep. Up to about 71 minutes: longer is taken as that. Call before gfx_init() or gfx_resume().
+ */
+void gfx_set_idle_sleep(uint32_t ms);
+
+/**
+ * @brief The render loop's wait for work, when it has nothing to draw: take the next item from the
+ * channel, sleeping until there is one. If none comes within the idle sleep time (see gfx_set_idle_sleep()),
+ * the LCD goes to sleep (backlight off, then the panel, which keeps its picture) and its bus's clock
+ * stops with the cores'. The item that ends it wakes the LCD, showing what it showed, before this returns,
+ * and the time from then until the next gfx_flush_rest()'s frame is out is kept in gfx_idle_stats().
+ * Call from the graphics core, in place of intercore_receive_blocking(). The wait counts as idle for
+ * the metrics library; waking the LCD doesn't.
+ *
+ * @param channel The channel work comes in on.
+ * @param item Where to put it.
+ */
+void gfx_idle_receive(struct intercore_channel *channel, void *item);
+
+/** Copy how the LCD's idle sleeps have gone. Safe from either core. */
+void gfx_idle_stats(gfx_idle_stats_t *stats);
+
+/** Have the idle sleep figures changed since the last call? Call from the main loop. */
+bool gfx_idle_update(void);
+
+/**
+ * @brief From the main core, with GFX_DUAL_CORE and GFX_BANDED: send the next band the graphics core
+ * has painted, if there is one waiting, and the graphics core isn't sending one itself. The graphics core
+ * wakes the main core (with __sev()) whenever it hands one over, so call this from the main loop, and
+ * don't sleep when it returns true: there may be another. Sends one band at a time, so commands that
+ * come in meanwhile wait a band's time at most. Otherwise does nothing.
+ *
+ * @return true if it sent a band.
+ */
+bool gfx_band_assist(void);
+
+/** Was the last frame cut short for a newer one? If so, show the newer one straight away. */
+bool gfx_flush_stopped(void);
+
+/**
+ * If the last frame was cut short, send what it didn't get to (or, for a display list or scene,
+ * whatever of it the LCD doesn't show yet). Call it if the newer frame sent nothing after all,
+ * so the LCD isn't left showing part of each. The render loop calls it after every frame: the
+ * first one after the LCD wakes (see gfx_idle_receive()) waits here until it's out.
+ */
+gfx_fence_t gfx_flush_rest(void);
+
+#if !GFX_BANDED
+/**
+ * Block until the paint buffer is safe to draw into: until the last frame sent from it has been
+ * clocked out (anything sent since, like the performance overlay, may still be going).
+ * A no-op when double buffered.
+ */
+void gfx_wait_for_paint_buffer(void);
+
+/**
+ * Wait until the paint buffer can be drawn into, then clear it to white. Does not touch the LCD.
+ * Only the area drawn into since the last clear is wiped; the next frame sends it. Empties the scene.
+ */
+void gfx_clear_paint_buffer(void);
+
+/**
+ * Show a pre-rendered frame: decode it straight over a cleared paint buffer and send it.
+ *
+ * Returns false (having drawn nothing) if the frame was rendered for a different buffer
+ * format or orientation than the one we have, or if it is corrupt; paint the shape instead.
+ */
+bool gfx_show_frame(const gfx_frame_t *frame);
+#endif // GFX_BANDED
+
+/**
+ * Stream a run-length encoded 1 bpp image straight to the LCD at (x, y), in the picture's
+ * coordinates (the same as Paint's), expanding it a row at a time into DMA line buffers.
+ *
+ * Doesn't touch the paint buffer, so the image stays up until something sends over it.
+ * Returns as soon as the last row has started.
+ */
+void gfx_send_rle_image(const PAINT_RLE_IMAGE *image, UWORD x, UWORD y, UWORD fg, UWORD bg);
+
+/** Version of the delta frame format, the first byte of its header. */
+#define GFX_DELTA_VERSION 1
+
+/** Bytes in a delta frame's header, and in each of its tiles' headers. */
+#define GFX_DELTA_HEADER_LEN 16
+#define GFX_DELTA_TILE_HEADER_LEN 10
+
+/** A key frame: its tiles are drawn over background, rather than XORed into the last frame. */
+#define GFX_DELTA_FLAG_KEY 0x01
+
+/**
+ * A frame rendered somewhere else (see can/canframes.h), sent as the difference from the one before.
+ * Its header, as gfx_delta_parse() takes it (little-endian): version u8, flags u8, seq u16, base u16,
+ * scale u8, a zero byte, rotate u16, width_memory u16, height_memory u16, ntiles u16. Then the tiles,
+ * each of them a box of the paint buffer in whole bytes of buffer rows: xbyte u16, y u16, wbytes u16,
+ * height u16, size u16, then size bytes of PackBits (see gfx_frame_t) that decode to the box's bytes,
+ * a row at a time. They are XORed into the paint buffer, which must be holding frame base; a key
+ * frame's are copied over background instead, whatever the paint buffer was holding.
+ */
+typedef struct gfx_delta {
+    uint16_t seq;               ///< This frame's number
+    uint16_t base;              ///< Number of the frame it is the difference from, unless key
+    bool key;                   ///< A key frame, needing no base
+    uint8_t scale;              ///< Paint_SetScale() value the frame was rendered at
+    uint16_t rotate;            ///< Paint_SetRotate() value the frame was rendered at
+    uint16_t width_memory;      ///< Width of the paint buffer in memory
+    uint16_t height_memory;     ///< Height of the paint buffer in memory
+    uint16_t ntiles;            ///< Number of tiles
+    uint32_t size;              ///< Number of bytes of tiles
+    const uint8_t *tiles;       ///< The tiles, each with its header
+} gfx_delta_t;
+
+/**
+ * Read a delta frame's header from the len bytes at data, which go on to hold its tiles.
+ * Returns false if it's too short, or a version we don't know. The tiles are checked when it's applied.
+ */
+bool gfx_delta_parse(const uint8_t *data, uint32_t len, gfx_delta_t *delta);
+
+/**
+ * Number of the delta frame the paint buffer holds, for the next one's base, or -1 if it holds
+ * anything else (something else drew since, or there's no paint buffer, with GFX_BANDED).
+ */
+int32_t gfx_delta_shown(void);
+
+/** Called on the graphics core once a blit is done with its data. */
+typedef void (*gfx_blit_done_t)(uintptr_t arg);
+
+/**
+ * A picture from outside the faces (see usb/usbframes.h and can/canframes.h), for the graphics core to
+ * put on the LCD: a frame to show like a pre-rendered one, a delta frame to apply to the last one,
+ * or pixels to send straight to a window of the LCD.
+ */
+typedef struct gfx_blit {
+    const gfx_frame_t *frame;   ///< Frame to show, or NULL
+    const gfx_delta_t *delta;   ///< Delta frame to apply, or NULL (with no frame either) to send pixels
+    PAINT_RECT window;          ///< Where the pixels go, in the picture's coordinates
+    const uint8_t *pixels;      ///< The window's pixels, a row at a time, in the LCD's format (see gfx_lcd_pixel_bits())
+    uint32_t len;               ///< Number of bytes in pixels
+    gfx_blit_done_t done;       ///< Called once the frame or pixels can be reused, or NULL
+    uintptr_t arg;              ///< Passed to done
+} gfx_blit_t;
+
+/** Set up the queue of blits. Call (from the main core) before launching the graphics core. */
+void gfx_blit_init(void);
+
+/**
+ * From the main core: queue a blit for gfx_blit_run(). Its frame or pixels must be left alone
+ * until its done callback. Returns false if the queue is full.
+ */
+bool gfx_blit_post(const gfx_blit_t *blit);
+
+/** How many blits are waiting for gfx_blit_run(). */
+uint32_t gfx_blit_count(void);
+
+/**
+ * From the graphics core: run the oldest blit waiting, if there is one. A frame replaces the picture
+ * (a frame that doesn't suit our buffer, or is corrupt, is an error); a delta frame is decoded into the
+ * paint buffer, and what it changed is sent (one that doesn't suit or is corrupt, or isn't against the
+ * frame the paint buffer holds, is an error, and changes nothing); pixels are sent as they are and
+ * stay up until something sends over them. A display list that showed the frame is emptied afterwards,
+ * since the frame goes back to its owner. Neither is cut short for a newer frame.
+ */
+void gfx_blit_run(void);
+
+/** Bits a pixel the LCD is sent in: 16 (RGB565, high byte first) or 12 (RGB444, two pixels in three bytes). */
+uint8_t gfx_lcd_pixel_bits(void);
+
+/** Fill in the scale, rotation, and buffer size a frame must have been rendered at to suit us. */
+void gfx_frame_format(gfx_frame_t *format);
+
+/**
+ * Note a frame the render loop just drew, which took frame_us in all (sending included), and
+ * update the performance overlay: frames drawn in the last second, the time spent painting
+ * that frame, and the time spent sending it, in us. The overlay is drawn with Paint's glyph
+ * cache into a buffer of its own and streamed to its corner of the LCD, so it sends nothing
+ * else and doesn't touch the picture or its dirty region. Anything sent over it is covered
+ * again after the next frame. Does nothing unless built with GFX_PERF_OVERLAY.
+ */
+void gfx_overlay_frame(uint32_t frame_us);
 
 #ifdef __cplusplus
 }
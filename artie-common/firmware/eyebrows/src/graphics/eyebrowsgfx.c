@@ -1,32 +1,26 @@
+#ifndef MOUTH
 // Std lib includes
 #include <stdio.h>
+#include <string.h>
 // SDK includes
+#include "hardware/sync.h"
 #include "pico/multicore.h"
-#include "pico/util/queue.h"
+#include "pico/time.h"
 // Library includes
-#include "lcd/LCD/LCD_1in14.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include <LCD_1in14.h>
+#include <GUI_Paint.h>
 #include <errors.h>
+#include <intercore.h>
+#include <metrics.h>
+#include <trace.h>
 // Local includes
 #include "commongfx.h"
+#include "faceframes.h"
+#include "faceshapes.h"
 #include "../board/pinconfig.h"
 #include "../board/types.h"
 #include "../cmds/cmds.h"
 
-/** The location of a given pair of vertices */
-typedef enum {
-    VERTEX_POS_LOW = 0,
-    VERTEX_POS_MIDDLE = 1,
-    VERTEX_POS_HIGH = 2
-} vertex_pos_t;
-
-/** The eyebrow that we draw. */
-typedef struct {
-    vertex_pos_t left;
-    vertex_pos_t middle;
-    vertex_pos_t right;
-} eyebrow_t;
-
 /** The current state of the eyebrow. */
 static eyebrow_t eyebrow_state = {
     .left = VERTEX_POS_MIDDLE,
@@ -34,50 +28,88 @@ static eyebrow_t eyebrow_state = {
     .right = VERTEX_POS_MIDDLE
 };
 
-/** The pixel X location of left vertices. */
-static const UWORD X_POS_LEFT_VERTEX = 25;
+#ifndef EYEBROW_ANIMATION_FRAMES
+    /** Number of frames a change of eyebrow is tweened over. 1 snaps straight to the new eyebrow. */
+    #define EYEBROW_ANIMATION_FRAMES 8
+#endif // EYEBROW_ANIMATION_FRAMES
 
-/** The pixel X location of middle vertices. */
-static const UWORD X_POS_MIDDLE_VERTEX = 115;
+/** Number of vertex pairs in an eyebrow (left, middle, right). */
+#define NUM_VERTEX_PAIRS 3
 
-/** The pixel X location of right vertices. */
-static const UWORD X_POS_RIGHT_VERTEX = 200;
+/** A change of eyebrow, tweened over several frames. Offsets are as for faceshapes_paint_eyebrow_at(). */
+typedef struct {
+    bool running;                       ///< Are there frames left to draw?
+    bool on_lcd;                        ///< Is an eyebrow (at shown) on the LCD? If not, there is nothing to tween from.
+    uint8_t frame;                      ///< Frames drawn so far
+    UWORD from[NUM_VERTEX_PAIRS];       ///< Where each vertex pair started
+    UWORD to[NUM_VERTEX_PAIRS];         ///< Where each vertex pair ends up
+    UWORD shown[NUM_VERTEX_PAIRS];      ///< Where each vertex pair is on the LCD right now
+} eyebrow_animation_t;
+
+/** The animation in progress, if any. Only touched by the graphics core. */
+static eyebrow_animation_t animation = {
+    .running = false,
+    .on_lcd = false,
+};
 
-/** The Y offsets to apply when in VERTEX_POS_LOW, VERTEX_POS_MIDDLE, or VERTEX_POS_HIGH */
-static const UWORD LOOKUP_Y_OFFSETS[] = {50, 25, 0};
+/**
+ * Where each vertex pair of the eyebrow to draw is, as for faceshapes_paint_eyebrow_at(): eyebrow_state's,
+ * or the ones a CMD_LCD_DRAW_VERTICES asked for.
+ */
+static UWORD eyebrow_offsets[NUM_VERTEX_PAIRS];
 
-/** The starting Y value for any vertex. Apply an offset from LOOKUP_Y_OFFSETS. */
-static const UWORD Y_POS_BASE = 25;
+/** Is the eyebrow to draw eyebrow_state, rather than one from CMD_LCD_DRAW_VERTICES? Only the fixed ones are pre-rendered. */
+static bool eyebrow_is_fixed = true;
 
-/** The thickness of the eyebrow. */
-static const UWORD EYEBROW_Y_THICKNESS = 50;
+/** Has the eyebrow to draw changed since the last frame? Several commands in one frame only draw the last. */
+static bool eyebrow_state_pending = false;
 
-/** Macro for looking up bottom left y position at runtime. */
-#define BOTTOM_LEFT_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.left] + EYEBROW_Y_THICKNESS
+/** A buffer for putting strings into. */
+static char strbuf[32];
 
-/** Macro for looking up bottom middle y position at runtime. */
-#define BOTTOM_MIDDLE_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.middle] + EYEBROW_Y_THICKNESS
+/** Smallish value for commands to be fed into the LCD command queue by the main core. A power of two. */
+#define INTER_CORE_QUEUE_SIZE 32
 
-/** Macro for looking up bottom right y position at runtime. */
-#define BOTTOM_RIGHT_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.right] + EYEBROW_Y_THICKNESS
+/** Commands from the main core. It only sends, and the graphics core only receives. */
+static intercore_channel_t inter_core_queue;
 
-/** Macro for looking up top left y position at runtime. */
-#define TOP_LEFT_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.left]
+/** Where inter_core_queue keeps them. */
+static cmd_t inter_core_items[INTER_CORE_QUEUE_SIZE];
 
-/** Macro for looking up top middle y position at runtime. */
-#define TOP_MIDDLE_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.middle]
+/**
+ * Sent in place of a draw command: draw whatever latest_draw holds when it is taken. Never a real draw
+ * (all three vertex pairs "special"), so one from the controller still gets rejected by draw().
+ */
+#define CMD_LCD_DRAW_LATEST ((cmd_t)(CMD_MODULE_ID_LCD | 0x3F))
 
-/** Macro for looking up top right y position at runtime. */
-#define TOP_RIGHT_Y() Y_POS_BASE + LOOKUP_Y_OFFSETS[eyebrow_state.right]
+/** Sent after posting a blit, to run it in its place among the commands. Never a real draw either. See eyebrowsgfx_blit(). */
+#define CMD_LCD_BLIT ((cmd_t)(CMD_MODULE_ID_LCD | 0x3E))
 
-/** A buffer for putting strings into. */
-static char strbuf[32];
+/**
+ * The last draw from the main core: its command in the low byte and, for CMD_LCD_DRAW_VERTICES, the
+ * three bytes after it (with the module ID off) in the bytes above. A burst of draws only needs the
+ * last one, so rather than queueing each of them, the main core leaves them here and only queues a
+ * CMD_LCD_DRAW_LATEST when the one already queued (if any) might be taken before an OFF or TEST sent after it.
+ */
+static volatile uint32_t latest_draw;
 
-/** Smallish value for commands to be fed into the LCD command queue by the main core. */
-#define INTER_CORE_QUEUE_SIZE 32
+/** Main core only: a CMD_LCD_DRAW_VERTICES still waiting for the bytes that follow it, packed as for latest_draw. */
+static uint32_t collecting = 0;
+static uint8_t args_taken = 0;      ///< Bytes of it here so far
+static bool collecting_args = false;
 
-/** Inter-core communication queue. */
-static queue_t inter_core_queue;
+/** How many CMD_LCD_DRAW_LATESTs the main core has queued, and how many the graphics core has taken. */
+static volatile uint32_t draws_sent = 0;
+static volatile uint32_t draws_taken = 0;
+
+/** Main core only: was the last thing queued a CMD_LCD_DRAW_LATEST? */
+static bool last_sent_was_draw = false;
+
+/** Start the graphics core with gfx_resume() instead of gfx_init(). */
+static bool resume_lcd = false;
+
+/** Main core only: the draw command for what's on the LCD (or about to be), or 0 if it's off or showing the test. */
+static cmd_t expression = 0;
 
 /** Which side eye are we (left/right)? */
 static side_t left_or_right_side = EYE_UNASSIGNED_SIDE;
@@ -121,6 +153,11 @@ static void eyebrow_state_to_strbuf(size_t n, char *buf)
 
 static void log_eyebrow_state(void)
 {
+    if (!eyebrow_is_fixed)
+    {
+        log_debug("LCD: Eyebrow vertices: %u %u %u\n", eyebrow_offsets[0], eyebrow_offsets[1], eyebrow_offsets[2]);
+        return;
+    }
     log_debug("LCD: Eyebrow state:");
     eyebrow_state_to_strbuf(count_of(strbuf), strbuf);
     printf(strbuf);
@@ -130,48 +167,88 @@ static void log_eyebrow_state(void)
 /** Label each point on the LCD for debugging purposes. Does not refresh LCD, simply paints to the current buffer. */
 static void label_points(void)
 {
-    DRAW_TEXT(X_POS_LEFT_VERTEX, BOTTOM_LEFT_Y(), "BL");
-    DRAW_TEXT(X_POS_LEFT_VERTEX, TOP_LEFT_Y(), "TL");
-    DRAW_TEXT(X_POS_MIDDLE_VERTEX, BOTTOM_MIDDLE_Y(), "BM");
-    DRAW_TEXT(X_POS_MIDDLE_VERTEX, TOP_MIDDLE_Y(), "TM");
-    DRAW_TEXT(X_POS_RIGHT_VERTEX, BOTTOM_RIGHT_Y(), "BR");
-    DRAW_TEXT(X_POS_RIGHT_VERTEX, TOP_RIGHT_Y(), "TR");
+    faceshapes_label_eyebrow(&eyebrow_state);
 }
 
 static void paint_eyebrow(void)
 {
-    gfx_lcd_reset();
+#if GFX_PRERENDERED_FRAMES
+    // Recall the frame we rendered at build time if it suits this buffer
+    if (eyebrow_is_fixed && gfx_show_frame(&faceframes_eyebrows[faceshapes_eyebrow_index(&eyebrow_state)]))
+    {
+        return;
+    }
+#endif // GFX_PRERENDERED_FRAMES
 
-    // Eyebrow is composed of six vertices:
-    //  Top Left, Top Middle, Top Right
-    //  Btm Left, Btm Middle, Btm Right
-    //
-    // There is a line connecting them like this:
-    //
-    //     * ------- * --------- *
-    //     |                     |
-    //     * ------- * --------- *
+    gfx_clear_paint_buffer();
+    faceshapes_paint_eyebrow_at(eyebrow_offsets[0], eyebrow_offsets[1], eyebrow_offsets[2]);
 
-    // Paint line from bottom left -> top left
-    DRAW_SOLID_LINE(X_POS_LEFT_VERTEX, BOTTOM_LEFT_Y(), X_POS_LEFT_VERTEX, TOP_LEFT_Y());
+    // Send buffer to LCD
+    gfx_swap_buffers();
+}
 
-    // Paint line from top left -> top middle
-    DRAW_SOLID_LINE(X_POS_LEFT_VERTEX, TOP_LEFT_Y(), X_POS_MIDDLE_VERTEX, TOP_MIDDLE_Y());
+/** Forget what is on the LCD, e.g., because it was cleared or something else was drawn over it. */
+static void stop_animation(void)
+{
+    animation.running = false;
+    animation.on_lcd = false;
+}
 
-    // Paint line from top middle -> top right
-    DRAW_SOLID_LINE(X_POS_MIDDLE_VERTEX, TOP_MIDDLE_Y(), X_POS_RIGHT_VERTEX, TOP_RIGHT_Y());
+/** Start tweening from whatever is on the LCD to eyebrow_offsets. Snaps to it if there is nothing to tween from. */
+static void start_animation(void)
+{
+    if (!animation.on_lcd || (EYEBROW_ANIMATION_FRAMES <= 1))
+    {
+        paint_eyebrow();
+        memcpy(animation.shown, eyebrow_offsets, sizeof(eyebrow_offsets));
+        animation.on_lcd = true;
+        animation.running = false;
+        return;
+    }
 
-    // Paint line from top right -> bottom right
-    DRAW_SOLID_LINE(X_POS_RIGHT_VERTEX, TOP_RIGHT_Y(), X_POS_RIGHT_VERTEX, BOTTOM_RIGHT_Y());
+    // Start from where we are, even if that is part way through another animation
+    memcpy(animation.from, animation.shown, sizeof(animation.from));
+    memcpy(animation.to, eyebrow_offsets, sizeof(eyebrow_offsets));
+    animation.frame = 0;
+    animation.running = true;
+}
 
-    // Paint line from bottom left -> bottom middle
-    DRAW_SOLID_LINE(X_POS_LEFT_VERTEX, BOTTOM_LEFT_Y(), X_POS_MIDDLE_VERTEX, BOTTOM_MIDDLE_Y());
+/** Draw the next frame of the animation in progress. */
+static void step_animation(void)
+{
+    animation.frame++;
 
-    // Paint line from bottom middle -> bottom right
-    DRAW_SOLID_LINE(X_POS_MIDDLE_VERTEX, BOTTOM_MIDDLE_Y(), X_POS_RIGHT_VERTEX, BOTTOM_RIGHT_Y());
+    if (animation.frame >= EYEBROW_ANIMATION_FRAMES)
+    {
+        // Land exactly on the eyebrow (which may well be pre-rendered)
+        paint_eyebrow();
+        memcpy(animation.shown, animation.to, sizeof(animation.shown));
+        animation.running = false;
+        return;
+    }
 
-    // Send buffer to LCD
-    gfx_send_paint_buffer_to_lcd();
+    // Ease in and out: smoothstep (3u^2 - 2u^3) of the fraction of frames done, in Q8
+    const int32_t u = ((int32_t)animation.frame << 8) / EYEBROW_ANIMATION_FRAMES;
+    const int32_t eased = (u * u * ((3 << 8) - 2 * u)) >> 16;
+
+    bool moved = false;
+    for (size_t i = 0; i < NUM_VERTEX_PAIRS; i++)
+    {
+        const int32_t distance = (int32_t)animation.to[i] - (int32_t)animation.from[i];
+        const UWORD offset = (UWORD)((int32_t)animation.from[i] + ((distance * eased) >> 8));
+        moved |= (offset != animation.shown[i]);
+        animation.shown[i] = offset;
+    }
+
+    if (!moved)
+    {
+        return;
+    }
+
+    // Only the area the eyebrow leaves or enters gets sent
+    gfx_clear_paint_buffer();
+    faceshapes_paint_eyebrow_at(animation.shown[0], animation.shown[1], animation.shown[2]);
+    gfx_swap_buffers();
 }
 
 static void draw_test(void)
@@ -214,7 +291,7 @@ static void draw_test(void)
     Paint_DrawPoint(btm_right_x, btm_right_y, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
     DRAW_TEXT(btm_right_x, btm_right_y, "BR");
 
-    Paint_DrawString_EN(5, 5, "Graphics Test", &Font20, 0x00F, 0xFFF0);
+    DRAW_TEXT(5, 5, "Graphics Test");
 
     // Send buffer to LCD
     gfx_send_paint_buffer_to_lcd();
@@ -223,8 +300,6 @@ static void draw_test(void)
 
 static void draw(cmd_t command)
 {
-    gfx_lcd_reset();
-
     // Mask off first two bits, these are the subsystem mask
     uint8_t cmd_param = command & 0x3F;
 
@@ -241,7 +316,7 @@ static void draw(cmd_t command)
             // Is the lsb set?
             if (0x01 & (cmd_param >> i))
             {
-                log_error("Illegal command in LCD subsystem: 0x%02X with param: 0x%02X\n", command);
+                log_error("Illegal command in LCD subsystem: 0x%02X with param: 0x%02X\n", command, cmd_param);
                 set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
                 return;
             }
@@ -295,56 +370,195 @@ static void draw(cmd_t command)
     eyebrow_state.left    = (msbs[0] ? VERTEX_POS_MIDDLE : (lsbs[0] ? VERTEX_POS_HIGH : VERTEX_POS_LOW));
     eyebrow_state.middle  = (msbs[1] ? VERTEX_POS_MIDDLE : (lsbs[1] ? VERTEX_POS_HIGH : VERTEX_POS_LOW));
     eyebrow_state.right   = (msbs[2] ? VERTEX_POS_MIDDLE : (lsbs[2] ? VERTEX_POS_HIGH : VERTEX_POS_LOW));
+    eyebrow_offsets[0] = faceshapes_vertex_y_offset(eyebrow_state.left);
+    eyebrow_offsets[1] = faceshapes_vertex_y_offset(eyebrow_state.middle);
+    eyebrow_offsets[2] = faceshapes_vertex_y_offset(eyebrow_state.right);
+    eyebrow_is_fixed = true;
 
     log_eyebrow_state();
 
-    // Paint the new state
-    paint_eyebrow();
+    // Tween to the new state, starting on the next frame
+    eyebrow_state_pending = true;
+}
+
+/**
+ * Act on a CMD_LCD_DRAW_VERTICES, given the three bytes that followed it, packed as for latest_draw:
+ * each vertex pair's height, left first as the left eyebrow sees them.
+ */
+static void draw_vertices(uint32_t args)
+{
+    uint8_t heights[NUM_VERTEX_PAIRS];
+    for (size_t i = 0; i < NUM_VERTEX_PAIRS; i++)
+    {
+        heights[i] = (uint8_t)((args >> (8 * i)) & 0x3F);
+    }
+
+    // The right eyebrow is the left one's mirror image, as for draw()
+    if (left_or_right_side == EYE_RIGHT_SIDE)
+    {
+        const uint8_t tmp = heights[0];
+        heights[0] = heights[2];
+        heights[2] = tmp;
+    }
+
+    for (size_t i = 0; i < NUM_VERTEX_PAIRS; i++)
+    {
+        eyebrow_offsets[i] = faceshapes_vertex_height_offset(heights[i]);
+    }
+    eyebrow_is_fixed = false;
+
+    log_eyebrow_state();
+
+    // Tween to it, starting on the next frame
+    eyebrow_state_pending = true;
+}
+
+/** Draw this frame of whatever is going on. */
+static void render_frame(void)
+{
+    if (eyebrow_state_pending)
+    {
+        eyebrow_state_pending = false;
+        start_animation();
+    }
+
+    if (animation.running)
+    {
+        step_animation();
+    }
+}
+
+/** Act on a command from the other core. Drawing is left to render_frame(). */
+static void handle_command(cmd_t command)
+{
+    if (command == CMD_LCD_DRAW_LATEST)
+    {
+        // Count it taken before reading the draw, so a newer one is either read here or gets its own
+        draws_taken = draws_taken + 1;
+        __dmb();
+        const uint32_t latest = latest_draw;
+        log_debug("LCD: Draw\n");
+        if ((cmd_t)(latest & 0xFF) == CMD_LCD_DRAW_VERTICES)
+        {
+            draw_vertices(latest >> 8);
+        }
+        else
+        {
+            draw((cmd_t)latest);
+        }
+        return;
+    }
+
+    if (command == CMD_LCD_BLIT)
+    {
+        log_debug("LCD: Blit\n");
+        stop_animation();
+        eyebrow_state_pending = false;
+        gfx_blit_run();
+        return;
+    }
+
+    if ((command & CMD_LCD_SET_THEME_MASK) == CMD_LCD_SET_THEME)
+    {
+        log_debug("LCD: Theme\n");
+        gfx_set_theme((gfx_theme_t)(command & ~CMD_LCD_SET_THEME_MASK));
+        return;
+    }
+
+    switch (command)
+    {
+        case CMD_LCD_OFF:
+            log_debug("LCD: off\n");
+            stop_animation();
+            eyebrow_state_pending = false;
+            gfx_lcd_reset();
+            break;
+        case CMD_LCD_TEST:
+            log_debug("LCD: test\n");
+            stop_animation();
+            eyebrow_state_pending = false;
+            draw_test();
+            break;
+        default:
+            {
+                if ((command & 0xC0) != CMD_MODULE_ID_LCD)
+                {
+                    log_error("Illegal cmd type 0x%02X\n in graphics subsystem\n", command);
+                }
+                else
+                {
+                    log_debug("LCD: Draw\n");
+                    draw(command);
+                }
+            }
+            break;
+    }
+}
+
+/** Is a command waiting to go into a newer frame than the one going out? */
+static bool command_waiting(void)
+{
+    return intercore_count(&inter_core_queue) > 0;
 }
 
 static void core_task(void)
 {
-    gfx_init(LCD_SIZE_EYEBROWS);
+    // The settings store pauses us (in RAM) while it writes to flash
+    multicore_lockout_victim_init();
 
-    // Left eyebrow LCD is installed upside-down
-    if (left_or_right_side == EYE_LEFT_SIDE)
+    if (resume_lcd)
     {
-        Paint_SetRotate(ROTATE_180);
+        gfx_resume(LCD_SIZE_EYEBROWS);
     }
     else
     {
-        Paint_SetRotate(ROTATE_0);
+        gfx_init(LCD_SIZE_EYEBROWS);
     }
+    // A command that comes in while a frame is going out cuts it short
+    gfx_set_superseded_check(command_waiting);
+
+    // Left eyebrow LCD is installed upside-down
+    gfx_set_upside_down(left_or_right_side == EYE_LEFT_SIDE);
     Paint_Clear(WHITE);
 
     while (true)
     {
         cmd_t command;
-        queue_remove_blocking(&inter_core_queue, &command);
-        switch (command)
+        if (!animation.running && !eyebrow_state_pending)
         {
-            case CMD_LCD_OFF:
-                log_debug("LCD: off\n");
-                gfx_lcd_reset();
-                break;
-            case CMD_LCD_TEST:
-                log_debug("LCD: test\n");
-                draw_test();
-                break;
-            default:
-                {
-                    if ((command & 0xC0) != CMD_MODULE_ID_LCD)
-                    {
-                        log_error("Illegal cmd type 0x%02X\n in graphics subsystem\n", command);
-                    }
-                    else
-                    {
-                        log_debug("LCD: Draw\n");
-                        draw(command);
-                    }
-                }
-                break;
+            // Nothing to draw: sleep until a command comes in (the LCD too, if it's a while), then draw it straight away
+            gfx_idle_receive(&inter_core_queue, &command);
+            handle_command(command);
+            gfx_frame_clock_start();
         }
+
+        if (gfx_flush_stopped())
+        {
+            // The last frame was cut short for what's waiting, so show it now
+            gfx_frame_clock_start();
+        }
+        gfx_wait_for_frame();
+
+        // Everything that came in during the last frame goes into this one
+        while (intercore_try_receive(&inter_core_queue, &command))
+        {
+            handle_command(command);
+        }
+        TRACE_BEGIN(TRACE_ID_RENDER_FRAME, 0);
+        TRACE_PROBE(TRACE_PROBE_RENDER_START);
+        const uint32_t frame_start = time_us_32();
+        render_frame();
+        // In case what cut the last frame short didn't draw anything after all
+        gfx_flush_rest();
+        TRACE_END(TRACE_ID_RENDER_FRAME, 0);
+#if TRACE_PROBES_ENABLED
+        // The frame is on the glass once its last transfer is out. Waiting for it here costs
+        // the next frame its head start, so only probe builds do.
+        gfx_wait_for_lcd();
+        TRACE_PROBE(TRACE_PROBE_FLUSH_END);
+#endif // TRACE_PROBES_ENABLED
+        metrics_count(METRICS_COUNT_FRAMES, 1);
+        gfx_overlay_frame(time_us_32() - frame_start);
     }
 }
 
@@ -353,21 +567,142 @@ void eyebrowsgfx_init(side_t side)
     // Set the module-level variable to tell us which side we are (left or right)
     left_or_right_side = side;
 
-    // Initialize the inter-core queue with a mutex to be safe.
-    static const uint SPINLOCK_ID = 0; // If we need more than one of these, we should put them all in the same header.
-    queue_init_with_spinlock(&inter_core_queue, sizeof(cmd_t), INTER_CORE_QUEUE_SIZE, SPINLOCK_ID);
+    // Before the graphics core can wait on it
+    intercore_channel_init(&inter_core_queue, inter_core_items, sizeof(cmd_t), INTER_CORE_QUEUE_SIZE);
+    gfx_blit_init();
 
     // Start up the task for the other core
     multicore_launch_core1(core_task);
 }
 
+/** Queue a command for the graphics core, and show metrics how full that leaves its queue. Returns false (a drop) if it's full. */
+static bool send_work(cmd_t command)
+{
+    if (!intercore_try_send(&inter_core_queue, &command))
+    {
+        metrics_count(METRICS_COUNT_DROPS, 1);
+        return false;
+    }
+    metrics_level(METRICS_LEVEL_GFX_QUEUE, intercore_count(&inter_core_queue));
+    return true;
+}
+
+static void send_command(cmd_t command)
+{
+    if (!send_work(command))
+    {
+        log_error("LCD: Could not add command to work queue. Queue is full.\n");
+    }
+}
+
+/** Have the graphics core draw the given draw (packed as for latest_draw). It replaces any draw that hasn't been drawn yet. */
+static void send_draw(uint32_t draw)
+{
+    latest_draw = draw;
+    __dmb();
+    if (last_sent_was_draw && (draws_taken != draws_sent))
+    {
+        // The one queued is the last thing queued and hasn't been taken, so it will draw this
+        return;
+    }
+
+    // Counted before it is queued, so it can't be taken before it is counted
+    draws_sent = draws_sent + 1;
+    __dmb();
+    if (send_work(CMD_LCD_DRAW_LATEST))
+    {
+        last_sent_was_draw = true;
+    }
+    else
+    {
+        draws_sent = draws_sent - 1;
+        last_sent_was_draw = false;
+        log_error("LCD: Could not add command to work queue. Queue is full.\n");
+    }
+}
+
 void eyebrowsgfx_cmd(cmd_t command)
 {
     // This function is called from the main thread's core.
+    // A CMD_LCD_DRAW_VERTICES is only complete once the bytes after it (the next LCD commands) are here.
+    if (collecting_args)
+    {
+        args_taken++;
+        collecting |= (uint32_t)(command & ~CMD_MODULE_ID_LCD) << (8 * args_taken);
+        if (args_taken < NUM_VERTEX_PAIRS)
+        {
+            return;
+        }
+        collecting_args = false;
+        // Not drawn again after a warm restart, but it stays up on the LCD
+        expression = 0;
+        send_draw(collecting);
+        return;
+    }
+
+    if (command == CMD_LCD_DRAW_VERTICES)
+    {
+        collecting = command;
+        args_taken = 0;
+        collecting_args = true;
+        return;
+    }
+
     // Submit the work item to the other core for processing and return.
-    bool added = queue_try_add(&inter_core_queue, &command);
-    if (!added)
+    if ((command == CMD_LCD_OFF) || (command == CMD_LCD_TEST) || ((command & 0xC0) != CMD_MODULE_ID_LCD))
     {
-        log_error("LCD: Could not add command to work queue. Queue is full.\n");
+        expression = ((command == CMD_LCD_OFF) || (command == CMD_LCD_TEST)) ? 0 : expression;
+        last_sent_was_draw = false;
+        send_command(command);
+        return;
+    }
+
+    expression = command;
+    send_draw(command);
+}
+
+void eyebrowsgfx_frame_end(void)
+{
+    // This function is called from the main thread's core, like eyebrowsgfx_cmd().
+    if (collecting_args)
+    {
+        log_error("LCD: Command 0x%02X is missing %u of its bytes\n", CMD_LCD_DRAW_VERTICES, (uint)(NUM_VERTEX_PAIRS - args_taken));
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        collecting_args = false;
+    }
+}
+
+bool eyebrowsgfx_blit(const gfx_blit_t *blit)
+{
+    // We're the only sender on both queues, so if there's room in each now, there still is once we've sent
+    if ((intercore_count(&inter_core_queue) == INTER_CORE_QUEUE_SIZE) || !gfx_blit_post(blit))
+    {
+        log_error("LCD: Could not add blit to work queue. Queue is full.\n");
+        return false;
+    }
+
+    // Nothing to draw again after a warm restart
+    expression = 0;
+    last_sent_was_draw = false;
+    send_command(CMD_LCD_BLIT);
+    return true;
+}
+
+void eyebrowsgfx_resume(side_t side, cmd_t shown)
+{
+    resume_lcd = true;
+    eyebrowsgfx_init(side);
+
+    // Paint it again straight away, so everything else picks up from it
+    if (shown != 0)
+    {
+        eyebrowsgfx_cmd(shown);
     }
 }
+
+cmd_t eyebrowsgfx_expression(void)
+{
+    return expression;
+}
+
+#endif // MOUTH
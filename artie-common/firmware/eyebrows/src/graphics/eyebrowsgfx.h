@@ -11,6 +11,7 @@ extern "C" {
 
 #include "../cmds/cmds.h"
 #include "../board/types.h"
+#include "commongfx.h"
 
 /**
  * @brief Initialize graphics (and LCD) libraries.
@@ -19,6 +20,27 @@ extern "C" {
  */
 void eyebrowsgfx_init(side_t side);
 
+/**
+ * @brief Like eyebrowsgfx_init(), after a warm restart: the LCD is still set up, so it isn't reset or
+ * cleared, and the eyebrow it was showing is painted again straight away.
+ *
+ * @param side Whether this MCU is left or right eyebrow.
+ * @param shown What eyebrowsgfx_expression() was before the restart.
+ */
+void eyebrowsgfx_resume(side_t side, cmd_t shown);
+
+/** The draw command for the eyebrow on the LCD (or about to be), or 0 if the LCD is off or showing its test. */
+cmd_t eyebrowsgfx_expression(void);
+
+/**
+ * @brief Have the graphics core run a blit (see gfx_blit_t), in order with the commands around it.
+ * It stops any animation, and the eyebrow is drawn afresh by the next draw command.
+ *
+ * @param blit The blit. Copied, but its frame or pixels must be left alone until its done callback.
+ * @return false if the work queue is full.
+ */
+bool eyebrowsgfx_blit(const gfx_blit_t *blit);
+
 /**
  * @brief Handles the given LCD subsystem command.
  *
@@ -35,9 +57,22 @@ void eyebrowsgfx_init(side_t side);
  * OR we have a special command. If x is set and y is also set,
  * then it is a special command. If x is set and y is cleared,
  * then we ignore the y and set the vertex pair to middle.
+ *
+ * The vertex pairs can also go anywhere in between: CMD_LCD_DRAW_VERTICES must be followed
+ * by three bytes, each CMD_MODULE_ID_LCD | n: the left, middle, and right vertex pair's height
+ * (as the left eyebrow sees them, like the draw commands), from 0 (low) up to
+ * EYEBROW_VERTEX_HEIGHT_MAX (high). Send all four in the same frame. The eyebrow is painted with
+ * sub-pixel vertices and anti-aliased edges, and tweened to over EYEBROW_ANIMATION_FRAMES like any
+ * other. It is not drawn again after a warm restart, so eyebrowsgfx_expression() is 0 while it's shown.
  */
 void eyebrowsgfx_cmd(cmd_t command);
 
+/**
+ * @brief The frame eyebrowsgfx_cmd() was given has ended. A CMD_LCD_DRAW_VERTICES still missing
+ * some of its bytes is dropped, and sets errno.
+ */
+void eyebrowsgfx_frame_end(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,35 @@
+/**
+ * @file faceframes.h
+ * @brief Every expression, pre-rendered at build time by tools/facegen and kept in flash.
+ *
+ * Only available when built with GFX_PRERENDERED_FRAMES; otherwise the expressions
+ * are always painted at runtime (see faceshapes.h).
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <GUI_Paint.h>
+#include "commongfx.h"
+#include "faceshapes.h"
+
+#ifndef GFX_PRERENDERED_FRAMES
+    #define GFX_PRERENDERED_FRAMES 0
+#endif // GFX_PRERENDERED_FRAMES
+
+/** Each eyebrow (by faceshapes_eyebrow_index()). The left eye's LCD turns it over itself. */
+extern const gfx_frame_t faceframes_eyebrows[NUM_EYEBROW_STATES];
+
+/** Each static mouth expression. */
+extern const gfx_frame_t faceframes_mouth[NUM_MOUTH_SHAPES];
+
+/** Each lip-sync viseme. */
+extern const gfx_frame_t faceframes_visemes[NUM_VISEMES];
+
+#ifdef __cplusplus
+}
+#endif
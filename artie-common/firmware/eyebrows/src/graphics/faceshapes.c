@@ -0,0 +1,351 @@
+// Std lib includes
+#include <stdbool.h>
+#include <stdint.h>
+// Library includes
+#include <GUI_Paint.h>
+// Local includes
+#include "commongfx.h"
+#include "faceshapes.h"
+
+/** The pixel X location of left vertices. */
+static const UWORD X_POS_LEFT_VERTEX = 25;
+
+/** The pixel X location of middle vertices. */
+static const UWORD X_POS_MIDDLE_VERTEX = 115;
+
+/** The pixel X location of right vertices. */
+static const UWORD X_POS_RIGHT_VERTEX = 200;
+
+/** The Y offsets to apply when in VERTEX_POS_LOW, VERTEX_POS_MIDDLE, or VERTEX_POS_HIGH */
+static const UWORD LOOKUP_Y_OFFSETS[] = {50, 25, 0};
+
+/** The starting Y value for any vertex. Apply an offset from LOOKUP_Y_OFFSETS. */
+static const UWORD Y_POS_BASE = 25;
+
+/** The thickness of the eyebrow. */
+static const UWORD EYEBROW_Y_THICKNESS = 50;
+
+/** Macro for looking up bottom left y position at runtime. */
+#define BOTTOM_LEFT_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->left] + EYEBROW_Y_THICKNESS
+
+/** Macro for looking up bottom middle y position at runtime. */
+#define BOTTOM_MIDDLE_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->middle] + EYEBROW_Y_THICKNESS
+
+/** Macro for looking up bottom right y position at runtime. */
+#define BOTTOM_RIGHT_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->right] + EYEBROW_Y_THICKNESS
+
+/** Macro for looking up top left y position at runtime. */
+#define TOP_LEFT_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->left]
+
+/** Macro for looking up top middle y position at runtime. */
+#define TOP_MIDDLE_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->middle]
+
+/** Macro for looking up top right y position at runtime. */
+#define TOP_RIGHT_Y(e) Y_POS_BASE + LOOKUP_Y_OFFSETS[(e)->right]
+
+/** The width of the mouth. */
+#define MOUTH_WIDTH 275
+
+/** The x position of the left corner of the mouth. */
+#define X_POS_LEFT_CORNER 20
+
+#define X_POS_RIGHT_CORNER (X_POS_LEFT_CORNER + MOUTH_WIDTH)
+
+/** The y position of the two corners of the mouth. */
+#define Y_POS_CORNERS 120
+
+/** The x position of the center of the mouth. */
+#define X_POS_CENTER (X_POS_LEFT_CORNER + (MOUTH_WIDTH / 2))
+
+/**
+ * How far round from the middle of its circle each corner of a smile or frown is, in degrees.
+ * The circle's center is a quarter of its radius above (or below) the corners, and asin(1/4) is about 15.
+ */
+#define SMILE_CORNER_DEG 15
+
+/** Same for the open smile, whose corners are 10 pixels higher: asin((34 - 10) / 137) is about 10. */
+#define OPEN_SMILE_CORNER_DEG 10
+
+/** Number of vertices in the polygon we approximate an open mouth with. */
+#define MOUTH_OUTLINE_POINTS 16
+
+/** Cosine of each of the MOUTH_OUTLINE_POINTS angles around the mouth, in Q7. The sines are a quarter turn on. */
+static const int16_t OUTLINE_COS_Q7[MOUTH_OUTLINE_POINTS] = {
+    128, 118, 91, 49, 0, -49, -91, -118, -128, -118, -91, -49, 0, 49, 91, 118
+};
+
+/** How wide and how open the mouth is for each viseme. A height of zero is a closed line. */
+static const struct {
+    UWORD width;
+    UWORD height;
+} VISEME_SIZES[NUM_VISEMES] = {
+    [VISEME_REST]   = {MOUTH_WIDTH, 0},
+    [VISEME_MBP]    = {(MOUTH_WIDTH * 3) / 4, 0},
+    [VISEME_AI]     = {220, 110},
+    [VISEME_E]      = {240, 60},
+    [VISEME_O]      = {130, 120},
+    [VISEME_U]      = {80, 70},
+    [VISEME_FV]     = {200, 24},
+    [VISEME_L]      = {180, 70},
+    [VISEME_WQ]     = {70, 50},
+    [VISEME_ETC]    = {190, 44},
+};
+
+UWORD faceshapes_vertex_y_offset(vertex_pos_t pos)
+{
+    return LOOKUP_Y_OFFSETS[pos] * PAINT_SUBPIXELS;
+}
+
+UWORD faceshapes_vertex_height_offset(uint8_t height)
+{
+    const uint32_t lowest = LOOKUP_Y_OFFSETS[VERTEX_POS_LOW] * PAINT_SUBPIXELS;
+    height = (height > EYEBROW_VERTEX_HEIGHT_MAX) ? EYEBROW_VERTEX_HEIGHT_MAX : height;
+    return (UWORD)((((EYEBROW_VERTEX_HEIGHT_MAX - height) * lowest) + (EYEBROW_VERTEX_HEIGHT_MAX / 2)) / EYEBROW_VERTEX_HEIGHT_MAX);
+}
+
+void faceshapes_paint_eyebrow_at(UWORD left_offset, UWORD middle_offset, UWORD right_offset)
+{
+    // Eyebrow is composed of six vertices:
+    //  Top Left, Top Middle, Top Right
+    //  Btm Left, Btm Middle, Btm Right
+    //
+    // We fill the polygon they make:
+    //
+    //     * ------- * --------- *
+    //     |#####################|
+    //     * ------- * --------- *
+    //
+    // The edges are anti-aliased if the paint buffer has the grayscale (2 bpp) palette, and
+    // the vertices are in sub-pixels, so an eyebrow part way between two moves smoothly.
+    const UWORD top = Y_POS_BASE * PAINT_SUBPIXELS;
+    const UWORD bottom = (Y_POS_BASE + EYEBROW_Y_THICKNESS) * PAINT_SUBPIXELS;
+    const PAINT_POINT vertices[] = {
+        {X_POS_LEFT_VERTEX * PAINT_SUBPIXELS,   top + left_offset},
+        {X_POS_MIDDLE_VERTEX * PAINT_SUBPIXELS, top + middle_offset},
+        {X_POS_RIGHT_VERTEX * PAINT_SUBPIXELS,  top + right_offset},
+        {X_POS_RIGHT_VERTEX * PAINT_SUBPIXELS,  bottom + right_offset},
+        {X_POS_MIDDLE_VERTEX * PAINT_SUBPIXELS, bottom + middle_offset},
+        {X_POS_LEFT_VERTEX * PAINT_SUBPIXELS,   bottom + left_offset},
+    };
+    Paint_FillPolygonAASubpixel(vertices, sizeof(vertices) / sizeof(vertices[0]), BLACK);
+}
+
+void faceshapes_paint_eyebrow(const eyebrow_t *eyebrow)
+{
+    faceshapes_paint_eyebrow_at(faceshapes_vertex_y_offset(eyebrow->left), faceshapes_vertex_y_offset(eyebrow->middle),
+                                faceshapes_vertex_y_offset(eyebrow->right));
+}
+
+void faceshapes_label_eyebrow(const eyebrow_t *eyebrow)
+{
+    DRAW_TEXT(X_POS_LEFT_VERTEX, BOTTOM_LEFT_Y(eyebrow), "BL");
+    DRAW_TEXT(X_POS_LEFT_VERTEX, TOP_LEFT_Y(eyebrow), "TL");
+    DRAW_TEXT(X_POS_MIDDLE_VERTEX, BOTTOM_MIDDLE_Y(eyebrow), "BM");
+    DRAW_TEXT(X_POS_MIDDLE_VERTEX, TOP_MIDDLE_Y(eyebrow), "TM");
+    DRAW_TEXT(X_POS_RIGHT_VERTEX, BOTTOM_RIGHT_Y(eyebrow), "BR");
+    DRAW_TEXT(X_POS_RIGHT_VERTEX, TOP_RIGHT_Y(eyebrow), "TR");
+}
+
+static void paint_mouth_smile(void)
+{
+    // Bottom of a circle, from one corner round to the other
+    uint16_t radius = MOUTH_WIDTH / 2;
+    DRAW_ARC(X_POS_CENTER, Y_POS_CORNERS - (radius / 4), radius, SMILE_CORNER_DEG, 180 - SMILE_CORNER_DEG);
+}
+
+static void paint_mouth_frown(void)
+{
+    // Top of a circle, translated down so the corners are at Y_POS_CORNERS
+    uint16_t radius = MOUTH_WIDTH / 2;
+    DRAW_ARC(X_POS_CENTER, Y_POS_CORNERS + (radius / 4), radius, 180 + SMILE_CORNER_DEG, 360 - SMILE_CORNER_DEG);
+}
+
+static void paint_mouth_line(void)
+{
+    DRAW_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER, Y_POS_CORNERS);
+}
+
+static void paint_mouth_smirk(void)
+{
+    const UWORD rad = MOUTH_WIDTH / 6;
+
+    // Draw a line
+    DRAW_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER - rad, Y_POS_CORNERS);
+
+    // Curve up from the end of the line: the bottom right quarter of a small circle
+    DRAW_ARC(X_POS_RIGHT_CORNER - rad, Y_POS_CORNERS - rad, rad, 0, 90);
+}
+
+static void paint_mouth_zigzag(void)
+{
+    // Draw a bunch of lines, each of which starts at the end of the line previous
+    uint8_t nzigs = 5;
+    UWORD start_x = X_POS_LEFT_CORNER;
+    UWORD start_y = Y_POS_CORNERS;
+    const UWORD bottom_y = start_y - 25;
+    UWORD end_x = start_x + (MOUTH_WIDTH / nzigs);
+    UWORD end_y = bottom_y;
+    bool down = true;
+    for (uint8_t i = 0; i < nzigs; i++)
+    {
+        DRAW_SOLID_LINE(start_x, start_y, end_x, end_y);
+        down = !down;
+        start_x = end_x;
+        start_y = end_y;
+        end_x += (MOUTH_WIDTH / nzigs);
+        end_y = down ? bottom_y : Y_POS_CORNERS;
+    }
+}
+
+static void paint_mouth_open(void)
+{
+    // Draw a circle
+    DRAW_CIRCLE(X_POS_CENTER, Y_POS_CORNERS, MOUTH_WIDTH/4);
+}
+
+static void paint_mouth_open_smile(void)
+{
+    // Draw the bottom of a circle, up to the top line
+    uint16_t up = 10;
+    uint16_t radius = MOUTH_WIDTH / 2;
+    DRAW_ARC(X_POS_CENTER, Y_POS_CORNERS - (radius / 4), radius, OPEN_SMILE_CORNER_DEG, 180 - OPEN_SMILE_CORNER_DEG);
+
+    // Draw top line
+    DRAW_SOLID_LINE(X_POS_LEFT_CORNER + 1, Y_POS_CORNERS - up, X_POS_RIGHT_CORNER - 1, Y_POS_CORNERS - up);
+}
+
+void faceshapes_paint_mouth(mouth_shape_t shape)
+{
+    switch (shape)
+    {
+        case MOUTH_SHAPE_SMILE:
+            paint_mouth_smile();
+            break;
+        case MOUTH_SHAPE_FROWN:
+            paint_mouth_frown();
+            break;
+        case MOUTH_SHAPE_LINE:
+            paint_mouth_line();
+            break;
+        case MOUTH_SHAPE_SMIRK:
+            paint_mouth_smirk();
+            break;
+        case MOUTH_SHAPE_ZIG_ZAG:
+            paint_mouth_zigzag();
+            break;
+        case MOUTH_SHAPE_OPEN:
+            paint_mouth_open();
+            break;
+        case MOUTH_SHAPE_OPEN_SMILE:
+            paint_mouth_open_smile();
+            break;
+        default:
+            break;
+    }
+}
+
+void faceshapes_erase_mouth(mouth_shape_t shape)
+{
+    switch (shape)
+    {
+        case MOUTH_SHAPE_LINE:
+            ERASE_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER, Y_POS_CORNERS);
+            break;
+        case MOUTH_SHAPE_OPEN:
+            ERASE_CIRCLE(X_POS_CENTER, Y_POS_CORNERS, MOUTH_WIDTH/4);
+            break;
+        default:
+            break;
+    }
+}
+
+/** Clamp value to [-limit, limit]. */
+static int16_t clamp_param(int16_t value, int16_t limit)
+{
+    return (value > limit) ? limit : ((value < -limit) ? -limit : value);
+}
+
+/** The parameters, each clamped to its range. */
+static mouth_params_t clamp_params(const mouth_params_t *params)
+{
+    mouth_params_t clamped = {
+        .curve = clamp_param(params->curve, MOUTH_MAX_CURVE),
+        .open = (params->open < 0) ? 0 : clamp_param(params->open, MOUTH_MAX_OPEN),
+        .tilt = clamp_param(params->tilt, MOUTH_MAX_TILT),
+    };
+    return clamped;
+}
+
+void faceshapes_paint_mouth_params(const mouth_params_t *params)
+{
+    const mouth_params_t p = clamp_params(params);
+    const UWORD left_y = Y_POS_CORNERS + p.tilt;
+    const UWORD right_y = Y_POS_CORNERS - p.tilt;
+
+    // A quadratic Bezier passes halfway between its control point and the middle of its ends,
+    // so to sag s below the corners the control point goes 2s below them
+    const int lower_sag = p.curve + (p.open / 2);
+    DRAW_CURVE(X_POS_LEFT_CORNER, left_y, X_POS_CENTER, Y_POS_CORNERS + (2 * lower_sag), X_POS_RIGHT_CORNER, right_y);
+    if (p.open > 0)
+    {
+        const int upper_sag = lower_sag - p.open;
+        DRAW_CURVE(X_POS_LEFT_CORNER, left_y, X_POS_CENTER, Y_POS_CORNERS + (2 * upper_sag), X_POS_RIGHT_CORNER, right_y);
+    }
+}
+
+void faceshapes_mouth_params_box(const mouth_params_t *params, gfx_box_t *box)
+{
+    // Each lip is at most its sag plus the tilt away from Y_POS_CORNERS, and the stroke reaches LINE_WIDTH past that
+    const mouth_params_t p = clamp_params(params);
+    const int16_t tilt = (p.tilt < 0) ? -p.tilt : p.tilt;
+    const int16_t lower_sag = p.curve + (p.open / 2);
+    const int16_t upper_sag = lower_sag - p.open;
+    const int16_t top = (upper_sag < 0) ? upper_sag : 0;
+    const int16_t bottom = (lower_sag > 0) ? lower_sag : 0;
+    box->xstart = X_POS_LEFT_CORNER - LINE_WIDTH;
+    box->xend = X_POS_RIGHT_CORNER + LINE_WIDTH;
+    box->ystart = Y_POS_CORNERS + top - tilt - LINE_WIDTH;
+    box->yend = Y_POS_CORNERS + bottom + tilt + LINE_WIDTH;
+}
+
+void faceshapes_paint_viseme(viseme_t viseme)
+{
+    if (viseme >= NUM_VISEMES)
+    {
+        return;
+    }
+
+    const int32_t half_width = VISEME_SIZES[viseme].width / 2;
+    const int32_t half_height = VISEME_SIZES[viseme].height / 2;
+    if (half_height == 0)
+    {
+        DRAW_SOLID_LINE(X_POS_CENTER - half_width, Y_POS_CORNERS, X_POS_CENTER + half_width, Y_POS_CORNERS);
+        return;
+    }
+
+    // Open mouths are filled ellipses centered between the corners
+    PAINT_POINT vertices[MOUTH_OUTLINE_POINTS];
+    for (uint8_t i = 0; i < MOUTH_OUTLINE_POINTS; i++)
+    {
+        const int32_t cos_q7 = OUTLINE_COS_Q7[i];
+        const int32_t sin_q7 = OUTLINE_COS_Q7[(i + (3 * MOUTH_OUTLINE_POINTS / 4)) % MOUTH_OUTLINE_POINTS];
+        vertices[i].X = (UWORD)(X_POS_CENTER + ((half_width * cos_q7) / 128));
+        vertices[i].Y = (UWORD)(Y_POS_CORNERS + ((half_height * sin_q7) / 128));
+    }
+    Paint_FillPolygonAA(vertices, MOUTH_OUTLINE_POINTS, BLACK);
+}
+
+void faceshapes_label_mouth(void)
+{
+    // Label left corner of the mouth
+    Paint_DrawPoint(X_POS_LEFT_CORNER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
+    DRAW_TEXT(X_POS_LEFT_CORNER, Y_POS_CORNERS, "L");
+
+    // Label right corner of the mouth
+    Paint_DrawPoint(X_POS_RIGHT_CORNER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
+    DRAW_TEXT(X_POS_RIGHT_CORNER, Y_POS_CORNERS, "R");
+
+    // Label the center of the mouth
+    Paint_DrawPoint(X_POS_CENTER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
+    DRAW_TEXT(X_POS_CENTER, Y_POS_CORNERS, "C");
+}
@@ -0,0 +1,148 @@
+/**
+ * @file faceshapes.h
+ * @brief The shapes that make up each facial expression, painted with GUI_Paint only.
+ *
+ * Nothing in here touches the LCD, timers, or the other core, so the same code
+ * paints the expressions at runtime and pre-renders them at build time (see tools/facegen).
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <GUI_Paint.h>
+#include "commongfx.h"
+
+/** The location of a given pair of vertices */
+typedef enum {
+    VERTEX_POS_LOW = 0,
+    VERTEX_POS_MIDDLE = 1,
+    VERTEX_POS_HIGH = 2
+} vertex_pos_t;
+
+/** Number of positions each vertex pair can be in. */
+#define NUM_VERTEX_POSITIONS 3
+
+/** The eyebrow that we draw. */
+typedef struct {
+    vertex_pos_t left;
+    vertex_pos_t middle;
+    vertex_pos_t right;
+} eyebrow_t;
+
+/** Number of distinct eyebrows. */
+#define NUM_EYEBROW_STATES (NUM_VERTEX_POSITIONS * NUM_VERTEX_POSITIONS * NUM_VERTEX_POSITIONS)
+
+/** The static mouth expressions. */
+typedef enum {
+    MOUTH_SHAPE_SMILE = 0,
+    MOUTH_SHAPE_FROWN,
+    MOUTH_SHAPE_LINE,
+    MOUTH_SHAPE_SMIRK,
+    MOUTH_SHAPE_ZIG_ZAG,
+    MOUTH_SHAPE_OPEN,
+    MOUTH_SHAPE_OPEN_SMILE,
+    NUM_MOUTH_SHAPES
+} mouth_shape_t;
+
+/**
+ * Mouth shapes for lip-sync, one per group of speech sounds that look alike.
+ * Sent to the mouth in the four LSbs of CMD_LCD_MOUTH_VISEME.
+ */
+typedef enum {
+    VISEME_REST = 0,    ///< Silence: closed mouth
+    VISEME_MBP,         ///< M, B, P: lips pressed together
+    VISEME_AI,          ///< A, I: wide open
+    VISEME_E,           ///< E: wide, half open
+    VISEME_O,           ///< O: round
+    VISEME_U,           ///< U: small and round
+    VISEME_FV,          ///< F, V: teeth on lip, nearly closed
+    VISEME_L,           ///< L, TH: open, tongue showing
+    VISEME_WQ,          ///< W, Q: puckered
+    VISEME_ETC,         ///< C, D, G, K, N, R, S, T, Y, Z: slightly open
+    NUM_VISEMES
+} viseme_t;
+
+/** Furthest the middle of a parametric mouth bends away from its corners, in pixels. */
+#define MOUTH_MAX_CURVE 48
+
+/** Furthest apart the lips of a parametric mouth open in the middle, in pixels. */
+#define MOUTH_MAX_OPEN 64
+
+/** Furthest one corner of a parametric mouth sits above the other, in pixels. */
+#define MOUTH_MAX_TILT 24
+
+/** A mouth drawn from parameters (see faceshapes_paint_mouth_params()), rather than one of the fixed shapes. */
+typedef struct {
+    int16_t curve;  ///< How far the middle sits below the corners, negative for a frown. Up to MOUTH_MAX_CURVE either way.
+    int16_t open;   ///< How far apart the lips are in the middle, 0 (closed) up to MOUTH_MAX_OPEN
+    int16_t tilt;   ///< How far the right corner sits above the left, negative for the other way. Up to MOUTH_MAX_TILT either way.
+} mouth_params_t;
+
+/** Index of the given eyebrow among the NUM_EYEBROW_STATES of them. */
+static inline uint8_t faceshapes_eyebrow_index(const eyebrow_t *eyebrow)
+{
+    return (uint8_t)((eyebrow->left * NUM_VERTEX_POSITIONS + eyebrow->middle) * NUM_VERTEX_POSITIONS + eyebrow->right);
+}
+
+/** The eyebrow with the given index. Inverse of faceshapes_eyebrow_index(). */
+static inline eyebrow_t faceshapes_eyebrow_from_index(uint8_t index)
+{
+    eyebrow_t eyebrow = {
+        .left = (vertex_pos_t)(index / (NUM_VERTEX_POSITIONS * NUM_VERTEX_POSITIONS)),
+        .middle = (vertex_pos_t)((index / NUM_VERTEX_POSITIONS) % NUM_VERTEX_POSITIONS),
+        .right = (vertex_pos_t)(index % NUM_VERTEX_POSITIONS),
+    };
+    return eyebrow;
+}
+
+/** Highest a vertex pair can be put by height (see faceshapes_vertex_height_offset()): VERTEX_POS_HIGH. 0 is VERTEX_POS_LOW. */
+#define EYEBROW_VERTEX_HEIGHT_MAX 63
+
+/** How far the given position puts a pair of vertices below the highest one, in 1/PAINT_SUBPIXELS of a pixel. */
+UWORD faceshapes_vertex_y_offset(vertex_pos_t pos);
+
+/**
+ * Like faceshapes_vertex_y_offset(), for a pair of vertices the given height (0 to EYEBROW_VERTEX_HEIGHT_MAX)
+ * up from VERTEX_POS_LOW to VERTEX_POS_HIGH, so it can sit anywhere in between to within a sub-pixel.
+ */
+UWORD faceshapes_vertex_height_offset(uint8_t height);
+
+/** Paint the given eyebrow into the current (cleared) paint buffer. */
+void faceshapes_paint_eyebrow(const eyebrow_t *eyebrow);
+
+/**
+ * Paint an eyebrow whose vertex pairs sit the given distances below the highest position
+ * (in 1/PAINT_SUBPIXELS of a pixel, see faceshapes_vertex_y_offset()), e.g., part way between two eyebrows.
+ */
+void faceshapes_paint_eyebrow_at(UWORD left_offset, UWORD middle_offset, UWORD right_offset);
+
+/** Label each vertex of the given eyebrow, for debugging. */
+void faceshapes_label_eyebrow(const eyebrow_t *eyebrow);
+
+/** Paint the given mouth expression into the current (cleared) paint buffer. */
+void faceshapes_paint_mouth(mouth_shape_t shape);
+
+/** Erase what faceshapes_paint_mouth() painted for MOUTH_SHAPE_LINE or MOUTH_SHAPE_OPEN. */
+void faceshapes_erase_mouth(mouth_shape_t shape);
+
+/**
+ * Paint a mouth from parameters into the current (cleared) paint buffer: each lip is a curve
+ * between the two corners, which the lower one sags below and the upper one rises above by
+ * half the opening. Out of range parameters are clamped.
+ */
+void faceshapes_paint_mouth_params(const mouth_params_t *params);
+
+/** The box faceshapes_paint_mouth_params() paints inside, for the given parameters. */
+void faceshapes_mouth_params_box(const mouth_params_t *params, gfx_box_t *box);
+
+/** Paint the given viseme into the current (cleared) paint buffer. */
+void faceshapes_paint_viseme(viseme_t viseme);
+
+/** Label the corners and center of the mouth, for debugging. */
+void faceshapes_label_mouth(void);
+
+#ifdef __cplusplus
+}
+#endif
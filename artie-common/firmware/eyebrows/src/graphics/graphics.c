@@ -1,4 +1,6 @@
 // Std lib includes
+#include <stddef.h>
+#include <stdint.h>
 // SDK includes
 // Library includes
 #include <errors.h>
@@ -6,6 +8,7 @@
 #include "../cmds/cmds.h"
 #include "../board/pinconfig.h"
 #include "../board/types.h"
+#include "graphics.h"
 #ifdef MOUTH
     #include "mouthgfx.h"
 #else
@@ -23,6 +26,26 @@ void graphics_init(side_t side)
 #endif // MOUTH
 }
 
+void graphics_resume(side_t side, cmd_t shown)
+{
+    log_info("Resume LCD\n");
+
+#if MOUTH
+    mouthgfx_resume(shown);
+#else
+    eyebrowsgfx_resume(side, shown);
+#endif // MOUTH
+}
+
+cmd_t graphics_expression(void)
+{
+#if MOUTH
+    return mouthgfx_expression();
+#else
+    return eyebrowsgfx_expression();
+#endif // MOUTH
+}
+
 void graphics_cmd(cmd_t command)
 {
 #if MOUTH
@@ -31,3 +54,61 @@ void graphics_cmd(cmd_t command)
     eyebrowsgfx_cmd(command);
 #endif // MOUTH
 }
+
+void graphics_frame_end(void)
+{
+#if MOUTH
+    mouthgfx_frame_end();
+#else
+    eyebrowsgfx_frame_end();
+#endif // MOUTH
+}
+
+bool graphics_blit(const struct gfx_blit *blit)
+{
+#if MOUTH
+    return mouthgfx_blit(blit);
+#else
+    return eyebrowsgfx_blit(blit);
+#endif // MOUTH
+}
+
+void graphics_set_idle_sleep(uint32_t ms)
+{
+    gfx_set_idle_sleep(ms);
+}
+
+bool graphics_idle_update(void)
+{
+    return gfx_idle_update();
+}
+
+bool graphics_assist(void)
+{
+    return gfx_band_assist();
+}
+
+/** Write value little-endian. */
+static uint8_t *pack_u32(uint8_t *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+    return out + 4;
+}
+
+size_t graphics_idle_pack(uint8_t *buf, size_t len)
+{
+    if (len < GRAPHICS_IDLE_PACKED_LEN)
+    {
+        return 0;
+    }
+
+    gfx_idle_stats_t stats;
+    gfx_idle_stats(&stats);
+    uint8_t *out = pack_u32(buf, stats.sleeps);
+    out = pack_u32(out, stats.last_wake_us);
+    pack_u32(out, stats.worst_wake_us);
+    return GRAPHICS_IDLE_PACKED_LEN;
+}
@@ -22,12 +22,84 @@ extern "C" {
 void graphics_init(side_t side);
 
 /**
- * @brief Handles the given LCD subsystem command.
+ * @brief Like graphics_init(), after a warm restart: the LCD kept its setup and picture,
+ * so it isn't reset or cleared, and what it was showing is drawn again straight away.
+ *
+ * @param side The side (left or right) that this MCU controls.
+ * @param shown What graphics_expression() was before the restart, or 0 for nothing.
+ */
+void graphics_resume(side_t side, cmd_t shown);
+
+/** The LCD command for what's showing, or 0 if the LCD is off or showing its test. */
+cmd_t graphics_expression(void);
+
+/**
+ * @brief Handles the given LCD subsystem command, or CMD_LCD_SET_THEME.
  *
  * @param command The command to handle.
  */
 void graphics_cmd(cmd_t command);
 
+/**
+ * @brief Call once a frame's commands have all been through graphics_cmd(). A command still waiting
+ * for the bytes that follow it (which come in the same frame) is dropped, so the next frame's first
+ * command isn't taken for one of them.
+ */
+void graphics_frame_end(void);
+
+#ifndef GFX_IDLE_SLEEP_MS
+    /**
+     * How long the LCD waits with nothing to draw before it sleeps (backlight, panel, and bus), in ms,
+     * unless SETTING_IDLE_SLEEP_MS says otherwise. 0 never sleeps.
+     */
+    #define GFX_IDLE_SLEEP_MS 60000
+#endif // GFX_IDLE_SLEEP_MS
+
+/**
+ * @brief Set how long the LCD waits with nothing to draw before it sleeps, in ms (0: never).
+ * Call before graphics_init() or graphics_resume().
+ */
+void graphics_set_idle_sleep(uint32_t ms);
+
+/**
+ * Size of what graphics_idle_pack() writes, all little-endian: how many times the LCD has slept
+ * (4 bytes), then how long it took from the command that woke it to that command's frame being
+ * out, the last time and the worst time (4 bytes each, in us).
+ */
+#define GRAPHICS_IDLE_PACKED_LEN 12
+
+/** Have the LCD's idle sleep figures changed since the last call? Call from the main loop. */
+bool graphics_idle_update(void);
+
+/**
+ * @brief Pack the LCD's idle sleep figures. See GRAPHICS_IDLE_PACKED_LEN for the layout.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least GRAPHICS_IDLE_PACKED_LEN, or nothing is written.
+ * @return size_t Number of bytes written.
+ */
+size_t graphics_idle_pack(uint8_t *buf, size_t len);
+
+/**
+ * @brief From the main loop: help the graphics core get a picture out, by sending a band it has painted
+ * (see gfx_band_assist() in commongfx.h). Call every time round, and don't sleep if it returns true.
+ *
+ * @return true if it did some of the graphics core's work.
+ */
+bool graphics_assist(void);
+
+/** A blit, from commongfx.h. Declared here so this header doesn't bring in the whole graphics stack. */
+struct gfx_blit;
+
+/**
+ * @brief Put a frame or pixels on the LCD (see gfx_blit_t in commongfx.h), in order with the LCD commands around it.
+ * Call from the main core.
+ *
+ * @param blit The blit. Copied, but its frame or pixels must be left alone until its done callback.
+ * @return false if it couldn't be queued.
+ */
+bool graphics_blit(const struct gfx_blit *blit);
+
 #ifdef __cplusplus
 }
 #endif
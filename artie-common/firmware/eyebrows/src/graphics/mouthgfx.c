@@ -1,280 +1,541 @@
 #ifdef MOUTH
 // Std lib includes
 #include <stdio.h>
+#include <string.h>
 // SDK includes
+#include "pico/multicore.h"
+#include "pico/time.h"
 // Library includes
 #include <errors.h>
+#include <intercore.h>
+#include <metrics.h>
+#include <trace.h>
+#include <LCD_2in.h>
+#include <GUI_Paint.h>
 // Local includes
 #include "commongfx.h"
-#include "lcd/LCD/LCD_2in.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include "faceframes.h"
+#include "faceshapes.h"
 #include "../board/types.h"
 
-/** The width of the mouth. */
-#define MOUTH_WIDTH 275
-
-/** The x position of the left corner of the mouth. */
-#define X_POS_LEFT_CORNER 20
-
-#define X_POS_RIGHT_CORNER (X_POS_LEFT_CORNER + MOUTH_WIDTH)
-
-/** The y position of the two corners of the mouth. */
-#define Y_POS_CORNERS 120
-
-/** The x position of the center of the mouth. */
-#define X_POS_CENTER (X_POS_LEFT_CORNER + (MOUTH_WIDTH / 2))
-
-/** Are we currently in a talking state? */
-static volatile bool talking = false;
-
-/** Repeating timer used by talking stuff. */
-static repeating_timer_t timer;
+#ifndef MOUTH_TALK_PERIOD_MS
+    /** How long the mouth holds each position while talking. */
+    #define MOUTH_TALK_PERIOD_MS 1000
+#endif // MOUTH_TALK_PERIOD_MS
+
+#ifndef MOUTH_VISEME_TICK_MS
+    /** Unit of the hold byte that follows each CMD_LCD_MOUTH_VISEME. */
+    #define MOUTH_VISEME_TICK_MS 10
+#endif // MOUTH_VISEME_TICK_MS
+
+#ifndef MOUTH_VISEME_LATENCY_MS
+    /**
+     * How far behind the first viseme of a stream we start playing it. Visemes that arrive
+     * up to this late are still shown on time, so the host should delay its audio by this much.
+     */
+    #define MOUTH_VISEME_LATENCY_MS 100
+#endif // MOUTH_VISEME_LATENCY_MS
+
+#ifndef MOUTH_MORPH_FRAMES
+    /** Number of frames the mouth morphs from one set of parameters to the next over. 1 snaps straight to the new one. */
+    #define MOUTH_MORPH_FRAMES 8
+#endif // MOUTH_MORPH_FRAMES
+
+/** Value of a CMD_LCD_MOUTH_PARAMS byte (with the module ID off) for a straight, level mouth. */
+#define MOUTH_PARAM_MIDDLE 32
+
+/** Largest value of a CMD_LCD_MOUTH_PARAMS byte (with the module ID off). */
+#define MOUTH_PARAM_MAX 0x3F
+
+/** Most bytes that follow a command: the three of CMD_LCD_MOUTH_PARAMS. */
+#define MOUTH_MAX_ARGS 3
+
+/** The scene element the parametric mouth is. */
+#define SCENE_ID_MOUTH 0
+
+/** Most visemes that can be waiting to be shown. Must be a power of two. */
+#define VISEME_BUFFER_LEN 32
+
+/** Smallish value for commands to be fed into the LCD command queue by the main core. A power of two. */
+#define INTER_CORE_QUEUE_SIZE 32
+
+/**
+ * Sent after posting a blit, to run it in its place among the commands (see mouthgfx_blit()). Not a command
+ * the controller has, and outside CMD_LCD_MOUTH_VISEME's range, so mouthgfx_cmd() can turn it away.
+ */
+#define CMD_LCD_BLIT ((cmd_t)(CMD_MODULE_ID_LCD | 0x2F))
+
+/** What goes through the inter-core queue. */
+typedef struct {
+    cmd_t command;
+    /**
+     * The bytes that followed the command, with the module ID off. For CMD_LCD_MOUTH_VISEME, how long
+     * to show it in MOUTH_VISEME_TICK_MS; for CMD_LCD_MOUTH_PARAMS, the curve, openness, and tilt.
+     */
+    uint8_t args[MOUTH_MAX_ARGS];
+} mouth_work_t;
+
+/** Work from the main core. It only sends, and the graphics core only receives. */
+static intercore_channel_t inter_core_queue;
+
+/** Where inter_core_queue keeps it. */
+static mouth_work_t inter_core_items[INTER_CORE_QUEUE_SIZE];
+
+/** A command still waiting for the bytes that follow it. Only touched by the main core. */
+static mouth_work_t collecting;
+static uint8_t args_taken = 0;      ///< Bytes of it here so far
+static uint8_t args_wanted = 0;     ///< Bytes it needs, or 0 if we aren't collecting one
+
+/** Start the graphics core with gfx_resume() instead of gfx_init(). */
+static bool resume_lcd = false;
+
+/** Main core only: the shape (or talking) command for what's on the LCD, or 0 if it's off or showing the test. Visemes leave it alone. */
+static cmd_t expression = 0;
+
+/** One viseme of a lip-sync stream. */
+typedef struct {
+    viseme_t viseme;
+    uint8_t hold_ticks;
+} viseme_entry_t;
+
+/**
+ * Jitter buffer for lip-sync. Each viseme starts when the one before it has been held for its time,
+ * so the schedule is fixed by when the stream started, not by when each viseme got here.
+ * Only touched by the graphics core.
+ */
+typedef struct {
+    viseme_entry_t entries[VISEME_BUFFER_LEN];
+    uint8_t head;                   ///< Next entry to show
+    uint8_t count;                  ///< Entries waiting to be shown
+    bool playing;                   ///< Is a stream in progress?
+    absolute_time_t next_start;     ///< When the entry at head is due
+    viseme_t shown;                 ///< What's on the LCD (NUM_VISEMES if it isn't a viseme)
+} viseme_player_t;
+
+static viseme_player_t visemes = {
+    .head = 0,
+    .count = 0,
+    .playing = false,
+    .shown = NUM_VISEMES,
+};
+
+/** The talking animation. Only touched by the graphics core. */
+typedef struct {
+    bool active;                    ///< Are we currently in a talking state?
+    bool mouth_open;                ///< Is the mouth currently drawn open?
+    absolute_time_t next_toggle;    ///< When to open or close the mouth next
+} talking_t;
+
+static talking_t talking = {
+    .active = false,
+    .mouth_open = false,
+};
+
+/** Moving from one parametric mouth to the next, over several frames. Only touched by the graphics core. */
+typedef struct {
+    bool running;               ///< Are there frames left to draw?
+    bool on_lcd;                ///< Is a parametric mouth (at shown) on the LCD? If not, there is nothing to morph from.
+    uint8_t frame;              ///< Frames drawn so far
+    mouth_params_t from;        ///< Where the morph started
+    mouth_params_t to;          ///< Where it ends up
+    mouth_params_t shown;       ///< What's on the LCD right now
+} mouth_morph_t;
+
+static mouth_morph_t morph = {
+    .running = false,
+    .on_lcd = false,
+};
+
+/** Parametric mouth to move to on the next frame, if params_pending. Several in one frame only move to the last. */
+static mouth_params_t pending_params;
+static bool params_pending = false;
+
+/** Means there is no expression waiting to be drawn. */
+#define NO_PENDING_SHAPE NUM_MOUTH_SHAPES
+
+/** Expression to draw on the next frame. Several commands in one frame only draw the last. */
+static mouth_shape_t pending_shape = NO_PENDING_SHAPE;
+
+/** Display list painter for a mouth shape. */
+static void paint_mouth(uintptr_t shape)
+{
+    faceshapes_paint_mouth((mouth_shape_t)shape);
+}
 
-static void draw_line_no_erase(void)
+/** Display list painter for a viseme. */
+static void paint_viseme(uintptr_t viseme)
 {
-    DRAW_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER, Y_POS_CORNERS);
-    log_debug("Paint line\n");
-    gfx_send_paint_buffer_to_lcd();
+    faceshapes_paint_viseme((viseme_t)viseme);
 }
 
-static void erase_line(void)
+/** Pack a parametric mouth into a painter arg, a byte each. They all fit once offset to be positive. */
+static uintptr_t pack_params(const mouth_params_t *params)
 {
-    ERASE_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER, Y_POS_CORNERS);
+    return (uintptr_t)(uint8_t)(params->curve + 128) |
+           ((uintptr_t)(uint8_t)params->open << 8) |
+           ((uintptr_t)(uint8_t)(params->tilt + 128) << 16);
 }
 
-static void draw_open_no_erase(void)
+/** Scene painter for a parametric mouth, packed by pack_params(). */
+static void paint_params(uintptr_t packed)
 {
-    // Draw a circle
-    DRAW_CIRCLE(X_POS_CENTER, Y_POS_CORNERS, MOUTH_WIDTH/4);
-    log_debug("Paint open\n");
-    gfx_send_paint_buffer_to_lcd();
+    const mouth_params_t params = {
+        .curve = (int16_t)(packed & 0xFF) - 128,
+        .open = (int16_t)((packed >> 8) & 0xFF),
+        .tilt = (int16_t)((packed >> 16) & 0xFF) - 128,
+    };
+    faceshapes_paint_mouth_params(&params);
 }
 
-static void erase_open(void)
+/** Display list painter for the test pattern. */
+static void paint_test(uintptr_t unused)
 {
-    ERASE_CIRCLE(X_POS_CENTER, Y_POS_CORNERS, MOUTH_WIDTH/4);
+    faceshapes_label_mouth();
 }
 
-static inline bool talking_cb(repeating_timer_t *rt)
+/** Replace whatever is on the LCD with the given expression. */
+static void draw_mouth(mouth_shape_t shape)
 {
-    if (!talking)
-    {
-        // Somehow we got called even though we should be turned off.
-        // Abort and cancel timer.
-        return false;
-    }
+    log_debug("Paint mouth shape %d\n", shape);
+
+    gfx_list_begin();
+#if GFX_PRERENDERED_FRAMES
+    // Recall the frame we rendered at build time if it suits this buffer
+    gfx_list_add_frame(&faceframes_mouth[shape], paint_mouth, shape);
+#else
+    gfx_list_add_painter(paint_mouth, shape);
+#endif // GFX_PRERENDERED_FRAMES
+    gfx_list_show();
+    morph.on_lcd = false;
+}
 
-    static bool mouth_open = false;
-    if (mouth_open)
-    {
-        // Draw mouth closed
-        mouth_open = false;
-        erase_open();
-        draw_line_no_erase();
-    }
-    else
+/** Open or close the mouth if it is time to. */
+static void step_talking(void)
+{
+    if (!time_reached(talking.next_toggle))
     {
-        // Draw mouth open
-        mouth_open = true;
-        erase_line();
-        draw_open_no_erase();
+        return;
     }
+    talking.next_toggle = delayed_by_ms(talking.next_toggle, MOUTH_TALK_PERIOD_MS);
 
-    return true;
+    talking.mouth_open = !talking.mouth_open;
+    draw_mouth(talking.mouth_open ? MOUTH_SHAPE_OPEN : MOUTH_SHAPE_LINE);
 }
 
 static void start_talking(void)
 {
-    Paint_Clear(WHITE);
-
-    // Fire off a timer that will trigger a periodic interrupt to refresh the LCD
-    const int32_t refresh_period_ms = 1000;
-    talking = true;
-    bool worked = add_repeating_timer_ms(refresh_period_ms, &talking_cb, NULL, &timer);
-    if (!worked)
-    {
-        set_errno(ERR_ID_GRAPHICS_MODULE, ENOMEM);
-        log_error("Could not initialize repeating timer for talking animation.\n");
-    }
+    // The first change comes one period from now
+    talking.active = true;
+    talking.mouth_open = false;
+    talking.next_toggle = make_timeout_time_ms(MOUTH_TALK_PERIOD_MS);
 }
 
 static void stop_talking(void)
 {
-    // Disable the talking timer/interrupt
-    if (talking)
-    {
-        talking = false;
-        bool worked = cancel_repeating_timer(&timer);
-        if (!worked)
-        {
-            set_errno(ERR_ID_GRAPHICS_MODULE, ENOENT);
-            log_error("Could not cancel the repeating timer for some reason.\n");
-        }
-        Paint_Clear(WHITE);
-    }
+    talking.active = false;
 }
 
-static void draw_mouth_smile(void)
+static void draw_test(void)
 {
     stop_talking();
-    Paint_Clear(WHITE);
-
-    // Bottom half of a circle
-    uint16_t radius = MOUTH_WIDTH / 2;
-    DRAW_CIRCLE(X_POS_CENTER, Y_POS_CORNERS - (radius / 4), radius);
-    ERASE_RECTANGLE(0, 0, X_POS_RIGHT_CORNER, Y_POS_CORNERS-1);
-    log_debug("Paint smile\n");
-    gfx_send_paint_buffer_to_lcd();
+    gfx_lcd_reset();
+
+    gfx_list_begin();
+    gfx_list_add_painter(paint_test, 0);
+    gfx_list_show();
+    morph.on_lcd = false;
 }
 
-static void draw_mouth_frown(void)
+/** Replace whatever is on the LCD with the given parametric mouth. Only the tiles the mouth left or entered are repainted. */
+static void draw_params(const mouth_params_t *params)
 {
-    stop_talking();
-    Paint_Clear(WHITE);
-
-    // Top half of a circle, translated down so the top is at Y_POS_CORNERS
-    uint16_t radius = MOUTH_WIDTH / 2;
-    DRAW_CIRCLE(X_POS_CENTER, Y_POS_CORNERS + (radius / 4), radius);
-    ERASE_RECTANGLE(X_POS_LEFT_CORNER, Y_POS_CORNERS + 1, gfx_lcd_width(), gfx_lcd_height());
-    log_debug("Paint frown\n");
-    gfx_send_paint_buffer_to_lcd();
+    gfx_box_t box;
+    faceshapes_mouth_params_box(params, &box);
+    gfx_scene_set(SCENE_ID_MOUTH, paint_params, pack_params(params), &box);
+    gfx_scene_show();
+    morph.shown = *params;
+    morph.on_lcd = true;
 }
 
-static void draw_mouth_line(void)
+/** Start morphing from whatever is on the LCD to the given parametric mouth. Snaps to it if there is nothing to morph from. */
+static void start_morph(const mouth_params_t *params)
 {
-    stop_talking();
-    Paint_Clear(WHITE);
-    draw_line_no_erase();
+    if (!morph.on_lcd || (MOUTH_MORPH_FRAMES <= 1))
+    {
+        draw_params(params);
+        morph.running = false;
+        return;
+    }
+
+    // Start from where we are, even if that is part way through another morph
+    morph.from = morph.shown;
+    morph.to = *params;
+    morph.frame = 0;
+    morph.running = true;
 }
 
-static void draw_mouth_smirk(void)
+/** Draw the next frame of the morph in progress. */
+static void step_morph(void)
 {
-    const UWORD rad = MOUTH_WIDTH / 6;
+    morph.frame++;
+    if (morph.frame >= MOUTH_MORPH_FRAMES)
+    {
+        draw_params(&morph.to);
+        morph.running = false;
+        return;
+    }
 
-    stop_talking();
-    Paint_Clear(WHITE);
+    // Ease in and out: smoothstep (3u^2 - 2u^3) of the fraction of frames done, in Q8
+    const int32_t u = ((int32_t)morph.frame << 8) / MOUTH_MORPH_FRAMES;
+    const int32_t eased = (u * u * ((3 << 8) - 2 * u)) >> 16;
+    const mouth_params_t params = {
+        .curve = (int16_t)(morph.from.curve + (((morph.to.curve - morph.from.curve) * eased) >> 8)),
+        .open = (int16_t)(morph.from.open + (((morph.to.open - morph.from.open) * eased) >> 8)),
+        .tilt = (int16_t)(morph.from.tilt + (((morph.to.tilt - morph.from.tilt) * eased) >> 8)),
+    };
+    if (memcmp(&params, &morph.shown, sizeof(params)) != 0)
+    {
+        draw_params(&params);
+    }
+}
 
-    // Draw a line
-    DRAW_SOLID_LINE(X_POS_LEFT_CORNER, Y_POS_CORNERS, X_POS_RIGHT_CORNER - rad, Y_POS_CORNERS);
+/** Drop the morph in progress, and any waiting to start. Leaves whatever is on the LCD. */
+static void stop_morph(void)
+{
+    morph.running = false;
+    params_pending = false;
+}
 
-    // Draw a small curve at the end of the line
-    DRAW_CIRCLE(X_POS_RIGHT_CORNER - rad, Y_POS_CORNERS - rad, rad);
-    ERASE_RECTANGLE(0, 0, gfx_lcd_width(), Y_POS_CORNERS - rad);
-    ERASE_RECTANGLE(X_POS_RIGHT_CORNER - (2 * rad), Y_POS_CORNERS - (2 * rad), X_POS_RIGHT_CORNER - rad, Y_POS_CORNERS - (LINE_WIDTH + 1));
-    log_debug("Paint smirk\n");
-    gfx_send_paint_buffer_to_lcd();
+/** The parametric mouth a CMD_LCD_MOUTH_PARAMS asks for, from the bytes that followed it. */
+static mouth_params_t params_from_args(const uint8_t *args)
+{
+    const mouth_params_t params = {
+        .curve = (int16_t)((((int32_t)args[0] - MOUTH_PARAM_MIDDLE) * MOUTH_MAX_CURVE) / MOUTH_PARAM_MIDDLE),
+        .open = (int16_t)(((int32_t)args[1] * MOUTH_MAX_OPEN) / MOUTH_PARAM_MAX),
+        .tilt = (int16_t)((((int32_t)args[2] - MOUTH_PARAM_MIDDLE) * MOUTH_MAX_TILT) / MOUTH_PARAM_MIDDLE),
+    };
+    return params;
 }
 
-static void draw_mouth_zigzag(void)
+/** Show the given viseme, unless it's already up. */
+static void draw_viseme(viseme_t viseme)
 {
-    stop_talking();
-    Paint_Clear(WHITE);
-
-    // Draw a bunch of lines, each of which starts at the end of the line previous
-    uint8_t nzigs = 5;
-    UWORD start_x = X_POS_LEFT_CORNER;
-    UWORD start_y = Y_POS_CORNERS;
-    const UWORD bottom_y = start_y - 25;
-    UWORD end_x = start_x + (MOUTH_WIDTH / nzigs);
-    UWORD end_y = bottom_y;
-    bool down = true;
-    for (uint8_t i = 0; i < nzigs; i++)
-    {
-        DRAW_SOLID_LINE(start_x, start_y, end_x, end_y);
-        down = !down;
-        start_x = end_x;
-        start_y = end_y;
-        end_x += (MOUTH_WIDTH / nzigs);
-        end_y = down ? bottom_y : Y_POS_CORNERS;
-    }
-    gfx_send_paint_buffer_to_lcd();
+    if (viseme == visemes.shown)
+    {
+        return;
+    }
+    visemes.shown = viseme;
+
+    gfx_list_begin();
+#if GFX_PRERENDERED_FRAMES
+    gfx_list_add_frame(&faceframes_visemes[viseme], paint_viseme, viseme);
+#else
+    gfx_list_add_painter(paint_viseme, viseme);
+#endif // GFX_PRERENDERED_FRAMES
+    gfx_list_show();
+    morph.on_lcd = false;
 }
 
-static void draw_mouth_open(void)
+/** Drop the lip-sync stream. Leaves whatever is on the LCD. */
+static void stop_visemes(void)
 {
-    stop_talking();
-    Paint_Clear(WHITE);
-    draw_open_no_erase();
+    visemes.playing = false;
+    visemes.count = 0;
+    visemes.shown = NUM_VISEMES;
 }
 
-static void draw_mouth_open_smile(void)
+/** Add a viseme to the stream, starting a new one if none is playing. */
+static void queue_viseme(viseme_t viseme, uint8_t hold_ticks)
 {
-    stop_talking();
-    Paint_Clear(WHITE);
-
-    // Draw bottom half of a circle
-    uint16_t up = 10;
-    uint16_t radius = MOUTH_WIDTH / 2;
-    DRAW_CIRCLE(X_POS_CENTER, Y_POS_CORNERS - (radius / 4), radius);
-    ERASE_RECTANGLE(0, 0, X_POS_RIGHT_CORNER, (Y_POS_CORNERS-1) - up);
-
-    // Draw top line
-    DRAW_SOLID_LINE(X_POS_LEFT_CORNER + 1, Y_POS_CORNERS - up, X_POS_RIGHT_CORNER - 1, Y_POS_CORNERS - up);
-    log_debug("Paint open smile\n");
-    gfx_send_paint_buffer_to_lcd();
+    if (viseme >= NUM_VISEMES)
+    {
+        log_error("Illegal viseme %u\n", viseme);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+
+    if (visemes.count == VISEME_BUFFER_LEN)
+    {
+        log_error("Viseme buffer is full; dropping viseme.\n");
+        set_errno(ERR_ID_GRAPHICS_MODULE, ENOMEM);
+        metrics_count(METRICS_COUNT_DROPS, 1);
+        return;
+    }
+
+    if (!visemes.playing)
+    {
+        // Give the rest of the stream time to catch up before we start
+        visemes.playing = true;
+        visemes.next_start = make_timeout_time_ms(MOUTH_VISEME_LATENCY_MS);
+    }
+
+    const uint8_t tail = (visemes.head + visemes.count) & (VISEME_BUFFER_LEN - 1);
+    visemes.entries[tail].viseme = viseme;
+    visemes.entries[tail].hold_ticks = hold_ticks;
+    visemes.count++;
 }
 
-static void draw_test(void)
+/** Show whichever viseme is due now. */
+static void step_visemes(void)
 {
-    stop_talking();
-    gfx_lcd_reset();
+    const absolute_time_t now = get_absolute_time();
+    if (absolute_time_diff_us(visemes.next_start, now) < 0)
+    {
+        return;
+    }
+
+    // Skip anything that arrived too late to be seen, so we stay in step with the audio
+    bool due = false;
+    viseme_t viseme = VISEME_REST;
+    while (visemes.count > 0)
+    {
+        const viseme_entry_t *entry = &visemes.entries[visemes.head];
+        const absolute_time_t end = delayed_by_ms(visemes.next_start, (uint32_t)entry->hold_ticks * MOUTH_VISEME_TICK_MS);
+        visemes.head = (visemes.head + 1) & (VISEME_BUFFER_LEN - 1);
+        visemes.count--;
+        visemes.next_start = end;
+        viseme = entry->viseme;
+        due = true;
+        if (absolute_time_diff_us(now, end) > 0)
+        {
+            break;
+        }
+    }
+
+    if (due)
+    {
+        draw_viseme(viseme);
+        return;
+    }
 
-    // Label left corner of the mouth
-    Paint_DrawPoint(X_POS_LEFT_CORNER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
-    DRAW_TEXT(X_POS_LEFT_CORNER, Y_POS_CORNERS, "L");
+    // Ran dry. Hold the last shape in case the rest of the stream is only late; if it's really over, rest.
+    if (absolute_time_diff_us(delayed_by_ms(visemes.next_start, MOUTH_VISEME_LATENCY_MS), now) >= 0)
+    {
+        draw_viseme(VISEME_REST);
+        stop_visemes();
+    }
+}
 
-    // Label right corner of the mouth
-    Paint_DrawPoint(X_POS_RIGHT_CORNER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
-    DRAW_TEXT(X_POS_RIGHT_CORNER, Y_POS_CORNERS, "R");
+/** Draw this frame of whatever is going on. */
+static void render_frame(void)
+{
+    if (pending_shape != NO_PENDING_SHAPE)
+    {
+        draw_mouth(pending_shape);
+        pending_shape = NO_PENDING_SHAPE;
+    }
 
-    // Label the center of the mouth
-    Paint_DrawPoint(X_POS_CENTER, Y_POS_CORNERS, BLACK, LINE_WIDTH, DOT_FILL_RIGHTUP);
-    DRAW_TEXT(X_POS_CENTER, Y_POS_CORNERS, "C");
+    if (params_pending)
+    {
+        start_morph(&pending_params);
+        params_pending = false;
+    }
+    else if (morph.running)
+    {
+        step_morph();
+    }
 
-    // Send buffer to LCD
-    gfx_send_paint_buffer_to_lcd();
+    if (talking.active)
+    {
+        step_talking();
+    }
+
+    if (visemes.playing)
+    {
+        step_visemes();
+    }
 }
 
-void mouthgfx_init(void)
+/** Ask for the given expression on the next frame. */
+static void request_mouth(mouth_shape_t shape)
 {
-    gfx_init(LCD_SIZE_MOUTH);
+    stop_talking();
+    stop_visemes();
+    stop_morph();
+    pending_shape = shape;
 }
 
-void mouthgfx_cmd(cmd_t command)
+/** Act on a command from the other core. Expressions are left to render_frame(). */
+static void handle_command(const mouth_work_t *work)
 {
+    const cmd_t command = work->command;
+    if ((command & CMD_LCD_MOUTH_VISEME_MASK) == CMD_LCD_MOUTH_VISEME)
+    {
+        stop_talking();
+        stop_morph();
+        pending_shape = NO_PENDING_SHAPE;
+        queue_viseme((viseme_t)(command & ~CMD_LCD_MOUTH_VISEME_MASK), work->args[0]);
+        return;
+    }
+
+    if (command == CMD_LCD_BLIT)
+    {
+        pending_shape = NO_PENDING_SHAPE;
+        stop_talking();
+        stop_visemes();
+        stop_morph();
+        gfx_blit_run();
+        morph.on_lcd = false;
+        return;
+    }
+
+    if ((command & CMD_LCD_SET_THEME_MASK) == CMD_LCD_SET_THEME)
+    {
+        // Whatever is showing (or on its way) carries on, in the new colours
+        gfx_set_theme((gfx_theme_t)(command & ~CMD_LCD_SET_THEME_MASK));
+        return;
+    }
+
     switch (command)
     {
         case CMD_LCD_TEST:
+            pending_shape = NO_PENDING_SHAPE;
+            stop_visemes();
+            stop_morph();
             draw_test();
             break;
         case CMD_LCD_OFF:
+            pending_shape = NO_PENDING_SHAPE;
             stop_talking();
+            stop_visemes();
+            stop_morph();
             gfx_lcd_reset();
+            morph.on_lcd = false;
             break;
         case CMD_LCD_MOUTH_SMILE:
-            draw_mouth_smile();
+            request_mouth(MOUTH_SHAPE_SMILE);
             break;
         case CMD_LCD_MOUTH_FROWN:
-            draw_mouth_frown();
+            request_mouth(MOUTH_SHAPE_FROWN);
             break;
         case CMD_LCD_MOUTH_LINE:
-            draw_mouth_line();
+            request_mouth(MOUTH_SHAPE_LINE);
             break;
         case CMD_LCD_MOUTH_SMIRK:
-            draw_mouth_smirk();
+            request_mouth(MOUTH_SHAPE_SMIRK);
             break;
         case CMD_LCD_MOUTH_OPEN:
-            draw_mouth_open();
+            request_mouth(MOUTH_SHAPE_OPEN);
             break;
         case CMD_LCD_MOUTH_OPEN_SMILE:
-            draw_mouth_open_smile();
+            request_mouth(MOUTH_SHAPE_OPEN_SMILE);
             break;
         case CMD_LCD_MOUTH_ZIG_ZAG:
-            draw_mouth_zigzag();
+            request_mouth(MOUTH_SHAPE_ZIG_ZAG);
             break;
         case CMD_LCD_MOUTH_TALK:
+            pending_shape = NO_PENDING_SHAPE;
+            stop_visemes();
+            stop_morph();
             start_talking();
             break;
+        case CMD_LCD_MOUTH_PARAMS:
+            pending_shape = NO_PENDING_SHAPE;
+            stop_talking();
+            stop_visemes();
+            pending_params = params_from_args(work->args);
+            params_pending = true;
+            break;
         default:
             log_error("Illegal cmd type 0x%02X\n in graphics subsystem\n", command);
             set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
@@ -282,4 +543,189 @@ void mouthgfx_cmd(cmd_t command)
     }
 }
 
+/** Is a command waiting to go into a newer frame than the one going out? */
+static bool command_waiting(void)
+{
+    return intercore_count(&inter_core_queue) > 0;
+}
+
+static void core_task(void)
+{
+    // The settings store pauses us (in RAM) while it writes to flash
+    multicore_lockout_victim_init();
+
+    if (resume_lcd)
+    {
+        gfx_resume(LCD_SIZE_MOUTH);
+    }
+    else
+    {
+        gfx_init(LCD_SIZE_MOUTH);
+    }
+    // A command that comes in while a frame is going out cuts it short
+    gfx_set_superseded_check(command_waiting);
+
+    while (true)
+    {
+        mouth_work_t work;
+        if (!talking.active && !visemes.playing && !morph.running && !params_pending && (pending_shape == NO_PENDING_SHAPE))
+        {
+            // Nothing to draw: sleep until a command comes in (the LCD too, if it's a while), then draw it straight away
+            gfx_idle_receive(&inter_core_queue, &work);
+            handle_command(&work);
+            gfx_frame_clock_start();
+        }
+
+        if (gfx_flush_stopped())
+        {
+            // The last frame was cut short for what's waiting, so show it now
+            gfx_frame_clock_start();
+        }
+        gfx_wait_for_frame();
+
+        // Everything that came in during the last frame goes into this one
+        while (intercore_try_receive(&inter_core_queue, &work))
+        {
+            handle_command(&work);
+        }
+        TRACE_BEGIN(TRACE_ID_RENDER_FRAME, 0);
+        TRACE_PROBE(TRACE_PROBE_RENDER_START);
+        const uint32_t frame_start = time_us_32();
+        render_frame();
+        // In case what cut the last frame short didn't draw anything after all
+        gfx_flush_rest();
+        TRACE_END(TRACE_ID_RENDER_FRAME, 0);
+#if TRACE_PROBES_ENABLED
+        // The frame is on the glass once its last transfer is out. Waiting for it here costs
+        // the next frame its head start, so only probe builds do.
+        gfx_wait_for_lcd();
+        TRACE_PROBE(TRACE_PROBE_FLUSH_END);
+#endif // TRACE_PROBES_ENABLED
+        metrics_count(METRICS_COUNT_FRAMES, 1);
+        gfx_overlay_frame(time_us_32() - frame_start);
+    }
+}
+
+/** Queue work for the graphics core, and show metrics how full that leaves its queue. Returns false (a drop) if it's full. */
+static bool send_work(const mouth_work_t *work)
+{
+    if (!intercore_try_send(&inter_core_queue, work))
+    {
+        metrics_count(METRICS_COUNT_DROPS, 1);
+        return false;
+    }
+    metrics_level(METRICS_LEVEL_GFX_QUEUE, intercore_count(&inter_core_queue));
+    return true;
+}
+
+void mouthgfx_init(void)
+{
+    // Before the graphics core can wait on it
+    intercore_channel_init(&inter_core_queue, inter_core_items, sizeof(mouth_work_t), INTER_CORE_QUEUE_SIZE);
+    gfx_blit_init();
+
+    // Start up the task for the other core
+    multicore_launch_core1(core_task);
+}
+
+void mouthgfx_cmd(cmd_t command)
+{
+    // This function is called from the main thread's core.
+    // A viseme or parametric mouth is only complete once the bytes after it (the next LCD commands) are here.
+    if (args_wanted > 0)
+    {
+        collecting.args[args_taken++] = (uint8_t)(command & ~CMD_MODULE_ID_LCD);
+        if (args_taken < args_wanted)
+        {
+            return;
+        }
+        args_wanted = 0;
+        if (collecting.command == CMD_LCD_MOUTH_PARAMS)
+        {
+            // Not redrawn after a warm restart, but it stays up on the LCD
+            expression = 0;
+        }
+        if (!send_work(&collecting))
+        {
+            log_error("LCD: Could not add command 0x%02X to work queue. Queue is full.\n", collecting.command);
+        }
+        return;
+    }
+
+    if (((command & CMD_LCD_MOUTH_VISEME_MASK) == CMD_LCD_MOUTH_VISEME) || (command == CMD_LCD_MOUTH_PARAMS))
+    {
+        collecting = (mouth_work_t){.command = command};
+        args_taken = 0;
+        args_wanted = (command == CMD_LCD_MOUTH_PARAMS) ? 3 : 1;
+        return;
+    }
+
+    if (command == CMD_LCD_BLIT)
+    {
+        log_error("Illegal cmd type 0x%02X\n in graphics subsystem\n", command);
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        return;
+    }
+
+    if ((command == CMD_LCD_OFF) || (command == CMD_LCD_TEST))
+    {
+        expression = 0;
+    }
+    else if ((command >= CMD_LCD_MOUTH_SMILE) && (command <= CMD_LCD_MOUTH_TALK))
+    {
+        expression = command;
+    }
+
+    // Submit the work item to the other core for processing and return.
+    mouth_work_t work = {.command = command};
+    if (!send_work(&work))
+    {
+        log_error("LCD: Could not add command to work queue. Queue is full.\n");
+    }
+}
+
+void mouthgfx_frame_end(void)
+{
+    // This function is called from the main thread's core, like mouthgfx_cmd().
+    if (args_wanted > 0)
+    {
+        log_error("LCD: Command 0x%02X is missing %u of its bytes\n", collecting.command, (uint)(args_wanted - args_taken));
+        set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+        args_wanted = 0;
+    }
+}
+
+bool mouthgfx_blit(const gfx_blit_t *blit)
+{
+    // We're the only sender on both queues, so if there's room in each now, there still is once we've sent
+    if ((intercore_count(&inter_core_queue) == INTER_CORE_QUEUE_SIZE) || !gfx_blit_post(blit))
+    {
+        log_error("LCD: Could not add blit to work queue. Queue is full.\n");
+        return false;
+    }
+
+    // Nothing to draw again after a warm restart
+    expression = 0;
+    const mouth_work_t work = {.command = CMD_LCD_BLIT};
+    send_work(&work);
+    return true;
+}
+
+void mouthgfx_resume(cmd_t shown)
+{
+    resume_lcd = true;
+    mouthgfx_init();
+
+    // Draw it again straight away, so everything else picks up from it
+    if (shown != 0)
+    {
+        mouthgfx_cmd(shown);
+    }
+}
+
+cmd_t mouthgfx_expression(void)
+{
+    return expression;
+}
+
 #endif // MOUTH
@@ -12,19 +12,60 @@ extern "C" {
 #ifdef MOUTH
 
 #include "../board/types.h"
+#include "commongfx.h"
 
 /**
  * @brief Initialize graphics (and LCD) libraries.
  */
 void mouthgfx_init(void);
 
+/**
+ * @brief Like mouthgfx_init(), after a warm restart: the LCD is still set up, so it isn't reset or
+ * cleared, and the mouth it was showing is drawn again straight away.
+ *
+ * @param shown What mouthgfx_expression() was before the restart.
+ */
+void mouthgfx_resume(cmd_t shown);
+
+/** The command for the mouth shape on the LCD (or about to be), or 0 if the LCD is off, showing its test, or a parametric mouth. */
+cmd_t mouthgfx_expression(void);
+
 /**
  * @brief Handles the given LCD subsystem command.
  *
  * @param command The command to handle.
+ *
+ * Besides the fixed expressions, the mouth can lip-sync: each CMD_LCD_MOUTH_VISEME
+ * (with a viseme_t in its four LSbs) must be followed by a hold byte,
+ * CMD_MODULE_ID_LCD | n, meaning show it for n * MOUTH_VISEME_TICK_MS, after which the next
+ * viseme starts. Send both bytes in the same frame. The first viseme of a stream is shown
+ * MOUTH_VISEME_LATENCY_MS after it arrives, so that visemes sent a little late still show on time;
+ * the mouth rests once the stream has run dry for that long. Any other LCD command ends the stream.
+ *
+ * It can also take any expression in between: CMD_LCD_MOUTH_PARAMS must be followed by three bytes,
+ * each CMD_MODULE_ID_LCD | n: the curve (32 is straight, 0 the deepest frown, 63 the widest smile),
+ * the openness (0 closed to 63 wide open), and the tilt (32 is level, below lifts the left corner,
+ * above the right). Send all four in the same frame. The mouth morphs to it over MOUTH_MORPH_FRAMES
+ * frames from the one it was showing, or snaps to it if that was a fixed expression. It is not drawn
+ * again after a warm restart, so mouthgfx_expression() is 0 while it's shown.
  */
 void mouthgfx_cmd(cmd_t command);
 
+/**
+ * @brief The frame mouthgfx_cmd() was given has ended. A viseme or CMD_LCD_MOUTH_PARAMS still
+ * missing some of its bytes is dropped, and sets errno.
+ */
+void mouthgfx_frame_end(void);
+
+/**
+ * @brief Have the graphics core run a blit (see gfx_blit_t), in order with the commands around it.
+ * It ends any talking, lip-sync, or morph, and the next expression is drawn afresh.
+ *
+ * @param blit The blit. Copied, but its frame or pixels must be left alone until its done callback.
+ * @return false if the work queue is full.
+ */
+bool mouthgfx_blit(const gfx_blit_t *blit);
+
 #endif
 
 #ifdef __cplusplus
@@ -4,16 +4,36 @@
 // SDK includes
 #include "pico/stdlib.h"
 // Library includes
+#include <arena.h>
+#include <bist.h>
 #include <errors.h>
 #include <leds.h>
+#include <metrics.h>
+#include <settings.h>
+#include <stackmon.h>
+#include <sysclock.h>
+#include <trace.h>
+#if CMDS_USE_CAN
+    #include <msgpack.h>
+    #include <psacp.h>
+    #include <rpcacp.h>
+#endif // CMDS_USE_CAN
 // Local includes
 #include "cmds/cmds.h"
 #include "graphics/graphics.h"
 #include "board/pinconfig.h"
 #include "board/types.h"
+#include "board/warmboot.h"
+#include "sequence/sequence.h"
 #ifndef MOUTH
     #include "servo/servo.h"
 #endif // MOUTH
+#if USB_FRAMES
+    #include "usb/usbframes.h"
+#endif // USB_FRAMES
+#if CAN_FRAMES
+    #include "can/canframes.h"
+#endif // CAN_FRAMES
 
 #ifdef MOUTH
 /** I2C address if we are the mouth. */
@@ -68,93 +88,568 @@ static inline uint determine_address(side_t side)
 #endif // MOUTH
 }
 
+/** Anything no subsystem claims. */
+static void unknown_cmd(uint8_t command)
+{
+    log_error("Illegal cmd type 0x%02X\n", command);
+}
+
+static void led_on_cmd(uint8_t command)
+{
+    leds_on();
+}
+
+static void led_off_cmd(uint8_t command)
+{
+    leds_off();
+}
+
+static void led_heartbeat_cmd(uint8_t command)
+{
+    leds_heartbeat();
+}
+
+static void sequence_play_cmd(uint8_t command)
+{
+    sequence_play(command & ~CMD_SEQUENCE_MASK);
+}
+
+static void sequence_stop_cmd(uint8_t command)
+{
+    sequence_stop();
+}
+
+static void restart_cmd(uint8_t command)
+{
+    log_info("Restarting\n");
+    warmboot_restart();
+}
+
+static void query_trace_cmd(uint8_t command)
+{
+    uint8_t events[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(events, trace_pack(events, sizeof(events)));
+}
+
+static void dump_trace_cmd(uint8_t command)
+{
+    trace_dump();
+}
+
+static void query_errors_cmd(uint8_t command)
+{
+    uint8_t errors[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(errors, errors_pack(errors, sizeof(errors)));
+}
+
+static void query_log_cmd(uint8_t command)
+{
+    uint8_t messages[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(messages, log_pack(messages, sizeof(messages)));
+}
+
+static void query_memory_cmd(uint8_t command)
+{
+    uint8_t usage[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(usage, arena_pack(usage, sizeof(usage)));
+}
+
+static void query_stacks_cmd(uint8_t command)
+{
+    uint8_t usage[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(usage, stackmon_pack(usage, sizeof(usage)));
+}
+
+/** The theme is on the LED route, but graphics handles it. It doesn't change the expression. */
+static void theme_cmd(uint8_t command)
+{
+    graphics_cmd((cmd_t)command);
+}
+
+static void lcd_cmd(uint8_t command)
+{
+    TRACE_BEGIN(TRACE_ID_GRAPHICS_CMD, command);
+    graphics_cmd((cmd_t)command);
+    warmboot_set(WARMBOOT_SLOT_EXPRESSION, graphics_expression());
+    TRACE_END(TRACE_ID_GRAPHICS_CMD, command);
+}
+
+#ifndef MOUTH
+/** Send this before a turn command to set how long the turn takes. */
+static void servo_duration_cmd(uint8_t command)
+{
+    servo_set_move_duration(command & ~CMD_SERVO_SET_DURATION_MASK);
+}
+
+static void servo_status_cmd(uint8_t command)
+{
+    servo_report_status();
+}
+
+static void servo_route_cmd(uint8_t command)
+{
+    TRACE_BEGIN(TRACE_ID_SERVO_CMD, command);
+    servo_cmd((cmd_t)command);
+    TRACE_END(TRACE_ID_SERVO_CMD, command);
+}
+#endif // MOUTH
+
+/** The lanes commands are dispatched in, most urgent first. */
+typedef enum {
+    LANE_SERVO,     // Anything that moves the servo or reports on it
+    LANE_LED,       // Everything else on the LED route, which shares it with sequences, tracing, and errors
+    LANE_LCD,       // Only queued for the graphics core here, but the least urgent
+    LANE_COUNT
+} lane_t;
+
+/** What to do with a command byte, and which lane it goes in. The lane isn't always its route: some servo commands live on the LED route. */
+typedef struct {
+    cmds_handler_t handler;
+    uint8_t lane;   ///< lane_t
+} command_entry_t;
+
+/**
+ * Every command byte's handler and lane, so dispatching one is a lookup instead of a route switch
+ * and then a switch per subsystem. Later entries override the wider ranges before them.
+ * Sequence uploads and settings are only valid at the start of a frame (see dispatch_frame()),
+ * so on their own they are unknown here.
+ */
+CMDS_TABLE_BEGIN
+static const command_entry_t COMMANDS[CMDS_TABLE_LEN] = {
+    [CMDS_MATCHING(0x00, 0x00)]                                             = { unknown_cmd,        LANE_LED },
+    [CMD_LED_ON]                                                            = { led_on_cmd,         LANE_LED },
+    [CMD_LED_OFF]                                                           = { led_off_cmd,        LANE_LED },
+    [CMD_LED_HEARTBEAT]                                                     = { led_heartbeat_cmd,  LANE_LED },
+    [CMD_SEQUENCE_STOP]                                                     = { sequence_stop_cmd,  LANE_LED },
+    [CMDS_MATCHING(CMD_SEQUENCE_PLAY, CMD_SEQUENCE_MASK)]                   = { sequence_play_cmd,  LANE_LED },
+    [CMD_RESTART]                                                           = { restart_cmd,        LANE_LED },
+    [CMD_QUERY_TRACE]                                                       = { query_trace_cmd,    LANE_LED },
+    [CMD_DUMP_TRACE]                                                        = { dump_trace_cmd,     LANE_LED },
+    [CMD_QUERY_ERRORS]                                                      = { query_errors_cmd,   LANE_LED },
+    [CMD_QUERY_LOG]                                                         = { query_log_cmd,      LANE_LED },
+    [CMD_QUERY_MEMORY]                                                      = { query_memory_cmd,   LANE_LED },
+    [CMD_QUERY_STACKS]                                                      = { query_stacks_cmd,   LANE_LED },
+    [CMDS_MATCHING(CMD_LCD_SET_THEME, CMD_LCD_SET_THEME_MASK)]              = { theme_cmd,          LANE_LCD },
+    [CMDS_MATCHING(CMD_MODULE_ID_LCD, 0xC0)]                                = { lcd_cmd,            LANE_LCD },
+#ifndef MOUTH
+    [CMDS_MATCHING(CMD_SERVO_SET_DURATION, CMD_SERVO_SET_DURATION_MASK)]    = { servo_duration_cmd, LANE_SERVO },
+    [CMD_QUERY_SERVO_STATUS]                                                = { servo_status_cmd,   LANE_SERVO },
+    [CMDS_MATCHING(CMD_MODULE_ID_SERVO, 0xC0)]                              = { servo_route_cmd,    LANE_SERVO },
+#endif // MOUTH
+};
+CMDS_TABLE_END
+
 /**
- * @brief Command table for the LED subsystem.
+ * @brief Act on some commands that arrived together: servo commands first, then LED, then LCD.
+ * Each lane's commands keep their order, so a duration still comes before the turn it sets,
+ * and a viseme before its hold byte.
  *
- * @param command
+ * @param commands The commands.
+ * @param ncommands How many.
  */
-static void leds_cmd(cmd_t command)
+static void dispatch_cmds(const uint8_t *commands, size_t ncommands)
 {
-    switch (command)
+    metrics_count(METRICS_COUNT_COMMANDS, ncommands);
+    for (lane_t lane = 0; lane < LANE_COUNT; lane++)
     {
-        case CMD_LED_ON:
-            leds_on();
-            break;
-        case CMD_LED_OFF:
-            leds_off();
-            break;
-        case CMD_LED_HEARTBEAT:
-            leds_heartbeat();
-            break;
+        for (size_t i = 0; i < ncommands; i++)
+        {
+            const command_entry_t *entry = &COMMANDS[commands[i]];
+            if (entry->lane != lane)
+            {
+                continue;
+            }
+            TRACE_BEGIN(TRACE_ID_CMD_DISPATCH, commands[i]);
+            TRACE_PROBE(TRACE_PROBE_CMD_DISPATCH);
+            entry->handler(commands[i]);
+            TRACE_END(TRACE_ID_CMD_DISPATCH, commands[i]);
+        }
+    }
+    // Whatever the LCD was still waiting for had to come with these
+    graphics_frame_end();
+}
+
+/** Load the read register with a setting: whether it's set (1 byte), then its value (4 bytes, little-endian). */
+static void report_setting(uint16_t key)
+{
+    uint32_t value = 0;
+    const bool set = settings_get(key, &value);
+    const uint8_t report[5] = {
+        (uint8_t)set,
+        (uint8_t)(value & 0xFF), (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24),
+    };
+    cmds_set_register_bytes(report, sizeof(report));
+}
+
+/**
+ * @brief Act on a setting command frame (CMD_SETTING_GET or CMD_SETTING_SET) from the controller.
+ *
+ * @param commands The frame, starting with the command.
+ * @param ncommands How many bytes.
+ */
+static void setting_cmd(const uint8_t *commands, size_t ncommands)
+{
+    const size_t expected = (commands[0] == CMD_SETTING_SET) ? 7 : 3;
+    if (ncommands != expected)
+    {
+        log_error("Setting command 0x%02X takes %u bytes, not %u\n", commands[0], (uint)expected, (uint)ncommands);
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    const uint16_t key = (uint16_t)(commands[1] | (commands[2] << 8));
+    if (commands[0] == CMD_SETTING_GET)
+    {
+        report_setting(key);
+        return;
+    }
+    const uint32_t value = (uint32_t)commands[3] | ((uint32_t)commands[4] << 8) | ((uint32_t)commands[5] << 16) | ((uint32_t)commands[6] << 24);
+    settings_set(key, value);
+}
+
+/** Our command bus rate: SETTING_I2C_BAUDRATE if it's one the bus can run at, otherwise CMDS_I2C_BAUDRATE. */
+static cmds_i2c_speed_t command_bus_speed(void)
+{
+    const uint32_t speed = settings_get_or(SETTING_I2C_BAUDRATE, CMDS_I2C_BAUDRATE);
+    switch (speed)
+    {
+        case CMDS_I2C_SPEED_STANDARD:
+        case CMDS_I2C_SPEED_FAST:
+        case CMDS_I2C_SPEED_FAST_PLUS:
+            return (cmds_i2c_speed_t)speed;
         default:
-            log_error("Illegal cmd type 0x%02X\n in LED subsystem", command);
-            break;
+            log_error("Ignoring I2C rate setting of %lu Hz\n", (unsigned long)speed);
+            return CMDS_I2C_BAUDRATE;
     }
 }
 
+/** Switch to our clock profile: SETTING_SYS_CLOCK_MHZ if there's a profile for it, otherwise SYSCLOCK_MHZ. */
+static void set_system_clock(void)
+{
+    const uint32_t mhz = settings_get_or(SETTING_SYS_CLOCK_MHZ, SYSCLOCK_MHZ);
+    if (!sysclock_set(mhz))
+    {
+        // sysclock_set() has said why
+        sysclock_set(SYSCLOCK_MHZ);
+    }
+}
+
+/**
+ * @brief Act on a frame of commands from the controller. A frame that starts with a
+ * sequence definition uploads the rest of itself as the sequence's steps instead,
+ * and one that starts with a setting command is that command's arguments.
+ *
+ * @param commands The commands.
+ * @param ncommands How many.
+ */
+static void dispatch_frame(const uint8_t *commands, size_t ncommands)
+{
+    if (ncommands > 0)
+    {
+        const uint8_t kind = commands[0] & CMD_SEQUENCE_MASK;
+        if ((kind == CMD_SEQUENCE_DEFINE) || (kind == CMD_SEQUENCE_APPEND))
+        {
+            sequence_define(commands[0] & ~CMD_SEQUENCE_MASK, &commands[1], ncommands - 1, kind == CMD_SEQUENCE_APPEND);
+            return;
+        }
+        if ((commands[0] == CMD_SETTING_GET) || (commands[0] == CMD_SETTING_SET))
+        {
+            setting_cmd(commands, ncommands);
+            return;
+        }
+    }
+    dispatch_cmds(commands, ncommands);
+}
+
+/** Publish the last window of metrics to the register map. */
+static void publish_metrics(void)
+{
+    uint8_t packed[METRICS_PACKED_LEN];
+    cmds_register_write(REG_METRICS, packed, metrics_pack(packed, sizeof(packed)));
+}
+
+/** Publish the self test's results to the register map. */
+static void publish_bist(void)
+{
+    uint8_t packed[BIST_PACKED_LEN];
+    cmds_register_write(REG_BIST, packed, bist_pack(packed, sizeof(packed)));
+}
+
+/** Publish the LCD's idle sleep figures to the register map. */
+static void publish_idle(void)
+{
+    uint8_t packed[GRAPHICS_IDLE_PACKED_LEN];
+    cmds_register_write(REG_IDLE, packed, graphics_idle_pack(packed, sizeof(packed)));
+}
+
+/** Most clk_sys cycles the command bus's interrupt can take to run once raised and pass the self test. The core alone takes 15. */
+#define SELF_TEST_ISR_LATENCY_CYCLES 48U
+
+/** BIST_I2C_ISR_LATENCY: see cmds_measure_isr_latency(). */
+static bool measure_isr_latency(uint32_t *cycles, void *context)
+{
+    return cmds_measure_isr_latency(cycles);
+}
+
+/** Writes the command queue had dropped, as of the last sample_cmd_queue(). */
+static uint32_t cmds_dropped = 0;
+
+/** Show metrics how full the command queue is, and the writes it has dropped since last time. */
+static void sample_cmd_queue(void)
+{
+    cmds_stats_t stats;
+    cmds_get_stats(&stats);
+    metrics_level(METRICS_LEVEL_CMD_QUEUE, stats.used);
+    const uint32_t dropped = stats.dropped_overflow + stats.dropped_invalid;
+    if (dropped != cmds_dropped)
+    {
+        metrics_count(METRICS_COUNT_DROPS, dropped - cmds_dropped);
+        cmds_dropped = dropped;
+    }
+}
+
+/** Publish each module's error count to the register map. */
+static void publish_error_counts(void)
+{
+    for (int index = 0; index < ERR_NUM_MODULES; index++)
+    {
+        const uint32_t count = errors_get_count((err_module_id_t)((index + 1) << 8));
+        cmds_register_write_u16(REG_ERROR_COUNTS + (2 * index), (count > 0xFFFF) ? 0xFFFF : (uint16_t)count);
+    }
+}
+
+#if CMDS_USE_CAN
+/** RPC_ID_QUERY_ERRORS: the same report as CMD_QUERY_ERRORS, as a MsgPack bin 8. */
+static int rpc_query_errors(rpcacp_call_t *call)
+{
+    // Room for the bin 8 header, and no more than a bin 8 holds
+    uint8_t report[RPCACP_BUFFER_LEN - 2];
+    const size_t len = errors_pack(report, (sizeof(report) < 0xFF) ? sizeof(report) : 0xFF);
+
+    msgpack_writer_t writer;
+    msgpack_writer_init(&writer, call->data, RPCACP_BUFFER_LEN);
+    msgpack_write_bin(&writer, report, len);
+    call->len = writer.len;
+    return 0;
+}
+
+/** RPC_ID_QUERY_LOG: the same as CMD_QUERY_LOG, but as many messages as a MsgPack bin 8 in one call holds. */
+static int rpc_query_log(rpcacp_call_t *call)
+{
+    uint8_t messages[RPCACP_BUFFER_LEN - 2];
+    const size_t len = log_pack(messages, (sizeof(messages) < 0xFF) ? sizeof(messages) : 0xFF);
+
+    msgpack_writer_t writer;
+    msgpack_writer_init(&writer, call->data, RPCACP_BUFFER_LEN);
+    msgpack_write_bin(&writer, messages, len);
+    call->len = writer.len;
+    return 0;
+}
+#endif // CMDS_USE_CAN
+
+/**
+ * @brief Tell the reset MCU we're initialized, so it can let the next MCU boot.
+ * The line is shared with the other eyebrow, so we only ever pull it low: it goes
+ * high (to the reset MCU's pull-up) once we've both let go of it.
+ */
+static inline void signal_ready(void)
+{
+    gpio_set_dir(BOOT_READY_PIN, GPIO_IN);
+}
+
 int main()
 {
+    // Before anything else uses either core's stack, so their watermarks count everything from here
+    stackmon_init();
+
+    // Before anything that keeps state across a warm restart
+    warmboot_init();
+
+    // Tell the reset MCU we're busy booting, before anything else draws power
+    gpio_init(BOOT_READY_PIN);
+    gpio_disable_pulls(BOOT_READY_PIN);
+    gpio_put(BOOT_READY_PIN, 0);
+    gpio_set_dir(BOOT_READY_PIN, GPIO_OUT);
+
+#if USB_FRAMES
+    // Bring up our own USB device, whose serial port stdio then takes
+    usbframes_init();
+#endif // USB_FRAMES
+
     // Initialize UART for debugging (in a release build, this should be turned off from the CMake build system)
     stdio_init_all();
 
+    // Start tracing before anything that records events
+    trace_init();
+    trace_probes_init(TRACE_PROBE_PINS);
+
     // Initialize GPIO pins for LEDs
     leds_init(LED_PIN);
 
+    // Find the settings in flash, before anything that's tuned by them
+    settings_init();
+
+    // Then the clock, before the buses and displays start up (the LEDs follow it wherever it goes)
+    set_system_clock();
+
+    // Our sleeps waiting for commands are deep sleeps, so the graphics core can stop the LCD bus's clock while it sleeps
+    sysclock_deep_sleep_init();
+
     // Determine which 'side' we are (LEFT, RIGHT, MOUTH)
     const side_t side = determine_side();
 
     // Determine our I2C address
     const uint address = determine_address(side);
 
+#if !CMDS_USE_CAN
+    // Time the command bus's interrupt while it's free, before cmds_init() takes it
+    if (bist_run(BIST_I2C_ISR_LATENCY, &measure_isr_latency, NULL, SELF_TEST_ISR_LATENCY_CYCLES) != BIST_PASS)
+    {
+        set_errno(ERR_ID_CMD_MODULE, ETIME);
+    }
+#endif // CMDS_USE_CAN
+
     // Initialize I2C for communication with controller module.
-    cmds_init(address, I2C_SDA_PIN, I2C_SCL_PIN);
+    cmds_init(address, I2C_SDA_PIN, I2C_SCL_PIN, command_bus_speed());
+
+#ifndef MOUTH
+    // Both eyes take the same general-call commit, so the controller can stage a frame on each and switch them together
+    cmds_accept_general_call(true);
+#endif // MOUTH
 
-    // Initialize LCD
-    graphics_init(side);
+#if CMDS_USE_CAN
+    // Take remote procedure calls on the same bus
+    if (rpcacp_init())
+    {
+        rpcacp_register(RPC_ID_QUERY_ERRORS, &rpc_query_errors);
+        rpcacp_register(RPC_ID_QUERY_LOG, &rpc_query_log);
+    }
+#if CAN_FRAMES
+    // And frames, in blocks
+    canframes_init();
+#endif // CAN_FRAMES
+#endif // CMDS_USE_CAN
+
+    // Initialize LCD, or after a warm restart, carry on with what it's showing
+    graphics_set_idle_sleep(settings_get_or(SETTING_IDLE_SLEEP_MS, GFX_IDLE_SLEEP_MS));
+    uint32_t shown;
+    if (warmboot_is_warm())
+    {
+        graphics_resume(side, warmboot_get(WARMBOOT_SLOT_EXPRESSION, &shown) ? (cmd_t)shown : 0);
+    }
+    else
+    {
+        graphics_init(side);
+    }
 
 #ifndef MOUTH
     // Initialize servo subsystem
     servo_init();
 #endif // MOUTH
 
+    // Nothing to play until the controller uploads a sequence
+    sequence_init();
+
+    // Let the reset MCU start the next MCU's boot
+    signal_ready();
+
+    // How far through the error history we've logged
+    uint32_t error_cursor = 0;
+#if CMDS_USE_CAN
+    // And how far through it we've published
+    uint32_t publish_cursor = 0;
+#endif // CMDS_USE_CAN
+
     while (true)
     {
-        // Check the errno
-        err_t e = errno;
-        if (e)
+#if CMDS_USE_CAN
+        // Tell the controller about any new errors straight away, rather than waiting to be asked
+        psacp_publish_errors(&publish_cursor);
+#endif // CMDS_USE_CAN
+
+        // Log any new errors
+        err_record_t error;
+        uint32_t missed;
+        bool new_errors = false;
+        while (errors_get_next(&error_cursor, &error, &missed))
         {
-            uint8_t flag = (uint8_t)(e & 0x00FF);
-            uint8_t module = (uint8_t)((e & 0xFF00) >> 8);
+            new_errors = true;
+            if (missed > 0)
+            {
+                log_error("%lu errors were not logged; see CMD_QUERY_ERRORS for the counts.\n", (unsigned long)missed);
+            }
+            uint8_t flag = (uint8_t)(error.code & 0x00FF);
+            uint8_t module = (uint8_t)((error.code & 0xFF00) >> 8);
             log_error("Error flag: 0x%02X from module with ID: 0x%02X\n", flag, module);
-            errno = 0x0000;
         }
-
-        // Get the next command out of the cmds module and act on it.
-        cmd_t command;
-        if (cmds_get_next(&command))
+        if (new_errors)
         {
-            // Mask off the first two bits to detect the route
-            uint8_t route = command & 0xC0;
-            switch (route)
-            {
-                case CMD_MODULE_ID_LEDS:
-                    log_debug("LED command\n");
-                    leds_cmd(command);
-                    break;
-                case CMD_MODULE_ID_LCD:
-                    log_debug("LCD command\n");
-                    graphics_cmd(command);
-                    break;
+            publish_error_counts();
+            // Blink the latest one on the LED too, for when there's no serial to read the log from
+            leds_report_error((err_module_id_t)(error.code & 0xFF00), (err_t)(error.code & 0x00FF));
+        }
+
+        // Get the next frame of commands out of the cmds module and act on each of them in order.
+        // The queue is fullest just before we take from it.
+        sample_cmd_queue();
+        uint8_t commands[CMDS_FRAME_MAX_LEN];
+        size_t ncommands = cmds_get_next_frame(commands, sizeof(commands));
+        dispatch_frame(commands, ncommands);
+
+        // Then whatever steps of a playing sequence have come due
+        uint8_t steps[SEQUENCE_MAX_STEPS];
+        const size_t nsteps = sequence_get_due(steps, sizeof(steps));
+        dispatch_cmds(steps, nsteps);
+
+#if CMDS_USE_CAN
+        // Run any procedure calls that have come in, and send back what they return
+        rpcacp_process();
+#endif // CMDS_USE_CAN
+
+#if CAN_FRAMES
+        // Hand the graphics core whatever frames have come in over CAN
+        canframes_task();
+#endif // CAN_FRAMES
+
 #ifndef MOUTH
-                case CMD_MODULE_ID_SERVO:
-                    log_debug("Servo command\n");
-                    servo_cmd(command);
-                    break;
+        // Save the servo's calibration when a new one is done
+        servo_process();
 #endif // MOUTH
-                default:
-                    log_error("Illegal cmd type 0x%02X; route mask is: 0x%02X\n", command, route);
-                    break;
-            }
+
+#if USB_FRAMES
+        // Hand the graphics core whatever frames have come in over USB
+        usbframes_task();
+#endif // USB_FRAMES
+
+        // Once a window of metrics is up, show it to the controller
+        if (metrics_update())
+        {
+            publish_metrics();
+        }
+
+        // And the self test's results, as its checks finish (the LCD's, on the graphics core, whenever it's done)
+        if (bist_update())
+        {
+            publish_bist();
+        }
+
+        // And how the LCD's idle sleeps are going, as it sleeps and wakes
+        if (graphics_idle_update())
+        {
+            publish_idle();
+        }
+
+        // Send a band of the picture the graphics core is painting, if it has one ready (the mouth)
+        const bool assisted = graphics_assist();
+
+        // Nothing to do? Print what's been logged, then sleep until the I2C ISR
+        // (or any other interrupt, a log message from core 1, or a band painted) wakes us.
+        if ((ncommands == 0) && (nsteps == 0) && !assisted)
+        {
+            log_flush();
+            metrics_idle_begin();
+            cmds_wait_for_next();
+            metrics_idle_end();
         }
     }
 }
@@ -0,0 +1,166 @@
+// Stdlib includes
+#include <stdint.h>
+#include <string.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/time.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "sequence.h"
+
+/** Mask for a delay step's tick count. */
+#define SEQUENCE_DELAY_TICKS_MASK 0x3F
+
+/** No sequence is playing. */
+#define SEQUENCE_NONE (-1)
+
+/** The uploaded sequences. */
+static struct {
+    uint8_t steps[SEQUENCE_MAX_STEPS];
+    size_t len;
+} sequences[SEQUENCE_COUNT];
+
+/** The sequence that is playing, or SEQUENCE_NONE. */
+static int playing = SEQUENCE_NONE;
+
+/** Index of the playing sequence's next step. */
+static size_t position = 0;
+
+/** When the playing sequence's next steps are due. Delays count from here rather than from when the steps were taken, so they don't drift. */
+static absolute_time_t due_at;
+
+/** Set by the alarm (or sequence_play()) when the next steps are due. */
+static volatile bool due = false;
+
+/** The alarm for the delay being waited out, or 0 if there isn't one. */
+static alarm_id_t delay_alarm = 0;
+
+/** Alarm callback: the delay is over. Wakes the main loop to take the steps after it. */
+static int64_t delay_alarm_callback(alarm_id_t id, void *user_data)
+{
+    due = true;
+    __sev();
+    return 0;
+}
+
+/** Stop waiting out the delay, if we are. */
+static void cancel_delay(void)
+{
+    if (delay_alarm > 0)
+    {
+        cancel_alarm(delay_alarm);
+    }
+    delay_alarm = 0;
+}
+
+void sequence_init(void)
+{
+    log_info("Init sequence player\n");
+
+    for (size_t i = 0; i < SEQUENCE_COUNT; i++)
+    {
+        sequences[i].len = 0;
+    }
+    playing = SEQUENCE_NONE;
+    due = false;
+}
+
+void sequence_define(uint8_t id, const uint8_t *steps, size_t len, bool append)
+{
+    if (id >= SEQUENCE_COUNT)
+    {
+        log_error("No sequence %u\n", id);
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    if (playing == id)
+    {
+        sequence_stop();
+    }
+
+    const size_t start = append ? sequences[id].len : 0;
+    const size_t room = SEQUENCE_MAX_STEPS - start;
+    if (len > room)
+    {
+        log_error("Sequence %u is full; %u steps dropped\n", id, (uint)(len - room));
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        len = room;
+    }
+    memcpy(&sequences[id].steps[start], steps, len);
+    sequences[id].len = start + len;
+}
+
+void sequence_play(uint8_t id)
+{
+    if (id >= SEQUENCE_COUNT)
+    {
+        log_error("No sequence %u\n", id);
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    cancel_delay();
+    playing = (sequences[id].len > 0) ? id : SEQUENCE_NONE;
+    position = 0;
+    due_at = get_absolute_time();
+    due = (playing != SEQUENCE_NONE);
+}
+
+void sequence_stop(void)
+{
+    cancel_delay();
+    playing = SEQUENCE_NONE;
+    due = false;
+}
+
+size_t sequence_get_due(uint8_t *buf, size_t bufsize)
+{
+    if (!due || (playing == SEQUENCE_NONE))
+    {
+        return 0;
+    }
+    due = false;
+    delay_alarm = 0;
+
+    // Take the commands up to the next delay
+    const uint8_t *steps = sequences[playing].steps;
+    const size_t len = sequences[playing].len;
+    size_t ncommands = 0;
+    uint32_t delay_ticks = 0;
+    while ((position < len) && (delay_ticks == 0))
+    {
+        const uint8_t step = steps[position++];
+        if ((step & SEQUENCE_DELAY_MASK) == SEQUENCE_DELAY)
+        {
+            delay_ticks = step & SEQUENCE_DELAY_TICKS_MASK;
+        }
+        else if (ncommands < bufsize)
+        {
+            buf[ncommands++] = step;
+        }
+        else
+        {
+            set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        }
+    }
+
+    if (delay_ticks == 0)
+    {
+        // That was the end of it
+        playing = SEQUENCE_NONE;
+        return ncommands;
+    }
+
+    due_at = delayed_by_ms(due_at, delay_ticks * SEQUENCE_TICK_MS);
+    delay_alarm = add_alarm_at(due_at, &delay_alarm_callback, NULL, true);
+    if (delay_alarm < 0)
+    {
+        log_error("No alarm for a sequence delay; stopping it\n");
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        delay_alarm = 0;
+        playing = SEQUENCE_NONE;
+    }
+    return ncommands;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file sequence.h
+ * @brief Plays expression sequences uploaded by the controller, so a gesture like a blink
+ * takes one trigger command instead of one write per step.
+ *
+ * A sequence is a list of steps, each one byte. A step is either a command (anything
+ * main.c's command table takes: LED, LCD, servo) or a delay, SEQUENCE_DELAY | n, meaning wait
+ * n * SEQUENCE_TICK_MS before the steps after it. The commands between two delays are
+ * acted on together. A sequence can play another one (or itself, to loop), which stops it.
+ *
+ * One sequence plays at a time. An alarm marks each delay's end, and the main loop
+ * takes the commands that are due with sequence_get_due(), so they run exactly as
+ * commands from the controller would.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** A step with these two upper bits set is a delay of its lower six bits in ticks. Not a command route. */
+#define SEQUENCE_DELAY          0xC0
+
+/** Mask for detecting a delay step. */
+#define SEQUENCE_DELAY_MASK     0xC0
+
+#ifndef SEQUENCE_TICK_MS
+    /** The length of one delay tick, in ms. A delay step waits up to 63 of these. */
+    #define SEQUENCE_TICK_MS 10
+#endif // SEQUENCE_TICK_MS
+
+/** The number of sequences: IDs are 0 to SEQUENCE_COUNT - 1. */
+#define SEQUENCE_COUNT          8
+
+#ifndef SEQUENCE_MAX_STEPS
+    /** The most steps one sequence can hold. Each sequence costs this many bytes of RAM. */
+    #define SEQUENCE_MAX_STEPS 128
+#endif // SEQUENCE_MAX_STEPS
+
+/** Start the sequence player. All the sequences start out empty. */
+void sequence_init(void);
+
+/**
+ * @brief Set a sequence's steps, or add steps to the end of it.
+ * If it is playing, it stops first.
+ *
+ * @param id Which sequence.
+ * @param steps The steps. Copied.
+ * @param len How many.
+ * @param append Add to the sequence's steps instead of replacing them.
+ *               Steps past SEQUENCE_MAX_STEPS are dropped and set errno.
+ */
+void sequence_define(uint8_t id, const uint8_t *steps, size_t len, bool append);
+
+/**
+ * @brief Play a sequence from its first step, stopping whatever is playing.
+ * The first steps are due straight away.
+ *
+ * @param id Which sequence. An empty one just stops the one playing.
+ */
+void sequence_play(uint8_t id);
+
+/** Stop the sequence that is playing, if any. Its commands already acted on stay acted on. */
+void sequence_stop(void);
+
+/**
+ * @brief Get the commands that are due from the sequence that is playing.
+ * This does not block. Takes the steps up to the next delay (or the end),
+ * and starts the alarm for that delay.
+ *
+ * @param buf Where to put the commands.
+ * @param bufsize Size of `buf`. SEQUENCE_MAX_STEPS is always enough. Commands that don't fit are dropped and set errno.
+ * @return size_t The number of commands written to `buf`, or 0 if none are due.
+ */
+size_t sequence_get_due(uint8_t *buf, size_t bufsize);
+
+#ifdef __cplusplus
+}
+#endif
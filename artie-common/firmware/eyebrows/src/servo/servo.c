@@ -3,15 +3,23 @@
 #include <stdio.h>
 // SDK includes
 #include "hardware/pwm.h"
-#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "pico/time.h"
 // Library includes
+#include <bist.h>
 #include <errors.h>
+#include <fixmath.h>
+#include <gpioirq.h>
+#include <hotpaths.h>
+#include <settings.h>
+#include <sysclock.h>
 // Local includes
 #include "servo.h"
 #include "../cmds/cmds.h"
 #include "../board/pinconfig.h"
 #include "../board/types.h"
+#include "../board/warmboot.h"
 
 /** Macro for converting ms to micro seconds. */
 #define MS_TO_US(x) ((x) * 1000U)
@@ -22,162 +30,602 @@
  */
 #define PWM_PERIOD_MS 3
 
-/** Top of the PWM counter. */
-static const uint16_t COUNT_TOP = 0xFFFFU;
+/** The PWM counts microseconds, so a pulse width in us is its PWM level as it is. */
+#define PWM_TICK_HZ 1000000U
+
+/** Top of the PWM counter: it wraps every PWM_PERIOD_MS. */
+#define COUNT_TOP (MS_TO_US(PWM_PERIOD_MS) - 1U)
+
+/** Convert a pulse width in ms to us. Folds to a constant (no float math at run time) for a constant `ms`. */
+#define MS_TO_PULSE_US(ms) ((uint16_t)((ms) * 1000.0 + 0.5))
 
 /** The middle of the servo's range (nominally). */
-#define NOMINAL_MIDDLE_PULSE_WIDTH_MS 1.5f
+#define NOMINAL_MIDDLE_PULSE_WIDTH_MS 1.5
 
 /** The far left of the servo's range (nominally) */
-#define NOMINAL_FAR_LEFT 1.0f
+#define NOMINAL_FAR_LEFT 1.0
 
 /** The far right of the servo's range (nominally) */
-#define NOMINAL_FAR_RIGHT 2.0f
+#define NOMINAL_FAR_RIGHT 2.0
 
-/** Last known safe position left of center. */
-static float last_known_safe_left = NOMINAL_FAR_LEFT;
+/** The nominal range, in us of pulse width. */
+#define NOMINAL_MIDDLE_US MS_TO_PULSE_US(NOMINAL_MIDDLE_PULSE_WIDTH_MS)
+#define NOMINAL_FAR_LEFT_US MS_TO_PULSE_US(NOMINAL_FAR_LEFT)
+#define NOMINAL_FAR_RIGHT_US MS_TO_PULSE_US(NOMINAL_FAR_RIGHT)
 
-/** Last known safe position right of center. */
-static float last_known_safe_right = NOMINAL_FAR_RIGHT;
+/** How close to each limit calibration gets: the safe limit it finds is within this of where the switch trips. */
+#define CALIBRATION_RESOLUTION_US 20U
 
-/** Are we calibrating the servo? */
-static bool currently_calibrating = false;
+/**
+ * Pulse width (in ms) for a six-bit servo command parameter.
+ * Maps from the range [0, 63] to [1.0, 2.0] with a sharp fall off towards
+ * the less useful ends of the range so that the bits are used most efficiently:
+ * y = (1/65,000) * (x - 31)^3 + 1.5
+ */
+#define COMMAND_CURVE_MS(x) (1.5384e-05 * (((x) - 31.0) * ((x) - 31.0) * ((x) - 31.0)) + NOMINAL_MIDDLE_PULSE_WIDTH_MS)
+
+/** Pulse width (in us) for a six-bit servo command parameter, before clamping to the safe range. */
+#define COMMAND_CURVE_US(x) MS_TO_PULSE_US(COMMAND_CURVE_MS(x))
+
+/** Eight consecutive entries of COMMAND_CURVE. */
+#define COMMAND_CURVE_ROW(x) \
+    COMMAND_CURVE_US((x) + 0), COMMAND_CURVE_US((x) + 1), COMMAND_CURVE_US((x) + 2), COMMAND_CURVE_US((x) + 3), \
+    COMMAND_CURVE_US((x) + 4), COMMAND_CURVE_US((x) + 5), COMMAND_CURVE_US((x) + 6), COMMAND_CURVE_US((x) + 7)
+
+/** The number of distinct servo command parameters (six bits' worth). */
+#define N_SERVO_PARAMS 64
+
+/** The command curve, evaluated once (by the compiler) for every command parameter. */
+static const uint16_t COMMAND_CURVE[N_SERVO_PARAMS] = {
+    COMMAND_CURVE_ROW(0),  COMMAND_CURVE_ROW(8),  COMMAND_CURVE_ROW(16), COMMAND_CURVE_ROW(24),
+    COMMAND_CURVE_ROW(32), COMMAND_CURVE_ROW(40), COMMAND_CURVE_ROW(48), COMMAND_CURVE_ROW(56),
+};
+
+/**
+ * Pulse width (in us) for each command parameter, clamped to the safe range.
+ * Rebuilt from COMMAND_CURVE whenever calibration moves the safe range.
+ */
+static uint16_t command_widths[N_SERVO_PARAMS];
+
+/** Last known safe position left of center, in us of pulse width. */
+static uint16_t last_known_safe_left = NOMINAL_FAR_LEFT_US;
+
+/** Last known safe position right of center, in us of pulse width. */
+static uint16_t last_known_safe_right = NOMINAL_FAR_RIGHT_US;
+
+/** How long the servo takes to travel, in us per us of pulse width (300 ms for the full 1 ms: about 0.1 s per 60 degrees). */
+#define CALIBRATION_TRAVEL_US_PER_US 300U
+
+/** How long we give the servo to settle (and a limit switch to trip) at the end of each calibration probe, on top of its travel. */
+#define CALIBRATION_SETTLE_US 20000U
+
+/** Where the calibration state machine is. */
+static volatile servo_calibration_status_t calibration_status = SERVO_CALIBRATION_NOT_STARTED;
+
+/** Set by the limit switch IRQ when a switch trips during calibration. */
+static volatile bool limit_tripped = false;
+
+/** Limit switches can bounce for a few ms. Edges closer together than this count as the one trip. */
+#define LIMIT_SWITCH_DEBOUNCE_US 5000U
+
+/** The limit switch that tripped outside calibration, for servo_process() to report, or -1 if none. */
+static volatile int limit_trip_pending = -1;
+
+/** The last calibration position that didn't trip a limit switch. The limit switch IRQ backs off to here. */
+static uint16_t calibration_prev_value = NOMINAL_MIDDLE_US;
+
+/** The position being probed. */
+static uint16_t calibration_probe = NOMINAL_MIDDLE_US;
+
+/** The closest position to calibration_prev_value known to trip the limit switch, once we have found one. */
+static uint16_t calibration_trip_value = NOMINAL_MIDDLE_US;
+static bool calibration_trip_found = false;
 
-/** Set the servo's PWM pin to a duty cycle such that the HIGH portion of the square wave is `ms` long. */
-static void set_pulse_width(float ms)
+/** While verifying a saved calibration: have we checked that the saved left limit holds, and are now probing past it? */
+static bool verifying_past_limit = false;
+
+/** Set when a full calibration finishes, for servo_process() to save it to the settings store. */
+static volatile bool calibration_save_pending = false;
+
+/** The pulse width we last commanded, in us. */
+static volatile uint16_t current_pulse_us = NOMINAL_MIDDLE_US;
+
+/** Speed limit for moves, in sixteenths of a us per PWM period. Full range in about 330 ms. */
+#define MAX_SPEED_US16_PER_TICK 220U
+
+/** Acceleration limit for moves, in sixteenths of a us per PWM period, per PWM period. */
+#define MAX_ACCEL_US16_PER_TICK2 15U
+
+/** Move durations (in ms) selectable with CMD_SERVO_SET_DURATION. Zero means as fast as the limits allow. */
+static const uint16_t MOVE_DURATIONS_MS[8] = {0, 50, 100, 200, 300, 500, 750, 1000};
+
+/** How long each move should take, in ms. Applies to every turn command until changed. */
+static uint16_t move_duration_ms = 0;
+
+/** The move in progress. Stepped from the PWM wrap interrupt, once per PWM period. */
+static struct {
+    uint16_t start;             // Where we started, in us of pulse width
+    int32_t distance;           // Where we're going, relative to start
+    uint32_t tick;              // PWM periods since we started
+    uint32_t nticks;            // PWM periods the whole move takes
+    volatile bool active;
+} move;
+
+/** Set the servo's PWM pin so that the HIGH portion of the square wave is `us` long. The PWM counts in us, so that's its level. */
+static void HOT_FUNC(set_pulse_width)(uint16_t us)
 {
-    assert(ms >= NOMINAL_FAR_LEFT);
-    assert(ms <= NOMINAL_FAR_RIGHT);
+    assert(us >= NOMINAL_FAR_LEFT_US);
+    assert(us <= NOMINAL_FAR_RIGHT_US);
+    current_pulse_us = us;
+    warmboot_set(WARMBOOT_SLOT_SERVO_POSITION, us);
+    pwm_set_gpio_level(SERVO_PWM_PIN, us);
+}
 
-    // Set to duty cycle based on the frequency that we've already configured for
-    float duty_cycle = ms / (float)PWM_PERIOD_MS;
-    float count_fraction = (float)((uint32_t)COUNT_TOP + 1) * duty_cycle;
-    assert(count_fraction >= 0);
-    assert(count_fraction <= COUNT_TOP);
-    pwm_set_gpio_level(SERVO_PWM_PIN, (uint16_t)count_fraction);
+/** Step the move in progress. Runs once per PWM period, at the end of the pulse. */
+static void HOT_FUNC(servo_on_pwm_wrap)(void)
+{
+    // PWM_IRQ_WRAP is shared by all the slices. Ignore wraps that aren't ours.
+    uint slice_num = pwm_gpio_to_slice_num(SERVO_PWM_PIN);
+    if (!(pwm_get_irq_status_mask() & (1U << slice_num)))
+    {
+        return;
+    }
+    pwm_clear_irq(slice_num);
+
+    if (!move.active)
+    {
+        pwm_set_irq_enabled(slice_num, false);
+        return;
+    }
+
+    move.tick++;
+    if (move.tick >= move.nticks)
+    {
+        // Land exactly on the target
+        set_pulse_width((uint16_t)(move.start + move.distance));
+        move.active = false;
+        pwm_set_irq_enabled(slice_num, false);
+        return;
+    }
+
+    uint32_t u = (move.tick << 16) / move.nticks;
+    int32_t offset = (int32_t)(((int64_t)move.distance * (int64_t)fix_smoothstep_q16(u)) >> 16);
+    set_pulse_width((uint16_t)(move.start + offset));
 }
 
-/** Default GPIO IRQ handler for the whole system. If we add more interrupts, we should use raw handlers instead. */
-static void limit_switch_callback(uint gpio, uint32_t events)
+/** Stop wherever the servo is right now. Safe to call from an IRQ. */
+static inline void cancel_move(void)
 {
-    if (gpio == LIMIT_SWITCH_LEFT)
+    move.active = false;
+}
+
+/**
+ * Move from wherever we are to `target` along an S-curve, taking at least move_duration_ms.
+ * The speed and acceleration limits stretch the move if it's too short for the distance.
+ */
+static void start_move(uint16_t target)
+{
+    uint slice_num = pwm_gpio_to_slice_num(SERVO_PWM_PIN);
+
+    // Keep the IRQ off the move while we change it
+    pwm_set_irq_enabled(slice_num, false);
+    move.active = false;
+
+    const uint16_t start = current_pulse_us;
+    const int32_t distance = (int32_t)target - (int32_t)start;
+    const uint32_t magnitude = (distance < 0) ? (uint32_t)(-distance) : (uint32_t)distance;
+    if (magnitude == 0)
     {
-        set_pulse_width(last_known_safe_left);
-        currently_calibrating = false;
+        return;
     }
 
-    if (gpio == LIMIT_SWITCH_RIGHT)
+    // Peak speed of the S-curve is 1.5 * distance / duration
+    uint32_t nticks = move_duration_ms / PWM_PERIOD_MS;
+    const uint32_t speed_ticks = ((48U * magnitude) + (2U * MAX_SPEED_US16_PER_TICK) - 1U) / (2U * MAX_SPEED_US16_PER_TICK);
+    nticks = (nticks < speed_ticks) ? speed_ticks : nticks;
+
+    // Peak acceleration is 6 * distance / duration^2
+    const uint32_t accel_ticks = fix_isqrt64_ceil(((96U * magnitude) + MAX_ACCEL_US16_PER_TICK2 - 1U) / MAX_ACCEL_US16_PER_TICK2);
+    nticks = (nticks < accel_ticks) ? accel_ticks : nticks;
+
+    move.start = start;
+    move.distance = distance;
+    move.tick = 0;
+    move.nticks = nticks;
+    move.active = true;
+
+    pwm_clear_irq(slice_num);
+    pwm_set_irq_enabled(slice_num, true);
+}
+
+/** Regenerate command_widths from the command curve and the current safe range. */
+static void rebuild_command_widths(void)
+{
+    for (uint i = 0; i < N_SERVO_PARAMS; i++)
     {
-        set_pulse_width(last_known_safe_right);
-        currently_calibrating = false;
+        uint16_t us = COMMAND_CURVE[i];
+        us = (us < last_known_safe_left)  ? last_known_safe_left : us;
+        us = (us > last_known_safe_right) ? last_known_safe_right : us;
+        command_widths[i] = us;
     }
 }
 
-static void calibrate_servo(void)
+/** Are we calibrating the servo? */
+static inline bool currently_calibrating(void)
 {
-    float prev_value = NOMINAL_MIDDLE_PULSE_WIDTH_MS;
-    float next_value;
+    return (calibration_status == SERVO_CALIBRATION_SEEKING_LEFT) ||
+           (calibration_status == SERVO_CALIBRATION_CENTERING) ||
+           (calibration_status == SERVO_CALIBRATION_SEEKING_RIGHT) ||
+           (calibration_status == SERVO_CALIBRATION_VERIFYING);
+}
+
+/**
+ * A limit switch tripped: stop and back off straight away, and leave the rest to servo_process().
+ * The switches have their own raw handlers (see the gpioirq library), so nothing else waits on this.
+ */
+static void HOT_FUNC(limit_switch_irq)(uint gpio, uint32_t events, void *context)
+{
+    cancel_move();
 
-    // Run the servo all the way left to find where the limit is.
-    currently_calibrating = true;
-    uint32_t timestamp_ms = to_ms_since_boot(get_absolute_time());
-    while (currently_calibrating)
+    if (currently_calibrating())
     {
-        // Determine next value
-        next_value = prev_value - 0.1f;
-        next_value = (next_value < NOMINAL_FAR_LEFT) ? NOMINAL_FAR_LEFT : next_value;
+        // Back off to the last position that didn't trip. The calibration alarm does the rest.
+        set_pulse_width(calibration_prev_value);
+        limit_tripped = true;
+        return;
+    }
 
-        // Set pulse width
-        set_pulse_width(next_value);
+    set_pulse_width((gpio == LIMIT_SWITCH_LEFT) ? last_known_safe_left : last_known_safe_right);
+    limit_trip_pending = (int)gpio;
+    __sev();
+}
 
-        // Wait a bit for servo to drive to target
-        busy_wait_us(MS_TO_US(50));
+/** Unpack a safe range saved as left | right << 16. Returns whether it makes sense. */
+static bool unpack_limits(uint32_t limits, uint16_t *left, uint16_t *right)
+{
+    *left = (uint16_t)(limits & 0xFFFF);
+    *right = (uint16_t)(limits >> 16);
+    return (*left >= NOMINAL_FAR_LEFT_US) && (*left < NOMINAL_MIDDLE_US) &&
+           (*right <= NOMINAL_FAR_RIGHT_US) && (*right > NOMINAL_MIDDLE_US);
+}
 
-        // If we haven't tripped the limit switch, set prev_value to next_value
-        if (currently_calibrating)
-        {
-            prev_value = next_value;
-        }
+/** Pack the safe range as left | right << 16. */
+static inline uint32_t packed_limits(void)
+{
+    return ((uint32_t)last_known_safe_right << 16) | last_known_safe_left;
+}
 
-        // If we have been doing this for too long, cancel calibration.
-        // We have a potential hardware misconfiguration. Let someone know.
-        if ((to_ms_since_boot(get_absolute_time()) - timestamp_ms) >= 2000U)
-        {
-            set_errno(ERR_ID_SERVO_MODULE, ETIME);
-            log_warning("Calibration timed out. Potentially misconfigured servo encasing.\n");
-            return;
-        }
+/** The calibration saved in the settings store (as SETTING_SERVO_LIMITS), if there is one and it makes sense. */
+static bool saved_calibration(uint16_t *left, uint16_t *right)
+{
+    uint32_t limits;
+    return settings_get(SETTING_SERVO_LIMITS, &limits) && unpack_limits(limits, left, right);
+}
+
+/** The calibration from before a warm restart, if we just had one. It held until then, so it needs no checking. */
+static bool kept_calibration(uint16_t *left, uint16_t *right)
+{
+    uint32_t limits;
+    return warmboot_get(WARMBOOT_SLOT_SERVO_LIMITS, &limits) && unpack_limits(limits, left, right);
+}
+
+/**
+ * Drive to `target` for a calibration probe, with no limit switch tripped yet.
+ * Returns how long to give it (in us) before checking whether one has tripped.
+ */
+static int64_t probe_at(uint16_t target)
+{
+    const uint32_t travel = (target > current_pulse_us) ? (uint32_t)(target - current_pulse_us) : (uint32_t)(current_pulse_us - target);
+    calibration_probe = target;
+    limit_tripped = false;
+    set_pulse_width(target);
+    return (int64_t)CALIBRATION_SETTLE_US + (int64_t)((uint64_t)travel * CALIBRATION_TRAVEL_US_PER_US);
+}
+
+/** Give up on calibration. The safe range stays at whatever we have so far. */
+static void fail_calibration(void)
+{
+    set_errno(ERR_ID_SERVO_MODULE, ETIME);
+    log_warning("Limit switch never tripped. Potentially misconfigured servo encasing.\n");
+    set_pulse_width(NOMINAL_MIDDLE_US);
+    calibration_status = SERVO_CALIBRATION_FAILED;
+}
+
+/** Start looking for the limit in the given direction, with a probe all the way to that end of the nominal range. */
+static int64_t begin_seek(servo_calibration_status_t direction)
+{
+    calibration_prev_value = NOMINAL_MIDDLE_US;
+    calibration_trip_found = false;
+    calibration_status = direction;
+    return probe_at((direction == SERVO_CALIBRATION_SEEKING_LEFT) ? NOMINAL_FAR_LEFT_US : NOMINAL_FAR_RIGHT_US);
+}
+
+/**
+ * Check the last probe of a search for a limit, and probe again.
+ * The limit is between calibration_prev_value (which doesn't trip the switch) and calibration_trip_value
+ * (which does), and each probe halves that, until it's within CALIBRATION_RESOLUTION_US.
+ */
+static int64_t seek_step(void)
+{
+    const bool left = (calibration_status == SERVO_CALIBRATION_SEEKING_LEFT);
+    if (limit_tripped)
+    {
+        calibration_trip_value = calibration_probe;
+        calibration_trip_found = true;
+    }
+    else if (!calibration_trip_found)
+    {
+        // The first probe goes the whole way. Nothing to find.
+        fail_calibration();
+        return 0;
+    }
+    else
+    {
+        calibration_prev_value = calibration_probe;
     }
-    last_known_safe_left = prev_value;
 
-    // Drive to center
-    set_pulse_width(NOMINAL_MIDDLE_PULSE_WIDTH_MS);
-    busy_wait_us(MS_TO_US(50));
+    const uint16_t gap = left ? (calibration_prev_value - calibration_trip_value) : (calibration_trip_value - calibration_prev_value);
+    if (gap > CALIBRATION_RESOLUTION_US)
+    {
+        return probe_at((uint16_t)((calibration_prev_value + calibration_trip_value) / 2));
+    }
 
-    // Repeat on the right
-    prev_value = NOMINAL_MIDDLE_PULSE_WIDTH_MS;
-    currently_calibrating = true;
-    timestamp_ms = to_ms_since_boot(get_absolute_time());
-    while (currently_calibrating)
+    // Found this side's limit.
+    if (left)
     {
-        // Determine next value
-        next_value = prev_value + 0.1f;
-        next_value = (next_value > NOMINAL_FAR_RIGHT) ? NOMINAL_FAR_RIGHT : next_value;
+        last_known_safe_left = calibration_prev_value;
+    }
+    else
+    {
+        last_known_safe_right = calibration_prev_value;
+    }
+    rebuild_command_widths();
 
-        // Set pulse width
-        set_pulse_width(next_value);
+    if (left)
+    {
+        // Drive to center, and give it a probe's worth of time to get there.
+        calibration_status = SERVO_CALIBRATION_CENTERING;
+        return probe_at(NOMINAL_MIDDLE_US);
+    }
 
-        // Wait a bit for servo to drive to target
-        busy_wait_us(MS_TO_US(50));
+    set_pulse_width(NOMINAL_MIDDLE_US);
+    calibration_status = SERVO_CALIBRATION_DONE;
+    warmboot_set(WARMBOOT_SLOT_SERVO_LIMITS, packed_limits());
+    calibration_save_pending = true;
+    __sev();
+    log_info("Servo calibrated\n");
+    return 0;
+}
 
-        // If we haven't tripped the limit switch, set prev_value to next_value
-        if (currently_calibrating)
-        {
-            prev_value = next_value;
-        }
+/** Throw away the saved calibration and do a full one. */
+static int64_t recalibrate(void)
+{
+    log_info("Saved servo calibration is out of date; calibrating\n");
+    last_known_safe_left = NOMINAL_FAR_LEFT_US;
+    last_known_safe_right = NOMINAL_FAR_RIGHT_US;
+    rebuild_command_widths();
+    return begin_seek(SERVO_CALIBRATION_SEEKING_LEFT);
+}
 
-        // If we have been doing this for too long, cancel calibration.
-        // We have a potential hardware misconfiguration. Let someone know.
-        if ((to_ms_since_boot(get_absolute_time()) - timestamp_ms) >= 2000U)
+/**
+ * Check the last probe of a saved calibration. The saved left limit stands in for the encasing:
+ * the servo has to hold there without tripping the switch, and trip it just past there.
+ */
+static int64_t verify_step(void)
+{
+    if (!verifying_past_limit)
+    {
+        if (limit_tripped)
         {
-            set_errno(ERR_ID_SERVO_MODULE, ETIME);
-            log_warning("Calibration timed out. Potentially misconfigured servo encasing.\n");
-            return;
+            return recalibrate();
         }
+        calibration_prev_value = last_known_safe_left;
+        verifying_past_limit = true;
+        const uint16_t past = (last_known_safe_left < (NOMINAL_FAR_LEFT_US + (2 * CALIBRATION_RESOLUTION_US))) ? NOMINAL_FAR_LEFT_US : (last_known_safe_left - (2 * CALIBRATION_RESOLUTION_US));
+        return probe_at(past);
     }
-    last_known_safe_right = prev_value;
+
+    if (!limit_tripped)
+    {
+        return recalibrate();
+    }
+
+    set_pulse_width(NOMINAL_MIDDLE_US);
+    calibration_status = SERVO_CALIBRATION_DONE;
+    warmboot_set(WARMBOOT_SLOT_SERVO_LIMITS, packed_limits());
+    log_info("Servo calibration verified\n");
+    return 0;
 }
 
-void servo_init(void)
+/**
+ * One step of calibration, once the servo has had time to get where the last step sent it.
+ * Returns how long until the next step (in us), or 0 once calibration is over.
+ */
+static int64_t calibration_cb(alarm_id_t id, void *unused)
 {
-    log_info("Init servo\n");
+    switch (calibration_status)
+    {
+        case SERVO_CALIBRATION_VERIFYING:
+            return verify_step();
+        case SERVO_CALIBRATION_SEEKING_LEFT:
+        case SERVO_CALIBRATION_SEEKING_RIGHT:
+            return seek_step();
+        case SERVO_CALIBRATION_CENTERING:
+            // Repeat on the right
+            return begin_seek(SERVO_CALIBRATION_SEEKING_RIGHT);
+        default:
+            return 0;
+    }
+}
 
-    // Initialize limit switch left with interrupt (active low)
-    // First pin is used to enable interrupts for GPIO and to add a default handler for all pins.
-    gpio_set_irq_enabled_with_callback(LIMIT_SWITCH_LEFT, GPIO_IRQ_EDGE_FALL, true, &limit_switch_callback);
+/** Kick off calibration in the background: a quick check of the saved one if there is one, or a full one. */
+static void start_calibration(void)
+{
+    int64_t first_step_us;
+    uint16_t saved_left;
+    uint16_t saved_right;
+    if (kept_calibration(&saved_left, &saved_right))
+    {
+        // Warm restart: the servo hasn't moved, so stay where it was and skip the probing
+        last_known_safe_left = saved_left;
+        last_known_safe_right = saved_right;
+        rebuild_command_widths();
+        uint32_t position;
+        const bool in_range = warmboot_get(WARMBOOT_SLOT_SERVO_POSITION, &position) &&
+                              (position >= saved_left) && (position <= saved_right);
+        set_pulse_width(in_range ? (uint16_t)position : NOMINAL_MIDDLE_US);
+        warmboot_set(WARMBOOT_SLOT_SERVO_LIMITS, packed_limits());
+        calibration_status = SERVO_CALIBRATION_DONE;
+        log_info("Servo calibration kept across restart\n");
+        return;
+    }
 
-    // Initialize limit switch right with interrupt (active low)
-    // Additional pin interrupts are enabled like this.
-    gpio_set_irq_enabled(LIMIT_SWITCH_RIGHT, GPIO_IRQ_EDGE_FALL, true);
+    set_pulse_width(NOMINAL_MIDDLE_US);
+    if (saved_calibration(&saved_left, &saved_right))
+    {
+        last_known_safe_left = saved_left;
+        last_known_safe_right = saved_right;
+        rebuild_command_widths();
+        calibration_prev_value = NOMINAL_MIDDLE_US;
+        verifying_past_limit = false;
+        calibration_status = SERVO_CALIBRATION_VERIFYING;
+        first_step_us = probe_at(last_known_safe_left);
+    }
+    else
+    {
+        first_step_us = begin_seek(SERVO_CALIBRATION_SEEKING_LEFT);
+    }
 
-    // Clock division calculation for the PWM counter
-    // We want PWM_PERIOD_MS for our period (in ms)
-    float sysclock_frequency_hz = (float)clock_get_hz(clk_sys);
-    float default_timer_period_ms = ((float)COUNT_TOP / sysclock_frequency_hz) * (1000.0f); // multiply by a thousand to get ms
-    float division = (float)PWM_PERIOD_MS / default_timer_period_ms;
+    if (add_alarm_in_us((uint64_t)first_step_us, &calibration_cb, NULL, true) < 0)
+    {
+        log_error("Could not start servo calibration alarm.\n");
+        calibration_status = SERVO_CALIBRATION_FAILED;
+    }
+}
 
-    // Initialize servo pin for PWM. Configure PWM to count to count_top in PWM_PERIOD_MS ms.
+/** Divide the system clock down to the PWM's 1 us tick. */
+static void set_pwm_divider(uint32_t sys_hz, void *context)
+{
+    // In sixteenths (the divider's fractional part). At the usual 125 MHz that's exactly 125, so every count is a whole us.
+    const uint32_t division_16ths = (uint32_t)((((uint64_t)sys_hz * 16U) + (PWM_TICK_HZ / 2U)) / PWM_TICK_HZ);
+    pwm_set_clkdiv_int_frac(pwm_gpio_to_slice_num(SERVO_PWM_PIN), (uint8_t)(division_16ths >> 4), (uint8_t)(division_16ths & 0xFU));
+}
+
+/** How long the self test lets the PWM count for, against the timer. */
+#define SELF_TEST_WINDOW_US 1000U
+
+/** Most the PWM's count can be off the timer's over SELF_TEST_WINDOW_US and pass the self test: 1%. */
+#define SELF_TEST_LIMIT_US (SELF_TEST_WINDOW_US / 100U)
+
+/** Read the PWM's count and the timer together, with nothing in between. */
+static void read_counts(uint slice_num, uint32_t *pwm_count, uint32_t *timer_us)
+{
+    const uint32_t saved = save_and_disable_interrupts();
+    *pwm_count = pwm_get_counter(slice_num);
+    *timer_us = time_us_32();
+    restore_interrupts(saved);
+}
+
+/** BIST_SERVO_PWM: how far the PWM's 1 us count drifts from the timer over SELF_TEST_WINDOW_US. */
+static bool measure_pwm(uint32_t *error_us, void *context)
+{
+    const uint slice_num = pwm_gpio_to_slice_num(SERVO_PWM_PIN);
+    if (pwm_hw->slice[slice_num].top != COUNT_TOP)
+    {
+        log_error("Servo PWM wraps at %lu, not %u\n", (unsigned long)pwm_hw->slice[slice_num].top, COUNT_TOP);
+        return false;
+    }
+
+    uint32_t start_count, start_us, end_count, end_us;
+    read_counts(slice_num, &start_count, &start_us);
+    busy_wait_us(SELF_TEST_WINDOW_US);
+    read_counts(slice_num, &end_count, &end_us);
+
+    // It wraps every PWM_PERIOD_MS, which is longer than the window
+    const uint32_t counted = (end_count + COUNT_TOP + 1U - start_count) % (COUNT_TOP + 1U);
+    const uint32_t elapsed = end_us - start_us;
+    *error_us = (counted > elapsed) ? (counted - elapsed) : (elapsed - counted);
+    return true;
+}
+
+void servo_init(void)
+{
+    log_info("Init servo\n");
+
+    // Limit switches are active low, and each gets its own handler
+    gpioirq_add(LIMIT_SWITCH_LEFT, GPIO_IRQ_EDGE_FALL, LIMIT_SWITCH_DEBOUNCE_US, &limit_switch_irq, NULL);
+    gpioirq_add(LIMIT_SWITCH_RIGHT, GPIO_IRQ_EDGE_FALL, LIMIT_SWITCH_DEBOUNCE_US, &limit_switch_irq, NULL);
+
+    // Initialize servo pin for PWM. Configure PWM to count to COUNT_TOP, one count per us, so it wraps every PWM_PERIOD_MS.
     gpio_set_function(SERVO_PWM_PIN, GPIO_FUNC_PWM);
     uint slice_num = pwm_gpio_to_slice_num(SERVO_PWM_PIN);
     pwm_config cfg = pwm_get_default_config();
     pwm_config_set_wrap(&cfg, COUNT_TOP);
-    pwm_config_set_clkdiv(&cfg, division);
+    pwm_init(slice_num, &cfg, false);
+
+    // Then start the PWM signal, once it has its divider for the clock we're at (and whatever clock comes later)
+    sysclock_register(&set_pwm_divider, NULL);
+    pwm_set_enabled(slice_num, true);
+
+    // Moves are stepped at the end of each PWM period. The IRQ is shared with the LEDs.
+    pwm_clear_irq(slice_num);
+    irq_add_shared_handler(PWM_IRQ_WRAP, servo_on_pwm_wrap, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+
+    // A PWM that doesn't keep time moves the servo somewhere other than where it's told
+    if (bist_run(BIST_SERVO_PWM, &measure_pwm, NULL, SELF_TEST_LIMIT_US) != BIST_PASS)
+    {
+        set_errno(ERR_ID_SERVO_MODULE, ETIME);
+    }
 
-    // Start the PWM signal
-    pwm_init(slice_num, &cfg, true);
+    // Commands are usable (over the nominal range) even if calibration fails
+    rebuild_command_widths();
 
-    // Run the calibration procedure
-    calibrate_servo();
+    // Run the calibration procedure. It finishes in the background.
+    start_calibration();
+}
+
+void servo_process(void)
+{
+    const int tripped = limit_trip_pending;
+    if (tripped >= 0)
+    {
+        limit_trip_pending = -1;
+        log_warning("%s limit switch tripped; backed off to the safe limit\n", ((uint)tripped == LIMIT_SWITCH_LEFT) ? "Left" : "Right");
+    }
+
+    if (calibration_save_pending)
+    {
+        // Unchanged limits aren't written again
+        calibration_save_pending = false;
+        if (settings_set(SETTING_SERVO_LIMITS, packed_limits()))
+        {
+            log_info("Servo calibration saved\n");
+        }
+    }
+}
+
+servo_calibration_status_t servo_calibration_status(void)
+{
+    return calibration_status;
+}
+
+void servo_report_status(void)
+{
+    const uint16_t left = last_known_safe_left;
+    const uint16_t right = last_known_safe_right;
+    const uint8_t status[5] = {
+        (uint8_t)calibration_status,
+        (uint8_t)(left & 0xFF), (uint8_t)(left >> 8),
+        (uint8_t)(right & 0xFF), (uint8_t)(right >> 8),
+    };
+    cmds_set_register_bytes(status, sizeof(status));
+}
+
+void servo_set_move_duration(uint8_t index)
+{
+    move_duration_ms = MOVE_DURATIONS_MS[index & (count_of(MOVE_DURATIONS_MS) - 1)];
+    log_debug("Servo moves now take %u ms\n", move_duration_ms);
 }
 
 void servo_cmd(cmd_t command)
@@ -187,26 +635,18 @@ void servo_cmd(cmd_t command)
     // The 6 LSbs are mapped into the usable range of degrees for the eyeball enclosure.
     uint8_t servo_cmd_param = command & 0x3F;
 
+    // Calibration owns the servo until it's done.
+    if (currently_calibrating())
+    {
+        log_warning("Servo is calibrating; ignoring command 0x%02X\n", command);
+        set_errno(ERR_ID_SERVO_MODULE, EBUSY);
+        return;
+    }
+
     // Six bits means range [0, 63]
     // 0  => 0 deg      (1.0 ms)
     // 31 => 90 deg     (1.5 ms)
     // 63 => 180 deg    (2.0 ms)
-    // Use a function that maps from the range [0, 63] to [1.0, 2.0]
-    // with a sharp fall off towards the less useful ends of the range
-    // so that the bits are used most efficiently.
-    // y = (1/65,000) * (x - 31)^3 + 1.5
-    // NOTE: There is no hard floating point in the Pico.
-    //       This likely takes an egregious amount of time.
-    static const float scaling_factor = 1.5384e-05f;                // 1/65,000 ish
-    static const float x_offset = -31.0f;                           // Slide the graph to center on halfway between 0 and 63
-    static const float y_offset = NOMINAL_MIDDLE_PULSE_WIDTH_MS;    // Shift up so that the 31 falls on 1.5 ms (nominally)
-    float x = (float)servo_cmd_param;
-    float pulse_width_ms = scaling_factor * ((x + x_offset) * (x + x_offset) * (x + x_offset)) + y_offset;
-
-    // Make sure to bound the result
-    pulse_width_ms = (pulse_width_ms < last_known_safe_left)  ? last_known_safe_left : pulse_width_ms;
-    pulse_width_ms = (pulse_width_ms > last_known_safe_right) ? last_known_safe_right : pulse_width_ms;
-
-    // Set duty cycle on PWM line
-    set_pulse_width(pulse_width_ms);
+    // See COMMAND_CURVE_MS for the mapping. The table is already bounded to the safe range.
+    start_move(command_widths[servo_cmd_param]);
 }
@@ -12,14 +12,58 @@ extern "C" {
 #include "../cmds/cmds.h"
 #include "../board/types.h"
 
+/** Where the servo calibration is up to. */
+typedef enum {
+    SERVO_CALIBRATION_NOT_STARTED   = 0,
+    SERVO_CALIBRATION_SEEKING_LEFT  = 1,
+    SERVO_CALIBRATION_CENTERING     = 2,
+    SERVO_CALIBRATION_SEEKING_RIGHT = 3,
+    SERVO_CALIBRATION_DONE          = 4,
+    SERVO_CALIBRATION_FAILED        = 5,    // A limit switch never tripped
+    SERVO_CALIBRATION_VERIFYING     = 6,    // Checking the calibration saved in flash
+} servo_calibration_status_t;
+
 /**
  * @brief Initialize the servo subsystem.
+ * Calibration then runs in the background; servo commands are
+ * ignored (with EBUSY) until it is done.
  *
+ * A calibration saved (in the settings store) by an earlier boot is used if one quick
+ * probe at its left limit still agrees with it. Otherwise each limit is
+ * found by binary search, and the result is saved for next time
+ * (by servo_process()).
  */
 void servo_init(void);
 
+/**
+ * @brief Do the servo work that can't be done from an interrupt: saving a
+ * new calibration to the settings store. Call from the main loop, after
+ * settings_init().
+ */
+void servo_process(void);
+
+/** Where the calibration is up to. */
+servo_calibration_status_t servo_calibration_status(void);
+
+/**
+ * @brief Load the I2C read register with the servo's status:
+ * the calibration status (one byte), then the safe left and right
+ * limits in us of pulse width (uint16 each, little-endian).
+ */
+void servo_report_status(void);
+
+/**
+ * @brief Set how long each servo move takes from now on.
+ *
+ * @param index Index into {0, 50, 100, 200, 300, 500, 750, 1000} ms.
+ *              Zero means as fast as the speed and acceleration limits allow.
+ *              Moves that are too short for their distance are stretched to fit the limits.
+ */
+void servo_set_move_duration(uint8_t index);
+
 /**
  * @brief Handle the given command meant for the servo subsystem.
+ * Turn commands move the servo along an S-curve, in the background.
  *
  * @param command Servo command to handle.
  */
@@ -0,0 +1,279 @@
+/**
+ * @file facegen.c
+ * @brief Host tool that pre-renders every expression into a C file of flash frames.
+ *
+ * Paints each expression with the firmware's own faceshapes.c and GUI_Paint.c into a
+ * buffer laid out exactly like the firmware's paint buffer, then PackBits-encodes the
+ * rows that hold anything but background (see gfx_frame_t in commongfx.h).
+ *
+ * Usage: facegen <eyebrows|mouth> <paint scale> <output.c>
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GUI_Paint.h>
+#include <LCD_1in14.h>
+#include <LCD_2in.h>
+#include "faceframes.h"
+#include "faceshapes.h"
+
+/** The longest run PackBits can describe with one header byte. */
+#define MAX_RUN 128
+
+/** Buffer for the frame being rendered. */
+static UBYTE *image = NULL;
+
+/** Encoded frame. Worst case PackBits grows the data by one byte in 128. */
+static uint8_t *packed = NULL;
+
+/** Set up the paint buffer the same way commongfx.c's init_paint_buffer() and the callers after it do. */
+static void new_image(const char *kind, UBYTE scale)
+{
+    if (strcmp(kind, "mouth") == 0)
+    {
+        Paint_NewImage(image, LCD_2IN_WIDTH, LCD_2IN_HEIGHT, ROTATE_0, WHITE);
+    }
+    else
+    {
+        Paint_NewImage(image, LCD_1IN14_HEIGHT, LCD_1IN14_WIDTH, ROTATE_0, WHITE);
+    }
+    Paint_SetScale(scale);
+    Paint_Clear(WHITE);
+    Paint_ResetDirty();
+}
+
+/** Is the pixel at (x, y) in memory coordinates the background (WHITE) colour? */
+static int is_background(UWORD x, UWORD y)
+{
+    const UBYTE *row = image + (size_t)y * Paint.WidthByte;
+    switch (Paint.Scale)
+    {
+        case 2:
+            return (row[x >> 3] >> (7 - (x & 0x07))) & 0x01;
+        case 4:
+            return ((row[x >> 2] >> (6 - ((x & 0x03) << 1))) & 0x03) == 0x03;
+        default:
+            return (row[2 * x] == 0xFF) && (row[2 * x + 1] == 0xFF);
+    }
+}
+
+/** Box (memory coordinates) around every pixel that isn't background. Empty if there are none. */
+static PAINT_RECT find_bounds(void)
+{
+    PAINT_RECT r = {Paint.WidthMemory, Paint.HeightMemory, 0, 0};
+    for (UWORD y = 0; y < Paint.HeightMemory; y++)
+    {
+        for (UWORD x = 0; x < Paint.WidthMemory; x++)
+        {
+            if (!is_background(x, y))
+            {
+                r.Xstart = (x < r.Xstart) ? x : r.Xstart;
+                r.Ystart = (y < r.Ystart) ? y : r.Ystart;
+                r.Xend = (x >= r.Xend) ? (x + 1) : r.Xend;
+                r.Yend = (y >= r.Yend) ? (y + 1) : r.Yend;
+            }
+        }
+    }
+
+    if ((r.Xend <= r.Xstart) || (r.Yend <= r.Ystart))
+    {
+        r = (PAINT_RECT){0, 0, 0, 0};
+    }
+    return r;
+}
+
+/** PackBits-encode n bytes of src into packed. Returns the encoded size. */
+static size_t pack_bits(const UBYTE *src, size_t n)
+{
+    size_t in = 0;
+    size_t out = 0;
+    while (in < n)
+    {
+        // How long is the run of identical bytes starting here?
+        size_t run = 1;
+        while ((in + run < n) && (run < MAX_RUN) && (src[in + run] == src[in]))
+        {
+            run++;
+        }
+
+        if (run >= 2)
+        {
+            packed[out++] = (uint8_t)(257 - run);
+            packed[out++] = src[in];
+            in += run;
+            continue;
+        }
+
+        // Literal run, up to the next pair of identical bytes
+        size_t start = in;
+        size_t len = 0;
+        while ((in < n) && (len < MAX_RUN) && !((in + 1 < n) && (src[in] == src[in + 1])))
+        {
+            in++;
+            len++;
+        }
+        packed[out++] = (uint8_t)(len - 1);
+        memcpy(&packed[out], &src[start], len);
+        out += len;
+    }
+    return out;
+}
+
+/** Encode the current image and write it out as a named array. Fills in frame (but not its data pointer). */
+static void emit_frame(FILE *f, const char *name, gfx_frame_t *frame)
+{
+    frame->scale = (uint8_t)Paint.Scale;
+    frame->rotate = Paint.Rotate;
+    frame->width_memory = Paint.WidthMemory;
+    frame->height_memory = Paint.HeightMemory;
+    frame->bounds = find_bounds();
+
+    const UBYTE *band = image + (size_t)frame->bounds.Ystart * Paint.WidthByte;
+    const size_t nbytes = (size_t)(frame->bounds.Yend - frame->bounds.Ystart) * Paint.WidthByte;
+    frame->size = (uint32_t)pack_bits(band, nbytes);
+    if (frame->size == 0)
+    {
+        return;
+    }
+
+    fprintf(f, "static const uint8_t %s[%u] = {", name, (unsigned)frame->size);
+    for (uint32_t i = 0; i < frame->size; i++)
+    {
+        fprintf(f, "%s0x%02X,", ((i % 16) == 0) ? "\n    " : " ", packed[i]);
+    }
+    fprintf(f, "\n};\n\n");
+}
+
+/** Write out the initializer for a frame whose data was emitted as the given name. */
+static void emit_frame_struct(FILE *f, const char *name, const gfx_frame_t *frame)
+{
+    fprintf(f, "    {.scale = %u, .rotate = %u, .width_memory = %u, .height_memory = %u, "
+               ".bounds = {%u, %u, %u, %u}, .size = %u, .data = %s},\n",
+            frame->scale, frame->rotate, frame->width_memory, frame->height_memory,
+            frame->bounds.Xstart, frame->bounds.Ystart, frame->bounds.Xend, frame->bounds.Yend,
+            (unsigned)frame->size, (frame->size == 0) ? "NULL" : name);
+}
+
+static void generate_eyebrows(FILE *f, UBYTE scale)
+{
+    static gfx_frame_t frames[NUM_EYEBROW_STATES];
+    char name[32];
+
+    for (uint8_t i = 0; i < NUM_EYEBROW_STATES; i++)
+    {
+        new_image("eyebrows", scale);
+        const eyebrow_t eyebrow = faceshapes_eyebrow_from_index(i);
+        faceshapes_paint_eyebrow(&eyebrow);
+        snprintf(name, sizeof(name), "eyebrow_%u", i);
+        emit_frame(f, name, &frames[i]);
+    }
+
+    fprintf(f, "const gfx_frame_t faceframes_eyebrows[NUM_EYEBROW_STATES] = {\n");
+    for (uint8_t i = 0; i < NUM_EYEBROW_STATES; i++)
+    {
+        snprintf(name, sizeof(name), "eyebrow_%u", i);
+        emit_frame_struct(f, name, &frames[i]);
+    }
+    fprintf(f, "};\n");
+}
+
+static void generate_mouth(FILE *f, UBYTE scale)
+{
+    static gfx_frame_t frames[NUM_MOUTH_SHAPES];
+    char name[32];
+
+    for (uint8_t i = 0; i < NUM_MOUTH_SHAPES; i++)
+    {
+        new_image("mouth", scale);
+        faceshapes_paint_mouth((mouth_shape_t)i);
+        snprintf(name, sizeof(name), "mouth_%u", i);
+        emit_frame(f, name, &frames[i]);
+    }
+
+    fprintf(f, "const gfx_frame_t faceframes_mouth[NUM_MOUTH_SHAPES] = {\n");
+    for (uint8_t i = 0; i < NUM_MOUTH_SHAPES; i++)
+    {
+        snprintf(name, sizeof(name), "mouth_%u", i);
+        emit_frame_struct(f, name, &frames[i]);
+    }
+    fprintf(f, "};\n\n");
+
+    static gfx_frame_t visemes[NUM_VISEMES];
+    for (uint8_t i = 0; i < NUM_VISEMES; i++)
+    {
+        new_image("mouth", scale);
+        faceshapes_paint_viseme((viseme_t)i);
+        snprintf(name, sizeof(name), "viseme_%u", i);
+        emit_frame(f, name, &visemes[i]);
+    }
+
+    fprintf(f, "const gfx_frame_t faceframes_visemes[NUM_VISEMES] = {\n");
+    for (uint8_t i = 0; i < NUM_VISEMES; i++)
+    {
+        snprintf(name, sizeof(name), "viseme_%u", i);
+        emit_frame_struct(f, name, &visemes[i]);
+    }
+    fprintf(f, "};\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s <eyebrows|mouth> <paint scale> <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    const char *kind = argv[1];
+    const int scale = atoi(argv[2]);
+    if ((strcmp(kind, "eyebrows") != 0) && (strcmp(kind, "mouth") != 0))
+    {
+        fprintf(stderr, "Unknown target '%s'. Must be eyebrows or mouth.\n", kind);
+        return 1;
+    }
+    if ((scale != 2) && (scale != 4) && (scale != 65))
+    {
+        fprintf(stderr, "Paint scale must be one of 2, 4, or 65, not %d.\n", scale);
+        return 1;
+    }
+
+    // Big enough for either LCD at RGB565
+    const size_t image_size = (size_t)LCD_2IN_WIDTH * LCD_2IN_HEIGHT * 2;
+    image = (UBYTE *)malloc(image_size);
+    packed = (uint8_t *)malloc(image_size + (image_size / MAX_RUN) + 1);
+    if ((image == NULL) || (packed == NULL))
+    {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+
+    FILE *f = fopen(argv[3], "w");
+    if (f == NULL)
+    {
+        perror(argv[3]);
+        return 1;
+    }
+
+    fprintf(f, "// Generated by tools/facegen (%s, paint scale %d). Do not edit.\n", kind, scale);
+    fprintf(f, "#include <stddef.h>\n");
+    fprintf(f, "#include \"faceframes.h\"\n\n");
+    if (strcmp(kind, "mouth") == 0)
+    {
+        generate_mouth(f, (UBYTE)scale);
+    }
+    else
+    {
+        generate_eyebrows(f, (UBYTE)scale);
+    }
+
+    int err = ferror(f);
+    err |= fclose(f);
+    if (err != 0)
+    {
+        fprintf(stderr, "Could not write %s.\n", argv[3]);
+        remove(argv[3]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+# Pre-render every expression at build time (see facegen.c) and add the frames to a firmware target.
+#
+# faceframes_generate(<target> <eyebrows|mouth> <paint scale>)
+include(ExternalProject)
+
+set(FACEGEN_SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+function(faceframes_generate TARGET KIND SCALE)
+  set(FACEGEN_BINARY_DIR ${CMAKE_BINARY_DIR}/facegen)
+  ExternalProject_Add(facegen
+    SOURCE_DIR ${FACEGEN_SOURCE_DIR}
+    BINARY_DIR ${FACEGEN_BINARY_DIR}
+    CMAKE_ARGS "-DCMAKE_MAKE_PROGRAM:FILEPATH=${CMAKE_MAKE_PROGRAM}" "-DARTIE_GRAPHICS_DIR:PATH=${ARTIE_GRAPHICS_DIR}"
+    BUILD_ALWAYS 1
+    INSTALL_COMMAND ""
+  )
+
+  set(GRAPHICS_DIR ${FACEGEN_SOURCE_DIR}/../../graphics)
+  set(FACEFRAMES_C ${CMAKE_BINARY_DIR}/generated/faceframes.c)
+  add_custom_command(
+    OUTPUT ${FACEFRAMES_C}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_BINARY_DIR}/generated
+    COMMAND ${FACEGEN_BINARY_DIR}/facegen ${KIND} ${SCALE} ${FACEFRAMES_C}
+    DEPENDS facegen ${GRAPHICS_DIR}/faceshapes.c ${ARTIE_GRAPHICS_DIR}/GUI/GUI_Paint.c ${GRAPHICS_DIR}/commongfx.h
+    COMMENT "Pre-rendering ${KIND} frames"
+  )
+  target_sources(${TARGET} PRIVATE ${FACEFRAMES_C})
+  target_compile_definitions(${TARGET} PRIVATE GFX_PRERENDERED_FRAMES=1)
+endfunction()
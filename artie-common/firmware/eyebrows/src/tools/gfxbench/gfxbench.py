@@ -0,0 +1,109 @@
+"""
+Pick the results table out of a capture of the gfx_bench firmware's USB output
+(see bench/gfx_bench.c) and optionally compare it against an earlier capture.
+The bytestuff_bench and fixmath_bench firmware (bench/bytestuff_bench.c and
+bench/fixmath_bench.c) print the same table; pick theirs out with --bench. So do
+the host test programs (tools/hosttest) with --bench, with their times in ns per
+operation; pick theirs out with --bench <program>, e.g. --bench test_servo.
+
+Capture with anything that logs a serial port, e.g. `cat /dev/ttyACM0 > bench.txt`.
+The last complete run in each capture is used.
+
+When given a baseline, prints the change in mean time for each benchmark and exits
+non-zero if any got slower by more than the threshold.
+
+Usage: python gfxbench.py <capture.txt> [--baseline <old capture.txt>] [--threshold <percent>] [--bench <name>]
+"""
+import argparse
+import csv
+import sys
+
+def read_capture(path: str, bench: str = "gfx_bench"):
+    """
+    Read the last complete run of the named benchmark firmware out of a capture into
+    (header, rows), where header is the text of its begin line and rows maps
+    (name, param) to a dict of the columns.
+    """
+    begin = f"# {bench} begin"
+    end = f"# {bench} end"
+    with open(path, 'r', errors='replace') as f:
+        lines = [line.strip() for line in f]
+
+    run = None
+    header = None
+    current = None
+    for line in lines:
+        if line.startswith(begin):
+            header = line
+            current = []
+        elif line.startswith(end) and current is not None:
+            run = (header, current)
+            current = None
+        elif current is not None and line:
+            current.append(line)
+
+    if run is None:
+        raise ValueError(f"{path}: no complete {bench} run found")
+
+    header, table = run
+    rows = {}
+    for row in csv.DictReader(table):
+        rows[(row["name"], row["param"])] = row
+    return header, rows
+
+def time_unit(rows) -> str:
+    """The unit the table's times are in: "us" from the firmware, "ns" (per operation) from the host tests."""
+    first = next(iter(rows.values()), {})
+    return "ns" if "mean_ns" in first else "us"
+
+def compare(rows, baseline, threshold: float) -> bool:
+    """
+    Print each benchmark in rows against the same one in baseline. Returns True
+    if any got slower by more than threshold percent.
+    """
+    regressed = False
+    unit = time_unit(rows)
+    mean = f"mean_{unit}"
+    print(f"{'name':<28} {'param':>5} {'old ' + unit:>10} {'new ' + unit:>10} {'change':>8}")
+    for key, row in rows.items():
+        new = float(row[mean])
+        if key not in baseline:
+            print(f"{key[0]:<28} {key[1]:>5} {'-':>10} {new:>10g} {'new':>8}")
+            continue
+        old = float(baseline[key][mean])
+        change = ((new - old) * 100.0 / old) if old > 0 else 0.0
+        flag = ""
+        if change > threshold:
+            regressed = True
+            flag = "  <-- slower"
+        print(f"{key[0]:<28} {key[1]:>5} {old:>10g} {new:>10g} {change:>+7.1f}%{flag}")
+    return regressed
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="Captured benchmark output")
+    parser.add_argument("--baseline", help="Earlier capture to compare against")
+    parser.add_argument("--threshold", type=float, default=10.0, help="Percent slower that counts as a regression (default: 10)")
+    parser.add_argument("--bench", default="gfx_bench", help="Which benchmark firmware made the captures (default: gfx_bench)")
+    args = parser.parse_args()
+
+    try:
+        header, rows = read_capture(args.capture, args.bench)
+        baseline_header, baseline = read_capture(args.baseline, args.bench) if args.baseline else (None, None)
+    except (OSError, ValueError) as e:
+        print(e, file=sys.stderr)
+        sys.exit(1)
+
+    if baseline is None:
+        print(header)
+        unit = time_unit(rows)
+        columns = ["name", "param", "iterations", f"min_{unit}", f"mean_{unit}", f"max_{unit}"]
+        writer = csv.writer(sys.stdout)
+        writer.writerow(columns)
+        for row in rows.values():
+            writer.writerow([row[column] for column in columns])
+        sys.exit(0)
+
+    print(f"old: {baseline_header}")
+    print(f"new: {header}")
+    sys.exit(1 if compare(rows, baseline, args.threshold) else 0)
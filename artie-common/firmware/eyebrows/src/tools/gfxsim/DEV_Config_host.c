@@ -0,0 +1,431 @@
+/**
+ * @file DEV_Config_host.c
+ * @brief DEV_Config.h for the simulator: the LCD bus feeds a model of the panel (see panel.h).
+ *
+ * Transfers complete before they return, which is the same thing the real DEV_Config.c
+ * does when it has no DMA channel, so the callbacks run straight away.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <DEV_Config.h>
+#include "panel.h"
+
+/** Size of the ST7789's frame memory, as the glass is laid out (MADCTL's MV clear). */
+#define PANEL_GRAM_COLUMNS 240
+#define PANEL_GRAM_ROWS 320
+
+/** ST7789 commands we act on. Everything else is accepted and ignored. */
+#define ST7789_CASET 0x2A
+#define ST7789_RASET 0x2B
+#define ST7789_RAMWR 0x2C
+#define ST7789_VSCRDEF 0x33
+#define ST7789_MADCTL 0x36
+#define ST7789_VSCSAD 0x37
+#define ST7789_COLMOD 0x3A
+
+/** COLMOD's control interface format, in its low bits: 12 bits a pixel (two in three bytes), otherwise 16. */
+#define COLMOD_FORMAT_MASK 0x07
+#define COLMOD_12BIT 0x03
+
+/** MADCTL bits we act on: exchange addresses, then mirror the glass's columns (MX) and rows (MY). */
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+
+static struct {
+    pthread_mutex_t lock;
+    UWORD gram[PANEL_GRAM_ROWS][PANEL_GRAM_COLUMNS];
+    UBYTE dc;                   ///< Level of LCD_DC_PIN: 0 for a command, 1 for data
+    UBYTE command;              ///< Last command byte
+    UBYTE params[6];            ///< Parameter bytes of CASET/RASET/VSCRDEF/VSCSAD
+    UBYTE nparams;
+    UBYTE madctl;               ///< Memory access control: how addresses map onto the frame memory
+    UBYTE colmod;               ///< Interface pixel format: how many bytes make a pixel
+    UWORD scroll_top;           ///< Scroll area: the rows of frame memory that wrap around
+    UWORD scroll_rows;
+    UWORD scroll_start;         ///< Frame memory row shown at the top of the scroll area
+    UWORD xstart, xend;         ///< Column window, inclusive
+    UWORD ystart, yend;         ///< Row window, inclusive
+    UWORD x, y;                 ///< Where the next pixel of a memory write goes
+    UBYTE pixel_bytes[3];       ///< Bytes of the pixel (or RGB444 pair) we're part way through
+    UBYTE npixel_bytes;
+    UWORD seen_x0, seen_y0, seen_x1, seen_y1;   ///< Box (frame memory, exclusive end) around every pixel written
+    uint64_t bytes;
+} panel = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .dc = 1,
+    .colmod = 0x05,
+    .scroll_rows = PANEL_GRAM_ROWS,
+    .seen_x0 = PANEL_GRAM_COLUMNS,
+    .seen_y0 = PANEL_GRAM_ROWS,
+};
+
+static void panel_command(UBYTE command)
+{
+    panel.command = command;
+    panel.nparams = 0;
+    if (command == ST7789_RAMWR)
+    {
+        panel.x = panel.xstart;
+        panel.y = panel.ystart;
+        panel.npixel_bytes = 0;
+    }
+}
+
+static void panel_pixel(UWORD color)
+{
+    UWORD column = (panel.madctl & MADCTL_MV) ? panel.y : panel.x;
+    UWORD row = (panel.madctl & MADCTL_MV) ? panel.x : panel.y;
+    if ((column < PANEL_GRAM_COLUMNS) && (row < PANEL_GRAM_ROWS))
+    {
+        column = (panel.madctl & MADCTL_MX) ? (PANEL_GRAM_COLUMNS - 1 - column) : column;
+        row = (panel.madctl & MADCTL_MY) ? (PANEL_GRAM_ROWS - 1 - row) : row;
+        panel.gram[row][column] = color;
+
+        panel.seen_x0 = (column < panel.seen_x0) ? column : panel.seen_x0;
+        panel.seen_y0 = (row < panel.seen_y0) ? row : panel.seen_y0;
+        panel.seen_x1 = (column + 1 > panel.seen_x1) ? (column + 1) : panel.seen_x1;
+        panel.seen_y1 = (row + 1 > panel.seen_y1) ? (row + 1) : panel.seen_y1;
+    }
+
+    // Fill the window a row at a time, wrapping back to the top like the panel does
+    if (panel.x++ >= panel.xend)
+    {
+        panel.x = panel.xstart;
+        if (panel.y++ >= panel.yend)
+        {
+            panel.y = panel.ystart;
+        }
+    }
+}
+
+/** Widen an RGB444 pixel to the RGB565 the frame memory holds, the way the panel does. */
+static UWORD rgb444_to_565(UWORD rgb444)
+{
+    const UWORD r = (rgb444 >> 8) & 0x0F;
+    const UWORD g = (rgb444 >> 4) & 0x0F;
+    const UWORD b = rgb444 & 0x0F;
+    return (UWORD)((((r << 1) | (r >> 3)) << 11) | (((g << 2) | (g >> 2)) << 5) | ((b << 1) | (b >> 3)));
+}
+
+static void panel_data(UBYTE value)
+{
+    switch (panel.command)
+    {
+        case ST7789_CASET:
+        case ST7789_RASET:
+            if (panel.nparams < 4)
+            {
+                panel.params[panel.nparams++] = value;
+            }
+            if (panel.nparams == 4)
+            {
+                const UWORD start = (UWORD)((panel.params[0] << 8) | panel.params[1]);
+                const UWORD end = (UWORD)((panel.params[2] << 8) | panel.params[3]);
+                if (panel.command == ST7789_CASET)
+                {
+                    panel.xstart = start;
+                    panel.xend = end;
+                }
+                else
+                {
+                    panel.ystart = start;
+                    panel.yend = end;
+                }
+            }
+            break;
+        case ST7789_VSCRDEF:
+            if (panel.nparams < 6)
+            {
+                panel.params[panel.nparams++] = value;
+            }
+            if (panel.nparams == 6)
+            {
+                // The bottom fixed area is whatever is left
+                panel.scroll_top = (UWORD)((panel.params[0] << 8) | panel.params[1]);
+                panel.scroll_rows = (UWORD)((panel.params[2] << 8) | panel.params[3]);
+            }
+            break;
+        case ST7789_VSCSAD:
+            if (panel.nparams < 2)
+            {
+                panel.params[panel.nparams++] = value;
+            }
+            if (panel.nparams == 2)
+            {
+                panel.scroll_start = (UWORD)((panel.params[0] << 8) | panel.params[1]);
+            }
+            break;
+        case ST7789_MADCTL:
+            panel.madctl = value;
+            break;
+        case ST7789_COLMOD:
+            panel.colmod = value;
+            break;
+        case ST7789_RAMWR:
+            panel.pixel_bytes[panel.npixel_bytes++] = value;
+            if ((panel.colmod & COLMOD_FORMAT_MASK) != COLMOD_12BIT)
+            {
+                if (panel.npixel_bytes == 2)
+                {
+                    panel_pixel((UWORD)((panel.pixel_bytes[0] << 8) | panel.pixel_bytes[1]));
+                    panel.npixel_bytes = 0;
+                }
+            }
+            else if (panel.npixel_bytes == 2)
+            {
+                panel_pixel(rgb444_to_565((UWORD)((panel.pixel_bytes[0] << 4) | (panel.pixel_bytes[1] >> 4))));
+            }
+            else if (panel.npixel_bytes == 3)
+            {
+                panel_pixel(rgb444_to_565((UWORD)(((panel.pixel_bytes[1] & 0x0F) << 8) | panel.pixel_bytes[2])));
+                panel.npixel_bytes = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/** Put bytes on the bus. Must be called with the lock held. */
+static void panel_receive_locked(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (panel.dc)
+        {
+            panel_data(data[i]);
+        }
+        else
+        {
+            panel_command(data[i]);
+        }
+    }
+    panel.bytes += len;
+}
+
+/** Frame memory row that the glass shows on the given line, once the scroll area has wrapped. */
+static UWORD panel_scrolled_row(UWORD line)
+{
+    const UWORD top = panel.scroll_top;
+    const UWORD rows = panel.scroll_rows;
+    if ((line < top) || (line >= top + rows) || (panel.scroll_start < top) || (panel.scroll_start >= top + rows))
+    {
+        return line;
+    }
+    return (UWORD)(top + ((line - top) + (panel.scroll_start - top)) % rows);
+}
+
+bool panel_write_ppm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&panel.lock);
+    const UWORD x0 = panel.seen_x0;
+    const UWORD y0 = panel.seen_y0;
+    const UWORD width = (panel.seen_x1 > x0) ? (panel.seen_x1 - x0) : 0;
+    const UWORD height = (panel.seen_y1 > y0) ? (panel.seen_y1 - y0) : 0;
+    fprintf(f, "P6\n%u %u\n255\n", width, height);
+    for (UWORD y = y0; y < y0 + height; y++)
+    {
+        for (UWORD x = x0; x < x0 + width; x++)
+        {
+            // RGB565 out to 8 bits a channel, replicating the top bits into the bottom
+            const UWORD c = panel.gram[panel_scrolled_row(y)][x];
+            const UBYTE r = (UBYTE)((c >> 11) & 0x1F);
+            const UBYTE g = (UBYTE)((c >> 5) & 0x3F);
+            const UBYTE b = (UBYTE)(c & 0x1F);
+            const UBYTE rgb[3] = {(UBYTE)((r << 3) | (r >> 2)), (UBYTE)((g << 2) | (g >> 4)), (UBYTE)((b << 3) | (b >> 2))};
+            fwrite(rgb, 1, sizeof(rgb), f);
+        }
+    }
+    pthread_mutex_unlock(&panel.lock);
+
+    int err = ferror(f);
+    err |= fclose(f);
+    return err == 0;
+}
+
+uint64_t panel_bytes_received(void)
+{
+    pthread_mutex_lock(&panel.lock);
+    const uint64_t bytes = panel.bytes;
+    pthread_mutex_unlock(&panel.lock);
+    return bytes;
+}
+
+/**
+ * GPIO
+**/
+void DEV_Digital_Write(UWORD Pin, UBYTE Value)
+{
+    if (Pin == LCD_DC_PIN)
+    {
+        pthread_mutex_lock(&panel.lock);
+        panel.dc = Value;
+        pthread_mutex_unlock(&panel.lock);
+    }
+}
+
+UBYTE DEV_Digital_Read(UWORD Pin)
+{
+    return 0;
+}
+
+void DEV_GPIO_Mode(UWORD Pin, UWORD Mode)
+{
+}
+
+void DEV_KEY_Config(UWORD Pin)
+{
+}
+
+/**
+ * SPI
+**/
+void DEV_SPI_WriteByte(UBYTE Value)
+{
+    DEV_SPI_Write_nByte(&Value, 1);
+}
+
+void DEV_SPI_Write_nByte(uint8_t *pData, uint32_t Len)
+{
+    pthread_mutex_lock(&panel.lock);
+    panel_receive_locked(pData, Len);
+    pthread_mutex_unlock(&panel.lock);
+}
+
+uint32_t DEV_SPI_SetBaudrate(uint32_t Baudrate)
+{
+    return Baudrate;
+}
+
+/** Transfers started (and, since they finish before they return, finished). */
+static uint32_t spi_dma_transfers = 0;
+
+void DEV_SPI_Write_nByte_DMA(const uint8_t *pData, uint32_t Len, DEV_SPI_DMA_Callback Callback)
+{
+    pthread_mutex_lock(&panel.lock);
+    panel_receive_locked(pData, Len);
+    spi_dma_transfers++;
+    pthread_mutex_unlock(&panel.lock);
+    if (Callback != NULL)
+    {
+        Callback();
+    }
+}
+
+void DEV_SPI_Fill_DMA(uint16_t Value, uint32_t Count, DEV_SPI_DMA_Callback Callback)
+{
+    const uint8_t bytes[2] = {(uint8_t)(Value >> 8), (uint8_t)(Value & 0xFF)};
+    pthread_mutex_lock(&panel.lock);
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        panel_receive_locked(bytes, sizeof(bytes));
+    }
+    spi_dma_transfers++;
+    pthread_mutex_unlock(&panel.lock);
+    if (Callback != NULL)
+    {
+        Callback();
+    }
+}
+
+bool DEV_SPI_DMA_Busy(void)
+{
+    return false;
+}
+
+void DEV_SPI_DMA_Wait(void)
+{
+}
+
+uint32_t DEV_SPI_DMA_Abort(void)
+{
+    // Nothing is ever in flight
+    return 0;
+}
+
+uint32_t DEV_SPI_DMA_Started(void)
+{
+    return spi_dma_transfers;
+}
+
+uint32_t DEV_SPI_DMA_Finished(void)
+{
+    return spi_dma_transfers;
+}
+
+void DEV_Bus_Count_Start(void)
+{
+}
+
+uint32_t DEV_Bus_Count_Contested(void)
+{
+    // No bus to contend for
+    return 0;
+}
+
+bool DEV_TE_Wait(UDOUBLE Timeout_us)
+{
+    // No tearing-effect line to watch
+    return false;
+}
+
+/**
+ * delay x ms: the delays are only there to let a real panel settle, so don't bother
+**/
+void DEV_Delay_ms(UDOUBLE xms)
+{
+}
+
+void DEV_Delay_us(UDOUBLE xus)
+{
+}
+
+/**
+ * I2C (not wired to anything)
+**/
+void DEV_I2C_Write(uint8_t addr, uint8_t reg, uint8_t Value)
+{
+}
+
+void DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len)
+{
+}
+
+uint8_t DEV_I2C_ReadByte(uint8_t addr, uint8_t reg)
+{
+    return 0;
+}
+
+void DEV_SET_PWM(uint8_t Value)
+{
+}
+
+void DEV_PWM_Ramp(uint8_t Value, UDOUBLE Duration_ms)
+{
+}
+
+bool DEV_PWM_Ramp_Busy(void)
+{
+    return false;
+}
+
+UBYTE DEV_Module_Init(void)
+{
+    return 0;
+}
+
+void DEV_Module_Sleep(bool Asleep)
+{
+}
+
+void DEV_Module_Exit(void)
+{
+}
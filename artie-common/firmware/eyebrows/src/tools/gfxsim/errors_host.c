@@ -0,0 +1,62 @@
+/**
+ * @file errors_host.c
+ * @brief errors.h for the simulator: logs go to stderr, and errors are reported as they are set.
+ *
+ * The firmware's errors.c keeps its error history behind an RP2040 spinlock and timestamps it from the
+ * hardware timer, so it stays on the board.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <errors.h>
+
+#define CALL_LOG_FUNCTION(level) do { \
+    va_list args; \
+    va_start(args, str); \
+    logging_internal(level, str, args); \
+    va_end(args); \
+} while (0)
+
+static void logging_internal(const char *level, const char *str, va_list args)
+{
+    fprintf(stderr, "[%s]: ", level);
+    vfprintf(stderr, str, args);
+}
+
+void log_debug(const char *str, ...)
+{
+    #if LOG_LEVEL == LOG_LEVEL_DEBUG
+    CALL_LOG_FUNCTION("DEBUG");
+    #endif // if LOG_LEVEL
+}
+
+void log_info(const char *str, ...)
+{
+    #if LOG_LEVEL <= LOG_LEVEL_INFO
+    CALL_LOG_FUNCTION("INFO");
+    #endif // if LOG_LEVEL
+}
+
+void log_warning(const char *str, ...)
+{
+    #if LOG_LEVEL <= LOG_LEVEL_WARNING
+    CALL_LOG_FUNCTION("WARNING");
+    #endif // if LOG_LEVEL
+}
+
+void log_error(const char *str, ...)
+{
+    #if LOG_LEVEL <= LOG_LEVEL_ERROR
+    CALL_LOG_FUNCTION("ERROR");
+    #endif // if LOG_LEVEL
+}
+
+void log_flush(void)
+{
+    // Nothing is deferred
+}
+
+void set_errno(err_module_id_t module_id, err_t error)
+{
+    // Nothing polls for it like the firmware's main loop does, so say so now
+    fprintf(stderr, "[ERRNO]: 0x%02X from module with ID: 0x%02X\n", error & 0x00FF, (module_id & 0xFF00) >> 8);
+}
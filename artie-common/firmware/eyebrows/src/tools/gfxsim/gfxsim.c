@@ -0,0 +1,263 @@
+/**
+ * @file gfxsim.c
+ * @brief Host simulator of the eyebrow or mouth graphics stack.
+ *
+ * Runs the firmware's own graphics code (core 1 is a thread, and the main thread does the
+ * main loop's share of the drawing while it waits) against a model of the LCD panel, driven
+ * by a script of the commands the controller would send over I2C, and dumps what the panel
+ * shows to PPM files. Good for profiling the rendering with perf or valgrind and for
+ * golden-image tests, without a board.
+ *
+ * Usage: gfxsim_<eyebrows|mouth> [--left] [script]
+ *
+ * The script (stdin if not given) has one instruction per line:
+ *   cmd <byte> [<byte> ...]   Hand these command bytes to graphics_cmd(), e.g. cmd 0x4A
+ *   fill <x> <y> <w> <h> <rgb565>
+ *                             Blit a window of the LCD in one colour (see graphics_blit()), and wait for it
+ *   delta <file>              Apply a delta frame (see gfx_delta_t), as can/canframes.c takes them, and wait for it
+ *   wait <ms>                 Let the render loop run for this long
+ *   dump <file.ppm>           Write what the panel is showing
+ * Blank lines and lines starting with # are ignored.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "commongfx.h"
+#include "graphics.h"
+#include "panel.h"
+#include <LCD_2in.h>
+#include <LCD_Panel.h>
+
+/** Longest script line we accept. */
+#define MAX_LINE 256
+
+/** How long to give the render loop to come up before running the script. */
+#define STARTUP_WAIT_MS 50
+
+/** The pixels of a fill, which the graphics core reads until it says it's done with them. */
+static uint8_t fill_pixels[LCD_2IN_WIDTH * LCD_2IN_HEIGHT * 2];
+
+/** A delta frame, likewise. The most a BWACP block holds by default. */
+static uint8_t delta_data[4096];
+
+static volatile bool blit_done;
+
+static void on_blit_done(uintptr_t arg)
+{
+    blit_done = true;
+}
+
+/** Let the render loop run for ms, helping it as the main loop does (see graphics_assist()) meanwhile. */
+static void run_main_loop(uint32_t ms)
+{
+    const absolute_time_t until = make_timeout_time_ms(ms);
+    while (!time_reached(until))
+    {
+        if (!graphics_assist())
+        {
+            sleep_us(100);
+        }
+    }
+}
+
+/** Hand the graphics core a blit, and wait for it to be done. */
+static bool blit_and_wait(const gfx_blit_t *blit)
+{
+    blit_done = false;
+    if (!graphics_blit(blit))
+    {
+        return false;
+    }
+    while (!blit_done)
+    {
+        run_main_loop(1);
+    }
+    return true;
+}
+
+/** Blit a window of the LCD in one colour, the way usb/usbframes.c sends a rectangle, and wait for it. */
+static bool fill(const unsigned long *args)
+{
+    const uint16_t color = (uint16_t)args[4];
+    const uint32_t npixels = (uint32_t)(args[2] * args[3]);
+    uint32_t len = 0;
+    if (gfx_lcd_pixel_bits() == 12)
+    {
+        // Two pixels in three bytes
+        const uint16_t rgb444 = LCD_PANEL_RGB444(color);
+        for (uint32_t i = 0; i < npixels; i += 2)
+        {
+            fill_pixels[len++] = (uint8_t)(rgb444 >> 4);
+            fill_pixels[len++] = (uint8_t)((rgb444 << 4) | (rgb444 >> 8));
+            fill_pixels[len++] = (uint8_t)rgb444;
+        }
+        len = LCD_Panel_PixelBytes(npixels);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < npixels; i++)
+        {
+            fill_pixels[len++] = (uint8_t)(color >> 8);
+            fill_pixels[len++] = (uint8_t)color;
+        }
+    }
+
+    const gfx_blit_t blit = {
+        .window = {(UWORD)args[0], (UWORD)args[1], (UWORD)(args[0] + args[2]), (UWORD)(args[1] + args[3])},
+        .pixels = fill_pixels,
+        .len = len,
+        .done = on_blit_done,
+    };
+    return blit_and_wait(&blit);
+}
+
+/** Apply the delta frame in a file, the way can/canframes.c applies a block, and wait for it. */
+static bool apply_delta(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    const size_t len = fread(delta_data, 1, sizeof(delta_data), f);
+    fclose(f);
+
+    gfx_delta_t delta;
+    if (!gfx_delta_parse(delta_data, (uint32_t)len, &delta))
+    {
+        fprintf(stderr, "%s is not a delta frame\n", path);
+        return false;
+    }
+    const gfx_blit_t blit = {
+        .delta = &delta,
+        .done = on_blit_done,
+    };
+    return blit_and_wait(&blit);
+}
+
+/** Run one line of the script. Returns false if it's malformed or fails. */
+static bool run_line(char *line, unsigned lineno)
+{
+    char *op = strtok(line, " \t\r\n");
+    if ((op == NULL) || (op[0] == '#'))
+    {
+        return true;
+    }
+
+    if (strcmp(op, "cmd") == 0)
+    {
+        char *arg;
+        while ((arg = strtok(NULL, " \t\r\n")) != NULL)
+        {
+            char *end;
+            const unsigned long byte = strtoul(arg, &end, 0);
+            if ((*end != '\0') || (byte > 0xFF))
+            {
+                fprintf(stderr, "line %u: '%s' is not a command byte\n", lineno, arg);
+                return false;
+            }
+            graphics_cmd((cmd_t)byte);
+        }
+        return true;
+    }
+
+    if (strcmp(op, "fill") == 0)
+    {
+        unsigned long args[5];
+        for (size_t i = 0; i < 5; i++)
+        {
+            char *arg = strtok(NULL, " \t\r\n");
+            char *end;
+            args[i] = (arg == NULL) ? 0 : strtoul(arg, &end, 0);
+            if ((arg == NULL) || (*end != '\0') || (args[i] > 0xFFFF))
+            {
+                fprintf(stderr, "line %u: fill takes x, y, width, height, and an RGB565 colour\n", lineno);
+                return false;
+            }
+        }
+        if ((args[2] * args[3] * 2) > sizeof(fill_pixels))
+        {
+            fprintf(stderr, "line %u: fill is bigger than the LCD\n", lineno);
+            return false;
+        }
+        return fill(args);
+    }
+
+    char *arg = strtok(NULL, " \t\r\n");
+    if (arg == NULL)
+    {
+        fprintf(stderr, "line %u: '%s' needs an argument\n", lineno, op);
+        return false;
+    }
+
+    if (strcmp(op, "wait") == 0)
+    {
+        run_main_loop((uint32_t)strtoul(arg, NULL, 0));
+        return true;
+    }
+    else if (strcmp(op, "delta") == 0)
+    {
+        return apply_delta(arg);
+    }
+    else if (strcmp(op, "dump") == 0)
+    {
+        if (!panel_write_ppm(arg))
+        {
+            fprintf(stderr, "line %u: could not write %s\n", lineno, arg);
+            return false;
+        }
+        return true;
+    }
+
+    fprintf(stderr, "line %u: unknown instruction '%s'\n", lineno, op);
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    side_t side = EYE_RIGHT_SIDE;
+    const char *script = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--left") == 0)
+        {
+            side = EYE_LEFT_SIDE;
+        }
+        else if (script == NULL)
+        {
+            script = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--left] [script]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *f = (script == NULL) ? stdin : fopen(script, "r");
+    if (f == NULL)
+    {
+        perror(script);
+        return 1;
+    }
+
+    graphics_init(side);
+    run_main_loop(STARTUP_WAIT_MS);
+
+    char line[MAX_LINE];
+    unsigned lineno = 0;
+    bool ok = true;
+    while (ok && (fgets(line, sizeof(line), f) != NULL))
+    {
+        ok = run_line(line, ++lineno);
+    }
+
+    if (f != stdin)
+    {
+        fclose(f);
+    }
+    fprintf(stderr, "%llu bytes sent to the panel\n", (unsigned long long)panel_bytes_received());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file sync.h
+ * @brief Host stand-in for hardware/sync.h: the barrier the graphics code shares state across cores with,
+ * the event register it wakes the other core with, and a spin lock for the libraries that take one.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+/** A full memory barrier, as on the board. */
+#define __dmb() __sync_synchronize()
+
+/** Nothing in the simulator sleeps on the event register, so waiting on it just lets the other threads run. */
+#define __sev() ((void)0)
+#define __wfe() ((void)sched_yield())
+
+/** The board has 32 hardware spin locks. The simulator has one mutex, which is enough for what takes them. */
+typedef pthread_mutex_t spin_lock_t;
+#define PICO_SPINLOCK_ID_STRIPED_FIRST 16
+
+static inline spin_lock_t *spin_lock_instance(unsigned int lock_num)
+{
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    return &lock;
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    pthread_mutex_lock(lock);
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+    pthread_mutex_unlock(lock);
+}
@@ -0,0 +1,12 @@
+/**
+ * @file multicore.h
+ * @brief Host stand-in for pico/multicore.h: core 1 is a thread.
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+void multicore_launch_core1(void (*entry)(void));
+
+/** Nothing on the host pauses core 1. */
+static inline void multicore_lockout_victim_init(void) {}
@@ -0,0 +1,24 @@
+/**
+ * @file stdlib.h
+ * @brief Host stand-in for the bits of the Pico SDK that the graphics stack uses.
+ *
+ * Only what commongfx.c, eyebrowsgfx.c, mouthgfx.c, and the headers they pull in need.
+ * Implemented in sdk_host.c.
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/time.h"
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+/** The RP2040 has two cores. Core 1 is a thread here (see multicore.h). */
+#define NUM_CORES 2
+
+/** The core (thread) we are running on. */
+uint get_core_num(void);
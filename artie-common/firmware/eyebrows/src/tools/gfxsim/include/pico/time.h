@@ -0,0 +1,22 @@
+/**
+ * @file time.h
+ * @brief Host stand-in for pico/time.h: the monotonic clock, in microseconds since the simulator started.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint64_t absolute_time_t;
+
+absolute_time_t get_absolute_time(void);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us);
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+bool time_reached(absolute_time_t t);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+void sleep_until(absolute_time_t t);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
@@ -0,0 +1,136 @@
+/**
+ * @file intercore_host.c
+ * @brief intercore.h for the simulator: the cores are threads, so the channels are guarded by a mutex,
+ * and waiting is on a condition variable.
+ *
+ * The firmware's intercore.c relies on the RP2040's event register and SIO FIFOs, so it stays on the board.
+ */
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <intercore.h>
+
+/** One lock for every channel. The simulator has one. */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+
+/** What each channel's doorbell calls, indexed by its doorbell. */
+static struct {
+    intercore_doorbell_t handler;
+    void *context;
+} doorbells[INTERCORE_MAX_DOORBELLS];
+static uint32_t ndoorbells = 0;
+
+bool intercore_channel_init(intercore_channel_t *channel, void *storage, size_t item_size, uint32_t capacity)
+{
+    if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+    {
+        return false;
+    }
+
+    channel->items = (uint8_t *)storage;
+    channel->item_size = item_size;
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->tail = 0;
+    channel->doorbell = -1;
+    return true;
+}
+
+bool intercore_try_send(intercore_channel_t *channel, const void *item)
+{
+    pthread_mutex_lock(&lock);
+    const bool sent = (channel->head - channel->tail) < channel->capacity;
+    if (sent)
+    {
+        memcpy(&channel->items[(channel->head & (channel->capacity - 1)) * channel->item_size], item, channel->item_size);
+        channel->head++;
+        pthread_cond_broadcast(&changed);
+    }
+    const int8_t doorbell = channel->doorbell;
+    pthread_mutex_unlock(&lock);
+
+    // No interrupts here: ring it from the sender's thread
+    if (sent && (doorbell >= 0))
+    {
+        doorbells[doorbell].handler(doorbells[doorbell].context);
+    }
+    return sent;
+}
+
+/** Take the oldest item out. Must be called with the lock held and the channel not empty. */
+static void receive_locked(intercore_channel_t *channel, void *item)
+{
+    memcpy(item, &channel->items[(channel->tail & (channel->capacity - 1)) * channel->item_size], channel->item_size);
+    channel->tail++;
+}
+
+bool intercore_try_receive(intercore_channel_t *channel, void *item)
+{
+    pthread_mutex_lock(&lock);
+    const bool received = channel->tail != channel->head;
+    if (received)
+    {
+        receive_locked(channel, item);
+    }
+    pthread_mutex_unlock(&lock);
+    return received;
+}
+
+void intercore_receive_blocking(intercore_channel_t *channel, void *item)
+{
+    pthread_mutex_lock(&lock);
+    while (channel->tail == channel->head)
+    {
+        pthread_cond_wait(&changed, &lock);
+    }
+    receive_locked(channel, item);
+    pthread_mutex_unlock(&lock);
+}
+
+bool intercore_receive_timeout_us(intercore_channel_t *channel, void *item, uint32_t timeout_us)
+{
+    // The condition variable waits on the wall clock
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    const uint64_t nsec = (uint64_t)deadline.tv_nsec + ((uint64_t)timeout_us * 1000u);
+    deadline.tv_sec += (time_t)(nsec / 1000000000u);
+    deadline.tv_nsec = (long)(nsec % 1000000000u);
+
+    pthread_mutex_lock(&lock);
+    bool timed_out = false;
+    while ((channel->tail == channel->head) && !timed_out)
+    {
+        timed_out = pthread_cond_timedwait(&changed, &lock, &deadline) != 0;
+    }
+    const bool received = channel->tail != channel->head;
+    if (received)
+    {
+        receive_locked(channel, item);
+    }
+    pthread_mutex_unlock(&lock);
+    return received;
+}
+
+uint32_t intercore_count(const intercore_channel_t *channel)
+{
+    pthread_mutex_lock(&lock);
+    const uint32_t count = channel->head - channel->tail;
+    pthread_mutex_unlock(&lock);
+    return count;
+}
+
+bool intercore_set_doorbell(intercore_channel_t *channel, intercore_doorbell_t handler, void *context)
+{
+    pthread_mutex_lock(&lock);
+    const bool set = ndoorbells < INTERCORE_MAX_DOORBELLS;
+    if (set)
+    {
+        doorbells[ndoorbells].handler = handler;
+        doorbells[ndoorbells].context = context;
+        channel->doorbell = (int8_t)ndoorbells;
+        ndoorbells++;
+    }
+    pthread_mutex_unlock(&lock);
+    return set;
+}
@@ -0,0 +1,21 @@
+/**
+ * @file panel.h
+ * @brief The simulated LCD panel that DEV_Config_host.c drives.
+ *
+ * Models just enough of the ST7789 to show what the firmware sent: the column and row
+ * address commands, memory access control (MADCTL), the pixel format (COLMOD: RGB565 or
+ * RGB444), vertical scrolling (VSCRDEF and VSCSAD), and memory writes. The visible area is
+ * everything the firmware has written, which is the whole panel once gfx_init() has cleared
+ * it. Pixels land where the address window and MADCTL put them in the frame memory, so frames
+ * come out as the glass shows them, upright for the panel (portrait) however it is mounted.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Write what the panel is showing to the given file as a binary PPM. Returns false if it couldn't. */
+bool panel_write_ppm(const char *path);
+
+/** Number of bytes the firmware has sent the panel so far. */
+uint64_t panel_bytes_received(void);
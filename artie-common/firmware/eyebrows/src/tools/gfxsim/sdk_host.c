@@ -0,0 +1,124 @@
+/**
+ * @file sdk_host.c
+ * @brief The Pico SDK stand-ins declared under include/, on top of POSIX.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+
+/** When the simulator started, so the clock reads small numbers like the board's does. */
+static uint64_t boot_us = 0;
+static pthread_once_t boot_once = PTHREAD_ONCE_INIT;
+
+static uint64_t clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void record_boot_time(void)
+{
+    boot_us = clock_us();
+}
+
+/** Microseconds since the simulator started. */
+static uint64_t monotonic_us(void)
+{
+    pthread_once(&boot_once, record_boot_time);
+    return clock_us() - boot_us;
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return monotonic_us();
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us)
+{
+    return t + us;
+}
+
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms)
+{
+    return t + (uint64_t)ms * 1000u;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+bool time_reached(absolute_time_t t)
+{
+    return get_absolute_time() >= t;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)monotonic_us();
+}
+
+uint64_t time_us_64(void)
+{
+    return monotonic_us();
+}
+
+void sleep_until(absolute_time_t t)
+{
+    const absolute_time_t now = get_absolute_time();
+    if (t > now)
+    {
+        sleep_us(t - now);
+    }
+}
+
+void sleep_us(uint64_t us)
+{
+    struct timespec ts = {.tv_sec = (time_t)(us / 1000000u), .tv_nsec = (long)(us % 1000000u) * 1000};
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        // Interrupted; sleep for whatever is left
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+/** Which core the calling thread stands in for. */
+static __thread uint core_num = 0;
+
+uint get_core_num(void)
+{
+    return core_num;
+}
+
+static void *core1_thread(void *arg)
+{
+    void (*entry)(void) = (void (*)(void))arg;
+    core_num = 1;
+    entry();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, core1_thread, (void *)entry) != 0)
+    {
+        fprintf(stderr, "Could not start core 1.\n");
+        exit(1);
+    }
+    pthread_detach(thread);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file errors_fake.c
+ * @brief errors.h for the host tests: set_errno() and log_error() are counted (see hosttest_errors),
+ * and everything is logged to stderr with -v. The error history is always empty, and a test can
+ * define its own of those functions in place of these.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <errors.h>
+#include "hosttest.h"
+
+hosttest_errors_t hosttest_errors;
+
+static void logging_internal(const char *level, const char *str, va_list args)
+{
+    if (hosttest_verbose)
+    {
+        fprintf(stderr, "[%s]: ", level);
+        vfprintf(stderr, str, args);
+    }
+}
+
+#define CALL_LOG_FUNCTION(level) do { \
+    va_list args; \
+    va_start(args, str); \
+    logging_internal(level, str, args); \
+    va_end(args); \
+} while (0)
+
+void log_debug(const char *str, ...)
+{
+    CALL_LOG_FUNCTION("DEBUG");
+}
+
+void log_info(const char *str, ...)
+{
+    CALL_LOG_FUNCTION("INFO");
+}
+
+void log_warning(const char *str, ...)
+{
+    CALL_LOG_FUNCTION("WARNING");
+}
+
+void log_error(const char *str, ...)
+{
+    hosttest_errors.nlogged_errors++;
+    CALL_LOG_FUNCTION("ERROR");
+}
+
+void log_flush(void)
+{
+    // Nothing is deferred
+}
+
+void set_errno(err_module_id_t module_id, err_t error)
+{
+    hosttest_errors.nerrno++;
+    hosttest_errors.last_module = (uint16_t)module_id;
+    hosttest_errors.last_error = (uint16_t)error;
+    if (hosttest_verbose)
+    {
+        fprintf(stderr, "[ERRNO]: 0x%02X from module with ID: 0x%02X\n", error & 0x00FF, (module_id & 0xFF00) >> 8);
+    }
+}
+
+__attribute__((weak)) uint32_t errors_get_count(err_module_id_t module_id)
+{
+    return 0;
+}
+
+__attribute__((weak)) bool errors_get_next(uint32_t *cursor, err_record_t *record, uint32_t *missed)
+{
+    return false;
+}
+
+__attribute__((weak)) size_t errors_pack(uint8_t *buf, size_t len)
+{
+    return 0;
+}
+
+__attribute__((weak)) size_t log_pack(uint8_t *buf, size_t len)
+{
+    return 0;
+}
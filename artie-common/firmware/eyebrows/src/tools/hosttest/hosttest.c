@@ -0,0 +1,262 @@
+/**
+ * @file hosttest.c
+ * @brief The harness's main(): runs the tests or the benchmarks each test program registers (see hosttest.h).
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hosttest.h"
+
+#ifndef HOSTTEST_COUNT_ALLOCS
+    /** Count heap calls, by wrapping them at link time (-Wl,--wrap=malloc and so on; see CMakeLists.txt). */
+    #define HOSTTEST_COUNT_ALLOCS 0
+#endif // HOSTTEST_COUNT_ALLOCS
+
+/** Most tests (or benchmarks) a program can have. */
+#define HOSTTEST_MAX_ENTRIES 128
+
+/** Each benchmark is timed for at least this long, and at least HOSTTEST_BENCH_MIN_BATCHES batches. */
+#define HOSTTEST_BENCH_MIN_NS (200u * 1000u * 1000u)
+#define HOSTTEST_BENCH_MIN_BATCHES 10u
+#define HOSTTEST_BENCH_MAX_BATCHES 100000u
+
+typedef struct {
+    const char *name;
+    hosttest_test_fn_t test;
+    hosttest_bench_fn_t bench;
+    uint32_t nops;
+} entry_t;
+
+static entry_t tests[HOSTTEST_MAX_ENTRIES];
+static size_t ntests = 0;
+static entry_t benches[HOSTTEST_MAX_ENTRIES];
+static size_t nbenches = 0;
+static hosttest_test_fn_t setup = NULL;
+
+/** Where results go. The firmware's own stdout goes to /dev/null unless -v. */
+static FILE *report = NULL;
+
+/** Failed checks in the test that's running. */
+static uint32_t failures = 0;
+
+static volatile uint64_t allocations = 0;
+
+volatile uint64_t hosttest_sink = 0;
+bool hosttest_verbose = false;
+
+#if HOSTTEST_COUNT_ALLOCS
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    allocations++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+#endif // HOSTTEST_COUNT_ALLOCS
+
+uint64_t hosttest_allocations(void)
+{
+    return allocations;
+}
+
+static void add_entry(entry_t *entries, size_t *nentries, entry_t entry)
+{
+    if (*nentries >= HOSTTEST_MAX_ENTRIES)
+    {
+        fprintf(stderr, "Too many tests; raise HOSTTEST_MAX_ENTRIES.\n");
+        exit(2);
+    }
+    entries[(*nentries)++] = entry;
+}
+
+void hosttest_register_test(const char *name, hosttest_test_fn_t fn)
+{
+    add_entry(tests, &ntests, (entry_t){ .name = name, .test = fn });
+}
+
+void hosttest_register_bench(const char *name, uint32_t nops, hosttest_bench_fn_t fn)
+{
+    add_entry(benches, &nbenches, (entry_t){ .name = name, .bench = fn, .nops = nops });
+}
+
+void hosttest_register_setup(hosttest_test_fn_t fn)
+{
+    setup = fn;
+}
+
+void hosttest_fail(const char *file, int line, const char *fmt, ...)
+{
+    failures++;
+    fprintf(report, "    %s:%d: ", file, line);
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(report, fmt, args);
+    va_end(args);
+    fprintf(report, "\n");
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/** Put the module under test back how it starts, and forget what the fakes saw. */
+static void reset(void)
+{
+    memset(&hosttest_errors, 0, sizeof(hosttest_errors));
+    if (setup != NULL)
+    {
+        setup();
+    }
+}
+
+static bool selected(const char *name, const char *filter)
+{
+    return (filter == NULL) || (strstr(name, filter) != NULL);
+}
+
+static int run_tests(const char *filter)
+{
+    uint32_t run = 0;
+    uint32_t failed = 0;
+    for (size_t i = 0; i < ntests; i++)
+    {
+        if (!selected(tests[i].name, filter))
+        {
+            continue;
+        }
+
+        failures = 0;
+        reset();
+        tests[i].test();
+        fflush(stdout);
+
+        run++;
+        failed += (failures > 0) ? 1 : 0;
+        fprintf(report, "%s %s\n", (failures > 0) ? "FAIL" : "ok  ", tests[i].name);
+    }
+
+    fprintf(report, "%u tests, %u failed\n", run, failed);
+    return (failed > 0) ? 1 : 0;
+}
+
+/** Time one benchmark, and print its row of the table. */
+static void run_bench(const entry_t *bench)
+{
+    reset();
+
+    // Once untimed, so first-use costs (the C library's buffers, cold caches) aren't counted
+    bench->bench(bench->nops);
+
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    uint64_t total_ns = 0;
+    uint32_t batches = 0;
+    const uint64_t allocs_before = allocations;
+    while (((total_ns < HOSTTEST_BENCH_MIN_NS) || (batches < HOSTTEST_BENCH_MIN_BATCHES)) && (batches < HOSTTEST_BENCH_MAX_BATCHES))
+    {
+        const uint64_t start = now_ns();
+        bench->bench(bench->nops);
+        const uint64_t elapsed = now_ns() - start;
+
+        min_ns = (elapsed < min_ns) ? elapsed : min_ns;
+        max_ns = (elapsed > max_ns) ? elapsed : max_ns;
+        total_ns += elapsed;
+        batches++;
+    }
+    const uint64_t allocs = allocations - allocs_before;
+    fflush(stdout);
+
+    const double nops = (double)bench->nops;
+    const double total_ops = nops * batches;
+    fprintf(report, "%s,%u,%u,%.2f,%.2f,%.2f,", bench->name, bench->nops, batches,
+            min_ns / nops, total_ns / total_ops, max_ns / nops);
+    if (HOSTTEST_COUNT_ALLOCS)
+    {
+        fprintf(report, "%.2f\n", allocs / total_ops);
+    }
+    else
+    {
+        fprintf(report, "-\n");
+    }
+}
+
+static int run_benches(const char *program, const char *filter)
+{
+    fprintf(report, "# %s begin: host count_allocs=%u\n", program, HOSTTEST_COUNT_ALLOCS);
+    fprintf(report, "name,param,iterations,min_ns,mean_ns,max_ns,allocs_per_op\n");
+    for (size_t i = 0; i < nbenches; i++)
+    {
+        if (selected(benches[i].name, filter))
+        {
+            run_bench(&benches[i]);
+        }
+    }
+    fprintf(report, "# %s end\n", program);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bool bench = false;
+    const char *filter = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            hosttest_verbose = true;
+        }
+        else if (strcmp(argv[i], "--bench") == 0)
+        {
+            bench = true;
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Usage: %s [-v] [--bench] [filter]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    // Keep our own copy of stdout for the results, and send the firmware's printing away
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    if (report == NULL)
+    {
+        perror("stdout");
+        return 2;
+    }
+    setvbuf(report, NULL, _IOLBF, 0);
+    if (!hosttest_verbose && (freopen("/dev/null", "w", stdout) == NULL))
+    {
+        perror("/dev/null");
+        return 2;
+    }
+
+    const char *program = strrchr(argv[0], '/');
+    program = (program == NULL) ? argv[0] : program + 1;
+    const int result = bench ? run_benches(program, filter) : run_tests(filter);
+    fclose(report);
+    return result;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file hosttest.h
+ * @brief A small unit test and microbenchmark harness for firmware logic built for the host.
+ *
+ * Each test program is one .c file that includes the module under test (its .c file, so its
+ * statics are in reach) and fakes whatever that module calls. Tests and benchmarks register
+ * themselves with TEST() and BENCH(), and hosttest.c's main() runs them:
+ *
+ *     test_servo              Run every test. Exits non-zero if any failed.
+ *     test_servo -v           The same, with the firmware's own logging and stdout shown.
+ *     test_servo --bench      Run every benchmark instead, and print the table (see below).
+ *     test_servo <filter>     Only the tests (or benchmarks) with <filter> in their names.
+ *
+ * The benchmark table is CSV between a "# <program> begin" and a "# <program> end" line, with the
+ * same first columns as the on-device benchmarks' (see bench/), so tools/gfxbench can compare two
+ * captures of it (with --bench <program>):
+ *
+ *     name,param,iterations,min_ns,mean_ns,max_ns,allocs_per_op
+ *
+ * where param is the operations in each timed batch, iterations the batches timed, the times are
+ * per operation, and allocs_per_op counts the heap calls (malloc, calloc, realloc) made by the code
+ * under test itself, not the C library's own.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** A test. Fails if any CHECK in it does. */
+typedef void (*hosttest_test_fn_t)(void);
+
+/** A benchmark: do `nops` operations. */
+typedef void (*hosttest_bench_fn_t)(uint32_t nops);
+
+void hosttest_register_test(const char *name, hosttest_test_fn_t fn);
+void hosttest_register_bench(const char *name, uint32_t nops, hosttest_bench_fn_t fn);
+
+/** Called before every test and benchmark, if the program defines one with HOSTTEST_SETUP(). */
+void hosttest_register_setup(hosttest_test_fn_t fn);
+
+/** Record a failed check. The test carries on, so one run shows every check that failed. */
+void hosttest_fail(const char *file, int line, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+/** Heap calls made by the code under test since the program started. */
+uint64_t hosttest_allocations(void);
+
+/** Keeps the compiler from throwing away results nobody reads. */
+extern volatile uint64_t hosttest_sink;
+
+/** Define a test. */
+#define TEST(name) \
+    static void test_##name(void); \
+    __attribute__((constructor)) static void register_test_##name(void) { hosttest_register_test(#name, test_##name); } \
+    static void test_##name(void)
+
+/** Define a benchmark that times `batch` operations at a time. The body does `nops` of them. */
+#define BENCH(name, batch) \
+    static void bench_##name(uint32_t nops); \
+    __attribute__((constructor)) static void register_bench_##name(void) { hosttest_register_bench(#name, (batch), bench_##name); } \
+    static void bench_##name(uint32_t nops)
+
+/** Define what puts the module under test back how it starts, before every test and benchmark. */
+#define HOSTTEST_SETUP() \
+    static void hosttest_setup(void); \
+    __attribute__((constructor)) static void register_setup(void) { hosttest_register_setup(hosttest_setup); } \
+    static void hosttest_setup(void)
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) \
+        { \
+            hosttest_fail(__FILE__, __LINE__, "%s", #expr); \
+        } \
+    } while (0)
+
+/** Check two integers are equal, printing both if they aren't. */
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const long long actual_ = (long long)(actual); \
+        const long long expected_ = (long long)(expected); \
+        if (actual_ != expected_) \
+        { \
+            hosttest_fail(__FILE__, __LINE__, "%s is %lld, expected %lld", #actual, actual_, expected_); \
+        } \
+    } while (0)
+
+/** Check two strings are equal. */
+#define CHECK_STR(actual, expected) \
+    do { \
+        const char *actual_ = (actual); \
+        const char *expected_ = (expected); \
+        if (strcmp(actual_, expected_) != 0) \
+        { \
+            hosttest_fail(__FILE__, __LINE__, "%s is \"%s\", expected \"%s\"", #actual, actual_, expected_); \
+        } \
+    } while (0)
+
+/** What the fake errors module (errors_fake.c) has seen since the last test started. */
+typedef struct {
+    uint32_t nerrno;            ///< set_errno() calls
+    uint16_t last_module;       ///< err_module_id_t of the last one
+    uint16_t last_error;        ///< err_t of the last one
+    uint32_t nlogged_errors;    ///< log_error() calls
+} hosttest_errors_t;
+
+extern hosttest_errors_t hosttest_errors;
+
+/** Is the firmware's logging shown (-v)? */
+extern bool hosttest_verbose;
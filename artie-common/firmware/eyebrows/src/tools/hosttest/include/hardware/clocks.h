@@ -0,0 +1,16 @@
+/**
+ * @file clocks.h
+ * @brief Host stand-in for hardware/clocks.h: the system clock runs at the SDK's usual 125 MHz.
+ */
+#pragma once
+
+#include <stdint.h>
+
+enum clock_index {
+    clk_sys = 5,
+};
+
+static inline uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    return 125u * 1000u * 1000u;
+}
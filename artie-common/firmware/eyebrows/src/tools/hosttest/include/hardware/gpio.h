@@ -0,0 +1,36 @@
+/**
+ * @file gpio.h
+ * @brief Host stand-in for hardware/gpio.h. There are no pins: writes go nowhere and reads are low.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** From pico/types.h, which the real one includes. */
+typedef unsigned int uint;
+
+#define GPIO_IN  false
+#define GPIO_OUT true
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW  = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL  = 0x4u,
+    GPIO_IRQ_EDGE_RISE  = 0x8u,
+};
+
+enum gpio_function {
+    GPIO_FUNC_SPI   = 1,
+    GPIO_FUNC_I2C   = 3,
+    GPIO_FUNC_PWM   = 4,
+    GPIO_FUNC_SIO   = 5,
+    GPIO_FUNC_NULL  = 0x1f,
+};
+
+static inline void gpio_init(uint gpio) {}
+static inline void gpio_set_dir(uint gpio, bool out) {}
+static inline void gpio_put(uint gpio, bool value) {}
+static inline bool gpio_get(uint gpio) { return false; }
+static inline void gpio_disable_pulls(uint gpio) {}
+static inline void gpio_set_function(uint gpio, enum gpio_function fn) {}
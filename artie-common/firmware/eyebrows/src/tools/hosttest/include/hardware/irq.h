@@ -0,0 +1,16 @@
+/**
+ * @file irq.h
+ * @brief Host stand-in for hardware/irq.h. Nothing interrupts a test: it calls the handlers itself.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void (*irq_handler_t)(void);
+
+#define PWM_IRQ_WRAP 4
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+static inline void irq_add_shared_handler(unsigned int num, irq_handler_t handler, uint8_t order_priority) {}
+static inline void irq_set_enabled(unsigned int num, bool enabled) {}
@@ -0,0 +1,41 @@
+/**
+ * @file pwm.h
+ * @brief Host stand-in for hardware/pwm.h. The slices don't count, and every slice always has its wrap
+ * pending, so a test steps a PWM wrap handler by calling it.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t csr;
+    uint32_t div;
+    uint32_t top;
+} pwm_config;
+
+/** The slices' registers, which nothing writes to. */
+typedef struct {
+    struct {
+        uint32_t csr;
+        uint32_t div;
+        uint32_t ctr;
+        uint32_t cc;
+        uint32_t top;
+    } slice[8];
+} pwm_hw_t;
+static pwm_hw_t pwm_hw_host;
+#define pwm_hw (&pwm_hw_host)
+
+static inline unsigned int pwm_gpio_to_slice_num(unsigned int gpio) { return (gpio >> 1u) & 7u; }
+static inline pwm_config pwm_get_default_config(void) { return (pwm_config){ 0, 1u << 4, 0xFFFFu }; }
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->top = wrap; }
+static inline void pwm_config_set_clkdiv_int_frac(pwm_config *c, uint8_t integer, uint8_t fract) { c->div = ((uint32_t)integer << 4) | fract; }
+static inline void pwm_init(unsigned int slice_num, pwm_config *c, bool start) {}
+static inline void pwm_set_clkdiv_int_frac(unsigned int slice_num, uint8_t integer, uint8_t fract) {}
+static inline void pwm_set_enabled(unsigned int slice_num, bool enabled) {}
+static inline uint16_t pwm_get_counter(unsigned int slice_num) { return 0; }
+static inline void pwm_set_gpio_level(unsigned int gpio, uint16_t level) {}
+static inline uint32_t pwm_get_irq_status_mask(void) { return 0xFFu; }
+static inline void pwm_clear_irq(unsigned int slice_num) {}
+static inline void pwm_set_irq_enabled(unsigned int slice_num, bool enabled) {}
@@ -0,0 +1,11 @@
+/**
+ * @file spi.h
+ * @brief Host stand-in for hardware/spi.h. Only the instances, for the pin configurations that name them;
+ * the tests fake the sensors' SPI layer above this.
+ */
+#pragma once
+
+typedef struct spi_inst spi_inst_t;
+
+#define spi0 ((spi_inst_t *)0)
+#define spi1 ((spi_inst_t *)1)
@@ -0,0 +1,11 @@
+/**
+ * @file sync.h
+ * @brief Host stand-in for hardware/sync.h: the simulator's barrier, event register, and spin lock
+ * (see tools/gfxsim/include), plus interrupts, which nothing raises in a test.
+ */
+#pragma once
+
+#include_next "hardware/sync.h"
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) {}
@@ -0,0 +1,15 @@
+/**
+ * @file watchdog.h
+ * @brief Host stand-in for hardware/watchdog.h: only the scratch registers, which keep state across a
+ * warm restart (see board/warmboot.h). Each test program gets its own.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t scratch[8];
+} watchdog_hw_t;
+
+static watchdog_hw_t hosttest_watchdog __attribute__((unused));
+#define watchdog_hw (&hosttest_watchdog)
@@ -0,0 +1,9 @@
+/**
+ * @file platform.h
+ * @brief Host stand-in for pico/platform.h. There is no flash to keep code out of.
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define __not_in_flash_func(f) f
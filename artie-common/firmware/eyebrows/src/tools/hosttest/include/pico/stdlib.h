@@ -0,0 +1,12 @@
+/**
+ * @file stdlib.h
+ * @brief Host stand-in for pico/stdlib.h: the simulator's (see tools/gfxsim/include), plus the GPIO
+ * and stdio calls the real one brings in, which the modules under test make at init.
+ */
+#pragma once
+
+#include_next "pico/stdlib.h"
+#include "hardware/gpio.h"
+
+/** Nothing to set up: stdout is already the terminal (or /dev/null; see hosttest.c). */
+static inline bool stdio_init_all(void) { return true; }
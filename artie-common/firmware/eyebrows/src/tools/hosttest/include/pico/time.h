@@ -0,0 +1,16 @@
+/**
+ * @file time.h
+ * @brief Host stand-in for pico/time.h: the simulator's clock (see tools/gfxsim/include), plus alarms and busy waits.
+ * Nothing fires an alarm on its own here. A test that wants one to run calls its callback itself.
+ */
+#pragma once
+
+#include_next "pico/time.h"
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+/** Defined by each test that needs it, so it can see what was scheduled. */
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+static inline void busy_wait_us(uint64_t us) { sleep_us(us); }
@@ -0,0 +1,326 @@
+/**
+ * @file test_bme280.c
+ * @brief Tests and benchmarks for the head sensors' BME280 driver (sensors/src/sensors/temp.c):
+ * reading the calibration, and compensating the raw temperature, pressure, and humidity.
+ *
+ * The integer compensation is checked against the example in Bosch's datasheet, and against
+ * the datasheet's floating-point formulas over the whole range of each reading.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hosttest.h"
+#include "sensors/temp.c"
+
+/** The sensor's registers, by address (with the read bit set, as they are all 0x80 and up). */
+static uint8_t registers[256];
+
+void myspi_blocking_read(uint8_t cs_pin, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        buf[i] = registers[(uint8_t)(reg + i)];
+    }
+}
+
+void myspi_blocking_write(uint8_t cs_pin, uint8_t reg, uint8_t byte)
+{
+    registers[reg | 0x80] = byte;
+}
+
+bool myspi_async_read(const myspi_transaction_t *transaction)
+{
+    myspi_blocking_read(transaction->cs_pin, transaction->reg, transaction->buf, transaction->len);
+    transaction->callback(transaction->ctx);
+    return true;
+}
+
+/** Calibration from the example in the datasheet (temperature and pressure), and typical humidity calibration. */
+static const comp_vals_t DATASHEET_CALIBRATION = {
+    .dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+    .dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024, .dig_P4 = 2855, .dig_P5 = 140,
+    .dig_P6 = -7, .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+    .dig_H1 = 75, .dig_H2 = 362, .dig_H3 = 0, .dig_H4 = 313, .dig_H5 = 50, .dig_H6 = 30,
+};
+
+/** The datasheet's example readings. */
+#define DATASHEET_ADC_T 519888
+#define DATASHEET_ADC_P 415148
+
+HOSTTEST_SETUP()
+{
+    memset(registers, 0, sizeof(registers));
+    compensation_values = DATASHEET_CALIBRATION;
+}
+
+/** The datasheet's floating-point temperature compensation, in degrees C. Sets *t_fine like the integer version. */
+static double reference_temp(int32_t adc_T, int32_t *t_fine)
+{
+    const comp_vals_t *c = &compensation_values;
+    const double var1 = (adc_T / 16384.0 - c->dig_T1 / 1024.0) * c->dig_T2;
+    const double var2 = ((adc_T / 131072.0 - c->dig_T1 / 8192.0) * (adc_T / 131072.0 - c->dig_T1 / 8192.0)) * c->dig_T3;
+    *t_fine = (int32_t)(var1 + var2);
+    return (var1 + var2) / 5120.0;
+}
+
+/** The datasheet's floating-point pressure compensation, in Pa, at the integer version's t_fine. */
+static double reference_pressure(int32_t adc_P)
+{
+    const comp_vals_t *c = &compensation_values;
+    double var1 = (c->t_fine / 2.0) - 64000.0;
+    double var2 = var1 * var1 * c->dig_P6 / 32768.0;
+    var2 = var2 + var1 * c->dig_P5 * 2.0;
+    var2 = (var2 / 4.0) + (c->dig_P4 * 65536.0);
+    var1 = (c->dig_P3 * var1 * var1 / 524288.0 + c->dig_P2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c->dig_P1;
+    if (var1 == 0.0)
+    {
+        return 0;
+    }
+    double p = 1048576.0 - adc_P;
+    p = (p - (var2 / 4096.0)) * 6250.0 / var1;
+    var1 = c->dig_P9 * p * p / 2147483648.0;
+    var2 = p * c->dig_P8 / 32768.0;
+    return p + (var1 + var2 + c->dig_P7) / 16.0;
+}
+
+/** The datasheet's floating-point humidity compensation, in %RH, at the integer version's t_fine. */
+static double reference_humidity(int32_t adc_H)
+{
+    const comp_vals_t *c = &compensation_values;
+    double h = c->t_fine - 76800.0;
+    h = (adc_H - (c->dig_H4 * 64.0 + c->dig_H5 / 16384.0 * h)) *
+        (c->dig_H2 / 65536.0 * (1.0 + c->dig_H6 / 67108864.0 * h * (1.0 + c->dig_H3 / 67108864.0 * h)));
+    h = h * (1.0 - c->dig_H1 * h / 524288.0);
+    return (h > 100.0) ? 100.0 : ((h < 0.0) ? 0.0 : h);
+}
+
+TEST(temperature_matches_datasheet_example)
+{
+    CHECK_EQ(compensate_temp(DATASHEET_ADC_T), 2508);
+    CHECK_EQ(compensation_values.t_fine, 128422);
+}
+
+TEST(pressure_matches_datasheet_example)
+{
+    compensate_temp(DATASHEET_ADC_T);
+    // 100653.25 Pa. The datasheet's floating-point version gets 100653.27.
+    CHECK_EQ(compensate_pressure(DATASHEET_ADC_P), 25767233);
+}
+
+TEST(temperature_matches_float_over_range)
+{
+    // The readings that mean -40 C to 85 C, and a little either side. The integer version drops the
+    // reading's low bits (it works in 8ths and 16ths of it), so it is up to 16 t_fine (and 0.8 of a
+    // hundredth of a degree, after rounding) off the float version.
+    for (int32_t adc_T = 300000; adc_T < 700000; adc_T += 7)
+    {
+        int32_t t_fine;
+        const double expected = reference_temp(adc_T, &t_fine) * 100.0;
+        const int32_t actual = compensate_temp(adc_T);
+        if ((abs(compensation_values.t_fine - t_fine) > 16) || (fabs(actual - expected) > 0.8))
+        {
+            hosttest_fail(__FILE__, __LINE__, "adc_T %d: %d (t_fine %d), expected %.2f (t_fine %d)",
+                          adc_T, actual, compensation_values.t_fine, expected, t_fine);
+            return;
+        }
+    }
+}
+
+TEST(pressure_matches_float_over_range)
+{
+    // From -40 C to 85 C, over the readings that mean 300 hPa to 1100 hPa there
+    for (int32_t adc_T = 350000; adc_T <= 650000; adc_T += 50000)
+    {
+        compensate_temp(adc_T);
+        for (int32_t adc_P = 200000; adc_P < 700000; adc_P += 331)
+        {
+            const double expected = reference_pressure(adc_P);
+            if ((expected < 30000.0) || (expected > 110000.0))
+            {
+                continue;
+            }
+            const double actual = compensate_pressure(adc_P) / 256.0;
+            if (fabs(actual - expected) > 0.1)
+            {
+                hosttest_fail(__FILE__, __LINE__, "adc_T %d adc_P %d: %.3f Pa, expected %.3f", adc_T, adc_P, actual, expected);
+                return;
+            }
+        }
+    }
+}
+
+TEST(humidity_matches_float_over_range)
+{
+    for (int32_t adc_T = 350000; adc_T <= 650000; adc_T += 50000)
+    {
+        compensate_temp(adc_T);
+        for (int32_t adc_H = 0; adc_H < (1 << 16); adc_H += 7)
+        {
+            const double expected = reference_humidity(adc_H);
+            const double actual = compensate_humidity(adc_H) / 1024.0;
+            if (fabs(actual - expected) > 0.01)
+            {
+                hosttest_fail(__FILE__, __LINE__, "adc_T %d adc_H %d: %.4f %%RH, expected %.4f", adc_T, adc_H, actual, expected);
+                return;
+            }
+        }
+    }
+}
+
+TEST(humidity_is_clamped)
+{
+    compensate_temp(DATASHEET_ADC_T);
+    CHECK_EQ(compensate_humidity(0), 0);
+    CHECK_EQ(compensate_humidity(0xFFFF), 100 * 1024);
+}
+
+TEST(readings_are_monotonic)
+{
+    int32_t last_temp = INT32_MIN;
+    for (int32_t adc_T = 300000; adc_T < 700000; adc_T += 13)
+    {
+        const int32_t temp = compensate_temp(adc_T);
+        CHECK(temp >= last_temp);
+        last_temp = temp;
+    }
+
+    // A higher ADC reading is a lower pressure
+    compensate_temp(DATASHEET_ADC_T);
+    uint32_t last_pressure = UINT32_MAX;
+    for (int32_t adc_P = 200000; adc_P < 700000; adc_P += 13)
+    {
+        const uint32_t pressure = compensate_pressure(adc_P);
+        CHECK(pressure <= last_pressure);
+        last_pressure = pressure;
+    }
+
+    uint32_t last_humidity = 0;
+    for (int32_t adc_H = 0; adc_H < (1 << 16); adc_H++)
+    {
+        const uint32_t humidity = compensate_humidity(adc_H);
+        CHECK(humidity >= last_humidity);
+        last_humidity = humidity;
+    }
+}
+
+TEST(pressure_guards_divide_by_zero)
+{
+    compensation_values.dig_P1 = 0;
+    compensate_temp(DATASHEET_ADC_T);
+    CHECK_EQ(compensate_pressure(DATASHEET_ADC_P), 0);
+}
+
+/** Put a little-endian 16-bit calibration value in the register map. */
+static void put_u16(uint8_t reg, uint16_t value)
+{
+    registers[reg] = (uint8_t)(value & 0xFF);
+    registers[reg + 1] = (uint8_t)(value >> 8);
+}
+
+TEST(calibration_is_read_from_registers)
+{
+    const comp_vals_t *c = &DATASHEET_CALIBRATION;
+    const uint16_t words[12] = {
+        c->dig_T1, (uint16_t)c->dig_T2, (uint16_t)c->dig_T3,
+        c->dig_P1, (uint16_t)c->dig_P2, (uint16_t)c->dig_P3, (uint16_t)c->dig_P4, (uint16_t)c->dig_P5,
+        (uint16_t)c->dig_P6, (uint16_t)c->dig_P7, (uint16_t)c->dig_P8, (uint16_t)c->dig_P9,
+    };
+    for (uint8_t i = 0; i < 12; i++)
+    {
+        put_u16((uint8_t)(0x88 + 2 * i), words[i]);
+    }
+
+    // The humidity calibration is spread over 0xA1 and 0xE1 to 0xE7, with H4 and H5 sharing 0xE5's nibbles
+    registers[0xA0] = 0x5A;
+    registers[0xA1] = c->dig_H1;
+    put_u16(0xE1, (uint16_t)c->dig_H2);
+    registers[0xE3] = c->dig_H3;
+    registers[0xE4] = (uint8_t)(c->dig_H4 >> 4);
+    registers[0xE5] = (uint8_t)((c->dig_H4 & 0x0F) | ((c->dig_H5 & 0x0F) << 4));
+    registers[0xE6] = (uint8_t)(c->dig_H5 >> 4);
+    registers[0xE7] = (uint8_t)c->dig_H6;
+    registers[0xE8] = 0xA5;
+
+    memset(&compensation_values, 0, sizeof(compensation_values));
+    read_compensation_parameters();
+
+    CHECK_EQ(compensation_values.dig_T1, c->dig_T1);
+    CHECK_EQ(compensation_values.dig_T2, c->dig_T2);
+    CHECK_EQ(compensation_values.dig_T3, c->dig_T3);
+    CHECK_EQ(compensation_values.dig_P1, c->dig_P1);
+    CHECK_EQ(compensation_values.dig_P2, c->dig_P2);
+    CHECK_EQ(compensation_values.dig_P3, c->dig_P3);
+    CHECK_EQ(compensation_values.dig_P4, c->dig_P4);
+    CHECK_EQ(compensation_values.dig_P5, c->dig_P5);
+    CHECK_EQ(compensation_values.dig_P6, c->dig_P6);
+    CHECK_EQ(compensation_values.dig_P7, c->dig_P7);
+    CHECK_EQ(compensation_values.dig_P8, c->dig_P8);
+    CHECK_EQ(compensation_values.dig_P9, c->dig_P9);
+    CHECK_EQ(compensation_values.dig_H1, c->dig_H1);
+    CHECK_EQ(compensation_values.dig_H2, c->dig_H2);
+    CHECK_EQ(compensation_values.dig_H3, c->dig_H3);
+    CHECK_EQ(compensation_values.dig_H4, c->dig_H4);
+    CHECK_EQ(compensation_values.dig_H5, c->dig_H5);
+    CHECK_EQ(compensation_values.dig_H6, c->dig_H6);
+}
+
+TEST(data_registers_are_decoded)
+{
+    // Pressure and temperature are 20 bits (msb, lsb, xlsb's high nibble), humidity 16
+    const uint8_t burst[8] = {
+        (uint8_t)(DATASHEET_ADC_P >> 12), (uint8_t)(DATASHEET_ADC_P >> 4), (uint8_t)((DATASHEET_ADC_P & 0x0F) << 4),
+        (uint8_t)(DATASHEET_ADC_T >> 12), (uint8_t)(DATASHEET_ADC_T >> 4), (uint8_t)((DATASHEET_ADC_T & 0x0F) << 4),
+        0x80, 0x00,
+    };
+    memcpy(&registers[BME280_REG_PRESS], burst, sizeof(burst));
+
+    temp_sensor_values_t values;
+    temp_read(&values);
+    CHECK_EQ(values.temperature_centi_c, 2508);
+    CHECK_EQ(values.pressure_pa_q24_8, 25767233);
+    CHECK_EQ(values.humidity_percent_rh_q22_10, compensate_humidity(0x8000));
+}
+
+BENCH(compensate_temp, 256)
+{
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        acc += compensate_temp((int32_t)(400000 + (i * 997)));
+    }
+    hosttest_sink += (uint64_t)acc;
+}
+
+BENCH(compensate_pressure, 256)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        acc += compensate_pressure((int32_t)(300000 + (i * 1499)));
+    }
+    hosttest_sink += acc;
+}
+
+BENCH(compensate_humidity, 256)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        acc += compensate_humidity((int32_t)((i * 251) & 0xFFFF));
+    }
+    hosttest_sink += acc;
+}
+
+BENCH(decode_values, 256)
+{
+    uint8_t burst[8] = { 0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x80, 0x00 };
+    temp_sensor_values_t values;
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        burst[1] = (uint8_t)i;
+        burst[4] = (uint8_t)(i * 7);
+        decode_values(burst, &values);
+        hosttest_sink += values.pressure_pa_q24_8;
+    }
+}
@@ -0,0 +1,290 @@
+/**
+ * @file test_eyebrowsgfx.c
+ * @brief Tests and benchmarks for graphics/eyebrowsgfx.c: decoding draw commands (and vertex heights)
+ * into an eyebrow, on either side, and describing the eyebrow for the log; and the LCD's idle sleep,
+ * which its render loop waits in.
+ */
+#include <pthread.h>
+#include <string.h>
+#include "hosttest.h"
+#include "graphics/eyebrowsgfx.c"
+
+HOSTTEST_SETUP()
+{
+    eyebrow_state.left = VERTEX_POS_MIDDLE;
+    eyebrow_state.middle = VERTEX_POS_MIDDLE;
+    eyebrow_state.right = VERTEX_POS_MIDDLE;
+    eyebrow_state_pending = false;
+    eyebrow_is_fixed = true;
+    left_or_right_side = EYE_LEFT_SIDE;
+}
+
+/**
+ * What a draw command's six bits mean, worked out bit by bit from the schema in eyebrowsgfx.h:
+ * for vertex pair i (left, middle, right, as the left eyebrow sees them), bit 3 + i set is MIDDLE,
+ * otherwise bit i set is HIGH, and neither is LOW. Both set isn't a draw. The right eyebrow is a
+ * mirror image. Returns false if it isn't a draw.
+ */
+static bool reference_decode(uint8_t param, side_t side, eyebrow_t *out)
+{
+    vertex_pos_t pos[3];
+    for (int i = 0; i < 3; i++)
+    {
+        const bool middle = (param >> (3 + i)) & 1;
+        const bool high = (param >> i) & 1;
+        if (middle && high)
+        {
+            return false;
+        }
+        pos[i] = middle ? VERTEX_POS_MIDDLE : (high ? VERTEX_POS_HIGH : VERTEX_POS_LOW);
+    }
+
+    const bool mirrored = (side == EYE_RIGHT_SIDE);
+    out->left = mirrored ? pos[2] : pos[0];
+    out->middle = pos[1];
+    out->right = mirrored ? pos[0] : pos[2];
+    return true;
+}
+
+/** Draw every command on one side, and check each against the reference. */
+static void check_side(side_t side)
+{
+    left_or_right_side = side;
+    uint32_t ndraws = 0;
+    for (uint8_t param = 0; param < 64; param++)
+    {
+        // Start from something no draw leaves behind, so a rejected one shows up as unchanged
+        const eyebrow_t before = { VERTEX_POS_MIDDLE, VERTEX_POS_HIGH, VERTEX_POS_MIDDLE };
+        eyebrow_state = before;
+        eyebrow_state_pending = false;
+        const uint32_t nerrno = hosttest_errors.nerrno;
+
+        draw((cmd_t)(CMD_MODULE_ID_LCD | param));
+
+        eyebrow_t expected;
+        if (!reference_decode(param, side, &expected))
+        {
+            CHECK_EQ(hosttest_errors.nerrno, nerrno + 1);
+            CHECK_EQ(hosttest_errors.last_error, EINVAL);
+            CHECK_EQ(hosttest_errors.last_module, ERR_ID_GRAPHICS_MODULE);
+            CHECK(memcmp(&eyebrow_state, &before, sizeof(before)) == 0);
+            CHECK(!eyebrow_state_pending);
+            continue;
+        }
+
+        ndraws++;
+        CHECK_EQ(hosttest_errors.nerrno, nerrno);
+        CHECK(eyebrow_state_pending);
+        if ((eyebrow_state.left != expected.left) || (eyebrow_state.middle != expected.middle) || (eyebrow_state.right != expected.right))
+        {
+            hosttest_fail(__FILE__, __LINE__, "side %d param 0x%02X: eyebrow %d %d %d, expected %d %d %d", side, param,
+                          eyebrow_state.left, eyebrow_state.middle, eyebrow_state.right, expected.left, expected.middle, expected.right);
+        }
+    }
+
+    // Each pair has three positions
+    CHECK_EQ(ndraws, 27);
+}
+
+TEST(draw_decodes_left_eyebrow)
+{
+    check_side(EYE_LEFT_SIDE);
+}
+
+TEST(draw_decodes_right_eyebrow)
+{
+    check_side(EYE_RIGHT_SIDE);
+}
+
+TEST(draw_reaches_every_eyebrow)
+{
+    bool seen[NUM_EYEBROW_STATES] = { false };
+    for (uint8_t param = 0; param < 64; param++)
+    {
+        eyebrow_t expected;
+        if (reference_decode(param, EYE_LEFT_SIDE, &expected))
+        {
+            draw((cmd_t)(CMD_MODULE_ID_LCD | param));
+            seen[faceshapes_eyebrow_index(&eyebrow_state)] = true;
+        }
+    }
+    for (size_t i = 0; i < NUM_EYEBROW_STATES; i++)
+    {
+        CHECK(seen[i]);
+    }
+}
+
+TEST(draw_sets_fixed_offsets)
+{
+    eyebrow_is_fixed = false;
+    draw((cmd_t)(CMD_MODULE_ID_LCD | 0x0C));    // Left middle, middle low, right high
+    CHECK(eyebrow_is_fixed);
+    CHECK_EQ(eyebrow_offsets[0], faceshapes_vertex_y_offset(VERTEX_POS_MIDDLE));
+    CHECK_EQ(eyebrow_offsets[1], faceshapes_vertex_y_offset(VERTEX_POS_LOW));
+    CHECK_EQ(eyebrow_offsets[2], faceshapes_vertex_y_offset(VERTEX_POS_HIGH));
+}
+
+TEST(vertex_heights_span_low_to_high_in_sub_pixel_steps)
+{
+    CHECK_EQ(faceshapes_vertex_height_offset(0), faceshapes_vertex_y_offset(VERTEX_POS_LOW));
+    CHECK_EQ(faceshapes_vertex_height_offset(EYEBROW_VERTEX_HEIGHT_MAX), faceshapes_vertex_y_offset(VERTEX_POS_HIGH));
+    CHECK_EQ(faceshapes_vertex_height_offset(0xFF), faceshapes_vertex_y_offset(VERTEX_POS_HIGH));
+    for (uint8_t height = 1; height <= EYEBROW_VERTEX_HEIGHT_MAX; height++)
+    {
+        // Each step up moves the pair up, by no more than a pixel
+        const UWORD below = faceshapes_vertex_height_offset(height - 1);
+        const UWORD here = faceshapes_vertex_height_offset(height);
+        CHECK(here < below);
+        CHECK(below - here <= PAINT_SUBPIXELS);
+    }
+}
+
+TEST(draw_vertices_places_each_pair)
+{
+    // Low, a little under the middle, and high, with the module ID still on one of them
+    const uint32_t args = 0x00 | ((CMD_MODULE_ID_LCD | 31) << 8) | (EYEBROW_VERTEX_HEIGHT_MAX << 16);
+    draw_vertices(args);
+    CHECK(!eyebrow_is_fixed);
+    CHECK(eyebrow_state_pending);
+    CHECK_EQ(eyebrow_offsets[0], faceshapes_vertex_height_offset(0));
+    CHECK_EQ(eyebrow_offsets[1], faceshapes_vertex_height_offset(31));
+    CHECK_EQ(eyebrow_offsets[2], faceshapes_vertex_height_offset(EYEBROW_VERTEX_HEIGHT_MAX));
+
+    // The right eyebrow is a mirror image
+    left_or_right_side = EYE_RIGHT_SIDE;
+    draw_vertices(args);
+    CHECK_EQ(eyebrow_offsets[0], faceshapes_vertex_height_offset(EYEBROW_VERTEX_HEIGHT_MAX));
+    CHECK_EQ(eyebrow_offsets[1], faceshapes_vertex_height_offset(31));
+    CHECK_EQ(eyebrow_offsets[2], faceshapes_vertex_height_offset(0));
+}
+
+TEST(frame_end_drops_unfinished_draw_vertices)
+{
+    intercore_channel_init(&inter_core_queue, inter_core_items, sizeof(cmd_t), INTER_CORE_QUEUE_SIZE);
+    latest_draw = 0;
+    expression = 0;
+    const uint32_t nerrno = hosttest_errors.nerrno;
+
+    // The frame ends one byte into its three
+    eyebrowsgfx_cmd(CMD_LCD_DRAW_VERTICES);
+    eyebrowsgfx_cmd((cmd_t)(CMD_MODULE_ID_LCD | 31));
+    eyebrowsgfx_frame_end();
+    CHECK(!collecting_args);
+    CHECK_EQ(hosttest_errors.nerrno, nerrno + 1);
+    CHECK_EQ(hosttest_errors.last_error, EINVAL);
+    CHECK_EQ(hosttest_errors.last_module, ERR_ID_GRAPHICS_MODULE);
+    CHECK_EQ(latest_draw, 0);
+
+    // So the next frame's draw is drawn, rather than taken for the rest of them
+    const cmd_t draw_cmd = (cmd_t)(CMD_MODULE_ID_LCD | 0x0C);
+    eyebrowsgfx_cmd(draw_cmd);
+    eyebrowsgfx_frame_end();
+    CHECK_EQ(latest_draw, draw_cmd);
+    CHECK_EQ(eyebrowsgfx_expression(), draw_cmd);
+    CHECK_EQ(hosttest_errors.nerrno, nerrno + 1);
+}
+
+TEST(eyebrow_state_to_strbuf_names_each_pair)
+{
+    static const char *NAMES[3] = { " LOW", " MID", " HIGH" };
+    for (int left = 0; left < 3; left++)
+    {
+        for (int middle = 0; middle < 3; middle++)
+        {
+            for (int right = 0; right < 3; right++)
+            {
+                eyebrow_state.left = (vertex_pos_t)left;
+                eyebrow_state.middle = (vertex_pos_t)middle;
+                eyebrow_state.right = (vertex_pos_t)right;
+
+                char expected[32];
+                snprintf(expected, sizeof(expected), "%s%s%s", NAMES[left], NAMES[middle], NAMES[right]);
+                char buf[32];
+                memset(buf, 'x', sizeof(buf));
+                eyebrow_state_to_strbuf(sizeof(buf), buf);
+                CHECK_STR(buf, expected);
+            }
+        }
+    }
+}
+
+TEST(eyebrow_state_to_strbuf_longest_fits)
+{
+    eyebrow_state.left = VERTEX_POS_HIGH;
+    eyebrow_state.middle = VERTEX_POS_HIGH;
+    eyebrow_state.right = VERTEX_POS_HIGH;
+    char buf[16];
+    eyebrow_state_to_strbuf(sizeof(buf), buf);
+    CHECK_STR(buf, " HIGH HIGH HIGH");
+}
+
+/** Send a command on the channel after 20 ms, from another thread, as the main core would. */
+static void *send_later(void *channel)
+{
+    sleep_ms(20);
+    const cmd_t command = CMD_LCD_DRAW_VERTICES;
+    intercore_try_send((intercore_channel_t *)channel, &command);
+    return NULL;
+}
+
+TEST(idle_receive_sleeps_the_lcd_until_a_command)
+{
+    LCD_Panel_Init(&LCD_1IN14_PANEL, HORIZONTAL);
+    cmd_t storage[4];
+    intercore_channel_t channel;
+    intercore_channel_init(&channel, storage, sizeof(cmd_t), 4);
+    gfx_idle_stats_t before;
+    gfx_idle_stats(&before);
+    gfx_idle_update();
+
+    // A command that's already waiting is taken without sleeping
+    gfx_set_idle_sleep(1000);
+    const cmd_t waiting = CMD_LCD_OFF;
+    cmd_t command = 0;
+    intercore_try_send(&channel, &waiting);
+    gfx_idle_receive(&channel, &command);
+    CHECK_EQ(command, CMD_LCD_OFF);
+    CHECK(!gfx_idle_update());
+
+    // Nothing for 1 ms: the LCD sleeps, and the command that comes later wakes it
+    gfx_set_idle_sleep(1);
+    pthread_t sender;
+    pthread_create(&sender, NULL, &send_later, &channel);
+    gfx_idle_receive(&channel, &command);
+    pthread_join(sender, NULL);
+    CHECK_EQ(command, CMD_LCD_DRAW_VERTICES);
+    CHECK(gfx_idle_update());
+
+    // Its frame going out is the end of the wake, once
+    gfx_flush_rest();
+    CHECK(gfx_idle_update());
+    gfx_flush_rest();
+    CHECK(!gfx_idle_update());
+    gfx_idle_stats_t after;
+    gfx_idle_stats(&after);
+    CHECK_EQ(after.sleeps, before.sleeps + 1);
+    CHECK(after.worst_wake_us >= after.last_wake_us);
+
+    gfx_set_idle_sleep(0);
+}
+
+BENCH(draw, 64)
+{
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        draw((cmd_t)(CMD_MODULE_ID_LCD | (i & 0x3F)));
+    }
+    hosttest_sink += eyebrow_state.left;
+}
+
+BENCH(eyebrow_state_to_strbuf, 64)
+{
+    char buf[32];
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        eyebrow_state.left = (vertex_pos_t)(i % 3);
+        eyebrow_state.right = (vertex_pos_t)((i / 3) % 3);
+        eyebrow_state_to_strbuf(sizeof(buf), buf);
+        hosttest_sink += (uint8_t)buf[2];
+    }
+}
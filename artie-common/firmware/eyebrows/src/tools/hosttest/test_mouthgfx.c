@@ -0,0 +1,60 @@
+/**
+ * @file test_mouthgfx.c
+ * @brief Tests for graphics/mouthgfx.c: collecting the bytes that follow a viseme or parametric
+ * mouth command, and dropping one whose bytes don't all come in its frame.
+ */
+#include <string.h>
+#include "hosttest.h"
+#include "graphics/mouthgfx.c"
+
+HOSTTEST_SETUP()
+{
+    // Only the main core's side: what it queues for the graphics core is left in the queue to check
+    intercore_channel_init(&inter_core_queue, inter_core_items, sizeof(mouth_work_t), INTER_CORE_QUEUE_SIZE);
+    args_wanted = 0;
+    expression = 0;
+}
+
+/** Take the next work item the main core queued. Returns false if there is none. */
+static bool take_work(mouth_work_t *work)
+{
+    return intercore_try_receive(&inter_core_queue, work);
+}
+
+TEST(viseme_waits_for_its_hold_byte)
+{
+    mouthgfx_cmd((cmd_t)(CMD_LCD_MOUTH_VISEME | 3));
+    mouth_work_t work;
+    CHECK(!take_work(&work));
+
+    mouthgfx_cmd((cmd_t)(CMD_MODULE_ID_LCD | 5));
+    mouthgfx_frame_end();
+    CHECK(take_work(&work));
+    CHECK_EQ(work.command, CMD_LCD_MOUTH_VISEME | 3);
+    CHECK_EQ(work.args[0], 5);
+    CHECK(!take_work(&work));
+}
+
+TEST(frame_end_drops_viseme_missing_its_hold_byte)
+{
+    const uint32_t nerrno = hosttest_errors.nerrno;
+
+    // The frame ends before the hold byte
+    mouthgfx_cmd((cmd_t)(CMD_LCD_MOUTH_VISEME | 3));
+    mouthgfx_frame_end();
+    CHECK_EQ(args_wanted, 0);
+    CHECK_EQ(hosttest_errors.nerrno, nerrno + 1);
+    CHECK_EQ(hosttest_errors.last_error, EINVAL);
+    CHECK_EQ(hosttest_errors.last_module, ERR_ID_GRAPHICS_MODULE);
+    mouth_work_t work;
+    CHECK(!take_work(&work));
+
+    // So the next frame's command is acted on, rather than taken for the hold
+    mouthgfx_cmd(CMD_LCD_MOUTH_SMILE);
+    mouthgfx_frame_end();
+    CHECK(take_work(&work));
+    CHECK_EQ(work.command, CMD_LCD_MOUTH_SMILE);
+    CHECK(!take_work(&work));
+    CHECK_EQ(mouthgfx_expression(), CMD_LCD_MOUTH_SMILE);
+    CHECK_EQ(hosttest_errors.nerrno, nerrno + 1);
+}
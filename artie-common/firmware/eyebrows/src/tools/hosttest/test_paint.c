@@ -0,0 +1,229 @@
+/**
+ * @file test_paint.c
+ * @brief Tests and benchmarks for the graphics library's GUI_Paint.c: drawing sprites, flipped,
+ * scaled, and turned, into the whole image and into bands, against a floating point reference.
+ */
+#include <math.h>
+#include <string.h>
+#include "hosttest.h"
+#include "GUI/GUI_Paint.c"
+
+#define IMAGE_W 48
+#define IMAGE_H 40
+
+/** RGB565, as Paint_SetScale(65) keeps it (byte swapped). */
+static UBYTE image[IMAGE_W * IMAGE_H * 2];
+
+/** A 5 x 3 1 bpp sprite, one byte a row (stride 8), with no two rows or columns alike. */
+static const UBYTE ARROW_DATA[] = {
+    0xC0,   // XX...
+    0xE8,   // XXX.X
+    0x10,   // ...X.
+};
+static const PAINT_SPRITE ARROW = {ARROW_DATA, 5, 3, 3, PAINT_SPRITE_1BPP, 0};
+
+HOSTTEST_SETUP()
+{
+    Paint_NewImage(image, IMAGE_W, IMAGE_H, ROTATE_0, WHITE);
+    Paint_SetScale(65);
+    Paint_Clear(WHITE);
+    Paint_ResetDirty();
+}
+
+static UWORD pixel(int x, int y)
+{
+    const UBYTE *p = image + 2 * (x + y * IMAGE_W);
+    return (UWORD)((p[0] << 8) | p[1]);
+}
+
+static bool texel_set(const PAINT_SPRITE *sprite, int u, int v)
+{
+    const int index = u + (v << sprite->StrideBits);
+    return (sprite->Data[index >> 3] << (index & 7)) & 0x80;
+}
+
+/** Check the sprite is at (x0, y0) to (x0 + w, y0 + h), with texel (u, v) at texel(i, j), and nothing else was touched. */
+static void check_placed(const PAINT_SPRITE *sprite, int x0, int y0, int w, int h, void (*texel)(int i, int j, int *u, int *v))
+{
+    for (int y = 0; y < IMAGE_H; y++)
+    {
+        for (int x = 0; x < IMAGE_W; x++)
+        {
+            UWORD expected = WHITE;
+            if (x >= x0 && x < x0 + w && y >= y0 && y < y0 + h)
+            {
+                int u, v;
+                texel(x - x0, y - y0, &u, &v);
+                expected = texel_set(sprite, u, v) ? RED : WHITE;
+            }
+            if (pixel(x, y) != expected)
+            {
+                hosttest_fail(__FILE__, __LINE__, "(%d, %d) is %04x, not %04x", x, y, pixel(x, y), expected);
+                return;
+            }
+        }
+    }
+}
+
+static void as_is(int i, int j, int *u, int *v) { *u = i; *v = j; }
+static void flipped_x(int i, int j, int *u, int *v) { *u = ARROW.Width - 1 - i; *v = j; }
+static void flipped_y(int i, int j, int *u, int *v) { *u = i; *v = ARROW.Height - 1 - j; }
+static void turned_90(int i, int j, int *u, int *v) { *u = j; *v = ARROW.Height - 1 - i; }
+static void doubled(int i, int j, int *u, int *v) { *u = i / 2; *v = j / 2; }
+
+TEST(sprite_at_its_own_size_is_copied)
+{
+    const PAINT_SPRITE_XFORM xform = {20, 10, PAINT_SPRITE_SCALE_ONE, 0, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    // The centre texel (2, 1) lands on (20, 10)
+    check_placed(&ARROW, 18, 9, 5, 3, as_is);
+
+    // Only the pixels set are dirty
+    PAINT_RECT dirty;
+    CHECK(Paint_GetDirty(&dirty));
+    CHECK_EQ(dirty.Xstart, 18);
+    CHECK_EQ(dirty.Ystart, 9);
+    CHECK_EQ(dirty.Xend, 23);
+    CHECK_EQ(dirty.Yend, 12);
+}
+
+TEST(sprite_flips)
+{
+    PAINT_SPRITE_XFORM xform = {20, 10, PAINT_SPRITE_SCALE_ONE, 0, PAINT_SPRITE_FLIP_X};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    check_placed(&ARROW, 18, 9, 5, 3, flipped_x);
+
+    Paint_Clear(WHITE);
+    xform.Flip = PAINT_SPRITE_FLIP_Y;
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    check_placed(&ARROW, 18, 9, 5, 3, flipped_y);
+}
+
+TEST(sprite_turns_clockwise)
+{
+    const PAINT_SPRITE_XFORM xform = {20, 10, PAINT_SPRITE_SCALE_ONE, 90, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    // Three wide and five high, with the top row down the right hand side
+    check_placed(&ARROW, 19, 8, 3, 5, turned_90);
+}
+
+TEST(sprite_scales)
+{
+    const PAINT_SPRITE_XFORM xform = {20, 10, 2 * PAINT_SPRITE_SCALE_ONE, 0, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    check_placed(&ARROW, 15, 7, 10, 6, doubled);
+}
+
+TEST(rgb565_sprite_leaves_its_key_alone)
+{
+    // Little-endian texels, rows of 2 (stride 2)
+    const UBYTE data[] = {0x00, 0xF8, 0x1F, 0x00, 0xE0, 0x07, 0xFF, 0xFF};
+    const PAINT_SPRITE sprite = {data, 2, 2, 1, PAINT_SPRITE_RGB565, WHITE};
+    const PAINT_SPRITE_XFORM xform = {10, 10, PAINT_SPRITE_SCALE_ONE, 0, 0};
+    Paint_Clear(BLACK);
+    Paint_DrawSprite(&sprite, &xform, 0);
+    CHECK_EQ(pixel(9, 9), RED);
+    CHECK_EQ(pixel(10, 9), BLUE);
+    CHECK_EQ(pixel(9, 10), GREEN);
+    CHECK_EQ(pixel(10, 10), BLACK);
+}
+
+TEST(sprite_is_clipped_to_the_image)
+{
+    const PAINT_SPRITE_XFORM xform = {0, 0, 4 * PAINT_SPRITE_SCALE_ONE, 30, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    const PAINT_SPRITE_XFORM far = {IMAGE_W + 5, IMAGE_H - 1, 4 * PAINT_SPRITE_SCALE_ONE, 200, PAINT_SPRITE_FLIP_X};
+    Paint_DrawSprite(&ARROW, &far, RED);
+    PAINT_RECT dirty;
+    CHECK(Paint_GetDirty(&dirty));
+    CHECK(dirty.Xend <= IMAGE_W);
+    CHECK(dirty.Yend <= IMAGE_H);
+}
+
+/** Every pixel Paint_DrawSprite() would paint, worked out in floating point. Returns false if one lies too near a texel's edge to say. */
+static bool reference_covers(const PAINT_SPRITE *sprite, const PAINT_SPRITE_XFORM *xform, int x, int y, bool *set)
+{
+    const double angle = xform->Angle * M_PI / 180.0;
+    const double scale = (double)xform->Scale / PAINT_SPRITE_SCALE_ONE;
+    const double dx = x + 0.5 - xform->X - ((sprite->Width & 1) ? 0.5 : 0.0);
+    const double dy = y + 0.5 - xform->Y - ((sprite->Height & 1) ? 0.5 : 0.0);
+    double u = (dx * cos(angle) + dy * sin(angle)) / scale;
+    double v = (-dx * sin(angle) + dy * cos(angle)) / scale;
+    u = (xform->Flip & PAINT_SPRITE_FLIP_X) ? -u : u;
+    v = (xform->Flip & PAINT_SPRITE_FLIP_Y) ? -v : v;
+    u += sprite->Width / 2.0;
+    v += sprite->Height / 2.0;
+    if (fabs(u - round(u)) < 0.01 || fabs(v - round(v)) < 0.01)
+    {
+        return false;
+    }
+    *set = (u >= 0) && (u < sprite->Width) && (v >= 0) && (v < sprite->Height) && texel_set(sprite, (int)u, (int)v);
+    return true;
+}
+
+TEST(turned_and_scaled_sprite_matches_reference)
+{
+    const int angles[] = {0, 17, 45, 90, 133, 180, 251, 300};
+    const UWORD scales[] = {PAINT_SPRITE_SCALE_ONE / 2, PAINT_SPRITE_SCALE_ONE, 700, 4 * PAINT_SPRITE_SCALE_ONE};
+    for (size_t a = 0; a < sizeof(angles) / sizeof(angles[0]); a++)
+    {
+        for (size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); s++)
+        {
+            const PAINT_SPRITE_XFORM xform = {23, 19, scales[s], angles[a], (UBYTE)(a & 3)};
+            Paint_Clear(WHITE);
+            Paint_DrawSprite(&ARROW, &xform, RED);
+            for (int y = 0; y < IMAGE_H; y++)
+            {
+                for (int x = 0; x < IMAGE_W; x++)
+                {
+                    bool set;
+                    if (reference_covers(&ARROW, &xform, x, y, &set) && ((pixel(x, y) == RED) != set))
+                    {
+                        hosttest_fail(__FILE__, __LINE__, "angle %d scale %u: (%d, %d) should be %s", xform.Angle,
+                                      xform.Scale, x, y, set ? "set" : "clear");
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(sprite_drawn_in_bands_matches_whole_image)
+{
+    const PAINT_SPRITE_XFORM xform = {24, 20, 5 * PAINT_SPRITE_SCALE_ONE, 33, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    UBYTE whole[sizeof(image)];
+    memcpy(whole, image, sizeof(image));
+
+    const UWORD band_rows = 7;
+    UBYTE band[IMAGE_W * 2 * 7];
+    for (UWORD y = 0; y < IMAGE_H; y += band_rows)
+    {
+        Paint_SelectBand(band, y, y + band_rows);
+        Paint_Clear(WHITE);
+        Paint_DrawSprite(&ARROW, &xform, RED);
+        const UWORD rows = (y + band_rows > IMAGE_H) ? IMAGE_H - y : band_rows;
+        CHECK(memcmp(band, whole + y * IMAGE_W * 2, rows * IMAGE_W * 2) == 0);
+    }
+}
+
+TEST(sprite_follows_paint_rotation)
+{
+    // With the paint code doing the turning, a sprite turned back the other way comes out as it is
+    Paint_SetRotate(ROTATE_90);
+    const PAINT_SPRITE_XFORM xform = {10, 20, PAINT_SPRITE_SCALE_ONE, 270, 0};
+    Paint_DrawSprite(&ARROW, &xform, RED);
+    // Logical (10, 20) is memory (IMAGE_W - 1 - 20, 10)
+    check_placed(&ARROW, IMAGE_W - 1 - 20 - 2, 10 - 1, 5, 3, as_is);
+}
+
+BENCH(draw_sprite_turned, 16)
+{
+    const PAINT_SPRITE_XFORM xform = {24, 20, 6 * PAINT_SPRITE_SCALE_ONE, 37, 0};
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        Paint_DrawSprite(&ARROW, &xform, RED);
+    }
+    hosttest_sink += image[0];
+}
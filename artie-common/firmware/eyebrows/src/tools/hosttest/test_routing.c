@@ -0,0 +1,520 @@
+/**
+ * @file test_routing.c
+ * @brief Tests and benchmarks for the command routing in main.c: which handler each command byte
+ * reaches, the order the lanes are dispatched in, and the frames that aren't plain commands
+ * (sequence uploads and settings).
+ *
+ * Every module main.c calls into is faked here, and records the calls that say which handler ran.
+ */
+#include <setjmp.h>
+#include <string.h>
+#include "hosttest.h"
+
+#define main eyebrows_main
+#include "main.c"
+#undef main
+
+/** The calls that tell the handlers apart. */
+typedef enum {
+    CALL_LEDS_ON,
+    CALL_LEDS_OFF,
+    CALL_LEDS_HEARTBEAT,
+    CALL_SEQUENCE_STOP,
+    CALL_SEQUENCE_PLAY,             // arg: sequence ID
+    CALL_SEQUENCE_DEFINE,           // arg: sequence ID
+    CALL_RESTART,
+    CALL_TRACE_PACK,
+    CALL_TRACE_DUMP,
+    CALL_ERRORS_PACK,
+    CALL_LOG_PACK,
+    CALL_ARENA_PACK,
+    CALL_STACKMON_PACK,
+    CALL_REGISTER,                  // arg: bytes loaded into the read register
+    CALL_GRAPHICS_CMD,              // arg: command
+    CALL_GRAPHICS_EXPRESSION,
+    CALL_SERVO_DURATION,            // arg: duration index
+    CALL_SERVO_STATUS,
+    CALL_SERVO_CMD,                 // arg: command
+    CALL_SETTINGS_GET,              // arg: key
+    CALL_SETTINGS_SET,              // arg: key
+} call_kind_t;
+
+typedef struct {
+    call_kind_t kind;
+    uint32_t arg;
+} call_t;
+
+/** Calls since the last reset_calls(). Only the first MAX_CALLS are kept, but all are counted. */
+#define MAX_CALLS 512
+static call_t calls[MAX_CALLS];
+static size_t ncalls = 0;
+
+/** What the last sequence_define() and settings_set() were given, and metrics_count() was last told. */
+static uint8_t defined_steps[CMDS_FRAME_MAX_LEN];
+static size_t defined_len = 0;
+static bool defined_append = false;
+static uint32_t set_value = 0;
+static uint32_t counted_commands = 0;
+
+/** What the last cmds_set_register_bytes() loaded. */
+static uint8_t register_bytes[CMDS_REGISTER_MAX_LEN];
+
+/** Where warmboot_restart() goes instead of restarting. */
+static jmp_buf restart_jmp;
+
+static void record(call_kind_t kind, uint32_t arg)
+{
+    if (ncalls < MAX_CALLS)
+    {
+        calls[ncalls] = (call_t){ kind, arg };
+    }
+    ncalls++;
+}
+
+static void reset_calls(void)
+{
+    ncalls = 0;
+    counted_commands = 0;
+    hosttest_errors.nlogged_errors = 0;
+}
+
+// The modules main.c calls
+
+void leds_init(uint led_pin) {}
+void leds_on(void) { record(CALL_LEDS_ON, 0); }
+void leds_off(void) { record(CALL_LEDS_OFF, 0); }
+void leds_heartbeat(void) { record(CALL_LEDS_HEARTBEAT, 0); }
+void leds_report_error(err_module_id_t module_id, err_t error) {}
+
+void sequence_init(void) {}
+void sequence_play(uint8_t id) { record(CALL_SEQUENCE_PLAY, id); }
+void sequence_stop(void) { record(CALL_SEQUENCE_STOP, 0); }
+size_t sequence_get_due(uint8_t *buf, size_t bufsize) { return 0; }
+
+void sequence_define(uint8_t id, const uint8_t *steps, size_t len, bool append)
+{
+    record(CALL_SEQUENCE_DEFINE, id);
+    memcpy(defined_steps, steps, len);
+    defined_len = len;
+    defined_append = append;
+}
+
+void warmboot_init(void) {}
+bool warmboot_is_warm(void) { return false; }
+bool warmboot_get(warmboot_slot_t slot, uint32_t *value) { return false; }
+
+void warmboot_restart(void)
+{
+    record(CALL_RESTART, 0);
+    longjmp(restart_jmp, 1);
+}
+
+void trace_init(void) {}
+void trace_probes_init(const unsigned int pins[NUM_TRACE_PROBES]) {}
+void trace_dump(void) { record(CALL_TRACE_DUMP, 0); }
+
+/** The pack functions all give a one-byte report: a count of nothing. */
+static size_t pack_nothing(call_kind_t kind, uint8_t *buf)
+{
+    record(kind, 0);
+    buf[0] = 0;
+    return 1;
+}
+
+size_t trace_pack(uint8_t *buf, size_t len) { return pack_nothing(CALL_TRACE_PACK, buf); }
+size_t errors_pack(uint8_t *buf, size_t len) { return pack_nothing(CALL_ERRORS_PACK, buf); }
+size_t log_pack(uint8_t *buf, size_t len) { return pack_nothing(CALL_LOG_PACK, buf); }
+size_t arena_pack(uint8_t *buf, size_t len) { return pack_nothing(CALL_ARENA_PACK, buf); }
+void stackmon_init(void) {}
+size_t stackmon_pack(uint8_t *buf, size_t len) { return pack_nothing(CALL_STACKMON_PACK, buf); }
+
+void metrics_count(metrics_count_t id, uint32_t n)
+{
+    if (id == METRICS_COUNT_COMMANDS)
+    {
+        counted_commands += n;
+    }
+}
+
+void metrics_level(metrics_level_t id, uint32_t value) {}
+void metrics_idle_begin(void) {}
+void metrics_idle_end(void) {}
+bool metrics_update(void) { return false; }
+size_t metrics_pack(uint8_t *buf, size_t len) { return 0; }
+
+void settings_init(void) {}
+
+/** Key 1 is set (to 0x12345678). Nothing else is. */
+bool settings_get(uint16_t key, uint32_t *value)
+{
+    record(CALL_SETTINGS_GET, key);
+    if (key == 1)
+    {
+        *value = 0x12345678;
+        return true;
+    }
+    return false;
+}
+
+uint32_t settings_get_or(uint16_t key, uint32_t fallback)
+{
+    uint32_t value;
+    return settings_get(key, &value) ? value : fallback;
+}
+
+bool settings_set(uint16_t key, uint32_t value)
+{
+    record(CALL_SETTINGS_SET, key);
+    set_value = value;
+    return true;
+}
+
+bool sysclock_set(uint32_t mhz) { return true; }
+void sysclock_deep_sleep_init(void) {}
+
+bist_result_t bist_run(bist_check_t check, bist_measure_t measure, void *context, uint32_t limit) { return BIST_PASS; }
+bool bist_update(void) { return false; }
+size_t bist_pack(uint8_t *buf, size_t len) { return 0; }
+
+void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin, cmds_i2c_speed_t speed) {}
+bool cmds_measure_isr_latency(uint32_t *cycles) { return false; }
+void cmds_accept_general_call(bool accept) {}
+void cmds_wait_for_next(void) {}
+void cmds_get_stats(cmds_stats_t *stats) { memset(stats, 0, sizeof(*stats)); }
+size_t cmds_get_next_frame(uint8_t *buf, size_t bufsize) { return 0; }
+void cmds_register_write(uint8_t address, const uint8_t *bytes, size_t len) {}
+void cmds_register_write_u16(uint8_t address, uint16_t value) {}
+
+void cmds_set_register_bytes(const uint8_t *bytes, size_t len)
+{
+    record(CALL_REGISTER, (uint32_t)len);
+    memcpy(register_bytes, bytes, (len < sizeof(register_bytes)) ? len : sizeof(register_bytes));
+}
+
+void graphics_init(side_t side) {}
+void graphics_resume(side_t side, cmd_t shown) {}
+void graphics_set_idle_sleep(uint32_t ms) {}
+bool graphics_idle_update(void) { return false; }
+bool graphics_assist(void) { return false; }
+size_t graphics_idle_pack(uint8_t *buf, size_t len) { return 0; }
+void graphics_cmd(cmd_t command) { record(CALL_GRAPHICS_CMD, command); }
+void graphics_frame_end(void) {}
+cmd_t graphics_expression(void) { record(CALL_GRAPHICS_EXPRESSION, 0); return 0; }
+
+void servo_init(void) {}
+void servo_process(void) {}
+void servo_report_status(void) { record(CALL_SERVO_STATUS, 0); }
+void servo_set_move_duration(uint8_t index) { record(CALL_SERVO_DURATION, index); }
+void servo_cmd(cmd_t command) { record(CALL_SERVO_CMD, command); }
+
+// The reference
+
+/** A command byte's handler, as calls, and its lane. No calls is an unknown command. */
+typedef struct {
+    call_t calls[2];
+    size_t ncalls;
+    lane_t lane;
+} route_t;
+
+/**
+ * Where a command byte should go, worked out from the command codes in board/types.h rather than
+ * from the table in main.c: the LED route (0x00 to 0x3F) is shared by the LEDs, sequences, tracing,
+ * errors, settings, the theme, and the servo's duration and status; the LCD route (0x40 to 0x7F)
+ * is all graphics; and the servo route (0x80 to 0xBF) is all turns. Frame headers (0xC0 and up)
+ * never reach dispatch, and sequence uploads and settings only do at the start of a frame.
+ */
+static route_t reference_route(uint8_t command)
+{
+    route_t r = { .ncalls = 0, .lane = LANE_LED };
+    const uint8_t route = command & 0xC0;
+    if (route == CMD_MODULE_ID_LCD)
+    {
+        r.calls[r.ncalls++] = (call_t){ CALL_GRAPHICS_CMD, command };
+        r.calls[r.ncalls++] = (call_t){ CALL_GRAPHICS_EXPRESSION, 0 };
+        r.lane = LANE_LCD;
+        return r;
+    }
+    if (route == CMD_MODULE_ID_SERVO)
+    {
+        r.calls[r.ncalls++] = (call_t){ CALL_SERVO_CMD, command };
+        r.lane = LANE_SERVO;
+        return r;
+    }
+    if (route != CMD_MODULE_ID_LEDS)
+    {
+        return r;
+    }
+
+    if ((command & 0xF8) == CMD_SEQUENCE_PLAY)
+    {
+        r.calls[r.ncalls++] = (call_t){ CALL_SEQUENCE_PLAY, command & 0x07 };
+    }
+    else if ((command & 0xFC) == CMD_LCD_SET_THEME)
+    {
+        r.calls[r.ncalls++] = (call_t){ CALL_GRAPHICS_CMD, command };
+        r.lane = LANE_LCD;
+    }
+    else if ((command & 0xF8) == CMD_SERVO_SET_DURATION)
+    {
+        r.calls[r.ncalls++] = (call_t){ CALL_SERVO_DURATION, command & 0x07 };
+        r.lane = LANE_SERVO;
+    }
+    else
+    {
+        switch (command)
+        {
+            case CMD_LED_ON:                r.calls[r.ncalls++] = (call_t){ CALL_LEDS_ON, 0 }; break;
+            case CMD_LED_OFF:               r.calls[r.ncalls++] = (call_t){ CALL_LEDS_OFF, 0 }; break;
+            case CMD_LED_HEARTBEAT:         r.calls[r.ncalls++] = (call_t){ CALL_LEDS_HEARTBEAT, 0 }; break;
+            case CMD_SEQUENCE_STOP:         r.calls[r.ncalls++] = (call_t){ CALL_SEQUENCE_STOP, 0 }; break;
+            case CMD_RESTART:               r.calls[r.ncalls++] = (call_t){ CALL_RESTART, 0 }; break;
+            case CMD_DUMP_TRACE:            r.calls[r.ncalls++] = (call_t){ CALL_TRACE_DUMP, 0 }; break;
+            case CMD_QUERY_TRACE:
+                r.calls[r.ncalls++] = (call_t){ CALL_TRACE_PACK, 0 };
+                r.calls[r.ncalls++] = (call_t){ CALL_REGISTER, 1 };
+                break;
+            case CMD_QUERY_ERRORS:
+                r.calls[r.ncalls++] = (call_t){ CALL_ERRORS_PACK, 0 };
+                r.calls[r.ncalls++] = (call_t){ CALL_REGISTER, 1 };
+                break;
+            case CMD_QUERY_LOG:
+                r.calls[r.ncalls++] = (call_t){ CALL_LOG_PACK, 0 };
+                r.calls[r.ncalls++] = (call_t){ CALL_REGISTER, 1 };
+                break;
+            case CMD_QUERY_MEMORY:
+                r.calls[r.ncalls++] = (call_t){ CALL_ARENA_PACK, 0 };
+                r.calls[r.ncalls++] = (call_t){ CALL_REGISTER, 1 };
+                break;
+            case CMD_QUERY_STACKS:
+                r.calls[r.ncalls++] = (call_t){ CALL_STACKMON_PACK, 0 };
+                r.calls[r.ncalls++] = (call_t){ CALL_REGISTER, 1 };
+                break;
+            case CMD_QUERY_SERVO_STATUS:
+                r.calls[r.ncalls++] = (call_t){ CALL_SERVO_STATUS, 0 };
+                r.lane = LANE_SERVO;
+                break;
+            default:
+                break;
+        }
+    }
+    return r;
+}
+
+/** Check the calls recorded since reset_calls() are `expected`. */
+static void check_calls(const call_t *expected, size_t nexpected, const char *what)
+{
+    if (ncalls != nexpected)
+    {
+        hosttest_fail(__FILE__, __LINE__, "%s: %zu calls, expected %zu", what, ncalls, nexpected);
+        return;
+    }
+    for (size_t i = 0; i < nexpected; i++)
+    {
+        if ((calls[i].kind != expected[i].kind) || (calls[i].arg != expected[i].arg))
+        {
+            hosttest_fail(__FILE__, __LINE__, "%s: call %zu is %d(0x%X), expected %d(0x%X)", what, i,
+                          calls[i].kind, calls[i].arg, expected[i].kind, expected[i].arg);
+            return;
+        }
+    }
+}
+
+/** A deterministic stream of bytes, for making up frames. */
+static uint32_t next_random(uint32_t *state)
+{
+    *state = (*state * 1664525u) + 1013904223u;
+    return *state >> 24;
+}
+
+HOSTTEST_SETUP()
+{
+    reset_calls();
+    defined_len = 0;
+    defined_append = false;
+    set_value = 0;
+    memset(register_bytes, 0, sizeof(register_bytes));
+}
+
+TEST(every_command_byte_routes)
+{
+    // Volatile, since a restart longjmp()s back into the loop
+    for (volatile uint32_t command = 0; command < CMDS_TABLE_LEN; command++)
+    {
+        const uint8_t byte = (uint8_t)command;
+        const route_t expected = reference_route(byte);
+        char what[32];
+        snprintf(what, sizeof(what), "command 0x%02X", byte);
+
+        reset_calls();
+        if (setjmp(restart_jmp) == 0)
+        {
+            dispatch_cmds(&byte, 1);
+        }
+
+        check_calls(expected.calls, expected.ncalls, what);
+        CHECK_EQ(counted_commands, 1);
+        if (expected.ncalls == 0)
+        {
+            // Unknown: said so, and nothing else
+            CHECK_EQ(hosttest_errors.nlogged_errors, 1);
+        }
+        CHECK_EQ(COMMANDS[byte].lane, expected.lane);
+    }
+}
+
+TEST(lanes_dispatch_in_order)
+{
+    // Every command there is a handler for, bar the restart
+    uint8_t known[CMDS_TABLE_LEN];
+    size_t nknown = 0;
+    for (uint32_t command = 0; command < CMDS_TABLE_LEN; command++)
+    {
+        if ((reference_route((uint8_t)command).ncalls > 0) && (command != CMD_RESTART))
+        {
+            known[nknown++] = (uint8_t)command;
+        }
+    }
+
+    uint32_t state = 1;
+    for (uint32_t frame = 0; frame < 2000; frame++)
+    {
+        uint8_t commands[CMDS_FRAME_MAX_LEN];
+        const size_t ncommands = 1 + (next_random(&state) % CMDS_FRAME_MAX_LEN);
+        for (size_t i = 0; i < ncommands; i++)
+        {
+            commands[i] = known[((next_random(&state) << 8) | next_random(&state)) % nknown];
+        }
+
+        // Servo, then LED, then LCD, each in the order they came
+        call_t expected[2 * CMDS_FRAME_MAX_LEN];
+        size_t nexpected = 0;
+        for (lane_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            for (size_t i = 0; i < ncommands; i++)
+            {
+                const route_t r = reference_route(commands[i]);
+                if (r.lane == lane)
+                {
+                    memcpy(&expected[nexpected], r.calls, r.ncalls * sizeof(call_t));
+                    nexpected += r.ncalls;
+                }
+            }
+        }
+
+        reset_calls();
+        dispatch_frame(commands, ncommands);
+        char what[32];
+        snprintf(what, sizeof(what), "frame %u", frame);
+        check_calls(expected, nexpected, what);
+        CHECK_EQ(counted_commands, ncommands);
+        CHECK_EQ(hosttest_errors.nlogged_errors, 0);
+    }
+}
+
+TEST(empty_frame_does_nothing)
+{
+    dispatch_frame(NULL, 0);
+    CHECK_EQ(ncalls, 0);
+    CHECK_EQ(counted_commands, 0);
+}
+
+TEST(sequence_define_takes_the_frame)
+{
+    const uint8_t frame[] = { CMD_SEQUENCE_DEFINE | 3, CMD_LED_ON, CMD_MODULE_ID_LCD | 0x15, CMD_SETTING_SET };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_SEQUENCE_DEFINE, 3 } };
+    check_calls(expected, 1, "define");
+    CHECK_EQ(defined_len, 3);
+    CHECK(memcmp(defined_steps, &frame[1], 3) == 0);
+    CHECK(!defined_append);
+    CHECK_EQ(counted_commands, 0);
+}
+
+TEST(sequence_append_takes_the_frame)
+{
+    const uint8_t frame[] = { CMD_SEQUENCE_APPEND | 7, CMD_MODULE_ID_SERVO | 0x10 };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_SEQUENCE_DEFINE, 7 } };
+    check_calls(expected, 1, "append");
+    CHECK_EQ(defined_len, 1);
+    CHECK_EQ(defined_steps[0], CMD_MODULE_ID_SERVO | 0x10);
+    CHECK(defined_append);
+}
+
+TEST(sequence_define_only_starts_a_frame)
+{
+    const uint8_t frame[] = { CMD_LED_ON, CMD_SEQUENCE_DEFINE | 1, CMD_LED_OFF };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_LEDS_ON, 0 }, { CALL_LEDS_OFF, 0 } };
+    check_calls(expected, 2, "define mid-frame");
+    CHECK_EQ(hosttest_errors.nlogged_errors, 1);
+}
+
+TEST(setting_get_reports_value)
+{
+    const uint8_t frame[] = { CMD_SETTING_GET, 0x01, 0x00 };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_SETTINGS_GET, 1 }, { CALL_REGISTER, 5 } };
+    check_calls(expected, 2, "get");
+    const uint8_t report[5] = { 1, 0x78, 0x56, 0x34, 0x12 };
+    CHECK(memcmp(register_bytes, report, sizeof(report)) == 0);
+}
+
+TEST(setting_get_reports_unset)
+{
+    const uint8_t frame[] = { CMD_SETTING_GET, 0x34, 0x12 };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_SETTINGS_GET, 0x1234 }, { CALL_REGISTER, 5 } };
+    check_calls(expected, 2, "get unset");
+    const uint8_t report[5] = { 0, 0, 0, 0, 0 };
+    CHECK(memcmp(register_bytes, report, sizeof(report)) == 0);
+}
+
+TEST(setting_set_saves_value)
+{
+    const uint8_t frame[] = { CMD_SETTING_SET, 0x02, 0x00, 0x11, 0x22, 0x33, 0x44 };
+    dispatch_frame(frame, sizeof(frame));
+    const call_t expected[] = { { CALL_SETTINGS_SET, 2 } };
+    check_calls(expected, 1, "set");
+    CHECK_EQ(set_value, 0x44332211);
+    CHECK_EQ(hosttest_errors.nerrno, 0);
+}
+
+TEST(setting_commands_check_length)
+{
+    const uint8_t short_set[] = { CMD_SETTING_SET, 0x02, 0x00, 0x11, 0x22, 0x33 };
+    dispatch_frame(short_set, sizeof(short_set));
+    const uint8_t long_get[] = { CMD_SETTING_GET, 0x01, 0x00, 0x00 };
+    dispatch_frame(long_get, sizeof(long_get));
+
+    CHECK_EQ(ncalls, 0);
+    CHECK_EQ(hosttest_errors.nerrno, 2);
+    CHECK_EQ(hosttest_errors.last_module, ERR_ID_CMD_MODULE);
+    CHECK_EQ(hosttest_errors.last_error, EINVAL);
+}
+
+/** A frame of the kind the controller sends: a duration and a turn, an expression, and an LED change. */
+static const uint8_t TYPICAL_FRAME[] = {
+    CMD_MODULE_ID_LCD | 0x15, CMD_SERVO_SET_DURATION | 3, CMD_MODULE_ID_SERVO | 0x20, CMD_LED_HEARTBEAT,
+};
+
+BENCH(dispatch_cmds, 64)
+{
+    for (uint32_t i = 0; i < nops; i += sizeof(TYPICAL_FRAME))
+    {
+        ncalls = 0;
+        dispatch_cmds(TYPICAL_FRAME, sizeof(TYPICAL_FRAME));
+    }
+    hosttest_sink += ncalls;
+}
+
+BENCH(dispatch_frame_setting_get, 64)
+{
+    const uint8_t frame[] = { CMD_SETTING_GET, 0x01, 0x00 };
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        ncalls = 0;
+        dispatch_frame(frame, sizeof(frame));
+    }
+    hosttest_sink += register_bytes[1];
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_servo.c
+ * @brief Tests and benchmarks for servo/servo.c: the command curve, the safe range, and the moves.
+ */
+#include <math.h>
+#include <string.h>
+#include "hosttest.h"
+#include "servo/servo.c"
+
+/** The settings store, the limit switches, and the warm restart state are all empty, the clock never changes, and the self test passes. */
+bool settings_get(uint16_t key, uint32_t *value)
+{
+    return false;
+}
+
+bool settings_set(uint16_t key, uint32_t value)
+{
+    return true;
+}
+
+bool warmboot_get(warmboot_slot_t slot, uint32_t *value)
+{
+    return false;
+}
+
+bool gpioirq_add(uint gpio, uint32_t events, uint32_t debounce_us, gpioirq_handler_t handler, void *context)
+{
+    return true;
+}
+
+void cmds_set_register_bytes(const uint8_t *bytes, size_t len)
+{
+}
+
+bool sysclock_register(sysclock_hook_t hook, void *context)
+{
+    return true;
+}
+
+bist_result_t bist_run(bist_check_t check, bist_measure_t measure, void *context, uint32_t limit)
+{
+    return BIST_PASS;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return 1;
+}
+
+HOSTTEST_SETUP()
+{
+    calibration_status = SERVO_CALIBRATION_DONE;
+    last_known_safe_left = NOMINAL_FAR_LEFT_US;
+    last_known_safe_right = NOMINAL_FAR_RIGHT_US;
+    rebuild_command_widths();
+    memset((void *)&move, 0, sizeof(move));
+    current_pulse_us = NOMINAL_MIDDLE_US;
+    move_duration_ms = 0;
+}
+
+/** The pulse width for a command parameter, worked out the long way: y = (1/65,000) * (x - 31)^3 + 1.5 ms, in the nominal range. */
+static uint16_t reference_width_us(uint8_t param)
+{
+    const double x = (double)param - 31.0;
+    const double us = lround((1.5384e-05 * x * x * x + 1.5) * 1000.0);
+    return (uint16_t)((us < 1000.0) ? 1000.0 : ((us > 2000.0) ? 2000.0 : us));
+}
+
+/** Step the move in progress to its end. Returns how many PWM periods it took, and checks each step is within the limits. */
+static uint32_t finish_move(void)
+{
+    uint32_t ticks = 0;
+    uint16_t last = current_pulse_us;
+    while (move.active && (ticks < 100000))
+    {
+        servo_on_pwm_wrap();
+        const uint32_t step = (current_pulse_us > last) ? (uint32_t)(current_pulse_us - last) : (uint32_t)(last - current_pulse_us);
+        // Peak speed, rounded up, and a us either way for the rounding of each step
+        CHECK(step <= ((MAX_SPEED_US16_PER_TICK + 15U) / 16U) + 1U);
+        last = current_pulse_us;
+        ticks++;
+    }
+    CHECK(!move.active);
+    return ticks;
+}
+
+TEST(command_curve_matches_formula)
+{
+    CHECK_EQ(command_widths[31], 1500);
+    CHECK_EQ(command_widths[0], 1042);
+    CHECK_EQ(command_widths[63], 2000);
+    for (uint8_t param = 0; param < N_SERVO_PARAMS; param++)
+    {
+        CHECK_EQ(command_widths[param], reference_width_us(param));
+    }
+}
+
+TEST(command_curve_is_monotonic)
+{
+    for (uint8_t param = 1; param < N_SERVO_PARAMS; param++)
+    {
+        CHECK(command_widths[param] >= command_widths[param - 1]);
+    }
+}
+
+TEST(command_widths_clamp_to_safe_range)
+{
+    last_known_safe_left = 1200;
+    last_known_safe_right = 1800;
+    rebuild_command_widths();
+    for (uint8_t param = 0; param < N_SERVO_PARAMS; param++)
+    {
+        const uint16_t expected = reference_width_us(param);
+        CHECK_EQ(command_widths[param], (expected < 1200) ? 1200 : ((expected > 1800) ? 1800 : expected));
+    }
+
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 0));
+    finish_move();
+    CHECK_EQ(current_pulse_us, 1200);
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 63));
+    finish_move();
+    CHECK_EQ(current_pulse_us, 1800);
+}
+
+TEST(every_command_lands_on_target)
+{
+    for (uint8_t param = 0; param < N_SERVO_PARAMS; param++)
+    {
+        servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | param));
+        finish_move();
+        CHECK_EQ(current_pulse_us, reference_width_us(param));
+    }
+}
+
+TEST(move_to_same_place_does_nothing)
+{
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 31));
+    CHECK(!move.active);
+    CHECK_EQ(current_pulse_us, 1500);
+}
+
+TEST(move_duration_stretches_moves)
+{
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 40));
+    const uint32_t fastest = finish_move();
+
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 31));
+    finish_move();
+    servo_set_move_duration(7);
+    CHECK_EQ(move_duration_ms, 1000);
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 40));
+    const uint32_t slow = finish_move();
+
+    CHECK(fastest < slow);
+    CHECK_EQ(slow, 1000 / PWM_PERIOD_MS);
+    CHECK_EQ(current_pulse_us, reference_width_us(40));
+}
+
+TEST(commands_refused_while_calibrating)
+{
+    calibration_status = SERVO_CALIBRATION_SEEKING_LEFT;
+    servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | 0));
+    CHECK(!move.active);
+    CHECK_EQ(current_pulse_us, 1500);
+    CHECK_EQ(hosttest_errors.nerrno, 1);
+    CHECK_EQ(hosttest_errors.last_module, ERR_ID_SERVO_MODULE);
+    CHECK_EQ(hosttest_errors.last_error, EBUSY);
+}
+
+BENCH(servo_cmd, 64)
+{
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        // Alternate ends, so every command starts a move
+        servo_cmd((cmd_t)(CMD_MODULE_ID_SERVO | ((i & 1) ? (i & 0x3F) : (0x3F - (i & 0x3F)))));
+    }
+    hosttest_sink += move.nticks;
+}
+
+BENCH(servo_on_pwm_wrap, 1024)
+{
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        if (!move.active)
+        {
+            start_move((current_pulse_us < NOMINAL_MIDDLE_US) ? NOMINAL_FAR_RIGHT_US : NOMINAL_FAR_LEFT_US);
+        }
+        servo_on_pwm_wrap();
+    }
+    hosttest_sink += current_pulse_us;
+}
+
+BENCH(rebuild_command_widths, 16)
+{
+    for (uint32_t i = 0; i < nops; i++)
+    {
+        rebuild_command_widths();
+    }
+    hosttest_sink += command_widths[(nops - 1) & 0x3F];
+}
@@ -0,0 +1,141 @@
+"""
+Convert a monochrome image into a run-length encoded PAINT_RLE_IMAGE
+(see GUI_Paint.h) that can be compiled into the firmware and drawn
+with Paint_DrawImageRLE() or streamed with gfx_send_rle_image().
+
+Takes PBM files (P1 or P4), which any image editor or ImageMagick
+(`convert in.png -threshold 50% out.pbm`) can produce. Black pixels
+become foreground.
+
+Usage: python rleimage.py <input.pbm> <c identifier> [-o output.c]
+"""
+import argparse
+import re
+import sys
+
+_SKIP = re.compile(rb"\s*(#[^\n]*\n\s*)*")
+_TOKEN = re.compile(rb"\S+")
+
+def _tokens(data: bytes):
+    """
+    Yield the whitespace-separated header tokens of a PBM file, skipping comments,
+    followed by the byte offset just past the last one we consumed.
+    """
+    pos = 0
+    while pos < len(data):
+        pos = _SKIP.match(data, pos).end()
+        m = _TOKEN.match(data, pos)
+        if m is None:
+            return
+        pos = m.end()
+        yield m.group(0), pos
+
+def read_pbm(path: str):
+    """
+    Read a PBM file into (width, height, rows), where each row is a list of
+    booleans that are True for black (foreground) pixels.
+    """
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    tokens = _tokens(data)
+    magic, _ = next(tokens)
+    width, _ = next(tokens)
+    height, pos = next(tokens)
+    width = int(width)
+    height = int(height)
+
+    if magic == b"P1":
+        bits = re.findall(rb"[01]", data[pos:])
+        if len(bits) < width * height:
+            raise ValueError(f"{path}: expected {width * height} pixels, found {len(bits)}")
+        pixels = [b == b"1" for b in bits[:width * height]]
+    elif magic == b"P4":
+        # Exactly one whitespace byte separates the header from the raster
+        raster = data[pos + 1:]
+        row_bytes = (width + 7) // 8
+        if len(raster) < row_bytes * height:
+            raise ValueError(f"{path}: raster is truncated")
+        pixels = []
+        for y in range(height):
+            row = raster[y * row_bytes:(y + 1) * row_bytes]
+            pixels.extend(bool(row[x >> 3] & (0x80 >> (x & 7))) for x in range(width))
+    else:
+        raise ValueError(f"{path}: not a PBM file (must be P1 or P4)")
+
+    rows = [pixels[y * width:(y + 1) * width] for y in range(height)]
+    return width, height, rows
+
+def encode(rows) -> bytes:
+    """
+    Run-length encode the given rows: alternating background/foreground runs, starting
+    with background, carrying on across rows. Runs over 255 are split with an empty run.
+    """
+    runs = []
+    foreground = False
+    length = 0
+    for row in rows:
+        for pixel in row:
+            if pixel != foreground:
+                runs.append(length)
+                foreground = pixel
+                length = 0
+            length += 1
+            if length == 256:
+                runs.extend([255, 0])
+                length = 1
+    if length > 0:
+        runs.append(length)
+    return bytes(runs)
+
+def to_c(name: str, width: int, height: int, data: bytes, source: str) -> str:
+    """
+    Render the encoded image as a C source file.
+    """
+    lines = [
+        f"// Generated by tools/rleimage from {source}. Do not edit.",
+        "#include <stddef.h>",
+        '#include <GUI_Paint.h>',
+        "",
+    ]
+    body = []
+    for i in range(0, len(data), 16):
+        body.append("    " + " ".join(f"0x{b:02X}," for b in data[i:i + 16]))
+    if body:
+        lines.append(f"static const UBYTE {name}_data[{len(data)}] = {{")
+        lines.extend(body)
+        lines.append("};")
+        lines.append("")
+        data_ref = f"{name}_data"
+    else:
+        data_ref = "NULL"
+    lines.append(f"const PAINT_RLE_IMAGE {name} = {{")
+    lines.append(f"    .Width = {width},")
+    lines.append(f"    .Height = {height},")
+    lines.append(f"    .Size = {len(data)},")
+    lines.append(f"    .Data = {data_ref},")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="PBM file to convert")
+    parser.add_argument("name", help="C identifier for the PAINT_RLE_IMAGE")
+    parser.add_argument("-o", "--output", help="Where to write the C source (default: stdout)")
+    args = parser.parse_args()
+
+    if not re.fullmatch(r"[A-Za-z_][A-Za-z0-9_]*", args.name):
+        print(f"{args.name} is not a valid C identifier", file=sys.stderr)
+        sys.exit(1)
+
+    width, height, rows = read_pbm(args.input)
+    if width > 0xFFFF or height > 0xFFFF:
+        print(f"{args.input} is too big ({width} x {height})", file=sys.stderr)
+        sys.exit(1)
+
+    source = to_c(args.name, width, height, encode(rows), args.input)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(source)
+    else:
+        sys.stdout.write(source)
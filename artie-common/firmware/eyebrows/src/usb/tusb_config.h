@@ -0,0 +1,34 @@
+/**
+ * @file tusb_config.h
+ * @brief TinyUSB configuration for our own USB device (see usbframes.h): stdio's serial port,
+ * and the vendor interface frames come in on. Only used when built with USB_FRAMES.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The SDK sets CFG_TUSB_MCU and CFG_TUSB_OS
+#define CFG_TUSB_RHPORT0_MODE       OPT_MODE_DEVICE
+#define CFG_TUD_ENDPOINT0_SIZE      64
+
+// Classes
+#define CFG_TUD_CDC                 1
+#define CFG_TUD_MSC                 0
+#define CFG_TUD_HID                 0
+#define CFG_TUD_MIDI                0
+#define CFG_TUD_VENDOR              1
+
+// The serial port, the same as stdio's own device has
+#define CFG_TUD_CDC_RX_BUFSIZE      256
+#define CFG_TUD_CDC_TX_BUFSIZE      256
+
+// Room for a couple of ms of frames between passes of the main loop, so the host isn't held off
+// while it does something else. Replies are short.
+#define CFG_TUD_VENDOR_RX_BUFSIZE   2048
+#define CFG_TUD_VENDOR_TX_BUFSIZE   64
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+// Stdlib includes
+#include <string.h>
+// SDK includes
+#include "pico/unique_id.h"
+#include "tusb.h"
+// Local includes
+#include "usbframes.h"
+
+/** Our interfaces. The serial port comes first, where stdio expects it. */
+enum {
+    ITF_NUM_CDC = 0,
+    ITF_NUM_CDC_DATA,
+    ITF_NUM_FRAMES,
+    ITF_NUM_TOTAL
+};
+
+/** Endpoints. */
+#define EPNUM_CDC_NOTIF     0x81
+#define EPNUM_CDC_OUT       0x02
+#define EPNUM_CDC_IN        0x82
+#define EPNUM_FRAMES_OUT    0x03
+#define EPNUM_FRAMES_IN     0x83
+
+/** Bulk endpoints at full speed. */
+#define BULK_PACKET_SIZE 64
+
+/** String descriptor indexes. */
+enum {
+    STRID_LANGID = 0,
+    STRID_MANUFACTURER,
+    STRID_PRODUCT,
+    STRID_SERIAL,
+    STRID_CDC,
+    STRID_FRAMES,
+};
+
+static const tusb_desc_device_t device_descriptor = {
+    .bLength = sizeof(tusb_desc_device_t),
+    .bDescriptorType = TUSB_DESC_DEVICE,
+    .bcdUSB = 0x0200,
+    // The serial port's two interfaces are tied together by an interface association
+    .bDeviceClass = TUSB_CLASS_MISC,
+    .bDeviceSubClass = MISC_SUBCLASS_COMMON,
+    .bDeviceProtocol = MISC_PROTOCOL_IAD,
+    .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = USBFRAMES_VID,
+    .idProduct = USBFRAMES_PID,
+    .bcdDevice = 0x0100,
+    .iManufacturer = STRID_MANUFACTURER,
+    .iProduct = STRID_PRODUCT,
+    .iSerialNumber = STRID_SERIAL,
+    .bNumConfigurations = 1,
+};
+
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_VENDOR_DESC_LEN)
+
+static const uint8_t configuration_descriptor[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0, 250),
+    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, STRID_CDC, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, BULK_PACKET_SIZE),
+    TUD_VENDOR_DESCRIPTOR(ITF_NUM_FRAMES, STRID_FRAMES, EPNUM_FRAMES_OUT, EPNUM_FRAMES_IN, BULK_PACKET_SIZE),
+};
+
+static const char *const strings[] = {
+    [STRID_MANUFACTURER] = "Artie",
+#ifdef MOUTH
+    [STRID_PRODUCT] = "Artie Mouth",
+#else
+    [STRID_PRODUCT] = "Artie Eyebrow",
+#endif // MOUTH
+    [STRID_CDC] = "Board CDC",
+    [STRID_FRAMES] = "LCD Frames",
+};
+
+const uint8_t *tud_descriptor_device_cb(void)
+{
+    return (const uint8_t *)&device_descriptor;
+}
+
+const uint8_t *tud_descriptor_configuration_cb(uint8_t index)
+{
+    return configuration_descriptor;
+}
+
+const uint16_t *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
+{
+    // UTF-16, after a header of length and type. The serial number is the longest.
+    static uint16_t descriptor[1 + (2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES)];
+    char serial[(2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES) + 1];
+
+    size_t len;
+    if (index == STRID_LANGID)
+    {
+        descriptor[1] = 0x0409; // English
+        len = 1;
+    }
+    else
+    {
+        const char *str;
+        if (index == STRID_SERIAL)
+        {
+            pico_get_unique_board_id_string(serial, sizeof(serial));
+            str = serial;
+        }
+        else if ((index < (sizeof(strings) / sizeof(strings[0]))) && (strings[index] != NULL))
+        {
+            str = strings[index];
+        }
+        else
+        {
+            return NULL;
+        }
+
+        len = strlen(str);
+        if (len > (sizeof(descriptor) / sizeof(descriptor[0])) - 1)
+        {
+            len = (sizeof(descriptor) / sizeof(descriptor[0])) - 1;
+        }
+        for (size_t i = 0; i < len; i++)
+        {
+            descriptor[1 + i] = (uint8_t)str[i];
+        }
+    }
+    descriptor[0] = (uint16_t)((TUSB_DESC_STRING << 8) | (2 * len + 2));
+    return descriptor;
+}
@@ -0,0 +1,404 @@
+// Std lib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "tusb.h"
+// Library includes
+#include <LCD_Panel.h>
+#include <errors.h>
+// Local includes
+#include "../graphics/commongfx.h"
+#include "../graphics/graphics.h"
+#include "usbframes.h"
+
+/** Bytes in each message's header, type included. */
+#define INFO_HEADER_SIZE    1
+#define FRAME_HEADER_SIZE   20
+#define RECT_HEADER_SIZE    9
+#define SYNC_HEADER_SIZE    1
+#define MAX_HEADER_SIZE     FRAME_HEADER_SIZE
+
+/** Bytes in each reply. */
+#define INFO_REPLY_SIZE     18
+#define SYNC_REPLY_SIZE     3
+
+/** What the parser is waiting for. */
+typedef enum {
+    WANT_TYPE,      ///< The first byte of a message
+    WANT_HEADER,    ///< The rest of its header
+    WANT_PAYLOAD,   ///< A frame's data, or a rectangle's pixels
+    WANT_SYNC,      ///< Everything before a SYNC to be on the LCD, so it can be answered
+} parse_state_t;
+
+/** Somewhere to put what comes in while the graphics core sends the last one to the LCD. */
+typedef struct {
+    uint8_t data[USBFRAMES_BUFFER_SIZE];
+    gfx_frame_t frame;              ///< The frame in data, for a FRAME
+    volatile bool busy;             ///< Posted to the graphics core, and not done with yet
+} staging_t;
+
+static staging_t staging[2];
+
+/** The staging buffer being filled, how much is in it, and how much it will take. */
+static uint8_t filling;
+static uint32_t filled;
+static uint32_t want;
+
+/** Filled, but not posted yet: the graphics core's queue was full. */
+static bool ready;
+
+/** The parser. */
+static parse_state_t state = WANT_TYPE;
+static uint8_t header[MAX_HEADER_SIZE];
+static uint32_t header_got;
+static uint32_t header_want;
+
+/**
+ * The message being taken in: a FRAME's header (its buffer may still be on the LCD until its data
+ * comes), or a RECT and where its next band goes. rows_per_band is 0 for a FRAME.
+ */
+static gfx_frame_t incoming;
+static PAINT_RECT rect;
+static uint16_t rect_row;
+static uint16_t rows_per_band;
+
+/** Blits handed to the graphics core, and how many of those it is done with. */
+static uint32_t blits_posted;
+static volatile uint32_t blits_done;
+
+/** Messages turned away since the last SYNC. */
+static uint16_t rejected;
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t value)
+{
+    put_u16(p, (uint16_t)value);
+    put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+/** On the graphics core: a staging buffer can be filled again. Wake the main loop, in case it's waiting on one. */
+static void blit_done(uintptr_t arg)
+{
+    staging[arg].busy = false;
+    blits_done++;
+    __dmb();
+    __sev();
+}
+
+/** Bytes of pixels in a band of rows of the rectangle. */
+static inline uint32_t band_bytes(uint16_t rows)
+{
+    return LCD_Panel_PixelBytes((uint32_t)(rect.Xend - rect.Xstart) * rows);
+}
+
+/** Rows of the rectangle in the band that goes next. */
+static inline uint16_t next_band_rows(void)
+{
+    const uint16_t left = rect.Yend - rect_row;
+    return (left < rows_per_band) ? left : rows_per_band;
+}
+
+/** Start filling the other staging buffer with want bytes. */
+static void next_staging(uint32_t bytes)
+{
+    filling ^= 1;
+    filled = 0;
+    want = bytes;
+}
+
+/**
+ * Hand the full staging buffer to the graphics core: the whole frame, or the rectangle's next band.
+ * Returns false if its queue is full; try again later.
+ */
+static bool post(void)
+{
+    staging_t *buffer = &staging[filling];
+    gfx_blit_t blit = {
+        .frame = NULL,
+        .pixels = buffer->data,
+        .len = filled,
+        .done = &blit_done,
+        .arg = filling,
+    };
+    uint16_t rows = 0;
+    if (rows_per_band == 0)
+    {
+        buffer->frame = incoming;
+        buffer->frame.data = buffer->data;
+        blit.frame = &buffer->frame;
+        blit.pixels = NULL;
+        blit.len = 0;
+    }
+    else
+    {
+        rows = next_band_rows();
+        blit.window = (PAINT_RECT){ rect.Xstart, rect_row, rect.Xend, (UWORD)(rect_row + rows) };
+    }
+
+    buffer->busy = true;
+    if (!graphics_blit(&blit))
+    {
+        buffer->busy = false;
+        return false;
+    }
+    blits_posted++;
+    ready = false;
+
+    // A rectangle goes on with its next band, if it has one; anything else is done
+    rect_row += rows;
+    if ((rows_per_band != 0) && (rect_row < rect.Yend))
+    {
+        next_staging(band_bytes(next_band_rows()));
+    }
+    else
+    {
+        next_staging(0);
+        rows_per_band = 0;
+        state = WANT_TYPE;
+    }
+    return true;
+}
+
+/** Throw away what has come in, and the message it was part of: the host finds out at its next SYNC. */
+static void reject(void)
+{
+    uint8_t scratch[64];
+    while (tud_vendor_available() > 0)
+    {
+        tud_vendor_read(scratch, sizeof(scratch));
+    }
+    if (rejected < UINT16_MAX)
+    {
+        rejected++;
+    }
+    set_errno(ERR_ID_GRAPHICS_MODULE, EINVAL);
+    filled = 0;
+    want = 0;
+    rows_per_band = 0;
+    state = WANT_TYPE;
+}
+
+static void reply(const uint8_t *data, uint32_t len)
+{
+    tud_vendor_write(data, len);
+    tud_vendor_write_flush();
+}
+
+static void reply_info(void)
+{
+    gfx_frame_t format;
+    gfx_frame_format(&format);
+
+    uint8_t info[INFO_REPLY_SIZE];
+    info[0] = USBFRAMES_MSG_INFO;
+    info[1] = USBFRAMES_VERSION;
+    info[2] = gfx_lcd_pixel_bits();
+    info[3] = format.scale;
+    put_u16(&info[4], format.rotate);
+    put_u16(&info[6], format.width_memory);
+    put_u16(&info[8], format.height_memory);
+    put_u16(&info[10], gfx_lcd_width());
+    put_u16(&info[12], gfx_lcd_height());
+    put_u32(&info[14], USBFRAMES_BUFFER_SIZE);
+    reply(info, sizeof(info));
+}
+
+/** A message's header is all in: get ready for its payload. */
+static void begin_payload(void)
+{
+    switch (header[0])
+    {
+        case USBFRAMES_MSG_FRAME:
+        {
+            gfx_frame_t *frame = &incoming;
+            frame->scale = header[1];
+            frame->rotate = get_u16(&header[2]);
+            frame->width_memory = get_u16(&header[4]);
+            frame->height_memory = get_u16(&header[6]);
+            frame->bounds = (PAINT_RECT){ get_u16(&header[8]), get_u16(&header[10]), get_u16(&header[12]), get_u16(&header[14]) };
+            frame->size = get_u32(&header[16]);
+            if (frame->size > USBFRAMES_BUFFER_SIZE)
+            {
+                log_error("USB frame of %lu bytes does not fit in %u.\n", (unsigned long)frame->size, USBFRAMES_BUFFER_SIZE);
+                reject();
+                return;
+            }
+            rows_per_band = 0;
+            want = frame->size;
+            state = WANT_PAYLOAD;
+            break;
+        }
+        case USBFRAMES_MSG_RECT:
+        {
+            const uint16_t x = get_u16(&header[1]);
+            const uint16_t y = get_u16(&header[3]);
+            const uint16_t w = get_u16(&header[5]);
+            const uint16_t h = get_u16(&header[7]);
+            if ((w == 0) || (h == 0) || ((uint32_t)x + w > gfx_lcd_width()) || ((uint32_t)y + h > gfx_lcd_height()))
+            {
+                log_error("USB rectangle %ux%u at (%u, %u) does not fit the LCD.\n", w, h, x, y);
+                reject();
+                return;
+            }
+            rect = (PAINT_RECT){ x, y, (UWORD)(x + w), (UWORD)(y + h) };
+            rect_row = y;
+
+            // As many rows as fit in a staging buffer. At 12 bits, a band of an odd width takes
+            // an even number of rows, so that it doesn't end half way through a byte.
+            const uint32_t rows = USBFRAMES_BUFFER_SIZE / LCD_Panel_PixelBytes(w);
+            rows_per_band = (rows < h) ? (uint16_t)rows : h;
+            if ((gfx_lcd_pixel_bits() == 12) && (w & 1))
+            {
+                rows_per_band &= (uint16_t)~1;
+            }
+            if (rows_per_band == 0)
+            {
+                log_error("USB rectangle %u pixels wide does not fit in %u bytes.\n", w, USBFRAMES_BUFFER_SIZE);
+                reject();
+                return;
+            }
+            want = band_bytes(next_band_rows());
+            state = WANT_PAYLOAD;
+            break;
+        }
+        case USBFRAMES_MSG_INFO:
+            reply_info();
+            state = WANT_TYPE;
+            break;
+        case USBFRAMES_MSG_SYNC:
+            state = WANT_SYNC;
+            break;
+        default:
+            break;
+    }
+}
+
+/** Take in what has come over USB, as far as there's somewhere to put it. */
+static void receive(void)
+{
+    while (true)
+    {
+        if (ready && !post())
+        {
+            // The graphics core's queue is full; it wakes us when it takes something off
+            return;
+        }
+
+        switch (state)
+        {
+            case WANT_TYPE:
+            {
+                if (tud_vendor_available() == 0)
+                {
+                    return;
+                }
+                tud_vendor_read(header, 1);
+                header_got = 1;
+                switch (header[0])
+                {
+                    case USBFRAMES_MSG_INFO:    header_want = INFO_HEADER_SIZE; break;
+                    case USBFRAMES_MSG_FRAME:   header_want = FRAME_HEADER_SIZE; break;
+                    case USBFRAMES_MSG_RECT:    header_want = RECT_HEADER_SIZE; break;
+                    case USBFRAMES_MSG_SYNC:    header_want = SYNC_HEADER_SIZE; break;
+                    default:
+                        log_error("Unknown USB frames message 0x%02X.\n", header[0]);
+                        reject();
+                        continue;
+                }
+                state = WANT_HEADER;
+                if (header_got == header_want)
+                {
+                    begin_payload();
+                }
+                break;
+            }
+            case WANT_HEADER:
+            {
+                const uint32_t n = tud_vendor_read(&header[header_got], header_want - header_got);
+                if (n == 0)
+                {
+                    return;
+                }
+                header_got += n;
+                if (header_got == header_want)
+                {
+                    begin_payload();
+                }
+                break;
+            }
+            case WANT_PAYLOAD:
+            {
+                // Wait for the graphics core to be done with the buffer; the host is held off meanwhile
+                staging_t *buffer = &staging[filling];
+                if (buffer->busy)
+                {
+                    return;
+                }
+                if (filled < want)
+                {
+                    const uint32_t n = tud_vendor_read(&buffer->data[filled], want - filled);
+                    if (n == 0)
+                    {
+                        return;
+                    }
+                    filled += n;
+                }
+                if (filled == want)
+                {
+                    ready = true;
+                }
+                break;
+            }
+            case WANT_SYNC:
+            {
+                __dmb();
+                if (blits_done != blits_posted)
+                {
+                    // The graphics core wakes us as each one is done
+                    return;
+                }
+                uint8_t sync[SYNC_REPLY_SIZE];
+                sync[0] = USBFRAMES_MSG_SYNC;
+                put_u16(&sync[1], rejected);
+                reply(sync, sizeof(sync));
+                rejected = 0;
+                state = WANT_TYPE;
+                break;
+            }
+        }
+    }
+}
+
+void usbframes_init(void)
+{
+    // Before stdio_init_all(): with tinyusb_device linked in, stdio leaves bringing up USB to us
+    tusb_init();
+}
+
+void usbframes_task(void)
+{
+    // The USB interrupt wakes the main loop out of its sleep, so this runs soon after anything comes in
+    tud_task();
+    if (tud_vendor_mounted())
+    {
+        receive();
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file usbframes.h
+ * @brief Takes pictures for the LCD over USB, when built with USB_FRAMES: frames and rectangles
+ * from a host, a few KB at a time, instead of shapes one command byte at a time over the bus.
+ *
+ * The board is a composite device: the stdio serial port, as before, and a vendor interface
+ * (class 0xFF) with a bulk OUT endpoint for messages and a bulk IN endpoint for replies.
+ * Messages start with a type byte, and everything in them is little-endian:
+ *
+ *   USBFRAMES_MSG_INFO    Nothing more. Replies with what the LCD takes (see below).
+ *   USBFRAMES_MSG_FRAME   scale u8, rotate u16, width_memory u16, height_memory u16, bounds
+ *                         (Xstart, Ystart, Xend, Yend) u16 each, size u32, then size bytes of data:
+ *                         a gfx_frame_t, like the pre-rendered ones, that replaces the picture.
+ *                         It must have been rendered at our format and fit in USBFRAMES_BUFFER_SIZE.
+ *   USBFRAMES_MSG_RECT    x u16, y u16, width u16, height u16, then the rectangle's pixels, a row at
+ *                         a time, in the LCD's pixel format: sent straight to that window of the LCD,
+ *                         where they stay until something sends over them. At 12 bits a pixel, two
+ *                         pixels take three bytes, and an odd pixel at the end takes two.
+ *   USBFRAMES_MSG_SYNC    Nothing more. Replies once everything sent before it is on the LCD, with
+ *                         how many messages were turned away since the last one (u16).
+ *
+ * The INFO reply is: USBFRAMES_MSG_INFO, USBFRAMES_VERSION, bits a pixel the LCD takes (16 for RGB565,
+ * high byte first, or 12 for RGB444), then the frame format (scale u8, rotate u16, width_memory u16,
+ * height_memory u16), the LCD's width and height (u16 each), and the biggest frame in bytes (u32).
+ *
+ * Data goes into one of two staging buffers while the graphics core sends the other to the LCD.
+ * When both are full, nothing more is read, so the host is held off by the USB flow control.
+ * A message that doesn't make sense is an error, and whatever else has come in is thrown away;
+ * the host finds out from the next SYNC, and starts over.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** The version of the protocol, in the INFO reply. */
+#define USBFRAMES_VERSION 1
+
+/** Message types: the first byte of each message, and of each reply. */
+#define USBFRAMES_MSG_INFO  0x01
+#define USBFRAMES_MSG_FRAME 0x02
+#define USBFRAMES_MSG_RECT  0x03
+#define USBFRAMES_MSG_SYNC  0x04
+
+#ifndef USBFRAMES_BUFFER_SIZE
+    /** Bytes in each of the two staging buffers. A frame must fit in one; a rectangle goes through a band of rows at a time. */
+    #define USBFRAMES_BUFFER_SIZE 8192
+#endif // USBFRAMES_BUFFER_SIZE
+
+#ifndef USBFRAMES_VID
+    /** USB vendor ID. The Pico SDK's, as stdio's own device has. */
+    #define USBFRAMES_VID 0x2E8A
+#endif // USBFRAMES_VID
+
+#ifndef USBFRAMES_PID
+    /** USB product ID. The Pico SDK's stdio device, so host rules for the serial port still match. */
+    #define USBFRAMES_PID 0x000A
+#endif // USBFRAMES_PID
+
+/**
+ * Bring up USB. Call before stdio_init_all(), which then shares the device with us
+ * (its serial port is our first interface), and before graphics_init().
+ */
+void usbframes_init(void);
+
+/**
+ * Service USB, and hand the graphics core whatever has come in that it has room for.
+ * Call from every pass of the main loop: with our own device, nothing else runs the USB stack.
+ */
+void usbframes_task(void);
+
+#ifdef __cplusplus
+}
+#endif
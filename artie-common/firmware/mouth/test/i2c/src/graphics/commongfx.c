@@ -5,49 +5,14 @@
 #include "pico/util/queue.h"
 // Local includes
 #include "commongfx.h"
-#include "lcd/LCD/LCD_1in14.h"
-#include "lcd/LCD/LCD_2in.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include <LCD_1in14.h>
+#include <LCD_2in.h>
+#include <LCD_Panel.h>
+#include <GUI_Paint.h>
 #include "../board/errors.h"
 
-/** Union of two functions since they have slightly different signatures. */
-typedef union {
-    void (*display_1in14)(UWORD *);
-    void (*display_2in)(UBYTE *);
-} lcd_display_function_t;
-
-/** "Class" describing the LCD. */
-typedef struct {
-    UWORD width;
-    UWORD height;
-    void (*clear)(UWORD);
-    void (*init)(UBYTE);
-    lcd_display_function_t display;
-} lcd_t;
-
-static const lcd_display_function_t display_for_1in14_lcd = {.display_1in14 = &LCD_1IN14_Display};
-static const lcd_display_function_t display_for_2in_lcd = {.display_2in = &LCD_2IN_Display};
-
-/** If we are eyebrows, we use this LCD. */
-static const lcd_t eyebrows_lcd = {
-    .width = LCD_1IN14_WIDTH,
-    .height = LCD_1IN14_HEIGHT,
-    .clear = &LCD_1IN14_Clear,
-    .init = &LCD_1IN14_Init,
-    .display = display_for_1in14_lcd,
-};
-
-/** If we are mouth, we use this LCD. */
-static const lcd_t mouth_lcd = {
-    .width = LCD_2IN_WIDTH,
-    .height = LCD_2IN_HEIGHT,
-    .clear = &LCD_2IN_Clear,
-    .init = &LCD_2IN_Init,
-    .display = display_for_2in_lcd,
-};
-
-/** Cache the size of the LCD since it won't change at runtime after initialization. */
-static lcd_t lcd = eyebrows_lcd;
+/** The LCD's panel, picked by gfx_init(). Everything goes through the one LCD_Panel driver. */
+static const LCD_PANEL *panel = &LCD_1IN14_PANEL;
 
 /** Number of values in an LCD image */
 #ifdef MOUTH
@@ -77,7 +42,7 @@ static init_paint_buffer(void)
         return;
     }
 #endif
-    Paint_NewImage((UBYTE *)paint_buffer, lcd.width, lcd.height, 0, WHITE);
+    Paint_NewImage((UBYTE *)paint_buffer, panel->Scan[HORIZONTAL].Width, panel->Scan[HORIZONTAL].Height, 0, WHITE);
     Paint_SetScale(65);
     Paint_Clear(WHITE);
     Paint_SetRotate(ROTATE_0);
@@ -90,11 +55,7 @@ void gfx_send_paint_buffer_to_lcd(void)
     {
         return;
     }
-#ifdef MOUTH
-    lcd.display.display_2in(paint_buffer);
-#else
-    lcd.display.display_1in14(paint_buffer);
-#endif // MOUTH
+    LCD_Panel_Display(paint_buffer);
 }
 
 void gfx_lcd_reset(void)
@@ -105,7 +66,7 @@ void gfx_lcd_reset(void)
     }
 
     Paint_Clear(WHITE);
-    lcd.clear(WHITE);
+    LCD_Panel_Clear(WHITE);
 
     // Create new buffer for when we want to turn back on
     init_paint_buffer();
@@ -177,12 +138,12 @@ void gfx_init(lcd_size_t lcdsz)
     {
         case LCD_SIZE_EYEBROWS:
             {
-                lcd = eyebrows_lcd;
+                panel = &LCD_1IN14_PANEL;
             }
             break;
         case LCD_SIZE_MOUTH:
             {
-                lcd = mouth_lcd;
+                panel = &LCD_2IN_PANEL;
             }
             break;
         default:
@@ -191,7 +152,7 @@ void gfx_init(lcd_size_t lcdsz)
             break;
     }
 
-    lcd.init(HORIZONTAL);
-    lcd.clear(WHITE);
+    LCD_Panel_Init(panel, HORIZONTAL);
+    LCD_Panel_Clear(WHITE);
     init_paint_buffer();
 }
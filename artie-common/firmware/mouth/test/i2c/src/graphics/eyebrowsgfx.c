@@ -5,8 +5,8 @@
 #include "pico/util/queue.h"
 // Local includes
 #include "commongfx.h"
-#include "lcd/LCD/LCD_1in14.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include <LCD_1in14.h>
+#include <GUI_Paint.h>
 #include "../cmds/cmds.h"
 #include "../board/errors.h"
 
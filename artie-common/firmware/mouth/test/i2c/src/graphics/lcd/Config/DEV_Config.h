@@ -1,85 +0,0 @@
-/*****************************************************************************
-* | File      	:   DEV_Config.h
-* | Author      :   
-* | Function    :   Hardware underlying interface
-* | Info        :
-*----------------
-* |	This version:   V1.0
-* | Date        :   2021-03-16
-* | Info        :   
-#
-# Permission is hereby granted, free of charge, to any person obtaining a copy
-# of this software and associated documnetation files (the "Software"), to deal
-# in the Software without restriction, including without limitation the rights
-# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-# copies of theex Software, and to permit persons to  whom the Software is
-# furished to do so, subject to the following conditions:
-#
-# The above copyright notice and this permission notice shall be included in
-# all copies or substantial portions of the Software.
-#
-# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
-# THE SOFTWARE.
-******************************************************************************/
-#ifndef _DEV_CONFIG_H_
-#define _DEV_CONFIG_H_
-
-#include "pico/stdlib.h"
-#include "hardware/spi.h"
-#include "stdio.h"
-#include "hardware/i2c.h"
-#include "hardware/pwm.h"
-
-/**
- * data
-**/
-#define UBYTE   uint8_t
-#define UWORD   uint16_t
-#define UDOUBLE uint32_t
-
-/**
- * GPIOI config
-**/
-
-#define LCD_RST_PIN  12
-#define LCD_DC_PIN   8
-#define LCD_BL_PIN   13
-    
-#define LCD_CS_PIN   9
-#define LCD_CLK_PIN  10
-#define LCD_MOSI_PIN 11
-    
-#define LCD_SCL_PIN  7
-#define LCD_SDA_PIN  6
-/*------------------------------------------------------------------------------------------------------*/
-void DEV_Digital_Write(UWORD Pin, UBYTE Value);
-UBYTE DEV_Digital_Read(UWORD Pin);
-
-void DEV_GPIO_Mode(UWORD Pin, UWORD Mode);
-void DEV_KEY_Config(UWORD Pin);
-void DEV_Digital_Write(UWORD Pin, UBYTE Value);
-UBYTE DEV_Digital_Read(UWORD Pin);
-
-void DEV_SPI_WriteByte(UBYTE Value);
-void DEV_SPI_Write_nByte(uint8_t *pData, uint32_t Len);
-
-void DEV_Delay_ms(UDOUBLE xms);
-void DEV_Delay_us(UDOUBLE xus);
-
-
-void DEV_I2C_Write(uint8_t addr, uint8_t reg, uint8_t Value);
-void DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len);
-uint8_t DEV_I2C_ReadByte(uint8_t addr, uint8_t reg);
-
-void DEV_SET_PWM(uint8_t Value);
-
-UBYTE DEV_Module_Init(void);
-void DEV_Module_Exit(void);
-
-
-#endif
@@ -4,8 +4,8 @@
 // SDK includes
 // Local includes
 #include "commongfx.h"
-#include "lcd/LCD/LCD_2in.h"
-#include "lcd/GUI/GUI_Paint.h"
+#include <LCD_2in.h>
+#include <GUI_Paint.h>
 #include "../cmds/cmds.h"
 #include "../board/errors.h"
 
@@ -1,5 +1,5 @@
 /*
- * Pin configuration for the eyebrows.
+ * Pin configuration for the reset MCU.
  */
 #pragma once
 
@@ -8,6 +8,10 @@ extern "C" {
 #endif
 
 #include <pico/stdlib.h>
+#include "types.h"
+
+/** Our address on the I2C bus (the controller's I2C_ADDRESS_RESET_MCU). */
+static const uint RESET_I2C_ADDRESS = 0x20;
 
 /** The LED pin used for testing and heartbeat signal */
 static const uint LED_PIN = 25; // on board LED
@@ -18,6 +22,31 @@ static const uint I2C_SDA_PIN = 2;
 /** I2C SCL pin used for communicating with controller module */
 static const uint I2C_SCL_PIN = 3;
 
+/** A target without a power switch (or ready line). */
+#define RESET_NO_PIN 0xFFU
+
+/** Each target's reset line (its RUN pin), in reset_target_t order. Active low, and only ever pulled down. */
+static const uint RESET_PINS[RESET_NUM_TARGETS] = { 6, 7, 8, 9 };
+
+/** Each target's power switch enable, in reset_target_t order, or RESET_NO_PIN. Active high. */
+static const uint POWER_PINS[RESET_NUM_TARGETS] = { 10, 11, 12, 13 };
+
+/**
+ * Each target's ready line, in reset_target_t order, or RESET_NO_PIN. Pulled up here. The target's firmware
+ * holds it low from the start of main() until it's done initializing, so boards that share a target (both
+ * eyebrows) share its line, and it only goes high once they're all ready. A target whose firmware doesn't
+ * drive it just gets RESET_BOOT_STAGGER_MS.
+ */
+static const uint READY_PINS[RESET_NUM_TARGETS] = { 14, 15, 16, 17 };
+
+/** The order the boot sequence brings targets up in: the hungriest first, while nothing else is running. */
+static const reset_target_t RESET_BOOT_ORDER[RESET_NUM_TARGETS] = {
+    RESET_TARGET_EYEBROWS,
+    RESET_TARGET_MOUTH,
+    RESET_TARGET_HEAD_SENSORS,
+    RESET_TARGET_PUMP_CTL,
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Pin configuration for the eyebrows.
+ * Typedefs for this project.
  */
 #pragma once
 
@@ -13,6 +13,26 @@ extern "C" {
 //    and yy yyyy are six bits which specify the command.
 
 #define CMD_MODULE_ID_LEDS  0x00        // 0b0000 0000
+#define CMD_MODULE_ID_RESET 0x40        // 0b0100 0000
+
+/** CMD_RESET and CMD_POWER_CYCLE carry a target (reset_target_t) in their four LSbs. */
+#define CMD_RESET_TARGET_MASK 0xF0
+
+/** CMD_RESET_SET_HOLD and CMD_RESET_SET_SETTLE carry a time index in their three LSbs; see reset_set_hold(). */
+#define CMD_RESET_TIMING_MASK 0xF8
+
+/** The MCUs we can reset. The same numbers as the controller's MCU_RESET_ADDR_*. */
+typedef enum {
+    RESET_TARGET_EYEBROWS       = 0x00,     // Both eyebrows share a reset line
+    RESET_TARGET_MOUTH          = 0x01,
+    RESET_TARGET_HEAD_SENSORS   = 0x02,
+    RESET_TARGET_PUMP_CTL       = 0x03,
+    RESET_NUM_TARGETS,
+    RESET_TARGET_ALL            = 0x0F,     // Every target at once (the controller's MCU_RESET_BROADCAST)
+} reset_target_t;
+
+/** Register map (see CMDS_REGISTER_SELECT in cmds.h). */
+#define REG_RESET_STATUS    (CMDS_REG_FIRMWARE_FIRST + 0x00)    // Each target's status (RESET_NUM_TARGETS x 2 bytes), in reset_target_t order; see reset.h
 
 /**
  * @brief The types of commands we can receive and act on.
@@ -23,6 +43,16 @@ typedef enum {
     CMD_LED_ON                      = (CMD_MODULE_ID_LEDS       | 0x00),
     CMD_LED_OFF                     = (CMD_MODULE_ID_LEDS       | 0x01),
     CMD_LED_HEARTBEAT               = (CMD_MODULE_ID_LEDS       | 0x02),
+    // Error reporting (see the errors library) shares the LED route too
+    CMD_QUERY_ERRORS                = (CMD_MODULE_ID_LEDS       | 0x22),    // Loads the read register with the error counts and latest errors; see errors_pack()
+
+    // Commands for resets. Each returns right away: the reset runs in the background,
+    // and REG_RESET_STATUS says when it's done. A frame of them runs them all at once.
+    CMD_RESET                       = (CMD_MODULE_ID_RESET      | 0x00),    // | target: hold its reset line, then let it go
+    CMD_POWER_CYCLE                 = (CMD_MODULE_ID_RESET      | 0x10),    // | target: cut its power (holding reset), then bring it back
+    CMD_RESET_SET_HOLD              = (CMD_MODULE_ID_RESET      | 0x20),    // | time index: how long the resets after it hold
+    CMD_RESET_SET_SETTLE            = (CMD_MODULE_ID_RESET      | 0x28),    // | time index: how long the resets after it wait for their target to boot
+    CMD_BOOT_SEQUENCE               = (CMD_MODULE_ID_RESET      | 0x30),    // Reset every target, then bring them up one at a time; see reset_boot()
 } cmd_t;
 
 #ifdef __cplusplus
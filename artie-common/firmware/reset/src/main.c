@@ -7,33 +7,55 @@
 #include <leds.h>
 #include <errors.h>
 // Local includes
+#include "cmds/cmds.h"
 #include "board/pinconfig.h"
 #include "board/types.h"
+#include "reset/reset.h"
 
-/**
- * @brief Command table for the LED subsystem.
- *
- * @param command
- */
-static void leds_cmd(cmd_t command)
+/** Anything no subsystem claims. */
+static void unknown_cmd(uint8_t command)
 {
-    switch (command)
-    {
-        case CMD_LED_ON:
-            leds_on();
-            break;
-        case CMD_LED_OFF:
-            leds_off();
-            break;
-        case CMD_LED_HEARTBEAT:
-            leds_heartbeat();
-            break;
-        default:
-            log_error("Illegal cmd type 0x%02X\n in LED subsystem", command);
-            break;
-    }
+    log_error("Illegal cmd type 0x%02X\n", command);
+}
+
+static void led_on_cmd(uint8_t command)
+{
+    leds_on();
+}
+
+static void led_off_cmd(uint8_t command)
+{
+    leds_off();
+}
+
+static void led_heartbeat_cmd(uint8_t command)
+{
+    leds_heartbeat();
+}
+
+static void query_errors_cmd(uint8_t command)
+{
+    uint8_t errors[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(errors, errors_pack(errors, sizeof(errors)));
+}
+
+static void reset_route_cmd(uint8_t command)
+{
+    reset_cmd((cmd_t)command);
 }
 
+/** Every command byte's handler, so dispatching one is a single lookup. Later entries override the ranges before them. */
+CMDS_TABLE_BEGIN
+static const cmds_handler_t COMMANDS[CMDS_TABLE_LEN] = {
+    [CMDS_MATCHING(0x00, 0x00)]                 = unknown_cmd,
+    [CMD_LED_ON]                                = led_on_cmd,
+    [CMD_LED_OFF]                               = led_off_cmd,
+    [CMD_LED_HEARTBEAT]                         = led_heartbeat_cmd,
+    [CMD_QUERY_ERRORS]                          = query_errors_cmd,
+    [CMDS_MATCHING(CMD_MODULE_ID_RESET, 0xC0)]  = reset_route_cmd,
+};
+CMDS_TABLE_END
+
 int main()
 {
     // Initialize UART for debugging (in a release build, this should be turned off from the CMake build system)
@@ -42,10 +64,51 @@ int main()
     // Initialize GPIO pins for LEDs
     leds_init(LED_PIN);
 
+    // Take over the targets' reset lines before the controller can ask for anything
+    reset_init();
+
+#if RESET_BOOT_AT_POWER_ON
+    // Everyone powered up with us: bring them up one at a time
+    reset_boot();
+#endif // RESET_BOOT_AT_POWER_ON
+
+    // Initialize I2C for communication with controller module.
+    cmds_init(RESET_I2C_ADDRESS, I2C_SDA_PIN, I2C_SCL_PIN, CMDS_I2C_BAUDRATE);
+
+    // How far through the error history we've logged
+    uint32_t error_cursor = 0;
+
     while (true)
     {
-        // TODO
-        // Contract is this:
-        //      Controller Module tells us who to reset, then we handle the reset logic asynchronously.
+        // Log any new errors
+        err_record_t error;
+        uint32_t missed;
+        while (errors_get_next(&error_cursor, &error, &missed))
+        {
+            if (missed > 0)
+            {
+                log_error("%lu errors were not logged; see CMD_QUERY_ERRORS for the counts.\n", (unsigned long)missed);
+            }
+            uint8_t flag = (uint8_t)(error.code & 0x00FF);
+            uint8_t module = (uint8_t)((error.code & 0xFF00) >> 8);
+            log_error("Error flag: 0x%02X from module with ID: 0x%02X\n", flag, module);
+        }
+
+        // The controller tells us who to reset; the resets themselves run from alarms.
+        // All the commands in a frame are started together, so a batch of resets overlaps.
+        uint8_t commands[CMDS_FRAME_MAX_LEN];
+        size_t ncommands = cmds_get_next_frame(commands, sizeof(commands));
+        for (size_t i = 0; i < ncommands; i++)
+        {
+            COMMANDS[commands[i]](commands[i]);
+        }
+
+        // Nothing to do? Print what's been logged, then sleep until the I2C ISR
+        // (or any other interrupt) wakes us.
+        if (ncommands == 0)
+        {
+            log_flush();
+            cmds_wait_for_next();
+        }
     }
 }
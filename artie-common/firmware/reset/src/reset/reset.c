@@ -0,0 +1,424 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "pico/time.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "reset.h"
+#include "../cmds/cmds.h"
+#include "../board/pinconfig.h"
+#include "../board/types.h"
+
+/** Hold and settle times, in ms, by time index. */
+static const uint32_t TIMES_MS[] = { 1, 5, 10, 20, 50, 100, 250, 500 };
+
+#define NUM_TIMES (sizeof(TIMES_MS) / sizeof(TIMES_MS[0]))
+
+/** Macro for converting ms to micro seconds. */
+#define MS_TO_US(x) ((int64_t)(x) * 1000)
+
+/** One reset, as requested. */
+typedef struct {
+    bool power_cycle;
+    uint32_t hold_ms;
+    uint32_t settle_ms;
+} request_t;
+
+/** One target's state. The alarm callback and the main loop share it, under reset_lock. */
+typedef struct {
+    reset_state_t state;
+    request_t current;      // The reset in progress
+    bool pending;           // Was another requested while this one was in progress?
+    request_t next;         // If so, that one
+    uint8_t completed;      // Resets finished, wrapping
+} target_t;
+
+static target_t targets[RESET_NUM_TARGETS];
+
+/** Guards targets[] between the main loop and the alarm callbacks. */
+static spin_lock_t *reset_lock = NULL;
+
+/** Where the boot sequence is up to. The boot alarm and the main loop share it, under reset_lock. */
+static struct {
+    uint position;          // Index into RESET_BOOT_ORDER of the target being booted
+    uint64_t released_us;   // When that target was let out of reset
+} boot;
+
+/** Hold and settle times for the next requests. Only the main loop touches these. */
+static uint32_t hold_ms;
+static uint32_t settle_ms;
+
+static inline bool has_power_switch(uint index)
+{
+    return POWER_PINS[index] != RESET_NO_PIN;
+}
+
+/** Pull the target's RUN pin low. */
+static inline void assert_reset(uint index)
+{
+    gpio_put(RESET_PINS[index], 0);
+    gpio_set_dir(RESET_PINS[index], GPIO_OUT);
+}
+
+/** Stop driving the target's RUN pin, and let its own pull-up bring it out of reset. */
+static inline void release_reset(uint index)
+{
+    gpio_set_dir(RESET_PINS[index], GPIO_IN);
+}
+
+/** Has the target got a line to tell us it's done booting? */
+static inline bool has_ready_line(uint index)
+{
+    return READY_PINS[index] != RESET_NO_PIN;
+}
+
+static inline void set_power(uint index, bool on)
+{
+    if (has_power_switch(index))
+    {
+        gpio_put(POWER_PINS[index], on);
+    }
+}
+
+/** Publish a target's status to the register map. Call with reset_lock held. */
+static void publish_status(uint index)
+{
+    const uint8_t status[2] = { (uint8_t)targets[index].state, targets[index].completed };
+    cmds_register_write(REG_RESET_STATUS + (2 * index), status, sizeof(status));
+}
+
+/** Start the target's current reset. Call with reset_lock held. Returns how long to hold it, in us. */
+static int64_t begin(uint index)
+{
+    target_t *target = &targets[index];
+    assert_reset(index);
+    if (target->current.power_cycle)
+    {
+        set_power(index, false);
+    }
+    target->state = RESET_STATE_HOLDING;
+    publish_status(index);
+    return MS_TO_US(target->current.hold_ms);
+}
+
+/** A target's reset is done. Call with reset_lock held. Returns how long to hold the next one, in us, or 0 if there isn't one. */
+static int64_t finish(uint index)
+{
+    target_t *target = &targets[index];
+    target->completed++;
+    if (target->pending)
+    {
+        // Carry straight on with the reset that was asked for in the meantime
+        target->pending = false;
+        target->current = target->next;
+        return begin(index);
+    }
+    target->state = RESET_STATE_IDLE;
+    return 0;
+}
+
+/** Move a target's reset on to its next step. Returns how long until the one after, in us, or 0 once it's done. */
+static int64_t reset_alarm_callback(alarm_id_t id, void *user_data)
+{
+    const uint index = (uint)(uintptr_t)user_data;
+    target_t *target = &targets[index];
+    int64_t next_us = 0;
+
+    const uint32_t saved = spin_lock_blocking(reset_lock);
+    switch (target->state)
+    {
+        case RESET_STATE_HOLDING:
+            if (target->current.power_cycle && has_power_switch(index))
+            {
+                set_power(index, true);
+                target->state = RESET_STATE_POWERING_UP;
+                next_us = MS_TO_US(RESET_POWER_GOOD_MS);
+                break;
+            }
+            release_reset(index);
+            target->state = RESET_STATE_SETTLING;
+            next_us = MS_TO_US(target->current.settle_ms);
+            break;
+        case RESET_STATE_POWERING_UP:
+            release_reset(index);
+            target->state = RESET_STATE_SETTLING;
+            next_us = MS_TO_US(target->current.settle_ms);
+            break;
+        case RESET_STATE_SETTLING:
+            next_us = finish(index);
+            break;
+        default:
+            break;
+    }
+    publish_status(index);
+    spin_unlock(reset_lock, saved);
+
+    // The SDK reschedules us next_us after this step was due, so the steps don't drift
+    return next_us;
+}
+
+/** Step a target's reset along from an alarm, starting `hold_us` from now. Call without reset_lock held: the callback takes it. */
+static void start_alarm(uint index, int64_t hold_us)
+{
+    if (add_alarm_in_us((uint64_t)hold_us, &reset_alarm_callback, (void *)(uintptr_t)index, true) <= 0)
+    {
+        // Don't leave it held
+        log_error("No alarm for resetting target %u\n", index);
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        const uint32_t saved = spin_lock_blocking(reset_lock);
+        set_power(index, true);
+        release_reset(index);
+        targets[index].state = RESET_STATE_IDLE;
+        targets[index].pending = false;
+        publish_status(index);
+        spin_unlock(reset_lock, saved);
+    }
+}
+
+/** Reset one target. */
+static void request_one(uint index, const request_t *request)
+{
+    target_t *target = &targets[index];
+
+    const uint32_t saved = spin_lock_blocking(reset_lock);
+    if (target->state != RESET_STATE_IDLE)
+    {
+        // Its alarm (or the boot sequence) picks this up when the reset in progress is done
+        target->pending = true;
+        target->next = *request;
+        spin_unlock(reset_lock, saved);
+        return;
+    }
+    target->current = *request;
+    const int64_t hold_us = begin(index);
+    spin_unlock(reset_lock, saved);
+
+    start_alarm(index, hold_us);
+}
+
+/**
+ * Let the boot sequence's targets out of reset one after another. Each target stays booting until
+ * it says it's ready (or, without a ready line, for the stagger), so only one is ever in its
+ * power-hungry start-up at a time. Returns how long until the next step, in us, or 0 once they're all up.
+ */
+static int64_t boot_alarm_callback(alarm_id_t id, void *user_data)
+{
+    const uint64_t now_us = time_us_64();
+    int64_t next_us = RESET_BOOT_POLL_US;
+    int64_t restart_hold_us = 0;
+    uint restart_index = 0;
+    bool timed_out = false;
+
+    const uint32_t saved = spin_lock_blocking(reset_lock);
+    const uint index = (uint)RESET_BOOT_ORDER[boot.position];
+    target_t *target = &targets[index];
+    if (target->state == RESET_STATE_QUEUED)
+    {
+        release_reset(index);
+        target->state = RESET_STATE_BOOTING;
+        boot.released_us = now_us;
+        publish_status(index);
+    }
+    else
+    {
+        // Don't trust the ready line until the target's firmware has had time to start holding it low
+        const uint64_t elapsed_ms = (now_us - boot.released_us) / 1000;
+        const bool ready = has_ready_line(index) && (elapsed_ms >= RESET_BOOT_STAGGER_MS) && gpio_get(READY_PINS[index]);
+        timed_out = has_ready_line(index) ? (elapsed_ms >= RESET_BOOT_TIMEOUT_MS) : (elapsed_ms >= RESET_BOOT_STAGGER_MS);
+        if (ready || timed_out)
+        {
+            timed_out = timed_out && !ready && has_ready_line(index);
+            restart_hold_us = finish(index);
+            restart_index = index;
+            publish_status(index);
+
+            boot.position++;
+            if (boot.position >= RESET_NUM_TARGETS)
+            {
+                next_us = 0;
+            }
+        }
+    }
+    spin_unlock(reset_lock, saved);
+
+    if (timed_out)
+    {
+        // It's up as far as we know, but something on it is slow or broken
+        set_errno(ERR_ID_CMD_MODULE, ETIME);
+    }
+    if (restart_hold_us > 0)
+    {
+        // Someone asked for it to be reset while it was booting
+        start_alarm(restart_index, restart_hold_us);
+    }
+    return next_us;
+}
+
+void reset_init(void)
+{
+    log_info("Init reset\n");
+
+    reset_lock = spin_lock_init(spin_lock_claim_unused(true));
+    hold_ms = TIMES_MS[RESET_DEFAULT_HOLD_INDEX];
+    settle_ms = TIMES_MS[RESET_DEFAULT_SETTLE_INDEX];
+
+    for (uint index = 0; index < RESET_NUM_TARGETS; index++)
+    {
+        // Power on, and not holding the target in reset
+        if (has_power_switch(index))
+        {
+            gpio_init(POWER_PINS[index]);
+            gpio_put(POWER_PINS[index], 1);
+            gpio_set_dir(POWER_PINS[index], GPIO_OUT);
+        }
+        // The pad's default pull-down would fight the target's pull-up
+        gpio_init(RESET_PINS[index]);
+        gpio_disable_pulls(RESET_PINS[index]);
+        release_reset(index);
+
+        // Wired-AND between the target's boards, which only ever pull it down
+        if (has_ready_line(index))
+        {
+            gpio_init(READY_PINS[index]);
+            gpio_set_dir(READY_PINS[index], GPIO_IN);
+            gpio_pull_up(READY_PINS[index]);
+        }
+
+        targets[index].state = RESET_STATE_IDLE;
+        targets[index].pending = false;
+        targets[index].completed = 0;
+        publish_status(index);
+    }
+}
+
+void reset_boot(void)
+{
+    const uint32_t saved = spin_lock_blocking(reset_lock);
+    for (uint index = 0; index < RESET_NUM_TARGETS; index++)
+    {
+        if (targets[index].state != RESET_STATE_IDLE)
+        {
+            spin_unlock(reset_lock, saved);
+            log_error("Can't start the boot sequence while target %u is being reset\n", index);
+            set_errno(ERR_ID_CMD_MODULE, EBUSY);
+            return;
+        }
+    }
+
+    // Hold everyone, then let them go one at a time
+    for (uint index = 0; index < RESET_NUM_TARGETS; index++)
+    {
+        assert_reset(index);
+        targets[index].state = RESET_STATE_QUEUED;
+        publish_status(index);
+    }
+    boot.position = 0;
+    spin_unlock(reset_lock, saved);
+
+    if (add_alarm_in_us((uint64_t)MS_TO_US(hold_ms), &boot_alarm_callback, NULL, true) <= 0)
+    {
+        // Let them all boot at once rather than not at all
+        log_error("No alarm for the boot sequence\n");
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        const uint32_t again = spin_lock_blocking(reset_lock);
+        for (uint index = 0; index < RESET_NUM_TARGETS; index++)
+        {
+            release_reset(index);
+            targets[index].state = RESET_STATE_IDLE;
+            targets[index].pending = false;
+            publish_status(index);
+        }
+        spin_unlock(reset_lock, again);
+    }
+}
+
+void reset_request(reset_target_t target, bool power_cycle)
+{
+    const request_t request = {
+        .power_cycle = power_cycle,
+        .hold_ms = hold_ms,
+        .settle_ms = settle_ms,
+    };
+
+    if (target == RESET_TARGET_ALL)
+    {
+        for (uint index = 0; index < RESET_NUM_TARGETS; index++)
+        {
+            request_one(index, &request);
+        }
+    }
+    else if ((uint)target < RESET_NUM_TARGETS)
+    {
+        request_one((uint)target, &request);
+    }
+    else
+    {
+        log_error("No reset target 0x%02X\n", target);
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+    }
+}
+
+void reset_set_hold(uint8_t index)
+{
+    if (index >= NUM_TIMES)
+    {
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+    hold_ms = TIMES_MS[index];
+}
+
+void reset_set_settle(uint8_t index)
+{
+    if (index >= NUM_TIMES)
+    {
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+    settle_ms = TIMES_MS[index];
+}
+
+reset_state_t reset_get_state(reset_target_t target)
+{
+    if ((uint)target >= RESET_NUM_TARGETS)
+    {
+        return RESET_STATE_IDLE;
+    }
+    return targets[target].state;
+}
+
+void reset_cmd(cmd_t command)
+{
+    if ((command & CMD_RESET_TIMING_MASK) == CMD_RESET_SET_HOLD)
+    {
+        reset_set_hold(command & ~CMD_RESET_TIMING_MASK);
+        return;
+    }
+
+    if ((command & CMD_RESET_TIMING_MASK) == CMD_RESET_SET_SETTLE)
+    {
+        reset_set_settle(command & ~CMD_RESET_TIMING_MASK);
+        return;
+    }
+
+    switch (command & CMD_RESET_TARGET_MASK)
+    {
+        case CMD_RESET:
+            reset_request((reset_target_t)(command & ~CMD_RESET_TARGET_MASK), false);
+            break;
+        case CMD_POWER_CYCLE:
+            reset_request((reset_target_t)(command & ~CMD_RESET_TARGET_MASK), true);
+            break;
+        case CMD_BOOT_SEQUENCE:
+            reset_boot();
+            break;
+        default:
+            log_error("Illegal cmd type 0x%02X\n in reset subsystem", command);
+            set_errno(ERR_ID_CMD_MODULE, EINVAL);
+            break;
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file reset.h
+ * @brief Interface to the reset subsystem, which resets and power cycles the other MCUs.
+ * Requests return right away. Each target then runs through its own reset from alarms,
+ * so resets of several targets overlap instead of queueing behind each other.
+ *
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../board/types.h"
+
+#ifndef RESET_DEFAULT_HOLD_INDEX
+    /** Time index (see reset_set_hold()) that resets hold for until the controller picks another. 10 ms. */
+    #define RESET_DEFAULT_HOLD_INDEX 2
+#endif // RESET_DEFAULT_HOLD_INDEX
+
+#ifndef RESET_DEFAULT_SETTLE_INDEX
+    /** Time index that resets wait for their target to boot until the controller picks another. 100 ms. */
+    #define RESET_DEFAULT_SETTLE_INDEX 5
+#endif // RESET_DEFAULT_SETTLE_INDEX
+
+#ifndef RESET_POWER_GOOD_MS
+    /** How long a power cycle keeps holding reset after the power comes back, for the supply to come up. */
+    #define RESET_POWER_GOOD_MS 10
+#endif // RESET_POWER_GOOD_MS
+
+#ifndef RESET_BOOT_STAGGER_MS
+    /**
+     * The least time the boot sequence gives each target before letting the next one go, in ms.
+     * Long enough for its firmware to get to main() and start holding its ready line low.
+     * Targets without a ready line get exactly this long.
+     */
+    #define RESET_BOOT_STAGGER_MS 50
+#endif // RESET_BOOT_STAGGER_MS
+
+#ifndef RESET_BOOT_TIMEOUT_MS
+    /** The most time the boot sequence waits for a target to say it's ready, in ms. */
+    #define RESET_BOOT_TIMEOUT_MS 3000
+#endif // RESET_BOOT_TIMEOUT_MS
+
+#ifndef RESET_BOOT_POLL_US
+    /** How often the boot sequence looks at the ready line of the target it's booting, in us. */
+    #define RESET_BOOT_POLL_US 1000
+#endif // RESET_BOOT_POLL_US
+
+/** Where a target's reset is up to. */
+typedef enum {
+    RESET_STATE_IDLE        = 0,    // Not being reset
+    RESET_STATE_HOLDING     = 1,    // Reset held (and power off, for a power cycle)
+    RESET_STATE_POWERING_UP = 2,    // Power back, reset still held
+    RESET_STATE_SETTLING    = 3,    // Let go; waiting for the target to boot
+    RESET_STATE_QUEUED      = 4,    // Held until the boot sequence gets to it
+    RESET_STATE_BOOTING     = 5,    // Let go by the boot sequence; waiting for it to say it's ready
+} reset_state_t;
+
+/**
+ * @brief Initialize the reset subsystem. Every target is powered and let out of reset.
+ * The status of each target goes into the register map at REG_RESET_STATUS, two bytes each:
+ * its reset_state_t, then how many of its resets have finished (wrapping at 256). A controller
+ * that reads the count before asking for a reset knows it's done when the count moves on
+ * and the state is back to idle.
+ */
+void reset_init(void);
+
+/**
+ * @brief Hold every target in reset, then let them out one at a time, in RESET_BOOT_ORDER, so their
+ * start-ups (servo calibration, LCD init) don't all draw their peak current at once.
+ * The next target goes once the one before has raised its ready line (but not before RESET_BOOT_STAGGER_MS),
+ * or after RESET_BOOT_TIMEOUT_MS if it never does (which sets ETIME). Returns right away.
+ * Refused (EBUSY) while any target is being reset. Resets asked for during it happen once their target is up.
+ */
+void reset_boot(void);
+
+/**
+ * @brief Reset a target: hold its reset line, let it go, then give it time to boot.
+ * If the target is already being reset, it is reset again once that's done.
+ *
+ * @param target Which target, or RESET_TARGET_ALL.
+ * @param power_cycle Cut its power while holding, if it has a power switch. Otherwise just reset it.
+ */
+void reset_request(reset_target_t target, bool power_cycle);
+
+/**
+ * @brief Set how long the resets requested from now on hold their target in reset (or its power off).
+ *
+ * @param index Index into {1, 5, 10, 20, 50, 100, 250, 500} ms.
+ */
+void reset_set_hold(uint8_t index);
+
+/**
+ * @brief Set how long the resets requested from now on give their target to boot before they count as done.
+ *
+ * @param index Index into the same times as reset_set_hold().
+ */
+void reset_set_settle(uint8_t index);
+
+/** Where a target's reset is up to. */
+reset_state_t reset_get_state(reset_target_t target);
+
+/**
+ * @brief Handle the given command meant for the reset subsystem.
+ *
+ * @param command Reset command to handle.
+ */
+void reset_cmd(cmd_t command);
+
+#ifdef __cplusplus
+}
+#endif
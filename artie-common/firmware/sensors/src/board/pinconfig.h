@@ -0,0 +1,55 @@
+/*
+ * Pin configuration for the head sensor board.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pico/stdlib.h>
+#include "hardware/spi.h"
+
+/** Our address on the I2C bus (the controller's I2C_ADDRESS_HEAD_SENSORS_MCU). */
+static const uint SENSORS_I2C_ADDRESS = 0x1A;
+
+/** The LED pin used for testing and heartbeat signal */
+static const uint LED_PIN = 25; // on board LED
+
+/** I2C SDA pin used for communicating with controller module */
+static const uint I2C_SDA_PIN = 20;
+
+/** I2C SCL pin used for communicating with controller module */
+static const uint I2C_SCL_PIN = 21;
+
+/** CAN controller (MCP2515) pins on spi0, used instead of I2C when built with CMDS_USE_CAN */
+static const uint CAN_SCK_PIN = 2;
+static const uint CAN_MOSI_PIN = 3;
+static const uint CAN_MISO_PIN = 4;
+static const uint CAN_CS_PIN = 5;
+
+/** The CAN controller's (active-low) interrupt output */
+static const uint CAN_INT_PIN = 14;
+
+/** Ready line to the reset MCU. Held low until we're initialized, then let go; see signal_ready() in main.c. */
+static const uint BOOT_READY_PIN = 26;
+
+/** The SPI the sensors are on. spi0 is the CAN controller's. */
+#define SENSORS_SPI spi1
+
+/** Sensor SPI pins */
+static const uint SENSORS_SPI_MISO = 12;
+static const uint SENSORS_SPI_CLOCK = 10;
+static const uint SENSORS_SPI_MOSI = 11;
+
+/** Chip selects (active low, driven by hand) for the BME280 and the IMU */
+static const uint SENSORS_SPI_CS_TEMP = 13;
+static const uint SENSORS_SPI_CS_IMU = 9;
+
+/** The IMU's interrupt outputs: INT1 is its FIFO watermark, INT2 its motion events */
+static const uint SENSORS_IMU_INT1 = 6;
+static const uint SENSORS_IMU_INT2 = 7;
+
+#ifdef __cplusplus
+}
+#endif
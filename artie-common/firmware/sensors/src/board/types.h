@@ -0,0 +1,49 @@
+/*
+ * Typedefs for this project.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pico/stdlib.h>
+
+// Commands are of the form xxyy yyyy where xx are two bits which set the module
+//    and yy yyyy are six bits which specify the command.
+
+#define CMD_MODULE_ID_LEDS      0x00        // 0b0000 0000
+#define CMD_MODULE_ID_SENSORS   0x80        // 0b1000 0000
+
+/**
+ * @brief The types of commands we can receive and act on.
+ * The sensors have more than these: burst, orientation, and history reads, and
+ * configuration, which carry their arguments in their low bits (see sensors.h).
+ */
+typedef enum {
+    // Commands for LED
+    CMD_LED_ON                      = (CMD_MODULE_ID_LEDS       | 0x00),
+    CMD_LED_OFF                     = (CMD_MODULE_ID_LEDS       | 0x01),
+    CMD_LED_HEARTBEAT               = (CMD_MODULE_ID_LEDS       | 0x02),
+    // Tracing, error reporting and logs, and the self test (see the trace, errors, and bist libraries) share the LED route
+    CMD_QUERY_TRACE                 = (CMD_MODULE_ID_LEDS       | 0x20),    // Loads the read register with the oldest trace events
+    CMD_DUMP_TRACE                  = (CMD_MODULE_ID_LEDS       | 0x21),    // Prints every trace event over USB stdio
+    CMD_QUERY_ERRORS                = (CMD_MODULE_ID_LEDS       | 0x22),    // Loads the read register with the error counts and latest errors; see errors_pack()
+    CMD_QUERY_BIST                  = (CMD_MODULE_ID_LEDS       | 0x23),    // Loads the read register with the boot self test's results; see bist_pack()
+    CMD_QUERY_LOG                   = (CMD_MODULE_ID_LEDS       | 0x2C),    // Takes the oldest queued log messages and loads the read register with them, unformatted; see log_pack()
+
+    // Commands for sensors. Each loads the read register with one value (4 bytes, little-endian).
+    CMD_SENSORS_READ_TEMPERATURE    = (CMD_MODULE_ID_SENSORS    | 0x00),    // int32, 0.01 C
+    CMD_SENSORS_READ_HUMIDITY       = (CMD_MODULE_ID_SENSORS    | 0x01),    // uint32, %RH Q22.10
+    CMD_SENSORS_READ_PRESSURE       = (CMD_MODULE_ID_SENSORS    | 0x02),    // uint32, Pa Q24.8
+    CMD_SENSORS_READ_ACCEL_X        = (CMD_MODULE_ID_SENSORS    | 0x03),    // int16, raw, sign-extended
+    CMD_SENSORS_READ_ACCEL_Y        = (CMD_MODULE_ID_SENSORS    | 0x04),
+    CMD_SENSORS_READ_ACCEL_Z        = (CMD_MODULE_ID_SENSORS    | 0x05),
+    CMD_SENSORS_READ_GYRO_X         = (CMD_MODULE_ID_SENSORS    | 0x06),
+    CMD_SENSORS_READ_GYRO_Y         = (CMD_MODULE_ID_SENSORS    | 0x07),
+    CMD_SENSORS_READ_GYRO_Z         = (CMD_MODULE_ID_SENSORS    | 0x08),
+} cmd_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdio.h>
+// SDK includes
+#include "pico/stdlib.h"
+// Library includes
+#include <bist.h>
+#include <errors.h>
+#include <leds.h>
+#include <sysclock.h>
+#include <trace.h>
+#if CMDS_USE_CAN
+    #include <psacp.h>
+#endif // CMDS_USE_CAN
+// Local includes
+#include "cmds/cmds.h"
+#include "board/pinconfig.h"
+#include "board/types.h"
+#include "sensors/sensors.h"
+
+/** Anything no subsystem claims. */
+static void unknown_cmd(uint8_t command)
+{
+    log_error("Illegal cmd type 0x%02X\n", command);
+}
+
+static void led_on_cmd(uint8_t command)
+{
+    leds_on();
+}
+
+static void led_off_cmd(uint8_t command)
+{
+    leds_off();
+}
+
+static void led_heartbeat_cmd(uint8_t command)
+{
+    leds_heartbeat();
+}
+
+static void query_trace_cmd(uint8_t command)
+{
+    uint8_t events[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(events, trace_pack(events, sizeof(events)));
+}
+
+static void dump_trace_cmd(uint8_t command)
+{
+    trace_dump();
+}
+
+static void query_errors_cmd(uint8_t command)
+{
+    uint8_t errors[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(errors, errors_pack(errors, sizeof(errors)));
+}
+
+static void query_log_cmd(uint8_t command)
+{
+    uint8_t messages[CMDS_REGISTER_MAX_LEN];
+    cmds_set_register_bytes(messages, log_pack(messages, sizeof(messages)));
+}
+
+static void query_bist_cmd(uint8_t command)
+{
+    uint8_t results[BIST_PACKED_LEN];
+    cmds_set_register_bytes(results, bist_pack(results, sizeof(results)));
+}
+
+/** Most clk_sys cycles the command bus's interrupt can take to run once raised and pass the self test. The core alone takes 15. */
+#define SELF_TEST_ISR_LATENCY_CYCLES 48U
+
+/** BIST_I2C_ISR_LATENCY: see cmds_measure_isr_latency(). */
+static bool measure_isr_latency(uint32_t *cycles, void *context)
+{
+    return cmds_measure_isr_latency(cycles);
+}
+
+static void sensors_route_cmd(uint8_t command)
+{
+    sensors_cmd((cmd_t)command);
+}
+
+/** Every command byte's handler, so dispatching one is a single lookup. Later entries override the ranges before them. */
+CMDS_TABLE_BEGIN
+static const cmds_handler_t COMMANDS[CMDS_TABLE_LEN] = {
+    [CMDS_MATCHING(0x00, 0x00)]                     = unknown_cmd,
+    [CMD_LED_ON]                                    = led_on_cmd,
+    [CMD_LED_OFF]                                   = led_off_cmd,
+    [CMD_LED_HEARTBEAT]                             = led_heartbeat_cmd,
+    [CMD_QUERY_TRACE]                               = query_trace_cmd,
+    [CMD_DUMP_TRACE]                                = dump_trace_cmd,
+    [CMD_QUERY_ERRORS]                              = query_errors_cmd,
+    [CMD_QUERY_BIST]                                = query_bist_cmd,
+    [CMD_QUERY_LOG]                                 = query_log_cmd,
+    [CMDS_MATCHING(CMD_MODULE_ID_SENSORS, 0xC0)]    = sensors_route_cmd,
+};
+CMDS_TABLE_END
+
+/** Tell the reset MCU we're initialized, so it can let the next MCU boot. */
+static inline void signal_ready(void)
+{
+    gpio_set_dir(BOOT_READY_PIN, GPIO_IN);
+}
+
+int main()
+{
+    // Tell the reset MCU we're busy booting, before anything else draws power
+    gpio_init(BOOT_READY_PIN);
+    gpio_disable_pulls(BOOT_READY_PIN);
+    gpio_put(BOOT_READY_PIN, 0);
+    gpio_set_dir(BOOT_READY_PIN, GPIO_OUT);
+
+    // Initialize UART for debugging (in a release build, this should be turned off from the CMake build system)
+    stdio_init_all();
+
+    // Start tracing before anything that records events
+    trace_init();
+
+    // Initialize GPIO pins for LEDs
+    leds_init(LED_PIN);
+
+    // Then the clock, before the buses start up (the LEDs follow it wherever it goes)
+    sysclock_set(SYSCLOCK_MHZ);
+
+#if !CMDS_USE_CAN
+    // Time the command bus's interrupt while it's free, before cmds_init() takes it
+    if (bist_run(BIST_I2C_ISR_LATENCY, &measure_isr_latency, NULL, SELF_TEST_ISR_LATENCY_CYCLES) != BIST_PASS)
+    {
+        set_errno(ERR_ID_CMD_MODULE, ETIME);
+    }
+#endif // CMDS_USE_CAN
+
+    // Initialize I2C for communication with controller module.
+    cmds_init(SENSORS_I2C_ADDRESS, I2C_SDA_PIN, I2C_SCL_PIN, CMDS_I2C_BAUDRATE);
+
+    // Core 1 takes the sensors from here: the SPI bus, the IMU's interrupts, the read timers, and fusion.
+    // Core 0 keeps the command bus, and answers reads from what core 1 publishes.
+    sensors_init();
+
+    // Let the reset MCU start the next MCU's boot
+    signal_ready();
+
+    // How far through the error history we've logged
+    uint32_t error_cursor = 0;
+#if CMDS_USE_CAN
+    // And how far through it we've published
+    uint32_t publish_cursor = 0;
+#endif // CMDS_USE_CAN
+
+    while (true)
+    {
+#if CMDS_USE_CAN
+        // Tell the controller about any new errors straight away, rather than waiting to be asked
+        psacp_publish_errors(&publish_cursor);
+#endif // CMDS_USE_CAN
+
+        // Log any new errors
+        err_record_t error;
+        uint32_t missed;
+        bool new_errors = false;
+        while (errors_get_next(&error_cursor, &error, &missed))
+        {
+            new_errors = true;
+            if (missed > 0)
+            {
+                log_error("%lu errors were not logged; see CMD_QUERY_ERRORS for the counts.\n", (unsigned long)missed);
+            }
+            uint8_t flag = (uint8_t)(error.code & 0x00FF);
+            uint8_t module = (uint8_t)((error.code & 0xFF00) >> 8);
+            log_error("Error flag: 0x%02X from module with ID: 0x%02X\n", flag, module);
+        }
+        if (new_errors)
+        {
+            // Blink the latest one on the LED too, for when there's no serial to read the log from
+            leds_report_error((err_module_id_t)(error.code & 0xFF00), (err_t)(error.code & 0x00FF));
+        }
+
+        // Get the next frame of commands out of the cmds module and act on each of them in order.
+        uint8_t commands[CMDS_FRAME_MAX_LEN];
+        size_t ncommands = cmds_get_next_frame(commands, sizeof(commands));
+        for (size_t i = 0; i < ncommands; i++)
+        {
+            TRACE_BEGIN(TRACE_ID_CMD_DISPATCH, commands[i]);
+            COMMANDS[commands[i]](commands[i]);
+            TRACE_END(TRACE_ID_CMD_DISPATCH, commands[i]);
+        }
+
+        // Nothing to do? Print what's been logged, then sleep until the I2C ISR
+        // (or any other interrupt, or a log message from core 1) wakes us.
+        if (ncommands == 0)
+        {
+            log_flush();
+            cmds_wait_for_next();
+        }
+    }
+}
@@ -0,0 +1,266 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "../fixmath/fixmath.h"
+#include "fusion.h"
+#include "imu.h"
+#include "sensors.h"
+
+/** Gyro sensitivity at the 125 dps full scale: 4.375 mdps per LSB, in rad/s. Each wider full scale doubles it. */
+#define FUSION_GYRO_RAD_PER_LSB_125 (4.375e-3 * 3.14159265358979 / 180.0)
+
+/**
+ * How much we trust the accelerometer. The gyro is pulled toward the measured gravity
+ * vector at this rate (rad/s per unit of error). Bigger converges faster but lets more
+ * accelerometer noise and linear acceleration through.
+ */
+#define FUSION_ACCEL_GAIN 0.5
+
+/**
+ * Extra fractional bits of the gyro step. At the fastest rates one LSB turns through
+ * only a few Q30 units, which would be too coarse.
+ */
+#define FUSION_GYRO_STEP_EXTRA_Q 12
+
+/**
+ * Half the angle (in rad, Q30 + FUSION_GYRO_STEP_EXTRA_Q) the gyro turns through per LSB per sample
+ * at 125 dps, and half the correction (in rad, Q30) applied per unit (Q30) of gravity error per sample.
+ * All of these are folded to integers at compile time; there is no float math at run time.
+ */
+#define FUSION_GYRO_HALF_STEP(rate_hz)  ((int64_t)(0.5 * FUSION_GYRO_RAD_PER_LSB_125 / (rate_hz) * ((int64_t)1 << (FUSION_Q + FUSION_GYRO_STEP_EXTRA_Q)) + 0.5))
+#define FUSION_ACCEL_HALF_STEP(rate_hz) ((int64_t)(0.5 * FUSION_ACCEL_GAIN / (rate_hz) * (1 << FUSION_Q) + 0.5))
+#define FUSION_STEPS(rate_hz)           { FUSION_GYRO_HALF_STEP(rate_hz), FUSION_ACCEL_HALF_STEP(rate_hz) }
+
+/** The gyro and accel steps at one output data rate. */
+typedef struct {
+    int64_t gyro;
+    int64_t accel;
+} fusion_steps_t;
+
+/** Steps by imu_odr_t. With the IMU off there are no samples, so that one is never used. */
+static const fusion_steps_t STEPS[] = {
+    { 0, 0 },
+    FUSION_STEPS(12.5),
+    FUSION_STEPS(26.0),
+    FUSION_STEPS(52.0),
+    FUSION_STEPS(104.0),
+    FUSION_STEPS(208.0),
+    FUSION_STEPS(416.0),
+    FUSION_STEPS(833.0),
+    FUSION_STEPS(1660.0),
+    FUSION_STEPS(3330.0),
+    FUSION_STEPS(6660.0),
+};
+
+/** One, in Q30. */
+#define FUSION_ONE              ((int64_t)1 << FUSION_Q)
+
+/** Samples that can be waiting for the filter. Must be a power of two. */
+#define FUSION_RING_SIZE        64
+#define FUSION_RING_MASK        (FUSION_RING_SIZE - 1)
+
+/**
+ * Samples from the IMU batch path (the SPI DMA IRQ) to fusion_process() (the acquisition core's loop),
+ * so the filtering doesn't hold up the IRQ. The IRQ only writes ring_head; the loop only writes ring_tail.
+ */
+static imu_sensor_values_t ring[FUSION_RING_SIZE];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+
+/** Timestamp of the newest sample published to the ring. */
+static volatile uint64_t ring_newest_timestamp_us = 0;
+
+/** Sequence count for orientation. Odd while fusion_process() is writing it. */
+static volatile uint32_t orientation_seq = 0;
+
+/** The latest estimate. Level and facing forward until we know better. */
+static fusion_orientation_t orientation = {
+    .w = (int32_t)FUSION_ONE,
+    .x = 0,
+    .y = 0,
+    .z = 0,
+    .timestamp_us = 0,
+};
+
+/**
+ * The IMU configuration the samples come at: the output data rate in the low byte, and how many
+ * times the 125 dps sensitivity the gyro's is (as a shift) in the next. sensors_configure() writes
+ * it; fusion_process() reads it once per batch.
+ */
+static volatile uint32_t step_config = ((uint32_t)2 << 8) | IMU_ODR_208_HZ;
+
+/** Q30 multiply. */
+static inline int64_t qmul(int64_t a, int64_t b)
+{
+    return (a * b) >> FUSION_Q;
+}
+
+/**
+ * Run one sample through the filter, updating q (w, x, y, z in Q30).
+ * `gyro_step` is in Q30 + FUSION_GYRO_STEP_EXTRA_Q; `accel_step` is in Q30.
+ */
+static void fusion_step(int64_t q[4], const imu_sensor_values_t *sample, int64_t gyro_step, int64_t accel_step)
+{
+    const int64_t w = q[0];
+    const int64_t x = q[1];
+    const int64_t y = q[2];
+    const int64_t z = q[3];
+
+    // Half-angle rotation this step, from the gyro
+    int64_t hx = (sample->gyro_x * gyro_step) >> FUSION_GYRO_STEP_EXTRA_Q;
+    int64_t hy = (sample->gyro_y * gyro_step) >> FUSION_GYRO_STEP_EXTRA_Q;
+    int64_t hz = (sample->gyro_z * gyro_step) >> FUSION_GYRO_STEP_EXTRA_Q;
+
+    // Nudge toward the accelerometer's idea of "down", unless we're in free fall
+    int64_t ax = sample->accel_x;
+    int64_t ay = sample->accel_y;
+    int64_t az = sample->accel_z;
+    uint32_t amag = fix_isqrt64((uint64_t)(ax * ax + ay * ay + az * az));
+    if (amag != 0)
+    {
+        ax = (ax << FUSION_Q) / amag;
+        ay = (ay << FUSION_Q) / amag;
+        az = (az << FUSION_Q) / amag;
+
+        // Gravity direction in the body frame, according to q
+        int64_t vx = 2 * (qmul(x, z) - qmul(w, y));
+        int64_t vy = 2 * (qmul(w, x) + qmul(y, z));
+        int64_t vz = qmul(w, w) - qmul(x, x) - qmul(y, y) + qmul(z, z);
+
+        // Error is the rotation from estimated to measured gravity
+        int64_t ex = qmul(ay, vz) - qmul(az, vy);
+        int64_t ey = qmul(az, vx) - qmul(ax, vz);
+        int64_t ez = qmul(ax, vy) - qmul(ay, vx);
+
+        hx += qmul(ex, accel_step);
+        hy += qmul(ey, accel_step);
+        hz += qmul(ez, accel_step);
+    }
+
+    // q += q * (0, h)
+    q[0] = w + (-qmul(x, hx) - qmul(y, hy) - qmul(z, hz));
+    q[1] = x + (qmul(w, hx) + qmul(y, hz) - qmul(z, hy));
+    q[2] = y + (qmul(w, hy) - qmul(x, hz) + qmul(z, hx));
+    q[3] = z + (qmul(w, hz) + qmul(x, hy) - qmul(y, hx));
+
+    // Renormalize. We only ever drift a little from unit length, so one Newton step
+    // of 1/sqrt(n) about 1 (that is, 1.5 - n/2) is enough and needs no sqrt or divide.
+    int64_t n = qmul(q[0], q[0]) + qmul(q[1], q[1]) + qmul(q[2], q[2]) + qmul(q[3], q[3]);
+    int64_t scale = (3 * FUSION_ONE / 2) - (n / 2);
+    for (int i = 0; i < 4; i++)
+    {
+        q[i] = qmul(q[i], scale);
+    }
+}
+
+/** Publish the orientation to the register map, in the same layout as CMD_SENSORS_READ_ORIENTATION (less the version). */
+static void publish_orientation(const int64_t q[4], uint64_t timestamp_us)
+{
+    uint8_t buf[4 * 4 + 8];
+    size_t pos = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+        const uint32_t value = (uint32_t)(int32_t)q[i];
+        buf[pos++] = (uint8_t)(value & 0xFF);
+        buf[pos++] = (uint8_t)((value >> 8) & 0xFF);
+        buf[pos++] = (uint8_t)((value >> 16) & 0xFF);
+        buf[pos++] = (uint8_t)((value >> 24) & 0xFF);
+    }
+    for (size_t i = 0; i < 8; i++)
+    {
+        buf[pos++] = (uint8_t)((timestamp_us >> (8 * i)) & 0xFF);
+    }
+
+    // From core 1: cmds_register_write() takes care of the I2C ISR reading the map on core 0
+    cmds_register_write(SENSORS_REG_ORIENTATION, buf, pos);
+}
+
+void fusion_process(void)
+{
+    // The filter's state, carried from one batch to the next
+    static int64_t q[4] = { FUSION_ONE, 0, 0, 0 };
+    while (true)
+    {
+        uint32_t tail = ring_tail;
+        uint32_t head = ring_head;
+        if (tail == head)
+        {
+            return;
+        }
+
+        __dmb();
+        uint64_t timestamp_us = ring_newest_timestamp_us;
+        const uint32_t config = step_config;
+        const fusion_steps_t *steps = &STEPS[config & 0xFF];
+        const int64_t gyro_step = steps->gyro << (config >> 8);
+        for (; tail != head; tail++)
+        {
+            fusion_step(q, &ring[tail & FUSION_RING_MASK], gyro_step, steps->accel);
+        }
+        __dmb();
+        ring_tail = tail;
+
+        orientation_seq++;
+        __dmb();
+        orientation.w = (int32_t)q[0];
+        orientation.x = (int32_t)q[1];
+        orientation.y = (int32_t)q[2];
+        orientation.z = (int32_t)q[3];
+        orientation.timestamp_us = timestamp_us;
+        __dmb();
+        orientation_seq++;
+
+        publish_orientation(q, timestamp_us);
+    }
+}
+
+void fusion_set_imu_config(const imu_config_t *config)
+{
+    if (config->odr >= (sizeof(STEPS) / sizeof(STEPS[0])))
+    {
+        return;
+    }
+
+    // 125 dps is 1x, 250 dps (code 0) 2x, on up to 2000 dps (code 3) 16x
+    const uint32_t shift = (config->gyro_range == IMU_GYRO_RANGE_125_DPS) ? 0 : ((uint32_t)config->gyro_range + 1);
+    step_config = (shift << 8) | (uint32_t)config->odr;
+}
+
+void fusion_push_samples(const imu_sensor_values_t *samples, size_t nsamples, uint64_t newest_timestamp_us)
+{
+    uint32_t head = ring_head;
+    uint32_t room = FUSION_RING_SIZE - (head - ring_tail);
+    if (nsamples > room)
+    {
+        log_warning("IMU fusion fell behind; dropping %u samples.\n", (unsigned)(nsamples - room));
+        nsamples = room;
+    }
+
+    for (size_t i = 0; i < nsamples; i++)
+    {
+        ring[(head + i) & FUSION_RING_MASK] = samples[i];
+    }
+    ring_newest_timestamp_us = newest_timestamp_us;
+
+    __dmb();
+    ring_head = head + nsamples;
+    __sev();
+}
+
+void fusion_get_orientation(fusion_orientation_t *out)
+{
+    uint32_t seq;
+    do
+    {
+        seq = orientation_seq;
+        __dmb();
+        *out = orientation;
+        __dmb();
+    } while ((seq & 1) || (seq != orientation_seq));
+}
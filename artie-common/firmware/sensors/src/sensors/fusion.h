@@ -0,0 +1,57 @@
+/**
+ * @file fusion.h
+ * @brief Orientation estimate from the IMU, computed on core 1.
+ * Runs a fixed-point complementary filter (gyro integration, corrected
+ * toward gravity by the accelerometer) over every FIFO sample.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "imu.h"
+
+/** Number of fractional bits in the quaternion components. 1.0 is (1 << FUSION_Q). */
+#define FUSION_Q 30
+
+/** Orientation as a unit quaternion (body to world), in Q2.30. */
+typedef struct {
+    int32_t w;
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    uint64_t timestamp_us;  // Time (since boot) of the newest sample that went into this estimate
+} fusion_orientation_t;
+
+/**
+ * @brief Filter the samples waiting, then return. Call from the acquisition core's loop
+ * (core 1) whenever it wakes: fusion_push_samples() wakes it.
+ */
+void fusion_process(void);
+
+/**
+ * @brief Tell the filter the IMU's rate and gyro full scale changed (see imu_configure()).
+ * The samples it already has are taken to be at the new ones too. It starts at IMU_DEFAULT_CONFIG's.
+ */
+void fusion_set_imu_config(const imu_config_t *config);
+
+/**
+ * @brief Hand samples to the filter. Does not block; call from the IMU batch path.
+ * If fusion_process() has fallen behind and there isn't room, the oldest unprocessed samples are kept
+ * and these are dropped.
+ *
+ * @param samples Samples, oldest first, at the IMU's ODR.
+ * @param nsamples How many.
+ * @param newest_timestamp_us When the newest of these was ready, in us since boot (its sensors_stamp_t).
+ */
+void fusion_push_samples(const imu_sensor_values_t *samples, size_t nsamples, uint64_t newest_timestamp_us);
+
+/** Copy out the latest orientation estimate. Consistent; safe from either core, and does not block the filter. */
+void fusion_get_orientation(fusion_orientation_t *orientation);
+
+#ifdef __cplusplus
+}
+#endif
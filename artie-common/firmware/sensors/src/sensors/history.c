@@ -0,0 +1,240 @@
+// Stdlib includes
+#include <stdbool.h>
+// SDK includes
+#include "pico/sync.h"
+// Local includes
+#include "history.h"
+
+#if (SENSORS_HISTORY_RAW_LEN & (SENSORS_HISTORY_RAW_LEN - 1)) != 0
+    #error "SENSORS_HISTORY_RAW_LEN must be a power of two"
+#endif
+#if (SENSORS_HISTORY_ROLLUP_LEN & (SENSORS_HISTORY_ROLLUP_LEN - 1)) != 0
+    #error "SENSORS_HISTORY_ROLLUP_LEN must be a power of two"
+#endif
+
+/** IMU channels in a record, in the order they're packed: accel X, Y, Z, then gyro X, Y, Z. */
+#define IMU_CHANNELS 6
+
+/** Rollup levels (every level but raw), and the ms each of their windows spans. */
+#define NUM_ROLLUP_LEVELS (HISTORY_NUM_LEVELS - 1)
+static const uint32_t ROLLUP_WINDOW_MS[NUM_ROLLUP_LEVELS] = { 100, 1000 };
+
+/** An IMU sample and when it was taken. */
+typedef struct {
+    uint32_t timestamp_ms;
+    int16_t channels[IMU_CHANNELS];
+} raw_record_t;
+
+/** The samples over one window. */
+typedef struct {
+    uint32_t timestamp_ms;              // Start of the window
+    uint16_t count;
+    int16_t min[IMU_CHANNELS];
+    int16_t max[IMU_CHANNELS];
+    int16_t mean[IMU_CHANNELS];
+    temp_sensor_values_t environment;
+} rollup_record_t;
+
+/** A window being rolled up. */
+typedef struct {
+    uint32_t start_ms;
+    uint32_t count;                     // 0 until the window's first sample
+    int16_t min[IMU_CHANNELS];
+    int16_t max[IMU_CHANNELS];
+    int32_t sum[IMU_CHANNELS];          // A second of int16s at 6.66 kHz fits
+} rollup_acc_t;
+
+/** The rings. Each is indexed by sequence number (records written so far), masked. */
+static raw_record_t raw_ring[SENSORS_HISTORY_RAW_LEN];
+static rollup_record_t rollup_rings[NUM_ROLLUP_LEVELS][SENSORS_HISTORY_ROLLUP_LEN];
+
+/** The windows being rolled up. */
+static rollup_acc_t rollup_accs[NUM_ROLLUP_LEVELS];
+
+/** Sequence number of the next record to write, by level. */
+static uint32_t heads[HISTORY_NUM_LEVELS];
+
+/** Sequence number of the next record to hand the controller, by level. */
+static uint32_t cursors[HISTORY_NUM_LEVELS];
+
+/** The latest environment values, for the rollups. */
+static temp_sensor_values_t environment;
+
+/** Guards all of the above. The IMU adds from the DMA IRQ, and pages are packed from the command path. */
+static critical_section_t history_crit;
+
+/** Records each level's ring holds. */
+static inline uint32_t ring_len(history_level_t level)
+{
+    return (level == HISTORY_LEVEL_RAW) ? SENSORS_HISTORY_RAW_LEN : SENSORS_HISTORY_ROLLUP_LEN;
+}
+
+/** Append a little-endian value of `nbytes` bytes to `buf` at `*pos`. */
+static inline void pack_le(uint8_t *buf, size_t *pos, uint32_t value, size_t nbytes)
+{
+    for (size_t i = 0; i < nbytes; i++)
+    {
+        buf[(*pos)++] = (uint8_t)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/** Close a window: write its rollup to its level's ring. */
+static void rollup_close(size_t index)
+{
+    const history_level_t level = (history_level_t)(index + 1);
+    const rollup_acc_t *acc = &rollup_accs[index];
+    rollup_record_t *record = &rollup_rings[index][heads[level] & (SENSORS_HISTORY_ROLLUP_LEN - 1)];
+
+    record->timestamp_ms = acc->start_ms;
+    record->count = (acc->count > UINT16_MAX) ? UINT16_MAX : (uint16_t)acc->count;
+    for (size_t c = 0; c < IMU_CHANNELS; c++)
+    {
+        record->min[c] = acc->min[c];
+        record->max[c] = acc->max[c];
+        record->mean[c] = (int16_t)(acc->sum[c] / (int32_t)acc->count);
+    }
+    record->environment = environment;
+    heads[level]++;
+}
+
+/** Add a sample to a level's window, closing the window first if the sample is past it. */
+static void rollup_add(size_t index, uint32_t timestamp_ms, const int16_t *channels)
+{
+    rollup_acc_t *acc = &rollup_accs[index];
+    const uint32_t window_ms = ROLLUP_WINDOW_MS[index];
+    if ((acc->count > 0) && ((timestamp_ms - acc->start_ms) >= window_ms))
+    {
+        rollup_close(index);
+        acc->count = 0;
+    }
+
+    if (acc->count == 0)
+    {
+        // Windows line up with the clock, so the levels' windows nest
+        acc->start_ms = timestamp_ms - (timestamp_ms % window_ms);
+        for (size_t c = 0; c < IMU_CHANNELS; c++)
+        {
+            acc->min[c] = channels[c];
+            acc->max[c] = channels[c];
+            acc->sum[c] = 0;
+        }
+    }
+
+    for (size_t c = 0; c < IMU_CHANNELS; c++)
+    {
+        acc->min[c] = (channels[c] < acc->min[c]) ? channels[c] : acc->min[c];
+        acc->max[c] = (channels[c] > acc->max[c]) ? channels[c] : acc->max[c];
+        acc->sum[c] += channels[c];
+    }
+    acc->count++;
+}
+
+void history_init(void)
+{
+    critical_section_init(&history_crit);
+}
+
+void history_add_imu(const imu_sensor_values_t *samples, size_t nsamples, uint64_t newest_us, uint32_t period_us)
+{
+    critical_section_enter_blocking(&history_crit);
+    for (size_t i = 0; i < nsamples; i++)
+    {
+        // The FIFO doesn't timestamp its samples, so count back from the newest at the IMU's rate
+        const uint64_t timestamp_us = newest_us - ((uint64_t)(nsamples - 1 - i) * period_us);
+        raw_record_t *record = &raw_ring[heads[HISTORY_LEVEL_RAW] & (SENSORS_HISTORY_RAW_LEN - 1)];
+        record->timestamp_ms = (uint32_t)(timestamp_us / 1000U);
+        record->channels[0] = samples[i].accel_x;
+        record->channels[1] = samples[i].accel_y;
+        record->channels[2] = samples[i].accel_z;
+        record->channels[3] = samples[i].gyro_x;
+        record->channels[4] = samples[i].gyro_y;
+        record->channels[5] = samples[i].gyro_z;
+        heads[HISTORY_LEVEL_RAW]++;
+
+        for (size_t r = 0; r < NUM_ROLLUP_LEVELS; r++)
+        {
+            rollup_add(r, record->timestamp_ms, record->channels);
+        }
+    }
+    critical_section_exit(&history_crit);
+}
+
+void history_set_environment(const temp_sensor_values_t *values)
+{
+    critical_section_enter_blocking(&history_crit);
+    environment = *values;
+    critical_section_exit(&history_crit);
+}
+
+/** Pack one record of `level` (sequence number `seq`) into `buf` at `*pos`. */
+static void pack_record(history_level_t level, uint32_t seq, uint8_t *buf, size_t *pos)
+{
+    if (level == HISTORY_LEVEL_RAW)
+    {
+        const raw_record_t *record = &raw_ring[seq & (SENSORS_HISTORY_RAW_LEN - 1)];
+        pack_le(buf, pos, record->timestamp_ms, 4);
+        for (size_t c = 0; c < IMU_CHANNELS; c++)
+        {
+            pack_le(buf, pos, (uint16_t)record->channels[c], 2);
+        }
+        return;
+    }
+
+    const rollup_record_t *record = &rollup_rings[level - 1][seq & (SENSORS_HISTORY_ROLLUP_LEN - 1)];
+    pack_le(buf, pos, record->timestamp_ms, 4);
+    pack_le(buf, pos, record->count, 2);
+    for (size_t c = 0; c < IMU_CHANNELS; c++)
+    {
+        pack_le(buf, pos, (uint16_t)record->min[c], 2);
+    }
+    for (size_t c = 0; c < IMU_CHANNELS; c++)
+    {
+        pack_le(buf, pos, (uint16_t)record->max[c], 2);
+    }
+    for (size_t c = 0; c < IMU_CHANNELS; c++)
+    {
+        pack_le(buf, pos, (uint16_t)record->mean[c], 2);
+    }
+    pack_le(buf, pos, (uint32_t)record->environment.temperature_centi_c, 4);
+    pack_le(buf, pos, record->environment.pressure_pa_q24_8, 4);
+    pack_le(buf, pos, record->environment.humidity_percent_rh_q22_10, 4);
+}
+
+size_t history_read_page(history_level_t level, uint8_t *buf, size_t len)
+{
+    if ((level >= HISTORY_NUM_LEVELS) || (len < HISTORY_PAGE_HEADER_LEN))
+    {
+        return 0;
+    }
+
+    const size_t record_len = (level == HISTORY_LEVEL_RAW) ? HISTORY_RAW_RECORD_LEN : HISTORY_ROLLUP_RECORD_LEN;
+    const uint32_t max_records = (uint32_t)((len - HISTORY_PAGE_HEADER_LEN) / record_len);
+
+    critical_section_enter_blocking(&history_crit);
+    // Anything older than a ring's worth behind the head has been overwritten
+    uint32_t lost = 0;
+    if ((heads[level] - cursors[level]) > ring_len(level))
+    {
+        lost = heads[level] - cursors[level] - ring_len(level);
+        cursors[level] = heads[level] - ring_len(level);
+    }
+
+    uint32_t count = heads[level] - cursors[level];
+    count = (count > max_records) ? max_records : count;
+    count = (count > UINT8_MAX) ? UINT8_MAX : count;
+
+    size_t pos = 0;
+    buf[pos++] = HISTORY_PAGE_VERSION;
+    buf[pos++] = (uint8_t)level;
+    buf[pos++] = (uint8_t)count;
+    buf[pos++] = (lost > UINT8_MAX) ? UINT8_MAX : (uint8_t)lost;
+    pack_le(buf, &pos, cursors[level], 4);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pack_record(level, cursors[level] + i, buf, &pos);
+    }
+    cursors[level] += count;
+    critical_section_exit(&history_crit);
+
+    return pos;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file history.h
+ * @brief History of the sensor values, at several resolutions.
+ * Keeps every IMU sample for a little while, and rollups (min, max, and mean) over 100 ms and 1 s
+ * windows for longer, so the controller can fetch what it missed, at the fidelity it wants, in pages.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "imu.h"
+#include "temp.h"
+
+#ifndef SENSORS_HISTORY_RAW_LEN
+    /** IMU samples kept (a power of two). 256 is about 1.2 s at 208 Hz. */
+    #define SENSORS_HISTORY_RAW_LEN 256U
+#endif // SENSORS_HISTORY_RAW_LEN
+
+#ifndef SENSORS_HISTORY_ROLLUP_LEN
+    /** Rollups kept at each of the 100 ms and 1 s resolutions (a power of two). 256 is 25.6 s and 4 minutes. */
+    #define SENSORS_HISTORY_ROLLUP_LEN 256U
+#endif // SENSORS_HISTORY_ROLLUP_LEN
+
+/** The resolutions the history is kept at. */
+typedef enum {
+    HISTORY_LEVEL_RAW       = 0,    // Every IMU sample
+    HISTORY_LEVEL_100_MS    = 1,    // Rollups over 100 ms
+    HISTORY_LEVEL_1_S       = 2,    // Rollups over 1 s
+    HISTORY_NUM_LEVELS,
+} history_level_t;
+
+/** Layout version of a history page. Bump this if the layout changes. */
+#define HISTORY_PAGE_VERSION        0x01
+
+/** Bytes of a page's header: version, level, records, records lost, then the first record's sequence number (4). */
+#define HISTORY_PAGE_HEADER_LEN     8U
+
+/** Bytes of a raw record: timestamp (ms since boot, 4), then accel X, Y, Z and gyro X, Y, Z (int16, raw). */
+#define HISTORY_RAW_RECORD_LEN      16U
+
+/**
+ * Bytes of a rollup record: the window's start (ms since boot, 4), samples in it (2), the minimum,
+ * maximum, and mean of accel X, Y, Z and gyro X, Y, Z (6 int16s each), then the environment as in
+ * the burst read (12), as last read by the end of the window.
+ */
+#define HISTORY_ROLLUP_RECORD_LEN   54U
+
+/** Start keeping history. Call once, before anything else here. */
+void history_init(void);
+
+/**
+ * @brief Add a batch of IMU samples. Safe from IRQs.
+ *
+ * @param samples Samples, oldest first.
+ * @param nsamples How many.
+ * @param newest_us When the newest of these was ready, in us since boot (its sensors_stamp_t).
+ * @param period_us The time between samples (the IMU's rate).
+ */
+void history_add_imu(const imu_sensor_values_t *samples, size_t nsamples, uint64_t newest_us, uint32_t period_us);
+
+/** @brief Note the latest environment values, for the rollups. Safe from IRQs. */
+void history_set_environment(const temp_sensor_values_t *values);
+
+/**
+ * @brief Pack the next page of a level's history: as many of the records not already packed as fit,
+ * oldest first. If the ring has overwritten some before they were packed, the page starts at the
+ * oldest one left, and its header says how many were lost.
+ *
+ * @param level Which resolution.
+ * @param buf Where to pack the page.
+ * @param len How many bytes `buf` holds. At least HISTORY_PAGE_HEADER_LEN.
+ * @return size_t The bytes packed: the header, then the records.
+ */
+size_t history_read_page(history_level_t level, uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,802 @@
+// Stdlib includes
+// SDK includes
+#include <pico/stdlib.h>
+// Library includes
+#include <errors.h>
+// Local includes
+#include "../board/pinconfig.h"
+#include "imu.h"
+#include "spi_interface.h"
+
+/** LSM6DSO register addresses */
+#define LSM_REG_FUNC_CFG_ACCESS             0x01
+#define LSM_REG_PIN_CTRL                    0x02
+#define LSM_REG_FIFO_CTRL1                  0x07
+#define LSM_REG_FIFO_CTRL2                  0x08
+#define LSM_REG_FIFO_CTRL3                  0x09
+#define LSM_REG_FIFO_CTRL4                  0x0A
+#define LSM_REG_COUNTER_BDR_REG1            0x0B
+#define LSM_REG_COUNTER_BDR_REG2            0x0C
+#define LSM_REG_INT1_CTRL                   0x0D
+#define LSM_REG_INT2_CTRL                   0x0E
+#define LSM_REG_WHO_AM_I                    0x0F
+#define LSM_REG_CTRL1_XL                    0x10
+#define LSM_REG_CTRL2_G                     0x11
+#define LSM_REG_CTRL3_C                     0x12
+#define LSM_REG_CTRL4_C                     0x13
+#define LSM_REG_CTRL5_C                     0x14
+#define LSM_REG_CTRL6_C                     0x15
+#define LSM_REG_CTRL7_G                     0x16
+#define LSM_REG_CTRL8_XL                    0x17
+#define LSM_REG_CTRL9_XL                    0x18
+#define LSM_REG_CTRL10_C                    0x19
+#define LSM_REG_ALL_INT_SRC                 0x1A
+#define LSM_REG_WAKE_UP_SRC                 0x1B
+#define LSM_REG_TAP_SRC                     0x1C
+#define LSM_REG_D6D_SRC                     0x1D
+#define LSM_REG_STATUS_REG                  0x1E
+#define LSM_REG_OUT_TEMP_L                  0x20
+#define LSM_REG_OUT_TEMP_H                  0x21
+#define LSM_REG_OUTX_L_G                    0x22
+#define LSM_REG_OUTX_H_G                    0x23
+#define LSM_REG_OUTY_L_G                    0x24
+#define LSM_REG_OUTY_H_G                    0x25
+#define LSM_REG_OUTZ_L_G                    0x26
+#define LSM_REG_OUTZ_H_G                    0x27
+#define LSM_REG_OUTX_L_A                    0x28
+#define LSM_REG_OUTX_H_A                    0x29
+#define LSM_REG_OUTY_L_A                    0x2A
+#define LSM_REG_OUTY_H_A                    0x2B
+#define LSM_REG_OUTZ_L_A                    0x2C
+#define LSM_REG_OUTZ_H_A                    0x2D
+#define LSM_REG_EMB_FUNC_STATUS_MAINPAGE    0x35
+#define LSM_REG_FSM_STATUS_A_MAINPAGE       0x36
+#define LSM_REG_FSM_STATUS_B_MAINPAGE       0x37
+#define LSM_REG_STATUS_MASTER_MAINPAGE      0x39
+#define LSM_REG_FIFO_STATUS1                0x3A
+#define LSM_REG_FIFO_STATUS2                0x3B
+#define LSM_REG_TIMESTAMP0                  0x40
+#define LSM_REG_TIMESTAMP1                  0x41
+#define LSM_REG_TIMESTAMP2                  0x42
+#define LSM_REG_TIMESTAMP3                  0x43
+#define LSM_REG_TAP_CFG0                    0x56
+#define LSM_REG_TAP_CFG1                    0x57
+#define LSM_REG_TAP_CFG2                    0x58
+#define LSM_REG_TAP_THS_6D                  0x59
+#define LSM_REG_INT_DUR2                    0x5A
+#define LSM_REG_WAKE_UP_THS                 0x5B
+#define LSM_REG_WAKE_UP_DUR                 0x5C
+#define LSM_REG_FREE_FALL                   0x5D
+#define LSM_REG_MD1_CFG                     0x5E
+#define LSM_REG_MD2_CFG                     0x5F
+#define LSM_REG_i3C_BUS_AVB                 0x62
+#define LSM_REG_INTERNAL_FREQ_FINE          0x63
+#define LSM_REG_INT_OIS                     0x6F
+#define LSM_REG_CTRL1_OIS                   0x70
+#define LSM_REG_CTRL2_OIS                   0x71
+#define LSM_REG_CTRL3_OIS                   0x72
+#define LSM_REG_X_OFS_USR                   0x73
+#define LSM_REG_Y_OFS_USR                   0x74
+#define LSM_REG_Z_OFS_USR                   0x75
+#define LSM_REG_FIFO_DATA_OUT_TAG           0x78
+#define LSM_REG_FIFO_DATA_OUT_X_L           0x79
+#define LSM_REG_FIFO_DATA_OUT_X_H           0x7A
+#define LSM_REG_FIFO_DATA_OUT_Y_L           0x7B
+#define LSM_REG_FIFO_DATA_OUT_Y_H           0x7C
+#define LSM_REG_FIFO_DATA_OUT_Z_L           0x7D
+#define LSM_REG_FIFO_DATA_OUT_Z_H           0x7E
+
+/** WHO_AM_I of an LSM6DSO. */
+#define LSM_WHO_AM_I_LSM6DSO                0x6C
+
+/** CTRL1_XL: enable the accelerometer's second low-pass stage, whose cutoff is CTRL8_XL's HPCF_XL. */
+#define LSM_CTRL1_XL_LPF2_XL_EN             0x02
+
+/** CTRL2_G: 125 dps full scale, which overrides FS_G. */
+#define LSM_CTRL2_G_FS_125                  0x02
+
+/** CTRL6_C: leave the accelerometer's high-performance mode. Gyro LPF1 bandwidth (FTYPE) 12.2 Hz at 208 Hz. */
+#define LSM_CTRL6_C_XL_HM_MODE              0x10
+#define LSM_CTRL6_C_FTYPE_7                 0x07
+
+/** CTRL7_G: leave the gyro's high-performance mode. */
+#define LSM_CTRL7_G_G_HM_MODE               0x80
+
+/** CTRL8_XL: the 6D function uses the low-pass filtered accelerometer data. */
+#define LSM_CTRL8_XL_LOW_PASS_ON_6D         0x01
+
+/** Highest output data rate code (IMU_ODR_6660_HZ). */
+#define LSM_ODR_MAX                         0x0A
+
+/** FIFO_CTRL4 FIFO_MODE: continuous mode (oldest samples are overwritten once the FIFO is full). */
+#define LSM_FIFO_MODE_CONTINUOUS            0x06
+
+/** INT1_CTRL: route the FIFO watermark flag to INT1. */
+#define LSM_INT1_FIFO_TH                    0x08
+
+/** FIFO_STATUS2: the number of unread words is 10 bits wide; these are the top two. */
+#define LSM_FIFO_STATUS2_DIFF_MASK          0x03
+
+/** FIFO_STATUS2: the FIFO overflowed and we lost samples. */
+#define LSM_FIFO_STATUS2_OVR                0x40
+
+/**
+ * FIFO tag sensor IDs (upper five bits of the tag byte). NC words are whole samples: at the
+ * word's time slot, or the one (T_1) or two (T_2) before. 2xC words are two samples as 8 bit
+ * differences, and 3xC words three as 5 bit differences, each from the sample before it.
+ */
+#define LSM_FIFO_TAG_GYRO_NC                0x01
+#define LSM_FIFO_TAG_ACCEL_NC               0x02
+#define LSM_FIFO_TAG_GYRO_NC_T_2            0x06
+#define LSM_FIFO_TAG_GYRO_NC_T_1            0x07
+#define LSM_FIFO_TAG_GYRO_2XC               0x08
+#define LSM_FIFO_TAG_GYRO_3XC               0x09
+#define LSM_FIFO_TAG_ACCEL_NC_T_2           0x0A
+#define LSM_FIFO_TAG_ACCEL_NC_T_1           0x0B
+#define LSM_FIFO_TAG_ACCEL_2XC              0x0C
+#define LSM_FIFO_TAG_ACCEL_3XC              0x0D
+
+/** FUNC_CFG_ACCESS: switch the register addresses over to the embedded functions page. */
+#define LSM_FUNC_CFG_ACCESS_EMB_FUNC        0x80
+
+/** Embedded functions page: EMB_FUNC_EN_B, and its FIFO compression enable. */
+#define LSM_EMB_REG_EMB_FUNC_EN_B           0x05
+#define LSM_EMB_FUNC_EN_B_FIFO_COMPR_EN     0x08
+
+/**
+ * FIFO_CTRL2: compress at run time, and write a whole (uncompressed) sample at least every
+ * 16 batches, so the samples come right again soon after a word is lost to an overflow.
+ */
+#define LSM_FIFO_CTRL2_FIFO_COMPR_RT_EN     0x40
+#define LSM_FIFO_CTRL2_UNCOPTR_RATE_16      0x04
+
+/** Each FIFO word is a tag byte followed by X, Y, Z as little-endian int16s. */
+#define LSM_FIFO_WORD_BYTES                 7
+
+/** Each (gyro, accel) sample takes two FIFO words. */
+#define LSM_FIFO_WORDS_PER_SAMPLE           2
+
+/** The FIFO holds this many words at most. */
+#define LSM_FIFO_MAX_WORDS                  512
+
+/** How many FIFO words we pull in one SPI burst. */
+#define IMU_FIFO_BURST_WORDS                16
+
+/** TAP_CFG0: latch event interrupts until their source is read, clear on that read, and tap on all axes. */
+#define LSM_TAP_CFG0_LIR                    0x01
+#define LSM_TAP_CFG0_TAP_XYZ_EN             0x0E
+#define LSM_TAP_CFG0_INT_CLR_ON_READ        0x40
+
+/** TAP_CFG2: enable the embedded event functions (tap, free-fall, wake-up, 6D). */
+#define LSM_TAP_CFG2_INTERRUPTS_ENABLE      0x80
+
+/** WAKE_UP_THS: recognize double taps as well as single ones. */
+#define LSM_WAKE_UP_THS_SINGLE_DOUBLE_TAP   0x80
+
+/** MD2_CFG: route each event to INT2. */
+#define LSM_MD2_INT2_6D                     0x04
+#define LSM_MD2_INT2_DOUBLE_TAP             0x08
+#define LSM_MD2_INT2_FF                     0x10
+#define LSM_MD2_INT2_WU                     0x20
+#define LSM_MD2_INT2_SINGLE_TAP             0x40
+
+/** WAKE_UP_SRC, TAP_SRC, and D6D_SRC: an event happened, and the bits with its details. */
+#define LSM_WAKE_UP_SRC_FF_IA               0x20
+#define LSM_WAKE_UP_SRC_WU_IA               0x08
+#define LSM_WAKE_UP_SRC_AXES                0x07
+#define LSM_TAP_SRC_SINGLE_TAP              0x20
+#define LSM_TAP_SRC_DOUBLE_TAP              0x10
+#define LSM_TAP_SRC_AXIS_SIGN               0x0F
+#define LSM_D6D_SRC_D6D_IA                  0x40
+#define LSM_D6D_SRC_ORIENTATION             0x3F
+
+/*
+ * Event thresholds and timings, in g and ms. The registers count in steps of the accelerometer's
+ * full scale and of samples, so they are worked out again for each configuration (see events_configure()).
+ */
+/** Tap threshold on each axis (TAP_CFG1, TAP_CFG2, TAP_THS_6D), in steps of full scale / 32. */
+#define LSM_TAP_THRESHOLD_MG                560U
+/** 6D threshold (TAP_THS_6D SIXD_THS): 60 degrees. */
+#define LSM_SIXD_THS_60_DEG                 (0x02 << 5)
+/** INT_DUR2 DUR: a double tap's second tap within this, in steps of 32 samples. */
+#define LSM_TAP_DOUBLE_WINDOW_MS            1080U
+/** INT_DUR2 QUIET: quiet between the taps of a double tap, in steps of 4 samples. */
+#define LSM_TAP_QUIET_MS                    58U
+/** INT_DUR2 SHOCK: each tap over within this, in steps of 8 samples. */
+#define LSM_TAP_SHOCK_MS                    115U
+/** Wake-up threshold (WAKE_UP_THS WK_THS), in steps of full scale / 64. */
+#define LSM_WAKE_THRESHOLD_MG               63U
+/** WAKE_UP_DUR: over the wake-up threshold for one sample. Its top bit is FF_DUR's, which stays clear. */
+#define LSM_WAKE_UP_DUR                     0x00
+/** FREE_FALL FF_THS: under 312 mg, which is the same at every full scale. */
+#define LSM_FREE_FALL_THS_312_MG            0x03
+/** FREE_FALL FF_DUR: under the free-fall threshold for this long, in samples. */
+#define LSM_FREE_FALL_MS                    30U
+
+static inline void blocking_write(uint8_t reg, uint8_t byte)
+{
+    myspi_blocking_write(SENSORS_SPI_CS_IMU, reg, byte);
+}
+
+static inline void blocking_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    // LSM6DSO requires the most significant bit to be 1 to signal a read.
+    reg |= (1 << 7);
+    myspi_blocking_read(SENSORS_SPI_CS_IMU, reg, buf, len);
+}
+
+/** Settings we start with. */
+const imu_config_t IMU_DEFAULT_CONFIG = {
+    .odr = IMU_ODR_208_HZ,
+    .accel_range = IMU_ACCEL_RANGE_8_G,
+    .gyro_range = IMU_GYRO_RANGE_500_DPS,
+    .accel_bandwidth = IMU_ACCEL_BANDWIDTH_ODR_20,
+    .low_power = false,
+};
+
+/** Output data rates, in tenths of a Hz, by imu_odr_t. */
+static const uint32_t ODR_DECIHZ[LSM_ODR_MAX + 1] = { 0, 125, 260, 520, 1040, 2080, 4160, 8330, 16600, 33300, 66600 };
+
+/** Accelerometer full scales, in mg, by imu_accel_range_t. */
+static const uint16_t ACCEL_RANGE_MG[4] = { 2000, 16000, 4000, 8000 };
+
+/** The configuration the IMU is sampling with. */
+static imu_config_t config = { 0 };
+
+/** Is the FIFO batching (see imu_fifo_enable())? */
+static bool fifo_enabled = false;
+
+/** The IMU_EVENT_*s set by imu_events_enable(). */
+static uint8_t events_enabled = 0;
+
+uint32_t imu_odr_decihz(imu_odr_t odr)
+{
+    return (odr <= LSM_ODR_MAX) ? ODR_DECIHZ[odr] : 0;
+}
+
+void imu_read(imu_sensor_values_t *values)
+{
+    blocking_read(LSM_REG_OUTX_L_G, (uint8_t *)values, sizeof(imu_sensor_values_t));
+}
+
+void imu_init(void)
+{
+    // Chip select is active-low, so initialize as HIGH
+    gpio_init(SENSORS_SPI_CS_IMU);
+    gpio_set_dir(SENSORS_SPI_CS_IMU, GPIO_OUT);
+    gpio_put(SENSORS_SPI_CS_IMU, 1);
+
+    // Sanity check that we can read a value from the chip (read the ID)
+    uint8_t id;
+    blocking_read(LSM_REG_WHO_AM_I, &id, sizeof(id));
+    if (id != LSM_WHO_AM_I_LSM6DSO)
+    {
+        log_error("LSM IMU reads id 0x%x, but should be 0x6C.\n", id);
+    }
+
+    // Reset the sensor
+    blocking_write(LSM_REG_CTRL3_C, 0x85);
+    sleep_ms(5);
+
+    // Disable compression
+    blocking_write(LSM_REG_FIFO_CTRL2, 0x00);
+    // Disable FIFO
+    blocking_write(LSM_REG_FIFO_CTRL4, 0x00);
+    // Don't signal data ready until filter settling ends, disable i2c, enable gyro LPF1
+    blocking_write(LSM_REG_CTRL4_C, 0x0E);
+    // Disable data-enable bits being embedded into the sensor values, disable I3C interface
+    blocking_write(LSM_REG_CTRL9_XL, 0x02);
+
+    // And start sampling
+    imu_configure(&IMU_DEFAULT_CONFIG);
+}
+
+/** Write the event thresholds and timings (see LSM_TAP_THRESHOLD_MG and the rest) for the current configuration. */
+static void events_configure(void);
+
+void imu_configure(const imu_config_t *new_config)
+{
+    if ((new_config->odr > LSM_ODR_MAX) || (new_config->accel_range > IMU_ACCEL_RANGE_8_G) ||
+        (new_config->gyro_range > IMU_GYRO_RANGE_125_DPS) || (new_config->accel_bandwidth > IMU_ACCEL_BANDWIDTH_ODR_800))
+    {
+        log_error("IMU configuration (ODR %u, ranges %u and %u, bandwidth %u) is out of range.\n",
+                  new_config->odr, new_config->accel_range, new_config->gyro_range, new_config->accel_bandwidth);
+        return;
+    }
+    config = *new_config;
+
+    // Filters and power mode first, so the sensors start (or carry on) with them
+    blocking_write(LSM_REG_CTRL6_C, (config.low_power ? LSM_CTRL6_C_XL_HM_MODE : 0) | LSM_CTRL6_C_FTYPE_7);
+    blocking_write(LSM_REG_CTRL7_G, config.low_power ? LSM_CTRL7_G_G_HM_MODE : 0);
+    // HPCF_XL picks LPF2's cutoff: ODR / 4 (0) through ODR / 800 (7). We only use ODR / 10 and narrower.
+    const bool lpf2 = (config.accel_bandwidth != IMU_ACCEL_BANDWIDTH_ODR_2);
+    blocking_write(LSM_REG_CTRL8_XL, ((uint8_t)(lpf2 ? config.accel_bandwidth : 0) << 5) | LSM_CTRL8_XL_LOW_PASS_ON_6D);
+
+    // oooo ffl0 -> (ODR) (full scale) (LPF2 enable)
+    blocking_write(LSM_REG_CTRL1_XL, ((uint8_t)config.odr << 4) | ((uint8_t)config.accel_range << 2) | (lpf2 ? LSM_CTRL1_XL_LPF2_XL_EN : 0));
+    // oooo ff10 -> (ODR) (full scale) (125 dps)
+    const bool fs_125 = (config.gyro_range == IMU_GYRO_RANGE_125_DPS);
+    blocking_write(LSM_REG_CTRL2_G, ((uint8_t)config.odr << 4) | ((uint8_t)(fs_125 ? 0 : config.gyro_range) << 2) | (fs_125 ? LSM_CTRL2_G_FS_125 : 0));
+
+    if (fifo_enabled)
+    {
+        // Batch both at the new rate. The words already in the FIFO are at the old one.
+        blocking_write(LSM_REG_FIFO_CTRL3, ((uint8_t)config.odr << 4) | (uint8_t)config.odr);
+    }
+    if (events_enabled != 0)
+    {
+        imu_events_enable(events_enabled);
+    }
+}
+
+void imu_get_config(imu_config_t *out)
+{
+    *out = config;
+}
+
+/** X, Y, and Z of one sensor. */
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} fifo_xyz_t;
+
+/** Samples of one sensor a queue can hold (a power of two). */
+#define FIFO_QUEUE_LEN 16U
+#define FIFO_QUEUE_MASK (FIFO_QUEUE_LEN - 1)
+
+/**
+ * One sensor's samples, decoded from the FIFO, waiting for the other sensor's to pair with.
+ * A word can hold up to three samples of one sensor, so the two don't always come out together.
+ */
+typedef struct {
+    fifo_xyz_t samples[FIFO_QUEUE_LEN];
+    uint32_t head;
+    uint32_t tail;
+    fifo_xyz_t last;    // The newest sample, which a compressed word's first difference is from
+} fifo_queue_t;
+
+/** The gyro and accel samples decoded but not yet handed out. They must survive until the next read. */
+static fifo_queue_t gyro_queue = { 0 };
+static fifo_queue_t accel_queue = { 0 };
+
+/** Forget the samples waiting to be paired, so the two sensors line up again. */
+static void fifo_queues_reset(void)
+{
+    gyro_queue.tail = gyro_queue.head;
+    accel_queue.tail = accel_queue.head;
+}
+
+/** Work out the number of words waiting in the FIFO from FIFO_STATUS1 and FIFO_STATUS2. */
+static uint16_t fifo_words_from_status(const uint8_t status[2])
+{
+    if (status[1] & LSM_FIFO_STATUS2_OVR)
+    {
+        log_warning("IMU FIFO overflowed; samples were lost.\n");
+        // The words lost may have been either sensor's
+        fifo_queues_reset();
+    }
+    return (uint16_t)(status[0] | ((status[1] & LSM_FIFO_STATUS2_DIFF_MASK) << 8));
+}
+
+/** Read the number of words waiting in the FIFO. */
+static uint16_t fifo_words_available(void)
+{
+    uint8_t status[2];
+    blocking_read(LSM_REG_FIFO_STATUS1, status, sizeof(status));
+    return fifo_words_from_status(status);
+}
+
+/** How many words to pull in the next burst, given how many are waiting and how many samples we have room for. */
+static inline uint16_t fifo_burst_words(uint16_t words, size_t room_samples)
+{
+#if IMU_FIFO_COMPRESSION
+    // A 3xC word of each sensor is three samples, so only read what (at best) fills the room
+    uint16_t room = (uint16_t)((room_samples * LSM_FIFO_WORDS_PER_SAMPLE) / 3);
+    room = (room == 0) ? 1 : room;
+#else
+    uint16_t room = (uint16_t)(room_samples * LSM_FIFO_WORDS_PER_SAMPLE);
+#endif // IMU_FIFO_COMPRESSION
+    uint16_t burst = words;
+    burst = (burst > IMU_FIFO_BURST_WORDS) ? IMU_FIFO_BURST_WORDS : burst;
+    burst = (burst > room) ? room : burst;
+    return burst;
+}
+
+/** Queue a decoded sample, which is also the one the next differences are from. */
+static void fifo_queue_push(fifo_queue_t *queue, const fifo_xyz_t *sample)
+{
+    queue->last = *sample;
+    if ((queue->head - queue->tail) >= FIFO_QUEUE_LEN)
+    {
+        // One sensor is far ahead of the other, so they no longer pair up. Start again.
+        log_warning("IMU FIFO samples are out of step; dropping the unpaired ones.\n");
+        fifo_queues_reset();
+    }
+    queue->samples[queue->head++ & FIFO_QUEUE_MASK] = *sample;
+}
+
+/** Sign-extend the 5 bit difference at bit `shift` of a 3xC word's 16 bits. */
+static inline int16_t diff_5bit(uint16_t bits, unsigned shift)
+{
+    const int16_t diff = (int16_t)((bits >> shift) & 0x1F);
+    return (diff >= 16) ? (int16_t)(diff - 32) : diff;
+}
+
+/** Queue the whole sample in an NC word's data. */
+static void decode_nc(fifo_queue_t *queue, const uint8_t *data)
+{
+    const fifo_xyz_t sample = {
+        .x = (int16_t)(data[0] | (data[1] << 8)),
+        .y = (int16_t)(data[2] | (data[3] << 8)),
+        .z = (int16_t)(data[4] | (data[5] << 8)),
+    };
+    fifo_queue_push(queue, &sample);
+}
+
+/** Queue the two samples in a 2xC word's data: X, Y, Z differences of 8 bits apiece. */
+static void decode_2xc(fifo_queue_t *queue, const uint8_t *data)
+{
+    for (unsigned i = 0; i < 2; i++)
+    {
+        const fifo_xyz_t sample = {
+            .x = (int16_t)(queue->last.x + (int8_t)data[(i * 3) + 0]),
+            .y = (int16_t)(queue->last.y + (int8_t)data[(i * 3) + 1]),
+            .z = (int16_t)(queue->last.z + (int8_t)data[(i * 3) + 2]),
+        };
+        fifo_queue_push(queue, &sample);
+    }
+}
+
+/** Queue the three samples in a 3xC word's data: 16 bits apiece, X, Y, Z differences of 5 bits from the bottom. */
+static void decode_3xc(fifo_queue_t *queue, const uint8_t *data)
+{
+    for (unsigned i = 0; i < 3; i++)
+    {
+        const uint16_t bits = (uint16_t)(data[i * 2] | (data[(i * 2) + 1] << 8));
+        const fifo_xyz_t sample = {
+            .x = (int16_t)(queue->last.x + diff_5bit(bits, 0)),
+            .y = (int16_t)(queue->last.y + diff_5bit(bits, 5)),
+            .z = (int16_t)(queue->last.z + diff_5bit(bits, 10)),
+        };
+        fifo_queue_push(queue, &sample);
+    }
+}
+
+/** Decode one FIFO word into however many samples it holds, and queue them. */
+static void decode_fifo_word(const uint8_t *word)
+{
+    const uint8_t *data = &word[1];
+    switch (word[0] >> 3)
+    {
+        case LSM_FIFO_TAG_GYRO_NC:
+        case LSM_FIFO_TAG_GYRO_NC_T_1:
+        case LSM_FIFO_TAG_GYRO_NC_T_2:
+            decode_nc(&gyro_queue, data);
+            break;
+        case LSM_FIFO_TAG_ACCEL_NC:
+        case LSM_FIFO_TAG_ACCEL_NC_T_1:
+        case LSM_FIFO_TAG_ACCEL_NC_T_2:
+            decode_nc(&accel_queue, data);
+            break;
+        case LSM_FIFO_TAG_GYRO_2XC:
+            decode_2xc(&gyro_queue, data);
+            break;
+        case LSM_FIFO_TAG_ACCEL_2XC:
+            decode_2xc(&accel_queue, data);
+            break;
+        case LSM_FIFO_TAG_GYRO_3XC:
+            decode_3xc(&gyro_queue, data);
+            break;
+        case LSM_FIFO_TAG_ACCEL_3XC:
+            decode_3xc(&accel_queue, data);
+            break;
+        default:
+            // Timestamps, temperature, config changes, etc. We didn't ask for these.
+            break;
+    }
+}
+
+/**
+ * Pair up the waiting gyro and accel samples, appending them to `samples` (which holds
+ * `nsamples` already). Any that don't fit wait for the next read. Returns the new number of samples.
+ */
+static size_t pair_fifo_samples(imu_sensor_values_t *samples, size_t nsamples, size_t max_samples)
+{
+    while ((nsamples < max_samples) && (gyro_queue.head != gyro_queue.tail) && (accel_queue.head != accel_queue.tail))
+    {
+        // Both sensors batch at the same rate, so the nth of each were taken together
+        const fifo_xyz_t *gyro = &gyro_queue.samples[gyro_queue.tail++ & FIFO_QUEUE_MASK];
+        const fifo_xyz_t *accel = &accel_queue.samples[accel_queue.tail++ & FIFO_QUEUE_MASK];
+        samples[nsamples++] = (imu_sensor_values_t){
+            .gyro_x = gyro->x,
+            .gyro_y = gyro->y,
+            .gyro_z = gyro->z,
+            .accel_x = accel->x,
+            .accel_y = accel->y,
+            .accel_z = accel->z,
+        };
+    }
+    return nsamples;
+}
+
+/**
+ * Turn raw FIFO words into samples, appending to `samples` (which holds `nsamples` already).
+ * Returns the new number of samples.
+ */
+static size_t parse_fifo_words(const uint8_t *raw, uint16_t nwords, imu_sensor_values_t *samples, size_t nsamples, size_t max_samples)
+{
+    for (uint16_t i = 0; i < nwords; i++)
+    {
+        decode_fifo_word(&raw[i * LSM_FIFO_WORD_BYTES]);
+    }
+    return pair_fifo_samples(samples, nsamples, max_samples);
+}
+
+void imu_fifo_enable(uint16_t watermark_samples)
+{
+    uint16_t watermark_words = watermark_samples * LSM_FIFO_WORDS_PER_SAMPLE;
+    if ((watermark_words == 0) || (watermark_words >= LSM_FIFO_MAX_WORDS))
+    {
+        log_error("IMU FIFO watermark of %u samples is out of range.\n", watermark_samples);
+        return;
+    }
+
+    // Bypass mode first, which empties the FIFO.
+    blocking_write(LSM_REG_FIFO_CTRL4, 0x00);
+    fifo_queues_reset();
+
+#if IMU_FIFO_COMPRESSION
+    // The compression block is one of the embedded functions, enabled on their page of registers
+    blocking_write(LSM_REG_FUNC_CFG_ACCESS, LSM_FUNC_CFG_ACCESS_EMB_FUNC);
+    blocking_write(LSM_EMB_REG_EMB_FUNC_EN_B, LSM_EMB_FUNC_EN_B_FIFO_COMPR_EN);
+    blocking_write(LSM_REG_FUNC_CFG_ACCESS, 0x00);
+    const uint8_t compression = LSM_FIFO_CTRL2_FIFO_COMPR_RT_EN | LSM_FIFO_CTRL2_UNCOPTR_RATE_16;
+#else
+    const uint8_t compression = 0x00;
+#endif // IMU_FIFO_COMPRESSION
+
+    // Watermark is nine bits wide: eight in CTRL1, the ninth in bit 0 of CTRL2 (along with the compression bits).
+    blocking_write(LSM_REG_FIFO_CTRL1, (uint8_t)(watermark_words & 0xFF));
+    blocking_write(LSM_REG_FIFO_CTRL2, compression | (uint8_t)((watermark_words >> 8) & 0x01));
+    // Batch both gyro and accel at their full ODR.
+    blocking_write(LSM_REG_FIFO_CTRL3, ((uint8_t)config.odr << 4) | (uint8_t)config.odr);
+    // Signal the watermark on INT1.
+    blocking_write(LSM_REG_INT1_CTRL, LSM_INT1_FIFO_TH);
+    // And start filling.
+    blocking_write(LSM_REG_FIFO_CTRL4, LSM_FIFO_MODE_CONTINUOUS);
+    fifo_enabled = true;
+}
+
+size_t imu_read_batch(imu_sensor_values_t *samples, size_t max_samples)
+{
+    static uint8_t raw[IMU_FIFO_BURST_WORDS * LSM_FIFO_WORD_BYTES];
+
+    // Samples left over from the last read go first
+    size_t nsamples = pair_fifo_samples(samples, 0, max_samples);
+    uint16_t words = fifo_words_available();
+    while ((words > 0) && (nsamples < max_samples))
+    {
+        uint16_t burst = fifo_burst_words(words, max_samples - nsamples);
+
+        // The address wraps from the last FIFO output register back to the tag, so one read covers many words.
+        blocking_read(LSM_REG_FIFO_DATA_OUT_TAG, raw, burst * LSM_FIFO_WORD_BYTES);
+        words -= burst;
+
+        nsamples = parse_fifo_words(raw, burst, samples, nsamples, max_samples);
+    }
+
+    return nsamples;
+}
+
+/** State for an asynchronous FIFO drain. */
+static struct {
+    volatile bool busy;
+    imu_sensor_values_t *samples;
+    size_t max_samples;
+    size_t nsamples;
+    uint16_t words;
+    uint16_t burst;
+    imu_batch_done_t done;
+    uint8_t status[2];
+    uint8_t raw[IMU_FIFO_BURST_WORDS * LSM_FIFO_WORD_BYTES];
+} drain = { 0 };
+
+/** Queue the next SPI read of an asynchronous FIFO drain, or finish it. */
+static void drain_next(void);
+
+/** SPI callback: the words from the last burst have arrived. */
+static void drain_burst_cb(void *unused)
+{
+    drain.words -= drain.burst;
+    drain.nsamples = parse_fifo_words(drain.raw, drain.burst, drain.samples, drain.nsamples, drain.max_samples);
+    drain_next();
+}
+
+/** SPI callback: the FIFO status has arrived. */
+static void drain_status_cb(void *unused)
+{
+    drain.words = fifo_words_from_status(drain.status);
+    drain_next();
+}
+
+static void drain_next(void)
+{
+    if ((drain.words == 0) || (drain.nsamples >= drain.max_samples))
+    {
+        drain.busy = false;
+        drain.done(drain.samples, drain.nsamples);
+        return;
+    }
+
+    drain.burst = fifo_burst_words(drain.words, drain.max_samples - drain.nsamples);
+    myspi_transaction_t t = {
+        .cs_pin = SENSORS_SPI_CS_IMU,
+        .reg = LSM_REG_FIFO_DATA_OUT_TAG | (1 << 7),
+        .buf = drain.raw,
+        .len = drain.burst * LSM_FIFO_WORD_BYTES,
+        .callback = drain_burst_cb,
+        .ctx = NULL,
+    };
+    if (!myspi_async_read(&t))
+    {
+        drain.busy = false;
+        drain.done(drain.samples, drain.nsamples);
+    }
+}
+
+bool imu_read_batch_async(imu_sensor_values_t *samples, size_t max_samples, imu_batch_done_t done)
+{
+    if (drain.busy)
+    {
+        return false;
+    }
+
+    drain.busy = true;
+    drain.samples = samples;
+    drain.max_samples = max_samples;
+    drain.nsamples = pair_fifo_samples(samples, 0, max_samples);
+    drain.words = 0;
+    drain.done = done;
+
+    myspi_transaction_t t = {
+        .cs_pin = SENSORS_SPI_CS_IMU,
+        .reg = LSM_REG_FIFO_STATUS1 | (1 << 7),
+        .buf = drain.status,
+        .len = sizeof(drain.status),
+        .callback = drain_status_cb,
+        .ctx = NULL,
+    };
+    if (!myspi_async_read(&t))
+    {
+        drain.busy = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * `value` x `per_step` / `unit`, rounded, and kept to 1..`max_steps`: a threshold in mg in steps
+ * of a fraction of full scale, or a time in ms in steps of some number of samples.
+ */
+static uint8_t event_steps(uint32_t value, uint32_t per_step, uint32_t unit, uint8_t max_steps)
+{
+    const uint32_t steps = ((value * per_step) + (unit / 2)) / unit;
+    if (steps < 1)
+    {
+        return 1;
+    }
+    return (steps > max_steps) ? max_steps : (uint8_t)steps;
+}
+
+static void events_configure(void)
+{
+    // A threshold step is full scale / 32 (or 64); a time step is n samples, which is n x 10000 / decihz ms
+    const uint32_t fs_mg = ACCEL_RANGE_MG[config.accel_range];
+    const uint32_t decihz = imu_odr_decihz(config.odr);
+    const uint8_t tap_ths = event_steps(LSM_TAP_THRESHOLD_MG, 32, fs_mg, 0x1F);
+    const uint8_t wake_ths = event_steps(LSM_WAKE_THRESHOLD_MG, 64, fs_mg, 0x3F);
+    const uint8_t dur = event_steps(LSM_TAP_DOUBLE_WINDOW_MS, decihz, 10000U * 32, 0x0F);
+    const uint8_t quiet = event_steps(LSM_TAP_QUIET_MS, decihz, 10000U * 4, 0x03);
+    const uint8_t shock = event_steps(LSM_TAP_SHOCK_MS, decihz, 10000U * 8, 0x03);
+    const uint8_t ff_dur = event_steps(LSM_FREE_FALL_MS, decihz, 10000U, 0x1F);
+
+    // The tap priority bits (above the X threshold) are left at X, Y, Z
+    blocking_write(LSM_REG_TAP_CFG1, tap_ths);
+    blocking_write(LSM_REG_TAP_CFG2, LSM_TAP_CFG2_INTERRUPTS_ENABLE | tap_ths);
+    blocking_write(LSM_REG_TAP_THS_6D, LSM_SIXD_THS_60_DEG | tap_ths);
+    // ddddqqss -> (double tap window) (quiet) (shock)
+    blocking_write(LSM_REG_INT_DUR2, (uint8_t)((dur << 4) | (quiet << 2) | shock));
+    blocking_write(LSM_REG_WAKE_UP_THS, ((events_enabled & IMU_EVENT_DOUBLE_TAP) ? LSM_WAKE_UP_THS_SINGLE_DOUBLE_TAP : 0) | wake_ths);
+    blocking_write(LSM_REG_WAKE_UP_DUR, LSM_WAKE_UP_DUR);
+    blocking_write(LSM_REG_FREE_FALL, (uint8_t)((ff_dur << 3) | LSM_FREE_FALL_THS_312_MG));
+}
+
+void imu_events_enable(uint8_t events)
+{
+    if ((events & ~IMU_EVENT_ALL) != 0)
+    {
+        log_error("IMU events 0x%02X are not ones it can detect.\n", events);
+        return;
+    }
+
+    // Nothing goes to INT2 while the functions are set up
+    blocking_write(LSM_REG_MD2_CFG, 0x00);
+    events_enabled = events;
+    if (events == 0)
+    {
+        blocking_write(LSM_REG_TAP_CFG2, 0x00);
+        return;
+    }
+
+    const bool taps = (events & (IMU_EVENT_SINGLE_TAP | IMU_EVENT_DOUBLE_TAP)) != 0;
+    blocking_write(LSM_REG_TAP_CFG0, LSM_TAP_CFG0_INT_CLR_ON_READ | (taps ? LSM_TAP_CFG0_TAP_XYZ_EN : 0) | LSM_TAP_CFG0_LIR);
+    events_configure();
+
+    uint8_t md2 = 0;
+    md2 |= (events & IMU_EVENT_SINGLE_TAP) ? LSM_MD2_INT2_SINGLE_TAP : 0;
+    md2 |= (events & IMU_EVENT_DOUBLE_TAP) ? LSM_MD2_INT2_DOUBLE_TAP : 0;
+    md2 |= (events & IMU_EVENT_FREE_FALL) ? LSM_MD2_INT2_FF : 0;
+    md2 |= (events & IMU_EVENT_WAKE_UP) ? LSM_MD2_INT2_WU : 0;
+    md2 |= (events & IMU_EVENT_ORIENTATION) ? LSM_MD2_INT2_6D : 0;
+    blocking_write(LSM_REG_MD2_CFG, md2);
+}
+
+/** State for an asynchronous motion read. */
+static struct {
+    volatile bool busy;
+    imu_motion_done_t done;
+    uint8_t src[3];     // WAKE_UP_SRC, TAP_SRC, D6D_SRC
+} motion_read = { 0 };
+
+/** SPI callback: the event source registers have arrived, which cleared INT2. */
+static void motion_read_cb(void *unused)
+{
+    const uint8_t wake_up_src = motion_read.src[0];
+    const uint8_t tap_src = motion_read.src[1];
+    const uint8_t d6d_src = motion_read.src[2];
+
+    imu_motion_t motion = {
+        .events = 0,
+        .tap = tap_src & LSM_TAP_SRC_AXIS_SIGN,
+        .wake_up = wake_up_src & LSM_WAKE_UP_SRC_AXES,
+        .orientation = d6d_src & LSM_D6D_SRC_ORIENTATION,
+    };
+    motion.events |= (tap_src & LSM_TAP_SRC_SINGLE_TAP) ? IMU_EVENT_SINGLE_TAP : 0;
+    motion.events |= (tap_src & LSM_TAP_SRC_DOUBLE_TAP) ? IMU_EVENT_DOUBLE_TAP : 0;
+    motion.events |= (wake_up_src & LSM_WAKE_UP_SRC_FF_IA) ? IMU_EVENT_FREE_FALL : 0;
+    motion.events |= (wake_up_src & LSM_WAKE_UP_SRC_WU_IA) ? IMU_EVENT_WAKE_UP : 0;
+    motion.events |= (d6d_src & LSM_D6D_SRC_D6D_IA) ? IMU_EVENT_ORIENTATION : 0;
+    // The flags of functions that run without being routed to INT2 (wake-up, for the taps) are set too
+    motion.events &= events_enabled;
+
+    motion_read.busy = false;
+    motion_read.done(&motion);
+}
+
+bool imu_read_motion_async(imu_motion_done_t done)
+{
+    if (motion_read.busy)
+    {
+        return false;
+    }
+
+    motion_read.busy = true;
+    motion_read.done = done;
+
+    // The three source registers are next to each other, so one read gets them all
+    myspi_transaction_t t = {
+        .cs_pin = SENSORS_SPI_CS_IMU,
+        .reg = LSM_REG_WAKE_UP_SRC | (1 << 7),
+        .buf = motion_read.src,
+        .len = sizeof(motion_read.src),
+        .callback = motion_read_cb,
+        .ctx = NULL,
+    };
+    if (!myspi_async_read(&t))
+    {
+        motion_read.busy = false;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file imu.h
+ * @brief Module for the accelerator/gyroscope.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef IMU_FIFO_COMPRESSION
+    /**
+     * Have the IMU compress the samples in its FIFO, storing the differences from one sample to
+     * the next when they are small: two or three samples of a sensor to a FIFO word instead of one.
+     * That's up to a third of the SPI bytes per sample, and the watermark (which counts words) holds
+     * that many more samples between drains. The samples come out the same.
+     */
+    #define IMU_FIFO_COMPRESSION 0
+#endif // IMU_FIFO_COMPRESSION
+
+/** 6DOF IMU values. The order of these values matches the order found in the device. Do not change. */
+typedef struct {
+    int16_t gyro_x;
+    int16_t gyro_y;
+    int16_t gyro_z;
+    int16_t accel_x;
+    int16_t accel_y;
+    int16_t accel_z;
+} imu_sensor_values_t;
+
+/** Motion events the IMU can detect by itself (see imu_events_enable()). */
+#define IMU_EVENT_SINGLE_TAP        0x01
+#define IMU_EVENT_DOUBLE_TAP        0x02
+#define IMU_EVENT_FREE_FALL         0x04
+#define IMU_EVENT_WAKE_UP           0x08    // Moved past the wake-up threshold: bumped or picked up
+#define IMU_EVENT_ORIENTATION       0x10    // Turned to face a different way (6D)
+#define IMU_EVENT_ALL               0x1F
+
+/** imu_motion_t tap bits: the axis a tap was on, and whether it was toward the negative end. */
+#define IMU_TAP_Z                   0x01
+#define IMU_TAP_Y                   0x02
+#define IMU_TAP_X                   0x04
+#define IMU_TAP_NEGATIVE            0x08
+
+/** imu_motion_t wake_up bits: the axes that went past the wake-up threshold. */
+#define IMU_WAKE_UP_Z               0x01
+#define IMU_WAKE_UP_Y               0x02
+#define IMU_WAKE_UP_X               0x04
+
+/** imu_motion_t orientation bits: which end of which axis is pointing up (or down, for the L bits). */
+#define IMU_ORIENTATION_XL          0x01
+#define IMU_ORIENTATION_XH          0x02
+#define IMU_ORIENTATION_YL          0x04
+#define IMU_ORIENTATION_YH          0x08
+#define IMU_ORIENTATION_ZL          0x10
+#define IMU_ORIENTATION_ZH          0x20
+
+/** What the IMU signalled on INT2. The details are its own source register bits. */
+typedef struct {
+    uint8_t events;         // IMU_EVENT_*s that happened (only the enabled ones)
+    uint8_t tap;            // IMU_TAP_*
+    uint8_t wake_up;        // IMU_WAKE_UP_*
+    uint8_t orientation;    // IMU_ORIENTATION_*
+} imu_motion_t;
+
+/** Output data rate of both sensors, which the FIFO batches at too. The values are the IMU's own codes. */
+typedef enum {
+    IMU_ODR_OFF             = 0,    // Power down
+    IMU_ODR_12_5_HZ         = 1,
+    IMU_ODR_26_HZ           = 2,
+    IMU_ODR_52_HZ           = 3,
+    IMU_ODR_104_HZ          = 4,
+    IMU_ODR_208_HZ          = 5,
+    IMU_ODR_416_HZ          = 6,
+    IMU_ODR_833_HZ          = 7,
+    IMU_ODR_1660_HZ         = 8,
+    IMU_ODR_3330_HZ         = 9,
+    IMU_ODR_6660_HZ         = 10,
+} imu_odr_t;
+
+/** Accelerometer full scale. The values are the IMU's own codes, so they aren't in order. */
+typedef enum {
+    IMU_ACCEL_RANGE_2_G     = 0,
+    IMU_ACCEL_RANGE_16_G    = 1,
+    IMU_ACCEL_RANGE_4_G     = 2,
+    IMU_ACCEL_RANGE_8_G     = 3,
+} imu_accel_range_t;
+
+/** Gyroscope full scale. 125 dps has a bit of its own, apart from the others' code. */
+typedef enum {
+    IMU_GYRO_RANGE_250_DPS  = 0,
+    IMU_GYRO_RANGE_500_DPS  = 1,
+    IMU_GYRO_RANGE_1000_DPS = 2,
+    IMU_GYRO_RANGE_2000_DPS = 3,
+    IMU_GYRO_RANGE_125_DPS  = 4,
+} imu_gyro_range_t;
+
+/**
+ * Accelerometer low-pass bandwidth, as a fraction of the ODR. Narrower is less noisy but slower
+ * to respond. Only in high-performance mode; in low-power mode it is about ODR / 2 regardless.
+ */
+typedef enum {
+    IMU_ACCEL_BANDWIDTH_ODR_2   = 0,    // The first filter stage only
+    IMU_ACCEL_BANDWIDTH_ODR_10  = 1,
+    IMU_ACCEL_BANDWIDTH_ODR_20  = 2,
+    IMU_ACCEL_BANDWIDTH_ODR_45  = 3,
+    IMU_ACCEL_BANDWIDTH_ODR_100 = 4,
+    IMU_ACCEL_BANDWIDTH_ODR_200 = 5,
+    IMU_ACCEL_BANDWIDTH_ODR_400 = 6,
+    IMU_ACCEL_BANDWIDTH_ODR_800 = 7,
+} imu_accel_bandwidth_t;
+
+/** How the IMU samples. */
+typedef struct {
+    imu_odr_t odr;
+    imu_accel_range_t accel_range;
+    imu_gyro_range_t gyro_range;
+    imu_accel_bandwidth_t accel_bandwidth;
+    bool low_power;     // Leave high-performance mode: noisier, but much less current at 208 Hz and below
+} imu_config_t;
+
+/** The configuration imu_init() uses: 208 Hz, 8 g, 500 dps, high performance. */
+extern const imu_config_t IMU_DEFAULT_CONFIG;
+
+/**
+ * @brief Initialize the IMU module.
+ * Starts the IMU sampling with IMU_DEFAULT_CONFIG.
+ */
+void imu_init(void);
+
+/**
+ * @brief Change how the IMU samples. If the FIFO is on, it batches at the new rate from here,
+ * and the motion event thresholds (see imu_events_enable()) are redone for the new full scale
+ * and rate, so they stay the same in g and ms.
+ */
+void imu_configure(const imu_config_t *config);
+
+/** @brief Get the configuration the IMU is sampling with. */
+void imu_get_config(imu_config_t *config);
+
+/** @brief The output data rate `odr` is, in tenths of a Hz (2080 for IMU_ODR_208_HZ, 0 for IMU_ODR_OFF). */
+uint32_t imu_odr_decihz(imu_odr_t odr);
+
+/** Read the IMU values into the given pointer. */
+void imu_read(imu_sensor_values_t *values);
+
+/**
+ * @brief Have the IMU batch samples in its FIFO at the full output data rate (see imu_configure()).
+ * INT1 is raised once `watermark_samples` samples are waiting (or, with IMU_FIFO_COMPRESSION,
+ * once they would fill that many uncompressed, which is usually more samples).
+ *
+ * @param watermark_samples How many (gyro, accel) samples to accumulate before
+ *                          signalling. Must be less than 256.
+ */
+void imu_fifo_enable(uint16_t watermark_samples);
+
+/**
+ * @brief Drain samples from the IMU's FIFO in as few SPI bursts as possible.
+ * Requires imu_fifo_enable(). Samples come back oldest first.
+ *
+ * @param samples Where to put the samples.
+ * @param max_samples How many samples `samples` can hold. Anything beyond this stays in the FIFO.
+ * @return size_t The number of samples written.
+ */
+size_t imu_read_batch(imu_sensor_values_t *samples, size_t max_samples);
+
+/** Called when an asynchronous batch read is done. Runs in the SPI DMA IRQ. */
+typedef void (*imu_batch_done_t)(imu_sensor_values_t *samples, size_t nsamples);
+
+/**
+ * @brief Like imu_read_batch(), but done by DMA without blocking.
+ * `samples` must stay valid until `done` is called.
+ *
+ * @return bool False if a batch read is already running or the SPI queue is full,
+ *              in which case `done` will not be called.
+ */
+bool imu_read_batch_async(imu_sensor_values_t *samples, size_t max_samples, imu_batch_done_t done);
+
+/**
+ * @brief Have the IMU's embedded functions watch for motion events, and raise INT2 when one
+ * happens. INT2 stays high (latched) until imu_read_motion_async() reads what happened, so
+ * nothing is read from the IMU, and no MCU time is spent, until then.
+ *
+ * @param events The IMU_EVENT_*s to detect. 0 stops them all.
+ */
+void imu_events_enable(uint8_t events);
+
+/** Called when an asynchronous motion read is done. Runs in the SPI DMA IRQ. */
+typedef void (*imu_motion_done_t)(const imu_motion_t *motion);
+
+/**
+ * @brief Read (and clear) what the IMU signalled on INT2, by DMA without blocking.
+ *
+ * @return bool False if a motion read is already running or the SPI queue is full,
+ *              in which case `done` will not be called and INT2 stays high.
+ */
+bool imu_read_motion_async(imu_motion_done_t done);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+// Stdlib includes
+#include <stdbool.h>
+// SDK includes
+#include "pico/sync.h"
+// Local includes
+#include "latency.h"
+
+/** Counts, by stream and bucket. */
+static uint32_t counts[LATENCY_NUM_STREAMS][LATENCY_NUM_BUCKETS];
+
+/** Guards counts. They're added to from the acquisition core's IRQs, and packed from the command path on core 0. */
+static critical_section_t latency_crit;
+
+/** Which bucket a latency goes in. */
+static inline uint32_t bucket_of(uint32_t us)
+{
+    uint32_t bucket = 0;
+    uint32_t limit = LATENCY_FIRST_BUCKET_US;
+    while ((bucket < (LATENCY_NUM_BUCKETS - 1)) && (us >= limit))
+    {
+        bucket++;
+        limit <<= 1;
+    }
+    return bucket;
+}
+
+void latency_init(void)
+{
+    critical_section_init(&latency_crit);
+}
+
+void latency_record(latency_stream_t stream, uint32_t us)
+{
+    if (stream >= LATENCY_NUM_STREAMS)
+    {
+        return;
+    }
+
+    const uint32_t bucket = bucket_of(us);
+    critical_section_enter_blocking(&latency_crit);
+    counts[stream][bucket]++;
+    critical_section_exit(&latency_crit);
+}
+
+size_t latency_pack_and_clear(uint8_t *buf, size_t len)
+{
+    if (len < LATENCY_PACKED_LEN)
+    {
+        return 0;
+    }
+
+    uint32_t copy[LATENCY_NUM_STREAMS][LATENCY_NUM_BUCKETS];
+    critical_section_enter_blocking(&latency_crit);
+    for (uint32_t stream = 0; stream < LATENCY_NUM_STREAMS; stream++)
+    {
+        for (uint32_t bucket = 0; bucket < LATENCY_NUM_BUCKETS; bucket++)
+        {
+            copy[stream][bucket] = counts[stream][bucket];
+            counts[stream][bucket] = 0;
+        }
+    }
+    critical_section_exit(&latency_crit);
+
+    size_t pos = 0;
+    for (uint32_t stream = 0; stream < LATENCY_NUM_STREAMS; stream++)
+    {
+        for (uint32_t bucket = 0; bucket < LATENCY_NUM_BUCKETS; bucket++)
+        {
+            const uint32_t count = (copy[stream][bucket] > UINT16_MAX) ? UINT16_MAX : copy[stream][bucket];
+            buf[pos++] = (uint8_t)(count & 0xFF);
+            buf[pos++] = (uint8_t)((count >> 8) & 0xFF);
+        }
+    }
+    return pos;
+}
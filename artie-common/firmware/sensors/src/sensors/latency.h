@@ -0,0 +1,53 @@
+/**
+ * @file latency.h
+ * @brief Histograms of how long the sensor values take to become available.
+ * For each stream, the time from when a value was ready at the sensor (see sensors_stamp_t)
+ * to when it was in the snapshot and the register map, so the FIFO watermark, the SPI clock,
+ * and the IRQ load can be tuned against what the controller actually gets.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** The streams timed. */
+typedef enum {
+    LATENCY_STREAM_IMU          = 0,    // Each IMU batch, by its newest sample
+    LATENCY_STREAM_ENVIRONMENT  = 1,    // Each environment read
+    LATENCY_NUM_STREAMS,
+} latency_stream_t;
+
+/**
+ * Buckets in each stream's histogram. The first counts latencies under LATENCY_FIRST_BUCKET_US,
+ * each one after that up to twice as long as the one before, and the last everything longer:
+ * under 64, 128, 256, 512, 1024, and 2048 us, then 2048 us and up.
+ */
+#define LATENCY_NUM_BUCKETS         7U
+#define LATENCY_FIRST_BUCKET_US     64U
+
+/** Bytes of what latency_pack_and_clear() writes: each bucket's count (uint16, saturating), IMU then environment. */
+#define LATENCY_PACKED_LEN          (LATENCY_NUM_STREAMS * LATENCY_NUM_BUCKETS * 2U)
+
+/** Start timing. Call once, before anything else here. */
+void latency_init(void);
+
+/** @brief Count one value of `stream` that took `us` to become available. Safe from IRQs. */
+void latency_record(latency_stream_t stream, uint32_t us);
+
+/**
+ * @brief Pack the histograms (see LATENCY_PACKED_LEN for the layout) and start them again from zero,
+ * so each pack covers the time since the one before. Safe from either core.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least LATENCY_PACKED_LEN, or nothing is written (or cleared).
+ * @return size_t Number of bytes written.
+ */
+size_t latency_pack_and_clear(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
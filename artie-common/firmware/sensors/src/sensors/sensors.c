@@ -0,0 +1,1152 @@
+// Stdlib includes
+#include <stdbool.h>
+// SDK includes
+#include "hardware/spi.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <bist.h>
+#include <errors.h>
+// Local includes
+#include "../cmds/cmds.h"
+#include "../gpioirq/gpioirq.h"
+#include "../intercore/intercore.h"
+#include "../trace/trace.h"
+#include "../board/pinconfig.h"
+#include "fusion.h"
+#include "history.h"
+#include "imu.h"
+#include "latency.h"
+#include "sensors.h"
+#include "spi_interface.h"
+#include "temp.h"
+#if SENSORS_PUBLISH_PSACP
+    #include "../psacp/psacp.h"
+#endif // SENSORS_PUBLISH_PSACP
+
+/**
+ * The ms between each read of the temperature/pressure/humidity sensor.
+ * This should be no shorter than the sensor's own conversion period (see TEMP_DEFAULT_CONFIG).
+ * The IMU is read whenever its FIFO signals, independent of this.
+ */
+#define MS_BETWEEN_TEMP_READ 1000U
+
+/**
+ * How often we'd like the FIFO to raise INT1, which is how often we read the IMU. The watermark
+ * is this many ms of samples at the IMU's rate, but no more than IMU_BATCH_SAMPLES, so at 208 Hz
+ * and above it's a batch (about 150 ms at 208 Hz, 19 ms at 1.66 kHz).
+ */
+#define IMU_FIFO_WATERMARK_MS 150U
+
+/** Most IMU samples we pull out of the FIFO at a time. */
+#define IMU_BATCH_SAMPLES 32U
+
+#if SENSORS_PUBLISH_PSACP
+/** Bytes of each IMU sample in a publish. */
+#define PSACP_IMU_SAMPLE_LEN 12U
+
+#if SENSORS_PSACP_IMU_RATE_HZ == 0
+    #error "SENSORS_PSACP_IMU_RATE_HZ must be at least 1"
+#endif
+#if (SENSORS_PSACP_IMU_BATCH == 0) || ((SENSORS_PSACP_IMU_BATCH * PSACP_IMU_SAMPLE_LEN) > PSACP_MAX_PAYLOAD_LEN)
+    #error "SENSORS_PSACP_IMU_BATCH samples must fit in one publish"
+#endif
+#if SENSORS_PSACP_ENVIRONMENT_PERIOD_MS == 0
+    #error "SENSORS_PSACP_ENVIRONMENT_PERIOD_MS must be at least 1"
+#endif
+
+/** Publish the environment values from one read in this many. */
+#define PSACP_ENVIRONMENT_DECIMATION ((SENSORS_PSACP_ENVIRONMENT_PERIOD_MS + MS_BETWEEN_TEMP_READ - 1) / MS_BETWEEN_TEMP_READ)
+
+/**
+ * IMU samples waiting to be published (a power of two). A whole FIFO read arrives at once,
+ * and goes out a batch per publish timer tick.
+ */
+#define PSACP_IMU_RING_LEN 64U
+#define PSACP_IMU_RING_MASK (PSACP_IMU_RING_LEN - 1)
+
+/**
+ * The IMU samples to publish. The IMU read callback only moves the head, and the publish timer
+ * only moves the tail. When it's full, the newest samples are lost.
+ */
+static imu_sensor_values_t psacp_imu_ring[PSACP_IMU_RING_LEN];
+static volatile uint32_t psacp_imu_head = 0;
+static volatile uint32_t psacp_imu_tail = 0;
+
+/** IMU samples to skip before the next one to publish. */
+static uint32_t psacp_imu_skip = 0;
+
+/** Publish one IMU sample in this many. Follows the IMU's rate (see sensors_configure()). */
+static volatile uint32_t psacp_imu_decimation = 1;
+
+/** Timer for publishing IMU batches, ticking at the batch rate. */
+static repeating_timer_t psacp_imu_timer;
+#endif // SENSORS_PUBLISH_PSACP
+
+/** The time between IMU samples, in us. Follows the IMU's rate (see apply_imu_rate()). */
+static volatile uint32_t imu_period_us = 0;
+
+/** The FIFO watermark, in samples: the sample that reaches it raises INT1. Follows the IMU's rate. */
+static volatile uint32_t imu_watermark = 1;
+
+/** When INT1 last rose, in us since boot, and whether a batch has been stamped from it yet. */
+static volatile uint64_t imu_edge_us = 0;
+static volatile bool imu_edge_pending = false;
+
+/**
+ * The next batch starts over (a rate change emptied the FIFO), so its sequence numbers follow on from
+ * the last batch's without counting the periods in between as lost.
+ */
+static volatile bool imu_stamp_resync = true;
+
+/** Environment reads due so far, and when the latest started, in us since boot (see sensors_stamp_t). */
+static uint32_t temp_read_seq = 0;
+static uint64_t temp_read_started_us = 0;
+
+/** Timers and alarms we can have going at once on the acquisition core. */
+#define ACQUISITION_MAX_TIMERS 8
+
+/**
+ * The acquisition core's timers and alarms. They fire on the core that made the pool, so the
+ * sensor reads they start don't wait behind the command bus's interrupts on core 0.
+ */
+static alarm_pool_t *acquisition_alarm_pool = NULL;
+
+/** Configuration commands waiting for the acquisition core. Must be a power of two. */
+#define CONFIG_QUEUE_SIZE 16
+
+/** Configuration commands from core 0 (sensors_cmd()) to the acquisition core. */
+static intercore_channel_t config_queue;
+static uint8_t config_queue_items[CONFIG_QUEUE_SIZE];
+
+/** Has the acquisition core initialized the sensors? */
+static volatile bool acquisition_ready = false;
+
+/** The settings in use. Only sensors_configure() changes them. */
+static sensors_config_t config = { 0 };
+
+#if SENSORS_ADAPTIVE_SAMPLING
+/** Environment timer ticks between reads while idle. */
+#define ADAPTIVE_IDLE_TEMP_READ_TICKS (((SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS / MS_BETWEEN_TEMP_READ) == 0) ? 1U : (SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS / MS_BETWEEN_TEMP_READ))
+
+/** How soon after something starts going on the rates go up. */
+#define ADAPTIVE_SWITCH_DELAY_US 1000
+
+/** Is the robot moving, as far as adaptive sampling goes? It starts out so, and settles. */
+static volatile bool adaptive_active = true;
+
+/** When something last went on, in ms since boot. */
+static volatile uint32_t adaptive_last_activity_ms = 0;
+
+/** Is a switch to the active rates on its way (see adaptive_note_activity())? */
+static volatile bool adaptive_switch_pending = false;
+
+/** Gyro magnitude past which the robot is moving, squared, in raw LSBs. Follows the gyro's full scale. */
+static volatile uint32_t adaptive_gyro_threshold_sq = UINT32_MAX;
+
+/** Environment timer ticks to skip before the next read while idle. */
+static uint32_t adaptive_temp_skip = 0;
+
+/** Note that something is going on, and go to the active rates if we're idle. */
+static void adaptive_note_activity(void);
+
+/** Go back to the idle rates if nothing has gone on for SENSORS_ADAPTIVE_QUIET_MS. */
+static void adaptive_check_quiet(void);
+
+/** Go to the active (or idle) rates. */
+static void adaptive_apply(bool active);
+
+/** Is this sample turning faster than SENSORS_ADAPTIVE_GYRO_DPS? */
+static inline bool adaptive_gyro_moving(const imu_sensor_values_t *sample)
+{
+    // Squares of int16s fit in 30 bits, so the sum of three fits in 32
+    const int32_t x = sample->gyro_x;
+    const int32_t y = sample->gyro_y;
+    const int32_t z = sample->gyro_z;
+    return ((uint32_t)(x * x) + (uint32_t)(y * y) + (uint32_t)(z * z)) > adaptive_gyro_threshold_sq;
+}
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+/** Called with each batch of IMU samples, if set. */
+static sensors_imu_batch_handler_t imu_batch_handler = NULL;
+
+/** Called with each motion event, if set. */
+static sensors_motion_handler_t motion_handler = NULL;
+
+/** Motion events so far. Only the motion read callback touches it. */
+static uint16_t motion_count = 0;
+
+/** Timer for reading the temperature sensor. */
+static repeating_timer_t temp_read_timer;
+
+/**
+ * Sequence count for sensor_values. A writer makes it odd while it is writing
+ * and even again when it is done, so a reader can tell if its copy might be torn.
+ * The writers never wait on readers.
+ *
+ * The writers are the SPI DMA completion callbacks, which all run in the one DMA IRQ on the
+ * acquisition core, so they can't preempt each other partway through an update. The readers
+ * are mostly on core 0, answering the controller.
+ */
+static volatile uint32_t sensor_values_seq = 0;
+
+/** Sensor values are assigned during the ISR. Read them with sensors_get_snapshot(). */
+static sensor_values_t sensor_values = {
+    .temp_sensor_values = {
+        .pressure_pa_q24_8 = 0,
+        .temperature_centi_c = 0,
+        .humidity_percent_rh_q22_10 = 0,
+    },
+    .imu_sensor_values = {
+        .gyro_x = 0,
+        .gyro_y = 0,
+        .gyro_z = 0,
+        .accel_x = 0,
+        .accel_y = 0,
+        .accel_z = 0,
+    }
+};
+
+/** Begin updating sensor_values. Call from IRQ context only (see sensor_values_seq). */
+static inline void begin_sensor_values_update(void)
+{
+    sensor_values_seq++;
+    __dmb();
+}
+
+/** Finish updating sensor_values. */
+static inline void end_sensor_values_update(void)
+{
+    __dmb();
+    sensor_values_seq++;  // sensor values are safe to read now
+}
+
+/** Append a little-endian value of `nbytes` bytes to `buf` at `*pos`. */
+static inline void pack_le(uint8_t *buf, size_t *pos, uint32_t value, size_t nbytes)
+{
+    for (size_t i = 0; i < nbytes; i++)
+    {
+        buf[(*pos)++] = (uint8_t)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/** Publish the newest environment values to the register map. */
+static void publish_environment(const temp_sensor_values_t *values)
+{
+    uint8_t buf[12];
+    size_t pos = 0;
+    pack_le(buf, &pos, (uint32_t)values->temperature_centi_c, 4);
+    pack_le(buf, &pos, values->pressure_pa_q24_8, 4);
+    pack_le(buf, &pos, values->humidity_percent_rh_q22_10, 4);
+    cmds_register_write(SENSORS_REG_ENVIRONMENT, buf, pos);
+
+#if SENSORS_PUBLISH_PSACP
+    // 12 bytes fill two frames
+    static uint32_t skip = 0;
+    if (skip > 0)
+    {
+        skip--;
+    }
+    else
+    {
+        skip = PSACP_ENVIRONMENT_DECIMATION - 1;
+        psacp_publish(SENSORS_TOPIC_ENVIRONMENT, PSACP_BAND_LOW, RTACP_PRIORITY_LOW, buf, pos);
+    }
+#endif // SENSORS_PUBLISH_PSACP
+}
+
+/** Publish the newest IMU sample to the register map. */
+static void publish_imu(const imu_sensor_values_t *values)
+{
+    // Accel and gyro are contiguous, so write them together
+    uint8_t buf[12];
+    size_t pos = 0;
+    pack_le(buf, &pos, (uint16_t)values->accel_x, 2);
+    pack_le(buf, &pos, (uint16_t)values->accel_y, 2);
+    pack_le(buf, &pos, (uint16_t)values->accel_z, 2);
+    pack_le(buf, &pos, (uint16_t)values->gyro_x, 2);
+    pack_le(buf, &pos, (uint16_t)values->gyro_y, 2);
+    pack_le(buf, &pos, (uint16_t)values->gyro_z, 2);
+    cmds_register_write(SENSORS_REG_ACCEL, buf, pos);
+}
+
+#if SENSORS_PUBLISH_PSACP
+/** Keep the IMU samples due to be published, for the publish timer. Runs in the IMU read callback. */
+static void queue_imu_for_psacp(const imu_sensor_values_t *samples, size_t nsamples)
+{
+    for (size_t i = 0; i < nsamples; i++)
+    {
+        if (psacp_imu_skip > 0)
+        {
+            psacp_imu_skip--;
+            continue;
+        }
+        psacp_imu_skip = psacp_imu_decimation - 1;
+
+        const uint32_t head = psacp_imu_head;
+        if ((head - psacp_imu_tail) >= PSACP_IMU_RING_LEN)
+        {
+            // The publisher is behind (the CAN bus is busy), so this one is lost
+            continue;
+        }
+        psacp_imu_ring[head & PSACP_IMU_RING_MASK] = samples[i];
+        __dmb();
+        psacp_imu_head = head + 1;
+    }
+}
+
+/** Publish the waiting IMU samples, a batch at a time. */
+static bool psacp_imu_publish_cb(repeating_timer_t *unused)
+{
+    uint32_t tail = psacp_imu_tail;
+    while ((psacp_imu_head - tail) >= SENSORS_PSACP_IMU_BATCH)
+    {
+        __dmb();
+        uint8_t buf[SENSORS_PSACP_IMU_BATCH * PSACP_IMU_SAMPLE_LEN];
+        size_t pos = 0;
+        for (uint32_t i = 0; i < SENSORS_PSACP_IMU_BATCH; i++)
+        {
+            const imu_sensor_values_t *sample = &psacp_imu_ring[(tail + i) & PSACP_IMU_RING_MASK];
+            pack_le(buf, &pos, (uint16_t)sample->accel_x, 2);
+            pack_le(buf, &pos, (uint16_t)sample->accel_y, 2);
+            pack_le(buf, &pos, (uint16_t)sample->accel_z, 2);
+            pack_le(buf, &pos, (uint16_t)sample->gyro_x, 2);
+            pack_le(buf, &pos, (uint16_t)sample->gyro_y, 2);
+            pack_le(buf, &pos, (uint16_t)sample->gyro_z, 2);
+        }
+
+        if (!psacp_publish(SENSORS_TOPIC_IMU, PSACP_BAND_HIGH, RTACP_PRIORITY_MED_HIGH, buf, pos))
+        {
+            // The queue is still full of the last batch. Try again next tick.
+            break;
+        }
+        tail += SENSORS_PSACP_IMU_BATCH;
+        psacp_imu_tail = tail;
+    }
+
+    // Always return true (false stops the alarm, true fires it off again)
+    return true;
+}
+#endif // SENSORS_PUBLISH_PSACP
+
+/**
+ * Stamp the newest of a batch of IMU samples (see sensors_stamp_t), following on from `last`,
+ * the newest of the batch before.
+ */
+static void stamp_imu_batch(size_t nsamples, const sensors_stamp_t *last, sensors_stamp_t *newest)
+{
+    const uint64_t now_us = time_us_64();
+    const uint32_t period_us = imu_period_us;
+    uint64_t newest_us;
+    if (imu_edge_pending)
+    {
+        // The watermark'th sample raised INT1, and any after it came in while we started the read
+        imu_edge_pending = false;
+        newest_us = (uint64_t)((int64_t)imu_edge_us + (((int64_t)nsamples - (int64_t)imu_watermark) * (int64_t)period_us));
+    }
+    else
+    {
+        // More of the same drain: these were in the FIFO behind the last batch
+        newest_us = last->timestamp_us + ((uint64_t)nsamples * period_us);
+    }
+    newest_us = (newest_us > now_us) ? now_us : newest_us;
+
+    // Count the sample periods since the last batch, so samples the FIFO lost leave a gap in the sequence
+    uint32_t periods = (uint32_t)nsamples;
+    if (!imu_stamp_resync && (period_us != 0) && (newest_us > last->timestamp_us))
+    {
+        const uint64_t elapsed = ((newest_us - last->timestamp_us) + (period_us / 2)) / period_us;
+        periods = (elapsed > periods) ? (uint32_t)elapsed : periods;
+    }
+    imu_stamp_resync = false;
+
+    newest->seq = last->seq + periods;
+    newest->timestamp_us = newest_us;
+}
+
+/** SPI callback: a batch of IMU samples has been read. Hand it off and keep the newest sample. */
+static void imu_batch_done(imu_sensor_values_t *samples, size_t nsamples);
+
+/** Start draining the 6DOF IMU FIFO. */
+static void read_imu(void)
+{
+    static imu_sensor_values_t imu_batch[IMU_BATCH_SAMPLES];
+    TRACE_BEGIN(TRACE_ID_SENSOR_READ_IMU, 0);
+    if (!imu_read_batch_async(imu_batch, IMU_BATCH_SAMPLES, &imu_batch_done))
+    {
+        // A drain is already running (or the SPI queue is full), so there's no batch coming to end the span
+        TRACE_END(TRACE_ID_SENSOR_READ_IMU, 0);
+    }
+}
+
+static void imu_batch_done(imu_sensor_values_t *samples, size_t nsamples)
+{
+    TRACE_END(TRACE_ID_SENSOR_READ_IMU, nsamples);
+    if (nsamples == 0)
+    {
+        return;
+    }
+
+    // We're the only writer, so the last stamp needn't be read through the snapshot
+    sensors_stamp_t stamp;
+    stamp_imu_batch(nsamples, &sensor_values.imu_stamp, &stamp);
+
+#if SENSORS_ENABLE_FUSION
+    fusion_push_samples(samples, nsamples, stamp.timestamp_us);
+#endif // SENSORS_ENABLE_FUSION
+
+#if SENSORS_ENABLE_HISTORY
+    history_add_imu(samples, nsamples, stamp.timestamp_us, imu_period_us);
+#endif // SENSORS_ENABLE_HISTORY
+
+    if (imu_batch_handler != NULL)
+    {
+        imu_batch_handler(samples, nsamples, &stamp);
+    }
+
+#if SENSORS_PUBLISH_PSACP
+    queue_imu_for_psacp(samples, nsamples);
+#endif // SENSORS_PUBLISH_PSACP
+
+#if SENSORS_ADAPTIVE_SAMPLING
+    if (config.adaptive)
+    {
+        // While idle, any sample will do. While active, the newest is enough to tell it's still moving.
+        for (size_t i = adaptive_active ? (nsamples - 1) : 0; i < nsamples; i++)
+        {
+            if (adaptive_gyro_moving(&samples[i]))
+            {
+                adaptive_note_activity();
+                break;
+            }
+        }
+    }
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+    begin_sensor_values_update();
+    sensor_values.imu_sensor_values = samples[nsamples - 1];
+    sensor_values.imu_stamp = stamp;
+    end_sensor_values_update();
+    publish_imu(&samples[nsamples - 1]);
+    latency_record(LATENCY_STREAM_IMU, (uint32_t)(time_us_64() - stamp.timestamp_us));
+
+    // A full batch means there may be more waiting.
+    if (nsamples == IMU_BATCH_SAMPLES)
+    {
+        read_imu();
+    }
+}
+
+/** The IMU's FIFO reached its watermark. Only starts the read: the SPI finishes it in the background. */
+static void imu_int1_irq(uint gpio, uint32_t events, void *context)
+{
+    imu_edge_us = time_us_64();
+    imu_edge_pending = true;
+    read_imu();
+}
+
+size_t sensors_pack_motion(const sensors_motion_event_t *event, uint8_t *buf)
+{
+    size_t pos = 0;
+    pack_le(buf, &pos, event->count, 2);
+    buf[pos++] = event->motion.events;
+    buf[pos++] = event->motion.tap;
+    buf[pos++] = event->motion.wake_up;
+    buf[pos++] = event->motion.orientation;
+    pack_le(buf, &pos, event->timestamp_ms, 4);
+    return pos;
+}
+
+/** SPI callback: what the IMU signalled on INT2 has been read. */
+static void motion_done(const imu_motion_t *motion);
+
+/** Read what the IMU signalled on INT2. */
+static void read_motion(void)
+{
+    // If this can't start, the timer tries again (see temp_read_cb()), as INT2 stays high until it's read
+    imu_read_motion_async(&motion_done);
+}
+
+static void motion_done(const imu_motion_t *motion)
+{
+    if (motion->events != 0)
+    {
+        sensors_motion_event_t event = {
+            .count = ++motion_count,
+            .motion = *motion,
+            .timestamp_ms = to_ms_since_boot(get_absolute_time()),
+        };
+        uint8_t buf[SENSORS_MOTION_LEN];
+        const size_t len = sensors_pack_motion(&event, buf);
+        cmds_register_write(SENSORS_REG_MOTION, buf, len);
+#if SENSORS_PUBLISH_PSACP
+        // Rare and wanted soon, so the high band
+        psacp_publish(SENSORS_TOPIC_MOTION, PSACP_BAND_HIGH, RTACP_PRIORITY_MED_HIGH, buf, len);
+#endif // SENSORS_PUBLISH_PSACP
+
+        if (motion_handler != NULL)
+        {
+            motion_handler(&event);
+        }
+
+#if SENSORS_ADAPTIVE_SAMPLING
+        if (config.adaptive)
+        {
+            adaptive_note_activity();
+        }
+#endif // SENSORS_ADAPTIVE_SAMPLING
+    }
+
+    // Another event may have been latched since, with no edge of its own
+    if (gpio_get(SENSORS_IMU_INT2))
+    {
+        read_motion();
+    }
+}
+
+/** The IMU detected a motion event. Only starts the read: the SPI finishes it in the background. */
+static void imu_int2_irq(uint gpio, uint32_t events, void *context)
+{
+    read_motion();
+}
+
+/** SPI callback: new temperature, pressure, humidity values have been read. */
+static void temp_read_done(temp_sensor_values_t *values)
+{
+    TRACE_END(TRACE_ID_SENSOR_READ_TEMP, 0);
+    const sensors_stamp_t stamp = {
+        .seq = temp_read_seq,
+        .timestamp_us = temp_read_started_us,
+    };
+    begin_sensor_values_update();
+    sensor_values.temp_sensor_values = *values;
+    sensor_values.temp_stamp = stamp;
+    end_sensor_values_update();
+    publish_environment(values);
+    latency_record(LATENCY_STREAM_ENVIRONMENT, (uint32_t)(time_us_64() - stamp.timestamp_us));
+#if SENSORS_ENABLE_HISTORY
+    history_set_environment(values);
+#endif // SENSORS_ENABLE_HISTORY
+}
+
+/** Is the environment due to be read this tick? Always, unless adaptive sampling is idle. */
+static bool temp_read_due(void)
+{
+#if SENSORS_ADAPTIVE_SAMPLING
+    if (config.adaptive && !adaptive_active)
+    {
+        if (adaptive_temp_skip > 0)
+        {
+            adaptive_temp_skip--;
+            return false;
+        }
+        adaptive_temp_skip = ADAPTIVE_IDLE_TEMP_READ_TICKS - 1;
+    }
+#endif // SENSORS_ADAPTIVE_SAMPLING
+    return true;
+}
+
+/** The callback we use every so often from the timer. */
+static bool temp_read_cb(repeating_timer_t *unused)
+{
+#if SENSORS_ADAPTIVE_SAMPLING
+    adaptive_check_quiet();
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+    // Read temperature, pressure, humidity. The sensor converts on its own (normal mode),
+    // so this is always its latest result.
+    static temp_sensor_values_t temp_temp_vals;
+    if (temp_read_due())
+    {
+        // Counted even if the read can't start, so the sequence shows the one that's lost
+        temp_read_seq++;
+        temp_read_started_us = time_us_64();
+        TRACE_BEGIN(TRACE_ID_SENSOR_READ_TEMP, 0);
+        if (!temp_read_async(&temp_temp_vals, &temp_read_done))
+        {
+            TRACE_END(TRACE_ID_SENSOR_READ_TEMP, 0);
+        }
+    }
+
+    // A motion event whose read couldn't start (the SPI queue was full) is still latched
+    if (gpio_get(SENSORS_IMU_INT2))
+    {
+        read_motion();
+    }
+
+    // Always return true (false stops the alarm, true fires it off again)
+    return true;
+}
+
+size_t sensors_pack_config(const sensors_config_t *cfg, uint8_t *buf)
+{
+    size_t pos = 0;
+    buf[pos++] = (uint8_t)cfg->imu.odr;
+    buf[pos++] = (uint8_t)cfg->imu.accel_range;
+    buf[pos++] = (uint8_t)cfg->imu.gyro_range;
+    buf[pos++] = (uint8_t)cfg->imu.accel_bandwidth;
+    buf[pos++] = cfg->imu.low_power ? 1 : 0;
+    buf[pos++] = (uint8_t)cfg->environment_oversampling;
+    buf[pos++] = cfg->adaptive ? 1 : 0;
+    return pos;
+}
+
+/** Publish the settings in use to the register map, and pick them up from the sensors first. */
+static void publish_config(void)
+{
+    imu_get_config(&config.imu);
+    temp_config_t temp_config;
+    temp_get_config(&temp_config);
+    config.environment_oversampling = temp_config.temperature_oversampling;
+
+    uint8_t buf[SENSORS_CONFIG_LEN];
+    const size_t len = sensors_pack_config(&config, buf);
+    cmds_register_write(SENSORS_REG_CONFIG, buf, len);
+}
+
+/** Make everything that follows the IMU's rate (and the gyro's full scale) follow it. */
+static void apply_imu_rate(void)
+{
+    imu_config_t imu_config;
+    imu_get_config(&imu_config);
+    const uint32_t decihz = imu_odr_decihz(imu_config.odr);
+
+#if SENSORS_ENABLE_FUSION
+    fusion_set_imu_config(&imu_config);
+#endif // SENSORS_ENABLE_FUSION
+
+#if SENSORS_ADAPTIVE_SAMPLING
+    // udps per LSB by imu_gyro_range_t: 8750 at 250 dps, doubling with each wider full scale, and 4375 at 125 dps
+    static const uint32_t GYRO_UDPS_PER_LSB[] = { 8750, 17500, 35000, 70000, 4375 };
+    uint32_t threshold = (SENSORS_ADAPTIVE_GYRO_DPS * 1000000U) / GYRO_UDPS_PER_LSB[imu_config.gyro_range];
+    threshold = (threshold > INT16_MAX) ? INT16_MAX : threshold;
+    adaptive_gyro_threshold_sq = threshold * threshold;
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+#if SENSORS_PUBLISH_PSACP
+    const uint32_t decimation = decihz / (SENSORS_PSACP_IMU_RATE_HZ * 10U);
+    psacp_imu_decimation = (decimation == 0) ? 1 : decimation;
+#endif // SENSORS_PUBLISH_PSACP
+
+    imu_period_us = (decihz == 0) ? 0 : (10000000U / decihz);
+    imu_stamp_resync = true;
+
+    if (decihz == 0)
+    {
+        // Powered down: nothing comes into the FIFO, so leave it be
+        return;
+    }
+
+    // This empties the FIFO, so there are no samples left at the old rate
+    uint32_t watermark = (IMU_FIFO_WATERMARK_MS * decihz) / 10000U;
+    watermark = (watermark == 0) ? 1 : watermark;
+    watermark = (watermark > IMU_BATCH_SAMPLES) ? IMU_BATCH_SAMPLES : watermark;
+    imu_watermark = watermark;
+    imu_fifo_enable((uint16_t)watermark);
+}
+
+void sensors_configure(const sensors_config_t *new_config)
+{
+    if ((new_config->environment_oversampling < TEMP_OVERSAMPLING_X1) || (new_config->environment_oversampling > TEMP_OVERSAMPLING_X16))
+    {
+        log_error("Environment oversampling %u is out of range.\n", new_config->environment_oversampling);
+        return;
+    }
+
+    if (new_config->environment_oversampling != config.environment_oversampling)
+    {
+        temp_config_t temp_config;
+        temp_get_config(&temp_config);
+        temp_config.temperature_oversampling = new_config->environment_oversampling;
+        temp_config.pressure_oversampling = new_config->environment_oversampling;
+        temp_config.humidity_oversampling = new_config->environment_oversampling;
+        temp_configure(&temp_config);
+    }
+
+#if SENSORS_ADAPTIVE_SAMPLING
+    const bool start_adaptive = new_config->adaptive && !config.adaptive;
+    config.adaptive = new_config->adaptive;
+#else
+    config.adaptive = false;
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+    const imu_config_t *imu_config = &new_config->imu;
+    if ((imu_config->odr != config.imu.odr) || (imu_config->accel_range != config.imu.accel_range) ||
+        (imu_config->gyro_range != config.imu.gyro_range) || (imu_config->accel_bandwidth != config.imu.accel_bandwidth) ||
+        (imu_config->low_power != config.imu.low_power))
+    {
+        const imu_odr_t old_odr = config.imu.odr;
+        const imu_gyro_range_t old_gyro_range = config.imu.gyro_range;
+        imu_configure(imu_config);
+        imu_get_config(&config.imu);
+        if ((config.imu.odr != old_odr) || (config.imu.gyro_range != old_gyro_range))
+        {
+            apply_imu_rate();
+        }
+    }
+
+    publish_config();
+
+#if SENSORS_ADAPTIVE_SAMPLING
+    if (start_adaptive)
+    {
+        // Start out active, and settle from there
+        adaptive_last_activity_ms = to_ms_since_boot(get_absolute_time());
+        adaptive_apply(true);
+    }
+#endif // SENSORS_ADAPTIVE_SAMPLING
+}
+
+void sensors_get_config(sensors_config_t *out)
+{
+    *out = config;
+}
+
+#if SENSORS_ADAPTIVE_SAMPLING
+static void adaptive_apply(bool active)
+{
+    adaptive_active = active;
+    adaptive_temp_skip = 0;
+
+    sensors_config_t new_config = config;
+    new_config.imu.odr = active ? SENSORS_ADAPTIVE_ACTIVE_ODR : SENSORS_ADAPTIVE_IDLE_ODR;
+    new_config.imu.low_power = !active;
+    sensors_configure(&new_config);
+
+    // The environment sensor needn't convert as often while idle either
+    temp_config_t temp_config;
+    temp_get_config(&temp_config);
+    temp_config.standby = active ? TEMP_DEFAULT_CONFIG.standby : TEMP_STANDBY_1000_MS;
+    temp_configure(&temp_config);
+}
+
+/** Alarm: something started going on (see adaptive_note_activity()). */
+static int64_t adaptive_switch_cb(alarm_id_t id, void *unused)
+{
+    adaptive_switch_pending = false;
+    if (config.adaptive && !adaptive_active)
+    {
+        adaptive_apply(true);
+    }
+
+    // Don't fire again
+    return 0;
+}
+
+static void adaptive_note_activity(void)
+{
+    adaptive_last_activity_ms = to_ms_since_boot(get_absolute_time());
+    if (adaptive_active || adaptive_switch_pending)
+    {
+        return;
+    }
+
+    // Changing rates takes blocking SPI writes, which can't wait on the SPI DMA IRQ we're called from,
+    // so an alarm does it straight after
+    adaptive_switch_pending = true;
+    if (alarm_pool_add_alarm_in_us(acquisition_alarm_pool, ADAPTIVE_SWITCH_DELAY_US, &adaptive_switch_cb, NULL, true) < 0)
+    {
+        // Out of alarms. The next activity tries again.
+        adaptive_switch_pending = false;
+    }
+}
+
+static void adaptive_check_quiet(void)
+{
+    if (!config.adaptive || !adaptive_active)
+    {
+        return;
+    }
+
+    const uint32_t quiet_ms = to_ms_since_boot(get_absolute_time()) - adaptive_last_activity_ms;
+    if (quiet_ms >= SENSORS_ADAPTIVE_QUIET_MS)
+    {
+        adaptive_apply(false);
+    }
+}
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+/** If `command` is a configuration command, apply it and return true. On the acquisition core. */
+static bool config_cmd(cmd_t command);
+
+/** Core 1: bring up the sensors, with their interrupts and timers on this core. */
+/**
+ * Most reading the IMU can take and pass the self test, as a percentage of what its bytes (the register
+ * address and the values) take at SENSORS_SPI_BAUDRATE, and a few us more for the chip select and the call.
+ */
+#define SELF_TEST_READ_LIMIT_PERCENT 200U
+#define SELF_TEST_READ_OVERHEAD_US 10U
+
+/** BIST_SENSOR_SPI_READ: how long reading the IMU's values takes, as each batch of them is read. */
+static bool measure_imu_read(uint32_t *us, void *context)
+{
+    imu_sensor_values_t values;
+    const uint32_t start = time_us_32();
+    imu_read(&values);
+    *us = time_us_32() - start;
+    return true;
+}
+
+static void acquisition_init(void)
+{
+    acquisition_alarm_pool = alarm_pool_create_with_unused_hardware_alarm(ACQUISITION_MAX_TIMERS);
+
+    // Initialize the SPI interface that the sensors will be using
+    myspi_init(SENSORS_SPI_BAUDRATE);
+    gpio_set_function(SENSORS_SPI_MISO, GPIO_FUNC_SPI);
+    gpio_set_function(SENSORS_SPI_CLOCK, GPIO_FUNC_SPI);
+    gpio_set_function(SENSORS_SPI_MOSI, GPIO_FUNC_SPI);
+
+    // Initialize the sensors themselves
+    latency_init();
+    temp_init();
+    imu_init();
+
+    // Before anything else takes the bus, so the reads are timed on their own
+    const uint32_t expected_us = (uint32_t)(((1U + sizeof(imu_sensor_values_t)) * 8U * 1000000ULL) / SENSORS_SPI_BAUDRATE);
+    bist_run(BIST_SENSOR_SPI_READ, &measure_imu_read, NULL, ((expected_us * SELF_TEST_READ_LIMIT_PERCENT) / 100U) + SELF_TEST_READ_OVERHEAD_US);
+#if SENSORS_ENABLE_HISTORY
+    history_init();
+#endif // SENSORS_ENABLE_HISTORY
+
+    // Read the IMU whenever its FIFO reaches the watermark (INT1 goes high).
+    gpio_init(SENSORS_IMU_INT1);
+    gpio_set_dir(SENSORS_IMU_INT1, GPIO_IN);
+    gpioirq_add(SENSORS_IMU_INT1, GPIO_IRQ_EDGE_RISE, 0, &imu_int1_irq, NULL);
+    apply_imu_rate();
+    config.adaptive = (SENSORS_ADAPTIVE_SAMPLING != 0);
+    publish_config();
+#if SENSORS_ADAPTIVE_SAMPLING
+    // Start out active (at IMU_DEFAULT_CONFIG's rate, not necessarily SENSORS_ADAPTIVE_ACTIVE_ODR), and settle from there
+    adaptive_last_activity_ms = to_ms_since_boot(get_absolute_time());
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+    // The IMU detects motion events itself, and raises INT2 (until it's read) when one happens
+    gpio_init(SENSORS_IMU_INT2);
+    gpio_set_dir(SENSORS_IMU_INT2, GPIO_IN);
+    gpioirq_add(SENSORS_IMU_INT2, GPIO_IRQ_EDGE_RISE, 0, &imu_int2_irq, NULL);
+    imu_events_enable(SENSORS_IMU_EVENTS);
+
+    // Initialize a timer with callbacks for reading temperature/pressure/humidity values.
+    bool worked = alarm_pool_add_repeating_timer_ms(acquisition_alarm_pool, MS_BETWEEN_TEMP_READ, &temp_read_cb, NULL, &temp_read_timer);
+    if (!worked)
+    {
+        log_error("Could not initialize repeating temperature sensor read timer.\n");
+    }
+
+#if SENSORS_PUBLISH_PSACP
+    // Publish IMU batches as often as they fill up (or more often, when the IMU is slower than the publish rate)
+    const int64_t psacp_imu_period_us = (1000000LL * SENSORS_PSACP_IMU_BATCH) / SENSORS_PSACP_IMU_RATE_HZ;
+    worked = alarm_pool_add_repeating_timer_us(acquisition_alarm_pool, psacp_imu_period_us, &psacp_imu_publish_cb, NULL, &psacp_imu_timer);
+    if (!worked)
+    {
+        log_error("Could not initialize repeating IMU publish timer.\n");
+    }
+#endif // SENSORS_PUBLISH_PSACP
+}
+
+/**
+ * Core 1: the acquisition core. The reads themselves run from its interrupts (the IMU's pins,
+ * the SPI DMA, and its timers); in between, it filters the samples and applies configuration.
+ */
+static void acquisition_core_main(void)
+{
+    acquisition_init();
+    __dmb();
+    acquisition_ready = true;
+    __sev();
+
+    while (true)
+    {
+        uint8_t command;
+        while (intercore_try_receive(&config_queue, &command))
+        {
+            if (!config_cmd((cmd_t)command))
+            {
+                log_error("Illegal cmd type 0x%02X in sensors subsystem\n", command);
+            }
+        }
+
+#if SENSORS_ENABLE_FUSION
+        fusion_process();
+#endif // SENSORS_ENABLE_FUSION
+
+        // A new batch of samples, a configuration command from core 0, or any interrupt wakes us
+        __wfe();
+    }
+}
+
+void sensors_init(void)
+{
+    intercore_channel_init(&config_queue, config_queue_items, sizeof(config_queue_items[0]), CONFIG_QUEUE_SIZE);
+
+    log_info("Starting sensor acquisition on core 1\n");
+    multicore_launch_core1(acquisition_core_main);
+    while (!acquisition_ready)
+    {
+        __wfe();
+    }
+    __dmb();
+}
+
+void sensors_set_imu_batch_handler(sensors_imu_batch_handler_t handler)
+{
+    imu_batch_handler = handler;
+}
+
+void sensors_set_motion_handler(sensors_motion_handler_t handler)
+{
+    motion_handler = handler;
+}
+
+void sensors_get_snapshot(sensor_values_t *snapshot)
+{
+    uint32_t seq;
+    do
+    {
+        seq = sensor_values_seq;
+        __dmb();
+        *snapshot = sensor_values;
+        __dmb();
+        // Retry if the writer was partway through (odd) or finished a write while we copied.
+    } while ((seq & 1) || (seq != sensor_values_seq));
+}
+
+/** Load the read register with the selected groups of values from `snapshot`. */
+static void load_burst(const sensor_values_t *snapshot, uint8_t groups)
+{
+    // Version, groups, 3 x 4 environment bytes, 3 x 2 accel bytes, 3 x 2 gyro bytes
+    uint8_t buf[2 + 12 + 6 + 6];
+    size_t pos = 0;
+
+    buf[pos++] = SENSORS_BURST_VERSION;
+    buf[pos++] = groups;
+    if (groups & SENSORS_BURST_ENVIRONMENT)
+    {
+        pack_le(buf, &pos, (uint32_t)snapshot->temp_sensor_values.temperature_centi_c, 4);
+        pack_le(buf, &pos, snapshot->temp_sensor_values.pressure_pa_q24_8, 4);
+        pack_le(buf, &pos, snapshot->temp_sensor_values.humidity_percent_rh_q22_10, 4);
+    }
+    if (groups & SENSORS_BURST_ACCEL)
+    {
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_x, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_y, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_z, 2);
+    }
+    if (groups & SENSORS_BURST_GYRO)
+    {
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_x, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_y, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_z, 2);
+    }
+
+    cmds_set_register_bytes(buf, pos);
+}
+
+/** Load the read register with the newest IMU sample or environment read from `snapshot`, and its stamp. */
+static void load_stamped(const sensor_values_t *snapshot, uint8_t stream)
+{
+    // Version, seq, timestamp, then 12 bytes of values either way
+    uint8_t buf[1 + 4 + 8 + 12];
+    size_t pos = 0;
+    const sensors_stamp_t *stamp = (stream == SENSORS_STAMPED_ENVIRONMENT) ? &snapshot->temp_stamp : &snapshot->imu_stamp;
+
+    buf[pos++] = SENSORS_STAMPED_VERSION;
+    pack_le(buf, &pos, stamp->seq, 4);
+    pack_le(buf, &pos, (uint32_t)(stamp->timestamp_us & 0xFFFFFFFF), 4);
+    pack_le(buf, &pos, (uint32_t)(stamp->timestamp_us >> 32), 4);
+    if (stream == SENSORS_STAMPED_ENVIRONMENT)
+    {
+        pack_le(buf, &pos, (uint32_t)snapshot->temp_sensor_values.temperature_centi_c, 4);
+        pack_le(buf, &pos, snapshot->temp_sensor_values.pressure_pa_q24_8, 4);
+        pack_le(buf, &pos, snapshot->temp_sensor_values.humidity_percent_rh_q22_10, 4);
+    }
+    else
+    {
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_x, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_y, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.accel_z, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_x, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_y, 2);
+        pack_le(buf, &pos, (uint16_t)snapshot->imu_sensor_values.gyro_z, 2);
+    }
+
+    cmds_set_register_bytes(buf, pos);
+}
+
+/** Load the read register with the latency histograms, and start them again. */
+static void load_latency(void)
+{
+    uint8_t buf[1 + LATENCY_PACKED_LEN];
+    buf[0] = SENSORS_LATENCY_VERSION;
+    const size_t len = latency_pack_and_clear(&buf[1], sizeof(buf) - 1);
+    cmds_set_register_bytes(buf, 1 + len);
+}
+
+#if SENSORS_ENABLE_FUSION
+/** Load the read register with the latest orientation estimate. */
+static void load_orientation(void)
+{
+    fusion_orientation_t orientation;
+    fusion_get_orientation(&orientation);
+
+    // Version, w, x, y, z, timestamp
+    uint8_t buf[1 + 4 * 4 + 8];
+    size_t pos = 0;
+    buf[pos++] = SENSORS_ORIENTATION_VERSION;
+    pack_le(buf, &pos, (uint32_t)orientation.w, 4);
+    pack_le(buf, &pos, (uint32_t)orientation.x, 4);
+    pack_le(buf, &pos, (uint32_t)orientation.y, 4);
+    pack_le(buf, &pos, (uint32_t)orientation.z, 4);
+    pack_le(buf, &pos, (uint32_t)(orientation.timestamp_us & 0xFFFFFFFF), 4);
+    pack_le(buf, &pos, (uint32_t)(orientation.timestamp_us >> 32), 4);
+
+    cmds_set_register_bytes(buf, pos);
+}
+#endif // SENSORS_ENABLE_FUSION
+
+#if SENSORS_ENABLE_HISTORY
+/** Pack the next page of a level's history into SENSORS_REG_HISTORY. */
+static void load_history(history_level_t level)
+{
+    if (level >= HISTORY_NUM_LEVELS)
+    {
+        log_error("Illegal history level %u in sensors subsystem\n", (unsigned)level);
+        return;
+    }
+
+    uint8_t buf[SENSORS_HISTORY_WINDOW_LEN];
+    const size_t len = history_read_page(level, buf, sizeof(buf));
+    cmds_register_write(SENSORS_REG_HISTORY, buf, len);
+}
+#endif // SENSORS_ENABLE_HISTORY
+
+static bool config_cmd(cmd_t command)
+{
+    sensors_config_t new_config = config;
+    if ((command & CMD_SENSORS_SET_ADAPTIVE_MASK) == CMD_SENSORS_SET_ADAPTIVE)
+    {
+        // Before the gyro range, whose mask this is inside of
+        new_config.adaptive = (command & ~CMD_SENSORS_SET_ADAPTIVE_MASK) != 0;
+    }
+    else if ((command & CMD_SENSORS_SET_IMU_ODR_MASK) == CMD_SENSORS_SET_IMU_ODR)
+    {
+        // The controller has picked a rate, so it's not up to adaptive sampling any more
+        new_config.imu.odr = (imu_odr_t)(command & ~CMD_SENSORS_SET_IMU_ODR_MASK);
+        new_config.adaptive = false;
+    }
+    else if ((command & CMD_SENSORS_SET_IMU_POWER_MASK) == CMD_SENSORS_SET_IMU_POWER)
+    {
+        new_config.imu.low_power = (command & ~CMD_SENSORS_SET_IMU_POWER_MASK) != 0;
+        new_config.adaptive = false;
+    }
+    else if ((command & CMD_SENSORS_SET_ACCEL_RANGE_MASK) == CMD_SENSORS_SET_ACCEL_RANGE)
+    {
+        new_config.imu.accel_range = (imu_accel_range_t)(command & ~CMD_SENSORS_SET_ACCEL_RANGE_MASK);
+    }
+    else if ((command & CMD_SENSORS_SET_ACCEL_BANDWIDTH_MASK) == CMD_SENSORS_SET_ACCEL_BANDWIDTH)
+    {
+        new_config.imu.accel_bandwidth = (imu_accel_bandwidth_t)(command & ~CMD_SENSORS_SET_ACCEL_BANDWIDTH_MASK);
+    }
+    else if ((command & CMD_SENSORS_SET_GYRO_RANGE_MASK) == CMD_SENSORS_SET_GYRO_RANGE)
+    {
+        new_config.imu.gyro_range = (imu_gyro_range_t)(command & ~CMD_SENSORS_SET_GYRO_RANGE_MASK);
+    }
+    else if (((command & CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK) == CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING) &&
+             ((command & ~CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK) != 0))
+    {
+        // With no low bits, it's CMD_SENSORS_READ_GYRO_Z
+        new_config.environment_oversampling = (temp_oversampling_t)(command & ~CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK);
+    }
+    else
+    {
+        return false;
+    }
+
+    sensors_configure(&new_config);
+    return true;
+}
+
+void sensors_cmd(cmd_t command)
+{
+#if SENSORS_ENABLE_HISTORY
+    // Before the configuration commands, as these are inside CMD_SENSORS_SET_IMU_ODR_MASK
+    if ((command & CMD_SENSORS_READ_HISTORY_MASK) == CMD_SENSORS_READ_HISTORY)
+    {
+        load_history((history_level_t)(command & ~CMD_SENSORS_READ_HISTORY_MASK));
+        return;
+    }
+#endif // SENSORS_ENABLE_HISTORY
+
+    sensor_values_t snapshot;
+    sensors_get_snapshot(&snapshot);
+
+    if ((command & CMD_SENSORS_READ_BURST_MASK) == CMD_SENSORS_READ_BURST)
+    {
+        load_burst(&snapshot, command & SENSORS_BURST_ALL);
+        return;
+    }
+
+    // Before the configuration commands, as these are inside CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK
+    if ((command & CMD_SENSORS_READ_STAMPED_MASK) == CMD_SENSORS_READ_STAMPED)
+    {
+        load_stamped(&snapshot, command & ~CMD_SENSORS_READ_STAMPED_MASK);
+        return;
+    }
+
+    if (command == CMD_SENSORS_READ_LATENCY)
+    {
+        load_latency();
+        return;
+    }
+
+#if SENSORS_ENABLE_FUSION
+    if (command == CMD_SENSORS_READ_ORIENTATION)
+    {
+        load_orientation();
+        return;
+    }
+#endif // SENSORS_ENABLE_FUSION
+
+    switch (command)
+    {
+        case CMD_SENSORS_READ_TEMPERATURE:
+            cmds_set_register_value((uint32_t)snapshot.temp_sensor_values.temperature_centi_c);
+            break;
+        case CMD_SENSORS_READ_HUMIDITY:
+            cmds_set_register_value(snapshot.temp_sensor_values.humidity_percent_rh_q22_10);
+            break;
+        case CMD_SENSORS_READ_PRESSURE:
+            cmds_set_register_value(snapshot.temp_sensor_values.pressure_pa_q24_8);
+            break;
+        case CMD_SENSORS_READ_ACCEL_X:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.accel_x);
+            break;
+        case CMD_SENSORS_READ_ACCEL_Y:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.accel_y);
+            break;
+        case CMD_SENSORS_READ_ACCEL_Z:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.accel_z);
+            break;
+        case CMD_SENSORS_READ_GYRO_X:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.gyro_x);
+            break;
+        case CMD_SENSORS_READ_GYRO_Y:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.gyro_y);
+            break;
+        case CMD_SENSORS_READ_GYRO_Z:
+            cmds_set_register_value((uint32_t)(int32_t)snapshot.imu_sensor_values.gyro_z);
+            break;
+        default:
+        {
+            // Anything else changes the configuration, which takes the SPI bus, so it's the acquisition core's to do
+            const uint8_t byte = (uint8_t)command;
+            if (!intercore_try_send(&config_queue, &byte))
+            {
+                log_error("Sensors configuration queue is full; dropping 0x%02X\n", byte);
+            }
+            break;
+        }
+    }
+}
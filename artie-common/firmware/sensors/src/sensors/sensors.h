@@ -0,0 +1,323 @@
+/**
+ * @file sensors.h
+ * @brief Interface to the sensors submodule.
+ * The rest of the program should talk to this module instead
+ * of talking to the other sensors directly.
+ *
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../cmds/cmds.h"
+#include "../board/types.h"
+#include "imu.h"
+#include "temp.h"
+
+/**
+ * Burst read: `CMD_SENSORS_READ_BURST | SENSORS_BURST_*` loads the read register with
+ * every selected group of values, from one consistent snapshot, so the controller
+ * can fetch all of them in a single I2C read. See README.md for the layout.
+ */
+#define CMD_SENSORS_READ_BURST          (CMD_MODULE_ID_SENSORS | 0x20)
+
+/** Mask to detect a burst read command. The low three bits are the group selection. */
+#define CMD_SENSORS_READ_BURST_MASK     0xF8
+
+/** Burst read groups. */
+#define SENSORS_BURST_ENVIRONMENT       0x01    // Temperature, pressure, humidity
+#define SENSORS_BURST_ACCEL             0x02    // Accelerometer X, Y, Z
+#define SENSORS_BURST_GYRO              0x04    // Gyroscope X, Y, Z
+#define SENSORS_BURST_ALL               (SENSORS_BURST_ENVIRONMENT | SENSORS_BURST_ACCEL | SENSORS_BURST_GYRO)
+
+/** Layout version of the burst read response. Bump this if the layout changes. */
+#define SENSORS_BURST_VERSION           0x01
+
+#ifndef SENSORS_ENABLE_FUSION
+    /** Estimate orientation from the IMU on core 1 (see fusion.h). */
+    #define SENSORS_ENABLE_FUSION 1
+#endif
+
+/**
+ * Orientation read: loads the read register with a version byte, then the orientation quaternion
+ * (w, x, y, z; int32 Q2.30) and the timestamp of its newest sample (uint64 us since boot), little-endian.
+ * Only if SENSORS_ENABLE_FUSION.
+ */
+#define CMD_SENSORS_READ_ORIENTATION    (CMD_MODULE_ID_SENSORS | 0x28)
+
+/** Layout version of the orientation read response. */
+#define SENSORS_ORIENTATION_VERSION     0x01
+
+/**
+ * Stamped read: `CMD_SENSORS_READ_STAMPED | SENSORS_STAMPED_*` loads the read register with a version byte,
+ * then the newest IMU sample's (or environment read's) sequence number (uint32) and timestamp (uint64, us
+ * since boot), then its values as in the burst read, little-endian, from one consistent snapshot.
+ * See sensors_stamp_t. Its codes are past the last temp_oversampling_t, inside CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK.
+ */
+#define CMD_SENSORS_READ_STAMPED        (CMD_MODULE_ID_SENSORS | 0x0E)
+#define CMD_SENSORS_READ_STAMPED_MASK   0xFE
+
+/** Stamped read streams. */
+#define SENSORS_STAMPED_IMU             0x00    // Accelerometer X, Y, Z, then gyroscope X, Y, Z
+#define SENSORS_STAMPED_ENVIRONMENT     0x01    // Temperature, pressure, humidity
+
+/** Layout version of the stamped read response. */
+#define SENSORS_STAMPED_VERSION         0x01
+
+/**
+ * Latency read: loads the read register with a version byte, then the histograms of how long the
+ * IMU samples and the environment reads took to become available since the last latency read,
+ * and starts them again. See latency_pack_and_clear() and README.md for the layout.
+ */
+#define CMD_SENSORS_READ_LATENCY        (CMD_MODULE_ID_SENSORS | 0x29)
+
+/** Layout version of the latency read response. */
+#define SENSORS_LATENCY_VERSION         0x01
+
+#ifndef SENSORS_ENABLE_HISTORY
+    /** Keep a history of the sensor values at several resolutions (see history.h). About 33 KB of RAM. */
+    #define SENSORS_ENABLE_HISTORY 1
+#endif
+
+/**
+ * History read: `CMD_SENSORS_READ_HISTORY | history_level_t` packs the next page of that level's
+ * history (the records the controller hasn't had yet, as many as fit) into SENSORS_REG_HISTORY,
+ * for the controller to read from there. See history_read_page() and README.md for the layout.
+ * Only if SENSORS_ENABLE_HISTORY. Its codes are past the last imu_odr_t, inside CMD_SENSORS_SET_IMU_ODR_MASK.
+ */
+#define CMD_SENSORS_READ_HISTORY        (CMD_MODULE_ID_SENSORS | 0x1C)
+#define CMD_SENSORS_READ_HISTORY_MASK   0xFC
+
+/**
+ * Configuration: each of these takes its setting in its low bits and applies it straight away,
+ * so the controller can trade accuracy for throughput (and power) as it goes. A change to the
+ * IMU's rate empties its FIFO. SENSORS_REG_CONFIG has the settings in use. See README.md.
+ */
+#define CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING        (CMD_MODULE_ID_SENSORS | 0x08)  // | temp_oversampling_t, X1 (1) to X16 (5), for all three
+#define CMD_SENSORS_SET_ENVIRONMENT_OVERSAMPLING_MASK   0xF8
+#define CMD_SENSORS_SET_IMU_ODR                         (CMD_MODULE_ID_SENSORS | 0x10)  // | imu_odr_t
+#define CMD_SENSORS_SET_IMU_ODR_MASK                    0xF0
+#define CMD_SENSORS_SET_IMU_POWER                       (CMD_MODULE_ID_SENSORS | 0x2A)  // | 1 for low power, 0 for high performance
+#define CMD_SENSORS_SET_IMU_POWER_MASK                  0xFE
+#define CMD_SENSORS_SET_ACCEL_RANGE                     (CMD_MODULE_ID_SENSORS | 0x2C)  // | imu_accel_range_t
+#define CMD_SENSORS_SET_ACCEL_RANGE_MASK                0xFC
+#define CMD_SENSORS_SET_ACCEL_BANDWIDTH                 (CMD_MODULE_ID_SENSORS | 0x30)  // | imu_accel_bandwidth_t
+#define CMD_SENSORS_SET_ACCEL_BANDWIDTH_MASK            0xF8
+#define CMD_SENSORS_SET_GYRO_RANGE                      (CMD_MODULE_ID_SENSORS | 0x38)  // | imu_gyro_range_t
+#define CMD_SENSORS_SET_GYRO_RANGE_MASK                 0xF8
+#define CMD_SENSORS_SET_ADAPTIVE                        (CMD_MODULE_ID_SENSORS | 0x3E)  // | 1 to sample adaptively (see SENSORS_ADAPTIVE_SAMPLING), 0 not to
+#define CMD_SENSORS_SET_ADAPTIVE_MASK                   0xFE
+
+/**
+ * Register map (see CMDS_REGISTER_SELECT in cmds.h). The values are published as they are read,
+ * in the same layouts as the burst and orientation reads, so the controller can read them
+ * without sending a command first. Environment, accel, and gyro are contiguous, so one
+ * read from SENSORS_REG_ENVIRONMENT gets all three.
+ */
+#define SENSORS_REG_ENVIRONMENT         (CMDS_REG_FIRMWARE_FIRST + 0x00)    // Temperature, pressure, humidity (12 bytes)
+#define SENSORS_REG_ACCEL               (CMDS_REG_FIRMWARE_FIRST + 0x0C)    // Accelerometer X, Y, Z (6 bytes)
+#define SENSORS_REG_GYRO                (CMDS_REG_FIRMWARE_FIRST + 0x12)    // Gyroscope X, Y, Z (6 bytes)
+#define SENSORS_REG_ORIENTATION         (CMDS_REG_FIRMWARE_FIRST + 0x18)    // w, x, y, z, timestamp (24 bytes). Only if SENSORS_ENABLE_FUSION.
+#define SENSORS_REG_MOTION              (CMDS_REG_FIRMWARE_FIRST + 0x30)    // The latest motion event (10 bytes). See sensors_pack_motion().
+#define SENSORS_REG_CONFIG              (CMDS_REG_FIRMWARE_FIRST + 0x3A)    // The settings in use (7 bytes). See sensors_pack_config().
+#define SENSORS_REG_HISTORY             (CMDS_REG_FIRMWARE_FIRST + 0x48)    // The last history page (to the end of the map). Only if SENSORS_ENABLE_HISTORY.
+
+/** Bytes of SENSORS_REG_HISTORY: 10 raw records, or 3 rollups, and the header. */
+#define SENSORS_HISTORY_WINDOW_LEN      (CMDS_REGISTER_MAP_LEN - SENSORS_REG_HISTORY)
+
+#ifndef SENSORS_IMU_EVENTS
+    /** The motion events (IMU_EVENT_*) the IMU detects by itself and signals on INT2. 0 for none. */
+    #define SENSORS_IMU_EVENTS IMU_EVENT_ALL
+#endif // SENSORS_IMU_EVENTS
+
+#ifndef SENSORS_ADAPTIVE_SAMPLING
+    /**
+     * Sample fast only while there's something going on. The IMU runs at SENSORS_ADAPTIVE_IDLE_ODR
+     * in low-power mode, and the environment is read every SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS, until
+     * a motion event or the gyro (past SENSORS_ADAPTIVE_GYRO_DPS) says the robot is moving. Then the
+     * IMU goes to SENSORS_ADAPTIVE_ACTIVE_ODR in high-performance mode, and the environment is read
+     * every second, until SENSORS_ADAPTIVE_QUIET_MS pass with no more. CMD_SENSORS_SET_IMU_ODR and
+     * CMD_SENSORS_SET_IMU_POWER turn it off, as the controller has picked a rate itself;
+     * CMD_SENSORS_SET_ADAPTIVE turns it on or off.
+     */
+    #define SENSORS_ADAPTIVE_SAMPLING 1
+#endif // SENSORS_ADAPTIVE_SAMPLING
+
+#ifndef SENSORS_ADAPTIVE_IDLE_ODR
+    /** IMU rate while nothing is going on (imu_odr_t). */
+    #define SENSORS_ADAPTIVE_IDLE_ODR IMU_ODR_26_HZ
+#endif // SENSORS_ADAPTIVE_IDLE_ODR
+
+#ifndef SENSORS_ADAPTIVE_ACTIVE_ODR
+    /** IMU rate while the robot is moving (imu_odr_t). */
+    #define SENSORS_ADAPTIVE_ACTIVE_ODR IMU_ODR_208_HZ
+#endif // SENSORS_ADAPTIVE_ACTIVE_ODR
+
+#ifndef SENSORS_ADAPTIVE_GYRO_DPS
+    /** Turning faster than this (in degrees per second, on all axes together) counts as moving. */
+    #define SENSORS_ADAPTIVE_GYRO_DPS 10U
+#endif // SENSORS_ADAPTIVE_GYRO_DPS
+
+#ifndef SENSORS_ADAPTIVE_QUIET_MS
+    /** How long with nothing going on before the rates go back down. */
+    #define SENSORS_ADAPTIVE_QUIET_MS 5000U
+#endif // SENSORS_ADAPTIVE_QUIET_MS
+
+#ifndef SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS
+    /** ms between reads of the environment while nothing is going on, rounded down to whole seconds. */
+    #define SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS 5000U
+#endif // SENSORS_ADAPTIVE_IDLE_TEMP_READ_MS
+
+#ifndef SENSORS_PUBLISH_PSACP
+    /** Publish the IMU and environment values as PSACP topics as well (see psacp.h). Needs the CAN command bus. */
+    #define SENSORS_PUBLISH_PSACP CMDS_USE_CAN
+#endif // SENSORS_PUBLISH_PSACP
+
+#ifndef SENSORS_PSACP_IMU_RATE_HZ
+    /**
+     * IMU samples published per second. Every (IMU rate / this)th sample goes out, rounded down,
+     * or every one when the IMU is slower than this.
+     */
+    #define SENSORS_PSACP_IMU_RATE_HZ 52U
+#endif // SENSORS_PSACP_IMU_RATE_HZ
+
+#ifndef SENSORS_PSACP_IMU_BATCH
+    /**
+     * IMU samples per publish. Odd batches fill their last frame: 1, 3, and 5 samples
+     * take exactly 2, 5, and 8 frames. 5 is the most that fits.
+     */
+    #define SENSORS_PSACP_IMU_BATCH 3U
+#endif // SENSORS_PSACP_IMU_BATCH
+
+#ifndef SENSORS_PSACP_ENVIRONMENT_PERIOD_MS
+    /** ms between publishes of the environment values, rounded up to a whole number of reads (one a second). */
+    #define SENSORS_PSACP_ENVIRONMENT_PERIOD_MS 1000U
+#endif // SENSORS_PSACP_ENVIRONMENT_PERIOD_MS
+
+/** PSACP topics. See README.md for the layouts. */
+#define SENSORS_TOPIC_IMU               0x0B    // SENSORS_PSACP_IMU_BATCH samples, oldest first: accel X, Y, Z, then gyro X, Y, Z
+#define SENSORS_TOPIC_ENVIRONMENT       0x0C    // Temperature, pressure, humidity, as in the burst read
+#define SENSORS_TOPIC_MOTION            0x0D    // Each motion event, as in SENSORS_REG_MOTION
+
+/**
+ * When a value was ready, and which one it was, so the controller can line the values up with
+ * its other sensors and tell when some were lost.
+ *
+ * An IMU sample's timestamp is when INT1 rose for the FIFO watermark, counted forward or back
+ * from the sample that reached it at the IMU's rate, and its sequence number counts the IMU's
+ * sample periods since boot, so a jump of more than one is samples lost (to a full FIFO, say).
+ * An environment read's timestamp is when the read started (the sensor converts on its own, and
+ * has no data-ready line), and its sequence number counts the reads due, so a jump is a read that
+ * couldn't start.
+ */
+typedef struct {
+    uint32_t seq;           // This one included, since boot (wraps)
+    uint64_t timestamp_us;  // us since boot (time_us_64())
+} sensors_stamp_t;
+
+/** Sensor values all together. */
+typedef struct {
+    temp_sensor_values_t temp_sensor_values;
+    imu_sensor_values_t imu_sensor_values;
+    sensors_stamp_t temp_stamp;     // Of temp_sensor_values
+    sensors_stamp_t imu_stamp;      // Of imu_sensor_values
+} sensor_values_t;
+
+/**
+ * @brief Called with every IMU sample, a batch at a time, oldest first. `newest` stamps the last
+ * of them; each one before it is a sequence number and one IMU sample period earlier.
+ * Runs in the SPI DMA IRQ, on the acquisition core (core 1).
+ */
+typedef void (*sensors_imu_batch_handler_t)(const imu_sensor_values_t *samples, size_t nsamples, const sensors_stamp_t *newest);
+
+/** A motion event, as it is published. */
+typedef struct {
+    uint16_t count;         // Motion events so far, this one included (wraps)
+    imu_motion_t motion;
+    uint32_t timestamp_ms;  // When INT2 was read, in ms since boot
+} sensors_motion_event_t;
+
+/** Bytes of a packed sensors_motion_event_t. */
+#define SENSORS_MOTION_LEN              10U
+
+/**
+ * @brief Called with each motion event the IMU signals (see SENSORS_IMU_EVENTS).
+ * Runs in the SPI DMA IRQ, on the acquisition core (core 1).
+ */
+typedef void (*sensors_motion_handler_t)(const sensors_motion_event_t *event);
+
+/**
+ * @brief Initialize the sensors subsystem, on core 1: the acquisition core. It owns the SPI bus,
+ * the IMU's interrupts, and the sensor timers, and filters the samples (see fusion.h) between
+ * reads, so nothing on the command bus can hold up a read. Core 0 answers the controller from
+ * the snapshots core 1 publishes (see sensors_get_snapshot()). Call once, from core 0.
+ * Returns once the sensors are initialized.
+ */
+void sensors_init(void);
+
+/**
+ * @brief Get every IMU sample at the IMU's full output data rate, rather than just the latest.
+ * Pass NULL to stop.
+ */
+void sensors_set_imu_batch_handler(sensors_imu_batch_handler_t handler);
+
+/** @brief Be told of each motion event as it happens. Pass NULL to stop. */
+void sensors_set_motion_handler(sensors_motion_handler_t handler);
+
+/** The sensors' settings, as the configuration commands change them. */
+typedef struct {
+    imu_config_t imu;
+    temp_oversampling_t environment_oversampling;
+    bool adaptive;      // Sampling adaptively (see SENSORS_ADAPTIVE_SAMPLING), which changes the IMU's rate and power mode as it goes
+} sensors_config_t;
+
+/** Bytes of a packed sensors_config_t. */
+#define SENSORS_CONFIG_LEN              7U
+
+/**
+ * @brief Change how the sensors sample, as the configuration commands do. Everything that
+ * depends on the IMU's rate (the FIFO watermark, fusion, PSACP decimation) follows it.
+ * Call on the acquisition core. sensors_cmd() hands the configuration commands to it.
+ */
+void sensors_configure(const sensors_config_t *config);
+
+/** @brief Get the settings in use. */
+void sensors_get_config(sensors_config_t *config);
+
+/**
+ * @brief Pack the settings as they are published, a byte each: IMU ODR, accel range, gyro range,
+ * accel bandwidth, IMU low power (0 or 1), environment oversampling (the enums' values), and
+ * adaptive sampling (0 or 1). While it's on, the IMU's rate and power mode show whether it's idle.
+ *
+ * @param buf At least SENSORS_CONFIG_LEN bytes.
+ * @return size_t SENSORS_CONFIG_LEN.
+ */
+size_t sensors_pack_config(const sensors_config_t *config, uint8_t *buf);
+
+/**
+ * @brief Pack a motion event as it is published, little-endian: count (2 bytes), events (1),
+ * tap (1), wake_up (1), orientation (1), and timestamp_ms (4).
+ *
+ * @param buf At least SENSORS_MOTION_LEN bytes.
+ * @return size_t SENSORS_MOTION_LEN.
+ */
+size_t sensors_pack_motion(const sensors_motion_event_t *event, uint8_t *buf);
+
+/**
+ * @brief Copy out all the latest sensor values at once.
+ * The copy is consistent: every value in it comes from the same read of the sensors.
+ * Safe from either core. Never holds up the acquisition core: it retries if core 1 was writing.
+ */
+void sensors_get_snapshot(sensor_values_t *snapshot);
+
+/**
+ * @brief Execute the given command, on core 0. Reads are answered straight away from the
+ * latest snapshots. Configuration commands are queued for the acquisition core.
+ */
+void sensors_cmd(cmd_t command);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,199 @@
+// Stdlib
+#include <stdint.h>
+// SDK
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/spi.h"
+#include "pico/sync.h"
+// Library
+#include <errors.h>
+#include <sysclock.h>
+// Local
+#include "../board/pinconfig.h"
+#include "spi_interface.h"
+
+/** The DMA IRQ we use for transaction completion. */
+#define SENSORS_SPI_DMA_IRQ DMA_IRQ_0
+
+/** DMA channels for the asynchronous transactions. */
+static int dma_tx_channel = -1;
+static int dma_rx_channel = -1;
+
+/** Clocked out while we read. Never written. */
+static const uint8_t dummy_tx_byte = 0x00;
+
+/** Queued transactions. The one at queue_tail is running if transaction_running. */
+static myspi_transaction_t queue[MYSPI_QUEUE_SIZE];
+static uint queue_head = 0;
+static uint queue_tail = 0;
+static bool transaction_running = false;
+
+/** Guards the queue against the DMA IRQ and callers in other IRQs. */
+static critical_section_t queue_crit;
+
+/** CS pull down with a few no-ops to ensure compatability with the sensor's timing. */
+static inline void cs_select(uint8_t pin) {
+    asm volatile("nop \n nop \n nop");
+    gpio_put(pin, 0);
+    asm volatile("nop \n nop \n nop");
+}
+
+/** CS pull up with a few no-ops to ensure compatability with the sensor's timing. */
+static inline void cs_deselect(uint8_t pin) {
+    asm volatile("nop \n nop \n nop");
+    gpio_put(pin, 1);
+    asm volatile("nop \n nop \n nop");
+}
+
+/**
+ * Start the transaction at the tail of the queue. Call with queue_crit held.
+ * The register byte goes out by hand (it is one byte); the data comes back by DMA.
+ */
+static void start_next_locked(void)
+{
+    if (queue_head == queue_tail)
+    {
+        transaction_running = false;
+        return;
+    }
+    transaction_running = true;
+
+    const myspi_transaction_t *t = &queue[queue_tail];
+    cs_select(t->cs_pin);
+    spi_write_blocking(SENSORS_SPI, &t->reg, 1);
+
+    // RX first, so it is ready for the first byte TX clocks in.
+    dma_channel_transfer_to_buffer_now(dma_rx_channel, t->buf, t->len);
+    dma_channel_transfer_from_buffer_now(dma_tx_channel, &dummy_tx_byte, t->len);
+}
+
+/** DMA IRQ handler: finish the running transaction and start the next. */
+static void spi_dma_irq_handler(void)
+{
+    if (!dma_channel_get_irq0_status(dma_rx_channel))
+    {
+        return;  // Not ours
+    }
+    dma_channel_acknowledge_irq0(dma_rx_channel);
+
+    critical_section_enter_blocking(&queue_crit);
+    myspi_transaction_t done = queue[queue_tail];
+    cs_deselect(done.cs_pin);
+    queue_tail = (queue_tail + 1) % MYSPI_QUEUE_SIZE;
+    start_next_locked();
+    critical_section_exit(&queue_crit);
+
+    if (done.callback != NULL)
+    {
+        done.callback(done.ctx);
+    }
+}
+
+/**
+ * Don't let a blocking transaction and a DMA one share the bus.
+ * Completes finished transactions itself rather than waiting on the DMA IRQ,
+ * so this is safe to call from an IRQ that the DMA IRQ can't preempt.
+ */
+static void wait_for_async(void)
+{
+    while (myspi_busy())
+    {
+        if (!dma_channel_is_busy(dma_rx_channel))
+        {
+            spi_dma_irq_handler();
+        }
+    }
+}
+
+/** Derive the SPI divider for the rate in context from clk_peri, which follows the system clock. */
+static void set_spi_baudrate(uint32_t sys_hz, void *context)
+{
+    spi_set_baudrate(SENSORS_SPI, (uint)(uintptr_t)context);
+}
+
+void myspi_init(uint32_t baudrate)
+{
+    spi_init(SENSORS_SPI, baudrate);
+    sysclock_register(&set_spi_baudrate, (void *)(uintptr_t)baudrate);
+    critical_section_init(&queue_crit);
+
+    dma_tx_channel = dma_claim_unused_channel(true);
+    dma_rx_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(dma_tx_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(SENSORS_SPI, true));
+    dma_channel_configure(dma_tx_channel, &c, &spi_get_hw(SENSORS_SPI)->dr, &dummy_tx_byte, 0, false);
+
+    c = dma_channel_get_default_config(dma_rx_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, spi_get_dreq(SENSORS_SPI, false));
+    dma_channel_configure(dma_rx_channel, &c, NULL, &spi_get_hw(SENSORS_SPI)->dr, 0, false);
+
+    // RX finishes last, so that's when the transaction is done.
+    dma_channel_set_irq0_enabled(dma_rx_channel, true);
+    irq_add_shared_handler(SENSORS_SPI_DMA_IRQ, spi_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(SENSORS_SPI_DMA_IRQ, true);
+}
+
+/** Simple blocking read. Suitable to be run from an interrupt context if necessary. */
+void myspi_blocking_read(uint8_t cs_pin, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    wait_for_async();
+    cs_select(cs_pin);
+    spi_write_blocking(SENSORS_SPI, &reg, 1);
+    // Need about 50 ns of NOPs here
+    // Clock rate is 130 MHz out of the box and we don't change it so need about 3 noops to make sure
+    asm volatile("nop \n nop \n nop");
+    spi_read_blocking(SENSORS_SPI, 0, buf, len);
+    cs_deselect(cs_pin);
+}
+
+/** Simple blocking write. */
+void myspi_blocking_write(uint8_t cs_pin, uint8_t reg, uint8_t byte)
+{
+    uint8_t buf[2] = {reg, byte};
+
+    wait_for_async();
+    cs_select(cs_pin);
+    spi_write_blocking(SENSORS_SPI, buf, 2);
+    cs_deselect(cs_pin);
+}
+
+bool myspi_async_read(const myspi_transaction_t *transaction)
+{
+    if (transaction->len == 0)
+    {
+        return false;
+    }
+
+    critical_section_enter_blocking(&queue_crit);
+    uint next = (queue_head + 1) % MYSPI_QUEUE_SIZE;
+    bool queued = next != queue_tail;
+    if (queued)
+    {
+        queue[queue_head] = *transaction;
+        queue_head = next;
+        if (!transaction_running)
+        {
+            start_next_locked();
+        }
+    }
+    critical_section_exit(&queue_crit);
+
+    if (!queued)
+    {
+        log_warning("SPI transaction queue full.\n");
+    }
+    return queued;
+}
+
+bool myspi_busy(void)
+{
+    return transaction_running;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file This module contains the SPI functions common to all the sensors that use it.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SENSORS_SPI_BAUDRATE
+    /** SPI clock for the sensors, in Hz. Both the BME280 and the LSM6DSO are good to 10 MHz. */
+    #define SENSORS_SPI_BAUDRATE (8 * 1000 * 1000)
+#endif
+
+/** How many asynchronous transactions can be waiting at once. */
+#define MYSPI_QUEUE_SIZE 8
+
+/** Called from the DMA IRQ when an asynchronous transaction is done. */
+typedef void (*myspi_callback_t)(void *ctx);
+
+/** An asynchronous register read. */
+typedef struct {
+    uint8_t cs_pin;             // Chip select for the sensor
+    uint8_t reg;                // First register to read (including any read bit the sensor needs)
+    uint8_t *buf;               // Where to put the bytes. Must stay valid until the callback.
+    uint16_t len;               // How many bytes to read
+    myspi_callback_t callback;  // Called once `buf` is full. May be NULL.
+    void *ctx;                  // Passed to `callback`
+} myspi_transaction_t;
+
+/** Set up the SPI bus and its DMA channels. Call before anything else in this module. */
+void myspi_init(uint32_t baudrate);
+
+/** Simple blocking read. Suitable to be run from an interrupt context if necessary. */
+void myspi_blocking_read(uint8_t cs_pin, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/** Simple blocking write. Suitable to be run from an interrupt context if necessary. */
+void myspi_blocking_write(uint8_t cs_pin, uint8_t reg, uint8_t byte);
+
+/**
+ * @brief Queue a register read to be done by DMA.
+ * Transactions are run in the order they are queued. This does not block;
+ * the transaction (but not `buf`) is copied.
+ *
+ * @return bool False if the queue is full.
+ */
+bool myspi_async_read(const myspi_transaction_t *transaction);
+
+/** Is there an asynchronous transaction running or waiting? */
+bool myspi_busy(void);
+
+#ifdef __cplusplus
+}
+#endif
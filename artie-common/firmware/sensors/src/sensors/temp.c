@@ -1,14 +1,20 @@
 // The compenstation code in this module is taken from the bme280_spi example in the pico examples.
 
 // Stdlib includes
+#include <stdint.h>
 // SDK includes
 #include "pico/stdlib.h"
+// Library includes
+#include <errors.h>
 // Local includes
-#include "../board/errors.h"
 #include "../board/pinconfig.h"
 #include "spi_interface.h"
 #include "temp.h"
 
+/** CTRL_MEAS modes. */
+#define BME280_MODE_SLEEP 0x00
+#define BME280_MODE_NORMAL 0x03
+
 /** Register definitions */
 #define BME280_REG_ID 0xD0
 #define BME280_REG_RESET 0xE0
@@ -56,12 +62,24 @@ static inline void cs_select() {
 /** CS pull up with a few no-ops to ensure compatability with the sensor's timing. */
 static inline void cs_deselect() {
     asm volatile("nop \n nop \n nop");
-    gpio_put(PICO_DEFAULT_SPI_CSN_PIN, 1);
+    gpio_put(SENSORS_SPI_CS_TEMP, 1);
     asm volatile("nop \n nop \n nop");
 }
 
+/** Settings we start with: filtered, and fresh at least twice a second. */
+const temp_config_t TEMP_DEFAULT_CONFIG = {
+    .temperature_oversampling = TEMP_OVERSAMPLING_X2,
+    .pressure_oversampling = TEMP_OVERSAMPLING_X4,
+    .humidity_oversampling = TEMP_OVERSAMPLING_X1,
+    .filter = TEMP_FILTER_COEFF_4,
+    .standby = TEMP_STANDBY_500_MS,
+};
+
+/** The configuration the sensor is sampling with. */
+static temp_config_t current_config = { 0 };
+
 /** Simple blocking read. Suitable to be run from an interrupt context if necessary. */
-static volatile void blocking_read(uint8_t reg, uint8_t *buf, uint16_t len)
+static void blocking_read(uint8_t reg, uint8_t *buf, uint16_t len)
 {
     // BME280 requires the most significant bit to be 1 to signal a read. 0 signals a write.
     reg |= (1 << 7);
@@ -91,58 +109,51 @@ static void reset_sensor(void)
  * Beware that this must be called BEFORE the other compensation functions, as it adjusts the value
  * of t_fine.
  *
- * Returns T in degrees C.
+ * Returns T in hundredths of a degree C (5123 is 51.23 C).
  */
-static float compensate_temp(int32_t adc_T)
+static int32_t compensate_temp(int32_t adc_T)
 {
     int32_t var1;
     int32_t var2;
-    int32_t T;
     var1 = ((((adc_T >> 3) - ((int32_t) compensation_values.dig_T1 << 1))) * ((int32_t) compensation_values.dig_T2)) >> 11;
     var2 = (((((adc_T >> 4) - ((int32_t) compensation_values.dig_T1)) * ((adc_T >> 4) - ((int32_t) compensation_values.dig_T1))) >> 12) * ((int32_t) compensation_values.dig_T3))
             >> 14;
 
     compensation_values.t_fine = var1 + var2;
-    T = (compensation_values.t_fine * 5 + 128) >> 8;
-
-    // Convert to degrees C
-    T = T / 100.0f;
-
-    return T;
+    return (compensation_values.t_fine * 5 + 128) >> 8;
 }
 
-/** Adjust the raw ADC value for pressure into usable pressure value based on calibration values. Returns Pa. */
-static float compensate_pressure(int32_t adc_P)
+/**
+ * Adjust the raw ADC value for pressure into usable pressure value based on calibration values.
+ * Returns Pa as Q24.8 (24674867 is 24674867 / 256 = 96386.2 Pa). This is the datasheet's 64-bit version.
+ */
+static uint32_t compensate_pressure(int32_t adc_P)
 {
-    int32_t var1;
-    int32_t var2;
-    uint32_t p;
-    var1 = (((int32_t) compensation_values.t_fine) >> 1) - (int32_t) 64000;
-    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t) compensation_values.dig_P6);
-    var2 = var2 + ((var1 * ((int32_t) compensation_values.dig_P5)) << 1);
-    var2 = (var2 >> 2) + (((int32_t) compensation_values.dig_P4) << 16);
-    var1 = (((compensation_values.dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t) compensation_values.dig_P2) * var1) >> 1)) >> 18;
-    var1 = ((((32768 + var1)) * ((int32_t) compensation_values.dig_P1)) >> 15);
+    int64_t var1;
+    int64_t var2;
+    int64_t p;
+    var1 = ((int64_t) compensation_values.t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t) compensation_values.dig_P6;
+    var2 = var2 + ((var1 * (int64_t) compensation_values.dig_P5) << 17);
+    var2 = var2 + (((int64_t) compensation_values.dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t) compensation_values.dig_P3) >> 8) + ((var1 * (int64_t) compensation_values.dig_P2) << 12);
+    var1 = (((((int64_t) 1) << 47) + var1)) * ((int64_t) compensation_values.dig_P1) >> 33;
     if (var1 == 0)
-        return 0;
-
-    p = (((uint32_t) (((int32_t) 1048576) - adc_P) - (var2 >> 12))) * 3125;
-    if (p < 0x80000000)
-        p = (p << 1) / ((uint32_t) var1);
-    else
-        p = (p / (uint32_t) var1) * 2;
-
-    var1 = (((int32_t) compensation_values.dig_P9) * ((int32_t) (((p >> 3) * (p >> 3)) >> 13))) >> 12;
-    var2 = (((int32_t) (p >> 2)) * ((int32_t) compensation_values.dig_P8)) >> 13;
-    p = (uint32_t) ((int32_t) p + ((var1 + var2 + compensation_values.dig_P7) >> 4));
+        return 0;  // Avoid dividing by zero
 
-    // Convert to Pa
-    p = p / 256.0f;
+    p = 1048576 - adc_P;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t) compensation_values.dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t) compensation_values.dig_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t) compensation_values.dig_P7) << 4);
 
-    return p;
+    return (uint32_t) p;
 }
 
-/** Adjust the raw ADC value for humidity into usable humidity value based on calibration values. Return %RH. */
+/**
+ * Adjust the raw ADC value for humidity into usable humidity value based on calibration values.
+ * Returns %RH as Q22.10 (47445 is 47445 / 1024 = 46.333 %RH).
+ */
 static uint32_t compensate_humidity(int32_t adc_H)
 {
     int32_t v_x1_u32r;
@@ -154,11 +165,7 @@ static uint32_t compensate_humidity(int32_t adc_H)
     v_x1_u32r = (v_x1_u32r < 0 ? 0 : v_x1_u32r);
     v_x1_u32r = (v_x1_u32r > 419430400 ? 419430400 : v_x1_u32r);
 
-    // Convert to % relative humidity
-    float humidity = (uint32_t)(v_x1_u32r >> 12);
-    humidity = humidity / 1024.0f;
-
-    return humidity;
+    return (uint32_t)(v_x1_u32r >> 12);
 }
 
 /** This function reads the manufacturing assigned compensation parameters from the device */
@@ -166,7 +173,8 @@ static void read_compensation_parameters()
 {
     uint8_t buffer[26];
 
-    blocking_read(0x88, buffer, 24);
+    // 0x88 to 0x9F, then one reserved register, then dig_H1 at 0xA1
+    blocking_read(0x88, buffer, 26);
 
     compensation_values.dig_T1 = buffer[0] | (buffer[1] << 8);
     compensation_values.dig_T2 = buffer[2] | (buffer[3] << 8);
@@ -184,13 +192,14 @@ static void read_compensation_parameters()
 
     compensation_values.dig_H1 = buffer[25];
 
-    blocking_read(0xE1, buffer, 8);
+    // 0xE1 to 0xE7. dig_H4 and dig_H5 share 0xE5: H4 has its low nibble, H5 its high one.
+    blocking_read(0xE1, buffer, 7);
 
     compensation_values.dig_H2 = buffer[0] | (buffer[1] << 8);
     compensation_values.dig_H3 = (int8_t) buffer[2];
     compensation_values.dig_H4 = buffer[3] << 4 | (buffer[4] & 0xf);
-    compensation_values.dig_H5 = (buffer[5] >> 4) | (buffer[6] << 4);
-    compensation_values.dig_H6 = (int8_t) buffer[7];
+    compensation_values.dig_H5 = (buffer[4] >> 4) | (buffer[5] << 4);
+    compensation_values.dig_H6 = (int8_t) buffer[6];
 }
 
 void temp_init(void)
@@ -208,35 +217,101 @@ void temp_init(void)
         log_error("BME280 temperature sensor reads id 0x%x, but should be 0x60.\n");
     }
 
-    // Reset the sensor
+    // Reset the sensor. It needs 2 ms to come back up.
     reset_sensor();
-
-    // Oversampling settings: 1x 1x 1x (pressure, temp, humidity)
-    blocking_write(BME280_REG_CTRL_HUM, 0x01);
-
-    // Set IIR Filter to OFF
-    blocking_write(BME280_REG_CONFIG, 0x00);  // bxxx0 0000 -> (don't care about t_standby) (no IIR) (SPI 4 wire mode)
+    sleep_ms(2);
 
     // Read compensation values
     read_compensation_parameters();
 
-    // Set mode to Forced (sleep mode is default after power on)
-    // Forced mode means the sensor will sleep unless we specifically request a measurement.
-    // Also set the rest of the oversampling settings
-    blocking_write(BME280_REG_CTRL_MEAS, 0x25);  // b0010 0100 -> x1 x1 forced mode
+    // Start converting
+    temp_configure(&TEMP_DEFAULT_CONFIG);
 }
 
-void temp_read(temp_sensor_values_t *values)
+void temp_configure(const temp_config_t *config)
+{
+    current_config = *config;
+
+    // CONFIG writes may be ignored in normal mode, so go to sleep mode first.
+    blocking_write(BME280_REG_CTRL_MEAS, BME280_MODE_SLEEP);
+
+    // Humidity oversampling only takes effect on the next CTRL_MEAS write.
+    blocking_write(BME280_REG_CTRL_HUM, config->humidity_oversampling & 0x07);
+
+    // bsss fff0 -> (t_standby) (IIR filter) (SPI 4 wire mode)
+    blocking_write(BME280_REG_CONFIG, ((config->standby & 0x07) << 5) | ((config->filter & 0x07) << 2));
+
+    // Set mode to Normal: the sensor converts, waits t_standby, and converts again on its own,
+    // so whenever we read it we get the latest (filtered) result without triggering anything.
+    // bttt pppm -> (temperature oversampling) (pressure oversampling) (mode)
+    blocking_write(BME280_REG_CTRL_MEAS, ((config->temperature_oversampling & 0x07) << 5) | ((config->pressure_oversampling & 0x07) << 2) | BME280_MODE_NORMAL);
+}
+
+void temp_get_config(temp_config_t *config)
+{
+    *config = current_config;
+}
+
+/** Turn the eight data bytes (starting at BME280_REG_PRESS) into compensated values. */
+static void decode_values(const uint8_t *buffer, temp_sensor_values_t *values)
 {
-    // Non-blocking read of all values
-    static uint8_t buffer[8];
-    blocking_read(BME280_REG_PRESS, buffer, 8);
     int32_t adc_pressure = ((uint32_t) buffer[0] << 12) | ((uint32_t) buffer[1] << 4) | (buffer[2] >> 4);
     int32_t adc_temp = ((uint32_t) buffer[3] << 12) | ((uint32_t) buffer[4] << 4) | (buffer[5] >> 4);
     int32_t adc_humidity = (uint32_t) buffer[6] << 8 | buffer[7];
 
     // Compensate using calibrated parameters
-    values->temperature_c = compensate_temp(adc_temp);
-    values->pressure_pa = compensate_pressure(adc_pressure);
-    values->humidity_percent_rh =compensate_humidity(adc_humidity);
+    values->temperature_centi_c = compensate_temp(adc_temp);
+    values->pressure_pa_q24_8 = compensate_pressure(adc_pressure);
+    values->humidity_percent_rh_q22_10 = compensate_humidity(adc_humidity);
+}
+
+void temp_read(temp_sensor_values_t *values)
+{
+    static uint8_t buffer[8];
+    blocking_read(BME280_REG_PRESS, buffer, 8);
+    decode_values(buffer, values);
+}
+
+/** State for an asynchronous read. */
+static struct {
+    volatile bool busy;
+    temp_sensor_values_t *values;
+    temp_read_done_t done;
+    // The pressure through the last humidity register, in one burst
+    uint8_t buffer[8];
+} async_read = { 0 };
+
+/** SPI callback: the status and data registers have arrived. */
+static void async_read_cb(void *unused)
+{
+    async_read.busy = false;
+    decode_values(async_read.buffer, async_read.values);
+    async_read.done(async_read.values);
+}
+
+bool temp_read_async(temp_sensor_values_t *values, temp_read_done_t done)
+{
+    if (async_read.busy)
+    {
+        return false;
+    }
+
+    async_read.busy = true;
+    async_read.values = values;
+    async_read.done = done;
+
+    myspi_transaction_t t = {
+        .cs_pin = SENSORS_SPI_CS_TEMP,
+        .reg = BME280_REG_PRESS | (1 << 7),
+        .buf = async_read.buffer,
+        .len = sizeof(async_read.buffer),
+        .callback = async_read_cb,
+        .ctx = NULL,
+    };
+    if (!myspi_async_read(&t))
+    {
+        async_read.busy = false;
+        return false;
+    }
+    return true;
 }
@@ -0,0 +1,100 @@
+/**
+ * @file temp.h
+ * @brief Temperature sensor module.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Temperature, pressure, humidity values, in the BME280's own fixed-point formats.
+ * We never do float math on the MCU (it has no FPU); the controller converts these.
+ */
+typedef struct {
+    uint32_t pressure_pa_q24_8;             // Pa, 8 fractional bits: divide by 256
+    int32_t temperature_centi_c;            // Hundredths of a degree C: divide by 100
+    uint32_t humidity_percent_rh_q22_10;    // %RH, 10 fractional bits: divide by 1024
+} temp_sensor_values_t;
+
+/** Oversampling for each of the measurements. More is less noisy but takes longer. */
+typedef enum {
+    TEMP_OVERSAMPLING_SKIP  = 0,    // Don't measure this at all
+    TEMP_OVERSAMPLING_X1    = 1,
+    TEMP_OVERSAMPLING_X2    = 2,
+    TEMP_OVERSAMPLING_X4    = 3,
+    TEMP_OVERSAMPLING_X8    = 4,
+    TEMP_OVERSAMPLING_X16   = 5,
+} temp_oversampling_t;
+
+/** IIR filter coefficient for temperature and pressure. Higher is smoother but slower to respond. */
+typedef enum {
+    TEMP_FILTER_OFF         = 0,
+    TEMP_FILTER_COEFF_2     = 1,
+    TEMP_FILTER_COEFF_4     = 2,
+    TEMP_FILTER_COEFF_8     = 3,
+    TEMP_FILTER_COEFF_16    = 4,
+} temp_filter_t;
+
+/** Time the sensor waits between conversions. */
+typedef enum {
+    TEMP_STANDBY_0_5_MS     = 0,
+    TEMP_STANDBY_62_5_MS    = 1,
+    TEMP_STANDBY_125_MS     = 2,
+    TEMP_STANDBY_250_MS     = 3,
+    TEMP_STANDBY_500_MS     = 4,
+    TEMP_STANDBY_1000_MS    = 5,
+    TEMP_STANDBY_10_MS      = 6,
+    TEMP_STANDBY_20_MS      = 7,
+} temp_standby_t;
+
+/** How the sensor samples. */
+typedef struct {
+    temp_oversampling_t temperature_oversampling;
+    temp_oversampling_t pressure_oversampling;
+    temp_oversampling_t humidity_oversampling;
+    temp_filter_t filter;
+    temp_standby_t standby;
+} temp_config_t;
+
+/** The configuration temp_init() uses. */
+extern const temp_config_t TEMP_DEFAULT_CONFIG;
+
+/**
+ * @brief Initialize temperature module.
+ * Puts the sensor into normal mode with TEMP_DEFAULT_CONFIG, so it converts continuously.
+ */
+void temp_init(void);
+
+/**
+ * @brief Change how the sensor samples. It keeps converting continuously (normal mode).
+ */
+void temp_configure(const temp_config_t *config);
+
+/** @brief Get the configuration the sensor is sampling with. */
+void temp_get_config(temp_config_t *config);
+
+/**
+ * @brief Read the given values from the sensor.
+ */
+void temp_read(temp_sensor_values_t *values);
+
+/** Called when an asynchronous read has produced new values. Runs in the SPI DMA IRQ. */
+typedef void (*temp_read_done_t)(temp_sensor_values_t *values);
+
+/**
+ * @brief Like temp_read(), but done by DMA without blocking.
+ * The sensor's data registers are shadowed, so the values always come from one complete conversion.
+ * `values` must stay valid until `done` is called.
+ *
+ * @return bool False if a read is already running or the SPI queue is full.
+ */
+bool temp_read_async(temp_sensor_values_t *values, temp_read_done_t done);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+# Link a firmware to run from bank A under the CAN bootloader (see README.md), instead of from the start of flash.
+# The layout must match bank.h.
+set(ARTIE_BOOTLOADER_BANK_A_ORIGIN 0x10010000)
+set(ARTIE_BOOTLOADER_BANK_SIZE 960k)
+
+function(artie_bootloader_app TARGET)
+  # The SDK's default linker script, with flash starting at bank A
+  set(MEMMAP_DEFAULT ${PICO_SDK_PATH}/src/rp2_common/pico_standard_link/memmap_default.ld)
+  file(READ ${MEMMAP_DEFAULT} MEMMAP)
+  string(REGEX REPLACE
+    "FLASH\\(rx\\) : ORIGIN = 0x10000000, LENGTH = [0-9]+k"
+    "FLASH(rx) : ORIGIN = ${ARTIE_BOOTLOADER_BANK_A_ORIGIN}, LENGTH = ${ARTIE_BOOTLOADER_BANK_SIZE}"
+    MEMMAP_APP "${MEMMAP}")
+  if (MEMMAP_APP STREQUAL MEMMAP)
+    message(FATAL_ERROR "Could not find the flash region in ${MEMMAP_DEFAULT}")
+  endif()
+
+  set(MEMMAP_PATH ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}_bootloader_app.ld)
+  file(WRITE ${MEMMAP_PATH} "${MEMMAP_APP}")
+  pico_set_linker_script(${TARGET} ${MEMMAP_PATH})
+endfunction()
@@ -0,0 +1,188 @@
+// Stdlib includes
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+// SDK includes
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/regs/m0plus.h"
+#include "hardware/structs/scb.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <bytestuff.h>
+// Local includes
+#include "bank.h"
+
+/**
+ * The application's vector table comes after its own boot2 (256 bytes), which is never run:
+ * the bootloader's boot2 stands in for it.
+ */
+#define APP_VECTORS_OFFSET 0x100
+
+/**
+ * A sector's worth of RAM, to program flash from. The whole bootloader runs from RAM
+ * (it's a copy_to_ram binary), so nothing stops while flash is busy, and the CAN interrupt
+ * keeps taking blocks while earlier ones are written.
+ */
+static uint8_t sector_buffer[FLASH_SECTOR_SIZE];
+
+/** Flash at `offset`, read through XIP. */
+static inline const uint8_t *flash_at(uint32_t offset)
+{
+    return (const uint8_t *)(uintptr_t)(XIP_BASE + offset);
+}
+
+uint32_t bank_crc(uint32_t offset, size_t len)
+{
+    return crc24_update_bytes(CRC24_INIT, flash_at(offset), len);
+}
+
+static uint32_t record_crc(const boot_record_t *record)
+{
+    return crc24_update_bytes(CRC24_INIT, (const uint8_t *)record, offsetof(boot_record_t, record_crc));
+}
+
+/** The record in one of the two boot record sectors, if it's intact. */
+static const boot_record_t *record_in(int sector)
+{
+    const boot_record_t *record = (const boot_record_t *)flash_at(BOOT_RECORD_OFFSET + (sector * FLASH_SECTOR_SIZE));
+    if ((record->magic != BOOT_RECORD_MAGIC) || (record->record_crc != record_crc(record)))
+    {
+        return NULL;
+    }
+    return record;
+}
+
+/** Which of the two boot record sectors holds the newest record, or -1 if neither does. */
+static int newest_record_sector(void)
+{
+    const boot_record_t *first = record_in(0);
+    const boot_record_t *second = record_in(1);
+    if (second == NULL)
+    {
+        return (first == NULL) ? -1 : 0;
+    }
+    if (first == NULL)
+    {
+        return 1;
+    }
+    return ((int32_t)(second->sequence - first->sequence) > 0) ? 1 : 0;
+}
+
+/** Erase a sector and program the first `len` bytes of sector_buffer into it. Returns true if it reads back right. */
+static bool program_sector(uint32_t offset, size_t len)
+{
+    // Whole pages only. Erased flash is 0xFF, so padding with it leaves the rest as it was.
+    const size_t program_len = (len + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    memset(&sector_buffer[len], 0xFF, program_len - len);
+
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    flash_range_program(offset, sector_buffer, program_len);
+    return memcmp(flash_at(offset), sector_buffer, len) == 0;
+}
+
+bool bank_read_record(boot_record_t *record)
+{
+    const int sector = newest_record_sector();
+    if (sector < 0)
+    {
+        return false;
+    }
+
+    *record = *record_in(sector);
+    return true;
+}
+
+bool bank_write_record(boot_state_t state, uint32_t image_len, uint32_t image_crc)
+{
+    const int newest = newest_record_sector();
+    boot_record_t record = {
+        .magic = BOOT_RECORD_MAGIC,
+        .sequence = (newest < 0) ? 0 : (record_in(newest)->sequence + 1),
+        .state = state,
+        .image_len = image_len,
+        .image_crc = image_crc,
+    };
+    record.record_crc = record_crc(&record);
+
+    // Over the older one, so the newest one is still there if this is cut short
+    const int sector = (newest == 0) ? 1 : 0;
+    memcpy(sector_buffer, &record, sizeof(record));
+    return program_sector(BOOT_RECORD_OFFSET + (sector * FLASH_SECTOR_SIZE), sizeof(record));
+}
+
+bool bank_write_block(uint32_t image_offset, const uint8_t *data, size_t len)
+{
+    if (((image_offset % FLASH_SECTOR_SIZE) != 0) || (len == 0) || (len > FLASH_SECTOR_SIZE) || (image_offset > (BANK_SIZE - len)))
+    {
+        return false;
+    }
+
+    const uint32_t offset = BANK_B_OFFSET + image_offset;
+    if (memcmp(flash_at(offset), data, len) == 0)
+    {
+        // Already there, from a transfer that started over
+        return true;
+    }
+
+    memcpy(sector_buffer, data, len);
+    return program_sector(offset, len);
+}
+
+bool bank_install(const boot_record_t *staged)
+{
+    for (uint32_t pos = 0; pos < staged->image_len; pos += FLASH_SECTOR_SIZE)
+    {
+        const size_t len = MIN(FLASH_SECTOR_SIZE, staged->image_len - pos);
+        if (memcmp(flash_at(BANK_A_OFFSET + pos), flash_at(BANK_B_OFFSET + pos), len) == 0)
+        {
+            // Already copied, before a power cut
+            continue;
+        }
+
+        // Through RAM: flash can't be read while it's being programmed
+        memcpy(sector_buffer, flash_at(BANK_B_OFFSET + pos), len);
+        if (!program_sector(BANK_A_OFFSET + pos, len))
+        {
+            return false;
+        }
+    }
+
+    if (bank_crc(BANK_A_OFFSET, staged->image_len) != staged->image_crc)
+    {
+        return false;
+    }
+    return bank_write_record(BOOT_STATE_RUNNING, staged->image_len, staged->image_crc);
+}
+
+bool bank_app_is_valid(void)
+{
+    // The initial stack pointer must be in RAM, and the reset handler in bank A
+    const uint32_t *vectors = (const uint32_t *)flash_at(BANK_A_OFFSET + APP_VECTORS_OFFSET);
+    const uint32_t stack = vectors[0];
+    const uint32_t reset = vectors[1];
+    return (stack > SRAM_BASE) && (stack <= SRAM_END) &&
+           (reset >= (XIP_BASE + BANK_A_OFFSET + APP_VECTORS_OFFSET)) && (reset < (XIP_BASE + BANK_A_OFFSET + BANK_SIZE));
+}
+
+void bank_boot_app(void)
+{
+    const uint32_t *vectors = (const uint32_t *)flash_at(BANK_A_OFFSET + APP_VECTORS_OFFSET);
+
+    // Nothing of ours may fire once the application has its own vector table. Its runtime
+    // resets the peripherals, but it expects interrupts on (PRIMASK clear), as from a reset.
+    __asm volatile ("cpsid i");
+    irq_set_mask_enabled(0xFFFFFFFF, false);
+    *((io_rw_32 *)(PPB_BASE + M0PLUS_NVIC_ICPR_OFFSET)) = 0xFFFFFFFF;
+    scb_hw->vtor = (uintptr_t)vectors;
+    __asm volatile ("cpsie i");
+
+    __asm volatile (
+        "msr msp, %0\n"
+        "bx %1\n"
+        :
+        : "r" (vectors[0]), "r" (vectors[1])
+    );
+    __builtin_unreachable();
+}
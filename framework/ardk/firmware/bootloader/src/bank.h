@@ -0,0 +1,98 @@
+/**
+ * @file bank.h
+ * @brief The flash layout, and the boot record that says what's in it.
+ *
+ * The application always runs from bank A. New images are written to bank B while
+ * bank A keeps running, and only once bank B holds a whole image with the right CRC24
+ * is it committed, with one boot record write. The next boot copies it over bank A.
+ * The boot record is written to two sectors in turn, so a power cut while writing one
+ * leaves the other, and a power cut while copying leaves bank B and the record as they
+ * were, so the copy just runs again.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/flash.h"
+
+/** Flash reserved for the bootloader (boot2 included). Bank A starts right after. Must match app.cmake. */
+#define BOOTLOADER_FLASH_SIZE   (64 * 1024)
+
+/** Size of each bank. Must match app.cmake. */
+#define BANK_SIZE               (960 * 1024)
+
+/** Flash offsets of the banks and of the two boot record sectors. */
+#define BANK_A_OFFSET           BOOTLOADER_FLASH_SIZE
+#define BANK_B_OFFSET           (BANK_A_OFFSET + BANK_SIZE)
+#define BOOT_RECORD_OFFSET      (BANK_B_OFFSET + BANK_SIZE)
+
+#if (BOOT_RECORD_OFFSET + (2 * FLASH_SECTOR_SIZE)) > PICO_FLASH_SIZE_BYTES
+    #error "The banks and boot records don't fit in flash"
+#endif
+
+/** What the boot record says about the banks. */
+typedef enum {
+    BOOT_STATE_RUNNING = 1,     ///< Bank A holds the image (image_len, image_crc)
+    BOOT_STATE_STAGED = 2,      ///< Bank B holds a verified image (image_len, image_crc) to copy over bank A
+} boot_state_t;
+
+/** The boot record. */
+typedef struct {
+    uint32_t magic;             ///< BOOT_RECORD_MAGIC
+    uint32_t sequence;          ///< Higher is newer
+    uint32_t state;             ///< boot_state_t
+    uint32_t image_len;         ///< Bytes of image
+    uint32_t image_crc;         ///< CRC24 of them
+    uint32_t record_crc;        ///< CRC24 of the fields above
+} boot_record_t;
+
+/** Identifies a boot record. */
+#define BOOT_RECORD_MAGIC       0x41425254  // "TRBA"
+
+/**
+ * @brief Get the newest intact boot record.
+ *
+ * @return false if there isn't one (a board that was flashed over USB or SWD).
+ */
+bool bank_read_record(boot_record_t *record);
+
+/** Write a newer boot record over the older of the two. */
+bool bank_write_record(boot_state_t state, uint32_t image_len, uint32_t image_crc);
+
+/** CRC24 of `len` bytes of flash from `offset`. */
+uint32_t bank_crc(uint32_t offset, size_t len);
+
+/**
+ * @brief Write up to a sector of image into bank B. Sectors that already hold
+ * exactly these bytes aren't touched, so a transfer that starts over only costs
+ * the time on the bus for what it already sent.
+ *
+ * @param image_offset Sector-aligned offset into the image.
+ * @return false if it's out of range or misaligned, or didn't read back right.
+ */
+bool bank_write_block(uint32_t image_offset, const uint8_t *data, size_t len);
+
+/**
+ * @brief Copy the image staged in bank B over bank A and record that bank A holds it.
+ *
+ * @return false if bank A didn't read back right. Bank B and the record are untouched, so try again.
+ */
+bool bank_install(const boot_record_t *staged);
+
+/**
+ * @brief Does bank A look like it holds an application? Boots don't check its CRC24:
+ * it's only ever written by bank_install(), which checks it, or over USB or SWD.
+ */
+bool bank_app_is_valid(void);
+
+/** Start the application in bank A, with every interrupt of ours disabled. */
+void bank_boot_app(void) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Pin configuration for the bootloader. The defaults match the eyebrows and mouth boards.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pico/stdlib.h>
+
+/** CAN controller (MCP2515) pins on spi0 */
+static const uint CAN_SCK_PIN = 2;
+static const uint CAN_MOSI_PIN = 3;
+static const uint CAN_MISO_PIN = 4;
+static const uint CAN_CS_PIN = 5;
+
+/** The CAN controller's (active-low) interrupt output */
+static const uint CAN_INT_PIN = 14;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,186 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/watchdog.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <bwacp.h>
+#include <errors.h>
+#include <rtacp.h>
+// Local includes
+#include "bank.h"
+#include "board/pinconfig.h"
+
+#ifndef BOOTLOADER_CAN_ADDRESS
+    /** This node's CAN address. Images are usually multicast, so it's mostly for telling REPEATs apart. */
+    #define BOOTLOADER_CAN_ADDRESS 0x3E
+#endif // BOOTLOADER_CAN_ADDRESS
+
+#ifndef BOOTLOADER_CAN_CLASSES
+    /** The BWACP classes this node takes multicasts for. */
+    #define BOOTLOADER_CAN_CLASSES BWACP_CLASS_MCU
+#endif // BOOTLOADER_CAN_CLASSES
+
+#ifndef BOOTLOADER_CAN_BITRATE
+    /** CAN bus rate in bit/s. */
+    #define BOOTLOADER_CAN_BITRATE 500000
+#endif // BOOTLOADER_CAN_BITRATE
+
+#ifndef BOOTLOADER_CAN_OSC_HZ
+    /** The CAN controller's crystal frequency in Hz. */
+    #define BOOTLOADER_CAN_OSC_HZ 16000000
+#endif // BOOTLOADER_CAN_OSC_HZ
+
+#ifndef BOOTLOADER_CAN_SPI_BAUDRATE
+    /** SPI clock to the CAN controller in Hz. */
+    #define BOOTLOADER_CAN_SPI_BAUDRATE (8 * 1000 * 1000)
+#endif // BOOTLOADER_CAN_SPI_BAUDRATE
+
+#ifndef BOOTLOADER_LISTEN_MS
+    /** How long to wait for an update after a reset before starting the application. */
+    #define BOOTLOADER_LISTEN_MS 500
+#endif // BOOTLOADER_LISTEN_MS
+
+#ifndef BOOTLOADER_IDLE_TIMEOUT_MS
+    /** How long an update can go without a block before we give up on it and start the application. */
+    #define BOOTLOADER_IDLE_TIMEOUT_MS 5000
+#endif // BOOTLOADER_IDLE_TIMEOUT_MS
+
+/**
+ * Block address of the commit, sent once every block of the image has: the image's length (4 bytes)
+ * and CRC24 (3 bytes), little-endian. Addresses below BANK_SIZE are offsets into the image.
+ */
+#define COMMIT_ADDRESS 0xFFFFFFFF
+#define COMMIT_LEN 7
+
+/** Check the image in bank B against a commit block, and if it matches, stage it and restart to install it. */
+static void commit(const bwacp_block_t *block)
+{
+    const uint32_t image_len = (uint32_t)block->data[0] | ((uint32_t)block->data[1] << 8) |
+                               ((uint32_t)block->data[2] << 16) | ((uint32_t)block->data[3] << 24);
+    const uint32_t image_crc = (uint32_t)block->data[4] | ((uint32_t)block->data[5] << 8) | ((uint32_t)block->data[6] << 16);
+    if ((image_len == 0) || (image_len > BANK_SIZE) || (bank_crc(BANK_B_OFFSET, image_len) != image_crc))
+    {
+        // A block went missing (or its flash didn't take). Everything that made it stays in
+        // bank B, so sending the image again only rewrites what differs.
+        log_error("Image of %lu bytes doesn't match its CRC24\n", (unsigned long)image_len);
+        bwacp_request_repeat(block->writer, block->priority);
+        return;
+    }
+
+    if (!bank_write_record(BOOT_STATE_STAGED, image_len, image_crc))
+    {
+        log_error("Could not write the boot record\n");
+        bwacp_request_repeat(block->writer, block->priority);
+        return;
+    }
+
+    log_info("Image of %lu bytes staged. Restarting to install it.\n", (unsigned long)image_len);
+    watchdog_reboot(0, 0, 0);
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
+
+/** Deal with a block of an update. */
+static void handle_block(const bwacp_block_t *block)
+{
+    if (block->address == COMMIT_ADDRESS)
+    {
+        if (block->len == COMMIT_LEN)
+        {
+            commit(block);
+        }
+        else
+        {
+            log_error("Commit block of %u bytes\n", (uint)block->len);
+        }
+    }
+    else if (!bank_write_block(block->address, block->data, block->len))
+    {
+        // Out of range, misaligned, or didn't read back right. Only the last is worth another try,
+        // but the writer can't tell them apart either way.
+        log_error("Could not write %u bytes at 0x%08lX\n", (uint)block->len, (unsigned long)block->address);
+        bwacp_request_repeat(block->writer, block->priority);
+    }
+}
+
+/** Start the CAN controller and BWACP. */
+static bool start_can(void)
+{
+    const mcp2515_config_t can = {
+        .spi = spi0,
+        .sck_pin = CAN_SCK_PIN,
+        .mosi_pin = CAN_MOSI_PIN,
+        .miso_pin = CAN_MISO_PIN,
+        .cs_pin = CAN_CS_PIN,
+        .int_pin = CAN_INT_PIN,
+        .spi_baudrate = BOOTLOADER_CAN_SPI_BAUDRATE,
+        .osc_hz = BOOTLOADER_CAN_OSC_HZ,
+        .bitrate = BOOTLOADER_CAN_BITRATE,
+    };
+
+    // We take no RTACP messages, only BWACP blocks
+    return rtacp_init(BOOTLOADER_CAN_ADDRESS, &can, NULL) && bwacp_init(BOOTLOADER_CAN_CLASSES);
+}
+
+int main()
+{
+    // No stdio: USB would be left running under the application
+
+    // A committed image that hasn't been installed yet (or was cut short by a power cut) goes in first
+    boot_record_t record;
+    if (bank_read_record(&record) && (record.state == BOOT_STATE_STAGED))
+    {
+        if (!bank_install(&record))
+        {
+            log_error("Could not install the staged image\n");
+        }
+    }
+
+    const bool app_valid = bank_app_is_valid();
+    if (!start_can())
+    {
+        // Nothing to take an update from, so the application is all there is
+        log_error("CAN controller did not start\n");
+        if (app_valid)
+        {
+            bank_boot_app();
+        }
+    }
+
+    // Wait a moment for an update. Once one starts, stay until it's committed, or abandoned.
+    bool updating = false;
+    absolute_time_t deadline = make_timeout_time_ms(BOOTLOADER_LISTEN_MS);
+    while (true)
+    {
+        const bwacp_block_t *block = bwacp_get_block();
+        if ((block != NULL) || (!updating && bwacp_is_receiving()))
+        {
+            if (!updating)
+            {
+                log_info("Update started\n");
+                updating = true;
+            }
+            deadline = make_timeout_time_ms(BOOTLOADER_IDLE_TIMEOUT_MS);
+        }
+
+        if (block != NULL)
+        {
+            handle_block(block);
+            bwacp_release_block(block);
+            continue;
+        }
+
+        if (time_reached(deadline) && app_valid)
+        {
+            // Bank A is untouched by an abandoned update
+            bank_boot_app();
+        }
+
+        // Until a block arrives, or it's time to give up
+        best_effort_wfe_or_timeout(deadline);
+    }
+}
@@ -0,0 +1,123 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#if PICO_ON_DEVICE
+    #include <malloc.h>
+#endif // PICO_ON_DEVICE
+// SDK includes
+#include "hardware/sync.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "arena.h"
+
+/**
+ * Guards the arenas and their list against the other core. A striped lock, like the errors
+ * library's, since it needs neither claiming nor initializing and is only held for a few lines.
+ */
+#define ARENA_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST + 1)
+
+/** Bytes arena_pack() writes for each arena. */
+#define PACKED_ARENA_LEN 12
+
+/** The arenas that have been taken from, oldest first. */
+static arena_t *arenas = NULL;
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    const uint32_t saved = spin_lock_blocking(ARENA_LOCK);
+    if (!arena->listed)
+    {
+        arena_t **tail = &arenas;
+        while (*tail != NULL)
+        {
+            tail = &(*tail)->next;
+        }
+        *tail = arena;
+        arena->listed = true;
+    }
+
+    void *taken = NULL;
+    const bool sealed = arena->sealed;
+    const size_t cost = ARENA_ROUND_UP(size);
+    if (!sealed && (cost >= size) && (cost <= (arena->size - arena->used)))
+    {
+        taken = arena->base + arena->used;
+        arena->used += cost;
+    }
+    spin_unlock(ARENA_LOCK, saved);
+
+    if (sealed)
+    {
+        log_error("Arena %s is sealed; it can only be taken from at init.\n", arena->name);
+        set_errno(ERR_ID_ARENA_MODULE, EPERM);
+    }
+    else if (taken == NULL)
+    {
+        log_error("Arena %s has %u bytes left; %u were asked for.\n", arena->name,
+                  (unsigned)(arena->size - arena->used), (unsigned)size);
+        set_errno(ERR_ID_ARENA_MODULE, ENOMEM);
+    }
+    return taken;
+}
+
+void arena_seal(arena_t *arena)
+{
+    const uint32_t saved = spin_lock_blocking(ARENA_LOCK);
+    arena->sealed = true;
+    spin_unlock(ARENA_LOCK, saved);
+
+    log_info("Arena %s: %u of %u bytes used\n", arena->name, (unsigned)arena->used, (unsigned)arena->size);
+}
+
+/** Bytes of heap malloc() hasn't handed out: what it never took from the system, plus what's been freed. */
+static uint32_t heap_free(void)
+{
+#if PICO_ON_DEVICE
+    // The SDK's linker script puts the heap between the end of .bss and the bottom of the stack
+    extern char __end__, __StackLimit;
+    const struct mallinfo info = mallinfo();
+    const size_t total = (size_t)(&__StackLimit - &__end__);
+    return (uint32_t)((total - info.arena) + info.fordblks);
+#else
+    return 0;
+#endif // PICO_ON_DEVICE
+}
+
+static void pack_u32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    buf[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+size_t arena_pack(uint8_t *buf, size_t len)
+{
+    if (len < 5)
+    {
+        return 0;
+    }
+    pack_u32(&buf[1], heap_free());
+
+    // Arenas are only ever added to the end of the list, so it can be walked without the lock
+    uint8_t count = 0;
+    size_t written = 5;
+    for (const arena_t *arena = arenas; (arena != NULL) && ((len - written) >= PACKED_ARENA_LEN); arena = arena->next)
+    {
+        uint8_t *out = &buf[written];
+        memset(out, 0, 4);
+        for (size_t i = 0; (i < 4) && (arena->name[i] != '\0'); i++)
+        {
+            out[i] = (uint8_t)arena->name[i];
+        }
+        out[0] |= arena->sealed ? 0x80 : 0x00;
+        pack_u32(&out[4], (uint32_t)arena->size);
+        pack_u32(&out[8], (uint32_t)arena->used);
+        written += PACKED_ARENA_LEN;
+        count++;
+    }
+    buf[0] = count;
+    return written;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file arena.h
+ * @brief Static arenas.
+ * A named, fixed block of RAM that a module carves its big buffers out of while it initializes,
+ * instead of the heap. The block is sized at build time, so the linker says whether everything
+ * fits, and once the module seals it, nothing more can be taken from it.
+ * Nothing taken is ever given back.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Everything taken from an arena is aligned to this many bytes. */
+#define ARENA_ALIGN 8
+
+/** Round a size up to ARENA_ALIGN, which is what taking it costs. */
+#define ARENA_ROUND_UP(size) (((size) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+/** How big an arena has to be to hold `count` buffers of `size` bytes. */
+#define ARENA_SIZE_FOR(count, size) ((count) * ARENA_ROUND_UP(size))
+
+/** An arena. Make one with ARENA_DEFINE(). Read-only outside this library. */
+typedef struct arena {
+    const char *name;       ///< Reported by arena_pack(): its first four characters
+    uint8_t *base;
+    size_t size;            ///< Bytes in all
+    size_t used;            ///< Bytes taken so far, including alignment
+    bool sealed;            ///< arena_seal() has been called: nothing more can be taken
+    bool listed;            ///< In the list arena_pack() reports from
+    struct arena *next;
+} arena_t;
+
+/**
+ * Define an arena of `nbytes` (see ARENA_SIZE_FOR()) in .bss, as `var`, named `arena_name`.
+ * At file scope; the arena is static to the file.
+ */
+#define ARENA_DEFINE(var, arena_name, nbytes) \
+    static uint8_t var##_storage[ARENA_ROUND_UP(nbytes)] __attribute__((aligned(ARENA_ALIGN))); \
+    static arena_t var = { .name = (arena_name), .base = var##_storage, .size = ARENA_ROUND_UP(nbytes) }
+
+/**
+ * @brief Take `size` bytes from an arena. Safe from either core.
+ *
+ * @param arena The arena.
+ * @param size How many bytes. They are not cleared: .bss starts zeroed, and nothing is ever taken twice.
+ * @return The bytes, aligned to ARENA_ALIGN, or NULL (and errno set) if they don't fit
+ *         (ENOMEM) or the arena is sealed (EPERM).
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Seal an arena, once its owner has taken everything it needs from it at init, so any later
+ * arena_alloc() from it fails. Logs how much of it was used.
+ */
+void arena_seal(arena_t *arena);
+
+/**
+ * @brief Pack the arenas' usage, and the heap's, for the command bus.
+ * Layout: number of arenas (1 byte), bytes of heap not yet handed out (4 bytes; 0 off the board),
+ * then for each arena, in the order they were first taken from: its name (4 bytes, zero padded),
+ * size (4 bytes), and bytes used (4 bytes), all little-endian. The top bit of each arena's first
+ * name byte is set if it is sealed.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. Fits (len - 5) / 12 arenas.
+ * @return size_t Number of bytes written.
+ */
+size_t arena_pack(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
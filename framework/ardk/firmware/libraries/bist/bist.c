@@ -0,0 +1,146 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "bist.h"
+
+/** Guards the results against the other core. A striped lock, like the metrics library's. */
+#define BIST_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST + 3)
+
+/** A check's result, and its figures. */
+typedef struct {
+    bist_result_t result;
+    uint32_t median;
+    uint32_t worst;
+    uint32_t limit;
+} check_t;
+
+static check_t checks[BIST_NUM_CHECKS];
+
+/** Has a check finished since bist_update() last said so? */
+static bool changed = false;
+
+static const char *const NAMES[BIST_NUM_CHECKS] = {
+    [BIST_LCD_FLUSH]        = "LCD flush (us)",
+    [BIST_I2C_ISR_LATENCY]  = "I2C ISR latency (cycles)",
+    [BIST_SENSOR_SPI_READ]  = "sensor SPI read (us)",
+    [BIST_SERVO_PWM]        = "servo PWM error (us)",
+};
+
+bist_result_t bist_run(bist_check_t check, bist_measure_t measure, void *context, uint32_t limit)
+{
+    // Insertion sorted as they come in, so the median is the one in the middle
+    uint32_t runs[BIST_RUNS];
+    bool measured = true;
+    for (size_t i = 0; i < BIST_RUNS; i++)
+    {
+        uint32_t value;
+        if (!measure(&value, context))
+        {
+            measured = false;
+            break;
+        }
+        size_t j = i;
+        for (; (j > 0) && (runs[j - 1] > value); j--)
+        {
+            runs[j] = runs[j - 1];
+        }
+        runs[j] = value;
+    }
+
+    check_t result = { .result = BIST_FAILED, .limit = limit };
+    if (measured)
+    {
+        result.median = runs[BIST_RUNS / 2];
+        result.worst = runs[BIST_RUNS - 1];
+        result.result = (result.median <= limit) ? BIST_PASS : BIST_SLOW;
+    }
+
+    const uint32_t saved = spin_lock_blocking(BIST_LOCK);
+    checks[check] = result;
+    changed = true;
+    spin_unlock(BIST_LOCK, saved);
+
+    switch (result.result)
+    {
+        case BIST_PASS:
+            log_info("Self test: %s %lu (worst %lu, limit %lu)\n", NAMES[check],
+                     (unsigned long)result.median, (unsigned long)result.worst, (unsigned long)limit);
+            break;
+        case BIST_SLOW:
+            log_error("Self test: %s %lu is over its limit of %lu (worst %lu)\n", NAMES[check],
+                      (unsigned long)result.median, (unsigned long)limit, (unsigned long)result.worst);
+            break;
+        default:
+            log_error("Self test: could not measure %s\n", NAMES[check]);
+            break;
+    }
+    return result.result;
+}
+
+bist_result_t bist_result(bist_check_t check)
+{
+    const uint32_t saved = spin_lock_blocking(BIST_LOCK);
+    const bist_result_t result = checks[check].result;
+    spin_unlock(BIST_LOCK, saved);
+    return result;
+}
+
+bool bist_ok(void)
+{
+    for (int i = 0; i < BIST_NUM_CHECKS; i++)
+    {
+        const bist_result_t result = bist_result((bist_check_t)i);
+        if ((result == BIST_SLOW) || (result == BIST_FAILED))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool bist_update(void)
+{
+    const uint32_t saved = spin_lock_blocking(BIST_LOCK);
+    const bool was_changed = changed;
+    changed = false;
+    spin_unlock(BIST_LOCK, saved);
+    return was_changed;
+}
+
+static uint8_t *pack_u16(uint8_t *out, uint32_t value)
+{
+    const uint16_t saturated = (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+    out[0] = (uint8_t)(saturated & 0xFF);
+    out[1] = (uint8_t)(saturated >> 8);
+    return out + 2;
+}
+
+size_t bist_pack(uint8_t *buf, size_t len)
+{
+    if (len < BIST_PACKED_LEN)
+    {
+        return 0;
+    }
+
+    check_t copy[BIST_NUM_CHECKS];
+    const uint32_t saved = spin_lock_blocking(BIST_LOCK);
+    memcpy(copy, checks, sizeof(copy));
+    spin_unlock(BIST_LOCK, saved);
+
+    uint8_t *out = buf;
+    for (int i = 0; i < BIST_NUM_CHECKS; i++)
+    {
+        *out++ = (uint8_t)copy[i].result;
+        out = pack_u16(out, copy[i].median);
+        out = pack_u16(out, copy[i].worst);
+        out = pack_u16(out, copy[i].limit);
+    }
+    return BIST_PACKED_LEN;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file bist.h
+ * @brief Built-in self test.
+ * Each firmware measures the hardware it depends on as it boots (how long an LCD flush takes, how
+ * soon the command bus's interrupt runs, how long a sensor read takes, how true the servo PWM is) and
+ * keeps the results here, in a status block the controller can read. A measurement over its limit
+ * marks the board as degraded, so it is caught at boot rather than showing up as lag later.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef BIST_RUNS
+    /** How many times each check measures. It's judged on the median, so one run cut short by an interrupt doesn't fail it. */
+    #define BIST_RUNS 5
+#endif // BIST_RUNS
+
+/** The checks. A firmware runs the ones for the hardware it has. */
+typedef enum {
+    BIST_LCD_FLUSH = 0,         ///< Clearing the whole LCD, in us
+    BIST_I2C_ISR_LATENCY,       ///< From the command bus's interrupt being raised to its handler running, in clk_sys cycles
+    BIST_SENSOR_SPI_READ,       ///< Reading the IMU's gyroscope and accelerometer over SPI, in us
+    BIST_SERVO_PWM,             ///< How far the servo PWM's count is from the timer over 1 ms, in us
+    BIST_NUM_CHECKS
+} bist_check_t;
+
+/** How a check went. */
+typedef enum {
+    BIST_NOT_RUN = 0,           ///< Not run (yet, or at all on this board)
+    BIST_PASS,                  ///< Within its limit
+    BIST_SLOW,                  ///< Over its limit: the hardware is there, but degraded
+    BIST_FAILED,                ///< Couldn't be measured
+} bist_result_t;
+
+/**
+ * Size of what bist_pack() writes. Layout, for each check in bist_check_t order, all little-endian:
+ * its result (bist_result_t, 1 byte), the median and the worst of its runs (2 bytes each), and its
+ * limit (2 bytes). Figures saturate at 0xFFFF.
+ */
+#define BIST_PACKED_LEN (BIST_NUM_CHECKS * 7)
+
+/**
+ * A check's measurement: put one run's figure in value.
+ *
+ * @return false if it couldn't be measured.
+ */
+typedef bool (*bist_measure_t)(uint32_t *value, void *context);
+
+/**
+ * @brief Run a check BIST_RUNS times and keep its result. Logs a check that is slow or fails.
+ * Safe from either core, but not from two at once for the same check.
+ *
+ * @param check Which check.
+ * @param measure Takes one measurement.
+ * @param context Passed to measure.
+ * @param limit The most its median can be and pass.
+ * @return How it went.
+ */
+bist_result_t bist_run(bist_check_t check, bist_measure_t measure, void *context, uint32_t limit);
+
+/** How a check went, as of its last bist_run(). */
+bist_result_t bist_result(bist_check_t check);
+
+/** true unless a check was slow or failed. */
+bool bist_ok(void);
+
+/**
+ * @brief Has a check finished since the last call? Call from the main loop, and publish
+ * bist_pack() when it says so: checks on the other core finish whenever they finish.
+ */
+bool bist_update(void);
+
+/**
+ * @brief Pack every check's result. See BIST_PACKED_LEN for the layout.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least BIST_PACKED_LEN, or nothing is written.
+ * @return size_t Number of bytes written.
+ */
+size_t bist_pack(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,292 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <bytestuff.h>
+#include <errors.h>
+#include <hotpaths.h>
+#include <rtacp.h>
+// Local includes
+#include "bwacp.h"
+
+/** Frame types */
+#define TYPE_REPEAT         0x1
+#define TYPE_READY          0x3
+#define TYPE_DATA           0x7
+
+/**
+ * After the shared fields (see RTACP_ID_SENDER_SHIFT), BWACP has the target address (6 bits),
+ * the target class mask (6 bits), a flag, and a parity bit.
+ */
+#define ID_TARGET_SHIFT     8
+#define ID_CLASS_SHIFT      2
+#define ID_CLASS_MASK       0x3F
+#define ID_FLAG_BIT         0x02    // DATA: a repeat of the last frame. READY: start over with this block. REPEAT: just the last frame.
+#define ID_PARITY_BIT       0x01    // DATA: alternates from 0, so a missed frame shows. Otherwise 1.
+
+/** A READY frame's data: the CRC24 (little-endian), the address (little-endian), and the first special byte. */
+#define READY_CRC_LEN       3
+#define READY_ADDRESS_LEN   4
+#define READY_LEN           (READY_CRC_LEN + READY_ADDRESS_LEN + 1)
+
+/** Where a buffer is in a block's life. */
+typedef enum {
+    BUFFER_FREE = 0,
+    BUFFER_RECEIVING,   // Its frames are arriving (CAN interrupt)
+    BUFFER_WAITING,     // It has all arrived, for bwacp_get_block()
+    BUFFER_TAKEN,       // The main loop has it
+} buffer_state_t;
+
+/** One block and the buffer it lives in. */
+typedef struct {
+    bwacp_block_t block;            // First, so a block can be handed back to bwacp_release_block()
+    buffer_state_t state;
+    uint32_t sequence;              // When it finished arriving, relative to the others
+    uint32_t block_crc;             // The CRC24 the writer sent
+    uint32_t crc;                   // CRC24 of the address and unstuffed bytes so far
+    bool parity;                    // Parity bit of the next DATA frame
+    bool too_big;                   // Did it overflow the buffer?
+    bytestuff_decoder_t decoder;
+    uint8_t buffer[BWACP_BLOCK_LEN];
+} buffer_t;
+
+/** The buffer pool. States are guarded by bwacp_lock; a buffer's contents belong to whoever moved it to its state. */
+static buffer_t buffers[BWACP_NUM_BUFFERS];
+
+/** The block that's arriving. A writer sends one block at a time. */
+static buffer_t *receiving = NULL;
+
+/** This node's classes, for multicasts. */
+static uint8_t node_classes = 0;
+
+/** Sequence number of the next block to finish arriving. */
+static uint32_t next_sequence = 0;
+
+/** Guards the buffer states against the CAN interrupt and the other core. NULL until bwacp_init(). */
+static spin_lock_t *bwacp_lock = NULL;
+
+/** Send a REPEAT for the whole block. If the queue is full, the writer times out and resends anyway. */
+static void HOT_FUNC(send_repeat)(uint8_t writer, rtacp_priority_t priority)
+{
+    mcp2515_frame_t frame;
+    frame.id = ((uint32_t)RTACP_PROTOCOL_BWACP << RTACP_ID_PROTOCOL_SHIFT) |
+               ((uint32_t)TYPE_REPEAT << RTACP_ID_TYPE_SHIFT) |
+               ((uint32_t)priority << RTACP_ID_PRIORITY_SHIFT) |
+               ((uint32_t)rtacp_get_address() << RTACP_ID_SENDER_SHIFT) |
+               ((uint32_t)(writer & RTACP_MAX_ADDRESS) << ID_TARGET_SHIFT) |
+               ID_PARITY_BIT;
+    frame.len = 0;
+    rtacp_send_frames(&frame, 1);
+}
+
+/** Give up on the block that's arriving. Call with bwacp_lock held. */
+static void HOT_FUNC(drop_receiving)(void)
+{
+    if (receiving != NULL)
+    {
+        receiving->state = BUFFER_FREE;
+        receiving = NULL;
+    }
+}
+
+/**
+ * Unstuff bytes into the arriving block. Returns true if it should be sent again.
+ * Call with bwacp_lock held.
+ */
+static bool HOT_FUNC(feed_block)(const uint8_t *bytes, size_t len)
+{
+    buffer_t *buffer = receiving;
+    for (size_t i = 0; i < len; i++)
+    {
+        switch (bytestuff_decoder_feed(&buffer->decoder, bytes[i]))
+        {
+        case BYTESTUFF_BYTE_DATA:
+            if (buffer->block.len < BWACP_BLOCK_LEN)
+            {
+                buffer->buffer[buffer->block.len] = bytes[i];
+                buffer->block.len++;
+                buffer->crc = crc24_update(buffer->crc, bytes[i]);
+            }
+            else
+            {
+                buffer->too_big = true;
+            }
+            break;
+        case BYTESTUFF_BYTE_SPECIAL:
+            break;
+        case BYTESTUFF_BYTE_END:
+            receiving = NULL;
+            if (buffer->too_big)
+            {
+                // Sending it again won't help
+                set_errno(ERR_ID_CAN_MODULE, E2BIG);
+                buffer->state = BUFFER_FREE;
+                return false;
+            }
+            if (buffer->crc != buffer->block_crc)
+            {
+                buffer->state = BUFFER_FREE;
+                return true;
+            }
+            buffer->sequence = next_sequence++;
+            buffer->state = BUFFER_WAITING;
+
+            // Wake the main loop
+            __sev();
+            return false;
+        case BYTESTUFF_BYTE_INVALID:
+        default:
+            drop_receiving();
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Handler for BWACP frames, from the CAN interrupt. */
+static void HOT_FUNC(frame_received)(const mcp2515_frame_t *frame)
+{
+    const uint8_t type = (uint8_t)((frame->id >> RTACP_ID_TYPE_SHIFT) & RTACP_ID_TYPE_MASK);
+    const rtacp_priority_t priority = (rtacp_priority_t)((frame->id >> RTACP_ID_PRIORITY_SHIFT) & RTACP_ID_PRIORITY_MASK);
+    const uint8_t writer = (uint8_t)((frame->id >> RTACP_ID_SENDER_SHIFT) & RTACP_MAX_ADDRESS);
+    const uint8_t target = (uint8_t)((frame->id >> ID_TARGET_SHIFT) & RTACP_MAX_ADDRESS);
+    const uint8_t classes = (uint8_t)((frame->id >> ID_CLASS_SHIFT) & ID_CLASS_MASK);
+    const bool flag = (frame->id & ID_FLAG_BIT) != 0;
+    const bool parity = (frame->id & ID_PARITY_BIT) != 0;
+
+    // REPEATs are for writers. The rest are for us if they're to our address or one of our classes.
+    const bool for_us = (target == rtacp_get_address()) || ((target == BWACP_MULTICAST_ADDRESS) && ((classes & node_classes) != 0));
+    if ((type == TYPE_REPEAT) || !for_us)
+    {
+        return;
+    }
+
+    bool repeat = false;
+    const uint32_t saved = spin_lock_blocking(bwacp_lock);
+    if (type == TYPE_READY)
+    {
+        // A new block, so the last one is over, whether or not it asks us to start over
+        drop_receiving();
+        for (int i = 0; (i < BWACP_NUM_BUFFERS) && (receiving == NULL); i++)
+        {
+            if (buffers[i].state == BUFFER_FREE)
+            {
+                receiving = &buffers[i];
+            }
+        }
+
+        if ((receiving == NULL) || (frame->len != READY_LEN))
+        {
+            // Every buffer is in use (or the frame is malformed). Send it again later.
+            receiving = NULL;
+            repeat = true;
+        }
+        else
+        {
+            buffer_t *buffer = receiving;
+            buffer->state = BUFFER_RECEIVING;
+            buffer->block.writer = writer;
+            buffer->block.priority = priority;
+            buffer->block.data = buffer->buffer;
+            buffer->block.len = 0;
+            buffer->block_crc = (uint32_t)frame->data[0] | ((uint32_t)frame->data[1] << 8) | ((uint32_t)frame->data[2] << 16);
+            buffer->block.address = 0;
+            buffer->crc = CRC24_INIT;
+            for (int i = 0; i < READY_ADDRESS_LEN; i++)
+            {
+                const uint8_t byte = frame->data[READY_CRC_LEN + i];
+                buffer->block.address |= (uint32_t)byte << (8 * i);
+                buffer->crc = crc24_update(buffer->crc, byte);
+            }
+            buffer->parity = false;
+            buffer->too_big = false;
+            bytestuff_decoder_init(&buffer->decoder);
+            repeat = feed_block(&frame->data[READY_CRC_LEN + READY_ADDRESS_LEN], 1);
+        }
+    }
+    else if ((type == TYPE_DATA) && (receiving != NULL) && (receiving->block.writer == writer) && !flag)
+    {
+        // (A repeated DATA frame is for a node that asked for it. We never ask for single frames.)
+        if (parity != receiving->parity)
+        {
+            // We missed a frame
+            drop_receiving();
+            repeat = true;
+        }
+        else
+        {
+            receiving->parity = !receiving->parity;
+            repeat = feed_block(frame->data, frame->len);
+        }
+    }
+    spin_unlock(bwacp_lock, saved);
+
+    if (repeat)
+    {
+        send_repeat(writer, priority);
+    }
+}
+
+bool bwacp_init(uint8_t classes)
+{
+    log_info("Init BWACP with %u buffers of %u bytes\n", (uint)BWACP_NUM_BUFFERS, (uint)BWACP_BLOCK_LEN);
+
+    if (rtacp_get_address() == RTACP_BROADCAST_ADDRESS)
+    {
+        // No CAN controller (or it isn't started yet)
+        set_errno(ERR_ID_CAN_MODULE, EINIT);
+        return false;
+    }
+
+    // Before the interrupt can take it
+    node_classes = classes & ID_CLASS_MASK;
+    bwacp_lock = spin_lock_init(spin_lock_claim_unused(true));
+    rtacp_set_frame_callback(RTACP_PROTOCOL_BWACP, &frame_received);
+    return true;
+}
+
+const bwacp_block_t *bwacp_get_block(void)
+{
+    if (bwacp_lock == NULL)
+    {
+        return NULL;
+    }
+
+    buffer_t *oldest = NULL;
+    const uint32_t saved = spin_lock_blocking(bwacp_lock);
+    for (int i = 0; i < BWACP_NUM_BUFFERS; i++)
+    {
+        buffer_t *buffer = &buffers[i];
+        if ((buffer->state == BUFFER_WAITING) && ((oldest == NULL) || ((int32_t)(buffer->sequence - oldest->sequence) < 0)))
+        {
+            oldest = buffer;
+        }
+    }
+    if (oldest != NULL)
+    {
+        oldest->state = BUFFER_TAKEN;
+    }
+    spin_unlock(bwacp_lock, saved);
+    return (oldest != NULL) ? &oldest->block : NULL;
+}
+
+void bwacp_release_block(const bwacp_block_t *block)
+{
+    buffer_t *buffer = (buffer_t *)block;
+    const uint32_t saved = spin_lock_blocking(bwacp_lock);
+    buffer->state = BUFFER_FREE;
+    spin_unlock(bwacp_lock, saved);
+}
+
+bool bwacp_is_receiving(void)
+{
+    return receiving != NULL;
+}
+
+void bwacp_request_repeat(uint8_t writer, rtacp_priority_t priority)
+{
+    send_repeat(writer, priority);
+}
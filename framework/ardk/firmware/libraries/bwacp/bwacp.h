@@ -0,0 +1,84 @@
+/**
+ * @file bwacp.h
+ * @brief Block Write Artie CAN Protocol (BWACP) module, for the nodes being written to.
+ * Blocks are unstuffed from the CAN interrupt straight into a small pool of buffers,
+ * checked against their CRC24, and handed to the main loop in the order they arrived.
+ * A block that arrives with a frame missing, or corrupt, or with no buffer free for it,
+ * is asked for again with a REPEAT frame.
+ *
+ * Needs the rtacp module, which owns the CAN controller, started first.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <rtacp.h>
+
+#ifndef BWACP_NUM_BUFFERS
+    /** How many blocks can be arriving or waiting for the main loop at once. */
+    #define BWACP_NUM_BUFFERS 2
+#endif // BWACP_NUM_BUFFERS
+
+#ifndef BWACP_BLOCK_LEN
+    /** The most bytes (once unstuffed) a block can have. */
+    #define BWACP_BLOCK_LEN 4096
+#endif // BWACP_BLOCK_LEN
+
+/** Target address for a multicast to one or more classes of device. */
+#define BWACP_MULTICAST_ADDRESS 0x3F
+
+/** Classes of device, for multicasts. A node can be in more than one. */
+#define BWACP_CLASS_SBC     0x01    ///< Single board computer
+#define BWACP_CLASS_MCU     0x02
+#define BWACP_CLASS_SENSOR  0x04    ///< Sensor node
+#define BWACP_CLASS_MOTOR   0x08    ///< Motor node
+
+/** A block that has all arrived intact. */
+typedef struct {
+    uint8_t writer;                 ///< Address of the node that sent it
+    rtacp_priority_t priority;      ///< The priority it came at
+    uint32_t address;               ///< Where it goes. What that means is up to the application.
+    const uint8_t *data;            ///< Its bytes, unstuffed
+    size_t len;                     ///< How many
+} bwacp_block_t;
+
+/**
+ * @brief Start taking blocks written to this node's address, or multicast to any of its classes.
+ * Call after rtacp_init().
+ *
+ * @param classes BWACP_CLASS_* bits.
+ * @return false (and sets errno) if there's no CAN controller to take them from.
+ */
+bool bwacp_init(uint8_t classes);
+
+/**
+ * @brief Get the oldest block that has arrived, if any. It keeps its buffer until
+ * bwacp_release_block(), so release it as soon as it has been dealt with.
+ *
+ * @return The block, or NULL if there are none waiting.
+ */
+const bwacp_block_t *bwacp_get_block(void);
+
+/** Give a block's buffer back for the next one. */
+void bwacp_release_block(const bwacp_block_t *block);
+
+/** Is a block partway through arriving? */
+bool bwacp_is_receiving(void);
+
+/**
+ * @brief Ask a writer to send its block again: for one it sent intact that couldn't be used.
+ * Safe from either core and from IRQs.
+ *
+ * @param writer Its address.
+ * @param priority The priority the block came at.
+ */
+void bwacp_request_repeat(uint8_t writer, rtacp_priority_t priority);
+
+#ifdef __cplusplus
+}
+#endif
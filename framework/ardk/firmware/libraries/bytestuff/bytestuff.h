@@ -0,0 +1,110 @@
+/**
+ * @file bytestuff.h
+ * @brief Byte stuffing (docs/specifications/ByteStuffing.md), the CRC16 that RPCACP and
+ * PSACP check their stuffed payloads with, and the CRC24 that BWACP checks its unstuffed
+ * blocks with. The encoder and decoder work a byte at a time, so payloads can be stuffed
+ * straight into frames and unstuffed straight out of them. bytestuff_encode() and
+ * bytestuff_decode() do a whole payload at once, in place.
+ *
+ * Needs nothing from the Pico SDK unless built with HOT_PATHS_IN_RAM, so the host can
+ * build it too.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The special byte that ends a stuffed payload. */
+#define BYTESTUFF_END 0xFF
+
+/** Most payload bytes between two special bytes. */
+#define BYTESTUFF_MAX_RUN 0xFE
+
+/** Size of `len` payload bytes once stuffed. */
+#define BYTESTUFF_STUFFED_LEN(len) ((len) + (((len) + BYTESTUFF_MAX_RUN - 1) / BYTESTUFF_MAX_RUN) + 1)
+
+/** Where a stuffed payload is being read from. */
+typedef struct {
+    const uint8_t *data;    ///< The payload
+    size_t len;             ///< Its length
+    size_t pos;             ///< Next payload byte to put out
+    uint8_t run;            ///< Payload bytes left before the next special byte
+    bool done;              ///< Has the final special byte been put out?
+} bytestuff_encoder_t;
+
+/** What a stuffed byte turned out to be. */
+typedef enum {
+    BYTESTUFF_BYTE_DATA = 0,    ///< A payload byte
+    BYTESTUFF_BYTE_SPECIAL,     ///< A special byte, now consumed
+    BYTESTUFF_BYTE_END,         ///< The final special byte (or anything after it)
+    BYTESTUFF_BYTE_INVALID,     ///< A 0x00 special byte, which a stuffer never makes: the payload is corrupt
+} bytestuff_byte_t;
+
+/** Where a stuffed payload is being taken apart. */
+typedef struct {
+    uint8_t run;            ///< Payload bytes left before the next special byte
+    bool done;              ///< Has the final special byte arrived?
+} bytestuff_decoder_t;
+
+/** Initial value of a CRC16. */
+#define CRC16_INIT 0xFFFF
+
+/** Initial value of a CRC24. */
+#define CRC24_INIT 0xB704CE
+
+/** Start stuffing `len` bytes of `data`. `data` must stay put until the encoder is done. */
+void bytestuff_encoder_init(bytestuff_encoder_t *encoder, const uint8_t *data, size_t len);
+
+/**
+ * @brief Get the next stuffed byte.
+ *
+ * @return false once the final special byte has been put out.
+ */
+bool bytestuff_encoder_next(bytestuff_encoder_t *encoder, uint8_t *byte);
+
+/** Start taking apart a stuffed payload. */
+void bytestuff_decoder_init(bytestuff_decoder_t *decoder);
+
+/** Take the next stuffed byte. If it is a payload byte, it is the byte itself. */
+bytestuff_byte_t bytestuff_decoder_feed(bytestuff_decoder_t *decoder, uint8_t byte);
+
+/**
+ * @brief Stuff a payload in place.
+ *
+ * @param buffer Holds the payload, and gets the stuffed payload.
+ * @param len Bytes of payload.
+ * @param cap Size of `buffer`. Needs to be at least BYTESTUFF_STUFFED_LEN(len).
+ * @return Length of the stuffed payload, or 0 if it wouldn't fit.
+ */
+size_t bytestuff_encode(uint8_t *buffer, size_t len, size_t cap);
+
+/**
+ * @brief Unstuff a payload in place. Anything after the final special byte is left alone.
+ *
+ * @param buffer Holds the stuffed payload, and gets the payload, from its start.
+ * @param len Bytes of stuffed payload.
+ * @param payload_len Gets the length of the payload.
+ * @return false if the stuffed payload is corrupt or ends before its final special byte.
+ */
+bool bytestuff_decode(uint8_t *buffer, size_t len, size_t *payload_len);
+
+/** Add a byte to a CRC16 (CCITT: polynomial 0x1021, no reflection, starting from CRC16_INIT). */
+uint16_t crc16_update(uint16_t crc, uint8_t byte);
+
+/** Add `len` bytes to a CRC16. */
+uint16_t crc16_update_bytes(uint16_t crc, const uint8_t *data, size_t len);
+
+/** Add a byte to a CRC24 (OpenPGP: polynomial 0x864CFB, no reflection, starting from CRC24_INIT). */
+uint32_t crc24_update(uint32_t crc, uint8_t byte);
+
+/** Add `len` bytes to a CRC24. */
+uint32_t crc24_update_bytes(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,41 +1,581 @@
 // Stdlib includes
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 // SDK includes
+#include "hardware/dma.h"
 #include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
 #include "pico/stdlib.h"
-#include "pico/util/queue.h"
 // Third party library includes
 #include <i2c_fifo.h>
 #include <i2c_slave.h>
 // Library includes
 #include <errors.h>
+#include <hotpaths.h>
+#include <sysclock.h>
+#include <trace.h>
+#if CMDS_USE_CAN
+    #include <rtacp.h>
+#endif // CMDS_USE_CAN
 // Local includes
 #include "cmds.h"
 #include "../board/pinconfig.h"
 
-/** Baudrate for the I2C bus */
-static const uint I2C_BAUDRATE = 100 * 1000;
+#if ISR_DATA_IN_SCRATCH
+    /**
+     * Keep what the I2C ISR reads and writes in SCRATCH_Y, next to core 0's stack. cmds_init() runs on
+     * core 0, so the interrupt does too, and with its data there it stays off the four striped banks that
+     * core 1 paints into and the LCD's DMA reads from. See the README's Memory.
+     */
+    #define CMDS_ISR_DATA(v) __scratch_y(#v) v
+#else
+    #define CMDS_ISR_DATA(v) v
+#endif // ISR_DATA_IN_SCRATCH
 
-/** The number of items we can hold at maximum in the command queue. No testing was done to determine this value. */
-static const uint CMD_QUEUE_SIZE = 128;
+/**
+ * Size of the command ring buffer in bytes (see CMDS_RING_SIZE). Must be a power of two so that the
+ * free-running head and tail counters can be masked into an index.
+ * Each record costs one length byte plus its payload.
+ */
+#define CMD_RING_SIZE CMDS_RING_SIZE
+
+#if (CMD_RING_SIZE & (CMD_RING_SIZE - 1)) != 0
+    #error "CMDS_RING_SIZE must be a power of two"
+#endif
+
+/** Report busy once there's less room than a full frame plus its length byte. */
+#define CMD_RING_BUSY_FREE (CMDS_FRAME_MAX_LEN + 1)
+
+/** Mask to turn a free-running ring counter into an index. */
+#define CMD_RING_MASK (CMD_RING_SIZE - 1)
+
+/** The largest record (in command bytes) we can hold. Limited by the one-byte length slot. */
+#define CMD_RECORD_MAX_LEN 0xFF
+
+/**
+ * @brief Single-producer, single-consumer ring of received records.
+ *
+ * The I2C ISR is the only writer of cmd_ring_head and the main loop is the only writer
+ * of cmd_ring_tail, so no lock is needed. Each I2C write transaction becomes one record:
+ * a length byte followed by that many command bytes. The ISR writes the record past
+ * the published head and only publishes it (by moving the head) once the controller
+ * signals Stop, so the main loop never sees half a transaction.
+ */
+static uint8_t CMDS_ISR_DATA(cmd_ring)[CMD_RING_SIZE];
+
+/** Free-running count of bytes published by the ISR. */
+static volatile uint32_t CMDS_ISR_DATA(cmd_ring_head) = 0;
+
+/** Free-running count of bytes consumed by the main loop. */
+static volatile uint32_t CMDS_ISR_DATA(cmd_ring_tail) = 0;
+
+/** Number of command bytes left in the record the main loop is partway through (see cmds_get_next()). */
+static size_t cmd_record_remaining = 0;
+
+/** What we send the next time the controller reads from us. Set with cmds_set_register_bytes(). */
+static uint8_t CMDS_ISR_DATA(register_bytes)[CMDS_REGISTER_MAX_LEN];
+
+/** How many bytes of register_bytes are valid. */
+static size_t register_len = 0;
+
+/** The next byte of register_bytes to send in the current read transaction. */
+static size_t register_read_pos = 0;
+
+/** Most bytes ever in the ring at once, counting the record being received. Written by the ISR. */
+static volatile uint32_t cmd_ring_high_water = 0;
+
+/** Write transactions the ISR has thrown away for not fitting. */
+static volatile uint32_t cmd_dropped_overflow = 0;
+
+/** Frames the ISR has thrown away for having the wrong length. */
+static volatile uint32_t cmd_dropped_invalid = 0;
+
+/** Total drops as of the last time the status register was selected, for CMDS_STATUS_DROPPED. */
+static uint32_t cmd_dropped_at_status = 0;
+
+/** The register map (see CMDS_REGISTER_SELECT). Written with cmds_register_write(). */
+static uint8_t CMDS_ISR_DATA(register_map)[CMDS_REGISTER_MAP_LEN];
+
+/**
+ * Guards register_map against writers on the other core. NULL until cmds_init(), which is
+ * also when the ISR that reads the map starts, so until then writers don't need it.
+ */
+static spin_lock_t *register_map_lock = NULL;
 
-/** The circular buffer of commands we've received so far. */
-static queue_t cmd_queue;
+/** Set by selecting a register: the next read gets snapshot_bytes instead of register_bytes. */
+static bool snapshot_read_pending = false;
+
+/** The registers from the selected address on, copied out of register_map when it was selected. */
+static uint8_t CMDS_ISR_DATA(snapshot_bytes)[CMDS_REGISTER_MAX_LEN];
+
+/** How many bytes of snapshot_bytes are valid. */
+static size_t snapshot_len = 0;
+
+/** Bytes of a scheduled frame ahead of its commands: the CMDS_SCHEDULE marker and the time. */
+#define SCHEDULE_HEADER_LEN 5
+
+/** Length of a clock sync frame: the CMDS_CLOCK_SYNC marker and the controller's time. */
+#define CLOCK_SYNC_LEN 9
+
+/** Where a scheduled frame's slot is. */
+typedef enum {
+    SCHEDULE_FREE,      // Not in use
+    SCHEDULE_WAITING,   // Its alarm hasn't gone off yet
+    SCHEDULE_DUE,       // Its time has come; queued as soon as no write is half received
+} schedule_state_t;
+
+/** Scheduled frames waiting for their time. Touched by the ISR and the alarms, with the other kept out. */
+static struct {
+    schedule_state_t state;
+    size_t len;
+    uint8_t commands[CMDS_FRAME_MAX_LEN - SCHEDULE_HEADER_LEN];
+} schedule[CMDS_SCHEDULE_SLOTS];
+
+/** Is any scheduled frame SCHEDULE_DUE? */
+static bool schedule_due = false;
+
+/** The controller's clock minus ours, in microseconds, from the last CMDS_CLOCK_SYNC. */
+static int64_t clock_offset_us = 0;
+
+/** The commands of the staged frame (without the CMDS_STAGE marker), waiting for a CMDS_COMMIT. */
+static uint8_t staged_frame[CMDS_FRAME_MAX_LEN - 1];
+
+/** How many commands are staged. Zero if there's no staged frame. */
+static size_t staged_len = 0;
+
+/** What the ISR keeps about the write transaction it is receiving. */
+typedef struct {
+    bool active;        // Are we in the middle of a write transaction?
+    bool commit;        // Did this transaction start with CMDS_COMMIT?
+    bool dropped;       // Has this transaction been thrown away (overflow or bad header)?
+    bool select;        // Is this transaction selecting a register (a header with no commands)?
+    bool have_address;  // Has the register address arrived?
+    uint8_t address;    // The register address
+    uint32_t start;     // Ring counter of this record's length byte
+    uint32_t write;     // Ring counter of the next payload byte
+    size_t len;         // Number of payload bytes received so far
+    size_t seen;        // Number of bytes after the header so far, kept or not
+    size_t expected;    // Payload length from the frame header, or zero for an unframed write
+} rx_state_t;
+
+/** ISR-side state for the record currently being received. */
+static rx_state_t CMDS_ISR_DATA(rx) = { 0 };
+
+/**
+ * Helper function for ISR. Called with the bytes of a write transaction as they arrive, in
+ * as many pieces as it takes. Stores the payload into the ring a piece at a time.
+ */
+static inline void HOT_FUNC(_isr_receive)(const uint8_t *bytes, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    if (!rx.active)
+    {
+        // First byte of the transaction. Reserve the length slot.
+        rx.active = true;
+        rx.dropped = false;
+        rx.start = cmd_ring_head;
+        rx.write = rx.start + 1;
+        rx.len = 0;
+        rx.seen = 0;
+        rx.expected = 0;
+        rx.select = false;
+        rx.commit = false;
+        rx.have_address = false;
+
+        if ((bytes[0] & CMDS_FRAME_HEADER_MASK) == CMDS_FRAME_HEADER)
+        {
+            // Framed write: this byte is the header and is not stored.
+            rx.expected = CMDS_FRAME_LENGTH(bytes[0]);
+            rx.select = (bytes[0] == CMDS_REGISTER_SELECT);
+            rx.commit = (bytes[0] == CMDS_COMMIT);
+            bytes++;
+            len--;
+        }
+    }
+
+    rx.seen += len;
+    if (rx.dropped || (len == 0))
+    {
+        return;
+    }
+
+    if (rx.select)
+    {
+        if (!rx.have_address)
+        {
+            rx.address = bytes[0];
+            rx.have_address = true;
+            if (len == 1)
+            {
+                return;
+            }
+        }
+
+        // More than an address after an empty header. Neither a register selection nor a frame.
+        rx.select = false;
+        rx.dropped = true;
+        cmd_dropped_invalid++;
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    if (((rx.len + len) > CMD_RECORD_MAX_LEN) || ((rx.write + len - cmd_ring_tail) > CMD_RING_SIZE))
+    {
+        rx.dropped = true;
+        cmd_dropped_overflow++;
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        return;
+    }
+
+    // Copy in up to two pieces, in case the payload wraps around the end of the ring.
+    const size_t index = rx.write & CMD_RING_MASK;
+    const size_t first = ((CMD_RING_SIZE - index) < len) ? (CMD_RING_SIZE - index) : len;
+    memcpy(&cmd_ring[index], bytes, first);
+    memcpy(cmd_ring, bytes + first, len - first);
+    rx.write += len;
+    rx.len += len;
+
+    const uint32_t used = rx.write - cmd_ring_tail;
+    if (used > cmd_ring_high_water)
+    {
+        cmd_ring_high_water = used;
+    }
+}
+
+/** Helper function for ISR. Update the status register. */
+static inline void HOT_FUNC(_isr_update_status)(void)
+{
+    const uint32_t room = CMD_RING_SIZE - (cmd_ring_head - cmd_ring_tail);
+    const uint32_t dropped = cmd_dropped_overflow + cmd_dropped_invalid;
+    const uint16_t high_water = (cmd_ring_high_water > 0xFFFF) ? 0xFFFF : (uint16_t)cmd_ring_high_water;
+    const uint16_t dropped_saturated = (dropped > 0xFFFF) ? 0xFFFF : (uint16_t)dropped;
+
+    uint8_t flags = 0;
+    if (room < CMD_RING_BUSY_FREE)
+    {
+        flags |= CMDS_STATUS_BUSY;
+    }
+    if (dropped != cmd_dropped_at_status)
+    {
+        flags |= CMDS_STATUS_DROPPED;
+    }
+    if (staged_len != 0)
+    {
+        flags |= CMDS_STATUS_STAGED;
+    }
+    cmd_dropped_at_status = dropped;
+
+    // Only this ISR writes the status register, so it doesn't need register_map_lock
+    uint8_t *status = &register_map[CMDS_REG_STATUS];
+    status[0] = flags;
+    status[1] = (room > 0xFF) ? 0xFF : (uint8_t)room;
+    status[2] = (uint8_t)(high_water & 0xFF);
+    status[3] = (uint8_t)(high_water >> 8);
+    status[4] = (uint8_t)(dropped_saturated & 0xFF);
+    status[5] = (uint8_t)(dropped_saturated >> 8);
+}
+
+/** Helper function for ISR. Snapshot the registers from `address` on, for the read that follows. */
+static inline void HOT_FUNC(_isr_select_register)(uint8_t address)
+{
+    if (address < (CMDS_REG_STATUS + CMDS_STATUS_LEN))
+    {
+        _isr_update_status();
+    }
+
+    const size_t available = CMDS_REGISTER_MAP_LEN - address;
+    snapshot_len = (available < sizeof(snapshot_bytes)) ? available : sizeof(snapshot_bytes);
+    const uint32_t saved = spin_lock_blocking(register_map_lock);
+    memcpy(snapshot_bytes, &register_map[address], snapshot_len);
+    spin_unlock(register_map_lock, saved);
+    snapshot_read_pending = true;
+}
 
 /** Helper function for ISR. Called when we want to read bytes from the controller. */
-static inline void _isr_receive_bytes(i2c_inst_t *i2c)
+static inline void HOT_FUNC(_isr_receive_bytes)(i2c_inst_t *i2c)
 {
+    uint8_t bytes[16]; // The depth of the RX FIFO
     size_t nbytes = i2c_get_read_available(i2c);
+    nbytes = (nbytes < sizeof(bytes)) ? nbytes : sizeof(bytes);
     for (size_t i = 0; i < nbytes; i++)
     {
-        uint8_t byte = i2c_read_byte(i2c);
-        bool added = queue_try_add(&cmd_queue, &byte);
-        if (!added)
+        bytes[i] = i2c_read_byte(i2c);
+    }
+    _isr_receive(bytes, nbytes);
+}
+
+/**
+ * Helper function for ISR. Called when the controller wants a byte from us. Sends it, and as many of the
+ * ones after it as fit in the TX FIFO, so a burst only interrupts us once per FIFO-full. Whatever the
+ * controller doesn't read is flushed by the hardware at the next read.
+ */
+static inline void HOT_FUNC(_isr_send_bytes)(i2c_inst_t *i2c)
+{
+    const uint8_t *bytes = snapshot_read_pending ? snapshot_bytes : register_bytes;
+    const size_t len = snapshot_read_pending ? snapshot_len : register_len;
+    if (register_read_pos >= len)
+    {
+        // Pad with 0xFF if the controller reads past the end.
+        i2c_write_byte(i2c, 0xFF);
+        return;
+    }
+
+    size_t room = i2c_get_write_available(i2c);
+    do
+    {
+        i2c_write_byte(i2c, bytes[register_read_pos]);
+        register_read_pos++;
+        room--;
+    } while ((room > 0) && (register_read_pos < len));
+}
+
+/** Helper function for ISR. Byte `i` of the payload of the record being received. */
+static inline uint8_t HOT_FUNC(_isr_record_byte)(size_t i)
+{
+    return cmd_ring[(rx.start + 1 + i) & CMD_RING_MASK];
+}
+
+/**
+ * Helper function for ISR. Queue `len` (at least one) command bytes as a record of their own.
+ * Only call when no write is half received, since that one's record starts at the head.
+ * Returns false, counting the drop, if they don't fit.
+ */
+static bool HOT_FUNC(_isr_queue_record)(const uint8_t *bytes, size_t len)
+{
+    const uint32_t start = cmd_ring_head;
+    const uint32_t end = start + 1 + len;
+    if ((end - cmd_ring_tail) > CMD_RING_SIZE)
+    {
+        cmd_dropped_overflow++;
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        return false;
+    }
+
+    cmd_ring[start & CMD_RING_MASK] = (uint8_t)len;
+    for (size_t i = 0; i < len; i++)
+    {
+        cmd_ring[(start + 1 + i) & CMD_RING_MASK] = bytes[i];
+    }
+    if ((end - cmd_ring_tail) > cmd_ring_high_water)
+    {
+        cmd_ring_high_water = end - cmd_ring_tail;
+    }
+
+    __dmb();
+    cmd_ring_head = end;
+    TRACE_PROBE(TRACE_PROBE_CMD_RECEIVED);
+    __sev();
+    return true;
+}
+
+/** Helper function for ISR. Keep the frame just received (after its CMDS_STAGE marker) for the next commit, instead of queueing it. */
+static inline void HOT_FUNC(_isr_stage_record)(void)
+{
+    // The record's bytes stay past the head, where the next record writes over them.
+    staged_len = rx.len - 1;
+    for (size_t i = 0; i < staged_len; i++)
+    {
+        staged_frame[i] = _isr_record_byte(1 + i);
+    }
+}
+
+/** Helper function for ISR. Queue the staged frame. If it doesn't fit, it stays staged, so the controller can commit again once there's room. */
+static inline void HOT_FUNC(_isr_commit_record)(void)
+{
+    if ((staged_len != 0) && _isr_queue_record(staged_frame, staged_len))
+    {
+        staged_len = 0;
+    }
+}
+
+/** Queue every scheduled frame that is due. Call from the ISR, or with interrupts off, when no write is half received. */
+static void HOT_FUNC(_isr_queue_due)(void)
+{
+    for (size_t i = 0; i < CMDS_SCHEDULE_SLOTS; i++)
+    {
+        if (schedule[i].state == SCHEDULE_DUE)
+        {
+            // Late is as good as never, so one that doesn't fit is dropped rather than kept.
+            (void)_isr_queue_record(schedule[i].commands, schedule[i].len);
+            schedule[i].state = SCHEDULE_FREE;
+        }
+    }
+    schedule_due = false;
+}
+
+/** Alarm callback for a scheduled frame. Queues it now, unless a write is half received, in which case the ISR does when it ends. */
+static int64_t HOT_FUNC(_schedule_alarm_callback)(alarm_id_t id, void *user_data)
+{
+    const size_t slot = (size_t)(uintptr_t)user_data;
+
+    // The I2C (or CAN) interrupt also writes the ring and the schedule, and could otherwise cut in.
+    const uint32_t saved = save_and_disable_interrupts();
+    schedule[slot].state = SCHEDULE_DUE;
+    schedule_due = true;
+    if (!rx.active)
+    {
+        _isr_queue_due();
+    }
+    restore_interrupts(saved);
+    return 0;
+}
+
+/** Helper function for ISR. Hold the frame just received (after its CMDS_SCHEDULE marker and time) until its time. */
+static inline void HOT_FUNC(_isr_schedule_record)(void)
+{
+    if (rx.len <= SCHEDULE_HEADER_LEN)
+    {
+        // No commands to schedule, or not even a whole time
+        cmd_dropped_invalid++;
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    size_t slot = 0;
+    while ((slot < CMDS_SCHEDULE_SLOTS) && (schedule[slot].state != SCHEDULE_FREE))
+    {
+        slot++;
+    }
+    if (slot == CMDS_SCHEDULE_SLOTS)
+    {
+        cmd_dropped_overflow++;
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        return;
+    }
+
+    schedule[slot].len = rx.len - SCHEDULE_HEADER_LEN;
+    for (size_t i = 0; i < schedule[slot].len; i++)
+    {
+        schedule[slot].commands[i] = _isr_record_byte(SCHEDULE_HEADER_LEN + i);
+    }
+
+    // Only the low bits of the controller's time came over. Take the time nearest to now that has them.
+    const uint32_t at = (uint32_t)_isr_record_byte(1) | ((uint32_t)_isr_record_byte(2) << 8) |
+                        ((uint32_t)_isr_record_byte(3) << 16) | ((uint32_t)_isr_record_byte(4) << 24);
+    const uint64_t now = time_us_64();
+    const int32_t lead_us = (int32_t)(at - (uint32_t)(now + (uint64_t)clock_offset_us));
+    if (lead_us <= 0)
+    {
+        // Queued as soon as this write's own record is dealt with
+        schedule[slot].state = SCHEDULE_DUE;
+        schedule_due = true;
+        return;
+    }
+
+    schedule[slot].state = SCHEDULE_WAITING;
+    if (add_alarm_at(from_us_since_boot(now + (uint64_t)lead_us), &_schedule_alarm_callback, (void *)(uintptr_t)slot, true) < 0)
+    {
+        schedule[slot].state = SCHEDULE_FREE;
+        cmd_dropped_overflow++;
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+    }
+}
+
+/** Helper function for ISR. Take the controller's time from the clock sync frame just received. */
+static inline void HOT_FUNC(_isr_sync_clock)(void)
+{
+    if (rx.len != CLOCK_SYNC_LEN)
+    {
+        cmd_dropped_invalid++;
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    uint64_t controller_us = 0;
+    for (size_t i = CLOCK_SYNC_LEN - 1; i > 0; i--)
+    {
+        controller_us = (controller_us << 8) | _isr_record_byte(i);
+    }
+    clock_offset_us = (int64_t)(controller_us - time_us_64());
+}
+
+/** Helper function for ISR. Called when the controller ends a transaction. Publishes the record, if any. */
+static inline void HOT_FUNC(_isr_end_transaction)(void)
+{
+    // The next read starts from the beginning of the register again.
+    register_read_pos = 0;
+
+    if (!rx.active)
+    {
+        // A read finished. Any register selection has had its answer.
+        snapshot_read_pending = false;
+        return;
+    }
+    rx.active = false;
+
+    if (rx.select)
+    {
+        _isr_select_register(rx.have_address ? rx.address : CMDS_REG_STATUS);
+        return;
+    }
+
+    // Any other write cancels a selection, so the read after a command gets its response
+    snapshot_read_pending = false;
+
+    if (rx.commit && (rx.seen == 0))
+    {
+        _isr_commit_record();
+        return;
+    }
+
+    if (rx.dropped || (rx.len == 0))
+    {
+        return;
+    }
+
+    if ((rx.expected != 0) && (rx.expected != rx.len))
+    {
+        // Truncated or overlong frame. Don't act on any of it.
+        cmd_dropped_invalid++;
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        return;
+    }
+
+    if (rx.expected != 0)
+    {
+        // The library's own frames, told apart by their first byte (never a command)
+        switch (_isr_record_byte(0))
         {
-            errno = ERR_ID_CMD_MODULE | ENOMEM;
+        case CMDS_STAGE:
+            _isr_stage_record();
+            return;
+        case CMDS_SCHEDULE:
+            _isr_schedule_record();
+            return;
+        case CMDS_CLOCK_SYNC:
+            _isr_sync_clock();
+            return;
+        default:
+            break;
         }
     }
+
+    cmd_ring[rx.start & CMD_RING_MASK] = (uint8_t)rx.len;
+
+    // Make sure the record is in memory before the consumer can see the new head.
+    __dmb();
+    cmd_ring_head = rx.write;
+    TRACE_PROBE(TRACE_PROBE_CMD_RECEIVED);
+
+    // Wake the main loop if it is waiting in cmds_wait_for_next().
+    __sev();
+}
+
+/** Helper function for ISR. End the transaction, then queue any scheduled frames that came due during it. */
+static inline void HOT_FUNC(_isr_finish_record)(void)
+{
+    _isr_end_transaction();
+    if (schedule_due)
+    {
+        _isr_queue_due();
+    }
 }
 
 /**
@@ -44,29 +584,375 @@ static inline void _isr_receive_bytes(i2c_inst_t *i2c)
  * @param i2c
  * @param event
  */
-static void _i2c_handler(i2c_inst_t *i2c, i2c_slave_event_t event)
+static void HOT_FUNC(_i2c_handler)(i2c_inst_t *i2c, i2c_slave_event_t event)
 {
+    TRACE_BEGIN(TRACE_ID_I2C_ISR, event);
     switch (event)
     {
     case I2C_SLAVE_RECEIVE: // master has written some data
         _isr_receive_bytes(i2c);
         break;
     case I2C_SLAVE_REQUEST: // master is requesting data
-        errno = ERR_ID_CMD_MODULE | EIO;
+        _isr_send_bytes(i2c);
         break;
     case I2C_SLAVE_FINISH: // master has signalled Stop / Restart
+        _isr_finish_record();
         break;
     default:
         break;
     }
+    TRACE_END(TRACE_ID_I2C_ISR, event);
 }
 
-void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin)
+#if CMDS_I2C_RX_DMA && !CMDS_USE_CAN
+#if ((CMDS_RX_DMA_RING_SIZE & (CMDS_RX_DMA_RING_SIZE - 1)) != 0) || (CMDS_RX_DMA_RING_SIZE > 32768)
+    #error "CMDS_RX_DMA_RING_SIZE must be a power of two, and at most 32768 (the DMA's largest ring)"
+#endif
+
+/** Mask to turn a free-running count of received bytes into an index into rx_dma_ring. */
+#define RX_DMA_RING_MASK (CMDS_RX_DMA_RING_SIZE - 1)
+
+/**
+ * The channel is restarted (at the end of a transaction) once it has fewer transfers than this left,
+ * long before it could run out.
+ */
+#define RX_DMA_RESTART_BELOW 0x80000000u
+
+/**
+ * @brief Where the DMA channel puts received bytes, wrapping around. Aligned to its size, which the
+ * DMA's ring wrap needs. The ISR moves each write transaction out of it (into cmd_ring) when it ends.
+ */
+static uint8_t CMDS_ISR_DATA(rx_dma_ring)[CMDS_RX_DMA_RING_SIZE] __attribute__((aligned(CMDS_RX_DMA_RING_SIZE)));
+
+/** The DMA channel draining the RX FIFO, or -1 if the ISR takes the bytes instead (see cmds_init()). */
+static int rx_dma_channel = -1;
+
+/** Free-running count of bytes the channel had received when it was last started. */
+static uint32_t rx_dma_base = 0;
+
+/** Free-running count of received bytes the ISR has moved out of rx_dma_ring. */
+static uint32_t rx_dma_taken = 0;
+
+/** Has the controller read from us since the last transaction ended? */
+static bool rx_dma_reading = false;
+
+/** Helper function for ISR. Free-running count of bytes the channel has received. */
+static inline uint32_t HOT_FUNC(_isr_dma_received)(void)
+{
+    return rx_dma_base + (0xFFFFFFFFu - dma_channel_hw_addr(rx_dma_channel)->transfer_count);
+}
+
+/** Start the channel, writing on from the given free-running count of received bytes. */
+static void HOT_FUNC(_rx_dma_start)(uint32_t received)
+{
+    rx_dma_base = received;
+    dma_channel_set_write_addr(rx_dma_channel, &rx_dma_ring[received & RX_DMA_RING_MASK], false);
+    dma_channel_set_trans_count(rx_dma_channel, 0xFFFFFFFFu, true);
+}
+
+/** Helper function for ISR. Move the write transaction that has arrived (if any) into the ring and publish it. */
+static void HOT_FUNC(_isr_dma_take_write)(i2c_hw_t *hw)
+{
+    // The channel empties the FIFO within a few cycles of a byte arriving.
+    while (hw->rxflr != 0)
+    {
+        tight_loop_contents();
+    }
+
+    const uint32_t received = _isr_dma_received();
+    const uint32_t len = received - rx_dma_taken;
+    if (len == 0)
+    {
+        return;
+    }
+
+    if (len > CMDS_RX_DMA_RING_SIZE)
+    {
+        // The start of it has been written over. Too long for a record anyway.
+        rx.active = true;
+        rx.select = false;
+        rx.dropped = true;
+        cmd_dropped_overflow++;
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+    }
+    else
+    {
+        const size_t index = rx_dma_taken & RX_DMA_RING_MASK;
+        const size_t first = ((CMDS_RX_DMA_RING_SIZE - index) < len) ? (CMDS_RX_DMA_RING_SIZE - index) : len;
+        _isr_receive(&rx_dma_ring[index], first);
+        _isr_receive(rx_dma_ring, len - first);
+    }
+    rx_dma_taken = received;
+    _isr_finish_record();
+
+    if (dma_channel_hw_addr(rx_dma_channel)->transfer_count < RX_DMA_RESTART_BELOW)
+    {
+        // Anything that arrives meanwhile waits in the FIFO
+        dma_channel_abort(rx_dma_channel);
+        _rx_dma_start(_isr_dma_received());
+    }
+}
+
+/**
+ * @brief Handler for the I2C interrupt when the DMA channel takes the received bytes. Only wakes
+ * for the end of a transaction (Stop, or a repeated start, when we're the one addressed) and for reads.
+ */
+static void HOT_FUNC(_i2c_dma_irq_handler)(void)
+{
+    i2c_hw_t *hw = i2c_get_hw(i2c0);
+    const uint32_t status = hw->intr_stat;
+    TRACE_BEGIN(TRACE_ID_I2C_ISR, status);
+
+    if (status & (I2C_IC_INTR_STAT_R_TX_ABRT_BITS | I2C_IC_INTR_STAT_R_RESTART_DET_BITS | I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+    {
+        // Reading these clears them
+        if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS)
+        {
+            (void)hw->clr_tx_abrt;
+        }
+        if (status & I2C_IC_INTR_STAT_R_RESTART_DET_BITS)
+        {
+            (void)hw->clr_restart_det;
+        }
+        if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS)
+        {
+            (void)hw->clr_stop_det;
+        }
+
+        if (rx_dma_reading)
+        {
+            rx_dma_reading = false;
+            _isr_finish_record();
+        }
+        _isr_dma_take_write(hw);
+    }
+
+    if (status & I2C_IC_INTR_STAT_R_RD_REQ_BITS)
+    {
+        if (!rx_dma_reading)
+        {
+            // A write just before this read has ended, whether or not we saw its repeated start.
+            _isr_dma_take_write(hw);
+            rx_dma_reading = true;
+        }
+        (void)hw->clr_rd_req;
+        _isr_send_bytes(i2c0);
+    }
+
+    TRACE_END(TRACE_ID_I2C_ISR, status);
+}
+
+/**
+ * Claim a DMA channel and make the I2C target (already given its speed) take writes through it.
+ * Returns false, leaving the I2C block alone, if there's no channel to spare.
+ */
+static bool _rx_dma_init(uint i2c_address)
+{
+    rx_dma_channel = dma_claim_unused_channel(false);
+    if (rx_dma_channel < 0)
+    {
+        return false;
+    }
+
+    // Byte reads from the data register pop the FIFO. Writes wrap around rx_dma_ring.
+    dma_channel_config c = dma_channel_get_default_config(rx_dma_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, __builtin_ctz(CMDS_RX_DMA_RING_SIZE));
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c0, false));
+    i2c_hw_t *hw = i2c_get_hw(i2c0);
+    dma_channel_configure(rx_dma_channel, &c, rx_dma_ring, &hw->data_cmd, 0, false);
+    _rx_dma_start(0);
+
+    i2c_set_slave_mode(i2c0, true, (uint8_t)i2c_address);
+
+    // Ask for DMA as soon as there's a byte in the FIFO, so none are left behind at the end of a transaction.
+    // Only wake for Stops meant for us, not for the other targets on the bus.
+    hw->enable = 0;
+    hw_set_bits(&hw->con, I2C_IC_CON_STOP_DET_IFADDRESSED_BITS);
+    hw->dma_rdlr = 0;
+    hw->dma_cr = I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->enable = 1;
+
+    hw->intr_mask = I2C_IC_INTR_MASK_M_RD_REQ_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS |
+                    I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_RESTART_DET_BITS;
+    irq_set_exclusive_handler(I2C0_IRQ, &_i2c_dma_irq_handler);
+    irq_set_enabled(I2C0_IRQ, true);
+    return true;
+}
+#endif // CMDS_I2C_RX_DMA && !CMDS_USE_CAN
+
+#if CMDS_USE_CAN
+/** The node that sent us the last command, which gets the responses. None until then. */
+static volatile uint8_t can_controller = RTACP_BROADCAST_ADDRESS;
+
+/** The priority it sent it at. */
+static volatile rtacp_priority_t can_priority = RTACP_PRIORITY_HIGH;
+
+/** Send register bytes to the controller, framed the way it frames commands: 0xC0 | len, then the bytes. */
+static void HOT_FUNC(_can_send_register)(const uint8_t *bytes, size_t len)
+{
+    const uint8_t controller = can_controller;
+    if (controller == RTACP_BROADCAST_ADDRESS)
+    {
+        return;
+    }
+
+    uint8_t msg[1 + CMDS_REGISTER_MAX_LEN];
+    msg[0] = (uint8_t)(CMDS_FRAME_HEADER | len);
+    memcpy(&msg[1], bytes, len);
+    rtacp_send(controller, can_priority, msg, 1 + len);
+}
+
+/**
+ * @brief Handler for RTACP messages (from the CAN controller's interrupt). Each message is
+ * a write transaction, except that a frame continues over as many messages as its header says.
+ */
+static void HOT_FUNC(_can_receive)(uint8_t sender, uint8_t target, rtacp_priority_t priority, const uint8_t *data, size_t len)
+{
+    if (rx.active && (sender != can_controller))
+    {
+        // Someone else cut into an unfinished frame. Finishing it now drops it as truncated.
+        _isr_finish_record();
+    }
+    can_controller = sender;
+    can_priority = priority;
+
+    _isr_receive(data, len);
+    if (rx.active && !rx.select && !rx.commit && (rx.expected != 0) && (rx.seen < rx.expected))
+    {
+        // The rest of the frame is in the messages to come
+        return;
+    }
+    _isr_finish_record();
+
+    if (snapshot_read_pending)
+    {
+        // There's no read to wait for. Answer the selection now.
+        _can_send_register(snapshot_bytes, snapshot_len);
+        snapshot_read_pending = false;
+    }
+}
+#endif // CMDS_USE_CAN
+
+void cmds_set_register_bytes(const uint8_t *bytes, size_t len)
+{
+    if (len > CMDS_REGISTER_MAX_LEN)
+    {
+        set_errno(ERR_ID_CMD_MODULE, EINVAL);
+        len = CMDS_REGISTER_MAX_LEN;
+    }
+
+    // Keep the ISR from sending half old, half new bytes.
+    uint32_t saved = save_and_disable_interrupts();
+    memcpy(register_bytes, bytes, len);
+    register_len = len;
+    register_read_pos = 0;
+    restore_interrupts(saved);
+
+#if CMDS_USE_CAN
+    // Nobody reads it over CAN. Send it.
+    _can_send_register(bytes, len);
+#endif // CMDS_USE_CAN
+}
+
+void cmds_register_write(uint8_t address, const uint8_t *bytes, size_t len)
 {
-    log_info("Init command module\n");
+    const size_t available = CMDS_REGISTER_MAP_LEN - address;
+    len = (len < available) ? len : available;
+    if (register_map_lock == NULL)
+    {
+        memcpy(&register_map[address], bytes, len);
+        return;
+    }
+
+    const uint32_t saved = spin_lock_blocking(register_map_lock);
+    memcpy(&register_map[address], bytes, len);
+    spin_unlock(register_map_lock, saved);
+}
+
+void cmds_register_write_u8(uint8_t address, uint8_t value)
+{
+    cmds_register_write(address, &value, 1);
+}
+
+void cmds_register_write_u16(uint8_t address, uint16_t value)
+{
+    const uint8_t bytes[2] = {
+        (uint8_t)(value & 0xFF),
+        (uint8_t)(value >> 8),
+    };
+    cmds_register_write(address, bytes, sizeof(bytes));
+}
+
+void cmds_register_write_u32(uint8_t address, uint32_t value)
+{
+    const uint8_t bytes[4] = {
+        (uint8_t)(value & 0xFF),
+        (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF),
+        (uint8_t)((value >> 24) & 0xFF),
+    };
+    cmds_register_write(address, bytes, sizeof(bytes));
+}
+
+void cmds_set_register_value(uint32_t value)
+{
+    const uint8_t bytes[4] = {
+        (uint8_t)(value & 0xFF),
+        (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF),
+        (uint8_t)((value >> 24) & 0xFF),
+    };
+    cmds_set_register_bytes(bytes, sizeof(bytes));
+}
+
+#if CMDS_USE_CAN
+void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin, cmds_i2c_speed_t speed)
+{
+    log_info("Init command module over CAN\n");
+
+    // Before the CAN interrupt can read the register map
+    register_map_lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    const mcp2515_config_t can = {
+        .spi = spi0,
+        .sck_pin = CAN_SCK_PIN,
+        .mosi_pin = CAN_MOSI_PIN,
+        .miso_pin = CAN_MISO_PIN,
+        .cs_pin = CAN_CS_PIN,
+        .int_pin = CAN_INT_PIN,
+        .spi_baudrate = CMDS_CAN_SPI_BAUDRATE,
+        .osc_hz = CMDS_CAN_OSC_HZ,
+        .bitrate = CMDS_CAN_BITRATE,
+    };
+    if (!rtacp_init((uint8_t)i2c_address, &can, &_can_receive))
+    {
+        log_error("CAN controller did not start\n");
+        set_errno(ERR_ID_CMD_MODULE, EINIT);
+    }
+}
+
+bool cmds_measure_isr_latency(uint32_t *cycles)
+{
+    // The CAN controller's interrupt is a GPIO one, shared with everything else on the bank
+    return false;
+}
+#else
+/** Derive the bus timings for the rate in context (a cmds_i2c_speed_t) from the system clock. */
+static void set_bus_timings(uint32_t sys_hz, void *context)
+{
+    // Even as a target, the baudrate matters: the SDK derives the SDA hold time
+    // and spike filter length from it and clk_sys.
+    i2c_set_baudrate(i2c0, (uint)(uintptr_t)context);
+}
+
+void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin, cmds_i2c_speed_t speed)
+{
+    log_info("Init command module at %u Hz\n", (uint)speed);
 
     // Initialize I2C
-    queue_init(&cmd_queue, sizeof(uint8_t), CMD_QUEUE_SIZE);
     gpio_init(I2C_SDA_PIN);
     gpio_init(I2C_SCL_PIN);
     gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C);
@@ -74,17 +960,199 @@ void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin)
     gpio_pull_up(I2C_SDA_PIN);
     gpio_pull_up(I2C_SCL_PIN);
 
-    i2c_init(i2c0, I2C_BAUDRATE);
+    if (speed > CMDS_I2C_SPEED_FAST)
+    {
+        // Fast-mode plus needs sharper SDA edges than the default pad settings give us.
+        gpio_set_slew_rate(I2C_SDA_PIN, GPIO_SLEW_RATE_FAST);
+        gpio_set_drive_strength(I2C_SDA_PIN, GPIO_DRIVE_STRENGTH_12MA);
+    }
+
+    // Before the ISR can read the register map
+    register_map_lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    i2c_init(i2c0, (uint)speed);
+    sysclock_register(&set_bus_timings, (void *)(uintptr_t)speed);
+#if CMDS_I2C_RX_DMA
+    if (!_rx_dma_init(i2c_address))
+    {
+        log_warning("No DMA channel for I2C; taking bytes in the ISR\n");
+        i2c_slave_init(i2c0, i2c_address, &_i2c_handler);
+    }
+#else
     i2c_slave_init(i2c0, i2c_address, &_i2c_handler);
+#endif // CMDS_I2C_RX_DMA
+
+    // If we can't drain the RX FIFO in time (another ISR is running, say),
+    // stretch the clock instead of dropping bytes. This can only be changed while the block is disabled.
+    // Nor answer general calls, which the block does out of reset, until the firmware asks to.
+    i2c_hw_t *hw = i2c_get_hw(i2c0);
+    hw->enable = 0;
+    hw_set_bits(&hw->con, I2C_IC_CON_RX_FIFO_FULL_HLD_CTRL_BITS);
+    hw->ack_general_call = 0;
+    hw->enable = 1;
+
+    // Drain the FIFO ahead of the LCD DMA and animation timers, which can run for a while.
+    irq_set_priority(I2C0_IRQ, PICO_HIGHEST_IRQ_PRIORITY);
+}
+
+/** SysTick's count when cmds_measure_isr_latency()'s probe ran, and whether it has. */
+static volatile uint32_t isr_probe_entered = 0;
+static volatile bool isr_probe_ran = false;
+
+/** Stands in for the I2C ISR while cmds_measure_isr_latency() times how soon it runs. */
+static void HOT_FUNC(_isr_probe)(void)
+{
+    isr_probe_entered = systick_hw->cvr;
+    isr_probe_ran = true;
+}
+
+bool cmds_measure_isr_latency(uint32_t *cycles)
+{
+    if (irq_get_exclusive_handler(I2C0_IRQ) != NULL)
+    {
+        log_error("The I2C ISR is already installed; measure its latency before cmds_init()\n");
+        return false;
+    }
+
+    // SysTick counts down in clk_sys cycles, and nothing else uses it
+    systick_hw->csr = 0;
+    systick_hw->rvr = M0PLUS_SYST_RVR_BITS;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    // From RAM at the ISR's priority, as the ISR runs, so this is what it waits too
+    isr_probe_ran = false;
+    irq_set_exclusive_handler(I2C0_IRQ, &_isr_probe);
+    irq_set_priority(I2C0_IRQ, PICO_HIGHEST_IRQ_PRIORITY);
+    irq_set_enabled(I2C0_IRQ, true);
+    const uint32_t raised = systick_hw->cvr;
+    irq_set_pending(I2C0_IRQ);
+    for (uint32_t spins = 0; !isr_probe_ran && (spins < 1000); spins++)
+    {
+        tight_loop_contents();
+    }
+
+    irq_set_enabled(I2C0_IRQ, false);
+    irq_remove_handler(I2C0_IRQ, &_isr_probe);
+    systick_hw->csr = 0;
+    if (!isr_probe_ran)
+    {
+        log_error("The I2C interrupt never ran\n");
+        return false;
+    }
+    *cycles = (raised - isr_probe_entered) & M0PLUS_SYST_RVR_BITS;
+    return true;
+}
+#endif // CMDS_USE_CAN
+
+void cmds_accept_general_call(bool accept)
+{
+#if !CMDS_USE_CAN
+    i2c_hw_t *hw = i2c_get_hw(i2c0);
+    hw->enable = 0;
+    hw->ack_general_call = accept ? 1 : 0;
+#if CMDS_I2C_RX_DMA
+    if (rx_dma_channel >= 0)
+    {
+        // The block doesn't count a general call as being addressed, so it would never report its Stop.
+        // Wake for every Stop on the bus instead; the ones for other targets find nothing to take.
+        if (accept)
+        {
+            hw_clear_bits(&hw->con, I2C_IC_CON_STOP_DET_IFADDRESSED_BITS);
+        }
+        else
+        {
+            hw_set_bits(&hw->con, I2C_IC_CON_STOP_DET_IFADDRESSED_BITS);
+        }
+    }
+#endif // CMDS_I2C_RX_DMA
+    hw->enable = 1;
+#endif // !CMDS_USE_CAN
+}
+
+void cmds_get_stats(cmds_stats_t *stats)
+{
+    stats->size = CMD_RING_SIZE;
+    stats->used = cmd_ring_head - cmd_ring_tail;
+    stats->high_water = cmd_ring_high_water;
+    stats->dropped_overflow = cmd_dropped_overflow;
+    stats->dropped_invalid = cmd_dropped_invalid;
+}
+
+bool cmds_available(void)
+{
+    return cmd_ring_tail != cmd_ring_head;
+}
+
+void cmds_wait_for_next(void)
+{
+    // If the ISR publishes between this check and the __wfe(), its __sev()
+    // has already set the event register, so the __wfe() returns immediately.
+    if (!cmds_available())
+    {
+        __wfe();
+    }
 }
 
 bool cmds_get_next(uint8_t *ret)
 {
-    uint32_t ret_as_uint32 = 0;
-    bool worked = queue_try_remove(&cmd_queue, &ret_as_uint32);
-    if (worked)
+    uint32_t tail = cmd_ring_tail;
+    if (tail == cmd_ring_head)
+    {
+        return false;
+    }
+
+    // Don't read the record until we've seen the head that published it.
+    __dmb();
+    if (cmd_record_remaining == 0)
     {
-        *ret = (uint8_t)ret_as_uint32;
+        // Start of a record: consume its length byte. Records are never empty.
+        cmd_record_remaining = cmd_ring[tail & CMD_RING_MASK];
+        tail++;
     }
-    return worked;
+
+    *ret = cmd_ring[tail & CMD_RING_MASK];
+    tail++;
+    cmd_record_remaining--;
+
+    // Finish reading before handing the space back to the ISR.
+    __dmb();
+    cmd_ring_tail = tail;
+    return true;
+}
+
+size_t cmds_get_next_frame(uint8_t *buf, size_t bufsize)
+{
+    uint32_t tail = cmd_ring_tail;
+    if (tail == cmd_ring_head)
+    {
+        return 0;
+    }
+
+    __dmb();
+    size_t len = cmd_record_remaining;
+    if (len == 0)
+    {
+        len = cmd_ring[tail & CMD_RING_MASK];
+        tail++;
+    }
+    cmd_record_remaining = 0;
+
+    if (len > bufsize)
+    {
+        // Caller can't hold it. Throw the whole record away rather than act on part of it.
+        set_errno(ERR_ID_CMD_MODULE, ENOMEM);
+        tail += len;
+        len = 0;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        buf[i] = cmd_ring[(tail + i) & CMD_RING_MASK];
+    }
+    tail += len;
+
+    __dmb();
+    cmd_ring_tail = tail;
+    return len;
 }
@@ -14,28 +14,307 @@ extern "C" {
 
 // Standard libraries
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 // SDK includes
 #include "pico/stdlib.h"
 
-/** Set the i2c register for reading. */
-void cmds_set_register_value(float value);
+/**
+ * A write transaction whose first byte has these two upper bits set is a frame:
+ * the lower six bits of that header byte give the number of command bytes that follow.
+ * The command route 0xC0 is not used by any module, so this can't be mistaken for a command.
+ */
+#define CMDS_FRAME_HEADER       0xC0
+
+/** Mask for detecting a frame header byte. */
+#define CMDS_FRAME_HEADER_MASK  0xC0
+
+/** The most command bytes a single frame can carry. */
+#define CMDS_FRAME_MAX_LEN      0x3F
+
+/** Extract the payload length from a frame header byte. */
+#define CMDS_FRAME_LENGTH(header) ((size_t)((header) & CMDS_FRAME_MAX_LEN))
+
+/**
+ * A frame whose first command byte is this is staged instead of queued: it is held, in place of
+ * any frame staged before it, until a CMDS_COMMIT arrives. The marker itself is not delivered.
+ * A staged frame with nothing after the marker just throws away the one that was waiting.
+ */
+#define CMDS_STAGE              CMDS_FRAME_HEADER
+
+/**
+ * A write of this byte on its own queues the staged frame, if there is one, as though it had just
+ * arrived. Sent as an I2C general call (to address 0x00), it reaches every target that accepts
+ * general calls (see cmds_accept_general_call()) in the same instant, so they all act on their
+ * staged frames together. Otherwise it would be a frame header for 62 commands with none after it.
+ */
+#define CMDS_COMMIT             (CMDS_FRAME_HEADER | (CMDS_FRAME_MAX_LEN - 1))
+
+/**
+ * A frame whose first command byte is this is scheduled: the next four bytes are the controller's
+ * time (see CMDS_CLOCK_SYNC) to act on it at, in microseconds, little-endian, and the commands follow.
+ * It is queued from an alarm at that time, as though it had just arrived. Only the low 32 bits of
+ * the time are sent, so it must be within 35 minutes of now; a time already past queues it now.
+ */
+#define CMDS_SCHEDULE           (CMDS_FRAME_HEADER | 0x01)
+
+/**
+ * A frame of this byte and eight more sets our idea of the controller's clock: the eight bytes are
+ * its time, in microseconds, little-endian, at the Stop that ends the write. Until the first one,
+ * the controller's clock is taken to be ours (microseconds since we booted). Frames already scheduled
+ * keep the time they were given.
+ */
+#define CMDS_CLOCK_SYNC         (CMDS_FRAME_HEADER | 0x02)
+
+#ifndef CMDS_SCHEDULE_SLOTS
+    /**
+     * How many scheduled frames (see CMDS_SCHEDULE) can wait at once. One more is dropped.
+     * Each one takes an alarm from the SDK's default alarm pool while it waits.
+     */
+    #define CMDS_SCHEDULE_SLOTS 4
+#endif // CMDS_SCHEDULE_SLOTS
+
+/** Supported I2C bus rates (in Hz). */
+typedef enum {
+    CMDS_I2C_SPEED_STANDARD    = 100 * 1000,     // Standard mode
+    CMDS_I2C_SPEED_FAST        = 400 * 1000,     // Fast mode
+    CMDS_I2C_SPEED_FAST_PLUS   = 1000 * 1000,    // Fast mode plus
+} cmds_i2c_speed_t;
+
+#ifndef CMDS_I2C_BAUDRATE
+    /** The bus rate to use if the build doesn't pick one. Must match the controller's bus. */
+    #define CMDS_I2C_BAUDRATE CMDS_I2C_SPEED_STANDARD
+#endif
+
+#ifndef CMDS_USE_CAN
+    /**
+     * Talk to the controller over CAN (RTACP, through an MCP2515 on spi0; see the rtacp library)
+     * instead of I2C. The commands, frames, and register map work the same way over either.
+     */
+    #define CMDS_USE_CAN 0
+#endif // CMDS_USE_CAN
+
+#ifndef CMDS_CAN_BITRATE
+    /** The CAN bus rate in bit/s, when built with CMDS_USE_CAN. Must match the rest of the bus. */
+    #define CMDS_CAN_BITRATE 500000
+#endif // CMDS_CAN_BITRATE
+
+#ifndef CMDS_CAN_OSC_HZ
+    /** The CAN controller's crystal, when built with CMDS_USE_CAN. */
+    #define CMDS_CAN_OSC_HZ 16000000
+#endif // CMDS_CAN_OSC_HZ
+
+#ifndef CMDS_CAN_SPI_BAUDRATE
+    /** The SPI clock to the CAN controller, when built with CMDS_USE_CAN. It takes up to 10 MHz. */
+    #define CMDS_CAN_SPI_BAUDRATE (8 * 1000 * 1000)
+#endif // CMDS_CAN_SPI_BAUDRATE
+
+#ifndef CMDS_RING_SIZE
+    /**
+     * Size of the queue of received commands in bytes. Must be a power of two.
+     * Each write transaction costs one byte plus its commands. See cmds_get_stats() for how full it gets.
+     */
+    #define CMDS_RING_SIZE 256
+#endif
+
+#ifndef CMDS_I2C_RX_DMA
+    /**
+     * Drain the I2C RX FIFO with a DMA channel instead of from the interrupt, so the interrupt only
+     * runs when a transaction ends (and for reads) rather than whenever the FIFO has bytes in it.
+     * Falls back to the interrupt if no DMA channel is free.
+     */
+    #define CMDS_I2C_RX_DMA 1
+#endif // CMDS_I2C_RX_DMA
+
+#ifndef CMDS_RX_DMA_RING_SIZE
+    /**
+     * Size of the ring the DMA channel writes received bytes into, when built with CMDS_I2C_RX_DMA.
+     * A power of two. Each write transaction is moved into the queue when it ends, so this only has to
+     * hold the longest one (a longer one is dropped).
+     */
+    #define CMDS_RX_DMA_RING_SIZE 512
+#endif // CMDS_RX_DMA_RING_SIZE
+
+/**
+ * A frame header with no commands after it selects a register instead: the byte after it
+ * (if any; CMDS_REG_STATUS if not) is a register address, and the read that follows
+ * (after a repeated start, or as the next transaction) starts there and carries on through
+ * the addresses after it. The I2C ISR answers it from a snapshot of the register map, taken
+ * when the address arrives, so a burst never mixes old and new values and never waits behind
+ * queued commands.
+ */
+#define CMDS_REGISTER_SELECT    CMDS_FRAME_HEADER
+
+/** Size of the register map. Register addresses are one byte. */
+#define CMDS_REGISTER_MAP_LEN   256
+
+/** Register address of our status (CMDS_STATUS_LEN bytes). The rest of the map belongs to the firmware. */
+#define CMDS_REG_STATUS         0x00
+
+/** First register address the firmware can use. */
+#define CMDS_REG_FIRMWARE_FIRST 0x08
+
+/**
+ * Size of the status register. Layout: status flags (CMDS_STATUS_*), free space in the queue
+ * (bytes, saturating at 255), high-water mark of the queue (2 bytes), then write transactions
+ * dropped since boot (2 bytes, saturating), all little-endian. Updated whenever it is selected.
+ */
+#define CMDS_STATUS_LEN         6
+
+/** Status flag: a full frame might not fit in the queue right now. Hold off. */
+#define CMDS_STATUS_BUSY        0x01
+
+/** Status flag: we have dropped a write transaction since the last status read. */
+#define CMDS_STATUS_DROPPED     0x02
+
+/** Status flag: a staged frame is waiting for its CMDS_COMMIT. */
+#define CMDS_STATUS_STAGED      0x04
+
+/** How the command queue has been doing. */
+typedef struct {
+    uint32_t size;              ///< CMDS_RING_SIZE
+    uint32_t used;              ///< Bytes queued right now
+    uint32_t high_water;        ///< Most bytes ever queued at once, counting a transaction still arriving
+    uint32_t dropped_overflow;  ///< Write transactions dropped because they didn't fit
+    uint32_t dropped_invalid;   ///< Frames dropped because their length didn't match their header
+} cmds_stats_t;
+
+/** The most bytes the controller can read back in one transaction. Reads past this get 0xFF. */
+#define CMDS_REGISTER_MAX_LEN 32
+
+/**
+ * @brief Write bytes into the register map, for the controller to read by address (see CMDS_REGISTER_SELECT).
+ * Safe from either core and from IRQs. Bytes past the end of the map are ignored.
+ *
+ * @param address Register address of the first byte.
+ * @param bytes The bytes. Copied.
+ * @param len How many.
+ */
+void cmds_register_write(uint8_t address, const uint8_t *bytes, size_t len);
+
+/** Write a byte into the register map. */
+void cmds_register_write_u8(uint8_t address, uint8_t value);
+
+/** Write a 16-bit value into the register map, little-endian. Signed values are written as their two's complement. */
+void cmds_register_write_u16(uint8_t address, uint16_t value);
+
+/** Write a 32-bit value into the register map, little-endian. Signed values are written as their two's complement. */
+void cmds_register_write_u32(uint8_t address, uint32_t value);
+
+/**
+ * Set the i2c register for reading. Values are raw integers (fixed-point where the source is);
+ * the controller does any conversion to floating point. The value is sent as four little-endian bytes.
+ */
+void cmds_set_register_value(uint32_t value);
+
+/**
+ * @brief Set the bytes the controller gets the next time it reads from us without selecting a register
+ * (the response to a command). Every such read starts from the first byte. Reads past `len` get 0xFF.
+ *
+ * @param bytes The bytes. Copied.
+ * @param len At most CMDS_REGISTER_MAX_LEN. Longer is truncated and sets errno.
+ */
+void cmds_set_register_bytes(const uint8_t *bytes, size_t len);
+
+/**
+ * @brief Get the command queue's statistics. The counts are since boot.
+ *
+ * @param stats Filled in.
+ */
+void cmds_get_stats(cmds_stats_t *stats);
 
 /**
  * @brief Initialize the command module.
  *
- * @param i2c_address The address of this MCU on the I2C bus.
+ * @param i2c_address The address of this MCU on the I2C bus. With CMDS_USE_CAN, our RTACP node address instead.
+ * @param sda_pin The I2C data pin.
+ * @param scl_pin The I2C clock pin.
+ * @param speed The rate the controller runs the bus at. Not used with CMDS_USE_CAN.
+ */
+void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin, cmds_i2c_speed_t speed);
+
+/**
+ * @brief Time how soon the command bus's interrupt runs once it's raised: raise it with a probe
+ * standing in for the ISR, from RAM and at its priority, and count the clk_sys cycles until the probe
+ * runs. Call before cmds_init(), while the probe can have the interrupt to itself.
+ *
+ * @param cycles Where to put the count.
+ * @return false with CMDS_USE_CAN, or if the interrupt is taken or never ran.
+ */
+bool cmds_measure_isr_latency(uint32_t *cycles);
+
+/**
+ * @brief Answer I2C general calls (writes to address 0x00) as well as our own address, so a
+ * CMDS_COMMIT sent that way reaches us. Off after cmds_init(), so targets that don't stage frames
+ * stay out of it. Call after cmds_init(), before the controller starts talking to us: the I2C block
+ * is briefly disabled. Does nothing with CMDS_USE_CAN, where a commit is sent to the broadcast address.
+ *
+ * @param accept Whether to answer general calls.
+ */
+void cmds_accept_general_call(bool accept);
+
+/**
+ * @brief Is there at least one received command waiting to be read?
+ * This does not block.
  */
-void cmds_init(uint i2c_address, uint sda_pin, uint scl_pin);
+bool cmds_available(void);
+
+/**
+ * @brief Sleep this core until there might be a command to read.
+ * Returns right away if there already is one. Otherwise waits (with `__wfe`)
+ * until the I2C ISR publishes a command or any other interrupt fires,
+ * so the caller should check for commands (and anything else it cares about,
+ * like new errors) after this returns.
+ */
+void cmds_wait_for_next(void);
 
 /**
  * @brief Get the next command from the queue of so-far received commands.
  * This does not block. If there is no command, we return false. Otherwise,
  * we return true and fill the pointer.
  *
+ * Commands from a frame are returned one at a time, in order.
+ *
  * @return bool True if a command was returned, otherwise false.
  */
 bool cmds_get_next(uint8_t *ret);
 
+/**
+ * @brief Get all the commands from the next received write transaction.
+ * This does not block. A frame is only made available once the whole
+ * transaction has arrived, so the commands in it can be acted on together.
+ * An unframed write comes back the same way, so a controller that sends
+ * one command per transaction gets one command per call.
+ *
+ * If part of a record was already taken with cmds_get_next(), this returns the rest of it.
+ * If the record does not fit in `bufsize` bytes, it is discarded, errno is set, and we return 0.
+ *
+ * @param buf Where to put the commands.
+ * @param bufsize Size of `buf`. CMDS_FRAME_MAX_LEN is always enough for a frame.
+ * @return size_t The number of commands written to `buf`, or 0 if there were none.
+ */
+size_t cmds_get_next_frame(uint8_t *buf, size_t bufsize);
+
+/** Acts on one command byte. It gets the whole byte, so it can take its argument from the low bits. */
+typedef void (*cmds_handler_t)(uint8_t command);
+
+/** A command table has an entry for every command byte, so routing one is a single lookup. */
+#define CMDS_TABLE_LEN 256
+
+/**
+ * Designates the entries of a command table for every byte that matches `base` under `mask`,
+ * which must be a run of high bits, e.g. `[CMDS_MATCHING(0x10, 0xF8)] = ...` for 0x10 to 0x17.
+ * Start the table with `[CMDS_MATCHING(0x00, 0x00)]` for the bytes nothing else claims.
+ */
+#define CMDS_MATCHING(base, mask) (base) ... ((base) | (uint8_t)~(mask))
+
+/**
+ * Put these around a command table's initializer, since its entries override the ones
+ * for the wider ranges before them, which -Wextra otherwise warns about.
+ */
+#define CMDS_TABLE_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Woverride-init\"")
+#define CMDS_TABLE_END   _Pragma("GCC diagnostic pop")
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,54 +1,693 @@
 // Stdlib
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+// Library includes
+#include <hotpaths.h>
 // Local includes
 #include "errors.h"
 
-#define CALL_LOG_FUNCTION() do { \
+#define CALL_LOG_FUNCTION(level) do { \
     va_list args; \
     va_start(args, str); \
-    logging_internal(str, args); \
+    logging_internal(level, str, args); \
     va_end(args); \
 } while (0)
 
-static void logging_internal(const char *str, va_list args)
+#if (ERR_HISTORY_LEN & (ERR_HISTORY_LEN - 1)) != 0
+    #error "ERR_HISTORY_LEN must be a power of two"
+#endif
+
+/**
+ * Guards the error history against the other core (and, since it masks them, our own IRQs).
+ * A striped lock is the SDK's lock for short critical sections like ours, and it needs
+ * neither claiming nor initializing, so errors can be set before anything else is up.
+ */
+#define ERR_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST)
+
+/** Errors counted per core, so each count has a single writer, and per module (see module_index()). */
+static volatile uint32_t error_counts[NUM_CORES][ERR_NUM_MODULES];
+
+/** The latest errors. error_history_head is a free-running count of errors set. */
+static err_record_t error_history[ERR_HISTORY_LEN];
+static uint32_t error_history_head = 0;
+
+#if !LOG_DEFERRED || LOG_STDIO
+/** What each message starts with, by loglevel_t. */
+static const char *const LOG_PREFIXES[] = {
+    [LOG_LEVEL_DEBUG] = "[DEBUG]: ",
+    [LOG_LEVEL_INFO] = "[INFO]: ",
+    [LOG_LEVEL_WARNING] = "[WARNING]: ",
+    [LOG_LEVEL_ERROR] = "[ERROR]: ",
+};
+#endif // !LOG_DEFERRED || LOG_STDIO
+
+#if LOG_DEFERRED
+#if (LOG_DEFERRED_BUFFER_LEN & (LOG_DEFERRED_BUFFER_LEN - 1)) != 0
+    #error "LOG_DEFERRED_BUFFER_LEN must be a power of two"
+#endif
+
+/** Longest conversion specification (like "%-08lX") we will print from a queued message. */
+#define LOG_SPEC_MAX_LEN 16
+
+/** What va_arg() type a conversion takes. */
+typedef enum {
+    LOG_ARG_NONE,           ///< "%%"
+    LOG_ARG_INT,            ///< Anything that promotes to (unsigned) int, including char and short
+    LOG_ARG_LONG,
+    LOG_ARG_LONG_LONG,      ///< Also intmax_t
+    LOG_ARG_SIZE,           ///< size_t and ptrdiff_t
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,        ///< %s and %p
+    LOG_ARG_UNSUPPORTED     ///< Anything else (like '*' widths or long double). Stops the capture.
+} log_arg_kind_t;
+
+/** One captured argument. */
+typedef union {
+    unsigned int i;
+    unsigned long l;
+    unsigned long long ll;
+    size_t z;
+    double d;
+    const void *p;
+} log_arg_t;
+
+/** One queued message. */
+typedef struct {
+    const char *str;
+    uint32_t timestamp_us;  ///< time_us_32() when it was logged
+    uint8_t level;          ///< loglevel_t
+    uint8_t nargs;          ///< Arguments captured. Conversions past these print as written.
+    log_arg_t args[LOG_DEFERRED_MAX_ARGS];
+} log_entry_t;
+
+/**
+ * Messages queued by one core. Only that core (with its interrupts masked, so they can't
+ * interleave with it) moves head, and only the main loop (log_flush() and log_pack()) moves
+ * tail, so neither needs a lock.
+ * head, tail, and dropped are free-running counts.
+ */
+typedef struct {
+    log_entry_t entries[LOG_DEFERRED_BUFFER_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;      ///< Messages that didn't fit. Written by the queueing core.
+    uint32_t dropped_reported;      ///< How many of those log_flush() or log_pack() has reported.
+} log_ring_t;
+
+static log_ring_t log_rings[NUM_CORES];
+
+/**
+ * @brief Find the next conversion specification in a format string.
+ *
+ * @param str Where to start looking.
+ * @param kind Set to the type of argument the conversion takes.
+ * @param end Set to just past the conversion.
+ * @return const char* Its '%', or the terminator if there are no more.
+ */
+static const char *next_conversion(const char *str, log_arg_kind_t *kind, const char **end)
+{
+    const char *pct = strchr(str, '%');
+    if (pct == NULL)
+    {
+        pct = str + strlen(str);
+        *end = pct;
+        return pct;
+    }
+
+    const char *s = pct + 1;
+    while ((*s != '\0') && (strchr("-+ #0123456789.", *s) != NULL))
+    {
+        s++;
+    }
+
+    log_arg_kind_t length = LOG_ARG_INT;
+    switch (*s)
+    {
+        case 'h':
+            s += (s[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            length = (s[1] == 'l') ? LOG_ARG_LONG_LONG : LOG_ARG_LONG;
+            s += (s[1] == 'l') ? 2 : 1;
+            break;
+        case 'j':
+            length = LOG_ARG_LONG_LONG;
+            s++;
+            break;
+        case 'z':
+        case 't':
+            length = LOG_ARG_SIZE;
+            s++;
+            break;
+        default:
+            break;
+    }
+
+    switch (*s)
+    {
+        case '%':
+            *kind = LOG_ARG_NONE;
+            break;
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+            *kind = length;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            *kind = LOG_ARG_DOUBLE;
+            break;
+        case 's':
+        case 'p':
+            *kind = LOG_ARG_POINTER;
+            break;
+        case '\0':
+            *kind = LOG_ARG_UNSUPPORTED;
+            *end = s;
+            return pct;
+        default:
+            *kind = LOG_ARG_UNSUPPORTED;
+            break;
+    }
+
+    *end = s + 1;
+    return pct;
+}
+
+/** Pull the arguments for str's conversions out of args, as many as fit. */
+static void capture_args(log_entry_t *entry, const char *str, va_list args)
+{
+    entry->nargs = 0;
+    const char *s = str;
+    while (entry->nargs < LOG_DEFERRED_MAX_ARGS)
+    {
+        log_arg_kind_t kind;
+        const char *end;
+        const char *pct = next_conversion(s, &kind, &end);
+        if ((*pct == '\0') || (kind == LOG_ARG_UNSUPPORTED))
+        {
+            return;
+        }
+
+        log_arg_t *arg = &entry->args[entry->nargs];
+        switch (kind)
+        {
+            case LOG_ARG_INT:
+                arg->i = va_arg(args, unsigned int);
+                break;
+            case LOG_ARG_LONG:
+                arg->l = va_arg(args, unsigned long);
+                break;
+            case LOG_ARG_LONG_LONG:
+                arg->ll = va_arg(args, unsigned long long);
+                break;
+            case LOG_ARG_SIZE:
+                arg->z = va_arg(args, size_t);
+                break;
+            case LOG_ARG_DOUBLE:
+                arg->d = va_arg(args, double);
+                break;
+            case LOG_ARG_POINTER:
+                arg->p = va_arg(args, const void *);
+                break;
+            default:
+                break;
+        }
+
+        if (kind != LOG_ARG_NONE)
+        {
+            entry->nargs++;
+        }
+        s = end;
+    }
+}
+
+/** Queue a message on this core's ring. */
+static void log_deferred(loglevel_t level, const char *str, va_list args)
+{
+    // Capture outside the critical section, so it only lasts as long as the copy
+    log_entry_t entry;
+    entry.str = str;
+    entry.timestamp_us = time_us_32();
+    entry.level = (uint8_t)level;
+    capture_args(&entry, str, args);
+
+    log_ring_t *ring = &log_rings[get_core_num()];
+    const uint32_t saved = save_and_disable_interrupts();
+    const uint32_t head = ring->head;
+    if ((head - ring->tail) >= LOG_DEFERRED_BUFFER_LEN)
+    {
+        ring->dropped++;
+        restore_interrupts(saved);
+        return;
+    }
+    ring->entries[head & (LOG_DEFERRED_BUFFER_LEN - 1)] = entry;
+
+    // The entry must be visible to the other core before the head that publishes it
+    __dmb();
+    ring->head = head + 1;
+    restore_interrupts(saved);
+
+    // Wake the main loop if it is waiting for commands, so it gets to log_flush()
+    __sev();
+}
+
+/** Messages a ring has dropped that haven't been reported yet. Counts them as reported. */
+static uint32_t take_dropped(log_ring_t *ring)
+{
+    const uint32_t dropped = ring->dropped;
+    const uint32_t unreported = dropped - ring->dropped_reported;
+    ring->dropped_reported = dropped;
+    return unreported;
+}
+
+#if LOG_STDIO
+/** Print a queued message, one conversion at a time. */
+static void print_entry(const log_entry_t *entry)
+{
+    printf("%s", LOG_PREFIXES[entry->level]);
+
+    uint8_t nargs = 0;
+    const char *s = entry->str;
+    while (true)
+    {
+        log_arg_kind_t kind;
+        const char *end;
+        const char *pct = next_conversion(s, &kind, &end);
+        printf("%.*s", (int)(pct - s), s);
+        if (*pct == '\0')
+        {
+            return;
+        }
+
+        if (kind == LOG_ARG_NONE)
+        {
+            printf("%%");
+            s = end;
+            continue;
+        }
+
+        char spec[LOG_SPEC_MAX_LEN];
+        const size_t speclen = (size_t)(end - pct);
+        if ((kind == LOG_ARG_UNSUPPORTED) || (nargs >= entry->nargs) || (speclen >= sizeof(spec)))
+        {
+            // Nothing captured for it, so print the rest as written
+            printf("%s", pct);
+            return;
+        }
+        memcpy(spec, pct, speclen);
+        spec[speclen] = '\0';
+
+        const log_arg_t *arg = &entry->args[nargs++];
+        switch (kind)
+        {
+            case LOG_ARG_INT:
+                printf(spec, arg->i);
+                break;
+            case LOG_ARG_LONG:
+                printf(spec, arg->l);
+                break;
+            case LOG_ARG_LONG_LONG:
+                printf(spec, arg->ll);
+                break;
+            case LOG_ARG_SIZE:
+                printf(spec, arg->z);
+                break;
+            case LOG_ARG_DOUBLE:
+                printf(spec, arg->d);
+                break;
+            case LOG_ARG_POINTER:
+                printf(spec, arg->p);
+                break;
+            default:
+                break;
+        }
+        s = end;
+    }
+}
+
+void log_flush(void)
+{
+    for (uint core = 0; core < NUM_CORES; core++)
+    {
+        log_ring_t *ring = &log_rings[core];
+        uint32_t tail = ring->tail;
+        while (tail != ring->head)
+        {
+            // Don't read the entry until we've seen the head that published it
+            __dmb();
+            print_entry(&ring->entries[tail & (LOG_DEFERRED_BUFFER_LEN - 1)]);
+            tail++;
+
+            // And finish reading it before handing the slot back
+            __dmb();
+            ring->tail = tail;
+        }
+
+        const uint32_t dropped = take_dropped(ring);
+        if (dropped > 0)
+        {
+            printf("%sDropped %lu log messages from core %u.\n", LOG_PREFIXES[LOG_LEVEL_WARNING],
+                   (unsigned long)dropped, core);
+        }
+    }
+}
+#else
+void log_flush(void)
+{
+    // The messages wait for log_pack()
+}
+#endif // LOG_STDIO
+
+/** Write the low len bytes of value, little-endian. */
+static uint8_t *pack_le(uint8_t *out, uint64_t value, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+    return out + len;
+}
+
+/**
+ * @brief Pack a queued message's arguments, as many as fit, at the sizes they have on the board.
+ *
+ * @param entry The message.
+ * @param out Where to put them.
+ * @param room How many bytes fit there.
+ * @param complete Set to whether all of them fit.
+ * @return size_t Number of bytes written.
+ */
+static size_t pack_args(const log_entry_t *entry, uint8_t *out, size_t room, bool *complete)
+{
+    uint8_t *pos = out;
+    uint8_t nargs = 0;
+    const char *s = entry->str;
+    *complete = true;
+    while (nargs < entry->nargs)
+    {
+        // The same conversions capture_args() took them for
+        log_arg_kind_t kind;
+        const char *end;
+        next_conversion(s, &kind, &end);
+        s = end;
+        if (kind == LOG_ARG_NONE)
+        {
+            continue;
+        }
+
+        const size_t arglen = ((kind == LOG_ARG_LONG_LONG) || (kind == LOG_ARG_DOUBLE)) ? 8 : 4;
+        if ((size_t)(pos - out) + arglen > room)
+        {
+            *complete = false;
+            break;
+        }
+
+        const log_arg_t *arg = &entry->args[nargs++];
+        uint64_t value = 0;
+        switch (kind)
+        {
+            case LOG_ARG_INT:
+                value = arg->i;
+                break;
+            case LOG_ARG_LONG:
+                value = arg->l;
+                break;
+            case LOG_ARG_LONG_LONG:
+                value = arg->ll;
+                break;
+            case LOG_ARG_SIZE:
+                value = arg->z;
+                break;
+            case LOG_ARG_DOUBLE:
+                memcpy(&value, &arg->d, sizeof(value));
+                break;
+            case LOG_ARG_POINTER:
+                value = (uintptr_t)arg->p;
+                break;
+            default:
+                break;
+        }
+        pos = pack_le(pos, value, arglen);
+    }
+    return (size_t)(pos - out);
+}
+
+/** Which core's ring holds the oldest queued message, or -1 if neither has any. */
+static int oldest_ring(void)
+{
+    int oldest = -1;
+    uint32_t oldest_us = 0;
+    for (uint core = 0; core < NUM_CORES; core++)
+    {
+        const log_ring_t *ring = &log_rings[core];
+        const uint32_t tail = ring->tail;
+        if (tail == ring->head)
+        {
+            continue;
+        }
+
+        // Don't read the entry until we've seen the head that published it
+        __dmb();
+
+        // Both cores stamp with the same timer, so their stamps compare (across its wrap, too)
+        const uint32_t timestamp_us = ring->entries[tail & (LOG_DEFERRED_BUFFER_LEN - 1)].timestamp_us;
+        if ((oldest < 0) || ((int32_t)(timestamp_us - oldest_us) < 0))
+        {
+            oldest = (int)core;
+            oldest_us = timestamp_us;
+        }
+    }
+    return oldest;
+}
+
+size_t log_pack(uint8_t *buf, size_t len)
+{
+    if (len < LOG_PACKED_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    uint32_t dropped = 0;
+    for (uint core = 0; core < NUM_CORES; core++)
+    {
+        dropped += take_dropped(&log_rings[core]);
+    }
+
+    uint8_t count = 0;
+    size_t pos = LOG_PACKED_HEADER_LEN;
+    while ((count < 0xFF) && ((pos + LOG_PACKED_RECORD_LEN) <= len))
+    {
+        const int core = oldest_ring();
+        if (core < 0)
+        {
+            break;
+        }
+
+        log_ring_t *ring = &log_rings[core];
+        const log_entry_t *entry = &ring->entries[ring->tail & (LOG_DEFERRED_BUFFER_LEN - 1)];
+        uint8_t *record = buf + pos;
+        bool complete;
+        const size_t arglen = pack_args(entry, record + LOG_PACKED_RECORD_LEN, len - pos - LOG_PACKED_RECORD_LEN, &complete);
+        if (!complete && (count > 0))
+        {
+            // Leave it whole for the next call
+            break;
+        }
+
+        pack_le(record, entry->timestamp_us, 4);
+        pack_le(record + 4, (uintptr_t)entry->str, 4);
+        record[8] = (uint8_t)(entry->level | ((core != 0) ? LOG_PACKED_FLAG_CORE1 : 0));
+        record[9] = (uint8_t)arglen;
+        pos += LOG_PACKED_RECORD_LEN + arglen;
+        count++;
+
+        // Finish reading it before handing the slot back
+        __dmb();
+        ring->tail++;
+    }
+
+    buf[0] = count;
+    buf[1] = (dropped > 0xFF) ? 0xFF : (uint8_t)dropped;
+    return pos;
+}
+#else
+void log_flush(void)
+{
+}
+
+size_t log_pack(uint8_t *buf, size_t len)
+{
+    if (len < LOG_PACKED_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    // Nothing is queued
+    buf[0] = 0;
+    buf[1] = 0;
+    return LOG_PACKED_HEADER_LEN;
+}
+#endif // LOG_DEFERRED
+
+static void logging_internal(loglevel_t level, const char *str, va_list args)
 {
-    printf(str, args);
+#if LOG_DEFERRED
+    log_deferred(level, str, args);
+#else
+    printf("%s", LOG_PREFIXES[level]);
+    vprintf(str, args);
+#endif // LOG_DEFERRED
 }
 
 void log_debug(const char *str, ...)
 {
     #if LOG_LEVEL == LOG_LEVEL_DEBUG
-    printf("[DEBUG]: ");
-    CALL_LOG_FUNCTION();
+    CALL_LOG_FUNCTION(LOG_LEVEL_DEBUG);
     #endif // if LOG_LEVEL
 }
 
 void log_info(const char *str, ...)
 {
     #if LOG_LEVEL <= LOG_LEVEL_INFO
-    printf("[INFO]: ");
-    CALL_LOG_FUNCTION();
+    CALL_LOG_FUNCTION(LOG_LEVEL_INFO);
     #endif // if LOG_LEVEL
 }
 
 void log_warning(const char *str, ...)
 {
     #if LOG_LEVEL <= LOG_LEVEL_WARNING
-    printf("[WARNING]: ");
-    CALL_LOG_FUNCTION();
+    CALL_LOG_FUNCTION(LOG_LEVEL_WARNING);
     #endif // if LOG_LEVEL
 }
 
 void log_error(const char *str, ...)
 {
     #if LOG_LEVEL <= LOG_LEVEL_ERROR
-    printf("[ERROR]: ");
-    CALL_LOG_FUNCTION();
+    CALL_LOG_FUNCTION(LOG_LEVEL_ERROR);
     #endif // if LOG_LEVEL
 }
 
-void set_errno(err_module_id_t module_id, err_t error)
+/** Which of the counts a module's errors go in, or -1 if it doesn't have one. */
+static int module_index(err_module_id_t module_id)
 {
-    errno = module_id | error;
+    const int index = (int)(module_id >> 8) - 1;
+    return ((index >= 0) && (index < ERR_NUM_MODULES)) ? index : -1;
+}
+
+void HOT_FUNC(set_errno)(err_module_id_t module_id, err_t error)
+{
+    const uint core = get_core_num();
+    const int index = module_index(module_id);
+    const uint32_t saved = spin_lock_blocking(ERR_LOCK);
+    if (index >= 0)
+    {
+        error_counts[core][index]++;
+    }
+    err_record_t *record = &error_history[error_history_head & (ERR_HISTORY_LEN - 1)];
+    record->timestamp_us = time_us_32();
+    record->code = (uint16_t)(module_id | error);
+    record->core = (uint8_t)core;
+    error_history_head++;
+    spin_unlock(ERR_LOCK, saved);
+
+    // Wake the main loop if it is waiting for commands, so it reports the error now
+    __sev();
+}
+
+uint32_t errors_get_count(err_module_id_t module_id)
+{
+    const int index = module_index(module_id);
+    if (index < 0)
+    {
+        return 0;
+    }
+
+    // Each core only ever adds to its own count, and a word read can't tear, so no lock
+    uint32_t count = 0;
+    for (uint core = 0; core < NUM_CORES; core++)
+    {
+        count += error_counts[core][index];
+    }
+    return count;
+}
+
+bool errors_get_next(uint32_t *cursor, err_record_t *record, uint32_t *missed)
+{
+    const uint32_t saved = spin_lock_blocking(ERR_LOCK);
+    const uint32_t head = error_history_head;
+    *missed = 0;
+    if ((head - *cursor) > ERR_HISTORY_LEN)
+    {
+        // Overwritten before the caller got to them
+        *missed = (head - ERR_HISTORY_LEN) - *cursor;
+        *cursor = head - ERR_HISTORY_LEN;
+    }
+    const bool available = *cursor != head;
+    if (available)
+    {
+        *record = error_history[*cursor & (ERR_HISTORY_LEN - 1)];
+        (*cursor)++;
+    }
+    spin_unlock(ERR_LOCK, saved);
+    return available;
+}
+
+size_t errors_pack(uint8_t *buf, size_t len)
+{
+    const size_t header_len = 1 + (2 * ERR_NUM_MODULES);
+    if (len < header_len)
+    {
+        return 0;
+    }
+
+    size_t pos = 1;
+    for (int index = 0; index < ERR_NUM_MODULES; index++)
+    {
+        const uint32_t count = errors_get_count((err_module_id_t)((index + 1) << 8));
+        const uint16_t saturated = (count > 0xFFFF) ? 0xFFFF : (uint16_t)count;
+        buf[pos++] = (uint8_t)(saturated & 0xFF);
+        buf[pos++] = (uint8_t)(saturated >> 8);
+    }
+
+    // Copy out the newest ones that fit, then pack them without holding the lock
+    err_record_t records[ERR_HISTORY_LEN];
+    size_t nrecords = (len - header_len) / ERR_PACKED_RECORD_LEN;
+    uint32_t saved = spin_lock_blocking(ERR_LOCK);
+    const uint32_t head = error_history_head;
+    const uint32_t available = (head < ERR_HISTORY_LEN) ? head : ERR_HISTORY_LEN;
+    nrecords = (nrecords < available) ? nrecords : available;
+    for (size_t i = 0; i < nrecords; i++)
+    {
+        records[i] = error_history[(head - 1 - i) & (ERR_HISTORY_LEN - 1)];
+    }
+    spin_unlock(ERR_LOCK, saved);
+
+    for (size_t i = 0; i < nrecords; i++)
+    {
+        const err_record_t *r = &records[i];
+        buf[pos++] = (uint8_t)(r->timestamp_us & 0xFF);
+        buf[pos++] = (uint8_t)((r->timestamp_us >> 8) & 0xFF);
+        buf[pos++] = (uint8_t)((r->timestamp_us >> 16) & 0xFF);
+        buf[pos++] = (uint8_t)((r->timestamp_us >> 24) & 0xFF);
+        buf[pos++] = (uint8_t)(r->code & 0xFF);
+        buf[pos++] = (uint8_t)(r->code >> 8);
+        buf[pos++] = r->core;
+    }
+    buf[0] = (uint8_t)nrecords;
+    return pos;
 }
@@ -2,6 +2,9 @@
  * @file errors.h
  * @brief Error byte and associated enum.
  *
+ * Errors are counted per module and kept in a short, timestamped history rather
+ * than in a single errno, so they aren't lost when they come in bursts or from
+ * both cores at once.
  */
 #pragma once
 
@@ -9,6 +12,10 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 /** Allowed errors. */
 typedef enum {
     EPERM   = 0x0001,      // Operation not permitted
@@ -16,12 +23,15 @@ typedef enum {
     EINTR   = 0x0004,      // Interrupted
     EIO     = 0x0005,      // I/O Error
     ENXIO   = 0x0006,      // No such device or address
+    E2BIG   = 0x0007,      // Argument list too long
+    ENOEXEC = 0x0008,      // Exec format error
     EAGAIN  = 0x000B,      // Try again
     ENOMEM  = 0x000C,      // Out of memory
     EBUSY   = 0x0010,      // Resource is busy
     EINVAL  = 0x0016,      // Invalid argument
     ENODATA = 0x003D,      // No data available
     ETIME   = 0x003E,      // Timer expired
+    EALREADY = 0x0072,     // Operation already in progress
 
                            // Nonstandard errors below
     EINIT   = 0x00F0,      // Module failed to initialize
@@ -34,9 +44,31 @@ typedef enum {
     ERR_ID_LEDS_MODULE     = 0x0200,
     ERR_ID_GRAPHICS_MODULE = 0x0300,
     ERR_ID_SERVO_MODULE    = 0x0400,
+    ERR_ID_CAN_MODULE      = 0x0500,
+    ERR_ID_SETTINGS_MODULE = 0x0600,
+    ERR_ID_GPIOIRQ_MODULE  = 0x0700,
+    ERR_ID_ARENA_MODULE    = 0x0800,
     UNUSED_ID_MODULE       = 0xFFFF     // For sizing the enum type
 } err_module_id_t;
 
+/** Number of modules in err_module_id_t, each of which gets its own error count. */
+#define ERR_NUM_MODULES 8
+
+#ifndef ERR_HISTORY_LEN
+    /** Number of the most recent errors kept with their timestamps. Must be a power of two. */
+    #define ERR_HISTORY_LEN 16
+#endif // ERR_HISTORY_LEN
+
+/** One error, as recorded by set_errno(). */
+typedef struct {
+    uint32_t timestamp_us;  ///< time_us_32() when it was set
+    uint16_t code;          ///< err_module_id_t | err_t
+    uint8_t core;           ///< Which core set it
+} err_record_t;
+
+/** Size of each record packed by errors_pack(). */
+#define ERR_PACKED_RECORD_LEN 7
+
 /** Allowed logging levels. */
 typedef enum {
     LOG_LEVEL_DEBUG = 0,
@@ -50,7 +82,42 @@ typedef enum {
     #define LOG_LEVEL INFO
 #endif
 
-extern err_t errno;
+#ifndef LOG_DEFERRED
+    /**
+     * If nonzero, the log functions don't print. They queue the format string and
+     * arguments for log_flush() to print later, so logging costs the caller about
+     * as much as a memcpy. Format strings must be string literals, and any %s
+     * argument must still be valid when log_flush() runs.
+     */
+    #define LOG_DEFERRED 0
+#endif // LOG_DEFERRED
+
+#ifndef LOG_DEFERRED_BUFFER_LEN
+    /** Number of queued messages each core holds. Must be a power of two. Once full, new messages are dropped and counted. */
+    #define LOG_DEFERRED_BUFFER_LEN 16
+#endif // LOG_DEFERRED_BUFFER_LEN
+
+#ifndef LOG_DEFERRED_MAX_ARGS
+    /** Most arguments a queued message keeps. Any conversions past these print as they are written in the format string. */
+    #define LOG_DEFERRED_MAX_ARGS 4
+#endif // LOG_DEFERRED_MAX_ARGS
+
+#ifndef LOG_STDIO
+    /**
+     * If zero, log_flush() doesn't print the queued messages. They stay queued for log_pack()
+     * to take out over the command bus instead. Only used with LOG_DEFERRED.
+     */
+    #define LOG_STDIO 1
+#endif // LOG_STDIO
+
+/** Size of the header log_pack() writes. */
+#define LOG_PACKED_HEADER_LEN 2
+
+/** Size of each message packed by log_pack(), before its arguments. */
+#define LOG_PACKED_RECORD_LEN 10
+
+/** Set in a packed message's flags if it was logged on core 1. Its loglevel_t is in the two bits below. */
+#define LOG_PACKED_FLAG_CORE1 0x04
 
 /** Debug logging. */
 void log_debug(const char *str, ...);
@@ -64,9 +131,62 @@ void log_warning(const char *str, ...);
 /** Error logging. */
 void log_error(const char *str, ...);
 
-/** Set the errno from a particular subsystem. */
+/**
+ * @brief Print the messages the log functions have queued on either core, oldest first
+ * (one core's messages, then the other's). Does nothing unless built with LOG_DEFERRED and LOG_STDIO.
+ * Call it from one place only: the main loop, when it has nothing else to do.
+ */
+void log_flush(void);
+
+/**
+ * @brief Take the oldest queued messages, from both cores in the order they were logged, and pack
+ * them for the command bus unformatted: the controller formats them with the firmware's ELF.
+ * Layout: number of messages (1 byte), messages dropped since the last call (1 byte, saturating),
+ * then each message as timestamp_us (4 bytes), the address of its format string (4 bytes),
+ * flags (1 byte: its loglevel_t | LOG_PACKED_FLAG_CORE1), and the length of its arguments
+ * (1 byte), followed by the arguments, in order: 8 bytes for a long long, intmax_t, or double
+ * conversion, and 4 bytes for any other. All little-endian. A message whose arguments don't fit
+ * in an empty buf keeps those that do, and the rest print as written.
+ * Only writes the header unless built with LOG_DEFERRED. Call it from the same place as log_flush().
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least LOG_PACKED_HEADER_LEN + LOG_PACKED_RECORD_LEN to fit any.
+ * @return size_t Number of bytes written.
+ */
+size_t log_pack(uint8_t *buf, size_t len);
+
+/**
+ * @brief Report an error from a particular subsystem: count it against the module and
+ * add it to the error history. Safe from either core and from IRQs.
+ */
 void set_errno(err_module_id_t module_id, err_t error);
 
+/** Number of errors the given module has reported since boot, from both cores. */
+uint32_t errors_get_count(err_module_id_t module_id);
+
+/**
+ * @brief Read the error history in order, without taking anything out of it.
+ * Start with *cursor at 0 and keep passing the same cursor back.
+ *
+ * @param cursor Where the caller is up to. Advanced past the record we return.
+ * @param record Set to the next error, if there is one.
+ * @param missed Set to the number of errors that fell out of the history before the caller got to them.
+ * @return true if we found another error.
+ */
+bool errors_get_next(uint32_t *cursor, err_record_t *record, uint32_t *missed);
+
+/**
+ * @brief Pack the error counts and the latest errors for the command bus.
+ * Layout: number of records (1 byte), each module's count (ERR_NUM_MODULES x 2 bytes,
+ * saturating, in err_module_id_t order), then the records, newest first, each as
+ * timestamp_us (4 bytes), code (2 bytes), core (1 byte), all little-endian.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. Fits (len - 1 - 2 * ERR_NUM_MODULES) / ERR_PACKED_RECORD_LEN records.
+ * @return size_t Number of bytes written.
+ */
+size_t errors_pack(uint8_t *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,137 @@
+/**
+ * @file fixmath.h
+ * @brief Fixed-point math, for MCUs with no FPU.
+ * Q15 (int16_t, [-1, 1)) and Q16.16 (int32_t) values with saturating arithmetic, plus the integer
+ * square root and table-driven sine and cosine. The arithmetic is all inline, so it can be used from
+ * functions kept in RAM without a call into flash.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** A Q15 value: [-1, 1) in steps of 2**-15. */
+typedef int16_t q15_t;
+
+/** A Q16.16 value: [-32768, 32768) in steps of 2**-16. */
+typedef int32_t q16_t;
+
+#define Q15_MAX     ((q15_t)INT16_MAX)
+#define Q15_MIN     ((q15_t)INT16_MIN)
+#define Q16_ONE     ((q16_t)1 << 16)
+#define Q16_MAX     ((q16_t)INT32_MAX)
+#define Q16_MIN     ((q16_t)INT32_MIN)
+
+/** A constant in Q16.16, rounded. For constant `x`, folds to an integer (no float math at run time). */
+#define Q16_CONST(x) ((q16_t)(((x) * 65536.0) + (((x) >= 0) ? 0.5 : -0.5)))
+
+/** A constant in Q15, rounded. Same as Q16_CONST(). */
+#define Q15_CONST(x) ((q15_t)(((x) * 32768.0) + (((x) >= 0) ? 0.5 : -0.5)))
+
+/** Clamp to Q15. */
+static inline q15_t q15_sat(int32_t v)
+{
+    return (v > INT16_MAX) ? Q15_MAX : ((v < INT16_MIN) ? Q15_MIN : (q15_t)v);
+}
+
+static inline q15_t q15_add(q15_t a, q15_t b)
+{
+    return q15_sat((int32_t)a + b);
+}
+
+static inline q15_t q15_sub(q15_t a, q15_t b)
+{
+    return q15_sat((int32_t)a - b);
+}
+
+/** Rounded. Only -1 * -1 saturates. */
+static inline q15_t q15_mul(q15_t a, q15_t b)
+{
+    return q15_sat((((int32_t)a * b) + (1 << 14)) >> 15);
+}
+
+/** Clamp to Q16.16. */
+static inline q16_t q16_sat(int64_t v)
+{
+    return (v > INT32_MAX) ? Q16_MAX : ((v < INT32_MIN) ? Q16_MIN : (q16_t)v);
+}
+
+static inline q16_t q16_add(q16_t a, q16_t b)
+{
+    return q16_sat((int64_t)a + b);
+}
+
+static inline q16_t q16_sub(q16_t a, q16_t b)
+{
+    return q16_sat((int64_t)a - b);
+}
+
+/** Rounded. */
+static inline q16_t q16_mul(q16_t a, q16_t b)
+{
+    return q16_sat((((int64_t)a * b) + (1 << 15)) >> 16);
+}
+
+/** Truncated toward zero. Dividing by zero saturates, to the sign of a. */
+static inline q16_t q16_div(q16_t a, q16_t b)
+{
+    if (b == 0)
+    {
+        return (a < 0) ? Q16_MIN : Q16_MAX;
+    }
+    return q16_sat(((int64_t)a * 65536) / b);
+}
+
+static inline q16_t q16_from_int(int32_t i)
+{
+    return q16_sat((int64_t)i * 65536);
+}
+
+/** Rounded to the nearest integer (halves away from zero). */
+static inline int32_t q16_to_int(q16_t a)
+{
+    return (a >= 0) ? (int32_t)(((int64_t)a + (1 << 15)) >> 16) : -(int32_t)(((-(int64_t)a) + (1 << 15)) >> 16);
+}
+
+/** Multiply two unsigned Q16 fractions ([0, 1], with 1 as 65536), truncated. */
+static inline uint32_t uq16_mul(uint32_t a, uint32_t b)
+{
+    return (uint32_t)(((uint64_t)a * b) >> 16);
+}
+
+/**
+ * S-curve (smoothstep) in Q16: 3u^2 - 2u^3 for u in [0, 1] (1 is 65536).
+ * Starts and ends at rest, so there's no step in velocity at either end of a move along it.
+ */
+static inline uint32_t fix_smoothstep_q16(uint32_t u)
+{
+    return uq16_mul(uq16_mul(u, u), (3U << 16) - (2U * u));
+}
+
+/** Floor of the square root. */
+uint32_t fix_isqrt64(uint64_t n);
+
+/** Smallest root such that root * root >= n. */
+uint32_t fix_isqrt64_ceil(uint64_t n);
+
+/** Square root of a Q16.16 value. 0 for a negative one. */
+q16_t q16_sqrt(q16_t a);
+
+/**
+ * Sine, from a quarter-wave table of 257 entries, linearly interpolated.
+ * Within 2 LSB of the exact value.
+ *
+ * @param angle A full turn is 65536.
+ */
+q15_t fix_sin_q15(uint16_t angle);
+
+/** Cosine. Same as fix_sin_q15(), a quarter turn on. */
+q15_t fix_cos_q15(uint16_t angle);
+
+#ifdef __cplusplus
+}
+#endif
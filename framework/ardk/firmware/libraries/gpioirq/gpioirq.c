@@ -0,0 +1,116 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/platform.h"
+// Library includes
+#include <errors.h>
+#include <hotpaths.h>
+// Local includes
+#include "gpioirq.h"
+
+/** What a pin was added with. */
+typedef struct {
+    gpioirq_handler_t handler;
+    void *context;
+    uint32_t events;
+    uint32_t debounce_us;
+    uint32_t last_us;           // time_us_32() of the last edge handled, for the debounce
+} pin_t;
+
+static pin_t pins[NUM_BANK0_GPIOS];
+
+/** The pins each core takes interrupts for, a bit per pin. */
+static volatile uint32_t pin_masks[NUM_CORES];
+
+/** Has each core got the dispatcher on its GPIO interrupt yet? */
+static bool installed[NUM_CORES];
+
+/** The bank 0 GPIO interrupt: call the handler of each of our pins that has an event. */
+static void HOT_FUNC(gpioirq_dispatch)(void)
+{
+    uint32_t mask = pin_masks[get_core_num()];
+    while (mask != 0)
+    {
+        const uint gpio = (uint)__builtin_ctz(mask);
+        mask &= mask - 1;
+
+        pin_t *pin = &pins[gpio];
+        const uint32_t events = gpio_get_irq_event_mask(gpio) & pin->events;
+        if (events == 0)
+        {
+            continue;
+        }
+        // Only edges latch; levels stay pending until the pin lets go
+        gpio_acknowledge_irq(gpio, events);
+
+        if (pin->debounce_us != 0)
+        {
+            const uint32_t now = time_us_32();
+            if ((now - pin->last_us) < pin->debounce_us)
+            {
+                continue;
+            }
+            pin->last_us = now;
+        }
+        pin->handler(gpio, events, pin->context);
+    }
+}
+
+bool gpioirq_add(uint gpio, uint32_t events, uint32_t debounce_us, gpioirq_handler_t handler, void *context)
+{
+    if ((gpio >= NUM_BANK0_GPIOS) || (handler == NULL))
+    {
+        log_error("Can't take interrupts for GPIO %u\n", gpio);
+        set_errno(ERR_ID_GPIOIRQ_MODULE, EINVAL);
+        return false;
+    }
+
+    const uint core = get_core_num();
+    gpio_set_irq_enabled(gpio, pins[gpio].events, false);
+
+    const uint32_t saved = save_and_disable_interrupts();
+    pins[gpio] = (pin_t){
+        .handler = handler,
+        .context = context,
+        .events = events,
+        .debounce_us = debounce_us,
+        // So the first edge is handled, however soon it comes
+        .last_us = time_us_32() - debounce_us,
+    };
+    pin_masks[core] |= (1u << gpio);
+    restore_interrupts(saved);
+
+    if (debounce_us != 0)
+    {
+        gpio_set_input_hysteresis_enabled(gpio, true);
+    }
+    if (!installed[core])
+    {
+        irq_add_shared_handler(IO_IRQ_BANK0, &gpioirq_dispatch, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        installed[core] = true;
+    }
+
+    // An edge from before now isn't one of ours
+    gpio_acknowledge_irq(gpio, events);
+    gpio_set_irq_enabled(gpio, events, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
+
+void gpioirq_remove(uint gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS)
+    {
+        return;
+    }
+
+    gpio_set_irq_enabled(gpio, pins[gpio].events, false);
+    const uint32_t saved = save_and_disable_interrupts();
+    pin_masks[get_core_num()] &= ~(1u << gpio);
+    restore_interrupts(saved);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file gpioirq.h
+ * @brief GPIO interrupts.
+ * One raw handler on the bank 0 GPIO interrupt, shared with anything else that adds one, that calls
+ * each pin's own handler. It takes the place of the SDK's single GPIO callback, which every pin's
+ * interrupt has to go through.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/gpio.h"
+
+/**
+ * Called from the GPIO interrupt when the pin has one of the events it was added with
+ * (GPIO_IRQ_EDGE_FALL and so on). Keep it short, and leave anything that can wait to the main loop:
+ * every other GPIO interrupt waits on it.
+ */
+typedef void (*gpioirq_handler_t)(uint gpio, uint32_t events, void *context);
+
+/**
+ * @brief Take a pin's interrupts on the calling core, and call `handler` for them.
+ *
+ * @param gpio The pin.
+ * @param events The events to take (GPIO_IRQ_* bits).
+ * @param debounce_us If not 0, an edge less than this long after the last one handled is ignored
+ *                    (and the pin's Schmitt trigger is turned on). The first edge is handled straight
+ *                    away, so this adds no latency.
+ * @param handler Its handler. Replaces the one it had, if any.
+ * @param context Passed to the handler.
+ * @return false if gpio isn't a bank 0 pin, or handler is NULL.
+ */
+bool gpioirq_add(uint gpio, uint32_t events, uint32_t debounce_us, gpioirq_handler_t handler, void *context);
+
+/** Stop taking a pin's interrupts on the calling core. */
+void gpioirq_remove(uint gpio);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,871 @@
+/*****************************************************************************
+* | File      	:   DEV_Config.c
+* | Author      :
+* | Function    :   Hardware underlying interface
+* | Info        :
+*----------------
+* |	This version:   V1.0
+* | Date        :   2021-03-16
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of theex Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+******************************************************************************/
+#include "DEV_Config.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/busctrl.h"
+#include <sysclock.h>
+#include "pico/sync.h"
+#if LCD_USE_PIO
+#include "hardware/pio.h"
+#include "lcd_spi.pio.h"
+#endif
+
+#define SPI_PORT spi1
+#define I2C_PORT spi1
+
+#if LCD_USE_PIO
+/** PIO block driving the LCD bus when LCD_USE_PIO is set. */
+#define LCD_PIO pio0
+
+/** State machine driving the LCD bus. Claimed in lcd_bus_init. */
+static uint lcd_pio_sm = 0;
+#endif
+
+/** DMA IRQ line used for SPI transfer completion. DMA_IRQ_0 is left for anyone else who wants it. */
+#define SPI_DMA_IRQ DMA_IRQ_1
+
+uint slice_num;
+
+/** Backlight PWM counts per period, and the counter's rate: 1000 levels at about 25 kHz, at any clk_sys. */
+#define BL_PWM_WRAP 999
+#define BL_PWM_COUNT_HZ 25000000U
+
+/** The backlight PWM's clock divider, in sixteenths, and the system clock it was worked out for. See set_clock_dividers(). */
+static uint32_t bl_div_16ths = 5U << 4;
+static uint32_t bl_sys_hz = 125000000U;
+
+/** The LCD bus rate last asked for, to ask for again when the clock changes. */
+static uint lcd_bus_requested_hz = LCD_SPI_BAUDRATE;
+
+/** The touch controller's I2C rate. */
+#define TOUCH_I2C_BAUDRATE (300 * 1000)
+
+/** DMA channels that stream a backlight ramp: one writes the levels, the other feeds it one step at a time. -1 if unclaimed. */
+static int bl_ramp_data_channel = -1;
+static int bl_ramp_ctrl_channel = -1;
+
+/** A step of a ramp, as the control channel writes it into the data channel's AL3 TRANS_COUNT and READ_ADDR_TRIG. */
+typedef struct {
+    uint32_t count;             // PWM periods to hold the level for
+    const uint32_t *level;      // The compare register value: the level in channel B
+} bl_ramp_step_t;
+
+/** The ramp being streamed: its levels, and its steps, ending with a null one to stop the control channel. */
+static uint32_t bl_ramp_levels[DEV_PWM_RAMP_STEPS];
+static bl_ramp_step_t bl_ramp_steps[DEV_PWM_RAMP_STEPS + 1];
+
+/** Has a ramp been started since the last one was stopped? */
+static bool bl_ramp_started = false;
+
+/** DMA channel feeding the SPI TX FIFO. Claimed in DEV_Module_Init; -1 until then. */
+static int spi_dma_channel = -1;
+
+/** True from the moment a DMA transfer is started until its completion callback has run. */
+static volatile bool spi_dma_in_flight = false;
+
+/** Transfers started and finished since boot (see DEV_SPI_DMA_Started()). Free-running; they finish in order. */
+static volatile uint32_t spi_dma_started = 0;
+static volatile uint32_t spi_dma_finished = 0;
+
+/** Called once the in-flight transfer has finished shifting out. */
+static volatile DEV_SPI_DMA_Callback spi_dma_callback = NULL;
+
+/** Source word for DEV_SPI_Fill_DMA. The DMA reads it over and over, so it has to outlive the call. */
+static volatile uint16_t spi_fill_value = 0;
+
+/** True when the in-flight transfer switched the SPI to 16-bit frames and it needs switching back. */
+static volatile bool spi_dma_16bit = false;
+
+/** Guards completion so the IRQ and a polling waiter (possibly on the other core) can't both finish a transfer. */
+static critical_section_t spi_dma_crit;
+/**
+ * GPIO read and write
+**/
+void HOT_FUNC(DEV_Digital_Write)(UWORD Pin, UBYTE Value)
+{
+    gpio_put(Pin, Value);
+}
+
+UBYTE DEV_Digital_Read(UWORD Pin)
+{
+    return gpio_get(Pin);
+}
+
+/**
+ * LCD bus
+ *
+ * Write-only, mode 0, MSB first. Either spi1 or (with LCD_USE_PIO) a PIO state
+ * machine on the same pins. Everything above this goes through these functions.
+**/
+#if LCD_USE_PIO
+static uint lcd_bus_init(uint baudrate)
+{
+    lcd_pio_sm = (uint)pio_claim_unused_sm(LCD_PIO, true);
+    uint offset = pio_add_program(LCD_PIO, &lcd_spi_program);
+    float clkdiv = (float)clock_get_hz(clk_sys) / (2.0f * (float)baudrate);
+    if (clkdiv < 1.0f)
+    {
+        clkdiv = 1.0f;
+    }
+    lcd_spi_program_init(LCD_PIO, lcd_pio_sm, offset, LCD_MOSI_PIN, LCD_CLK_PIN, clkdiv);
+    return (uint)((float)clock_get_hz(clk_sys) / (2.0f * clkdiv));
+}
+
+static uint lcd_bus_set_baudrate(uint baudrate)
+{
+    float clkdiv = (float)clock_get_hz(clk_sys) / (2.0f * (float)baudrate);
+    if (clkdiv < 1.0f)
+    {
+        clkdiv = 1.0f;
+    }
+    pio_sm_set_clkdiv(LCD_PIO, lcd_pio_sm, clkdiv);
+    return (uint)((float)clock_get_hz(clk_sys) / (2.0f * clkdiv));
+}
+
+/** Wait until the last bit has actually been clocked out. */
+static void HOT_FUNC(lcd_bus_wait_idle)(void)
+{
+    uint32_t stall_mask = 1u << (PIO_FDEBUG_TXSTALL_LSB + lcd_pio_sm);
+    LCD_PIO->fdebug = stall_mask;
+    while (!(LCD_PIO->fdebug & stall_mask))
+    {
+        tight_loop_contents();
+    }
+}
+
+static void HOT_FUNC(lcd_bus_set_frame_bits)(uint bits)
+{
+    lcd_spi_set_frame_bits(LCD_PIO, lcd_pio_sm, bits);
+}
+
+static void HOT_FUNC(lcd_bus_write_blocking)(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        // Data is taken from the top of the word
+        pio_sm_put_blocking(LCD_PIO, lcd_pio_sm, (uint32_t)data[i] << 24);
+    }
+    lcd_bus_wait_idle();
+}
+
+static volatile void *lcd_bus_tx_addr(void)
+{
+    return &LCD_PIO->txf[lcd_pio_sm];
+}
+
+static uint lcd_bus_tx_dreq(void)
+{
+    return pio_get_dreq(LCD_PIO, lcd_pio_sm, true);
+}
+
+/** Nothing comes back from the PIO, so there's nothing to clean up. */
+static void HOT_FUNC(lcd_bus_drain_rx)(void)
+{
+}
+#else
+static uint lcd_bus_init(uint baudrate)
+{
+    uint actual = spi_init(SPI_PORT, baudrate);
+    gpio_set_function(LCD_CLK_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(LCD_MOSI_PIN, GPIO_FUNC_SPI);
+    return actual;
+}
+
+static uint lcd_bus_set_baudrate(uint baudrate)
+{
+    return spi_set_baudrate(SPI_PORT, baudrate);
+}
+
+/** Wait until the last bit has actually been clocked out. */
+static void HOT_FUNC(lcd_bus_wait_idle)(void)
+{
+    while (spi_is_busy(SPI_PORT))
+    {
+        tight_loop_contents();
+    }
+}
+
+static void HOT_FUNC(lcd_bus_set_frame_bits)(uint bits)
+{
+    spi_set_format(SPI_PORT, bits, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+}
+
+static void HOT_FUNC(lcd_bus_write_blocking)(const uint8_t *data, size_t len)
+{
+    spi_write_blocking(SPI_PORT, data, len);
+}
+
+static volatile void *lcd_bus_tx_addr(void)
+{
+    return &spi_get_hw(SPI_PORT)->dr;
+}
+
+static uint lcd_bus_tx_dreq(void)
+{
+    return spi_get_dreq(SPI_PORT, true);
+}
+
+/**
+ * We never read while transmitting via DMA, so throw away whatever piled up in RX
+ * and clear the overrun flag, which is what spi_write_blocking would have done.
+ */
+static void HOT_FUNC(lcd_bus_drain_rx)(void)
+{
+    while (spi_is_readable(SPI_PORT))
+    {
+        (void)spi_get_hw(SPI_PORT)->dr;
+    }
+    spi_get_hw(SPI_PORT)->icr = SPI_SSPICR_RORIC_BITS;
+}
+#endif // LCD_USE_PIO
+
+/**
+ * SPI
+**/
+void HOT_FUNC(DEV_SPI_WriteByte)(uint8_t Value)
+{
+    DEV_SPI_DMA_Wait();
+    lcd_bus_write_blocking(&Value, 1);
+}
+
+void HOT_FUNC(DEV_SPI_Write_nByte)(uint8_t pData[], uint32_t Len)
+{
+    DEV_SPI_DMA_Wait();
+    lcd_bus_write_blocking(pData, Len);
+}
+
+/******************************************************************************
+function:	Change the LCD bus bit rate
+parameter:
+    Baudrate : Requested rate in Hz
+return:
+    The rate actually achieved
+******************************************************************************/
+uint32_t DEV_SPI_SetBaudrate(uint32_t Baudrate)
+{
+    DEV_SPI_DMA_Wait();
+    lcd_bus_requested_hz = Baudrate;
+    return lcd_bus_set_baudrate(Baudrate);
+}
+
+/**
+ * SPI DMA
+**/
+/** Finish the in-flight transfer. Must be called with spi_dma_crit held. */
+static void HOT_FUNC(spi_dma_complete_locked)(void)
+{
+    if (!spi_dma_in_flight)
+    {
+        return;
+    }
+
+    dma_channel_acknowledge_irq1(spi_dma_channel);
+
+    // DMA is done once the last byte lands in the TX FIFO, but the byte still
+    // has to be shifted out before anyone can touch CS/DC.
+    lcd_bus_wait_idle();
+    lcd_bus_drain_rx();
+
+    if (spi_dma_16bit)
+    {
+        // Back to the byte-wide frames everything else expects (and the DMA channel with them).
+        lcd_bus_set_frame_bits(8);
+        dma_channel_config c = dma_get_channel_config(spi_dma_channel);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, true);
+        dma_channel_set_config(spi_dma_channel, &c, false);
+        spi_dma_16bit = false;
+    }
+
+    DEV_SPI_DMA_Callback cb = spi_dma_callback;
+    spi_dma_callback = NULL;
+    spi_dma_finished++;
+    spi_dma_in_flight = false;
+    if (cb != NULL)
+    {
+        cb();
+    }
+}
+
+static void HOT_FUNC(spi_dma_irq_handler)(void)
+{
+    if (spi_dma_channel < 0 || !dma_channel_get_irq1_status(spi_dma_channel))
+    {
+        // Shared IRQ; not ours.
+        return;
+    }
+
+    critical_section_enter_blocking(&spi_dma_crit);
+    spi_dma_complete_locked();
+    critical_section_exit(&spi_dma_crit);
+}
+
+/******************************************************************************
+function:	Start streaming Len bytes from pData out of the SPI port via DMA.
+parameter:
+    pData    : Buffer to send. Must stay untouched until the transfer completes.
+    Len      : Number of bytes.
+    Callback : Run once the last byte has left the SPI peripheral. May be NULL.
+Info:
+    Returns immediately. If a transfer is already in flight, waits for it first.
+    The callback runs in IRQ context (or in the context of whoever calls
+    DEV_SPI_DMA_Wait), so keep it short.
+******************************************************************************/
+void DEV_SPI_Write_nByte_DMA(const uint8_t *pData, uint32_t Len, DEV_SPI_DMA_Callback Callback)
+{
+    DEV_SPI_DMA_Wait();
+    spi_dma_started++;
+
+    if (spi_dma_channel < 0)
+    {
+        // No DMA available; fall back to the slow way.
+        lcd_bus_write_blocking(pData, Len);
+        spi_dma_finished++;
+        if (Callback != NULL)
+        {
+            Callback();
+        }
+        return;
+    }
+
+    spi_dma_callback = Callback;
+    spi_dma_in_flight = true;
+    dma_channel_transfer_from_buffer_now(spi_dma_channel, pData, Len);
+}
+
+/******************************************************************************
+function:	Send Value (MSB first) Count times via DMA, without a source buffer.
+parameter:
+    Value    : 16-bit word to repeat
+    Count    : Number of words
+    Callback : Same as DEV_SPI_Write_nByte_DMA
+Info:
+    Switches the SPI to 16-bit frames for the duration and points a
+    non-incrementing DMA read at a single word, so a full-screen clear needs
+    no RAM and no CPU. Returns immediately.
+******************************************************************************/
+void DEV_SPI_Fill_DMA(uint16_t Value, uint32_t Count, DEV_SPI_DMA_Callback Callback)
+{
+    DEV_SPI_DMA_Wait();
+    spi_dma_started++;
+
+    if (spi_dma_channel < 0)
+    {
+        uint8_t bytes[2] = {(uint8_t)(Value >> 8), (uint8_t)(Value & 0xFF)};
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            lcd_bus_write_blocking(bytes, 2);
+        }
+        spi_dma_finished++;
+        if (Callback != NULL)
+        {
+            Callback();
+        }
+        return;
+    }
+
+    spi_fill_value = Value;
+    lcd_bus_set_frame_bits(16);
+
+    dma_channel_config c = dma_get_channel_config(spi_dma_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    dma_channel_set_config(spi_dma_channel, &c, false);
+
+    spi_dma_callback = Callback;
+    spi_dma_16bit = true;
+    spi_dma_in_flight = true;
+    dma_channel_transfer_from_buffer_now(spi_dma_channel, &spi_fill_value, Count);
+}
+
+/******************************************************************************
+function:	Stop the in-flight DMA transfer where it is
+return:
+    How many bytes (words, for a fill) of it didn't go out. 0 if it had finished,
+    or if there was none.
+Info:
+    Everything already in the SPI FIFO is clocked out first, and the transfer's
+    callback runs as if it had finished, so CS goes up as usual.
+******************************************************************************/
+uint32_t DEV_SPI_DMA_Abort(void)
+{
+    uint32_t unsent = 0;
+    critical_section_enter_blocking(&spi_dma_crit);
+    if (spi_dma_in_flight && dma_channel_is_busy(spi_dma_channel))
+    {
+        // An abort can raise the channel's interrupt as if it had finished (RP2040-E13), so mask it meanwhile
+        dma_channel_set_irq1_enabled(spi_dma_channel, false);
+        dma_channel_abort(spi_dma_channel);
+        unsent = dma_channel_hw_addr(spi_dma_channel)->transfer_count;
+        dma_channel_acknowledge_irq1(spi_dma_channel);
+        dma_channel_set_irq1_enabled(spi_dma_channel, true);
+    }
+    spi_dma_complete_locked();
+    critical_section_exit(&spi_dma_crit);
+    return unsent;
+}
+
+/** How many DMA transfers (or their blocking stand-ins) have been started since boot. Wraps. */
+uint32_t DEV_SPI_DMA_Started(void)
+{
+    return spi_dma_started;
+}
+
+/** How many of those have finished (and had their callbacks run). Transfers finish in the order they start. */
+uint32_t DEV_SPI_DMA_Finished(void)
+{
+    return spi_dma_finished;
+}
+
+/** Is there a DMA transfer that hasn't completed yet? */
+bool DEV_SPI_DMA_Busy(void)
+{
+    return spi_dma_in_flight;
+}
+
+/******************************************************************************
+function:	Block until any in-flight DMA transfer has completed (and its callback has run).
+Info:
+    Polls the channel rather than relying solely on the IRQ so that it is safe
+    to call from an IRQ handler of equal or higher priority than the DMA IRQ.
+******************************************************************************/
+void DEV_SPI_DMA_Wait(void)
+{
+    while (spi_dma_in_flight)
+    {
+        if (!dma_channel_is_busy(spi_dma_channel))
+        {
+            critical_section_enter_blocking(&spi_dma_crit);
+            spi_dma_complete_locked();
+            critical_section_exit(&spi_dma_crit);
+        }
+        else
+        {
+            tight_loop_contents();
+        }
+    }
+}
+
+/** What the bus fabric's four performance counters count for DEV_Bus_Count_Start(): one striped bank of main RAM each. */
+static const bus_ctrl_perf_counter_t bus_count_events[] = {
+    arbiter_sram0_perf_event_access_contested,
+    arbiter_sram1_perf_event_access_contested,
+    arbiter_sram2_perf_event_access_contested,
+    arbiter_sram3_perf_event_access_contested,
+};
+
+/******************************************************************************
+function:	Start counting accesses to main RAM that had to wait for another bus
+            master (the other core, or a DMA channel, on the same bank)
+Info:
+    Takes all four of the bus fabric's performance counters, and starts them
+    again from zero. They saturate at 2^24 - 1.
+******************************************************************************/
+void DEV_Bus_Count_Start(void)
+{
+    for (uint i = 0; i < count_of(bus_count_events); i++)
+    {
+        busctrl_hw->counter[i].sel = bus_count_events[i];
+        // Any write clears it
+        busctrl_hw->counter[i].value = 0;
+    }
+}
+
+/** Accesses to main RAM, all four banks, that waited since DEV_Bus_Count_Start(). */
+uint32_t DEV_Bus_Count_Contested(void)
+{
+    uint32_t contested = 0;
+    for (uint i = 0; i < count_of(bus_count_events); i++)
+    {
+        contested += busctrl_hw->counter[i].value;
+    }
+    return contested;
+}
+
+static void DEV_SPI_DMA_Init(void)
+{
+    critical_section_init(&spi_dma_crit);
+
+    spi_dma_channel = dma_claim_unused_channel(false);
+    if (spi_dma_channel < 0)
+    {
+        printf("DEV_SPI_DMA_Init: no free DMA channel; falling back to blocking SPI \r\n");
+        return;
+    }
+
+    dma_channel_config c = dma_channel_get_default_config(spi_dma_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, lcd_bus_tx_dreq());
+    dma_channel_configure(spi_dma_channel, &c, lcd_bus_tx_addr(), NULL, 0, false);
+
+    // Install on whichever core is bringing up the LCD, since that's the core doing the drawing.
+    dma_channel_set_irq1_enabled(spi_dma_channel, true);
+    irq_add_shared_handler(SPI_DMA_IRQ, spi_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(SPI_DMA_IRQ, true);
+}
+
+/** Stop a backlight ramp where it is. */
+static void bl_ramp_stop(void)
+{
+    if (!bl_ramp_started)
+    {
+        return;
+    }
+    // Both at once, so a step finishing now can't chain into the control channel after it was stopped
+    const uint32_t mask = (1u << bl_ramp_data_channel) | (1u << bl_ramp_ctrl_channel);
+    dma_hw->abort = mask;
+    while (dma_hw->abort & mask)
+    {
+        tight_loop_contents();
+    }
+    bl_ramp_started = false;
+}
+
+/** Claim and set up the backlight ramp's DMA channels. Without them, DEV_PWM_Ramp() jumps to the level. */
+static void DEV_PWM_Ramp_Init(void)
+{
+    if (bl_ramp_data_channel >= 0)
+    {
+        return;
+    }
+    const int data = dma_claim_unused_channel(false);
+    const int ctrl = dma_claim_unused_channel(false);
+    if ((data < 0) || (ctrl < 0))
+    {
+        printf("DEV_PWM_Ramp_Init: no free DMA channels; backlight ramps will jump \r\n");
+        if (data >= 0)
+        {
+            dma_channel_unclaim(data);
+        }
+        if (ctrl >= 0)
+        {
+            dma_channel_unclaim(ctrl);
+        }
+        return;
+    }
+
+    // Writes a level into the compare register once per PWM period, then hands over to the control channel.
+    // The whole register is written: channel A's pin is the LCD's reset line, which isn't on the PWM
+    dma_channel_config c = dma_channel_get_default_config(data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pwm_get_dreq(slice_num));
+    channel_config_set_chain_to(&c, ctrl);
+    dma_channel_configure(data, &c, &pwm_hw->slice[slice_num].cc, NULL, 0, false);
+
+    // Loads the next step into the data channel, which starts it
+    c = dma_channel_get_default_config(ctrl);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 3);
+    dma_channel_configure(ctrl, &c, &dma_hw->ch[data].al3_transfer_count, NULL, 2, false);
+
+    bl_ramp_data_channel = data;
+    bl_ramp_ctrl_channel = ctrl;
+}
+
+
+
+/**
+ * I2C
+**/
+
+void DEV_I2C_Write(uint8_t addr, uint8_t reg, uint8_t Value)
+{
+    uint8_t data[2] = {reg, Value};
+    i2c_write_blocking(i2c1, addr, data, 2, false);
+}
+
+void DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len)
+{
+    i2c_write_blocking(i2c1, addr, pData, Len, false);
+}
+
+uint8_t DEV_I2C_ReadByte(uint8_t addr, uint8_t reg)
+{
+    uint8_t buf;
+    i2c_write_blocking(i2c1,addr,&reg,1,true);
+    i2c_read_blocking(i2c1,addr,&buf,1,false);
+    return buf;
+}
+
+/**
+ * GPIO Mode
+**/
+void DEV_GPIO_Mode(UWORD Pin, UWORD Mode)
+{
+    gpio_init(Pin);
+    if(Mode == 0 || Mode == GPIO_IN) {
+        gpio_set_dir(Pin, GPIO_IN);
+    } else {
+        gpio_set_dir(Pin, GPIO_OUT);
+    }
+}
+
+/**
+ * KEY Config
+**/
+void DEV_KEY_Config(UWORD Pin)
+{
+    gpio_init(Pin);
+	gpio_pull_up(Pin);
+    gpio_set_dir(Pin, GPIO_IN);
+}
+
+/**
+ * delay x ms
+**/
+void DEV_Delay_ms(UDOUBLE xms)
+{
+    sleep_ms(xms);
+}
+
+void DEV_Delay_us(UDOUBLE xus)
+{
+    sleep_us(xus);
+}
+
+
+
+void DEV_GPIO_Init(void)
+{
+    // High before it's an output, so setting up the pins doesn't reset a panel that's still running (see LCD_Panel_Resume())
+    DEV_GPIO_Mode(LCD_RST_PIN, 0);
+    DEV_Digital_Write(LCD_RST_PIN, 1);
+    gpio_set_dir(LCD_RST_PIN, GPIO_OUT);
+    DEV_GPIO_Mode(LCD_DC_PIN, 1);
+    DEV_GPIO_Mode(LCD_CS_PIN, 1);
+    DEV_GPIO_Mode(LCD_BL_PIN, 1);
+
+
+    DEV_GPIO_Mode(LCD_CS_PIN, 1);
+    DEV_GPIO_Mode(LCD_BL_PIN, 1);
+
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+    DEV_Digital_Write(LCD_DC_PIN, 0);
+    DEV_Digital_Write(LCD_BL_PIN, 1);
+
+#if LCD_TE_PIN >= 0
+    DEV_GPIO_Mode(LCD_TE_PIN, 0);
+#endif
+}
+
+/******************************************************************************
+function:	Wait for the panel to start a refresh (a rising edge on its tearing-effect line)
+parameter:
+    Timeout_us : Give up after this long
+return:
+    false if there is no TE line or it didn't rise in time
+******************************************************************************/
+bool DEV_TE_Wait(UDOUBLE Timeout_us)
+{
+#if LCD_TE_PIN >= 0
+    absolute_time_t deadline = make_timeout_time_us(Timeout_us);
+    while (gpio_get(LCD_TE_PIN))
+    {
+        if (time_reached(deadline))
+        {
+            return false;
+        }
+    }
+    while (!gpio_get(LCD_TE_PIN))
+    {
+        if (time_reached(deadline))
+        {
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif // LCD_TE_PIN
+}
+/******************************************************************************
+function:	Module Initialize, the library and initialize the pins, SPI protocol
+parameter:
+Info:
+******************************************************************************/
+/** Re-derive the LCD bus rate, the backlight PWM's divider, and the touch I2C rate from a new clk_sys. */
+static void set_clock_dividers(uint32_t sys_hz, void *context)
+{
+    DEV_SPI_DMA_Wait();
+    lcd_bus_set_baudrate(lcd_bus_requested_hz);
+
+    bl_sys_hz = sys_hz;
+    bl_div_16ths = (uint32_t)((((uint64_t)sys_hz * 16U) + (BL_PWM_COUNT_HZ / 2U)) / BL_PWM_COUNT_HZ);
+    pwm_set_clkdiv_int_frac(slice_num, (uint8_t)(bl_div_16ths >> 4), (uint8_t)(bl_div_16ths & 0xFU));
+
+    i2c_set_baudrate(i2c1, TOUCH_I2C_BAUDRATE);
+}
+
+UBYTE DEV_Module_Init(void)
+{
+    stdio_init_all();
+    // SPI Config
+    uint baud = lcd_bus_init(LCD_SPI_BAUDRATE);
+    printf("DEV_Module_Init: LCD bus at %u Hz (%s) \r\n", baud, LCD_USE_PIO ? "PIO" : "SPI");
+    DEV_SPI_DMA_Init();
+
+    // GPIO Config
+    DEV_GPIO_Init();
+
+
+    // PWM Config
+    gpio_set_function(LCD_BL_PIN, GPIO_FUNC_PWM);
+    slice_num = pwm_gpio_to_slice_num(LCD_BL_PIN);
+    pwm_set_wrap(slice_num, BL_PWM_WRAP);
+    pwm_set_chan_level(slice_num, PWM_CHAN_B, 10);
+    DEV_PWM_Ramp_Init();
+
+
+    //I2C Config
+    i2c_init(i2c1, TOUCH_I2C_BAUDRATE);
+    gpio_set_function(LCD_SDA_PIN,GPIO_FUNC_I2C);
+    gpio_set_function(LCD_SCL_PIN,GPIO_FUNC_I2C);
+    gpio_pull_up(LCD_SDA_PIN);
+    gpio_pull_up(LCD_SCL_PIN);
+
+    // Everything above that's divided down from clk_sys, for the clock we're at and whatever comes later
+    sysclock_register(&set_clock_dividers, NULL);
+    // This core's sleeps are deep sleeps, so the bus's clock can stop while the LCD sleeps (see DEV_Module_Sleep())
+    sysclock_deep_sleep_init();
+    pwm_set_enabled(slice_num, true);
+
+    printf("DEV_Module_Init OK \r\n");
+    return 0;
+}
+
+void DEV_SET_PWM(uint8_t Value){
+    if(Value > 100){
+        printf("DEV_SET_PWM Error \r\n");
+    }else {
+        bl_ramp_stop();
+        pwm_set_chan_level(slice_num, PWM_CHAN_B, (uint16_t)Value * 10);
+    }
+}
+
+/** Perceived brightness (0 to 1000) of a backlight PWM level (0 to 1000): the inverse of the square law in DEV_PWM_Ramp(). */
+static uint32_t bl_perceived(uint32_t level)
+{
+    uint32_t p = 0;
+    while (((p + 1) * (p + 1)) <= (level * 1000))
+    {
+        p++;
+    }
+    return p;
+}
+
+/******************************************************************************
+function:	Fade the backlight to a level (as for DEV_SET_PWM) over a time, in DEV_PWM_RAMP_STEPS
+            steps spaced evenly in perceived brightness (a square law, near enough the eye's).
+            Two DMA channels stream the steps into the PWM compare register, paced by the PWM
+            wrap, so this returns straight away and the CPU has nothing to do until it's done.
+            Replaces a ramp that is still going, from wherever that got to. DEV_SET_PWM() stops one.
+parameter:
+    Value       : Level to end on, 0 to 100
+    Duration_ms : How long to take
+******************************************************************************/
+void DEV_PWM_Ramp(uint8_t Value, UDOUBLE Duration_ms)
+{
+    if (Value > 100)
+    {
+        printf("DEV_PWM_Ramp Error \r\n");
+        return;
+    }
+    if (bl_ramp_data_channel < 0)
+    {
+        DEV_SET_PWM(Value);
+        return;
+    }
+    bl_ramp_stop();
+
+    const uint32_t from = bl_perceived((pwm_hw->slice[slice_num].cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB);
+    const uint32_t to = bl_perceived((uint32_t)Value * 10);
+    const uint32_t periods_per_s = (uint32_t)(((uint64_t)bl_sys_hz * 16U) / ((uint64_t)bl_div_16ths * (BL_PWM_WRAP + 1)));
+    const uint64_t periods = ((uint64_t)periods_per_s * Duration_ms) / 1000;
+    const uint32_t hold = (periods > DEV_PWM_RAMP_STEPS) ? (uint32_t)(periods / DEV_PWM_RAMP_STEPS) : 1;
+    for (uint32_t i = 0; i < DEV_PWM_RAMP_STEPS; i++)
+    {
+        const int32_t p = (int32_t)from + ((((int32_t)to - (int32_t)from) * (int32_t)(i + 1)) / DEV_PWM_RAMP_STEPS);
+        const uint32_t level = (i == (DEV_PWM_RAMP_STEPS - 1)) ? ((uint32_t)Value * 10) : ((((uint32_t)p * (uint32_t)p) + 500) / 1000);
+        bl_ramp_levels[i] = level << PWM_CH0_CC_B_LSB;
+        bl_ramp_steps[i] = (bl_ramp_step_t){hold, &bl_ramp_levels[i]};
+    }
+    // Writing 0 to READ_ADDR_TRIG is a null trigger, which leaves the data channel idle
+    bl_ramp_steps[DEV_PWM_RAMP_STEPS] = (bl_ramp_step_t){0, NULL};
+
+    // A stopped ramp can leave the control channel part way through a step
+    bl_ramp_started = true;
+    dma_channel_set_write_addr(bl_ramp_ctrl_channel, &dma_hw->ch[bl_ramp_data_channel].al3_transfer_count, false);
+    dma_channel_set_trans_count(bl_ramp_ctrl_channel, 2, false);
+    dma_channel_set_read_addr(bl_ramp_ctrl_channel, bl_ramp_steps, true);
+}
+
+/** Is a backlight ramp still going? */
+bool DEV_PWM_Ramp_Busy(void)
+{
+    if (!bl_ramp_started)
+    {
+        return false;
+    }
+    // Between steps, neither channel may be busy for a moment, but the control channel hasn't reached the null step
+    return dma_channel_is_busy(bl_ramp_data_channel) || dma_channel_is_busy(bl_ramp_ctrl_channel) ||
+           (dma_hw->ch[bl_ramp_ctrl_channel].read_addr != (uintptr_t)&bl_ramp_steps[DEV_PWM_RAMP_STEPS + 1]);
+}
+
+/******************************************************************************
+function:	Have the LCD bus's clocks stop, or not, while both cores are in deep sleep
+            (see sysclock_deep_sleep_init())
+parameter:
+    Asleep : true while the LCD sleeps and nothing is going out to it
+Info:
+    Only spi1's clocks. A PIO bus's block may be running other state machines, so it
+    is left running. Wait for the bus (DEV_SPI_DMA_Wait()) first.
+******************************************************************************/
+void DEV_Module_Sleep(bool Asleep)
+{
+#if !LCD_USE_PIO
+    sysclock_sleep_gate(0, CLOCKS_SLEEP_EN1_CLK_SYS_SPI1_BITS | CLOCKS_SLEEP_EN1_CLK_PERI_SPI1_BITS, Asleep);
+#endif // LCD_USE_PIO
+}
+
+/******************************************************************************
+function:	Module exits, closes SPI and BCM2835 library
+parameter:
+Info:
+******************************************************************************/
+void DEV_Module_Exit(void)
+{
+
+}
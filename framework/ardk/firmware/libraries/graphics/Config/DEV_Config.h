@@ -29,11 +29,24 @@
 #ifndef _DEV_CONFIG_H_
 #define _DEV_CONFIG_H_
 
+#ifdef GFX_HOST_BUILD
+    // Built for the host (e.g., by tools/facegen) to run GUI_Paint off the board. Only the types are needed.
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include <stdio.h>
+#else
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
 #include "stdio.h"
 #include "hardware/i2c.h"
 #include "hardware/pwm.h"
+#include "hardware/dma.h"
+#endif // GFX_HOST_BUILD
+
+/**
+ * Hot paths (pixel writers, LCD bus and its ISR) are marked with HOT_FUNC
+**/
+#include <hotpaths.h>
 
 /**
  * data
@@ -42,6 +55,29 @@
 #define UWORD   uint16_t
 #define UDOUBLE uint32_t
 
+/**
+ * LCD bus config
+**/
+#ifndef LCD_SPI_BAUDRATE
+    /** LCD bus bit rate in Hz. spi1 tops out at clk_peri / 2; the ST7789 is happy well past that. */
+    #define LCD_SPI_BAUDRATE (62500 * 1000)
+#endif
+
+#ifndef LCD_USE_PIO
+    /** Set to 1 to drive CLK/MOSI from a PIO state machine instead of spi1 (e.g., to go past clk_peri / 2). */
+    #define LCD_USE_PIO 0
+#endif
+
+#ifndef DEV_PWM_RAMP_STEPS
+    /** Backlight levels a ramp (DEV_PWM_Ramp()) goes through, each held for an equal share of it. */
+    #define DEV_PWM_RAMP_STEPS 64
+#endif
+
+#ifndef LCD_TE_PIN
+    /** GPIO wired to the panel's tearing-effect output, or -1 if it isn't connected (the Waveshare boards don't break it out). */
+    #define LCD_TE_PIN -1
+#endif
+
 /**
  * GPIOI config
 **/
@@ -67,6 +103,23 @@ UBYTE DEV_Digital_Read(UWORD Pin);
 
 void DEV_SPI_WriteByte(UBYTE Value);
 void DEV_SPI_Write_nByte(uint8_t *pData, uint32_t Len);
+uint32_t DEV_SPI_SetBaudrate(uint32_t Baudrate);
+
+/** Called (from the DMA IRQ, or from DEV_SPI_DMA_Wait) once a DMA transfer has fully left the SPI peripheral. */
+typedef void (*DEV_SPI_DMA_Callback)(void);
+
+void DEV_SPI_Write_nByte_DMA(const uint8_t *pData, uint32_t Len, DEV_SPI_DMA_Callback Callback);
+void DEV_SPI_Fill_DMA(uint16_t Value, uint32_t Count, DEV_SPI_DMA_Callback Callback);
+bool DEV_SPI_DMA_Busy(void);
+void DEV_SPI_DMA_Wait(void);
+uint32_t DEV_SPI_DMA_Abort(void);
+uint32_t DEV_SPI_DMA_Started(void);
+uint32_t DEV_SPI_DMA_Finished(void);
+
+void DEV_Bus_Count_Start(void);
+uint32_t DEV_Bus_Count_Contested(void);
+
+bool DEV_TE_Wait(UDOUBLE Timeout_us);
 
 void DEV_Delay_ms(UDOUBLE xms);
 void DEV_Delay_us(UDOUBLE xus);
@@ -77,8 +130,11 @@ void DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len);
 uint8_t DEV_I2C_ReadByte(uint8_t addr, uint8_t reg);
 
 void DEV_SET_PWM(uint8_t Value);
+void DEV_PWM_Ramp(uint8_t Value, UDOUBLE Duration_ms);
+bool DEV_PWM_Ramp_Busy(void);
 
 UBYTE DEV_Module_Init(void);
+void DEV_Module_Sleep(bool Asleep);
 void DEV_Module_Exit(void);
 
 
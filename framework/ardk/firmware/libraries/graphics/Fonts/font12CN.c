@@ -141,7 +141,7 @@ const CH_CN Font12CN_Table[] =
 };
 
 
-cFONT Font12CN = {
+const cFONT Font12CN = {
   Font12CN_Table,
   sizeof(Font12CN_Table)/sizeof(CH_CN),  /*size of table*/
   11, /* ASCII Width */
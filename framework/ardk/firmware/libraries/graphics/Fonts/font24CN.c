@@ -513,7 +513,7 @@ const CH_CN Font24CN_Table[] =
 
 };
 
-cFONT Font24CN = {
+const cFONT Font24CN = {
   Font24CN_Table,
   sizeof(Font24CN_Table)/sizeof(CH_CN),  /*size of table*/
   24, /* ASCII Width */
@@ -0,0 +1,48 @@
+# Print how much flash and RAM each font takes up in a linked firmware image.
+#
+# cmake -DNM=<nm> -DELF=<image.elf> -P font_report.cmake
+execute_process(
+  COMMAND ${NM} --print-size --radix=d ${ELF}
+  OUTPUT_VARIABLE SYMBOLS
+  RESULT_VARIABLE RESULT
+)
+if (NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "Could not read the symbols of ${ELF}")
+endif()
+
+set(FONTS Font8 Font12 Font16 Font20 Font24 Font12CN Font24CN)
+foreach(FONT ${FONTS})
+  set(${FONT}_FLASH 0)
+  set(${FONT}_RAM 0)
+  set(${FONT}_LINKED NO)
+endforeach()
+
+# Each line is: address size type name. Read-only data and text live in flash; data is in both; bss is RAM only.
+string(REPLACE "\n" ";" LINES "${SYMBOLS}")
+foreach(LINE ${LINES})
+  if (LINE MATCHES "^[0-9]+ ([0-9]+) ([A-Za-z]) (Font[0-9]+(CN)?)(_Table)?$")
+    set(SIZE ${CMAKE_MATCH_1})
+    set(TYPE ${CMAKE_MATCH_2})
+    set(FONT ${CMAKE_MATCH_3})
+    set(${FONT}_LINKED YES)
+    if (TYPE MATCHES "[rRtT]")
+      math(EXPR ${FONT}_FLASH "${${FONT}_FLASH} + ${SIZE}")
+    elseif (TYPE MATCHES "[dD]")
+      math(EXPR ${FONT}_FLASH "${${FONT}_FLASH} + ${SIZE}")
+      math(EXPR ${FONT}_RAM "${${FONT}_RAM} + ${SIZE}")
+    elseif (TYPE MATCHES "[bB]")
+      math(EXPR ${FONT}_RAM "${${FONT}_RAM} + ${SIZE}")
+    endif()
+  endif()
+endforeach()
+
+get_filename_component(IMAGE ${ELF} NAME)
+message("Fonts linked into ${IMAGE} (bytes):")
+message("  font      flash    ram")
+foreach(FONT ${FONTS})
+  if (${FONT}_LINKED)
+    string(SUBSTRING "${FONT}          " 0 10 NAME)
+    string(SUBSTRING "${${FONT}_FLASH}        " 0 9 FLASH)
+    message("  ${NAME}${FLASH}${${FONT}_RAM}")
+  endif()
+endforeach()
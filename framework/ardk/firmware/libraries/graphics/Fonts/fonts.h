@@ -79,14 +79,14 @@ typedef struct
   
 }cFONT;
 
-extern sFONT Font24;
-extern sFONT Font20;
-extern sFONT Font16;
-extern sFONT Font12;
-extern sFONT Font8;
+extern const sFONT Font24;
+extern const sFONT Font20;
+extern const sFONT Font16;
+extern const sFONT Font12;
+extern const sFONT Font8;
 
-extern cFONT Font12CN;
-extern cFONT Font24CN;
+extern const cFONT Font12CN;
+extern const cFONT Font24CN;
 #ifdef __cplusplus
 }
 #endif
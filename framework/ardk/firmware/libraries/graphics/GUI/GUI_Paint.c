@@ -0,0 +1,2670 @@
+#include "GUI_Paint.h"
+#include "../Config/DEV_Config.h"
+#include "../Config/Debug.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h> //memset()
+#include <limits.h>
+#include <math.h>
+#ifndef GFX_HOST_BUILD
+#include "hardware/interp.h"
+#endif
+
+PAINT Paint;
+
+/** Bounding box (memory coordinates) of every pixel written since the last Paint_ResetDirty(). */
+static PAINT_RECT Paint_Dirty = {0, 0, 0, 0};
+
+/** The memory rows Paint.Image holds (see Paint_SelectBand()). Drawing outside them is dropped. */
+static UWORD Paint_BandStart = 0;
+static UWORD Paint_BandEnd = 0;
+
+/**
+ * Rotation and mirroring, resolved by Paint_BindOrientation() into memory X and Y
+ * as linear functions of logical x and y, so mapping a point takes no branches.
+ * Identity is set when there is neither, as when the LCD controller does the turning,
+ * and then points go straight through.
+ **/
+static struct
+{
+    int XOffset, XFromX, XFromY;
+    int YOffset, YFromX, YFromY;
+    bool Valid;
+    bool Identity;
+} Paint_Map = {0, 1, 0, 0, 0, 1, true, true};
+
+/**
+ * Pixel writer and color conversion for the current scale, bound by Paint_BindScale().
+ * Colors are converted to a fill pattern (see Paint_Pattern1() etc.) once, ahead of the pixel loop.
+ **/
+static void Paint_WritePixel1(UWORD X, UWORD Y, UDOUBLE Pattern);
+static UDOUBLE Paint_Pattern1(UWORD Color);
+static void (*Paint_WritePixel)(UWORD X, UWORD Y, UDOUBLE Pattern) = Paint_WritePixel1;
+static UDOUBLE (*Paint_Pattern)(UWORD Color) = Paint_Pattern1;
+static UWORD Paint_BitsPerPixel = 1;
+
+static void Paint_BindOrientation(void);
+static void Paint_BindScale(void);
+static void Paint_SetMemoryPixel(UWORD X, UWORD Y, UDOUBLE Pattern);
+
+/******************************************************************************
+function: Create Image
+parameter:
+    image   :   Pointer to the image cache
+    width   :   The width of the picture
+    Height  :   The height of the picture
+    Color   :   Whether the picture is inverted
+******************************************************************************/
+void Paint_NewImage(UBYTE *image, UWORD Width, UWORD Height, UWORD Rotate, UWORD Color)
+{
+    Paint.Image = NULL;
+    Paint.Image = image;
+
+    Paint.WidthMemory = Width;
+    Paint.HeightMemory = Height;
+    Paint_BandStart = 0;
+    Paint_BandEnd = Height;
+    Paint.Color = Color;
+    Paint.Scale = 2;
+
+    Paint.WidthByte = (Width % 8 == 0) ? (Width / 8) : (Width / 8 + 1);
+    Paint.HeightByte = Height;
+    //    printf("WidthByte = %d, HeightByte = %d\r\n", Paint.WidthByte, Paint.HeightByte);
+    //    printf(" LCD_WIDTH / 8 = %d\r\n",  122 / 8);
+
+    Paint.Rotate = Rotate;
+    Paint.Mirror = MIRROR_NONE;
+
+    if (Rotate == ROTATE_0 || Rotate == ROTATE_180)
+    {
+        Paint.Width = Width;
+        Paint.Height = Height;
+    }
+    else
+    {
+        Paint.Width = Height;
+        Paint.Height = Width;
+    }
+
+    Paint_BindOrientation();
+    Paint_BindScale();
+}
+
+/******************************************************************************
+function: Select Image
+parameter:
+    image : Pointer to the image cache
+******************************************************************************/
+void Paint_SelectImage(UBYTE *image)
+{
+    Paint.Image = image;
+    Paint_BandStart = 0;
+    Paint_BandEnd = Paint.HeightMemory;
+}
+
+/******************************************************************************
+function: Select a buffer that holds only some rows of the image, so a picture
+          can be painted a band at a time, each band replaying the same drawing
+parameter:
+    image  : Holds memory rows Ystart up to Yend, WidthByte apiece
+    Ystart : First memory row it holds
+    Yend   : One past the last memory row it holds
+info:
+    Drawing outside the band is dropped. Paint_Clear() clears just the band.
+    Rotation, mirroring, and the logical size still come from the whole image.
+******************************************************************************/
+void Paint_SelectBand(UBYTE *image, UWORD Ystart, UWORD Yend)
+{
+    Paint.Image = image;
+    Paint_BandStart = Ystart;
+    Paint_BandEnd = (Yend > Paint.HeightMemory) ? Paint.HeightMemory : Yend;
+}
+
+/******************************************************************************
+function: Save the image, band, orientation, scale, and dirty region, so that
+          another image can be painted and Paint_RestoreState() go back to this one
+parameter:
+    State : Where to keep them
+******************************************************************************/
+void Paint_SaveState(PAINT_STATE *State)
+{
+    State->Paint = Paint;
+    State->BandStart = Paint_BandStart;
+    State->BandEnd = Paint_BandEnd;
+    State->Dirty = Paint_Dirty;
+}
+
+/******************************************************************************
+function: Go back to what Paint_SaveState() saved
+parameter:
+    State : What it saved
+info:
+    The glyph cache is keyed by orientation, so it needn't be saved with it.
+******************************************************************************/
+void Paint_RestoreState(const PAINT_STATE *State)
+{
+    Paint = State->Paint;
+    Paint_BandStart = State->BandStart;
+    Paint_BandEnd = State->BandEnd;
+    Paint_Dirty = State->Dirty;
+    Paint_BindOrientation();
+    Paint_BindScale();
+}
+
+/******************************************************************************
+function: Select Image Rotate
+parameter:
+    Rotate : 0,90,180,270
+******************************************************************************/
+void Paint_SetRotate(UWORD Rotate)
+{
+    if (Rotate == ROTATE_0 || Rotate == ROTATE_90 || Rotate == ROTATE_180 || Rotate == ROTATE_270)
+    {
+        Debug("Set image Rotate %d\r\n", Rotate);
+        Paint.Rotate = Rotate;
+        Paint_BindOrientation();
+    }
+    else
+    {
+        Debug("rotate = 0, 90, 180, 270\r\n");
+    }
+}
+
+void Paint_SetScale(UBYTE scale)
+{
+    if (scale == 2)
+    {
+        Paint.Scale = scale;
+        Paint.WidthByte = (Paint.WidthMemory % 8 == 0) ? (Paint.WidthMemory / 8) : (Paint.WidthMemory / 8 + 1);
+    }
+    else if (scale == 4)
+    {
+        Paint.Scale = scale;
+        Paint.WidthByte = (Paint.WidthMemory % 4 == 0) ? (Paint.WidthMemory / 4) : (Paint.WidthMemory / 4 + 1);
+    }
+    else if (scale == 16)
+    {
+        Paint.Scale = scale;
+        Paint.WidthByte = (Paint.WidthMemory % 2 == 0) ? (Paint.WidthMemory / 2) : (Paint.WidthMemory / 2 + 1);
+    }
+    else if (scale == 65)
+    {
+        Paint.Scale = scale;
+        Paint.WidthByte = Paint.WidthMemory * 2;
+    }
+    else
+    {
+        Debug("Set Scale Input parameter error\r\n");
+        Debug("Scale Only support: 2 4 16 65\r\n");
+    }
+    Paint_BindScale();
+}
+/******************************************************************************
+function:	Select Image mirror
+parameter:
+    mirror   :Not mirror,Horizontal mirror,Vertical mirror,Origin mirror
+******************************************************************************/
+void Paint_SetMirroring(UBYTE mirror)
+{
+    if (mirror == MIRROR_NONE || mirror == MIRROR_HORIZONTAL ||
+        mirror == MIRROR_VERTICAL || mirror == MIRROR_ORIGIN)
+    {
+        Debug("mirror image x:%s, y:%s\r\n", (mirror & 0x01) ? "mirror" : "none", ((mirror >> 1) & 0x01) ? "mirror" : "none");
+        Paint.Mirror = mirror;
+        Paint_BindOrientation();
+    }
+    else
+    {
+        Debug("mirror should be MIRROR_NONE, MIRROR_HORIZONTAL, \
+        MIRROR_VERTICAL or MIRROR_ORIGIN\r\n");
+    }
+}
+
+/******************************************************************************
+function: Work out Paint_Map for the current rotation and mirroring
+******************************************************************************/
+static void Paint_BindOrientation(void)
+{
+    const int XLast = Paint.WidthMemory - 1;
+    const int YLast = Paint.HeightMemory - 1;
+
+    Paint_Map.Valid = true;
+    switch (Paint.Rotate)
+    {
+    case 0: // X = x, Y = y
+        Paint_Map.XOffset = 0;
+        Paint_Map.XFromX = 1;
+        Paint_Map.XFromY = 0;
+        Paint_Map.YOffset = 0;
+        Paint_Map.YFromX = 0;
+        Paint_Map.YFromY = 1;
+        break;
+    case 90: // X = WidthMemory - 1 - y, Y = x
+        Paint_Map.XOffset = XLast;
+        Paint_Map.XFromX = 0;
+        Paint_Map.XFromY = -1;
+        Paint_Map.YOffset = 0;
+        Paint_Map.YFromX = 1;
+        Paint_Map.YFromY = 0;
+        break;
+    case 180: // X = WidthMemory - 1 - x, Y = HeightMemory - 1 - y
+        Paint_Map.XOffset = XLast;
+        Paint_Map.XFromX = -1;
+        Paint_Map.XFromY = 0;
+        Paint_Map.YOffset = YLast;
+        Paint_Map.YFromX = 0;
+        Paint_Map.YFromY = -1;
+        break;
+    case 270: // X = y, Y = HeightMemory - 1 - x
+        Paint_Map.XOffset = 0;
+        Paint_Map.XFromX = 0;
+        Paint_Map.XFromY = 1;
+        Paint_Map.YOffset = YLast;
+        Paint_Map.YFromX = -1;
+        Paint_Map.YFromY = 0;
+        break;
+    default:
+        Paint_Map.Valid = false;
+        Paint_Map.Identity = false;
+        return;
+    }
+
+    if (Paint.Mirror & MIRROR_HORIZONTAL)
+    {
+        Paint_Map.XOffset = XLast - Paint_Map.XOffset;
+        Paint_Map.XFromX = -Paint_Map.XFromX;
+        Paint_Map.XFromY = -Paint_Map.XFromY;
+    }
+    if (Paint.Mirror & MIRROR_VERTICAL)
+    {
+        Paint_Map.YOffset = YLast - Paint_Map.YOffset;
+        Paint_Map.YFromX = -Paint_Map.YFromX;
+        Paint_Map.YFromY = -Paint_Map.YFromY;
+    }
+
+    Paint_Map.Identity = (Paint_Map.XOffset == 0) && (Paint_Map.XFromX == 1) && (Paint_Map.XFromY == 0) &&
+                         (Paint_Map.YOffset == 0) && (Paint_Map.YFromX == 0) && (Paint_Map.YFromY == 1);
+}
+
+/******************************************************************************
+function: Map a point from logical (rotated and mirrored) to image memory coordinates
+parameter:
+    Xpoint : At point X
+    Ypoint : At point Y
+    X      : Column in memory
+    Y      : Row in memory
+return:
+    false if the rotation is invalid
+******************************************************************************/
+static inline bool Paint_ToMemory(UWORD Xpoint, UWORD Ypoint, UWORD *X, UWORD *Y)
+{
+    *X = Paint_Map.XOffset + (Paint_Map.XFromX * Xpoint) + (Paint_Map.XFromY * Ypoint);
+    *Y = Paint_Map.YOffset + (Paint_Map.YFromX * Xpoint) + (Paint_Map.YFromY * Ypoint);
+    return Paint_Map.Valid;
+}
+
+/******************************************************************************
+function: The byte pattern that paints Color at each scale, repeated through
+          a 32-bit word so that whole words can be stored at once
+parameter:
+    Color : Painted colors
+******************************************************************************/
+static UDOUBLE Paint_Pattern1(UWORD Color)
+{
+    return ((Color & 0xff) == BLACK) ? 0x00000000 : 0xFFFFFFFF;
+}
+
+static UDOUBLE Paint_Pattern2(UWORD Color)
+{
+    return 0x55555555 * (Color % 4);
+}
+
+static UDOUBLE Paint_Pattern4(UWORD Color)
+{
+    return 0x11111111 * (Color % 16);
+}
+
+static UDOUBLE Paint_Pattern16(UWORD Color)
+{
+    // RGB565 is stored high byte first. The image is word aligned, so pixels start on even bytes.
+    UDOUBLE Pixel = ((Color & 0xff) << 8) | (0xff & (Color >> 8));
+    return Pixel | (Pixel << 16);
+}
+
+/******************************************************************************
+function: Write one pixel of a fill pattern at image memory coordinates, one writer per scale.
+          Bounds are not checked: Y must be in the band.
+parameter:
+    X       : Column in memory
+    Y       : Row in memory
+    Pattern : From Paint_Pattern()
+******************************************************************************/
+static void HOT_FUNC(Paint_WritePixel1)(UWORD X, UWORD Y, UDOUBLE Pattern)
+{
+    UBYTE *Addr = Paint.Image + X / 8 + (UDOUBLE)(Y - Paint_BandStart) * Paint.WidthByte;
+    UBYTE Mask = 0x80 >> (X % 8);
+    *Addr = (*Addr & ~Mask) | (Pattern & Mask);
+}
+
+static void HOT_FUNC(Paint_WritePixel2)(UWORD X, UWORD Y, UDOUBLE Pattern)
+{
+    UBYTE *Addr = Paint.Image + X / 4 + (UDOUBLE)(Y - Paint_BandStart) * Paint.WidthByte;
+    UBYTE Mask = 0xC0 >> ((X % 4) * 2);
+    *Addr = (*Addr & ~Mask) | (Pattern & Mask);
+}
+
+static void HOT_FUNC(Paint_WritePixel4)(UWORD X, UWORD Y, UDOUBLE Pattern)
+{
+    UBYTE *Addr = Paint.Image + X / 2 + (UDOUBLE)(Y - Paint_BandStart) * Paint.WidthByte;
+    UBYTE Mask = 0xF0 >> ((X % 2) * 4);
+    *Addr = (*Addr & ~Mask) | (Pattern & Mask);
+}
+
+static void HOT_FUNC(Paint_WritePixel16)(UWORD X, UWORD Y, UDOUBLE Pattern)
+{
+    // The pattern is already byte swapped, so this is a single halfword store
+    *(UWORD *)(Paint.Image + X * 2 + (UDOUBLE)(Y - Paint_BandStart) * Paint.WidthByte) = (UWORD)Pattern;
+}
+
+/******************************************************************************
+function: Pick the pixel writer for the current scale
+******************************************************************************/
+static void Paint_BindScale(void)
+{
+    switch (Paint.Scale)
+    {
+    case 4:
+        Paint_WritePixel = Paint_WritePixel2;
+        Paint_Pattern = Paint_Pattern2;
+        Paint_BitsPerPixel = 2;
+        break;
+    case 16:
+        Paint_WritePixel = Paint_WritePixel4;
+        Paint_Pattern = Paint_Pattern4;
+        Paint_BitsPerPixel = 4;
+        break;
+    case 65:
+        Paint_WritePixel = Paint_WritePixel16;
+        Paint_Pattern = Paint_Pattern16;
+        Paint_BitsPerPixel = 16;
+        break;
+    case 2:
+    default:
+        Paint_WritePixel = Paint_WritePixel1;
+        Paint_Pattern = Paint_Pattern1;
+        Paint_BitsPerPixel = 1;
+        break;
+    }
+}
+
+/******************************************************************************
+function: Draw one pixel of a fill pattern, in logical coordinates
+parameter:
+    Xpoint  : At point X
+    Ypoint  : At point Y
+    Pattern : From Paint_Pattern()
+******************************************************************************/
+static inline void Paint_PlotPattern(UWORD Xpoint, UWORD Ypoint, UDOUBLE Pattern)
+{
+    if (Xpoint > Paint.Width || Ypoint > Paint.Height)
+    {
+        Debug("Exceeding display boundaries\r\n");
+        return;
+    }
+    if (Paint_Map.Identity)
+    {
+        Paint_SetMemoryPixel(Xpoint, Ypoint, Pattern);
+        return;
+    }
+    UWORD X, Y;
+    if (Paint_ToMemory(Xpoint, Ypoint, &X, &Y))
+    {
+        Paint_SetMemoryPixel(X, Y, Pattern);
+    }
+}
+
+/******************************************************************************
+function: Draw Pixels
+parameter:
+    Xpoint : At point X
+    Ypoint : At point Y
+    Color  : Painted colors
+******************************************************************************/
+void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+    Paint_PlotPattern(Xpoint, Ypoint, Paint_Pattern(Color));
+}
+
+/******************************************************************************
+function: Write one pixel at image memory coordinates, bypassing rotation and mirroring
+parameter:
+    X       : Column in memory
+    Y       : Row in memory
+    Pattern : From Paint_Pattern()
+******************************************************************************/
+static void HOT_FUNC(Paint_SetMemoryPixel)(UWORD X, UWORD Y, UDOUBLE Pattern)
+{
+    if (X >= Paint.WidthMemory || Y >= Paint.HeightMemory)
+    {
+        Debug("Exceeding display boundaries\r\n");
+        return;
+    }
+    if (Y < Paint_BandStart || Y >= Paint_BandEnd)
+    {
+        return;
+    }
+
+    if (Paint_Dirty.Xend <= Paint_Dirty.Xstart || Paint_Dirty.Yend <= Paint_Dirty.Ystart)
+    {
+        Paint_Dirty.Xstart = X;
+        Paint_Dirty.Ystart = Y;
+        Paint_Dirty.Xend = X + 1;
+        Paint_Dirty.Yend = Y + 1;
+    }
+    else
+    {
+        if (X < Paint_Dirty.Xstart)
+            Paint_Dirty.Xstart = X;
+        else if (X >= Paint_Dirty.Xend)
+            Paint_Dirty.Xend = X + 1;
+        if (Y < Paint_Dirty.Ystart)
+            Paint_Dirty.Ystart = Y;
+        else if (Y >= Paint_Dirty.Yend)
+            Paint_Dirty.Yend = Y + 1;
+    }
+
+    Paint_WritePixel(X, Y, Pattern);
+}
+
+/******************************************************************************
+function: Fill bytes [Start, End) with Pattern, a whole word at a time where aligned
+******************************************************************************/
+static void HOT_FUNC(Paint_FillBytes)(UBYTE *Start, UBYTE *End, UDOUBLE Pattern)
+{
+    while (Start < End && ((uintptr_t)Start & 0x03))
+    {
+        *Start = 0xff & (Pattern >> (8 * ((uintptr_t)Start & 0x03)));
+        Start++;
+    }
+
+    UDOUBLE *Word = (UDOUBLE *)Start;
+    UDOUBLE *WordEnd = (UDOUBLE *)((uintptr_t)End & ~(uintptr_t)0x03);
+    while (Word < WordEnd)
+    {
+        *Word++ = Pattern;
+    }
+
+    Start = (UBYTE *)Word;
+    while (Start < End)
+    {
+        *Start = 0xff & (Pattern >> (8 * ((uintptr_t)Start & 0x03)));
+        Start++;
+    }
+}
+
+/******************************************************************************
+function: Fill part of one row of image memory. Bounds are not checked: Y must be in the band.
+parameter:
+    Xstart  : First column in memory
+    Xend    : One past the last column in memory
+    Y       : Row in memory
+    Pattern : From Paint_Pattern()
+******************************************************************************/
+static void HOT_FUNC(Paint_FillMemoryRow)(UWORD Xstart, UWORD Xend, UWORD Y, UDOUBLE Pattern)
+{
+    UBYTE *Row = Paint.Image + (UDOUBLE)(Y - Paint_BandStart) * Paint.WidthByte;
+    UWORD Bpp = Paint_BitsPerPixel;
+    if (Bpp == 16)
+    {
+        Paint_FillBytes(Row + Xstart * 2, Row + Xend * 2, Pattern);
+        return;
+    }
+
+    // Packed formats: the bytes at either end, which are shared with pixels outside the span, are masked in
+    UDOUBLE BitStart = (UDOUBLE)Xstart * Bpp;
+    UDOUBLE BitEnd = (UDOUBLE)Xend * Bpp;
+    UBYTE *First = Row + BitStart / 8;
+    UBYTE *Last = Row + BitEnd / 8;
+    UBYTE HeadMask = 0xFF >> (BitStart % 8);
+    UBYTE TailMask = ~(0xFF >> (BitEnd % 8));
+    if (First == Last)
+    {
+        UBYTE Mask = HeadMask & TailMask;
+        *First = (*First & ~Mask) | (Pattern & Mask);
+        return;
+    }
+
+    if (BitStart % 8)
+    {
+        *First = (*First & ~HeadMask) | (Pattern & HeadMask);
+        First++;
+    }
+    Paint_FillBytes(First, Last, Pattern);
+    if (BitEnd % 8)
+    {
+        *Last = (*Last & ~TailMask) | (Pattern & TailMask);
+    }
+}
+
+/******************************************************************************
+function: Find the window of image memory a logical window covers.
+          Rotation and mirroring only ever swap and flip the axes, so the corners give us the whole window.
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : One past the x end point
+    Yend   : One past the y end point
+    Rect   : Filled in with the window, in image memory coordinates
+return:
+    false (leaving Rect alone) if the window is empty once clipped to the image
+******************************************************************************/
+bool Paint_WindowToMemory(int Xstart, int Ystart, int Xend, int Yend, PAINT_RECT *Rect)
+{
+    Xstart = (Xstart < 0) ? 0 : Xstart;
+    Ystart = (Ystart < 0) ? 0 : Ystart;
+    Xend = (Xend > Paint.Width) ? Paint.Width : Xend;
+    Yend = (Yend > Paint.Height) ? Paint.Height : Yend;
+    if (Xend <= Xstart || Yend <= Ystart)
+    {
+        return false;
+    }
+
+    UWORD X0, Y0, X1, Y1;
+    if (!Paint_ToMemory(Xstart, Ystart, &X0, &Y0) || !Paint_ToMemory(Xend - 1, Yend - 1, &X1, &Y1))
+    {
+        return false;
+    }
+
+    Rect->Xstart = (X0 < X1) ? X0 : X1;
+    Rect->Ystart = (Y0 < Y1) ? Y0 : Y1;
+    Rect->Xend = ((X0 < X1) ? X1 : X0) + 1;
+    Rect->Yend = ((Y0 < Y1) ? Y1 : Y0) + 1;
+    return true;
+}
+
+/******************************************************************************
+function: Fill a rectangle given in logical (rotated and mirrored) coordinates.
+          Rotation and mirroring are resolved once for the whole rectangle,
+          which is then filled a row of image memory at a time.
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : One past the x end point
+    Yend   : One past the y end point
+    Color  : Painted colors
+******************************************************************************/
+static void Paint_FillLogicalRect(int Xstart, int Ystart, int Xend, int Yend, UWORD Color)
+{
+    PAINT_RECT Rect;
+    if (Paint_WindowToMemory(Xstart, Ystart, Xend, Yend, &Rect))
+    {
+        Paint_ClearMemoryWindow(&Rect, Color);
+    }
+}
+
+/******************************************************************************
+function: Fill every pixel that Paint_DrawPoint(X, Y, Color, Dot_Pixel, DOT_FILL_AROUND)
+          would, for every X in [Xstart, Xend] and Y in [Ystart, Yend], as a single rectangle.
+******************************************************************************/
+static void Paint_FillDots(int Xstart, int Ystart, int Xend, int Yend, UWORD Color, DOT_PIXEL Dot_Pixel)
+{
+    // Paint_DrawPoint() skips dots that would poke above the top of the image altogether
+    Ystart = (Ystart < (int)Dot_Pixel) ? (int)Dot_Pixel : Ystart;
+    if (Yend < Ystart)
+    {
+        return;
+    }
+    Paint_FillLogicalRect(Xstart - Dot_Pixel, Ystart - Dot_Pixel, Xend + Dot_Pixel - 1, Yend + Dot_Pixel - 1, Color);
+}
+
+/******************************************************************************
+function: Fill a rectangle (exclusive end points)
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : One past the x end point
+    Yend   : One past the y end point
+    Color  : Painted colors
+******************************************************************************/
+void Paint_FillRect(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
+{
+    Paint_FillLogicalRect(Xstart, Ystart, Xend, Yend, Color);
+}
+
+/******************************************************************************
+function: Fill a horizontal run of Length pixels starting at (Xpoint, Ypoint)
+******************************************************************************/
+void Paint_FillHSpan(UWORD Xpoint, UWORD Ypoint, UWORD Length, UWORD Color)
+{
+    Paint_FillLogicalRect(Xpoint, Ypoint, (int)Xpoint + Length, (int)Ypoint + 1, Color);
+}
+
+/******************************************************************************
+function: Fill a vertical run of Length pixels starting at (Xpoint, Ypoint)
+******************************************************************************/
+void Paint_FillVSpan(UWORD Xpoint, UWORD Ypoint, UWORD Length, UWORD Color)
+{
+    Paint_FillLogicalRect(Xpoint, Ypoint, (int)Xpoint + 1, (int)Ypoint + Length, Color);
+}
+
+/******************************************************************************
+function: Clear the color of the picture
+parameter:
+    Color : Painted colors
+******************************************************************************/
+void Paint_Clear(UWORD Color)
+{
+    Paint_MarkAllDirty();
+    // Rows are contiguous, so this is one long span (padding at the ends of rows included)
+    Paint_FillBytes(Paint.Image, Paint.Image + (UDOUBLE)Paint.WidthByte * (Paint_BandEnd - Paint_BandStart), Paint_Pattern(Color));
+}
+
+/******************************************************************************
+function: Clear a window given in image memory coordinates (ignores rotation and mirroring)
+parameter:
+    Rect  : The window to clear. Clipped to the image (and the band).
+    Color : Painted colors
+******************************************************************************/
+void Paint_ClearMemoryWindow(const PAINT_RECT *Rect, UWORD Color)
+{
+    UWORD Xend = (Rect->Xend > Paint.WidthMemory) ? Paint.WidthMemory : Rect->Xend;
+    UWORD Ystart = (Rect->Ystart < Paint_BandStart) ? Paint_BandStart : Rect->Ystart;
+    UWORD Yend = (Rect->Yend > Paint_BandEnd) ? Paint_BandEnd : Rect->Yend;
+    if (Xend <= Rect->Xstart || Yend <= Ystart)
+    {
+        return;
+    }
+
+    Paint_MarkDirty(Rect->Xstart, Ystart, Xend, Yend);
+    UDOUBLE Pattern = Paint_Pattern(Color);
+    for (UWORD Y = Ystart; Y < Yend; Y++)
+    {
+        Paint_FillMemoryRow(Rect->Xstart, Xend, Y, Pattern);
+    }
+}
+
+/******************************************************************************
+function: Get the bounding box of everything written since the last Paint_ResetDirty()
+parameter:
+    Rect : Filled in with the dirty region (memory coordinates)
+return:
+    false if nothing has been written
+******************************************************************************/
+bool Paint_GetDirty(PAINT_RECT *Rect)
+{
+    *Rect = Paint_Dirty;
+    return (Paint_Dirty.Xend > Paint_Dirty.Xstart) && (Paint_Dirty.Yend > Paint_Dirty.Ystart);
+}
+
+/******************************************************************************
+function: Grow the dirty region to include the given window (memory coordinates)
+******************************************************************************/
+void Paint_MarkDirty(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    PAINT_RECT r = {Xstart, Ystart, Xend, Yend};
+    Paint_RectUnion(&Paint_Dirty, &r);
+}
+
+void Paint_MarkAllDirty(void)
+{
+    Paint_Dirty.Xstart = 0;
+    Paint_Dirty.Ystart = 0;
+    Paint_Dirty.Xend = Paint.WidthMemory;
+    Paint_Dirty.Yend = Paint.HeightMemory;
+}
+
+void Paint_ResetDirty(void)
+{
+    Paint_Dirty.Xstart = 0;
+    Paint_Dirty.Ystart = 0;
+    Paint_Dirty.Xend = 0;
+    Paint_Dirty.Yend = 0;
+}
+
+/******************************************************************************
+function: Dst = bounding box of Dst and Src. Empty rectangles are ignored.
+******************************************************************************/
+void Paint_RectUnion(PAINT_RECT *Dst, const PAINT_RECT *Src)
+{
+    if (Src->Xend <= Src->Xstart || Src->Yend <= Src->Ystart)
+    {
+        return;
+    }
+    if (Dst->Xend <= Dst->Xstart || Dst->Yend <= Dst->Ystart)
+    {
+        *Dst = *Src;
+        return;
+    }
+    if (Src->Xstart < Dst->Xstart)
+        Dst->Xstart = Src->Xstart;
+    if (Src->Ystart < Dst->Ystart)
+        Dst->Ystart = Src->Ystart;
+    if (Src->Xend > Dst->Xend)
+        Dst->Xend = Src->Xend;
+    if (Src->Yend > Dst->Yend)
+        Dst->Yend = Src->Yend;
+}
+
+/******************************************************************************
+function: Clear the color of a window
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : x end point
+    Yend   : y end point
+    Color  : Painted colors
+******************************************************************************/
+void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
+{
+    Paint_FillLogicalRect(Xstart, Ystart, Xend, Yend, Color);
+}
+
+/******************************************************************************
+function: Draw Point(Xpoint, Ypoint) Fill the color
+parameter:
+    Xpoint		: The Xpoint coordinate of the point
+    Ypoint		: The Ypoint coordinate of the point
+    Color		: Painted color
+    Dot_Pixel	: point size
+    Dot_Style	: point Style
+******************************************************************************/
+void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color,
+                     DOT_PIXEL Dot_Pixel, DOT_STYLE Dot_Style)
+{
+    if (Xpoint > Paint.Width || Ypoint > Paint.Height)
+    {
+        Debug("Paint_DrawPoint Input exceeds the normal display range\r\n");
+        printf("Xpoint = %d , Paint.Width = %d  \r\n ", Xpoint, Paint.Width);
+        printf("Ypoint = %d , Paint.Height = %d  \r\n ", Ypoint, Paint.Height);
+        return;
+    }
+
+    if (Dot_Style == DOT_FILL_AROUND)
+    {
+        Paint_FillDots(Xpoint, Ypoint, Xpoint, Ypoint, Color, Dot_Pixel);
+    }
+    else
+    {
+        Paint_FillLogicalRect((int)Xpoint - 1, (int)Ypoint - 1, (int)Xpoint + Dot_Pixel - 1, (int)Ypoint + Dot_Pixel - 1, Color);
+    }
+}
+
+/** Dot rows remembered by Paint_DrawThickLine(). A power of two, at least 2 * DOT_PIXEL_8X8 - 1. */
+#define THICK_LINE_ROWS 16
+
+/** State for Paint_DrawThickLine(). Rows are counted from Ystart in the direction of travel. */
+typedef struct
+{
+    int Xmin[THICK_LINE_ROWS]; // Leftmost dot on each dot row
+    int Xmax[THICK_LINE_ROWS]; // Rightmost dot on each dot row
+    int Ystart;
+    int YAddway;
+    int Width;                 // Dot size
+    int Before;                // Rows each dot reaches back, against the direction of travel
+    int After;                 // Rows each dot reaches forward
+    int K;                     // Dot rows since Ystart
+    UWORD Color;
+} PAINT_THICK_LINE;
+
+/******************************************************************************
+function: Fill one row of a thick line: the union of every dot from dot rows
+          [Row - After, Row + Before] that reaches it, as a single span
+parameter:
+    Line  : The line so far
+    Row   : Row to fill (relative to Ystart)
+    Klast : Last dot row drawn so far
+******************************************************************************/
+static void Paint_FillThickLineRow(const PAINT_THICK_LINE *Line, int Row, int Klast)
+{
+    int First = Row - Line->After;
+    int Last = Row + Line->Before;
+    First = (First < 0) ? 0 : First;
+    Last = (Last > Klast) ? Klast : Last;
+
+    int Xmin = INT_MAX;
+    int Xmax = INT_MIN;
+    for (int K = First; K <= Last; K++)
+    {
+        Xmin = (Line->Xmin[K & (THICK_LINE_ROWS - 1)] < Xmin) ? Line->Xmin[K & (THICK_LINE_ROWS - 1)] : Xmin;
+        Xmax = (Line->Xmax[K & (THICK_LINE_ROWS - 1)] > Xmax) ? Line->Xmax[K & (THICK_LINE_ROWS - 1)] : Xmax;
+    }
+    if (Xmax < Xmin)
+    {
+        return;
+    }
+
+    // Each dot covers [X - Width, X + Width - 2], same as Paint_DrawPoint()
+    int Y = Line->Ystart + Line->YAddway * Row;
+    Paint_FillLogicalRect(Xmin - Line->Width, Y, Xmax + Line->Width - 1, Y + 1, Line->Color);
+}
+
+/******************************************************************************
+function: Start a thick stroke whose dots only ever move one way in Y
+parameter:
+    Line    : The stroke
+    Ystart  : Y of the first dot
+    YAddway : 1 if the dots move down, -1 if up
+******************************************************************************/
+static void Paint_ThickLineBegin(PAINT_THICK_LINE *Line, int Ystart, int YAddway, UWORD Color, DOT_PIXEL Line_width)
+{
+    Line->Ystart = Ystart;
+    Line->YAddway = YAddway;
+    Line->Width = (Line_width > DOT_PIXEL_8X8) ? DOT_PIXEL_8X8 : Line_width;
+    Line->Before = (YAddway > 0) ? Line->Width : Line->Width - 2;
+    Line->After = (YAddway > 0) ? Line->Width - 2 : Line->Width;
+    Line->K = 0;
+    Line->Color = Color;
+    Line->Xmin[0] = INT_MAX;
+    Line->Xmax[0] = INT_MIN;
+}
+
+/******************************************************************************
+function: Add a dot to a thick stroke. Each dot must be on the same row as the
+          one before it or on a later one (in the stroke's direction).
+******************************************************************************/
+static void Paint_ThickLineAddDot(PAINT_THICK_LINE *Line, int Xpoint, int Ypoint)
+{
+    const int Row = (Ypoint - Line->Ystart) * Line->YAddway;
+    while (Line->K < Row)
+    {
+        // Dot row K is done, which is the last one that reaches back to row K - Before
+        Paint_FillThickLineRow(Line, Line->K - Line->Before, Line->K);
+        Line->K++;
+        Line->Xmin[Line->K & (THICK_LINE_ROWS - 1)] = INT_MAX;
+        Line->Xmax[Line->K & (THICK_LINE_ROWS - 1)] = INT_MIN;
+    }
+
+    // Paint_DrawPoint() drops dots that would poke above the top of the image altogether
+    if (Ypoint >= Line->Width)
+    {
+        int i = Line->K & (THICK_LINE_ROWS - 1);
+        Line->Xmin[i] = (Xpoint < Line->Xmin[i]) ? Xpoint : Line->Xmin[i];
+        Line->Xmax[i] = (Xpoint > Line->Xmax[i]) ? Xpoint : Line->Xmax[i];
+    }
+}
+
+/******************************************************************************
+function: Add a dot at every step of the Bresenham walk from one point to
+          another (the same walk as Paint_DrawLine()) to a thick stroke
+******************************************************************************/
+static void Paint_ThickLineWalk(PAINT_THICK_LINE *Line, int Xstart, int Ystart, int Xend, int Yend)
+{
+    int Xpoint = Xstart;
+    int Ypoint = Ystart;
+    int dx = Xend - Xstart >= 0 ? Xend - Xstart : Xstart - Xend;
+    int dy = Yend - Ystart <= 0 ? Yend - Ystart : Ystart - Yend;
+    int XAddway = Xstart < Xend ? 1 : -1;
+    int YAddway = Ystart < Yend ? 1 : -1;
+    int Esp = dx + dy;
+
+    for (;;)
+    {
+        Paint_ThickLineAddDot(Line, Xpoint, Ypoint);
+        if (2 * Esp >= dy)
+        {
+            if (Xpoint == Xend)
+                break;
+            Esp += dy;
+            Xpoint += XAddway;
+        }
+        if (2 * Esp <= dx)
+        {
+            if (Ypoint == Yend)
+                break;
+            Esp += dx;
+            Ypoint += YAddway;
+        }
+    }
+}
+
+/******************************************************************************
+function: Fill the rows still waiting on the last dots of a thick stroke
+******************************************************************************/
+static void Paint_ThickLineEnd(PAINT_THICK_LINE *Line)
+{
+    for (int Row = Line->K - Line->Before; Row <= Line->K + Line->After; Row++)
+    {
+        Paint_FillThickLineRow(Line, Row, Line->K);
+    }
+}
+
+/******************************************************************************
+function: Draw a solid line of arbitrary slope, one span per row.
+          Covers exactly the pixels that stamping a dot at every Bresenham step would,
+          but touches each of them once.
+parameter:
+    Xstart ：Starting Xpoint point coordinates
+    Ystart ：Starting Xpoint point coordinates
+    Xend   ：End point Xpoint coordinate
+    Yend   ：End point Ypoint coordinate
+    Color  ：The color of the line segment
+    Line_width : Line width
+******************************************************************************/
+static void Paint_DrawThickLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
+                                UWORD Color, DOT_PIXEL Line_width)
+{
+    PAINT_THICK_LINE Line;
+    Paint_ThickLineBegin(&Line, Ystart, Ystart < Yend ? 1 : -1, Color, Line_width);
+    Paint_ThickLineWalk(&Line, Xstart, Ystart, Xend, Yend);
+    Paint_ThickLineEnd(&Line);
+}
+
+/******************************************************************************
+function: Draw a line of arbitrary slope
+parameter:
+    Xstart ：Starting Xpoint point coordinates
+    Ystart ：Starting Xpoint point coordinates
+    Xend   ：End point Xpoint coordinate
+    Yend   ：End point Ypoint coordinate
+    Color  ：The color of the line segment
+    Line_width : Line width
+    Line_Style: Solid and dotted lines
+******************************************************************************/
+void Paint_DrawLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
+                    UWORD Color, DOT_PIXEL Line_width, LINE_STYLE Line_Style)
+{
+    if (Xstart > Paint.Width || Ystart > Paint.Height ||
+        Xend > Paint.Width || Yend > Paint.Height)
+    {
+        Debug("Paint_DrawLine Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    if (Line_Style == LINE_STYLE_SOLID && (Xstart == Xend || Ystart == Yend))
+    {
+        // Horizontal and vertical lines: all the dots land in one rectangle
+        Paint_FillDots((Xstart < Xend) ? Xstart : Xend, (Ystart < Yend) ? Ystart : Yend,
+                       (Xstart < Xend) ? Xend : Xstart, (Ystart < Yend) ? Yend : Ystart, Color, Line_width);
+        return;
+    }
+
+    if (Line_Style == LINE_STYLE_SOLID)
+    {
+        Paint_DrawThickLine(Xstart, Ystart, Xend, Yend, Color, Line_width);
+        return;
+    }
+
+    UWORD Xpoint = Xstart;
+    UWORD Ypoint = Ystart;
+    int dx = (int)Xend - (int)Xstart >= 0 ? Xend - Xstart : Xstart - Xend;
+    int dy = (int)Yend - (int)Ystart <= 0 ? Yend - Ystart : Ystart - Yend;
+
+    // Increment direction, 1 is positive, -1 is counter;
+    int XAddway = Xstart < Xend ? 1 : -1;
+    int YAddway = Ystart < Yend ? 1 : -1;
+
+    // Cumulative error
+    int Esp = dx + dy;
+    char Dotted_Len = 0;
+
+    for (;;)
+    {
+        Dotted_Len++;
+        // Painted dotted line, 2 point is really virtual
+        if (Line_Style == LINE_STYLE_DOTTED && Dotted_Len % 3 == 0)
+        {
+            // Debug("LINE_DOTTED\r\n");
+            if (Color)
+                Paint_DrawPoint(Xpoint, Ypoint, BLACK, Line_width, DOT_STYLE_DFT);
+            else
+                Paint_DrawPoint(Xpoint, Ypoint, WHITE, Line_width, DOT_STYLE_DFT);
+            Dotted_Len = 0;
+        }
+        else
+        {
+            Paint_DrawPoint(Xpoint, Ypoint, Color, Line_width, DOT_STYLE_DFT);
+        }
+        if (2 * Esp >= dy)
+        {
+            if (Xpoint == Xend)
+                break;
+            Esp += dy;
+            Xpoint += XAddway;
+        }
+        if (2 * Esp <= dx)
+        {
+            if (Ypoint == Yend)
+                break;
+            Esp += dx;
+            Ypoint += YAddway;
+        }
+    }
+}
+
+/******************************************************************************
+function: Draw a rectangle
+parameter:
+    Xstart ：Rectangular  Starting Xpoint point coordinates
+    Ystart ：Rectangular  Starting Xpoint point coordinates
+    Xend   ：Rectangular  End point Xpoint coordinate
+    Yend   ：Rectangular  End point Ypoint coordinate
+    Color  ：The color of the Rectangular segment
+    Line_width: Line width
+    Draw_Fill : Whether to fill the inside of the rectangle
+******************************************************************************/
+void Paint_DrawRectangle(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
+                         UWORD Color, DOT_PIXEL Line_width, DRAW_FILL Draw_Fill)
+{
+    if (Xstart > Paint.Width || Ystart > Paint.Height ||
+        Xend > Paint.Width || Yend > Paint.Height)
+    {
+        Debug("Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    if (Draw_Fill)
+    {
+        // Same pixels as a solid line per row from Ystart up to (not including) Yend
+        if (Yend > Ystart)
+        {
+            Paint_FillDots((Xstart < Xend) ? Xstart : Xend, Ystart, (Xstart < Xend) ? Xend : Xstart, Yend - 1, Color, Line_width);
+        }
+    }
+    else
+    {
+        Paint_DrawLine(Xstart, Ystart, Xend, Ystart, Color, Line_width, LINE_STYLE_SOLID);
+        Paint_DrawLine(Xstart, Ystart, Xstart, Yend, Color, Line_width, LINE_STYLE_SOLID);
+        Paint_DrawLine(Xend, Yend, Xend, Ystart, Color, Line_width, LINE_STYLE_SOLID);
+        Paint_DrawLine(Xend, Yend, Xstart, Yend, Color, Line_width, LINE_STYLE_SOLID);
+    }
+}
+
+/******************************************************************************
+function: Use the 8-point method to draw a circle of the
+            specified size at the specified position->
+parameter:
+    X_Center  ：Center X coordinate
+    Y_Center  ：Center Y coordinate
+    Radius    ：circle Radius
+    Color     ：The color of the ：circle segment
+    Line_width: Line width
+    Draw_Fill : Whether to fill the inside of the Circle
+******************************************************************************/
+void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius,
+                      UWORD Color, DOT_PIXEL Line_width, DRAW_FILL Draw_Fill)
+{
+    if (X_Center > Paint.Width || Y_Center >= Paint.Height)
+    {
+        Debug("Paint_DrawCircle Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    // Draw a circle from(0, R) as a starting point
+    int16_t XCurrent, YCurrent;
+    XCurrent = 0;
+    YCurrent = Radius;
+
+    // Cumulative error,judge the next point of the logo
+    int16_t Esp = 3 - (Radius << 1);
+
+    if (Draw_Fill == DRAW_FILL_FULL)
+    {
+        while (XCurrent <= YCurrent)
+        { // Realistic circles, as horizontal spans through each pair of octants
+            Paint_FillDots(X_Center - YCurrent, Y_Center + XCurrent, X_Center + YCurrent, Y_Center + XCurrent, Color, DOT_PIXEL_DFT);
+            Paint_FillDots(X_Center - YCurrent, Y_Center - XCurrent, X_Center + YCurrent, Y_Center - XCurrent, Color, DOT_PIXEL_DFT);
+            Paint_FillDots(X_Center - XCurrent, Y_Center + YCurrent, X_Center + XCurrent, Y_Center + YCurrent, Color, DOT_PIXEL_DFT);
+            Paint_FillDots(X_Center - XCurrent, Y_Center - YCurrent, X_Center + XCurrent, Y_Center - YCurrent, Color, DOT_PIXEL_DFT);
+            if (Esp < 0)
+                Esp += 4 * XCurrent + 6;
+            else
+            {
+                Esp += 10 + 4 * (XCurrent - YCurrent);
+                YCurrent--;
+            }
+            XCurrent++;
+        }
+    }
+    else
+    { // Draw a hollow circle
+        while (XCurrent <= YCurrent)
+        {
+            Paint_DrawPoint(X_Center + XCurrent, Y_Center + YCurrent, Color, Line_width, DOT_STYLE_DFT); // 1
+            Paint_DrawPoint(X_Center - XCurrent, Y_Center + YCurrent, Color, Line_width, DOT_STYLE_DFT); // 2
+            Paint_DrawPoint(X_Center - YCurrent, Y_Center + XCurrent, Color, Line_width, DOT_STYLE_DFT); // 3
+            Paint_DrawPoint(X_Center - YCurrent, Y_Center - XCurrent, Color, Line_width, DOT_STYLE_DFT); // 4
+            Paint_DrawPoint(X_Center - XCurrent, Y_Center - YCurrent, Color, Line_width, DOT_STYLE_DFT); // 5
+            Paint_DrawPoint(X_Center + XCurrent, Y_Center - YCurrent, Color, Line_width, DOT_STYLE_DFT); // 6
+            Paint_DrawPoint(X_Center + YCurrent, Y_Center - XCurrent, Color, Line_width, DOT_STYLE_DFT); // 7
+            Paint_DrawPoint(X_Center + YCurrent, Y_Center + XCurrent, Color, Line_width, DOT_STYLE_DFT); // 0
+
+            if (Esp < 0)
+                Esp += 4 * XCurrent + 6;
+            else
+            {
+                Esp += 10 + 4 * (XCurrent - YCurrent);
+                YCurrent--;
+            }
+            XCurrent++;
+        }
+    }
+}
+
+/** sin() of 0 to 90 degrees, in Q14. */
+static const int16_t Paint_SinQ14[91] = {
+    0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+    2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+    5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+    8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384,
+};
+
+/******************************************************************************
+function: The direction of an angle in whole degrees (clockwise from +x, as y
+          runs down the image), as cosine and sine in Q14
+******************************************************************************/
+static void Paint_AngleVector(int Angle, int *Cos, int *Sin)
+{
+    Angle %= 360;
+    Angle = (Angle < 0) ? Angle + 360 : Angle;
+    if (Angle <= 90)
+    {
+        *Cos = Paint_SinQ14[90 - Angle];
+        *Sin = Paint_SinQ14[Angle];
+    }
+    else if (Angle <= 180)
+    {
+        *Cos = -Paint_SinQ14[Angle - 90];
+        *Sin = Paint_SinQ14[180 - Angle];
+    }
+    else if (Angle <= 270)
+    {
+        *Cos = -Paint_SinQ14[270 - Angle];
+        *Sin = -Paint_SinQ14[Angle - 180];
+    }
+    else
+    {
+        *Cos = Paint_SinQ14[Angle - 270];
+        *Sin = -Paint_SinQ14[360 - Angle];
+    }
+}
+
+/******************************************************************************
+function: The largest integer whose square is at most N
+******************************************************************************/
+static int Paint_ISqrt(int N)
+{
+    UDOUBLE Rem = (N < 0) ? 0 : (UDOUBLE)N;
+    UDOUBLE Root = 0;
+    UDOUBLE Bit = 1UL << 30;
+    while (Bit > Rem)
+    {
+        Bit >>= 2;
+    }
+    while (Bit != 0)
+    {
+        if (Rem >= Root + Bit)
+        {
+            Rem -= Root + Bit;
+            Root = (Root >> 1) + Bit;
+        }
+        else
+        {
+            Root >>= 1;
+        }
+        Bit >>= 2;
+    }
+    return (int)Root;
+}
+
+/** The part of a circle's plane that Paint_DrawArc() draws in, as seen from the center. */
+typedef struct
+{
+    int StartCos, StartSin;
+    int EndCos, EndSin;
+    bool Wide;  // More than a half turn
+    bool Full;  // The whole turn
+} PAINT_SECTOR;
+
+/******************************************************************************
+function: Is the offset (X, Y) from the center clockwise of the sector's start
+          and anticlockwise of its end? Both edges count as inside.
+******************************************************************************/
+static inline bool Paint_InSector(const PAINT_SECTOR *Sector, int X, int Y)
+{
+    if (Sector->Full)
+    {
+        return true;
+    }
+    const bool AfterStart = (Sector->StartCos * Y - Sector->StartSin * X) >= 0;
+    const bool BeforeEnd = (X * Sector->EndSin - Y * Sector->EndCos) >= 0;
+    return Sector->Wide ? (AfterStart || BeforeEnd) : (AfterStart && BeforeEnd);
+}
+
+/******************************************************************************
+function: Fill the pixels of row Y (offsets Xfirst to Xlast from the center)
+          that are in the sector, a span per run of them
+******************************************************************************/
+static void Paint_FillSectorRow(const PAINT_SECTOR *Sector, int X_Center, int Y_Center, int Xfirst, int Xlast, int Y, UWORD Color)
+{
+    int RunStart = 0;
+    bool InRun = false;
+    for (int X = Xfirst; X <= Xlast; X++)
+    {
+        const bool In = Paint_InSector(Sector, X, Y);
+        if (In && !InRun)
+        {
+            RunStart = X;
+        }
+        else if (!In && InRun)
+        {
+            Paint_FillLogicalRect(X_Center + RunStart, Y_Center + Y, X_Center + X, Y_Center + Y + 1, Color);
+        }
+        InRun = In;
+    }
+    if (InRun)
+    {
+        Paint_FillLogicalRect(X_Center + RunStart, Y_Center + Y, X_Center + Xlast + 1, Y_Center + Y + 1, Color);
+    }
+}
+
+/******************************************************************************
+function: Draw part of the outline of a circle, a span per row of each side of
+          the stroke, touching only the pixels that show
+parameter:
+    X_Center    : Center X coordinate
+    Y_Center    : Center Y coordinate
+    Radius      : Circle radius
+    Start_Angle : Where the arc starts, in degrees clockwise from the right of the center
+    End_Angle   : Where it ends, going clockwise. A full turn or more past Start_Angle draws the whole circle.
+    Color       : The color of the arc
+    Line_width  : Line width. The stroke is 2 * Line_width thick, centered on Radius, about as
+                  thick as Paint_DrawCircle()'s on average round the circle.
+******************************************************************************/
+void Paint_DrawArc(UWORD X_Center, UWORD Y_Center, UWORD Radius, int Start_Angle, int End_Angle,
+                   UWORD Color, DOT_PIXEL Line_width)
+{
+    if (X_Center > Paint.Width || Y_Center >= Paint.Height)
+    {
+        Debug("Paint_DrawArc Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    PAINT_SECTOR Sector;
+    int Sweep = (End_Angle - Start_Angle) % 360;
+    Sweep = (Sweep < 0) ? Sweep + 360 : Sweep;
+    Sector.Full = (End_Angle - Start_Angle) >= 360;
+    if (Sweep == 0 && !Sector.Full)
+    {
+        return;
+    }
+    Sector.Wide = Sweep > 180;
+    Paint_AngleVector(Start_Angle, &Sector.StartCos, &Sector.StartSin);
+    Paint_AngleVector(End_Angle, &Sector.EndCos, &Sector.EndSin);
+
+    // The stroke is every pixel from Radius - Line_width to Radius + Line_width out from the center.
+    // The hole inside it is every pixel nearer than that; Hole2 is the largest squared distance in it.
+    const int Width = (Line_width > DOT_PIXEL_8X8) ? DOT_PIXEL_8X8 : Line_width;
+    const int Outer2 = ((int)Radius + Width) * ((int)Radius + Width);
+    const int Inner = (int)Radius - Width;
+    const int Hole2 = (Inner > 0) ? Inner * Inner - 1 : -1;
+
+    const int Reach = Paint_ISqrt(Outer2);
+    for (int Y = -Reach; Y <= Reach; Y++)
+    {
+        const int Yimage = (int)Y_Center + Y;
+        if (Yimage < 0 || Yimage >= Paint.Height)
+        {
+            continue;
+        }
+
+        const int Xouter = Paint_ISqrt(Outer2 - Y * Y);
+        if (Y * Y > Hole2)
+        {
+            Paint_FillSectorRow(&Sector, X_Center, Y_Center, -Xouter, Xouter, Y, Color);
+        }
+        else
+        {
+            const int Xhole = Paint_ISqrt(Hole2 - Y * Y);
+            Paint_FillSectorRow(&Sector, X_Center, Y_Center, -Xouter, -Xhole - 1, Y, Color);
+            Paint_FillSectorRow(&Sector, X_Center, Y_Center, Xhole + 1, Xouter, Y, Color);
+        }
+    }
+}
+
+/** Most straight pieces Paint_DrawCurve() breaks a curve into. */
+#define CURVE_MAX_SEGMENTS 32
+
+/** About how long (along the control polygon) each straight piece of a curve is, in pixels. */
+#define CURVE_SEGMENT_LENGTH 8
+
+/******************************************************************************
+function: Draw a quadratic Bezier curve as a solid stroke. The curve is broken
+          into short straight pieces, and each run of them that keeps going
+          the same way in Y is drawn as one stroke, a span per row, like
+          Paint_DrawLine() does a single line.
+parameter:
+    Xstart   : Starting point X coordinate
+    Ystart   : Starting point Y coordinate
+    Xcontrol : Control point X coordinate (the curve leaves and arrives heading for it). May be off the image.
+    Ycontrol : Control point Y coordinate. May be off the image.
+    Xend     : End point X coordinate
+    Yend     : End point Y coordinate
+    Color    : The color of the curve
+    Line_width : Line width
+******************************************************************************/
+void Paint_DrawCurve(UWORD Xstart, UWORD Ystart, int Xcontrol, int Ycontrol, UWORD Xend, UWORD Yend,
+                     UWORD Color, DOT_PIXEL Line_width)
+{
+    if (Xstart > Paint.Width || Ystart > Paint.Height ||
+        Xend > Paint.Width || Yend > Paint.Height)
+    {
+        Debug("Paint_DrawCurve Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    const int Length = abs(Xcontrol - (int)Xstart) + abs(Ycontrol - (int)Ystart) +
+                       abs((int)Xend - Xcontrol) + abs((int)Yend - Ycontrol);
+    int N = Length / CURVE_SEGMENT_LENGTH + 1;
+    N = (N > CURVE_MAX_SEGMENTS) ? CURVE_MAX_SEGMENTS : N;
+
+    // B(t) = (1 - t)^2 P0 + 2t(1 - t) Pc + t^2 P1, at t = i / N, rounded
+    int X[CURVE_MAX_SEGMENTS + 1];
+    int Y[CURVE_MAX_SEGMENTS + 1];
+    const int N2 = N * N;
+    for (int i = 0; i <= N; i++)
+    {
+        const int A = N - i;
+        X[i] = (A * A * Xstart + 2 * A * i * Xcontrol + i * i * Xend + N2 / 2) / N2;
+        Y[i] = (A * A * Ystart + 2 * A * i * Ycontrol + i * i * Yend + N2 / 2) / N2;
+    }
+
+    // A stroke's dots have to keep going one way in Y, so start a new one where the curve turns back
+    int First = 0;
+    while (First < N)
+    {
+        int YAddway = 0;
+        int Last = First;
+        while (Last < N)
+        {
+            const int Step = (Y[Last + 1] > Y[Last]) - (Y[Last + 1] < Y[Last]);
+            if (Step != 0 && YAddway != 0 && Step != YAddway)
+            {
+                break;
+            }
+            YAddway = (Step != 0) ? Step : YAddway;
+            Last++;
+        }
+
+        PAINT_THICK_LINE Line;
+        Paint_ThickLineBegin(&Line, Y[First], (YAddway > 0) ? 1 : -1, Color, Line_width);
+        for (int i = First; i < Last; i++)
+        {
+            Paint_ThickLineWalk(&Line, X[i], Y[i], X[i + 1], Y[i + 1]);
+        }
+        Paint_ThickLineEnd(&Line);
+        First = Last;
+    }
+}
+
+/**
+ * An edge of a polygon, for the scanline fill. Samples are taken Samples times per row,
+ * at the middle of each 1/Samples slice, and numbered from the top of the image.
+ **/
+typedef struct
+{
+    int First; // First sample the edge crosses
+    int Last;  // One past the last sample the edge crosses
+    int32_t X; // Where the edge crosses the current sample, Q16
+    int32_t Dx; // How far X moves per sample, Q16
+} PAINT_EDGE;
+
+/** Edge table and active edge table for one polygon. */
+typedef struct
+{
+    PAINT_EDGE Edges[PAINT_POLYGON_MAX_POINTS]; // Sorted by First
+    UWORD Count;
+    UWORD Next;                                 // First edge not yet active
+    UWORD Active[PAINT_POLYGON_MAX_POINTS];     // Indices of the edges crossing the current sample
+    UWORD ActiveCount;
+} PAINT_EDGE_TABLE;
+
+/******************************************************************************
+function: The first sample at or below Y, where Y is in 1/Scale of a pixel:
+          sample k sits at (k + 0.5) / Samples, so this is ceil(Y * Samples - 0.5)
+******************************************************************************/
+static int Paint_SampleAt(UWORD Y, int Samples, int Scale)
+{
+    return ((2 * (int)Y * Samples) + Scale - 1) / (2 * Scale);
+}
+
+/******************************************************************************
+function: Build the edge table for a closed polygon. Horizontal edges never
+          cross a sample, so they are left out.
+parameter:
+    Table   : Filled in
+    Points  : Vertices, in order. The last one joins back to the first.
+    Count   : Number of vertices
+    Samples : Samples per row
+    Scale   : Vertices are in 1/Scale of a pixel
+return:
+    The first and one past the last sample crossed by any edge
+******************************************************************************/
+static void Paint_BuildEdgeTable(PAINT_EDGE_TABLE *Table, const PAINT_POINT *Points, UWORD Count, int Samples,
+                                 int Scale, int *FirstSample, int *LastSample)
+{
+    Table->Count = 0;
+    Table->Next = 0;
+    Table->ActiveCount = 0;
+    *FirstSample = INT_MAX;
+    *LastSample = INT_MIN;
+
+    for (UWORD i = 0; i < Count; i++)
+    {
+        const PAINT_POINT *P0 = &Points[i];
+        const PAINT_POINT *P1 = &Points[(i + 1) % Count];
+        if (P0->Y == P1->Y)
+        {
+            continue;
+        }
+        const PAINT_POINT *Top = (P0->Y < P1->Y) ? P0 : P1;
+        const PAINT_POINT *Bottom = (P0->Y < P1->Y) ? P1 : P0;
+
+        // Start where the edge crosses its first sample, Offset / (2 * Samples * Scale) of a
+        // pixel below its top: half a sample, for a top on a whole pixel
+        PAINT_EDGE Edge;
+        int32_t Run = ((int32_t)Bottom->X - (int32_t)Top->X) * 65536;
+        int32_t Rise = ((int32_t)Bottom->Y - (int32_t)Top->Y) * Samples;
+        Edge.First = Paint_SampleAt(Top->Y, Samples, Scale);
+        Edge.Last = Paint_SampleAt(Bottom->Y, Samples, Scale);
+        if (Edge.First == Edge.Last)
+        {
+            continue;
+        }
+        int32_t Offset = ((2 * Edge.First + 1) * Scale) - (2 * (int32_t)Top->Y * Samples);
+        Edge.Dx = Run / Rise;
+        Edge.X = (((int32_t)Top->X * 65536) / Scale) + (int32_t)(((int64_t)Run * Offset) / (2 * Scale * Rise));
+
+        // Insertion sort by First sample
+        UWORD j = Table->Count++;
+        while (j > 0 && Table->Edges[j - 1].First > Edge.First)
+        {
+            Table->Edges[j] = Table->Edges[j - 1];
+            j--;
+        }
+        Table->Edges[j] = Edge;
+
+        *FirstSample = (Edge.First < *FirstSample) ? Edge.First : *FirstSample;
+        *LastSample = (Edge.Last > *LastSample) ? Edge.Last : *LastSample;
+    }
+}
+
+/******************************************************************************
+function: Bring the active edge table up to the given sample, then sort the
+          active edges left to right
+******************************************************************************/
+static void Paint_UpdateActiveEdges(PAINT_EDGE_TABLE *Table, int Sample)
+{
+    // Drop edges we have gone past
+    UWORD Kept = 0;
+    for (UWORD i = 0; i < Table->ActiveCount; i++)
+    {
+        if (Table->Edges[Table->Active[i]].Last > Sample)
+        {
+            Table->Active[Kept++] = Table->Active[i];
+        }
+    }
+    Table->ActiveCount = Kept;
+
+    // Pick up edges that start here
+    while (Table->Next < Table->Count && Table->Edges[Table->Next].First <= Sample)
+    {
+        Table->Active[Table->ActiveCount++] = Table->Next++;
+    }
+
+    // Insertion sort by X. Edges rarely swap between samples, so this is nearly always one pass.
+    for (UWORD i = 1; i < Table->ActiveCount; i++)
+    {
+        UWORD Edge = Table->Active[i];
+        UWORD j = i;
+        while (j > 0 && Table->Edges[Table->Active[j - 1]].X > Table->Edges[Edge].X)
+        {
+            Table->Active[j] = Table->Active[j - 1];
+            j--;
+        }
+        Table->Active[j] = Edge;
+    }
+}
+
+/******************************************************************************
+function: Step every active edge on to the next sample
+******************************************************************************/
+static void Paint_StepActiveEdges(PAINT_EDGE_TABLE *Table)
+{
+    for (UWORD i = 0; i < Table->ActiveCount; i++)
+    {
+        PAINT_EDGE *Edge = &Table->Edges[Table->Active[i]];
+        Edge->X += Edge->Dx;
+    }
+}
+
+/******************************************************************************
+function: Fill a polygon (convex or not) with the even-odd rule, a span per
+          row between each pair of edge crossings. A pixel is filled if its
+          center is inside.
+parameter:
+    Points : Vertices, in order. The last one joins back to the first.
+    Count  : Number of vertices, at most PAINT_POLYGON_MAX_POINTS
+    Scale  : Vertices are in 1/Scale of a pixel
+    Color  : Painted color
+******************************************************************************/
+static void Paint_FillPolygonScaled(const PAINT_POINT *Points, UWORD Count, int Scale, UWORD Color)
+{
+    if (Count < 3 || Count > PAINT_POLYGON_MAX_POINTS)
+    {
+        Debug("Paint_FillPolygon needs 3 to %d points\r\n", PAINT_POLYGON_MAX_POINTS);
+        return;
+    }
+
+    PAINT_EDGE_TABLE Table;
+    int First, Last;
+    Paint_BuildEdgeTable(&Table, Points, Count, 1, Scale, &First, &Last);
+    First = (First < 0) ? 0 : First;
+    Last = (Last > Paint.Height) ? Paint.Height : Last;
+
+    for (int Y = First; Y < Last; Y++)
+    {
+        Paint_UpdateActiveEdges(&Table, Y);
+        for (UWORD i = 0; i + 1 < Table.ActiveCount; i += 2)
+        {
+            // Pixel X is in if X + 0.5 is in [Left, Right)
+            int32_t Left = Table.Edges[Table.Active[i]].X;
+            int32_t Right = Table.Edges[Table.Active[i + 1]].X;
+            int Xstart = (Left - 0x8000 + 0xFFFF) >> 16;
+            int Xend = (Right - 0x8000 + 0xFFFF) >> 16;
+            Paint_FillLogicalRect(Xstart, Y, Xend, Y + 1, Color);
+        }
+        Paint_StepActiveEdges(&Table);
+    }
+}
+
+/** Sub-scanlines per row for Paint_FillPolygonAA(). */
+#define PAINT_AA_SAMPLES 4
+
+/** Horizontal coverage resolution of each sub-scanline, in steps per pixel. */
+#define PAINT_AA_STEPS 16
+
+/** Coverage of a pixel that is entirely inside the polygon. */
+#define PAINT_AA_FULL (PAINT_AA_SAMPLES * PAINT_AA_STEPS)
+
+void Paint_FillPolygon(const PAINT_POINT *Points, UWORD Count, UWORD Color)
+{
+    Paint_FillPolygonScaled(Points, Count, 1, Color);
+}
+
+/******************************************************************************
+function: Fill a polygon like Paint_FillPolygonScaled(), but anti-alias the
+          edges using the 2 bpp palette (Paint_SetScale(4)): each pixel's
+          coverage picks one of the four levels between Color and WHITE. Edge
+          pixels are blended against WHITE, so draw onto a cleared background.
+          At any other scale this is the same as Paint_FillPolygonScaled().
+parameter:
+    Points : Vertices, in order. The last one joins back to the first.
+    Count  : Number of vertices, at most PAINT_POLYGON_MAX_POINTS
+    Scale  : Vertices are in 1/Scale of a pixel
+    Color  : Painted color (palette index 0 to 3)
+******************************************************************************/
+static void Paint_FillPolygonAAScaled(const PAINT_POINT *Points, UWORD Count, int Scale, UWORD Color)
+{
+    if (Paint.Scale != 4 || Paint.Width > PAINT_POLYGON_MAX_WIDTH)
+    {
+        Paint_FillPolygonScaled(Points, Count, Scale, Color);
+        return;
+    }
+    if (Count < 3 || Count > PAINT_POLYGON_MAX_POINTS)
+    {
+        Debug("Paint_FillPolygonAA needs 3 to %d points\r\n", PAINT_POLYGON_MAX_POINTS);
+        return;
+    }
+
+    PAINT_EDGE_TABLE Table;
+    int First, Last;
+    Paint_BuildEdgeTable(&Table, Points, Count, PAINT_AA_SAMPLES, Scale, &First, &Last);
+    First = (First < 0) ? 0 : First;
+    Last = (Last > Paint.Height * PAINT_AA_SAMPLES) ? Paint.Height * PAINT_AA_SAMPLES : Last;
+
+    // Coverage of each pixel in the current row, in 1/PAINT_AA_FULL
+    static UBYTE Coverage[PAINT_POLYGON_MAX_WIDTH];
+    const int Ink = Color % 4;
+    const int Background = WHITE % 4;
+
+    // Start on a row boundary so every row gets all of its sub-scanlines
+    int Sample = First - (First % PAINT_AA_SAMPLES);
+    for (int Y = Sample / PAINT_AA_SAMPLES; Sample < Last; Y++)
+    {
+        int Xmin = Paint.Width;
+        int Xmax = -1;
+        memset(Coverage, 0, Paint.Width);
+
+        for (int s = 0; s < PAINT_AA_SAMPLES; s++, Sample++)
+        {
+            Paint_UpdateActiveEdges(&Table, Sample);
+            for (UWORD i = 0; i + 1 < Table.ActiveCount; i += 2)
+            {
+                // Span in 1/PAINT_AA_STEPS of a pixel, clipped to the image
+                int Left = Table.Edges[Table.Active[i]].X >> 12;
+                int Right = Table.Edges[Table.Active[i + 1]].X >> 12;
+                Left = (Left < 0) ? 0 : Left;
+                Right = (Right > Paint.Width * PAINT_AA_STEPS) ? Paint.Width * PAINT_AA_STEPS : Right;
+                if (Right <= Left)
+                {
+                    continue;
+                }
+
+                int PixelLeft = Left / PAINT_AA_STEPS;
+                int PixelRight = Right / PAINT_AA_STEPS;
+                if (PixelLeft == PixelRight)
+                {
+                    Coverage[PixelLeft] += Right - Left;
+                }
+                else
+                {
+                    Coverage[PixelLeft] += PAINT_AA_STEPS - (Left % PAINT_AA_STEPS);
+                    for (int X = PixelLeft + 1; X < PixelRight; X++)
+                    {
+                        Coverage[X] += PAINT_AA_STEPS;
+                    }
+                    if (PixelRight < Paint.Width)
+                    {
+                        Coverage[PixelRight] += Right % PAINT_AA_STEPS;
+                    }
+                }
+                Xmin = (PixelLeft < Xmin) ? PixelLeft : Xmin;
+                Xmax = (PixelRight > Xmax) ? PixelRight : Xmax;
+            }
+            Paint_StepActiveEdges(&Table);
+        }
+
+        Xmax = (Xmax >= Paint.Width) ? Paint.Width - 1 : Xmax;
+        int Run = -1; // Start of a run of fully covered pixels
+        for (int X = Xmin; X <= Xmax + 1; X++)
+        {
+            int Cover = (X <= Xmax) ? Coverage[X] : 0;
+            if (Cover >= PAINT_AA_FULL)
+            {
+                Run = (Run < 0) ? X : Run;
+                continue;
+            }
+            if (Run >= 0)
+            {
+                Paint_FillLogicalRect(Run, Y, X, Y + 1, Ink);
+                Run = -1;
+            }
+            if (X <= Xmax && Cover > 0)
+            {
+                // Nearest of the four levels between the background and the ink
+                int Level = Background + (((Ink - Background) * Cover * 2 + PAINT_AA_FULL * ((Ink < Background) ? -1 : 1)) / (2 * PAINT_AA_FULL));
+                if (Level != Background)
+                {
+                    Paint_SetPixel(X, Y, Level);
+                }
+            }
+        }
+    }
+}
+
+void Paint_FillPolygonAA(const PAINT_POINT *Points, UWORD Count, UWORD Color)
+{
+    Paint_FillPolygonAAScaled(Points, Count, 1, Color);
+}
+
+/******************************************************************************
+function: Paint_FillPolygonAA(), with the vertices in 1/PAINT_SUBPIXELS of a
+          pixel, so a shape can move less than a pixel at a time. Vertices on
+          whole pixels paint exactly what Paint_FillPolygonAA() would.
+parameter:
+    Points : Vertices, in order, in 1/PAINT_SUBPIXELS of a logical pixel
+    Count  : Number of vertices, at most PAINT_POLYGON_MAX_POINTS
+    Color  : Painted color (palette index 0 to 3)
+******************************************************************************/
+void Paint_FillPolygonAASubpixel(const PAINT_POINT *Points, UWORD Count, UWORD Color)
+{
+    Paint_FillPolygonAAScaled(Points, Count, PAINT_SUBPIXELS, Color);
+}
+
+#if PAINT_GLYPH_CACHE_SIZE > 0
+/** Longest side of a glyph the cache will take. */
+#define PAINT_GLYPH_MAX_SIDE MAX_HEIGHT_FONT
+
+/** Most runs one cached glyph can hold. Glyphs that need more are drawn pixel by pixel. */
+#define PAINT_GLYPH_MAX_RUNS 192
+
+/**
+ * A character expanded into runs along rows of image memory (so already rotated and mirrored).
+ * Each row's runs alternate between clear and set font bits, starting with clear.
+ **/
+typedef struct
+{
+    const sFONT *Font;      // NULL if the entry is unused
+    char Char;
+    UWORD Rotate;
+    UWORD Mirror;
+    UBYTE Columns;          // Width in memory
+    UBYTE Rows;             // Height in memory
+    UDOUBLE LastUsed;
+    UBYTE RowStart[PAINT_GLYPH_MAX_SIDE + 1];   // Row r's runs are Runs[RowStart[r]] up to Runs[RowStart[r + 1]]
+    UBYTE Runs[PAINT_GLYPH_MAX_RUNS];
+} PAINT_GLYPH;
+
+static PAINT_GLYPH Paint_Glyphs[PAINT_GLYPH_CACHE_SIZE];
+static UDOUBLE Paint_GlyphClock = 0;
+
+/******************************************************************************
+function: Expand a character into Glyph for the current rotation and mirroring
+return:
+    false if it doesn't fit in a PAINT_GLYPH
+******************************************************************************/
+static bool Paint_ExpandGlyph(PAINT_GLYPH *Glyph, const sFONT *Font, char Acsii_Char)
+{
+    const int Width = Font->Width;
+    const int Height = Font->Height;
+    if (Width > PAINT_GLYPH_MAX_SIDE || Height > PAINT_GLYPH_MAX_SIDE)
+    {
+        return false;
+    }
+
+    // Rotation and mirroring only swap and flip the axes, so the glyph's box in memory is found from its corners
+    const int MinX = ((Paint_Map.XFromX < 0) ? Paint_Map.XFromX * (Width - 1) : 0) + ((Paint_Map.XFromY < 0) ? Paint_Map.XFromY * (Height - 1) : 0);
+    const int MinY = ((Paint_Map.YFromX < 0) ? Paint_Map.YFromX * (Width - 1) : 0) + ((Paint_Map.YFromY < 0) ? Paint_Map.YFromY * (Height - 1) : 0);
+    const int Columns = (Paint_Map.XFromX != 0) ? Width : Height;
+    const int Rows = (Paint_Map.YFromX != 0) ? Width : Height;
+
+    // Lay the font bits out in memory order first
+    uint64_t Bits[PAINT_GLYPH_MAX_SIDE] = {0};
+    const int RowBytes = Width / 8 + (Width % 8 ? 1 : 0);
+    const unsigned char *ptr = &Font->table[(Acsii_Char - ' ') * Height * RowBytes];
+    for (int Page = 0; Page < Height; Page++)
+    {
+        for (int Column = 0; Column < Width; Column++)
+        {
+            if (ptr[Page * RowBytes + Column / 8] & (0x80 >> (Column % 8)))
+            {
+                int X = Paint_Map.XFromX * Column + Paint_Map.XFromY * Page - MinX;
+                int Y = Paint_Map.YFromX * Column + Paint_Map.YFromY * Page - MinY;
+                Bits[Y] |= (uint64_t)1 << X;
+            }
+        }
+    }
+
+    UWORD Next = 0;
+    for (int Y = 0; Y < Rows; Y++)
+    {
+        Glyph->RowStart[Y] = Next;
+        bool Set = false;
+        UBYTE Length = 0;
+        for (int X = 0; X < Columns; X++)
+        {
+            if (((Bits[Y] >> X) & 1) != Set)
+            {
+                if (Next >= PAINT_GLYPH_MAX_RUNS)
+                {
+                    return false;
+                }
+                Glyph->Runs[Next++] = Length;
+                Set = !Set;
+                Length = 0;
+            }
+            Length++;
+        }
+        if (Next >= PAINT_GLYPH_MAX_RUNS)
+        {
+            return false;
+        }
+        Glyph->Runs[Next++] = Length;
+    }
+    Glyph->RowStart[Rows] = Next;
+
+    Glyph->Font = Font;
+    Glyph->Char = Acsii_Char;
+    Glyph->Rotate = Paint.Rotate;
+    Glyph->Mirror = Paint.Mirror;
+    Glyph->Columns = Columns;
+    Glyph->Rows = Rows;
+    return true;
+}
+
+/******************************************************************************
+function: Find a character in the glyph cache, expanding it in place of the
+          least recently used one if it isn't there
+return:
+    NULL if the character can't be cached
+******************************************************************************/
+static const PAINT_GLYPH *Paint_GetGlyph(const sFONT *Font, char Acsii_Char)
+{
+    PAINT_GLYPH *Oldest = &Paint_Glyphs[0];
+    Paint_GlyphClock++;
+    for (UWORD i = 0; i < PAINT_GLYPH_CACHE_SIZE; i++)
+    {
+        PAINT_GLYPH *Glyph = &Paint_Glyphs[i];
+        if (Glyph->Font == Font && Glyph->Char == Acsii_Char && Glyph->Rotate == Paint.Rotate && Glyph->Mirror == Paint.Mirror)
+        {
+            Glyph->LastUsed = Paint_GlyphClock;
+            return Glyph;
+        }
+        if (Glyph->Font == NULL || (Oldest->Font != NULL && Glyph->LastUsed < Oldest->LastUsed))
+        {
+            Oldest = Glyph;
+        }
+    }
+
+    if (!Paint_ExpandGlyph(Oldest, Font, Acsii_Char))
+    {
+        Oldest->Font = NULL;
+        return NULL;
+    }
+    Oldest->LastUsed = Paint_GlyphClock;
+    return Oldest;
+}
+
+/******************************************************************************
+function: Copy a cached glyph into image memory a run at a time
+parameter:
+    Glyph      : From Paint_GetGlyph()
+    Xpoint     : Logical X of the character's top left corner
+    Ypoint     : Logical Y of the character's top left corner
+    SetColor   : Colour for set font bits
+    ClearColor : Colour for clear font bits
+return:
+    false (having drawn nothing) if any of the character would be outside image memory
+******************************************************************************/
+static bool HOT_FUNC(Paint_BlitGlyph)(const PAINT_GLYPH *Glyph, UWORD Xpoint, UWORD Ypoint, UWORD SetColor, UWORD ClearColor)
+{
+    UWORD X0, Y0, X1, Y1;
+    Paint_ToMemory(Xpoint, Ypoint, &X0, &Y0);
+    Paint_ToMemory(Xpoint + Glyph->Font->Width - 1, Ypoint + Glyph->Font->Height - 1, &X1, &Y1);
+    if (X0 >= Paint.WidthMemory || X1 >= Paint.WidthMemory || Y0 >= Paint.HeightMemory || Y1 >= Paint.HeightMemory)
+    {
+        return false;
+    }
+    const UWORD Xstart = (X0 < X1) ? X0 : X1;
+    const UWORD Ystart = (Y0 < Y1) ? Y0 : Y1;
+    Paint_MarkDirty(Xstart, Ystart, Xstart + Glyph->Columns, Ystart + Glyph->Rows);
+
+    const UDOUBLE Patterns[2] = {Paint_Pattern(ClearColor), Paint_Pattern(SetColor)};
+    for (UWORD Row = 0; Row < Glyph->Rows; Row++)
+    {
+        if (Ystart + Row < Paint_BandStart || Ystart + Row >= Paint_BandEnd)
+        {
+            continue;
+        }
+        UWORD X = Xstart;
+        for (UWORD Run = Glyph->RowStart[Row]; Run < Glyph->RowStart[Row + 1]; Run++)
+        {
+            const UBYTE Length = Glyph->Runs[Run];
+            if (Length > 0)
+            {
+                Paint_FillMemoryRow(X, X + Length, Ystart + Row, Patterns[(Run - Glyph->RowStart[Row]) & 1]);
+                X += Length;
+            }
+        }
+    }
+    return true;
+}
+#endif // PAINT_GLYPH_CACHE_SIZE
+
+/******************************************************************************
+function: Show English characters
+parameter:
+    Xpoint           ：X coordinate
+    Ypoint           ：Y coordinate
+    Acsii_Char       ：To display the English characters
+    Font             ：A structure pointer that displays a character size
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
+                    const sFONT *Font, UWORD Color_Foreground, UWORD Color_Background)
+{
+    UWORD Page, Column;
+
+    if (Xpoint > Paint.Width || Ypoint > Paint.Height)
+    {
+        Debug("Paint_DrawChar Input exceeds the normal display range\r\n");
+        return;
+    }
+
+#if PAINT_GLYPH_CACHE_SIZE > 0
+    // Characters wholly inside the image come from the glyph cache, a span at a time
+    if (Paint_Map.Valid && (Xpoint + Font->Width <= Paint.Width) && (Ypoint + Font->Height <= Paint.Height))
+    {
+        const PAINT_GLYPH *Glyph = Paint_GetGlyph(Font, Acsii_Char);
+        if (Glyph != NULL && Paint_BlitGlyph(Glyph, Xpoint, Ypoint, Color_Background, Color_Foreground))
+        {
+            return;
+        }
+    }
+#endif // PAINT_GLYPH_CACHE_SIZE
+
+    uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
+    const unsigned char *ptr = &Font->table[Char_Offset];
+    const UDOUBLE Foreground = Paint_Pattern(Color_Foreground);
+    const UDOUBLE Background = Paint_Pattern(Color_Background);
+
+    for (Page = 0; Page < Font->Height; Page++)
+    {
+        for (Column = 0; Column < Font->Width; Column++)
+        {
+
+            // To determine whether the font background color and screen background color is consistent
+            if (*ptr & (0x80 >> (Column % 8)))
+            {
+                Paint_PlotPattern(Xpoint + Column, Ypoint + Page, Background);
+                // Paint_DrawPoint(Xpoint + Column, Ypoint + Page, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+            }
+            else
+            {
+                Paint_PlotPattern(Xpoint + Column, Ypoint + Page, Foreground);
+                // Paint_DrawPoint(Xpoint + Column, Ypoint + Page, Color_Background, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+            }
+            // One pixel is 8 bits
+            if (Column % 8 == 7)
+                ptr++;
+        } // Write a line
+        if (Font->Width % 8 != 0)
+            ptr++;
+    } // Write all
+}
+
+/******************************************************************************
+function:	Display the string
+parameter:
+    Xstart           ：X coordinate
+    Ystart           ：Y coordinate
+    pString          ：The first address of the English string to be displayed
+    Font             ：A structure pointer that displays a character size
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+void Paint_DrawString_EN(UWORD Xstart, UWORD Ystart, const char *pString,
+                         const sFONT *Font, UWORD Color_Foreground, UWORD Color_Background)
+{
+    UWORD Xpoint = Xstart;
+    UWORD Ypoint = Ystart;
+
+    if (Xstart > Paint.Width || Ystart > Paint.Height)
+    {
+        Debug("Paint_DrawString_EN Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    while (*pString != '\0')
+    {
+        // if X direction filled , reposition to(Xstart,Ypoint),Ypoint is Y direction plus the Height of the character
+        if ((Xpoint + Font->Width) > Paint.Width)
+        {
+            Xpoint = Xstart;
+            Ypoint += Font->Height;
+        }
+
+        // If the Y direction is full, reposition to(Xstart, Ystart)
+        if ((Ypoint + Font->Height) > Paint.Height)
+        {
+            Xpoint = Xstart;
+            Ypoint = Ystart;
+        }
+        Paint_DrawChar(Xpoint, Ypoint, *pString, Font, Color_Background, Color_Foreground);
+
+        // The next character of the address
+        pString++;
+
+        // The next word of the abscissa increases the font of the broadband
+        Xpoint += Font->Width;
+    }
+}
+
+/******************************************************************************
+function: Display the string
+parameter:
+    Xstart  ：X coordinate
+    Ystart  ：Y coordinate
+    pString ：The first address of the Chinese string and English
+              string to be displayed
+    Font    ：A structure pointer that displays a character size
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+void Paint_DrawString_CN(UWORD Xstart, UWORD Ystart, const char *pString, const cFONT *font,
+                         UWORD Color_Foreground, UWORD Color_Background)
+{
+    const char *p_text = pString;
+    int x = Xstart, y = Ystart;
+    int i, j, Num;
+
+    /* Send the string character by character on LCD */
+    while (*p_text != 0)
+    {
+        if (*p_text <= 0x7F)
+        { // ASCII < 126
+            for (Num = 0; Num < font->size; Num++)
+            {
+                if (*p_text == font->table[Num].index[0])
+                {
+                    const char *ptr = &font->table[Num].matrix[0];
+
+                    for (j = 0; j < font->Height; j++)
+                    {
+                        for (i = 0; i < font->Width; i++)
+                        {
+                            if (FONT_BACKGROUND == Color_Background)
+                            { // this process is to speed up the scan
+                                if (*ptr & (0x80 >> (i % 8)))
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Foreground);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                            }
+                            else
+                            {
+                                if (*ptr & (0x80 >> (i % 8)))
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Foreground);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                                else
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Background);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Background, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                            }
+                            if (i % 8 == 7)
+                            {
+                                ptr++;
+                            }
+                        }
+                        if (font->Width % 8 != 0)
+                        {
+                            ptr++;
+                        }
+                    }
+                    break;
+                }
+            }
+            /* Point on the next character */
+            p_text += 1;
+            /* Decrement the column position by 16 */
+            x += font->ASCII_Width;
+        }
+        else
+        { // Chinese
+            for (Num = 0; Num < font->size; Num++)
+            {
+                if ((*p_text == font->table[Num].index[0]) && (*(p_text + 1) == font->table[Num].index[1]))
+                {
+                    const char *ptr = &font->table[Num].matrix[0];
+
+                    for (j = 0; j < font->Height; j++)
+                    {
+                        for (i = 0; i < font->Width; i++)
+                        {
+                            if (FONT_BACKGROUND == Color_Background)
+                            { // this process is to speed up the scan
+                                if (*ptr & (0x80 >> (i % 8)))
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Foreground);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                            }
+                            else
+                            {
+                                if (*ptr & (0x80 >> (i % 8)))
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Foreground);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Foreground, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                                else
+                                {
+                                    Paint_SetPixel(x + i, y + j, Color_Background);
+                                    // Paint_DrawPoint(x + i, y + j, Color_Background, DOT_PIXEL_DFT, DOT_STYLE_DFT);
+                                }
+                            }
+                            if (i % 8 == 7)
+                            {
+                                ptr++;
+                            }
+                        }
+                        if (font->Width % 8 != 0)
+                        {
+                            ptr++;
+                        }
+                    }
+                    break;
+                }
+            }
+            /* Point on the next character */
+            p_text += 2;
+            /* Decrement the column position by 16 */
+            x += font->Width;
+        }
+    }
+}
+
+/******************************************************************************
+function:	Display nummber
+parameter:
+    Xstart           ：X coordinate
+    Ystart           : Y coordinate
+    Nummber          : The number displayed
+    Font             ：A structure pointer that displays a character size
+    Digit						 : Fractional width
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+#define ARRAY_LEN 255
+void Paint_DrawNum(UWORD Xpoint, UWORD Ypoint, double Nummber,
+                   const sFONT *Font, UWORD Digit, UWORD Color_Foreground, UWORD Color_Background)
+{
+    char Str[ARRAY_LEN];
+    sprintf(Str, "%.*lf", Digit + 1, Nummber);
+    char *pStr = (char *)malloc((strlen(Str)) * sizeof(char));
+    memcpy(pStr, Str, (strlen(Str) - 1));
+    *(pStr + strlen(Str) - 1) = '\0';
+    if (Digit == 0)
+        *(pStr + strlen(Str) - 2) = '\0';
+    // show
+    Paint_DrawString_EN(Xpoint, Ypoint, (const char *)pStr, Font, Color_Foreground, Color_Background);
+    free(pStr);
+    pStr = NULL;
+}
+
+/******************************************************************************
+function:	Display time
+parameter:
+    Xstart           ：X coordinate
+    Ystart           : Y coordinate
+    pTime            : Time-related structures
+    Font             ：A structure pointer that displays a character size
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+void Paint_DrawTime(UWORD Xstart, UWORD Ystart, PAINT_TIME *pTime, const sFONT *Font,
+                    UWORD Color_Foreground, UWORD Color_Background)
+{
+    uint8_t value[10] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+    UWORD Dx = Font->Width;
+
+    // Write data into the cache
+    Paint_DrawChar(Xstart, Ystart, value[pTime->Hour / 10], Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx, Ystart, value[pTime->Hour % 10], Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx + Dx / 4 + Dx / 2, Ystart, ':', Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx * 2 + Dx / 2, Ystart, value[pTime->Min / 10], Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx * 3 + Dx / 2, Ystart, value[pTime->Min % 10], Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx * 4 + Dx / 2 - Dx / 4, Ystart, ':', Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx * 5, Ystart, value[pTime->Sec / 10], Font, Color_Background, Color_Foreground);
+    Paint_DrawChar(Xstart + Dx * 6, Ystart, value[pTime->Sec % 10], Font, Color_Background, Color_Foreground);
+}
+
+void Paint_DrawImage(const unsigned char *image, UWORD xStart, UWORD yStart, UWORD W_Image, UWORD H_Image)
+{
+    int i, j;
+    for (j = 0; j < H_Image; j++)
+    {
+        for (i = 0; i < W_Image; i++)
+        {
+            if (xStart + i < Paint.WidthMemory && yStart + j < Paint.HeightMemory) // Exceeded part does not display
+                Paint_SetPixel(xStart + i, yStart + j, (*(image + j * W_Image * 2 + i * 2 + 1)) << 8 | (*(image + j * W_Image * 2 + i * 2)));
+            // Using arrays is a property of sequential storage, accessing the original array by algorithm
+            // j*W_Image*2 			   Y offset
+            // i*2              	   X offset
+        }
+    }
+}
+
+void Paint_DrawImage1(const unsigned char *image, UWORD xStart, UWORD yStart, UWORD W_Image, UWORD H_Image)
+{
+    int i, j;
+    for (j = 0; j < H_Image; j++)
+    {
+        for (i = 0; i < W_Image; i++)
+        {
+            if (xStart + i < Paint.HeightMemory && yStart + j < Paint.WidthMemory) // Exceeded part does not display
+                Paint_SetPixel(xStart + i, yStart + j, (*(image + j * W_Image * 2 + i * 2 + 1)) << 8 | (*(image + j * W_Image * 2 + i * 2)));
+            // Using arrays is a property of sequential storage, accessing the original array by algorithm
+            // j*W_Image*2 			   Y offset
+            // i*2              	   X offset
+        }
+    }
+}
+
+/******************************************************************************
+function:	Display monochrome bitmap
+parameter:
+    image_buffer ：A picture data converted to a bitmap
+info:
+    Use a computer to convert the image into a corresponding array,
+    and then embed the array directly into Imagedata.cpp as a .c file.
+    Needs the whole image selected, not a band.
+******************************************************************************/
+static bool Paint_WholeImageSelected(void)
+{
+    if (Paint_BandStart != 0 || Paint_BandEnd != Paint.HeightMemory)
+    {
+        Debug("Bitmaps need the whole image, not a band\r\n");
+        return false;
+    }
+    return true;
+}
+
+void Paint_DrawBitMap(const unsigned char *image_buffer)
+{
+    if (!Paint_WholeImageSelected())
+    {
+        return;
+    }
+    Paint_MarkAllDirty();
+    UWORD x, y;
+    UDOUBLE Addr = 0;
+
+    for (y = 0; y < Paint.HeightByte; y++)
+    {
+        for (x = 0; x < Paint.WidthByte; x++)
+        { // 8 pixel =  1 byte
+            Addr = x + y * Paint.WidthByte;
+            Paint.Image[Addr] = (unsigned char)image_buffer[Addr];
+        }
+    }
+}
+
+void Paint_DrawBitMap_Block(const unsigned char *image_buffer, UBYTE Region)
+{
+    if (!Paint_WholeImageSelected())
+    {
+        return;
+    }
+    Paint_MarkAllDirty();
+    UWORD x, y;
+    UDOUBLE Addr = 0;
+    for (y = 0; y < Paint.HeightByte; y++)
+    {
+        for (x = 0; x < Paint.WidthByte; x++)
+        { // 8 pixel =  1 byte
+            Addr = x + y * Paint.WidthByte;
+            Paint.Image[Addr] =
+                (unsigned char)image_buffer[Addr + (Paint.HeightByte) * Paint.WidthByte * (Region - 1)];
+        }
+    }
+}
+
+void Paint_BmpWindows(unsigned char x, unsigned char y, const unsigned char *pBmp,
+                      unsigned char chWidth, unsigned char chHeight)
+{
+    uint16_t i, j, byteWidth = (chWidth + 7) / 8;
+    for (j = 0; j < chHeight; j++)
+    {
+        for (i = 0; i < chWidth; i++)
+        {
+            if (*(pBmp + j * byteWidth + i / 8) & (128 >> (i & 7)))
+            {
+                Paint_SetPixel(x + i, y + j, 0xffff);
+            }
+        }
+    }
+}
+
+/******************************************************************************
+function:	Start decoding a run-length encoded image from its first pixel
+parameter:
+    Decoder : Decode state to set up
+    Image   : The image to decode. Must outlive the decode.
+******************************************************************************/
+void Paint_RLE_Begin(PAINT_RLE_DECODER *Decoder, const PAINT_RLE_IMAGE *Image)
+{
+    Decoder->Image = Image;
+    Decoder->Next = 0;
+    Decoder->Left = 0;
+    Decoder->Foreground = true; // So the first run flips to background
+}
+
+/******************************************************************************
+function:	Take the next span of same-coloured pixels from a run-length encoded image
+parameter:
+    Decoder    : Decode state from Paint_RLE_Begin()
+    Max        : Longest span to take (e.g., what is left of the current row)
+    Foreground : Set to whether the span is foreground
+return:
+    The length of the span, or 0 if the data has run out
+******************************************************************************/
+UWORD Paint_RLE_NextSpan(PAINT_RLE_DECODER *Decoder, UWORD Max, bool *Foreground)
+{
+    const PAINT_RLE_IMAGE *Image = Decoder->Image;
+    while (Decoder->Left == 0)
+    {
+        if (Decoder->Next >= Image->Size)
+        {
+            return 0;
+        }
+        Decoder->Left = Image->Data[Decoder->Next++];
+        Decoder->Foreground = !Decoder->Foreground;
+    }
+
+    UWORD Length = (Decoder->Left < Max) ? Decoder->Left : Max;
+    Decoder->Left -= Length;
+    *Foreground = Decoder->Foreground;
+    return Length;
+}
+
+/******************************************************************************
+function:	Display a run-length encoded 1 bpp image, one span per run
+parameter:
+    Image            : The image (see PAINT_RLE_IMAGE)
+    xStart           : X coordinate of the image's top left corner
+    yStart           : Y coordinate of the image's top left corner
+    Color_Foreground : Colour of the foreground runs
+    Color_Background : Colour of the background runs
+info:
+    Parts outside the image are clipped. Stops early if the data is short.
+******************************************************************************/
+void Paint_DrawImageRLE(const PAINT_RLE_IMAGE *Image, UWORD xStart, UWORD yStart, UWORD Color_Foreground, UWORD Color_Background)
+{
+    PAINT_RLE_DECODER Decoder;
+    Paint_RLE_Begin(&Decoder, Image);
+
+    for (UWORD j = 0; j < Image->Height; j++)
+    {
+        UWORD i = 0;
+        while (i < Image->Width)
+        {
+            bool Foreground;
+            UWORD Length = Paint_RLE_NextSpan(&Decoder, Image->Width - i, &Foreground);
+            if (Length == 0)
+            {
+                Debug("RLE image data ends at (%d, %d)\r\n", i, j);
+                return;
+            }
+            Paint_FillLogicalRect((int)xStart + i, (int)yStart + j, (int)xStart + i + Length, (int)yStart + j + 1,
+                                  Foreground ? Color_Foreground : Color_Background);
+            i += Length;
+        }
+    }
+}
+
+/** Fraction bits of a sprite's texel coordinates as Paint_DrawSprite() steps them. */
+#define PAINT_SPRITE_FRAC 16
+
+#ifndef GFX_HOST_BUILD
+/******************************************************************************
+function: Set interp0 up to step a sprite's texel coordinates (u, v) in 16.16
+          and give the texel index, u + v * stride, on every pop
+parameter:
+    StrideBits : log2 of the sprite's stride
+    HeightBits : log2 of its height, rounded up (at least 1)
+info:
+    Each lane adds its base to its accumulator raw. Lane 0's result is u's
+    whole part, and lane 1's is v's shifted up to the row it starts, so FULL,
+    their sum, is the index. A mask can't be empty, so lane 0 keeps one bit
+    when the stride is 1: u's whole part is 0 then anyway.
+******************************************************************************/
+static void Paint_SpriteStepperSetup(UBYTE StrideBits, UBYTE HeightBits)
+{
+    interp_config Config = interp_default_config();
+    interp_config_set_add_raw(&Config, true);
+    interp_config_set_shift(&Config, PAINT_SPRITE_FRAC);
+    interp_config_set_mask(&Config, 0, (StrideBits > 0) ? StrideBits - 1 : 0);
+    interp_set_config(interp0, 0, &Config);
+    interp_config_set_shift(&Config, PAINT_SPRITE_FRAC - StrideBits);
+    interp_config_set_mask(&Config, StrideBits, StrideBits + HeightBits - 1);
+    interp_set_config(interp0, 1, &Config);
+    interp0->base[2] = 0;
+}
+
+static inline void Paint_SpriteStepperStart(UDOUBLE U, UDOUBLE V, UDOUBLE DuDx, UDOUBLE DvDx)
+{
+    interp0->accum[0] = U;
+    interp0->base[0] = DuDx;
+    interp0->accum[1] = V;
+    interp0->base[1] = DvDx;
+}
+
+/** The texel under this pixel, stepping on to the next pixel's */
+static inline UDOUBLE Paint_SpriteStepperNext(void)
+{
+    return interp0->pop[2];
+}
+#else
+/** The host has no interpolator, so it does the same sums in C */
+static struct
+{
+    UDOUBLE U, V, DuDx, DvDx;
+    UDOUBLE Mask0, Mask1;
+    UBYTE Shift1;
+} Paint_SpriteStepper;
+
+static void Paint_SpriteStepperSetup(UBYTE StrideBits, UBYTE HeightBits)
+{
+    Paint_SpriteStepper.Mask0 = ((UDOUBLE)1 << ((StrideBits > 0) ? StrideBits : 1)) - 1;
+    Paint_SpriteStepper.Shift1 = PAINT_SPRITE_FRAC - StrideBits;
+    Paint_SpriteStepper.Mask1 = (((UDOUBLE)1 << HeightBits) - 1) << StrideBits;
+}
+
+static inline void Paint_SpriteStepperStart(UDOUBLE U, UDOUBLE V, UDOUBLE DuDx, UDOUBLE DvDx)
+{
+    Paint_SpriteStepper.U = U;
+    Paint_SpriteStepper.V = V;
+    Paint_SpriteStepper.DuDx = DuDx;
+    Paint_SpriteStepper.DvDx = DvDx;
+}
+
+static inline UDOUBLE Paint_SpriteStepperNext(void)
+{
+    UDOUBLE Texel = ((Paint_SpriteStepper.U >> PAINT_SPRITE_FRAC) & Paint_SpriteStepper.Mask0) +
+                    ((Paint_SpriteStepper.V >> Paint_SpriteStepper.Shift1) & Paint_SpriteStepper.Mask1);
+    Paint_SpriteStepper.U += Paint_SpriteStepper.DuDx;
+    Paint_SpriteStepper.V += Paint_SpriteStepper.DvDx;
+    return Texel;
+}
+#endif // GFX_HOST_BUILD
+
+/******************************************************************************
+function: Floor of A / B, for B > 0
+******************************************************************************/
+static int64_t Paint_FloorDiv(int64_t A, int64_t B)
+{
+    return (A >= 0) ? A / B : -((B - 1 - A) / B);
+}
+
+/******************************************************************************
+function: Narrow [*First, *Last] to the x where 0 <= Start + Step * (x - X0) < Limit
+return:
+    false if no x is left
+******************************************************************************/
+static bool Paint_SpriteClipSpan(int64_t Start, int32_t Step, int64_t Limit, int X0, int *First, int *Last)
+{
+    int64_t Lo, Hi;
+    if (Step > 0)
+    {
+        Lo = -Paint_FloorDiv(Start, Step);
+        Hi = Paint_FloorDiv(Limit - 1 - Start, Step);
+    }
+    else if (Step < 0)
+    {
+        Lo = Paint_FloorDiv(Start - Limit, -(int64_t)Step) + 1;
+        Hi = Paint_FloorDiv(Start, -(int64_t)Step);
+    }
+    else if (Start >= 0 && Start < Limit)
+    {
+        return *First <= *Last;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (X0 + Lo > *First)
+    {
+        *First = (int)(X0 + Lo);
+    }
+    if (X0 + Hi < *Last)
+    {
+        *Last = (int)(X0 + Hi);
+    }
+    return *First <= *Last;
+}
+
+/******************************************************************************
+function: Paint one row of a sprite, from the stepper's texels
+parameter:
+    Sprite : The sprite
+    First  : Logical x of the first pixel (whose texel the stepper starts on)
+    Last   : Logical x of the last
+    Y      : Logical y of the row
+    Ink    : Fill pattern for a PAINT_SPRITE_1BPP sprite's set bits
+    Inked  : Grown to take in every pixel written, when Paint_Map.Identity
+             (and left alone otherwise, as Paint_PlotPattern() keeps the dirty region)
+******************************************************************************/
+static void HOT_FUNC(Paint_SpriteRow)(const PAINT_SPRITE *Sprite, int First, int Last, int Y, UDOUBLE Ink, PAINT_RECT *Inked)
+{
+    const UBYTE *Data = Sprite->Data;
+    int Left = Last + 1;
+    int Right = First;
+    for (int X = First; X <= Last; X++)
+    {
+        UDOUBLE Texel = Paint_SpriteStepperNext();
+        UDOUBLE Pattern = Ink;
+        if (Sprite->Format == PAINT_SPRITE_1BPP)
+        {
+            if (!((Data[Texel >> 3] << (Texel & 0x07)) & 0x80))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            UWORD Color = Data[2 * Texel] | (Data[2 * Texel + 1] << 8);
+            if (Color == Sprite->Key)
+            {
+                continue;
+            }
+            Pattern = Paint_Pattern(Color);
+        }
+
+        if (Paint_Map.Identity)
+        {
+            Paint_WritePixel(X, Y, Pattern);
+            Left = (X < Left) ? X : Left;
+            Right = X + 1;
+        }
+        else
+        {
+            Paint_PlotPattern(X, Y, Pattern);
+        }
+    }
+
+    if (Right > Left)
+    {
+        PAINT_RECT Row = {Left, Y, Right, Y + 1};
+        Paint_RectUnion(Inked, &Row);
+    }
+}
+
+/******************************************************************************
+function: Draw a sprite, flipped, scaled, and turned about its centre
+parameter:
+    Sprite : The sprite (see PAINT_SPRITE)
+    Xform  : Where its centre goes and how it is drawn (see PAINT_SPRITE_XFORM)
+    Color  : Colour of a PAINT_SPRITE_1BPP sprite's set bits (an RGB565 sprite has its own)
+info:
+    Each pixel the sprite covers takes the nearest texel, found by stepping its
+    coordinates along the row: in the hardware interpolator (interp0, whose
+    state is put back afterwards) on the board. Every row is clipped to the
+    sprite exactly, up front, so the inner loop has no bounds checks.
+    The centre texel (or, for an even size, the texel after the centre) lands
+    on (X, Y). Clear texels (or Key ones) are left alone, and so is everything
+    outside the image and the band.
+******************************************************************************/
+void Paint_DrawSprite(const PAINT_SPRITE *Sprite, const PAINT_SPRITE_XFORM *Xform, UWORD Color)
+{
+    const int W = Sprite->Width;
+    const int H = Sprite->Height;
+    if (W == 0 || H == 0 || Xform->Scale == 0)
+    {
+        return;
+    }
+    if (Sprite->StrideBits > PAINT_SPRITE_MAX_BITS || W > (1 << Sprite->StrideBits) || H > (1 << PAINT_SPRITE_MAX_BITS))
+    {
+        Debug("Sprite %dx%d doesn't fit a stride of %d\r\n", W, H, 1 << Sprite->StrideBits);
+        return;
+    }
+
+    // Texels a step of one pixel along x and along y moves: the turn undone, over the scale, in 16.16
+    int Cos, Sin;
+    Paint_AngleVector(Xform->Angle, &Cos, &Sin);
+    int32_t DuDx = (int32_t)(((int64_t)Cos << (PAINT_SPRITE_FRAC - 14)) * PAINT_SPRITE_SCALE_ONE / Xform->Scale);
+    int32_t DuDy = (int32_t)(((int64_t)Sin << (PAINT_SPRITE_FRAC - 14)) * PAINT_SPRITE_SCALE_ONE / Xform->Scale);
+    int32_t DvDx = -DuDy;
+    int32_t DvDy = DuDx;
+    if (Xform->Flip & PAINT_SPRITE_FLIP_X)
+    {
+        DuDx = -DuDx;
+        DuDy = -DuDy;
+    }
+    if (Xform->Flip & PAINT_SPRITE_FLIP_Y)
+    {
+        DvDx = -DvDx;
+        DvDy = -DvDy;
+    }
+
+    // Every pixel the sprite can cover, by its turned and scaled half width and height
+    const int64_t ACos = abs(Cos), ASin = abs(Sin);
+    const int ExtentX = (int)(((ACos * W + ASin * H) * Xform->Scale) >> (14 + 8 + 1)) + 2;
+    const int ExtentY = (int)(((ASin * W + ACos * H) * Xform->Scale) >> (14 + 8 + 1)) + 2;
+    int Xstart = (Xform->X - ExtentX < 0) ? 0 : Xform->X - ExtentX;
+    int Xend = (Xform->X + ExtentX >= Paint.Width) ? Paint.Width - 1 : Xform->X + ExtentX;
+    int Ystart = (Xform->Y - ExtentY < 0) ? 0 : Xform->Y - ExtentY;
+    int Yend = (Xform->Y + ExtentY >= Paint.Height) ? Paint.Height - 1 : Xform->Y + ExtentY;
+    if (Paint_Map.Identity)
+    {
+        // Memory rows are logical rows, so the band's rows are all there is to do
+        Ystart = (Ystart < Paint_BandStart) ? Paint_BandStart : Ystart;
+        Yend = (Yend >= Paint_BandEnd) ? Paint_BandEnd - 1 : Yend;
+    }
+    if (Xend < Xstart || Yend < Ystart)
+    {
+        return;
+    }
+
+    UBYTE HeightBits = 1;
+    while ((1 << HeightBits) < H)
+    {
+        HeightBits++;
+    }
+
+#ifndef GFX_HOST_BUILD
+    interp_hw_save_t Saved;
+    interp_save(interp0, &Saved);
+#endif
+    Paint_SpriteStepperSetup(Sprite->StrideBits, HeightBits);
+
+    // Pixel centres, from the centre of the sprite (a texel centre when its size is odd)
+    const UDOUBLE Ink = Paint_Pattern(Color);
+    const int64_t Half = (int64_t)1 << (PAINT_SPRITE_FRAC - 1);
+    const int64_t Dx0 = ((int64_t)(Xstart - Xform->X) << PAINT_SPRITE_FRAC) + Half - ((W & 1) ? Half : 0);
+    PAINT_RECT Inked = {0, 0, 0, 0};
+    for (int Y = Ystart; Y <= Yend; Y++)
+    {
+        const int64_t Dy = ((int64_t)(Y - Xform->Y) << PAINT_SPRITE_FRAC) + Half - ((H & 1) ? Half : 0);
+        const int64_t U0 = ((int64_t)W << (PAINT_SPRITE_FRAC - 1)) + ((DuDx * Dx0 + DuDy * Dy) >> PAINT_SPRITE_FRAC);
+        const int64_t V0 = ((int64_t)H << (PAINT_SPRITE_FRAC - 1)) + ((DvDx * Dx0 + DvDy * Dy) >> PAINT_SPRITE_FRAC);
+
+        int First = Xstart;
+        int Last = Xend;
+        if (!Paint_SpriteClipSpan(U0, DuDx, (int64_t)W << PAINT_SPRITE_FRAC, Xstart, &First, &Last) ||
+            !Paint_SpriteClipSpan(V0, DvDx, (int64_t)H << PAINT_SPRITE_FRAC, Xstart, &First, &Last))
+        {
+            continue;
+        }
+
+        Paint_SpriteStepperStart((UDOUBLE)(U0 + (int64_t)DuDx * (First - Xstart)), (UDOUBLE)(V0 + (int64_t)DvDx * (First - Xstart)),
+                                 (UDOUBLE)DuDx, (UDOUBLE)DvDx);
+        Paint_SpriteRow(Sprite, First, Last, Y, Ink, &Inked);
+    }
+
+#ifndef GFX_HOST_BUILD
+    interp_restore(interp0, &Saved);
+#endif
+    Paint_RectUnion(&Paint_Dirty, &Inked);
+}
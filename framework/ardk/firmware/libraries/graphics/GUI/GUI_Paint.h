@@ -0,0 +1,316 @@
+#ifndef __GUI_PAINT_H
+#define __GUI_PAINT_H
+
+#include "../Config/DEV_Config.h"
+#include "../Fonts/fonts.h"
+
+/**
+ * Image attributes
+ **/
+typedef struct
+{
+    UBYTE *Image;
+    UWORD Width;
+    UWORD Height;
+    UWORD WidthMemory;
+    UWORD HeightMemory;
+    UWORD Color;
+    UWORD Rotate;
+    UWORD Mirror;
+    UWORD WidthByte;
+    UWORD HeightByte;
+    UWORD Scale;
+} PAINT;
+extern PAINT Paint;
+
+/**
+ * A rectangle in image memory coordinates (i.e., after rotation/mirroring),
+ * with exclusive end points. Empty when Xend <= Xstart or Yend <= Ystart.
+ **/
+typedef struct
+{
+    UWORD Xstart;
+    UWORD Ystart;
+    UWORD Xend;
+    UWORD Yend;
+} PAINT_RECT;
+
+/**
+ * Everything Paint_SaveState() keeps, so the paint code can be borrowed for another image
+ * and handed back as it was
+ **/
+typedef struct
+{
+    PAINT Paint;
+    UWORD BandStart;
+    UWORD BandEnd;
+    PAINT_RECT Dirty;
+} PAINT_STATE;
+
+/**
+ * A vertex of a polygon, in logical coordinates
+ **/
+typedef struct
+{
+    UWORD X;
+    UWORD Y;
+} PAINT_POINT;
+
+/** Most vertices Paint_FillPolygon() and Paint_FillPolygonAA() will take. */
+#define PAINT_POLYGON_MAX_POINTS 16
+
+/** Widest image (in logical pixels) Paint_FillPolygonAA() can anti-alias. */
+#define PAINT_POLYGON_MAX_WIDTH 320
+
+/** Paint_FillPolygonAASubpixel() takes its vertices in 1/PAINT_SUBPIXELS of a logical pixel. */
+#define PAINT_SUBPIXELS 4
+
+#ifndef PAINT_GLYPH_CACHE_SIZE
+/** How many characters Paint_DrawChar() keeps expanded into spans. 0 draws every character pixel by pixel. */
+#define PAINT_GLYPH_CACHE_SIZE 8
+#endif
+
+/**
+ * A run-length encoded 1 bpp image (see Paint_DrawImageRLE()).
+ * Data holds one byte per run, covering Width x Height pixels row by row.
+ * Runs alternate between background and foreground, starting with background,
+ * and may carry on from the end of one row onto the next. A run longer than 255
+ * is split in two with a 0-length run of the other colour in between.
+ **/
+typedef struct
+{
+    UWORD Width;
+    UWORD Height;
+    UDOUBLE Size;       // Number of bytes in Data
+    const UBYTE *Data;
+} PAINT_RLE_IMAGE;
+
+/**
+ * How far a streaming decode of a PAINT_RLE_IMAGE has got
+ **/
+typedef struct
+{
+    const PAINT_RLE_IMAGE *Image;
+    UDOUBLE Next;       // Index in Data of the next run
+    UWORD Left;         // Pixels left in the current run
+    bool Foreground;    // Whether the current run is foreground
+} PAINT_RLE_DECODER;
+
+/**
+ * How a sprite's texels are stored
+ **/
+typedef enum
+{
+    PAINT_SPRITE_1BPP = 0,  // 1 bit a texel, most significant first: set bits are painted, clear ones left alone
+    PAINT_SPRITE_RGB565,    // 2 bytes a texel, little-endian (as Paint_DrawImage()): all but Key are painted
+} PAINT_SPRITE_FORMAT;
+
+/**
+ * A sprite for Paint_DrawSprite(): a bitmap in flash, Width x Height texels, row by row.
+ * Each row takes 1 << StrideBits texels in Data, padded out past Width, so the hardware
+ * interpolator can find a texel from its coordinates by shifting and masking alone.
+ * PAINT_SPRITE_STRIDE_BITS() gives the smallest stride that fits a width.
+ **/
+typedef struct
+{
+    const UBYTE *Data;
+    UWORD Width;
+    UWORD Height;
+    UBYTE StrideBits;   // log2 of the texels each row takes in Data. At most PAINT_SPRITE_MAX_BITS.
+    UBYTE Format;       // PAINT_SPRITE_FORMAT
+    UWORD Key;          // PAINT_SPRITE_RGB565: the transparent colour
+} PAINT_SPRITE;
+
+/** Largest power of two a sprite's stride and height may be padded to: 1 << PAINT_SPRITE_MAX_BITS texels. */
+#define PAINT_SPRITE_MAX_BITS 10
+
+/** log2 of the smallest stride that holds Width texels (Width of at most 1 << PAINT_SPRITE_MAX_BITS). */
+#define PAINT_SPRITE_STRIDE_BITS(Width) \
+    (((Width) <= 1) ? 0 : ((Width) <= 2) ? 1 : ((Width) <= 4) ? 2 : ((Width) <= 8) ? 3 : ((Width) <= 16) ? 4 : \
+     ((Width) <= 32) ? 5 : ((Width) <= 64) ? 6 : ((Width) <= 128) ? 7 : ((Width) <= 256) ? 8 : ((Width) <= 512) ? 9 : 10)
+
+/** PAINT_SPRITE_XFORM.Scale for a sprite drawn at its own size. */
+#define PAINT_SPRITE_SCALE_ONE 256
+
+/** PAINT_SPRITE_XFORM.Flip bits */
+#define PAINT_SPRITE_FLIP_X 0x01
+#define PAINT_SPRITE_FLIP_Y 0x02
+
+/**
+ * Where and how Paint_DrawSprite() draws a sprite: flipped, then scaled, then turned
+ * about its centre, which lands on (X, Y)
+ **/
+typedef struct
+{
+    int X;              // Logical coordinates of the sprite's centre
+    int Y;
+    UWORD Scale;        // In 1/PAINT_SPRITE_SCALE_ONE. 0 draws nothing.
+    int Angle;          // Whole degrees clockwise
+    UBYTE Flip;         // PAINT_SPRITE_FLIP_X and/or PAINT_SPRITE_FLIP_Y
+} PAINT_SPRITE_XFORM;
+
+/**
+ * Display rotate
+ **/
+#define ROTATE_0 0
+#define ROTATE_90 90
+#define ROTATE_180 180
+#define ROTATE_270 270
+
+/**
+ * Display Flip
+ **/
+typedef enum
+{
+    MIRROR_NONE = 0x00,
+    MIRROR_HORIZONTAL = 0x01,
+    MIRROR_VERTICAL = 0x02,
+    MIRROR_ORIGIN = 0x03,
+} MIRROR_IMAGE;
+#define MIRROR_IMAGE_DFT MIRROR_NONE
+
+/**
+ * image color
+ **/
+#define WHITE 0xFFFF
+#define BLACK 0x0000
+#define BLUE 0x001F
+#define BRED 0XF81F
+#define GRED 0XFFE0
+#define GBLUE 0X07FF
+#define RED 0xF800
+#define MAGENTA 0xF81F
+#define GREEN 0x07E0
+#define CYAN 0x7FFF
+#define YELLOW 0xFFE0
+#define BROWN 0XBC40
+#define BRRED 0XFC07
+#define GRAY 0X8430
+
+#define IMAGE_BACKGROUND WHITE
+#define FONT_FOREGROUND BLACK
+#define FONT_BACKGROUND WHITE
+
+/**
+ * The size of the point
+ **/
+typedef enum
+{
+    DOT_PIXEL_1X1 = 1, // 1 x 1
+    DOT_PIXEL_2X2,     // 2 X 2
+    DOT_PIXEL_3X3,     // 3 X 3
+    DOT_PIXEL_4X4,     // 4 X 4
+    DOT_PIXEL_5X5,     // 5 X 5
+    DOT_PIXEL_6X6,     // 6 X 6
+    DOT_PIXEL_7X7,     // 7 X 7
+    DOT_PIXEL_8X8,     // 8 X 8
+} DOT_PIXEL;
+#define DOT_PIXEL_DFT DOT_PIXEL_1X1 // Default dot pilex
+
+/**
+ * Point size fill style
+ **/
+typedef enum
+{
+    DOT_FILL_AROUND = 1, // dot pixel 1 x 1
+    DOT_FILL_RIGHTUP,    // dot pixel 2 X 2
+} DOT_STYLE;
+#define DOT_STYLE_DFT DOT_FILL_AROUND // Default dot pilex
+
+/**
+ * Line style, solid or dashed
+ **/
+typedef enum
+{
+    LINE_STYLE_SOLID = 0,
+    LINE_STYLE_DOTTED,
+} LINE_STYLE;
+
+/**
+ * Whether the graphic is filled
+ **/
+typedef enum
+{
+    DRAW_FILL_EMPTY = 0,
+    DRAW_FILL_FULL,
+} DRAW_FILL;
+
+/**
+ * Custom structure of a time attribute
+ **/
+typedef struct
+{
+    UWORD Year;  // 0000
+    UBYTE Month; // 1 - 12
+    UBYTE Day;   // 1 - 30
+    UBYTE Hour;  // 0 - 23
+    UBYTE Min;   // 0 - 59
+    UBYTE Sec;   // 0 - 59
+} PAINT_TIME;
+extern PAINT_TIME sPaint_time;
+
+// init and Clear
+void Paint_NewImage(UBYTE *image, UWORD Width, UWORD Height, UWORD Rotate, UWORD Color);
+void Paint_SelectImage(UBYTE *image);
+void Paint_SelectBand(UBYTE *image, UWORD Ystart, UWORD Yend);
+void Paint_SaveState(PAINT_STATE *State);
+void Paint_RestoreState(const PAINT_STATE *State);
+void Paint_SetRotate(UWORD Rotate);
+void Paint_SetMirroring(UBYTE mirror);
+void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color);
+void Paint_SetScale(UBYTE scale);
+
+void Paint_Clear(UWORD Color);
+void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color);
+
+void Paint_ClearMemoryWindow(const PAINT_RECT *Rect, UWORD Color);
+
+// Span fills (exclusive end points); rotation and mirroring are resolved once per call
+void Paint_FillRect(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color);
+void Paint_FillHSpan(UWORD Xpoint, UWORD Ypoint, UWORD Length, UWORD Color);
+void Paint_FillVSpan(UWORD Xpoint, UWORD Ypoint, UWORD Length, UWORD Color);
+
+// Dirty-region tracking (memory coordinates)
+bool Paint_GetDirty(PAINT_RECT *Rect);
+void Paint_MarkDirty(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void Paint_MarkAllDirty(void);
+void Paint_ResetDirty(void);
+void Paint_RectUnion(PAINT_RECT *Dst, const PAINT_RECT *Src);
+bool Paint_WindowToMemory(int Xstart, int Ystart, int Xend, int Yend, PAINT_RECT *Rect);
+
+// Drawing
+void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color, DOT_PIXEL Dot_Pixel, DOT_STYLE Dot_FillWay);
+void Paint_DrawLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, DOT_PIXEL Line_width, LINE_STYLE Line_Style);
+void Paint_DrawRectangle(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, DOT_PIXEL Line_width, DRAW_FILL Draw_Fill);
+void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius, UWORD Color, DOT_PIXEL Line_width, DRAW_FILL Draw_Fill);
+void Paint_DrawArc(UWORD X_Center, UWORD Y_Center, UWORD Radius, int Start_Angle, int End_Angle, UWORD Color, DOT_PIXEL Line_width);
+void Paint_DrawCurve(UWORD Xstart, UWORD Ystart, int Xcontrol, int Ycontrol, UWORD Xend, UWORD Yend, UWORD Color, DOT_PIXEL Line_width);
+void Paint_FillPolygon(const PAINT_POINT *Points, UWORD Count, UWORD Color);
+void Paint_FillPolygonAA(const PAINT_POINT *Points, UWORD Count, UWORD Color);
+void Paint_FillPolygonAASubpixel(const PAINT_POINT *Points, UWORD Count, UWORD Color);
+
+// Display string
+void Paint_DrawChar(UWORD Xstart, UWORD Ystart, const char Acsii_Char, const sFONT *Font, UWORD Color_Foreground, UWORD Color_Background);
+void Paint_DrawString_EN(UWORD Xstart, UWORD Ystart, const char *pString, const sFONT *Font, UWORD Color_Foreground, UWORD Color_Background);
+void Paint_DrawString_CN(UWORD Xstart, UWORD Ystart, const char *pString, const cFONT *font, UWORD Color_Foreground, UWORD Color_Background);
+void Paint_DrawNum(UWORD Xpoint, UWORD Ypoint, double Nummber, const sFONT *Font, UWORD Digit, UWORD Color_Foreground, UWORD Color_Background);
+void Paint_DrawTime(UWORD Xstart, UWORD Ystart, PAINT_TIME *pTime, const sFONT *Font, UWORD Color_Foreground, UWORD Color_Background);
+
+// pic
+void Paint_DrawBitMap(const unsigned char *image_buffer);
+void Paint_DrawBitMap_Block(const unsigned char *image_buffer, UBYTE Region);
+
+void Paint_DrawImage(const unsigned char *image, UWORD xStart, UWORD yStart, UWORD W_Image, UWORD H_Image);
+void Paint_DrawImage1(const unsigned char *image, UWORD xStart, UWORD yStart, UWORD W_Image, UWORD H_Image);
+void Paint_BmpWindows(unsigned char x, unsigned char y, const unsigned char *pBmp,
+                      unsigned char chWidth, unsigned char chHeight);
+
+// Run-length encoded 1 bpp images
+void Paint_RLE_Begin(PAINT_RLE_DECODER *Decoder, const PAINT_RLE_IMAGE *Image);
+UWORD Paint_RLE_NextSpan(PAINT_RLE_DECODER *Decoder, UWORD Max, bool *Foreground);
+void Paint_DrawImageRLE(const PAINT_RLE_IMAGE *Image, UWORD xStart, UWORD yStart, UWORD Color_Foreground, UWORD Color_Background);
+
+// Sprites, scaled, turned, and flipped
+void Paint_DrawSprite(const PAINT_SPRITE *Sprite, const PAINT_SPRITE_XFORM *Xform, UWORD Color);
+
+#endif
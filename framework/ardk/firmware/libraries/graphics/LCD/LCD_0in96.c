@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * | File      	:   LCD_0in96.c
+ * | Author      :   Waveshare team
+ * | Function    :   Hardware underlying interface
+ * | Info        :
+ *                Used to shield the underlying layers of each master
+ *                and enhance portability
+ *----------------
+ * |	This version:   V1.0
+ * | Date        :   2021-03-11
+ * | Info        :   Basic version
+ *
+ ******************************************************************************/
+#include "LCD_0in96.h"
+#include "LCD_Panel.h"
+#include "../Config/DEV_Config.h"
+
+#include <stdlib.h> //itoa()
+#include <stdio.h>
+
+LCD_0IN96_ATTRIBUTES LCD_0IN96;
+
+static const UBYTE LCD_0IN96_INIT_SEQUENCE[] = {
+	0x11, 0 | LCD_PANEL_DELAY, 120, // Sleep exit
+	0x21, 0,
+	0x21, 0,
+	0xB1, 3, 0x05, 0x3A, 0x3A,
+	0xB2, 3, 0x05, 0x3A, 0x3A,
+	0xB3, 6, 0x05, 0x3A, 0x3A, 0x05, 0x3A, 0x3A,
+	0xB4, 1, 0x03,
+	0xC0, 3, 0x62, 0x02, 0x04,
+	0xC1, 1, 0xC0,
+	0xC2, 2, 0x0D, 0x00,
+	0xC3, 2, 0x8D, 0x6A,
+	0xC4, 2, 0x8D, 0xEE,
+	0xC5, 1, 0x0E, // VCOM
+	0xE0, 16, 0x10, 0x0E, 0x02, 0x03, 0x0E, 0x07, 0x02, 0x07, 0x0A, 0x12, 0x27, 0x37, 0x00, 0x0D, 0x0E, 0x10,
+	0xE1, 16, 0x10, 0x0E, 0x03, 0x03, 0x0F, 0x06, 0x02, 0x08, 0x0A, 0x13, 0x26, 0x36, 0x00, 0x0D, 0x0E, 0x10,
+	0x3A, 1, 0x05,
+	0x29, 0,
+};
+
+const LCD_PANEL LCD_0IN96_PANEL = {
+	.Name = "0in96",
+	.ResetMs = 200,
+	.Backlight = 90,
+	.InitSequence = LCD_0IN96_INIT_SEQUENCE,
+	.InitSequenceLen = sizeof(LCD_0IN96_INIT_SEQUENCE),
+	.Scan = {
+		[HORIZONTAL] = {.Width = LCD_0IN96_WIDTH, .Height = LCD_0IN96_HEIGHT, .XOffset = 1, .YOffset = 26, .MemoryAccess = 0xA8},
+		[VERTICAL] = {.Width = LCD_0IN96_WIDTH, .Height = LCD_0IN96_HEIGHT, .XOffset = 1, .YOffset = 26, .MemoryAccess = 0xA8},
+	},
+};
+
+/********************************************************************************
+function :	Initialize the lcd and make it the active panel
+parameter:
+********************************************************************************/
+void LCD_0IN96_Init(UBYTE Scan_dir)
+{
+	LCD_Panel_Init(&LCD_0IN96_PANEL, Scan_dir);
+	LCD_0IN96.SCAN_DIR = Scan_dir;
+	LCD_0IN96.WIDTH = LCD_ACTIVE.WIDTH;
+	LCD_0IN96.HEIGHT = LCD_ACTIVE.HEIGHT;
+}
+
+/********************************************************************************
+function:	Sets the start position and size of the display area
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (inclusive)
+		Yend    :   Y direction end coordinates (inclusive)
+********************************************************************************/
+void LCD_0IN96_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+	LCD_Panel_SetWindows(Xstart, Ystart, Xend + 1, Yend + 1);
+}
+
+/******************************************************************************
+function :	Clear screen
+parameter:
+******************************************************************************/
+void LCD_0IN96_Clear(UWORD Color)
+{
+	LCD_Panel_Clear(Color);
+	DEV_SPI_DMA_Wait();
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays
+parameter:
+******************************************************************************/
+void LCD_0IN96_Display(UWORD *Image)
+{
+	LCD_Panel_Display(Image);
+}
+
+void LCD_0IN96_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+{
+	LCD_Panel_DisplayWindows(Xstart, Ystart, Xend + 1, Yend + 1, Image);
+}
+
+void LCD_0IN96_DisplayPoint(UWORD X, UWORD Y, UWORD Color)
+{
+	LCD_Panel_DisplayPoint(X, Y, Color);
+}
+
+void Handler_0IN96_LCD(int signo)
+{
+	// System Exit
+	printf("\r\nHandler:Program stop\r\n");
+	DEV_Module_Exit();
+	exit(0);
+}
@@ -15,6 +15,7 @@
 #define __LCD_0IN96_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 #include <stdint.h>
 
 #include <stdlib.h> //itoa()
@@ -36,11 +37,15 @@ typedef struct
 } LCD_0IN96_ATTRIBUTES;
 extern LCD_0IN96_ATTRIBUTES LCD_0IN96;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_0IN96_PANEL;
+
 /********************************************************************************
 function:
             Macro definition variable name
 ********************************************************************************/
 void LCD_0IN96_Init(UBYTE Scan_dir);
+void LCD_0IN96_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_0IN96_Clear(UWORD Color);
 void LCD_0IN96_Display(UWORD *Image);
 void LCD_0IN96_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
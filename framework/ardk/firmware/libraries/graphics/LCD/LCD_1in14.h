@@ -2,6 +2,7 @@
 #define __LCD_1IN14_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 #include <stdint.h>
 
 #include <stdlib.h> //itoa()
@@ -23,13 +24,22 @@ typedef struct
 } LCD_1IN14_ATTRIBUTES;
 extern LCD_1IN14_ATTRIBUTES LCD_1IN14;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_1IN14_PANEL;
+
 /********************************************************************************
 function:
             Macro definition variable name
 ********************************************************************************/
 void LCD_1IN14_Init(UBYTE Scan_dir);
+void LCD_1IN14_SetTearingEffect(bool On);
+void LCD_1IN14_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_1IN14_Clear(UWORD Color);
 void LCD_1IN14_Display(UWORD *Image);
+void LCD_1IN14_Display_DMA(UWORD *Image);
+void LCD_1IN14_DisplayRows_DMA(UWORD Ystart, UWORD Yend, UWORD *Image);
+void LCD_1IN14_BeginPixels(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_1IN14_WritePixels_DMA(const UBYTE *Data, UDOUBLE Len, bool Last);
 void LCD_1IN14_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
 void LCD_1IN14_DisplayPoint(UWORD X, UWORD Y, UWORD Color);
 
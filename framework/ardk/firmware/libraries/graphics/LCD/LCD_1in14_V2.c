@@ -0,0 +1,130 @@
+/*****************************************************************************
+* | File        :   LCD_1IN14_V2.C
+* | Function    :   test Demo
+* | Info        :
+*----------------
+* |	This version:   V1.0
+* | Date        :   2021-03-16
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include "LCD_1in14_V2.h"
+#include "LCD_Panel.h"
+#include "../Config/DEV_Config.h"
+
+#include <stdlib.h> //itoa()
+#include <stdio.h>
+
+LCD_1IN14_V2_ATTRIBUTES LCD_1IN14_V2;
+
+static const UBYTE LCD_1IN14_V2_INIT_SEQUENCE[] = {
+    0x3A, 1, 0x05,
+    0xB2, 5, 0x0C, 0x0C, 0x00, 0x33, 0x33,
+    0xB7, 1, 0x35, // Gate Control
+    0xBB, 1, 0x19, // VCOM Setting
+    0xC0, 1, 0x2C, // LCM Control
+    0xC2, 1, 0x01, // VDV and VRH Command Enable
+    0xC3, 1, 0x12, // VRH Set
+    0xC4, 1, 0x20, // VDV Set
+    0xC6, 1, 0x0F, // Frame Rate Control in Normal Mode
+    0xD0, 2, 0xA4, 0xA1, // Power Control 1
+    0xE0, 14, 0xD0, 0x04, 0x0D, 0x11, 0x13, 0x2B, 0x3F, 0x54, 0x4C, 0x18, 0x0D, 0x0B, 0x1F, 0x23, // Positive Voltage Gamma Control
+    0xE1, 14, 0xD0, 0x04, 0x0C, 0x11, 0x13, 0x2C, 0x3F, 0x44, 0x51, 0x2F, 0x1F, 0x1F, 0x20, 0x23, // Negative Voltage Gamma Control
+    0x21, 0, // Display Inversion On
+    0x11, 0, // Sleep Out
+    0x29, 0, // Display On
+};
+
+const LCD_PANEL LCD_1IN14_V2_PANEL = {
+    .Name = "1in14_V2",
+    .ResetMs = 100,
+    .Backlight = 90,
+    .InitSequence = LCD_1IN14_V2_INIT_SEQUENCE,
+    .InitSequenceLen = sizeof(LCD_1IN14_V2_INIT_SEQUENCE),
+    .Scan = {
+        [HORIZONTAL] = {.Width = LCD_1IN14_V2_HEIGHT, .Height = LCD_1IN14_V2_WIDTH, .XOffset = 40, .YOffset = 53, .MemoryAccess = 0x70},
+        [VERTICAL] = {.Width = LCD_1IN14_V2_WIDTH, .Height = LCD_1IN14_V2_HEIGHT, .XOffset = 52, .YOffset = 40, .MemoryAccess = 0x00},
+    },
+    .RamColumns = 240,
+    .RamRows = 320,
+};
+
+/********************************************************************************
+function :	Initialize the lcd and make it the active panel
+parameter:
+********************************************************************************/
+void LCD_1IN14_V2_Init(UBYTE Scan_dir)
+{
+    LCD_Panel_Init(&LCD_1IN14_V2_PANEL, Scan_dir);
+    LCD_1IN14_V2.SCAN_DIR = Scan_dir;
+    LCD_1IN14_V2.WIDTH = LCD_ACTIVE.WIDTH;
+    LCD_1IN14_V2.HEIGHT = LCD_ACTIVE.HEIGHT;
+}
+
+/********************************************************************************
+function:	Sets the start position and size of the display area
+parameter:
+        Xstart 	:   X direction Start coordinates
+        Ystart  :   Y direction Start coordinates
+        Xend    :   X direction end coordinates
+        Yend    :   Y direction end coordinates
+********************************************************************************/
+void LCD_1IN14_V2_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    LCD_Panel_SetWindows(Xstart, Ystart, Xend, Yend);
+}
+
+/******************************************************************************
+function :	Clear screen
+parameter:
+******************************************************************************/
+void LCD_1IN14_V2_Clear(UWORD Color)
+{
+    LCD_Panel_Clear(Color);
+    DEV_SPI_DMA_Wait();
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays
+parameter:
+******************************************************************************/
+void LCD_1IN14_V2_Display(UWORD *Image)
+{
+    LCD_Panel_Display(Image);
+}
+
+void LCD_1IN14_V2_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+{
+    LCD_Panel_DisplayWindows(Xstart, Ystart, Xend, Yend, Image);
+}
+
+void LCD_1IN14_V2_DisplayPoint(UWORD X, UWORD Y, UWORD Color)
+{
+    LCD_Panel_DisplayPoint(X, Y, Color);
+}
+
+void Handler_1IN14_V2_LCD(int signo)
+{
+    // System Exit
+    printf("\r\nHandler:Program stop\r\n");
+    DEV_Module_Exit();
+    exit(0);
+}
@@ -30,6 +30,7 @@
 #define __LCD_1IN14_V2_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 #include <stdint.h>
 
 #include <stdlib.h> //itoa()
@@ -51,11 +52,15 @@ typedef struct
 } LCD_1IN14_V2_ATTRIBUTES;
 extern LCD_1IN14_V2_ATTRIBUTES LCD_1IN14_V2;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_1IN14_V2_PANEL;
+
 /********************************************************************************
 function:
             Macro definition variable name
 ********************************************************************************/
 void LCD_1IN14_V2_Init(UBYTE Scan_dir);
+void LCD_1IN14_V2_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_1IN14_V2_Clear(UWORD Color);
 void LCD_1IN14_V2_Display(UWORD *Image);
 void LCD_1IN14_V2_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
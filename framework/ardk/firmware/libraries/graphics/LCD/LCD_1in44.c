@@ -0,0 +1,113 @@
+/*****************************************************************************
+ * | File      	:   LCD_1in44.c
+ * | Author      :   Waveshare team
+ * | Function    :   Hardware underlying interface
+ * | Info        :
+ *                Used to shield the underlying layers of each master
+ *                and enhance portability
+ *----------------
+ * |	This version:   V1.0
+ * | Date        :   2020-05-20
+ * | Info        :   Basic version
+ *
+ ******************************************************************************/
+#include "LCD_1in44.h"
+#include "LCD_Panel.h"
+#include "../Config/DEV_Config.h"
+
+#include <stdlib.h> //itoa()
+#include <stdio.h>
+
+LCD_1IN44_ATTRIBUTES LCD_1IN44;
+
+static const UBYTE LCD_1IN44_INIT_SEQUENCE[] = {
+    0x3A, 1, 0x05,
+    0xB1, 3, 0x01, 0x2C, 0x2D,
+    0xB2, 3, 0x01, 0x2C, 0x2D,
+    0xB3, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D,
+    0xB4, 1, 0x07, // Column inversion
+    0xC0, 3, 0xA2, 0x02, 0x84,
+    0xC1, 1, 0xC5,
+    0xC2, 2, 0x0A, 0x00,
+    0xC3, 2, 0x8A, 0x2A,
+    0xC4, 2, 0x8A, 0xEE,
+    0xC5, 1, 0x0E, // VCOM
+    0xE0, 16, 0x0F, 0x1A, 0x0F, 0x18, 0x2F, 0x28, 0x20, 0x22, 0x1F, 0x1B, 0x23, 0x37, 0x00, 0x07, 0x02, 0x10,
+    0xE1, 16, 0x0F, 0x1B, 0x0F, 0x17, 0x33, 0x2C, 0x29, 0x2E, 0x30, 0x30, 0x39, 0x3F, 0x00, 0x07, 0x03, 0x10,
+    0x11, 0 | LCD_PANEL_DELAY, 120,
+    0x29, 0,
+};
+
+const LCD_PANEL LCD_1IN44_PANEL = {
+    .Name = "1in44",
+    .ResetMs = 100,
+    .Backlight = 90,
+    .InitSequence = LCD_1IN44_INIT_SEQUENCE,
+    .InitSequenceLen = sizeof(LCD_1IN44_INIT_SEQUENCE),
+    .Scan = {
+        [HORIZONTAL] = {.Width = LCD_1IN44_HEIGHT, .Height = LCD_1IN44_WIDTH, .XOffset = 1, .YOffset = 2, .MemoryAccess = 0x78},
+        [VERTICAL] = {.Width = LCD_1IN44_WIDTH, .Height = LCD_1IN44_HEIGHT, .XOffset = 2, .YOffset = 1, .MemoryAccess = 0x00},
+    },
+};
+
+/********************************************************************************
+function :	Initialize the lcd and make it the active panel
+parameter:
+********************************************************************************/
+void LCD_1IN44_Init(UBYTE Scan_dir)
+{
+    LCD_Panel_Init(&LCD_1IN44_PANEL, Scan_dir);
+    LCD_1IN44.SCAN_DIR = Scan_dir;
+    LCD_1IN44.WIDTH = LCD_ACTIVE.WIDTH;
+    LCD_1IN44.HEIGHT = LCD_ACTIVE.HEIGHT;
+}
+
+/********************************************************************************
+function:	Sets the start position and size of the display area
+parameter:
+        Xstart 	:   X direction Start coordinates
+        Ystart  :   Y direction Start coordinates
+        Xend    :   X direction end coordinates
+        Yend    :   Y direction end coordinates
+********************************************************************************/
+void LCD_1IN44_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    LCD_Panel_SetWindows(Xstart, Ystart, Xend, Yend);
+}
+
+/******************************************************************************
+function :	Clear screen
+parameter:
+******************************************************************************/
+void LCD_1IN44_Clear(UWORD Color)
+{
+    LCD_Panel_Clear(Color);
+    DEV_SPI_DMA_Wait();
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays
+parameter:
+******************************************************************************/
+void LCD_1IN44_Display(UWORD *Image)
+{
+    LCD_Panel_Display(Image);
+}
+
+void LCD_1IN44_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+{
+    LCD_Panel_DisplayWindows(Xstart, Ystart, Xend, Yend, Image);
+}
+
+void LCD_1IN44_DisplayPoint(UWORD X, UWORD Y, UWORD Color)
+{
+    LCD_Panel_DisplayPoint(X, Y, Color);
+}
+
+void Handler_1IN44_LCD(int signo)
+{
+    // System Exit
+    printf("\r\nHandler:Program stop\r\n");
+    DEV_Module_Exit();
+    exit(0);
+}
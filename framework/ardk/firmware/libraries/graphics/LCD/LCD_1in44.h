@@ -15,6 +15,7 @@
 #define __LCD_1IN44_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 #include <stdint.h>
 
 #include <stdlib.h> //itoa()
@@ -36,11 +37,15 @@ typedef struct
 } LCD_1IN44_ATTRIBUTES;
 extern LCD_1IN44_ATTRIBUTES LCD_1IN44;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_1IN44_PANEL;
+
 /********************************************************************************
 function:
             Macro definition variable name
 ********************************************************************************/
 void LCD_1IN44_Init(UBYTE Scan_dir);
+void LCD_1IN44_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_1IN44_Clear(UWORD Color);
 void LCD_1IN44_Display(UWORD *Image);
 void LCD_1IN44_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
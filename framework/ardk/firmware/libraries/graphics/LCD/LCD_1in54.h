@@ -2,6 +2,7 @@
 #define __LCD_1IN54_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 
 #define LCD_1IN54_HEIGHT 240
 #define LCD_1IN54_WIDTH 240
@@ -20,11 +21,15 @@ typedef struct{
 }LCD_1IN54_ATTRIBUTES;
 extern LCD_1IN54_ATTRIBUTES LCD_1IN54;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_1IN54_PANEL;
+
 /********************************************************************************
 function:
 			Macro definition variable name
 ********************************************************************************/
 void LCD_1IN54_Init(UBYTE Scan_dir);
+void LCD_1IN54_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_1IN54_Clear(UWORD Color);
 void LCD_1IN54_Display(UWORD *Image);
 void LCD_1IN54_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
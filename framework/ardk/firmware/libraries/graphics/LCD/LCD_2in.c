@@ -0,0 +1,148 @@
+/*****************************************************************************
+ * | File      	:   LCD_1in14.c
+ * | Author      :   Waveshare team
+ * | Function    :   Hardware underlying interface
+ * | Info        :
+ *                Used to shield the underlying layers of each master
+ *                and enhance portability
+ *----------------
+ * |	This version:   V1.0
+ * | Date        :   2020-05-20
+ * | Info        :   Basic version
+ *
+ ******************************************************************************/
+#include "LCD_2in.h"
+#include "LCD_Panel.h"
+#include "../Config/DEV_Config.h"
+
+#include <stdlib.h> //itoa()
+#include <stdio.h>
+
+LCD_2IN_ATTRIBUTES LCD_2IN;
+
+static const UBYTE LCD_2IN_INIT_SEQUENCE[] = {
+	0x3A, 1, 0x05,
+	0x21, 0,
+	0x2A, 4, 0x00, 0x00, 0x01, 0x3F,
+	0x2B, 4, 0x00, 0x00, 0x00, 0xEF,
+	0xB2, 5, 0x0C, 0x0C, 0x00, 0x33, 0x33,
+	0xB7, 1, 0x35,
+	0xBB, 1, 0x1F,
+	0xC0, 1, 0x2C,
+	0xC2, 1, 0x01,
+	0xC3, 1, 0x12,
+	0xC4, 1, 0x20,
+	0xC6, 1, 0x0F,
+	0xD0, 2, 0xA4, 0xA1,
+	0xE0, 14, 0xD0, 0x08, 0x11, 0x08, 0x0C, 0x15, 0x39, 0x33, 0x50, 0x36, 0x13, 0x14, 0x29, 0x2D,
+	0xE1, 14, 0xD0, 0x08, 0x10, 0x08, 0x06, 0x06, 0x39, 0x44, 0x51, 0x0B, 0x16, 0x14, 0x2F, 0x31,
+	0x21, 0,
+	0x11, 0,
+	0x29, 0,
+};
+
+const LCD_PANEL LCD_2IN_PANEL = {
+	.Name = "2in",
+	.ResetMs = 100,
+	.Backlight = 90,
+	.InitSequence = LCD_2IN_INIT_SEQUENCE,
+	.InitSequenceLen = sizeof(LCD_2IN_INIT_SEQUENCE),
+	.Scan = {
+		[HORIZONTAL] = {.Width = LCD_2IN_WIDTH, .Height = LCD_2IN_HEIGHT, .XOffset = 0, .YOffset = 0, .MemoryAccess = 0x70},
+		[VERTICAL] = {.Width = LCD_2IN_HEIGHT, .Height = LCD_2IN_WIDTH, .XOffset = 0, .YOffset = 0, .MemoryAccess = 0x00},
+	},
+	.RamColumns = 240,
+	.RamRows = 320,
+};
+
+/********************************************************************************
+function :	Initialize the lcd and make it the active panel
+parameter:
+********************************************************************************/
+void LCD_2IN_Init(UBYTE Scan_dir)
+{
+	LCD_Panel_Init(&LCD_2IN_PANEL, Scan_dir);
+	LCD_2IN.SCAN_DIR = Scan_dir;
+	LCD_2IN.WIDTH = LCD_ACTIVE.WIDTH;
+	LCD_2IN.HEIGHT = LCD_ACTIVE.HEIGHT;
+}
+
+void LCD_2IN_SetTearingEffect(bool On)
+{
+	LCD_Panel_SetTearingEffect(On);
+}
+
+/********************************************************************************
+function:	Sets the start position and size of the display area
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates
+		Yend    :   Y direction end coordinates
+********************************************************************************/
+void LCD_2IN_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+	LCD_Panel_SetWindows(Xstart, Ystart, Xend, Yend);
+}
+
+/******************************************************************************
+function :	Clear screen
+parameter:
+Info:
+	One repeated-colour DMA transfer; returns before it finishes.
+******************************************************************************/
+void LCD_2IN_Clear(UWORD Color)
+{
+	LCD_Panel_Clear(Color);
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays
+parameter:
+******************************************************************************/
+void LCD_2IN_Display(UBYTE *Image)
+{
+	LCD_Panel_Display(Image);
+}
+
+/******************************************************************************
+function :	The DMA versions; see LCD_Panel.h
+parameter:
+******************************************************************************/
+void LCD_2IN_Display_DMA(UBYTE *Image)
+{
+	LCD_Panel_Display_DMA(Image);
+}
+
+void LCD_2IN_DisplayRows_DMA(UWORD Ystart, UWORD Yend, UBYTE *Image)
+{
+	LCD_Panel_DisplayRows_DMA(Ystart, Yend, Image);
+}
+
+void LCD_2IN_BeginPixels(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+	LCD_Panel_BeginPixels(Xstart, Ystart, Xend, Yend);
+}
+
+void LCD_2IN_WritePixels_DMA(const UBYTE *Data, UDOUBLE Len, bool Last)
+{
+	LCD_Panel_WritePixels_DMA(Data, Len, Last);
+}
+
+void LCD_2IN_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image)
+{
+	LCD_Panel_DisplayWindows(Xstart, Ystart, Xend, Yend, Image);
+}
+
+void LCD_2IN_DisplayPoint(UWORD X, UWORD Y, UWORD Color)
+{
+	LCD_Panel_DisplayPoint(X, Y, Color);
+}
+
+void Handler_2IN_LCD(int signo)
+{
+	// System Exit
+	printf("\r\nHandler:Program stop\r\n");
+	DEV_Module_Exit();
+	exit(0);
+}
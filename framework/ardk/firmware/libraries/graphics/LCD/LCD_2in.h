@@ -15,6 +15,7 @@
 #define __LCD_2IN_H
 
 #include "../Config/DEV_Config.h"
+#include "LCD_Panel.h"
 #include <stdint.h>
 
 #include <stdlib.h> //itoa()
@@ -36,13 +37,22 @@ typedef struct
 } LCD_2IN_ATTRIBUTES;
 extern LCD_2IN_ATTRIBUTES LCD_2IN;
 
+/** This panel, for LCD_Panel_Init(). */
+extern const LCD_PANEL LCD_2IN_PANEL;
+
 /********************************************************************************
 function:
             Macro definition variable name
 ********************************************************************************/
 void LCD_2IN_Init(UBYTE Scan_dir);
+void LCD_2IN_SetTearingEffect(bool On);
+void LCD_2IN_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
 void LCD_2IN_Clear(UWORD Color);
 void LCD_2IN_Display(UBYTE *Image);
+void LCD_2IN_Display_DMA(UBYTE *Image);
+void LCD_2IN_DisplayRows_DMA(UWORD Ystart, UWORD Yend, UBYTE *Image);
+void LCD_2IN_BeginPixels(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_2IN_WritePixels_DMA(const UBYTE *Data, UDOUBLE Len, bool Last);
 void LCD_2IN_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD *Image);
 void LCD_2IN_DisplayPoint(UWORD X, UWORD Y, UWORD Color);
 
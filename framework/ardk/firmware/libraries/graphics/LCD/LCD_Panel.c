@@ -0,0 +1,587 @@
+/*****************************************************************************
+* | File      	:   LCD_Panel.c
+* | Function    :   One driver for every panel, run from a descriptor
+* | Info        :
+*   See LCD_Panel.h.
+******************************************************************************/
+#include "LCD_Panel.h"
+#include "../Config/DEV_Config.h"
+
+#include <stddef.h>
+
+LCD_PANEL_ATTRIBUTES LCD_ACTIVE;
+
+/** The active panel's scroll area, in frame memory rows. Length is 0 if it can't scroll. */
+static struct
+{
+    UWORD Top;
+    UWORD Length;
+    bool Mirrored;  // Does the picture run up the frame memory (MY)?
+} LCD_SCROLL_AREA;
+
+/** Rows [Rows_Ystart, Rows_Yend) of the last LCD_Panel_DisplayRows_DMA(), for LCD_Panel_StopRows_DMA(). */
+static UWORD Rows_Ystart = 0;
+static UWORD Rows_Yend = 0;
+
+/******************************************************************************
+function :	Hardware reset
+parameter:
+******************************************************************************/
+static void LCD_Panel_Reset(UWORD Ms)
+{
+    DEV_Digital_Write(LCD_RST_PIN, 1);
+    DEV_Delay_ms(Ms);
+    DEV_Digital_Write(LCD_RST_PIN, 0);
+    DEV_Delay_ms(Ms);
+    DEV_Digital_Write(LCD_RST_PIN, 1);
+    DEV_Delay_ms(Ms);
+}
+
+/******************************************************************************
+function :	Send a command and its data inside a CS frame the caller holds open
+parameter:
+Info:
+    The bus writes only return once the last bit is out, so DC can change
+    right after them.
+******************************************************************************/
+static void LCD_Panel_Command(UBYTE Command, const UBYTE *Data, UBYTE Len)
+{
+    DEV_Digital_Write(LCD_DC_PIN, 0);
+    DEV_SPI_WriteByte(Command);
+    if (Len > 0)
+    {
+        DEV_Digital_Write(LCD_DC_PIN, 1);
+        DEV_SPI_Write_nByte((uint8_t *)Data, Len);
+    }
+}
+
+/******************************************************************************
+function :	Send a command and its data in one CS frame
+parameter:
+    Command : Command register
+    Data    : Its parameters
+    Len     : Number of parameter bytes
+******************************************************************************/
+void LCD_Panel_SendCommand(UBYTE Command, const UBYTE *Data, UBYTE Len)
+{
+    DEV_SPI_DMA_Wait();
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_Panel_Command(Command, Data, Len);
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Send the panel's init sequence, all in one CS frame
+parameter:
+******************************************************************************/
+static void LCD_Panel_InitReg(const LCD_PANEL *Panel)
+{
+    const UBYTE *Entry = Panel->InitSequence;
+    const UBYTE *End = Panel->InitSequence + Panel->InitSequenceLen;
+
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    while (Entry + 1 < End)
+    {
+        UBYTE Command = Entry[0];
+        UBYTE Count = Entry[1] & ~LCD_PANEL_DELAY;
+        bool Delay = (Entry[1] & LCD_PANEL_DELAY) != 0;
+        Entry += 2;
+
+        LCD_Panel_Command(Command, Entry, Count);
+        Entry += Count;
+        if (Delay)
+        {
+            DEV_Delay_ms(*Entry++);
+        }
+    }
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Send where the scroll area starts (VSCSAD), for LCD_ACTIVE.SCROLL
+parameter:
+******************************************************************************/
+static void LCD_Panel_SendScrollStart(void)
+{
+    const UWORD Length = LCD_SCROLL_AREA.Length;
+    const UWORD Start = LCD_SCROLL_AREA.Top + (LCD_SCROLL_AREA.Mirrored ? ((Length - LCD_ACTIVE.SCROLL) % Length) : LCD_ACTIVE.SCROLL);
+    UBYTE StartAddress[2] = {Start >> 8, Start & 0xFF};
+
+    LCD_Panel_SendCommand(0x37, StartAddress, sizeof(StartAddress));
+}
+
+/******************************************************************************
+function :	Work out the scroll area for the MADCTL value in use, and send it (VSCRDEF)
+parameter:
+Info:
+    The controller scrolls its frame memory's rows, which are the picture's
+    columns when MV exchanges them. The area is the rows the picture covers,
+    and counts the other way when MY mirrors them.
+******************************************************************************/
+static void LCD_Panel_SetScrollArea(UBYTE MemoryAccess)
+{
+    const LCD_PANEL *Panel = LCD_ACTIVE.Panel;
+    const UWORD Length = LCD_ACTIVE.SCROLLS_X ? LCD_ACTIVE.WIDTH : LCD_ACTIVE.HEIGHT;
+    const UWORD Address = LCD_ACTIVE.SCROLLS_X ? LCD_ACTIVE.XOFFSET : LCD_ACTIVE.YOFFSET;
+
+    LCD_SCROLL_AREA.Length = 0;
+    if ((Panel->RamRows == 0) || (Length == 0) || ((Address + Length) > Panel->RamRows))
+    {
+        return;
+    }
+    LCD_SCROLL_AREA.Mirrored = (MemoryAccess & LCD_PANEL_MADCTL_MY) != 0;
+    LCD_SCROLL_AREA.Top = LCD_SCROLL_AREA.Mirrored ? (Panel->RamRows - Address - Length) : Address;
+    LCD_SCROLL_AREA.Length = Length;
+
+    const UWORD Bottom = Panel->RamRows - LCD_SCROLL_AREA.Top - Length;
+    UBYTE Area[6] = {LCD_SCROLL_AREA.Top >> 8, LCD_SCROLL_AREA.Top & 0xFF, Length >> 8, Length & 0xFF, Bottom >> 8, Bottom & 0xFF};
+    LCD_Panel_SendCommand(0x33, Area, sizeof(Area));
+    LCD_Panel_SendScrollStart();
+}
+
+/******************************************************************************
+function :	Send MADCTL for the active scan direction, turned 180 degrees or not,
+            and work out where the visible area sits in the frame memory
+parameter:
+Info:
+    Turning the picture mirrors both address orders (MX and MY), so the
+    visible area moves to the far side of whatever frame memory it doesn't use.
+******************************************************************************/
+static void LCD_Panel_SetMemoryAccess(void)
+{
+    const LCD_PANEL *Panel = LCD_ACTIVE.Panel;
+    const LCD_PANEL_SCAN *Scan = &Panel->Scan[LCD_ACTIVE.SCAN_DIR == HORIZONTAL ? HORIZONTAL : VERTICAL];
+    UBYTE MemoryAccess = Scan->MemoryAccess;
+
+    LCD_ACTIVE.XOFFSET = Scan->XOffset;
+    LCD_ACTIVE.YOFFSET = Scan->YOffset;
+    if (LCD_ACTIVE.UPSIDE_DOWN)
+    {
+        MemoryAccess ^= LCD_PANEL_MADCTL_MX | LCD_PANEL_MADCTL_MY;
+        if ((Panel->RamColumns != 0) && (Panel->RamRows != 0))
+        {
+            bool Exchanged = (Scan->MemoryAccess & LCD_PANEL_MADCTL_MV) != 0;
+            UWORD Columns = Exchanged ? Panel->RamRows : Panel->RamColumns;
+            UWORD Rows = Exchanged ? Panel->RamColumns : Panel->RamRows;
+            LCD_ACTIVE.XOFFSET = Columns - Scan->Width - Scan->XOffset;
+            LCD_ACTIVE.YOFFSET = Rows - Scan->Height - Scan->YOffset;
+        }
+    }
+
+    // Set the read / write scan direction of the frame memory
+    LCD_Panel_SendCommand(0x36, &MemoryAccess, 1);
+
+    // Turning the picture turns which way the scroll goes
+    LCD_ACTIVE.SCROLLS_X = (MemoryAccess & LCD_PANEL_MADCTL_MV) != 0;
+    LCD_Panel_SetScrollArea(MemoryAccess);
+}
+
+/******************************************************************************
+function :	Make a panel the active one and set its scan direction
+parameter:
+******************************************************************************/
+static void LCD_Panel_Activate(const LCD_PANEL *Panel, UBYTE Scan_dir)
+{
+    const LCD_PANEL_SCAN *Scan = &Panel->Scan[Scan_dir == HORIZONTAL ? HORIZONTAL : VERTICAL];
+
+    LCD_ACTIVE.Panel = Panel;
+    LCD_ACTIVE.SCAN_DIR = Scan_dir;
+    LCD_ACTIVE.WIDTH = Scan->Width;
+    LCD_ACTIVE.HEIGHT = Scan->Height;
+    LCD_ACTIVE.UPSIDE_DOWN = false;
+    LCD_ACTIVE.SCROLL = 0;
+    LCD_Panel_SetMemoryAccess();
+    LCD_Panel_SetPixelFormat(16);
+}
+
+/********************************************************************************
+function :	Take the controller out of sleep and turn the display on
+Info:
+    Harmless if it wasn't asleep.
+********************************************************************************/
+static void LCD_Panel_Wake(void)
+{
+    LCD_Panel_SendCommand(0x11, NULL, 0); // SLPOUT
+    DEV_Delay_ms(LCD_PANEL_SLPOUT_MS);
+    LCD_Panel_SendCommand(0x29, NULL, 0); // DISPON
+}
+
+/********************************************************************************
+function :	Initialize a panel and make it the active one
+parameter:
+    Panel    : Its descriptor
+    Scan_dir : HORIZONTAL or VERTICAL
+********************************************************************************/
+void LCD_Panel_Init(const LCD_PANEL *Panel, UBYTE Scan_dir)
+{
+    DEV_SPI_DMA_Wait();
+    if (Panel->Backlight != 0)
+    {
+        DEV_SET_PWM(Panel->Backlight);
+    }
+    LCD_Panel_Reset(Panel->ResetMs);
+
+    LCD_Panel_InitReg(Panel);
+
+    // After the init sequence, so MADCTL is always the scan direction's
+    LCD_Panel_Activate(Panel, Scan_dir);
+}
+
+/********************************************************************************
+function :	Make a panel that is already initialized (and showing whatever it was)
+            the active one, without resetting it or sending its init sequence:
+            after the MCU restarts, say, with the panel left running
+parameter:
+    Panel    : Its descriptor
+    Scan_dir : HORIZONTAL or VERTICAL
+********************************************************************************/
+void LCD_Panel_Resume(const LCD_PANEL *Panel, UBYTE Scan_dir)
+{
+    DEV_SPI_DMA_Wait();
+    // In case the MCU restarted while the panel was asleep
+    LCD_Panel_Wake();
+    if (Panel->Backlight != 0)
+    {
+        DEV_SET_PWM(Panel->Backlight);
+    }
+
+    LCD_Panel_Activate(Panel, Scan_dir);
+}
+
+/********************************************************************************
+function :	Put the active panel to sleep, or wake it
+parameter:
+    On : true to turn the backlight and display off and put the controller to
+         sleep (SLPIN), false to wake it (SLPOUT) and turn them back on
+Info:
+    The controller keeps its frame memory and configuration while it sleeps,
+    so it wakes showing what it showed. The backlight is only touched if the
+    panel's descriptor has a level for it. Leave LCD_PANEL_SLEEP_MS between
+    putting it to sleep and waking it; waking takes LCD_PANEL_SLPOUT_MS.
+********************************************************************************/
+void LCD_Panel_Sleep(bool On)
+{
+    DEV_SPI_DMA_Wait();
+    const LCD_PANEL *Panel = LCD_ACTIVE.Panel;
+    if (On)
+    {
+        if (Panel->Backlight != 0)
+        {
+            DEV_SET_PWM(0);
+        }
+        LCD_Panel_SendCommand(0x28, NULL, 0); // DISPOFF
+        LCD_Panel_SendCommand(0x10, NULL, 0); // SLPIN
+    }
+    else
+    {
+        LCD_Panel_Wake();
+        if (Panel->Backlight != 0)
+        {
+            DEV_SET_PWM(Panel->Backlight);
+        }
+    }
+}
+
+/********************************************************************************
+function :	Turn the tearing-effect output on (V-blank only) or off
+parameter:
+    On : Whether the panel should drive its TE line
+********************************************************************************/
+void LCD_Panel_SetTearingEffect(bool On)
+{
+    static const UBYTE VBlankOnly = 0x00;
+    if (On)
+    {
+        LCD_Panel_SendCommand(0x35, &VBlankOnly, 1); // TEON
+    }
+    else
+    {
+        LCD_Panel_SendCommand(0x34, NULL, 0); // TEOFF
+    }
+}
+
+/********************************************************************************
+function :	Have the controller turn the picture upside down, or back
+parameter:
+    On : Whether windows and pixels sent from now on are turned 180 degrees
+Info:
+    For a panel mounted upside down: the picture is painted the right way up
+    and costs nothing to turn. What the panel is showing stays as it is.
+    Initializing or resuming the panel turns it back.
+********************************************************************************/
+void LCD_Panel_SetRotate180(bool On)
+{
+    LCD_ACTIVE.UPSIDE_DOWN = On;
+    LCD_Panel_SetMemoryAccess();
+}
+
+/********************************************************************************
+function :	Choose how many bits a pixel takes over the bus
+parameter:
+    Bits : 12 for RGB444 (two pixels in three bytes), or 16 for RGB565
+Info:
+    Only changes how pixels sent from now on are read; what the panel is
+    showing stays as it is. Initializing or resuming the panel sets RGB565.
+********************************************************************************/
+void LCD_Panel_SetPixelFormat(UBYTE Bits)
+{
+    const UBYTE Colmod = (Bits == 12) ? LCD_PANEL_COLMOD_12BIT : LCD_PANEL_COLMOD_16BIT;
+    LCD_ACTIVE.PIXEL_BITS = (Bits == 12) ? 12 : 16;
+    LCD_Panel_SendCommand(0x3A, &Colmod, 1);
+}
+
+/********************************************************************************
+function :	Scroll the picture in the controller, wrapping around
+parameter:
+    Offset : Position along the scroll axis (X if LCD_ACTIVE.SCROLLS_X, otherwise Y)
+             to show at 0. What comes before it shows at the far end.
+Info:
+    Only the start address changes, so this costs a few bytes however much moves.
+    Windows are still written where they would be unscrolled: a pixel written at
+    P along the axis shows at P - Offset (wrapping around). Returns false (and does
+    nothing) if the panel's frame memory size isn't known. Initializing or
+    resuming the panel scrolls back to 0.
+********************************************************************************/
+bool LCD_Panel_SetScroll(UWORD Offset)
+{
+    if (LCD_SCROLL_AREA.Length == 0)
+    {
+        return false;
+    }
+
+    LCD_ACTIVE.SCROLL = Offset % LCD_SCROLL_AREA.Length;
+    LCD_Panel_SendScrollStart();
+    return true;
+}
+
+/********************************************************************************
+function :	Number of bytes that many pixels take over the bus, in the active pixel format
+parameter:
+Info:
+    An odd number of RGB444 pixels ends in half a byte, which counts as a whole one.
+********************************************************************************/
+UDOUBLE LCD_Panel_PixelBytes(UDOUBLE Pixels)
+{
+    if (LCD_ACTIVE.PIXEL_BITS == 12)
+    {
+        return (Pixels * 3 + 1) / 2;
+    }
+    return Pixels * 2;
+}
+
+/********************************************************************************
+function:	Open a window for writing: column and row addresses, then RAMWR
+parameter:
+Info:
+    Leaves CS low and DC high, so pixel data can follow straight away.
+********************************************************************************/
+static void LCD_Panel_OpenWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    UWORD Xs = Xstart + LCD_ACTIVE.XOFFSET;
+    UWORD Xe = Xend - 1 + LCD_ACTIVE.XOFFSET;
+    UWORD Ys = Ystart + LCD_ACTIVE.YOFFSET;
+    UWORD Ye = Yend - 1 + LCD_ACTIVE.YOFFSET;
+    UBYTE Columns[4] = {Xs >> 8, Xs & 0xFF, Xe >> 8, Xe & 0xFF};
+    UBYTE Rows[4] = {Ys >> 8, Ys & 0xFF, Ye >> 8, Ye & 0xFF};
+
+    DEV_SPI_DMA_Wait();
+    DEV_Digital_Write(LCD_CS_PIN, 0);
+    LCD_Panel_Command(0x2A, Columns, sizeof(Columns));
+    LCD_Panel_Command(0x2B, Rows, sizeof(Rows));
+    LCD_Panel_Command(0x2C, NULL, 0);
+    DEV_Digital_Write(LCD_DC_PIN, 1);
+}
+
+/********************************************************************************
+function:	Sets the start position and size of the display area
+parameter:
+        Xstart 	:   X direction Start coordinates
+        Ystart  :   Y direction Start coordinates
+        Xend    :   X direction end coordinates
+        Yend    :   Y direction end coordinates
+********************************************************************************/
+void LCD_Panel_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    LCD_Panel_OpenWindow(Xstart, Ystart, Xend, Yend);
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Release CS once a DMA transfer has gone out
+parameter:
+******************************************************************************/
+static void LCD_Panel_DisplayDone(void)
+{
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Clear screen
+parameter:
+Info:
+    One repeated-colour DMA transfer; no image buffer needed. Returns before it finishes.
+    At RGB444 a pair of pixels is three bytes, which only repeats every two bytes
+    when they are all the same (black, white, and the grays). Any other colour is
+    sent from a short run of it instead, and this waits for that.
+******************************************************************************/
+void LCD_Panel_Clear(UWORD Color)
+{
+    const uint32_t Pixels = (uint32_t)LCD_ACTIVE.WIDTH * LCD_ACTIVE.HEIGHT;
+
+    LCD_Panel_OpenWindow(0, 0, LCD_ACTIVE.WIDTH, LCD_ACTIVE.HEIGHT);
+    if (LCD_ACTIVE.PIXEL_BITS != 12)
+    {
+        DEV_SPI_Fill_DMA(Color, Pixels, &LCD_Panel_DisplayDone);
+        return;
+    }
+
+    const UWORD Rgb444 = LCD_PANEL_RGB444(Color);
+    const UBYTE Pair[3] = {Rgb444 >> 4, ((Rgb444 << 4) | (Rgb444 >> 8)) & 0xFF, Rgb444 & 0xFF};
+    const uint32_t Bytes = LCD_Panel_PixelBytes(Pixels);
+    if ((Pair[0] == Pair[1]) && (Pair[1] == Pair[2]))
+    {
+        DEV_SPI_Fill_DMA((UWORD)(Pair[0] << 8) | Pair[0], (Bytes + 1) / 2, &LCD_Panel_DisplayDone);
+        return;
+    }
+
+    UBYTE Run[48];
+    for (UBYTE i = 0; i < sizeof(Run); i++)
+    {
+        Run[i] = Pair[i % 3];
+    }
+    for (uint32_t Sent = 0; Sent < Bytes; Sent += sizeof(Run))
+    {
+        DEV_SPI_Write_nByte(Run, ((Bytes - Sent) < sizeof(Run)) ? (Bytes - Sent) : sizeof(Run));
+    }
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays
+parameter:
+******************************************************************************/
+void LCD_Panel_Display(const void *Image)
+{
+    LCD_Panel_OpenWindow(0, 0, LCD_ACTIVE.WIDTH, LCD_ACTIVE.HEIGHT);
+    DEV_SPI_Write_nByte((uint8_t *)Image, LCD_Panel_PixelBytes((uint32_t)LCD_ACTIVE.WIDTH * LCD_ACTIVE.HEIGHT));
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Sends the image buffer in RAM to displays in a single DMA transfer
+parameter:
+******************************************************************************/
+void LCD_Panel_Display_DMA(const void *Image)
+{
+    LCD_Panel_OpenWindow(0, 0, LCD_ACTIVE.WIDTH, LCD_ACTIVE.HEIGHT);
+    DEV_SPI_Write_nByte_DMA((const uint8_t *)Image, LCD_Panel_PixelBytes((uint32_t)LCD_ACTIVE.WIDTH * LCD_ACTIVE.HEIGHT), &LCD_Panel_DisplayDone);
+}
+
+/******************************************************************************
+function :	Sends rows [Ystart, Yend) of the image buffer in a single DMA transfer
+parameter:
+Info:
+    Full-width rows are contiguous in the buffer, so this is one transfer.
+******************************************************************************/
+void LCD_Panel_DisplayRows_DMA(UWORD Ystart, UWORD Yend, const void *Image)
+{
+    if (Yend > LCD_ACTIVE.HEIGHT)
+    {
+        Yend = LCD_ACTIVE.HEIGHT;
+    }
+    if (Ystart >= Yend)
+    {
+        return;
+    }
+    LCD_Panel_OpenWindow(0, Ystart, LCD_ACTIVE.WIDTH, Yend);
+    Rows_Ystart = Ystart;
+    Rows_Yend = Yend;
+    const uint8_t *start = (const uint8_t *)Image + LCD_Panel_PixelBytes((uint32_t)Ystart * LCD_ACTIVE.WIDTH);
+    DEV_SPI_Write_nByte_DMA(start, LCD_Panel_PixelBytes((uint32_t)(Yend - Ystart) * LCD_ACTIVE.WIDTH), &LCD_Panel_DisplayDone);
+}
+
+/******************************************************************************
+function :	Stop the transfer LCD_Panel_DisplayRows_DMA() started, if it is still going
+parameter:
+return:
+    The first row that didn't go out whole (its Yend, if they all did)
+Info:
+    Only for while that transfer is the last one started. The row it stops in is
+    left half sent, so send it again along with the rest.
+******************************************************************************/
+UWORD LCD_Panel_StopRows_DMA(void)
+{
+    const uint32_t Unsent = DEV_SPI_DMA_Abort();
+    const uint32_t Sent = LCD_Panel_PixelBytes((uint32_t)(Rows_Yend - Rows_Ystart) * LCD_ACTIVE.WIDTH) - Unsent;
+    return Rows_Ystart + (UWORD)(Sent / LCD_Panel_PixelBytes(LCD_ACTIVE.WIDTH));
+}
+
+/******************************************************************************
+function :	Open a pixel write to the given window
+parameter:
+Info:
+    Follow with LCD_Panel_WritePixels_DMA() until the window is full.
+******************************************************************************/
+void LCD_Panel_BeginPixels(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend)
+{
+    LCD_Panel_OpenWindow(Xstart, Ystart, Xend, Yend);
+}
+
+/******************************************************************************
+function :	Stream a chunk of (already byte-ordered) pixel data into the open window
+parameter:
+    Data : Must stay untouched until the transfer completes
+    Len  : Number of bytes
+    Last : Release CS once this chunk has gone out
+Info:
+    Waits for the previous chunk to finish before starting, so two buffers
+    used alternately are enough to keep the bus busy.
+******************************************************************************/
+void LCD_Panel_WritePixels_DMA(const UBYTE *Data, UDOUBLE Len, bool Last)
+{
+    DEV_SPI_Write_nByte_DMA(Data, Len, Last ? &LCD_Panel_DisplayDone : NULL);
+}
+
+/******************************************************************************
+function :	Close a pixel write before the window is full
+parameter:
+Info:
+    Waits for the chunk going out. The next write opens a window of its own.
+******************************************************************************/
+void LCD_Panel_EndPixels(void)
+{
+    DEV_SPI_DMA_Wait();
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Sends a window of a full-screen image buffer
+parameter:
+******************************************************************************/
+void LCD_Panel_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const void *Image)
+{
+    const UBYTE *Pixels = (const UBYTE *)Image;
+    UWORD j;
+    LCD_Panel_OpenWindow(Xstart, Ystart, Xend, Yend);
+    for (j = Ystart; j < Yend; j++)
+    {
+        UDOUBLE Addr = Xstart + (UDOUBLE)j * LCD_ACTIVE.WIDTH;
+        DEV_SPI_Write_nByte((uint8_t *)&Pixels[LCD_Panel_PixelBytes(Addr)], LCD_Panel_PixelBytes(Xend - Xstart));
+    }
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
+
+void LCD_Panel_DisplayPoint(UWORD X, UWORD Y, UWORD Color)
+{
+    UBYTE Pixel[2] = {Color >> 8, Color & 0xFF};
+    if (LCD_ACTIVE.PIXEL_BITS == 12)
+    {
+        // Half a pair; the panel drops the padding nibble when CS goes high
+        const UWORD Rgb444 = LCD_PANEL_RGB444(Color);
+        Pixel[0] = Rgb444 >> 4;
+        Pixel[1] = (Rgb444 << 4) & 0xFF;
+    }
+    LCD_Panel_OpenWindow(X, Y, X + 1, Y + 1);
+    DEV_SPI_Write_nByte(Pixel, sizeof(Pixel));
+    DEV_Digital_Write(LCD_CS_PIN, 1);
+}
@@ -0,0 +1,146 @@
+/*****************************************************************************
+* | File      	:   LCD_Panel.h
+* | Function    :   One driver for every panel, run from a descriptor
+* | Info        :
+*   Each panel's LCD_xxx.c only describes the panel (its init sequence,
+*   its size and RAM offsets in each scan direction, its MADCTL value,
+*   and how long its reset takes) in an LCD_PANEL. This file does the
+*   talking for all of them, so a new panel is a new descriptor.
+*
+*   The controller turns and flips the picture itself (MADCTL), so a
+*   caller can paint in the orientation the panel shows, and needn't
+*   rotate every pixel on the way into its buffer.
+*
+*   Pixels go out as RGB565 unless LCD_Panel_SetPixelFormat() asks for
+*   RGB444, which packs two pixels into three bytes: a quarter less to
+*   send, for pictures that don't need the extra colour.
+*
+*   The controller can also scroll the picture along its frame memory's
+*   rows, wrapping around (LCD_Panel_SetScroll()), so a picture can be
+*   moved by sending a start address and just the lines that came into view.
+*
+*   The controller can sleep (LCD_Panel_Sleep()), keeping its frame
+*   memory, so it wakes showing the picture it was showing.
+*
+*   Commands go out in one CS frame each, with DC flipped between the
+*   command byte and its data, and the data sent in one write, instead of
+*   a CS/DC round trip for every byte.
+******************************************************************************/
+#ifndef __LCD_PANEL_H
+#define __LCD_PANEL_H
+
+#include "../Config/DEV_Config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef HORIZONTAL
+    #define HORIZONTAL 0
+    #define VERTICAL 1
+#endif
+
+/**
+ * Set in an init sequence entry's count to wait after that command:
+ * one more byte follows the data, with the delay in ms.
+ */
+#define LCD_PANEL_DELAY 0x80
+
+/**
+ * Sleep timings: the controller isn't ready for the next command until
+ * LCD_PANEL_SLPOUT_MS after SLPOUT, and needs LCD_PANEL_SLEEP_MS between
+ * SLPIN and SLPOUT (either way round).
+ */
+#define LCD_PANEL_SLPOUT_MS 5
+#define LCD_PANEL_SLEEP_MS 120
+
+/** MADCTL (0x36) bits: row address order, column address order, and row/column exchange. */
+#define LCD_PANEL_MADCTL_MY 0x80
+#define LCD_PANEL_MADCTL_MX 0x40
+#define LCD_PANEL_MADCTL_MV 0x20
+
+/** COLMOD (0x3A) values: 12 (RGB444) or 16 (RGB565) bits a pixel over the bus. */
+#define LCD_PANEL_COLMOD_12BIT 0x03
+#define LCD_PANEL_COLMOD_16BIT 0x05
+
+/** An RGB565 colour as RGB444 (0x0RGB), keeping the top bits of each channel. */
+#define LCD_PANEL_RGB444(Color) ((UWORD)((((Color) >> 4) & 0xF00) | (((Color) >> 3) & 0x0F0) | (((Color) >> 1) & 0x00F)))
+
+/** A panel in one scan direction. */
+typedef struct
+{
+    UWORD Width;        // Visible pixels across, in this direction
+    UWORD Height;       // Visible pixels down
+    UWORD XOffset;      // Column of the controller's RAM that the first visible column is in
+    UWORD YOffset;      // Same for rows
+    UBYTE MemoryAccess; // MADCTL (0x36) value for this direction
+} LCD_PANEL_SCAN;
+
+/**
+ * Everything the driver needs to know about a panel. Kept in flash.
+ *
+ * InitSequence is the register settings sent at init, as entries of: a command, the number of data
+ * bytes that follow it (| LCD_PANEL_DELAY to wait after it), the data bytes, then (with
+ * LCD_PANEL_DELAY) the delay in ms.
+ */
+typedef struct
+{
+    const char *Name;
+    UWORD ResetMs;              // How long each step of the hardware reset takes
+    UBYTE Backlight;            // Backlight (DEV_SET_PWM) level to set at init, or 0 to leave it
+    const UBYTE *InitSequence;  // Entries of: command, data count (| LCD_PANEL_DELAY), data, (delay)
+    UDOUBLE InitSequenceLen;
+    LCD_PANEL_SCAN Scan[2];     // Indexed by HORIZONTAL / VERTICAL
+    UWORD RamColumns;           // Columns of the controller's frame memory with MADCTL's MV clear, or 0 if
+    UWORD RamRows;              // not known; the offsets turned 180 degrees come from these and the visible area
+} LCD_PANEL;
+
+/** The panel that was last initialized, and how. */
+typedef struct
+{
+    const LCD_PANEL *Panel;
+    UWORD WIDTH;
+    UWORD HEIGHT;
+    UBYTE SCAN_DIR;
+    bool UPSIDE_DOWN;   // Is the controller turning the picture upside down?
+    UWORD XOFFSET;      // RAM offsets of the visible area, as turned
+    UWORD YOFFSET;
+    UBYTE PIXEL_BITS;   // 16 (RGB565) or 12 (RGB444): what the image data sent is in
+    bool SCROLLS_X;     // Does scrolling move the picture across (X), rather than up and down (Y)?
+    UWORD SCROLL;       // How far along that the picture is scrolled
+} LCD_PANEL_ATTRIBUTES;
+extern LCD_PANEL_ATTRIBUTES LCD_ACTIVE;
+
+/********************************************************************************
+function:
+            Macro definition variable name
+Info:
+    Windows are [Xstart, Xend) by [Ystart, Yend) in the active scan direction.
+    The _DMA functions and Clear() return once the transfer has started; the
+    image must be left alone until DEV_SPI_DMA_Busy() goes false. The rest
+    return once everything has gone out.
+    Images are in the active pixel format (see LCD_Panel_SetPixelFormat()),
+    and at RGB444 the pixels before each window or row sent from one must
+    come to an even number, so no pixel starts half way through a byte.
+    Clear() and DisplayPoint() take RGB565 colours either way.
+********************************************************************************/
+void LCD_Panel_Init(const LCD_PANEL *Panel, UBYTE Scan_dir);
+void LCD_Panel_Resume(const LCD_PANEL *Panel, UBYTE Scan_dir);
+void LCD_Panel_SendCommand(UBYTE Command, const UBYTE *Data, UBYTE Len);
+void LCD_Panel_Sleep(bool On);
+void LCD_Panel_SetTearingEffect(bool On);
+void LCD_Panel_SetRotate180(bool On);
+void LCD_Panel_SetPixelFormat(UBYTE Bits);
+bool LCD_Panel_SetScroll(UWORD Offset);
+UDOUBLE LCD_Panel_PixelBytes(UDOUBLE Pixels);
+void LCD_Panel_SetWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_Panel_Clear(UWORD Color);
+void LCD_Panel_Display(const void *Image);
+void LCD_Panel_Display_DMA(const void *Image);
+void LCD_Panel_DisplayRows_DMA(UWORD Ystart, UWORD Yend, const void *Image);
+UWORD LCD_Panel_StopRows_DMA(void);
+void LCD_Panel_BeginPixels(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_Panel_WritePixels_DMA(const UBYTE *Data, UDOUBLE Len, bool Last);
+void LCD_Panel_EndPixels(void);
+void LCD_Panel_DisplayWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, const void *Image);
+void LCD_Panel_DisplayPoint(UWORD X, UWORD Y, UWORD Color);
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file hotpaths.h
+ * @brief Marks the functions and tables that ISRs and render loops run through, so that
+ * firmware built with HOT_PATHS_IN_RAM copies them to RAM, where they never wait on an
+ * XIP cache miss. Otherwise the macros leave them where they are, and need nothing from
+ * the Pico SDK, so the host can build the same sources.
+ */
+#pragma once
+
+#if HOT_PATHS_IN_RAM
+    // SDK includes
+    #include "pico.h"
+    /** Wrap the name of a function to run it from RAM: `void HOT_FUNC(my_isr)(void)`. */
+    #define HOT_FUNC(f) __not_in_flash_func(f)
+    /** Wrap the name of a variable to keep it in RAM: `static const int HOT_DATA(table)[]`. */
+    #define HOT_DATA(v) __not_in_flash(#v) v
+#else
+    #define HOT_FUNC(f) f
+    #define HOT_DATA(v) v
+#endif // HOT_PATHS_IN_RAM
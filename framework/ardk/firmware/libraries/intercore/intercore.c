@@ -0,0 +1,172 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+// SDK includes
+#include "hardware/claim.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+// Library includes
+#include <hotpaths.h>
+// Local includes
+#include "intercore.h"
+
+/** Upper bits of a doorbell's FIFO word, so anything else that comes through the FIFO is ignored. */
+#define DOORBELL_TAG        0xDB000000u
+
+/** Mask for the upper bits of a FIFO word. */
+#define DOORBELL_TAG_MASK   0xFFFFFF00u
+
+/** What each doorbell calls. Written before the doorbell is given to its channel, and never changed. */
+static struct {
+    intercore_doorbell_t handler;
+    void *context;
+} doorbells[INTERCORE_MAX_DOORBELLS];
+
+/** How many of doorbells[] are in use. */
+static volatile uint32_t ndoorbells = 0;
+
+/** Has each core's SIO interrupt been pointed at us? */
+static bool doorbell_irq_installed[2] = {false, false};
+
+/** This core's SIO interrupt: ring every doorbell that came through the FIFO. */
+static void HOT_FUNC(_doorbell_irq_handler)(void)
+{
+    while (multicore_fifo_rvalid())
+    {
+        const uint32_t word = multicore_fifo_pop_blocking();
+        const uint32_t index = word & ~DOORBELL_TAG_MASK;
+        if (((word & DOORBELL_TAG_MASK) == DOORBELL_TAG) && (index < ndoorbells))
+        {
+            doorbells[index].handler(doorbells[index].context);
+        }
+    }
+
+    // Clear any overflow the sender caused
+    multicore_fifo_clear_irq();
+}
+
+bool intercore_channel_init(intercore_channel_t *channel, void *storage, size_t item_size, uint32_t capacity)
+{
+    if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+    {
+        return false;
+    }
+
+    channel->items = (uint8_t *)storage;
+    channel->item_size = item_size;
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->tail = 0;
+    channel->doorbell = -1;
+    return true;
+}
+
+bool HOT_FUNC(intercore_try_send)(intercore_channel_t *channel, const void *item)
+{
+    const uint32_t head = channel->head;
+    if ((head - channel->tail) >= channel->capacity)
+    {
+        return false;
+    }
+
+    memcpy(&channel->items[(head & (channel->capacity - 1)) * channel->item_size], item, channel->item_size);
+
+    // The item has to be in memory before the receiver can see the new head
+    __dmb();
+    channel->head = head + 1;
+
+    const int8_t doorbell = channel->doorbell;
+    if ((doorbell >= 0) && multicore_fifo_wready())
+    {
+        // We're the only one writing to this FIFO, so there's still room. If there wasn't,
+        // the doorbells already in it haven't been answered yet, and the handler takes this item too.
+        multicore_fifo_push_blocking(DOORBELL_TAG | (uint32_t)doorbell);
+    }
+
+    // Wake the receiver if it is sleeping in intercore_receive_blocking()
+    __sev();
+    return true;
+}
+
+bool HOT_FUNC(intercore_try_receive)(intercore_channel_t *channel, void *item)
+{
+    const uint32_t tail = channel->tail;
+    if (tail == channel->head)
+    {
+        return false;
+    }
+
+    // Don't read the item until we've seen the head that published it
+    __dmb();
+    memcpy(item, &channel->items[(tail & (channel->capacity - 1)) * channel->item_size], channel->item_size);
+
+    // Finish reading before handing the slot back to the sender
+    __dmb();
+    channel->tail = tail + 1;
+    return true;
+}
+
+void HOT_FUNC(intercore_receive_blocking)(intercore_channel_t *channel, void *item)
+{
+    // If the sender publishes between the check and the __wfe(), its __sev()
+    // has already set our event register, so the __wfe() returns immediately.
+    while (!intercore_try_receive(channel, item))
+    {
+        __wfe();
+    }
+}
+
+bool intercore_receive_timeout_us(intercore_channel_t *channel, void *item, uint32_t timeout_us)
+{
+    const absolute_time_t deadline = make_timeout_time_us(timeout_us);
+    while (!intercore_try_receive(channel, item))
+    {
+        // An alarm's event wakes us at the deadline, as a send's does before it
+        if (best_effort_wfe_or_timeout(deadline))
+        {
+            // One may have come in just as we gave up
+            return intercore_try_receive(channel, item);
+        }
+    }
+    return true;
+}
+
+uint32_t intercore_count(const intercore_channel_t *channel)
+{
+    return channel->head - channel->tail;
+}
+
+bool intercore_set_doorbell(intercore_channel_t *channel, intercore_doorbell_t handler, void *context)
+{
+    // Either core can be handing out doorbells at the same time. The SDK's claim lock is for just this.
+    const uint32_t saved = hw_claim_lock();
+    const uint32_t index = ndoorbells;
+    if (index >= INTERCORE_MAX_DOORBELLS)
+    {
+        hw_claim_unlock(saved);
+        return false;
+    }
+    doorbells[index].handler = handler;
+    doorbells[index].context = context;
+    ndoorbells = index + 1;
+    hw_claim_unlock(saved);
+
+    const uint core = get_core_num();
+    if (!doorbell_irq_installed[core])
+    {
+        const uint irq = (core == 0) ? SIO_IRQ_PROC0 : SIO_IRQ_PROC1;
+        multicore_fifo_clear_irq();
+        irq_set_exclusive_handler(irq, &_doorbell_irq_handler);
+        irq_set_enabled(irq, true);
+        doorbell_irq_installed[core] = true;
+    }
+
+    // Only now can the sender start ringing it
+    __dmb();
+    channel->doorbell = (int8_t)index;
+    return true;
+}
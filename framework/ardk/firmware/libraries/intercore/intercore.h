@@ -0,0 +1,108 @@
+/**
+ * @file intercore.h
+ * @brief Inter-core messaging.
+ * Hands fixed-size items from one core to the other through lock-free rings in shared RAM.
+ * The receiving core can either wait for items (sleeping with `__wfe` until the sender's `__sev`)
+ * or have a doorbell rung: an interrupt, raised through the SIO FIFO, whenever items arrive.
+ *
+ * Each channel goes one way: one core only ever sends on it, and the other only ever receives.
+ * That's what lets it do without a spin lock.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef INTERCORE_MAX_DOORBELLS
+    /** How many channels can have a doorbell (see intercore_set_doorbell()). */
+    #define INTERCORE_MAX_DOORBELLS 8
+#endif // INTERCORE_MAX_DOORBELLS
+
+/** Called (from the receiving core's SIO interrupt) when a channel's doorbell rings. */
+typedef void (*intercore_doorbell_t)(void *context);
+
+/** A one-way channel between the cores. Set up with intercore_channel_init(); the fields are the library's. */
+typedef struct intercore_channel {
+    uint8_t *items;             ///< capacity items of item_size bytes
+    size_t item_size;
+    uint32_t capacity;          ///< A power of two
+    volatile uint32_t head;     ///< Free-running count of items sent. Only the sending core writes it.
+    volatile uint32_t tail;     ///< Free-running count of items received. Only the receiving core writes it.
+    volatile int8_t doorbell;   ///< Index of this channel's doorbell, or -1 if it has none
+} intercore_channel_t;
+
+/**
+ * @brief Set up a channel. Call before either core uses it (before launching core 1, say).
+ *
+ * @param channel The channel.
+ * @param storage Room for `capacity` items of `item_size` bytes. Must outlive the channel.
+ * @param item_size Size of each item, in bytes.
+ * @param capacity How many items can be waiting at once. Must be a power of two.
+ * @return false (and the channel is unusable) if capacity isn't a power of two.
+ */
+bool intercore_channel_init(intercore_channel_t *channel, void *storage, size_t item_size, uint32_t capacity);
+
+/**
+ * @brief Send an item, from the sending core. This does not block.
+ * Wakes the receiving core if it is waiting, and rings the channel's doorbell if it has one.
+ *
+ * @param channel The channel.
+ * @param item item_size bytes. Copied.
+ * @return false if the channel is full (and the item isn't sent).
+ */
+bool intercore_try_send(intercore_channel_t *channel, const void *item);
+
+/**
+ * @brief Take the oldest item, from the receiving core. This does not block.
+ *
+ * @param channel The channel.
+ * @param item Where to put it (item_size bytes).
+ * @return false if there was nothing to take.
+ */
+bool intercore_try_receive(intercore_channel_t *channel, void *item);
+
+/**
+ * @brief Take the oldest item, from the receiving core, sleeping until there is one.
+ *
+ * @param channel The channel.
+ * @param item Where to put it (item_size bytes).
+ */
+void intercore_receive_blocking(intercore_channel_t *channel, void *item);
+
+/**
+ * @brief Like intercore_receive_blocking(), but give up after a while.
+ *
+ * @param channel The channel.
+ * @param item Where to put it (item_size bytes).
+ * @param timeout_us How long to wait for one.
+ * @return false if none came in time.
+ */
+bool intercore_receive_timeout_us(intercore_channel_t *channel, void *item, uint32_t timeout_us);
+
+/** How many items are waiting on a channel. Either core can ask, but the answer may be out of date by the time it returns. */
+uint32_t intercore_count(const intercore_channel_t *channel);
+
+/**
+ * @brief Give a channel a doorbell: from now on, each send also raises the SIO interrupt
+ * on the core that calls this (which must be the channel's receiving core), and `handler`
+ * runs from it. Sends made while the SIO FIFO is full don't ring it again, so the handler
+ * should take everything that is waiting, not just one item.
+ *
+ * The doorbell takes over this core's SIO interrupt, so it can't be used alongside
+ * `multicore_lockout` on the same core.
+ *
+ * @param channel The channel.
+ * @param handler What to call.
+ * @param context Passed to handler.
+ * @return false if there are INTERCORE_MAX_DOORBELLS doorbells already.
+ */
+bool intercore_set_doorbell(intercore_channel_t *channel, intercore_doorbell_t handler, void *context);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,40 +1,106 @@
 // Std lib includes
 #include <stdio.h>
 // SDK includes
+#include "hardware/dma.h"
 #include "hardware/gpio.h"
-#include "hardware/irq.h"
 #include "hardware/pwm.h"
 // Library includes
 #include "../errors/errors.h"
+#include <sysclock.h>
 // Local includes
 #include "leds.h"
 
+/** PWM periods in one heartbeat, each a step of heartbeat_levels: up and back down, ~1 s. */
+#define HEARTBEAT_STEPS 512
+
+/**
+ * The PWM counter's rate: the system clock divided by 4 at the default 125 MHz, and by whatever
+ * keeps it there at other clocks. It wraps over its whole range (0 to 2**16-1), so a period is ~2 ms.
+ */
+#define LED_PWM_COUNT_HZ 31250000U
+
 /** Possible modes of the LED. */
 typedef enum {
     LED_MODE_UNASSIGNED,    // Default value for LED before we have initialized.
     LED_MODE_ON_OFF,        // The LED must be turned on or off explicitly through the command interface while in this mode.
     LED_MODE_HEARTBEAT,     // The LED displays a fade in/fade out pattern while in this mode.
+    LED_MODE_PATTERN,       // The LED plays a pattern (see leds_play()) while in this mode.
 } led_mode_t;
 
+/** The PWM's clock divider, in sixteenths, and the system clock it was worked out for. See set_pwm_divider(). */
+static uint32_t pwm_div_16ths = 4U << 4;
+static uint32_t pwm_sys_hz = 125000000U;
+
 /** Depending on the mode of LED we want, the LED pin must be configured differently. */
 static led_mode_t led_mode = LED_MODE_UNASSIGNED;
 
 /** The GPIO pin that we use as the LED. This gets set during initialization. */
 static uint _LED_PIN = 0;
 
+/**
+ * The LED's PWM level for each PWM period of a heartbeat. The fade is squared so the brightness looks
+ * linear, and it runs over the whole of the counter's range (it wraps at 2**16-1).
+ */
+static uint16_t heartbeat_levels[HEARTBEAT_STEPS];
+
+/** Where the heartbeat starts, for the control channel to load into the data channel's READ_ADDR_TRIG. */
+static const uint16_t *heartbeat_start = heartbeat_levels;
+
+/**
+ * DMA channels that play the heartbeat and patterns: the data channel writes levels into the PWM
+ * compare register, once per wrap, and the control channel sets it going again when it runs out.
+ * -1 if unclaimed.
+ */
+static int data_channel = -1;
+static int ctrl_channel = -1;
+
+/**
+ * A step of a pattern, as the control channel writes it into the data channel's AL2 registers
+ * (CTRL, TRANS_COUNT, READ_ADDR, then WRITE_ADDR_TRIG, which starts it).
+ */
+typedef struct {
+    uint32_t ctrl;              // The data channel's configuration
+    uint32_t count;             // PWM periods to hold the level for
+    const void *read;           // The level
+    volatile void *write;       // The PWM compare register
+} pattern_block_t;
+
+/**
+ * The pattern being played: a block per step, then one that puts the control channel back at the first
+ * (to loop) or a null one (all zeros, which stops it, as a null trigger).
+ */
+static pattern_block_t pattern_blocks[LEDS_PATTERN_MAX_STEPS + 1];
+
+/** Each step's PWM level. */
+static uint16_t pattern_levels[LEDS_PATTERN_MAX_STEPS];
+
+/** Where the pattern starts, for the block that loops it to load into the control channel's READ_ADDR. */
+static const pattern_block_t *pattern_start = pattern_blocks;
+
+/** Is the pattern an error's blink code (see leds_report_error())? */
+static bool pattern_is_error = false;
+
 /** Deconfigure LED pin from ON/OFF mode. */
 static inline void deconfigure_led_on_off_mode(void)
 {
     gpio_init(_LED_PIN);
 }
 
-/** Deconfigure LED pin from heartbeat mode. */
-static inline void deconfigure_led_heartbeat_mode(void)
+/** Deconfigure LED pin from heartbeat or pattern mode. */
+static inline void deconfigure_led_pwm_mode(void)
 {
     uint slice_num = pwm_gpio_to_slice_num(_LED_PIN);
+    if (data_channel >= 0)
+    {
+        // Both at once, so the data channel can't chain into the control channel after it was stopped
+        const uint32_t mask = (1u << data_channel) | (1u << ctrl_channel);
+        dma_hw->abort = mask;
+        while (dma_hw->abort & mask)
+        {
+            tight_loop_contents();
+        }
+    }
     pwm_set_enabled(slice_num, false);
-    pwm_set_irq_enabled(slice_num, false);
-    irq_set_enabled(PWM_IRQ_WRAP, false);
     gpio_init(_LED_PIN);
 }
 
@@ -45,40 +111,38 @@ static inline void configure_led_on_off_mode(void)
     gpio_set_dir(_LED_PIN, GPIO_OUT);
 }
 
-/** IRQ for the PWM which handles heartbeat mode. */
-static void heartbeat_on_pwm_wrap_cb(void)
+/** Work out the heartbeat's levels, and claim the DMA channels that play it and the patterns. */
+static void init_dma(void)
 {
-    static volatile int fade = 0;
-    static volatile bool going_up = true;
-
-    // Clear the interrupt flag that brought us here
-    pwm_clear_irq(pwm_gpio_to_slice_num(_LED_PIN));
+    for (uint i = 0; i < HEARTBEAT_STEPS / 2; i++)
+    {
+        const uint fade = (i * 256) / (HEARTBEAT_STEPS / 2);
+        heartbeat_levels[i] = (uint16_t)(fade * fade);
+        heartbeat_levels[HEARTBEAT_STEPS - 1 - i] = (uint16_t)(fade * fade);
+    }
 
-    if (going_up)
+    const int data = dma_claim_unused_channel(false);
+    const int ctrl = dma_claim_unused_channel(false);
+    if ((data < 0) || (ctrl < 0))
     {
-        fade++;
-        if (fade > 255)
+        log_error("No free DMA channels for the LED heartbeat. It will stay on.\n");
+        set_errno(ERR_ID_LEDS_MODULE, ENOMEM);
+        if (data >= 0)
         {
-            fade = 255;
-            going_up = false;
+            dma_channel_unclaim(data);
         }
-    }
-    else
-    {
-        fade--;
-        if (fade < 0)
+        if (ctrl >= 0)
         {
-            fade = 0;
-            going_up = true;
+            dma_channel_unclaim(ctrl);
         }
+        return;
     }
-    // Square the fade value to make the LED's brightness appear more linear
-    // Note this range matches with the wrap value
-    pwm_set_gpio_level(_LED_PIN, fade * fade);
+    data_channel = data;
+    ctrl_channel = ctrl;
 }
 
-/** Configure the LED pin for heartbeat mode. */
-static void configure_led_heartbeat_mode(void)
+/** Hand the LED pin to its PWM slice, and set the slice up, but leave it stopped until the DMA is waiting on it. */
+static uint init_led_pwm(void)
 {
     // This function is taken originally from the Pico examples
 
@@ -88,19 +152,77 @@ static void configure_led_heartbeat_mode(void)
     // Figure out which slice we just connected to the LED pin
     uint slice_num = pwm_gpio_to_slice_num(_LED_PIN);
 
-    // Register our interrupt handler with the PWM subsystem.
-    pwm_clear_irq(slice_num);
-    pwm_set_irq_enabled(slice_num, true);
-    irq_set_exclusive_handler(PWM_IRQ_WRAP, heartbeat_on_pwm_wrap_cb);
-    irq_set_enabled(PWM_IRQ_WRAP, true);
-
     // Get some sensible defaults for the slice configuration. By default, the
     // counter is allowed to wrap over its maximum range (0 to 2**16-1)
     pwm_config config = pwm_get_default_config();
     // Set divider, reduces counter clock to sysclock/this value
-    pwm_config_set_clkdiv(&config, 4.0f);
-    // Load the configuration into our PWM slice, and set it running.
-    pwm_init(slice_num, &config, true);
+    pwm_config_set_clkdiv_int_frac(&config, (uint8_t)(pwm_div_16ths >> 4), (uint8_t)(pwm_div_16ths & 0xFU));
+    // Load the configuration into our PWM slice, but don't start it yet.
+    pwm_init(slice_num, &config, false);
+    return slice_num;
+}
+
+/**
+ * The data channel's configuration for writing levels into the LED's PWM compare register, one per
+ * wrap. A 16-bit write to the register is repeated into both halves, so it sets whichever channel the
+ * LED is on (and the other, which isn't ours to use then).
+ */
+static dma_channel_config level_writer_config(uint slice_num, bool read_increment)
+{
+    dma_channel_config c = dma_channel_get_default_config(data_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, read_increment);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pwm_get_dreq(slice_num));
+    channel_config_set_chain_to(&c, ctrl_channel);
+    return c;
+}
+
+/** Configure the LED pin for heartbeat mode. The DMA plays it from then on, with no interrupts. */
+static void configure_led_heartbeat_mode(void)
+{
+    uint slice_num = init_led_pwm();
+    if (data_channel < 0)
+    {
+        pwm_set_gpio_level(_LED_PIN, 0xFFFF);
+        pwm_set_enabled(slice_num, true);
+        return;
+    }
+
+    dma_channel_config c = level_writer_config(slice_num, true);
+    dma_channel_configure(data_channel, &c, &pwm_hw->slice[slice_num].cc, heartbeat_levels, HEARTBEAT_STEPS, false);
+
+    // Puts the data channel back at the start of the table, which starts it again (with its count reloaded)
+    c = dma_channel_get_default_config(ctrl_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(ctrl_channel, &c, &dma_hw->ch[data_channel].al3_read_addr_trig, &heartbeat_start, 1, true);
+
+    pwm_set_enabled(slice_num, true);
+}
+
+/** Configure the LED pin for pattern mode, and start the pattern in pattern_blocks. */
+static void configure_led_pattern_mode(void)
+{
+    uint slice_num = init_led_pwm();
+    if (data_channel < 0)
+    {
+        pwm_set_gpio_level(_LED_PIN, 0xFFFF);
+        pwm_set_enabled(slice_num, true);
+        return;
+    }
+
+    // Loads each block into the data channel in turn, which starts it
+    dma_channel_config c = dma_channel_get_default_config(ctrl_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);
+    dma_channel_configure(ctrl_channel, &c, &dma_hw->ch[data_channel].al2_ctrl, pattern_blocks,
+                          sizeof(pattern_block_t) / sizeof(uint32_t), true);
+
+    pwm_set_enabled(slice_num, true);
 }
 
 /** Configure the LED mode. */
@@ -119,7 +241,8 @@ static void configure_led(led_mode_t new_mode)
             deconfigure_led_on_off_mode();
             break;
         case LED_MODE_HEARTBEAT:
-            deconfigure_led_heartbeat_mode();
+        case LED_MODE_PATTERN:
+            deconfigure_led_pwm_mode();
             break;
         case LED_MODE_UNASSIGNED:
             // Nothing to do
@@ -141,6 +264,9 @@ static void configure_led(led_mode_t new_mode)
         case LED_MODE_HEARTBEAT:
             configure_led_heartbeat_mode();
             break;
+        case LED_MODE_PATTERN:
+            configure_led_pattern_mode();
+            break;
         case LED_MODE_UNASSIGNED:
             log_error("Trying to set the LED back to unassigned state after initialization.\n");
             // Fall through
@@ -181,9 +307,137 @@ void leds_heartbeat(void)
     }
 }
 
+void leds_play(const leds_step_t *steps, size_t nsteps, bool loop)
+{
+    if ((nsteps == 0) || (nsteps > LEDS_PATTERN_MAX_STEPS))
+    {
+        log_error("LED patterns have 1 to %u steps, not %u\n", (unsigned)LEDS_PATTERN_MAX_STEPS, (unsigned)nsteps);
+        set_errno(ERR_ID_LEDS_MODULE, EINVAL);
+        return;
+    }
+
+    // Stop the one playing first, since the DMA reads the blocks as it goes
+    if (led_mode == LED_MODE_PATTERN)
+    {
+        deconfigure_led_pwm_mode();
+        led_mode = LED_MODE_UNASSIGNED;
+    }
+    pattern_is_error = false;
+
+    if (data_channel >= 0)
+    {
+        uint slice_num = pwm_gpio_to_slice_num(_LED_PIN);
+        const dma_channel_config level_config = level_writer_config(slice_num, false);
+        const uint32_t level_ctrl = channel_config_get_ctrl_value(&level_config);
+        const uint64_t periods_per_s = ((uint64_t)pwm_sys_hz * 16u) / ((uint64_t)pwm_div_16ths * 65536u);
+        for (size_t i = 0; i < nsteps; i++)
+        {
+            const uint64_t periods = (periods_per_s * steps[i].duration_ms) / 1000;
+            // Squared, like the heartbeat, so the brightness looks linear
+            pattern_levels[i] = (uint16_t)(steps[i].level * steps[i].level);
+            pattern_blocks[i] = (pattern_block_t){
+                .ctrl = level_ctrl,
+                .count = (periods > 0) ? (uint32_t)periods : 1,
+                .read = &pattern_levels[i],
+                .write = &pwm_hw->slice[slice_num].cc,
+            };
+        }
+
+        if (loop)
+        {
+            // Writes the first block's address into the control channel (without starting it) as soon as it
+            // is loaded, then chains to it, so it carries on from there
+            dma_channel_config c = dma_channel_get_default_config(data_channel);
+            channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+            channel_config_set_read_increment(&c, false);
+            channel_config_set_write_increment(&c, false);
+            channel_config_set_chain_to(&c, ctrl_channel);
+            pattern_blocks[nsteps] = (pattern_block_t){
+                .ctrl = channel_config_get_ctrl_value(&c),
+                .count = 1,
+                .read = &pattern_start,
+                .write = &dma_hw->ch[ctrl_channel].read_addr,
+            };
+        }
+        else
+        {
+            // The LED is left on the last step's level
+            pattern_blocks[nsteps] = (pattern_block_t){0};
+        }
+    }
+
+    configure_led(LED_MODE_PATTERN);
+}
+
+/** Each error's number in its blink code: its place in err_t. */
+static uint8_t error_blinks(err_t error)
+{
+    static const err_t errors[] = {
+        EPERM, ENOENT, EINTR, EIO, ENXIO, E2BIG, ENOEXEC, EAGAIN,
+        ENOMEM, EBUSY, EINVAL, ENODATA, ETIME, EALREADY, EINIT,
+    };
+    for (size_t i = 0; i < (sizeof(errors) / sizeof(errors[0])); i++)
+    {
+        if (errors[i] == error)
+        {
+            return (uint8_t)(i + 1);
+        }
+    }
+    return 0;
+}
+
+void leds_blink_error(err_module_id_t module_id, err_t error)
+{
+    // Long blinks for the module, then short ones for the error, then a long gap
+    const uint8_t longs = (uint8_t)(module_id >> 8);
+    const uint8_t shorts = error_blinks(error);
+    leds_step_t steps[LEDS_PATTERN_MAX_STEPS];
+    size_t nsteps = 0;
+    for (uint8_t i = 0; (i < longs) && ((nsteps + 2) <= LEDS_PATTERN_MAX_STEPS); i++)
+    {
+        steps[nsteps++] = (leds_step_t){255, LEDS_BLINK_LONG_MS};
+        steps[nsteps++] = (leds_step_t){0, LEDS_BLINK_OFF_MS};
+    }
+    if (nsteps > 0)
+    {
+        steps[nsteps - 1].duration_ms = LEDS_BLINK_DIGIT_GAP_MS;
+    }
+    for (uint8_t i = 0; (i < shorts) && ((nsteps + 2) <= LEDS_PATTERN_MAX_STEPS); i++)
+    {
+        steps[nsteps++] = (leds_step_t){255, LEDS_BLINK_SHORT_MS};
+        steps[nsteps++] = (leds_step_t){0, LEDS_BLINK_OFF_MS};
+    }
+    if (nsteps == 0)
+    {
+        steps[nsteps++] = (leds_step_t){0, 0};
+    }
+    steps[nsteps - 1].duration_ms = LEDS_BLINK_CODE_GAP_MS;
+
+    leds_play(steps, nsteps, true);
+    pattern_is_error = true;
+}
+
+void leds_report_error(err_module_id_t module_id, err_t error)
+{
+    if ((led_mode == LED_MODE_HEARTBEAT) || ((led_mode == LED_MODE_PATTERN) && pattern_is_error))
+    {
+        leds_blink_error(module_id, error);
+    }
+}
+
+/** Keep the PWM counter at LED_PWM_COUNT_HZ, so the heartbeat and patterns keep time at any system clock. */
+static void set_pwm_divider(uint32_t sys_hz, void *context)
+{
+    pwm_sys_hz = sys_hz;
+    pwm_div_16ths = (uint32_t)((((uint64_t)sys_hz * 16U) + (LED_PWM_COUNT_HZ / 2U)) / LED_PWM_COUNT_HZ);
+    pwm_set_clkdiv_int_frac(pwm_gpio_to_slice_num(_LED_PIN), (uint8_t)(pwm_div_16ths >> 4), (uint8_t)(pwm_div_16ths & 0xFU));
+}
+
 void leds_init(uint led_pin)
 {
     log_info("Init LEDs\n");
     _LED_PIN = led_pin;
+    sysclock_register(&set_pwm_divider, NULL);
+    init_dma();
     configure_led(LED_MODE_HEARTBEAT);
 }
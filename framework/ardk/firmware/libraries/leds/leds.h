@@ -5,7 +5,13 @@
  */
 #pragma once
 
+// Std lib includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+// Library includes
 #include "../cmds/cmds.h"
+#include "../errors/errors.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +32,50 @@ void leds_off(void);
 /** Turn the LED to heartbeat mode. */
 void leds_heartbeat(void);
 
+/** The most steps a pattern can have. */
+#define LEDS_PATTERN_MAX_STEPS 48
+
+/** Blink code timings (see leds_blink_error()), in ms. */
+#define LEDS_BLINK_LONG_MS          600
+#define LEDS_BLINK_SHORT_MS         150
+#define LEDS_BLINK_OFF_MS           400
+#define LEDS_BLINK_DIGIT_GAP_MS     1200
+#define LEDS_BLINK_CODE_GAP_MS      2500
+
+/** A step of an LED pattern. */
+typedef struct {
+    uint8_t level;          ///< Brightness, 0 (off) to 255 (full). Squared on the way out, so it looks linear.
+    uint16_t duration_ms;   ///< How long to hold it. Rounded down to the PWM's period (~2 ms), but at least one.
+} leds_step_t;
+
+/**
+ * @brief Play a pattern on the LED. The DMA steps through it, so it costs no CPU time once started.
+ *
+ * The steps are copied, so they needn't outlive the call. A pattern that doesn't loop leaves
+ * the LED at its last step's level. leds_on(), leds_off(), leds_heartbeat(), or another pattern
+ * replaces it.
+ *
+ * @param steps The steps, up to LEDS_PATTERN_MAX_STEPS.
+ * @param nsteps How many.
+ * @param loop Play it again from the top when it ends, until it is replaced.
+ */
+void leds_play(const leds_step_t *steps, size_t nsteps, bool loop);
+
+/**
+ * @brief Blink an error's code on the LED, over and over, until it is replaced.
+ *
+ * A long blink for each of the module's number (module_id >> 8), a gap, then a short blink
+ * for each of the error's place in err_t (EPERM is 1, EINIT 15, and 0 for any other), then
+ * a longer gap. The README has the table.
+ */
+void leds_blink_error(err_module_id_t module_id, err_t error);
+
+/**
+ * @brief Blink an error's code (see leds_blink_error()), but only if the LED is on its heartbeat
+ * or already blinking one. An LED that was set on, off, or to a pattern is left alone.
+ */
+void leds_report_error(err_module_id_t module_id, err_t error);
+
 #ifdef __cplusplus
 }
 #endif
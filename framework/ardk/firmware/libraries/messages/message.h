@@ -0,0 +1,158 @@
+/**
+ * @file message.h
+ * @brief Structs, and their MsgPack serializers, generated from a list of fields.
+ *
+ * A message is listed once, as a macro that applies FIELD(kind, type, name) to each field:
+ *
+ *     #define IMU_SAMPLE_FIELDS(FIELD) \
+ *         FIELD(UINT, uint32_t, timestamp_ms) \
+ *         FIELD(INT, int16_t, accel_x) \
+ *         FIELD(FLOAT, float, temperature_c) \
+ *         FIELD(BIN, msgpack_bin_t, raw)
+ *
+ *     MESSAGE_DECLARE(imu_sample, IMU_SAMPLE_FIELDS)    // In a header
+ *     MESSAGE_DEFINE(imu_sample, IMU_SAMPLE_FIELDS)     // In one .c file
+ *
+ * which makes imu_sample_t, and
+ *
+ *     bool imu_sample_pack(const imu_sample_t *message, msgpack_writer_t *writer);
+ *     bool imu_sample_unpack(imu_sample_t *message, msgpack_reader_t *reader);
+ *
+ * A message goes on the wire as an array of its fields, in order (see MsgPackSchema.md).
+ *
+ * The kinds, and the types they take:
+ *
+ * | Kind    | Type                                  | MsgPack                           |
+ * |---------|---------------------------------------|-----------------------------------|
+ * | UINT    | uint8_t to uint64_t                   | integer, refused if out of range  |
+ * | INT     | int8_t to int64_t                     | integer, refused if out of range  |
+ * | BOOL    | bool                                  | bool                              |
+ * | FLOAT   | float                                 | float 32 (reads any float or int) |
+ * | DOUBLE  | double                                | float 64 (reads any float or int) |
+ * | STR     | msgpack_str_t                         | str, pointed to in the payload    |
+ * | BIN     | msgpack_bin_t                         | bin, pointed to in the payload    |
+ * | MESSAGE | another message's name (`imu_sample`) | that message's array              |
+ *
+ * Unpacked strings and binary data point into the reader's buffer, so they are only good
+ * for as long as it is.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "msgpack.h"
+
+/** A STR field: a string in a payload (not NUL-terminated), or to be packed. */
+typedef struct {
+    const char *str;
+    size_t len;
+} msgpack_str_t;
+
+/** A BIN field: binary data in a payload, or to be packed. */
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} msgpack_bin_t;
+
+/*
+ * The rest is what MESSAGE_DECLARE() and MESSAGE_DEFINE() are made of.
+ */
+
+#define MESSAGE_TYPE_UINT(type) type
+#define MESSAGE_TYPE_INT(type) type
+#define MESSAGE_TYPE_BOOL(type) type
+#define MESSAGE_TYPE_FLOAT(type) type
+#define MESSAGE_TYPE_DOUBLE(type) type
+#define MESSAGE_TYPE_STR(type) type
+#define MESSAGE_TYPE_BIN(type) type
+#define MESSAGE_TYPE_MESSAGE(type) type##_t
+
+#define MESSAGE_PACK_UINT(writer, type, value) msgpack_write_uint((writer), (value))
+#define MESSAGE_PACK_INT(writer, type, value) msgpack_write_int((writer), (value))
+#define MESSAGE_PACK_BOOL(writer, type, value) msgpack_write_bool((writer), (value))
+#define MESSAGE_PACK_FLOAT(writer, type, value) msgpack_write_float((writer), (value))
+#define MESSAGE_PACK_DOUBLE(writer, type, value) msgpack_write_double((writer), (value))
+#define MESSAGE_PACK_STR(writer, type, value) msgpack_write_str((writer), (value).str, (value).len)
+#define MESSAGE_PACK_BIN(writer, type, value) msgpack_write_bin((writer), (value).data, (value).len)
+#define MESSAGE_PACK_MESSAGE(writer, type, value) type##_pack(&(value), (writer))
+
+/** Integers are read at full width, then refused if they don't survive the trip into the field's type. */
+#define MESSAGE_UNPACK_UINT(reader, type, value) \
+    do { \
+        uint64_t wide_ = 0; \
+        if (msgpack_read_uint((reader), &wide_) && ((uint64_t)(type)wide_ != wide_)) \
+        { \
+            (reader)->error = true; \
+        } \
+        (value) = (type)wide_; \
+    } while (0)
+#define MESSAGE_UNPACK_INT(reader, type, value) \
+    do { \
+        int64_t wide_ = 0; \
+        if (msgpack_read_int((reader), &wide_) && ((int64_t)(type)wide_ != wide_)) \
+        { \
+            (reader)->error = true; \
+        } \
+        (value) = (type)wide_; \
+    } while (0)
+#define MESSAGE_UNPACK_BOOL(reader, type, value) msgpack_read_bool((reader), &(value))
+#define MESSAGE_UNPACK_FLOAT(reader, type, value) msgpack_read_float((reader), &(value))
+#define MESSAGE_UNPACK_DOUBLE(reader, type, value) msgpack_read_double((reader), &(value))
+#define MESSAGE_UNPACK_STR(reader, type, value) msgpack_read_str((reader), &(value).str, &(value).len)
+#define MESSAGE_UNPACK_BIN(reader, type, value) msgpack_read_bin((reader), &(value).data, &(value).len)
+#define MESSAGE_UNPACK_MESSAGE(reader, type, value) type##_unpack(&(value), (reader))
+
+#define MESSAGE_STRUCT_FIELD(kind, type, name) MESSAGE_TYPE_##kind(type) name;
+#define MESSAGE_COUNT_FIELD(kind, type, name) + 1
+#define MESSAGE_PACK_FIELD(kind, type, name) MESSAGE_PACK_##kind(writer, type, message->name);
+#define MESSAGE_UNPACK_FIELD(kind, type, name) MESSAGE_UNPACK_##kind(reader, type, message->name);
+
+/** How many fields a message has. */
+#define MESSAGE_FIELD_COUNT(FIELDS) (0 FIELDS(MESSAGE_COUNT_FIELD))
+
+/**
+ * Declare message `name`'s struct (`name`_t) and serializers. Packing returns false (and sets
+ * writer->error) if the message didn't all fit, and unpacking returns false (and sets
+ * reader->error) if the payload isn't one.
+ */
+#define MESSAGE_DECLARE(name, FIELDS) \
+    typedef struct { \
+        FIELDS(MESSAGE_STRUCT_FIELD) \
+    } name##_t; \
+    bool name##_pack(const name##_t *message, msgpack_writer_t *writer); \
+    bool name##_unpack(name##_t *message, msgpack_reader_t *reader);
+
+/**
+ * Define message `name`'s serializers. Unpacking takes fields it doesn't know about (a newer
+ * sender's, added at the end) and skips them, but refuses a message that's missing any.
+ */
+#define MESSAGE_DEFINE(name, FIELDS) \
+    bool name##_pack(const name##_t *message, msgpack_writer_t *writer) \
+    { \
+        msgpack_write_array(writer, MESSAGE_FIELD_COUNT(FIELDS)); \
+        FIELDS(MESSAGE_PACK_FIELD) \
+        return msgpack_writer_ok(writer); \
+    } \
+    bool name##_unpack(name##_t *message, msgpack_reader_t *reader) \
+    { \
+        uint32_t count = 0; \
+        if (msgpack_read_array(reader, &count) && (count < MESSAGE_FIELD_COUNT(FIELDS))) \
+        { \
+            reader->error = true; \
+        } \
+        FIELDS(MESSAGE_UNPACK_FIELD) \
+        for (uint32_t i = MESSAGE_FIELD_COUNT(FIELDS); (i < count) && msgpack_reader_ok(reader); i++) \
+        { \
+            msgpack_skip(reader); \
+        } \
+        return msgpack_reader_ok(reader); \
+    }
+
+#ifdef __cplusplus
+}
+#endif
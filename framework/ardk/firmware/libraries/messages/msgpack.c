@@ -0,0 +1,561 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// Local includes
+#include "msgpack.h"
+
+/** The parts of an object's header that the readers need. */
+typedef struct {
+    msgpack_type_t type;
+    size_t header_len;      // Bytes of header, including the format byte
+    uint64_t value;         // UINT, or array/map count, or the bits of an INT or FLOAT
+    size_t body_len;        // Bytes after the header: STR, BIN, and EXT data, or a FLOAT's size
+} header_t;
+
+void msgpack_writer_init(msgpack_writer_t *writer, uint8_t *buffer, size_t cap)
+{
+    writer->buffer = buffer;
+    writer->cap = cap;
+    writer->len = 0;
+    writer->error = false;
+}
+
+/**
+ * Write a format byte, then `n` bytes of `value`, big-endian (MsgPack's byte order),
+ * if there's room for them and `extra` bytes after them.
+ */
+static bool put_header(msgpack_writer_t *writer, uint8_t format, uint64_t value, size_t n, size_t extra)
+{
+    if (writer->error || ((writer->cap - writer->len) < (1 + n)) || ((writer->cap - writer->len - 1 - n) < extra))
+    {
+        writer->error = true;
+        return false;
+    }
+
+    writer->buffer[writer->len] = format;
+    writer->len++;
+    for (size_t i = n; i > 0; i--)
+    {
+        writer->buffer[writer->len] = (uint8_t)(value >> (8 * (i - 1)));
+        writer->len++;
+    }
+    return true;
+}
+
+/**
+ * Write a header that has a length or count: the fix format if it fits, then 8, 16, or 32 bits.
+ * A format of 0 means there isn't one of that size.
+ */
+static bool put_sized_header(msgpack_writer_t *writer, uint8_t fix_format, uint32_t fix_max, uint8_t format8,
+                             uint8_t format16, uint8_t format32, uint64_t size, size_t extra)
+{
+    if (size > UINT32_MAX)
+    {
+        writer->error = true;
+        return false;
+    }
+    else if ((fix_format != 0) && (size <= fix_max))
+    {
+        return put_header(writer, (uint8_t)(fix_format | size), 0, 0, extra);
+    }
+    else if ((format8 != 0) && (size <= UINT8_MAX))
+    {
+        return put_header(writer, format8, size, 1, extra);
+    }
+    else if (size <= UINT16_MAX)
+    {
+        return put_header(writer, format16, size, 2, extra);
+    }
+    else
+    {
+        return put_header(writer, format32, size, 4, extra);
+    }
+}
+
+bool msgpack_write_nil(msgpack_writer_t *writer)
+{
+    return put_header(writer, 0xC0, 0, 0, 0);
+}
+
+bool msgpack_write_bool(msgpack_writer_t *writer, bool value)
+{
+    return put_header(writer, value ? 0xC3 : 0xC2, 0, 0, 0);
+}
+
+bool msgpack_write_uint(msgpack_writer_t *writer, uint64_t value)
+{
+    if (value <= 0x7F)
+    {
+        return put_header(writer, (uint8_t)value, 0, 0, 0);
+    }
+    else if (value <= UINT8_MAX)
+    {
+        return put_header(writer, 0xCC, value, 1, 0);
+    }
+    else if (value <= UINT16_MAX)
+    {
+        return put_header(writer, 0xCD, value, 2, 0);
+    }
+    else if (value <= UINT32_MAX)
+    {
+        return put_header(writer, 0xCE, value, 4, 0);
+    }
+    else
+    {
+        return put_header(writer, 0xCF, value, 8, 0);
+    }
+}
+
+bool msgpack_write_int(msgpack_writer_t *writer, int64_t value)
+{
+    if (value >= 0)
+    {
+        return msgpack_write_uint(writer, (uint64_t)value);
+    }
+    else if (value >= -32)
+    {
+        return put_header(writer, (uint8_t)value, 0, 0, 0);
+    }
+    else if (value >= INT8_MIN)
+    {
+        return put_header(writer, 0xD0, (uint64_t)value, 1, 0);
+    }
+    else if (value >= INT16_MIN)
+    {
+        return put_header(writer, 0xD1, (uint64_t)value, 2, 0);
+    }
+    else if (value >= INT32_MIN)
+    {
+        return put_header(writer, 0xD2, (uint64_t)value, 4, 0);
+    }
+    else
+    {
+        return put_header(writer, 0xD3, (uint64_t)value, 8, 0);
+    }
+}
+
+bool msgpack_write_float(msgpack_writer_t *writer, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_header(writer, 0xCA, bits, 4, 0);
+}
+
+bool msgpack_write_double(msgpack_writer_t *writer, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_header(writer, 0xCB, bits, 8, 0);
+}
+
+bool msgpack_write_str(msgpack_writer_t *writer, const char *str, size_t len)
+{
+    if (!put_sized_header(writer, 0xA0, 31, 0xD9, 0xDA, 0xDB, len, len))
+    {
+        return false;
+    }
+    memcpy(&writer->buffer[writer->len], str, len);
+    writer->len += len;
+    return true;
+}
+
+bool msgpack_write_bin(msgpack_writer_t *writer, const uint8_t *data, size_t len)
+{
+    if (!put_sized_header(writer, 0, 0, 0xC4, 0xC5, 0xC6, len, len))
+    {
+        return false;
+    }
+    memcpy(&writer->buffer[writer->len], data, len);
+    writer->len += len;
+    return true;
+}
+
+bool msgpack_write_array(msgpack_writer_t *writer, uint32_t count)
+{
+    return put_sized_header(writer, 0x90, 15, 0, 0xDC, 0xDD, count, 0);
+}
+
+bool msgpack_write_map(msgpack_writer_t *writer, uint32_t count)
+{
+    return put_sized_header(writer, 0x80, 15, 0, 0xDE, 0xDF, count, 0);
+}
+
+void msgpack_reader_init(msgpack_reader_t *reader, const uint8_t *buffer, size_t len)
+{
+    reader->buffer = buffer;
+    reader->len = len;
+    reader->pos = 0;
+    reader->error = false;
+}
+
+/** Read `n` big-endian bytes at `offset` past the reader's position. The caller checks they're there. */
+static uint64_t get_be(const msgpack_reader_t *reader, size_t offset, size_t n)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        value = (value << 8) | reader->buffer[reader->pos + offset + i];
+    }
+    return value;
+}
+
+/** Sign-extend the low `n` bytes of `value`. */
+static int64_t sign_extend(uint64_t value, size_t n)
+{
+    const unsigned shift = 64 - (8 * n);
+    return (int64_t)(value << shift) >> shift;
+}
+
+/**
+ * Work out what the next object is, and check that its header (and, for strings, binary, and
+ * extensions, its data) is all there. Doesn't move the reader.
+ */
+static bool parse(const msgpack_reader_t *reader, header_t *header)
+{
+    if (reader->error || (reader->pos >= reader->len))
+    {
+        return false;
+    }
+
+    const uint8_t format = reader->buffer[reader->pos];
+    const size_t remaining = reader->len - reader->pos - 1;
+    size_t n = 0;           // Bytes of value after the format byte
+    size_t length_n = 0;    // Of those, how many are a length that counts the data after the header
+    size_t fixed_body = 0;  // Bytes of data after the header that aren't counted by a length
+    header->value = 0;
+    header->body_len = 0;
+
+    if (format <= 0x7F)
+    {
+        header->type = MSGPACK_TYPE_UINT;
+        header->value = format;
+    }
+    else if (format <= 0x8F)
+    {
+        header->type = MSGPACK_TYPE_MAP;
+        header->value = format & 0x0F;
+    }
+    else if (format <= 0x9F)
+    {
+        header->type = MSGPACK_TYPE_ARRAY;
+        header->value = format & 0x0F;
+    }
+    else if (format <= 0xBF)
+    {
+        header->type = MSGPACK_TYPE_STR;
+        header->body_len = format & 0x1F;
+    }
+    else if (format >= 0xE0)
+    {
+        header->type = MSGPACK_TYPE_INT;
+        header->value = (uint64_t)(int64_t)(int8_t)format;
+    }
+    else
+    {
+        switch (format)
+        {
+        case 0xC0:
+            header->type = MSGPACK_TYPE_NIL;
+            break;
+        case 0xC2:
+        case 0xC3:
+            header->type = MSGPACK_TYPE_BOOL;
+            header->value = format & 0x01;
+            break;
+        case 0xC4: case 0xC5: case 0xC6:
+            header->type = MSGPACK_TYPE_BIN;
+            n = length_n = (size_t)1 << (format - 0xC4);
+            break;
+        case 0xC7: case 0xC8: case 0xC9:
+            // Length, then the extension's type byte
+            header->type = MSGPACK_TYPE_EXT;
+            length_n = (size_t)1 << (format - 0xC7);
+            n = length_n + 1;
+            break;
+        case 0xCA: case 0xCB:
+            header->type = MSGPACK_TYPE_FLOAT;
+            n = (size_t)4 << (format - 0xCA);
+            header->body_len = n;
+            break;
+        case 0xCC: case 0xCD: case 0xCE: case 0xCF:
+            header->type = MSGPACK_TYPE_UINT;
+            n = (size_t)1 << (format - 0xCC);
+            break;
+        case 0xD0: case 0xD1: case 0xD2: case 0xD3:
+            header->type = MSGPACK_TYPE_INT;
+            n = (size_t)1 << (format - 0xD0);
+            break;
+        case 0xD4: case 0xD5: case 0xD6: case 0xD7: case 0xD8:
+            // The extension's type byte, then 1 to 16 bytes of data
+            header->type = MSGPACK_TYPE_EXT;
+            n = 1;
+            fixed_body = (size_t)1 << (format - 0xD4);
+            break;
+        case 0xD9: case 0xDA: case 0xDB:
+            header->type = MSGPACK_TYPE_STR;
+            n = length_n = (size_t)1 << (format - 0xD9);
+            break;
+        case 0xDC: case 0xDD:
+            header->type = MSGPACK_TYPE_ARRAY;
+            n = (size_t)2 << (format - 0xDC);
+            break;
+        case 0xDE: case 0xDF:
+            header->type = MSGPACK_TYPE_MAP;
+            n = (size_t)2 << (format - 0xDE);
+            break;
+        default:
+            // 0xC1 is never used
+            return false;
+        }
+    }
+
+    if (n > remaining)
+    {
+        return false;
+    }
+
+    if (length_n > 0)
+    {
+        header->body_len = (size_t)get_be(reader, 1, length_n);
+    }
+    else if (fixed_body > 0)
+    {
+        header->body_len = fixed_body;
+    }
+    else if (n > 0)
+    {
+        header->value = get_be(reader, 1, n);
+        if (header->type == MSGPACK_TYPE_INT)
+        {
+            const int64_t value = sign_extend(header->value, n);
+            header->value = (uint64_t)value;
+            if (value >= 0)
+            {
+                // Signed formats can hold non-negative values too
+                header->type = MSGPACK_TYPE_UINT;
+            }
+        }
+    }
+
+    if (header->type == MSGPACK_TYPE_FLOAT)
+    {
+        // The value bytes are the float itself
+        header->header_len = 1;
+    }
+    else
+    {
+        header->header_len = 1 + n;
+    }
+
+    // Strings, binary, and extensions have to be all there
+    if ((header->type != MSGPACK_TYPE_FLOAT) && (header->body_len > (remaining - n)))
+    {
+        return false;
+    }
+    return true;
+}
+
+/** Give up on the payload. */
+static bool fail(msgpack_reader_t *reader)
+{
+    reader->error = true;
+    return false;
+}
+
+/** Parse the next object and check it's of the type asked for. */
+static bool expect(msgpack_reader_t *reader, msgpack_type_t type, header_t *header)
+{
+    if (!parse(reader, header) || (header->type != type))
+    {
+        return fail(reader);
+    }
+    return true;
+}
+
+msgpack_type_t msgpack_peek_type(const msgpack_reader_t *reader)
+{
+    header_t header;
+    return parse(reader, &header) ? header.type : MSGPACK_TYPE_INVALID;
+}
+
+bool msgpack_read_nil(msgpack_reader_t *reader)
+{
+    header_t header;
+    if (!expect(reader, MSGPACK_TYPE_NIL, &header))
+    {
+        return false;
+    }
+    reader->pos += header.header_len;
+    return true;
+}
+
+bool msgpack_read_bool(msgpack_reader_t *reader, bool *value)
+{
+    header_t header;
+    if (!expect(reader, MSGPACK_TYPE_BOOL, &header))
+    {
+        return false;
+    }
+    *value = (header.value != 0);
+    reader->pos += header.header_len;
+    return true;
+}
+
+bool msgpack_read_uint(msgpack_reader_t *reader, uint64_t *value)
+{
+    header_t header;
+    if (!expect(reader, MSGPACK_TYPE_UINT, &header))
+    {
+        return false;
+    }
+    *value = header.value;
+    reader->pos += header.header_len;
+    return true;
+}
+
+bool msgpack_read_int(msgpack_reader_t *reader, int64_t *value)
+{
+    header_t header;
+    if (!parse(reader, &header))
+    {
+        return fail(reader);
+    }
+
+    if ((header.type == MSGPACK_TYPE_INT) || ((header.type == MSGPACK_TYPE_UINT) && (header.value <= INT64_MAX)))
+    {
+        *value = (int64_t)header.value;
+        reader->pos += header.header_len;
+        return true;
+    }
+    return fail(reader);
+}
+
+bool msgpack_read_double(msgpack_reader_t *reader, double *value)
+{
+    header_t header;
+    if (!parse(reader, &header))
+    {
+        return fail(reader);
+    }
+
+    switch (header.type)
+    {
+    case MSGPACK_TYPE_FLOAT:
+        if (header.body_len == 4)
+        {
+            const uint32_t bits = (uint32_t)get_be(reader, 1, 4);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            *value = f;
+        }
+        else
+        {
+            const uint64_t bits = get_be(reader, 1, 8);
+            memcpy(value, &bits, sizeof(*value));
+        }
+        reader->pos += header.header_len + header.body_len;
+        return true;
+    case MSGPACK_TYPE_UINT:
+        *value = (double)header.value;
+        reader->pos += header.header_len;
+        return true;
+    case MSGPACK_TYPE_INT:
+        *value = (double)(int64_t)header.value;
+        reader->pos += header.header_len;
+        return true;
+    default:
+        return fail(reader);
+    }
+}
+
+bool msgpack_read_float(msgpack_reader_t *reader, float *value)
+{
+    double d;
+    if (!msgpack_read_double(reader, &d))
+    {
+        return false;
+    }
+    *value = (float)d;
+    return true;
+}
+
+/** Read the next string or binary object's header and point at its data. */
+static bool read_bytes(msgpack_reader_t *reader, msgpack_type_t type, const uint8_t **data, size_t *len)
+{
+    header_t header;
+    if (!expect(reader, type, &header))
+    {
+        return false;
+    }
+    *data = &reader->buffer[reader->pos + header.header_len];
+    *len = header.body_len;
+    reader->pos += header.header_len + header.body_len;
+    return true;
+}
+
+bool msgpack_read_str(msgpack_reader_t *reader, const char **str, size_t *len)
+{
+    const uint8_t *data;
+    if (!read_bytes(reader, MSGPACK_TYPE_STR, &data, len))
+    {
+        return false;
+    }
+    *str = (const char *)data;
+    return true;
+}
+
+bool msgpack_read_bin(msgpack_reader_t *reader, const uint8_t **data, size_t *len)
+{
+    return read_bytes(reader, MSGPACK_TYPE_BIN, data, len);
+}
+
+bool msgpack_read_array(msgpack_reader_t *reader, uint32_t *count)
+{
+    header_t header;
+    if (!expect(reader, MSGPACK_TYPE_ARRAY, &header))
+    {
+        return false;
+    }
+    *count = (uint32_t)header.value;
+    reader->pos += header.header_len;
+    return true;
+}
+
+bool msgpack_read_map(msgpack_reader_t *reader, uint32_t *count)
+{
+    header_t header;
+    if (!expect(reader, MSGPACK_TYPE_MAP, &header))
+    {
+        return false;
+    }
+    *count = (uint32_t)header.value;
+    reader->pos += header.header_len;
+    return true;
+}
+
+bool msgpack_skip(msgpack_reader_t *reader)
+{
+    // Objects still to skip. Every object is at least a byte, so this can't outrun the payload.
+    uint64_t pending = 1;
+    while (pending > 0)
+    {
+        header_t header;
+        if (!parse(reader, &header))
+        {
+            return fail(reader);
+        }
+        pending--;
+        reader->pos += header.header_len + header.body_len;
+
+        if (header.type == MSGPACK_TYPE_ARRAY)
+        {
+            pending += header.value;
+        }
+        else if (header.type == MSGPACK_TYPE_MAP)
+        {
+            pending += 2 * header.value;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file msgpack.h
+ * @brief MsgPack writer and reader over caller buffers. Nothing is allocated: the
+ * writer packs into the caller's buffer, and the reader hands out strings and binary
+ * data as pointers into the buffer it reads. Both stop at the first error (a full
+ * buffer, or bytes that aren't what was asked for) and stay stopped, so a run of
+ * writes or reads only has to be checked once, at the end.
+ *
+ * See docs/specifications/MsgPackSchema.md, and message.h for generating struct
+ * serializers from a list of fields.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Where a MsgPack payload is being written. */
+typedef struct {
+    uint8_t *buffer;        ///< The caller's buffer
+    size_t cap;             ///< Its size
+    size_t len;             ///< Bytes written so far
+    bool error;             ///< Did a write not fit? Nothing more gets written once it's set.
+} msgpack_writer_t;
+
+/** Where a MsgPack payload is being read from. */
+typedef struct {
+    const uint8_t *buffer;  ///< The payload
+    size_t len;             ///< Its length
+    size_t pos;             ///< Next byte to read
+    bool error;             ///< Was something not what was asked for? Nothing more gets read once it's set.
+} msgpack_reader_t;
+
+/** The kinds of MsgPack object. */
+typedef enum {
+    MSGPACK_TYPE_NIL = 0,
+    MSGPACK_TYPE_BOOL,
+    MSGPACK_TYPE_UINT,      ///< A non-negative integer (in any of MsgPack's integer formats)
+    MSGPACK_TYPE_INT,       ///< A negative integer
+    MSGPACK_TYPE_FLOAT,     ///< float 32 or float 64
+    MSGPACK_TYPE_STR,
+    MSGPACK_TYPE_BIN,
+    MSGPACK_TYPE_ARRAY,
+    MSGPACK_TYPE_MAP,
+    MSGPACK_TYPE_EXT,       ///< Extension types, which we don't use, but can skip
+    MSGPACK_TYPE_INVALID,   ///< 0xC1, which MsgPack never uses, or the end of the payload
+} msgpack_type_t;
+
+/** Start writing into `cap` bytes of `buffer`. */
+void msgpack_writer_init(msgpack_writer_t *writer, uint8_t *buffer, size_t cap);
+
+/** Did everything written so far fit? */
+static inline bool msgpack_writer_ok(const msgpack_writer_t *writer)
+{
+    return !writer->error;
+}
+
+/*
+ * Each write uses the smallest format that holds its value, and returns false
+ * (and sets writer->error) if it didn't fit, or if an earlier write didn't.
+ */
+
+bool msgpack_write_nil(msgpack_writer_t *writer);
+bool msgpack_write_bool(msgpack_writer_t *writer, bool value);
+bool msgpack_write_uint(msgpack_writer_t *writer, uint64_t value);
+bool msgpack_write_int(msgpack_writer_t *writer, int64_t value);
+bool msgpack_write_float(msgpack_writer_t *writer, float value);
+bool msgpack_write_double(msgpack_writer_t *writer, double value);
+bool msgpack_write_str(msgpack_writer_t *writer, const char *str, size_t len);
+bool msgpack_write_bin(msgpack_writer_t *writer, const uint8_t *data, size_t len);
+
+/** Start an array of `count` objects. Write them next. */
+bool msgpack_write_array(msgpack_writer_t *writer, uint32_t count);
+
+/** Start a map of `count` key/value pairs. Write them next, key then value. */
+bool msgpack_write_map(msgpack_writer_t *writer, uint32_t count);
+
+/** Start reading `len` bytes of `buffer`. */
+void msgpack_reader_init(msgpack_reader_t *reader, const uint8_t *buffer, size_t len);
+
+/** Has everything read so far been what was asked for? */
+static inline bool msgpack_reader_ok(const msgpack_reader_t *reader)
+{
+    return !reader->error;
+}
+
+/** Has the whole payload been read? */
+static inline bool msgpack_reader_done(const msgpack_reader_t *reader)
+{
+    return reader->pos >= reader->len;
+}
+
+/** What kind of object is next, without reading it. */
+msgpack_type_t msgpack_peek_type(const msgpack_reader_t *reader);
+
+/*
+ * Each read returns false (and sets reader->error) if the next object isn't of the
+ * kind asked for, doesn't fit the type it is read into, or runs past the end of the
+ * payload, or if an earlier read failed. Nothing is read in that case.
+ */
+
+bool msgpack_read_nil(msgpack_reader_t *reader);
+bool msgpack_read_bool(msgpack_reader_t *reader, bool *value);
+
+/** Reads any integer format, as long as the value isn't negative. */
+bool msgpack_read_uint(msgpack_reader_t *reader, uint64_t *value);
+
+/** Reads any integer format, as long as the value fits in an int64_t. */
+bool msgpack_read_int(msgpack_reader_t *reader, int64_t *value);
+
+/** Reads a float 32 or a float 64 (losing precision), or any integer. */
+bool msgpack_read_float(msgpack_reader_t *reader, float *value);
+
+/** Reads a float 32 or a float 64, or any integer. */
+bool msgpack_read_double(msgpack_reader_t *reader, double *value);
+
+/** Points `str` at the string in the payload. It isn't NUL-terminated. */
+bool msgpack_read_str(msgpack_reader_t *reader, const char **str, size_t *len);
+
+/** Points `data` at the binary data in the payload. */
+bool msgpack_read_bin(msgpack_reader_t *reader, const uint8_t **data, size_t *len);
+
+/** Reads the start of an array. Its `count` objects come next. */
+bool msgpack_read_array(msgpack_reader_t *reader, uint32_t *count);
+
+/** Reads the start of a map. Its `count` key/value pairs come next. */
+bool msgpack_read_map(msgpack_reader_t *reader, uint32_t *count);
+
+/**
+ * @brief Skip the next object, whatever it is, including everything in it if it's an array or map.
+ * Doesn't recurse, so nesting doesn't use up the stack.
+ */
+bool msgpack_skip(msgpack_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
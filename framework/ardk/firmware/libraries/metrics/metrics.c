@@ -0,0 +1,164 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+// Local includes
+#include "metrics.h"
+
+/**
+ * Guards the current window against the other core. A striped lock, like the errors library's,
+ * since it needs neither claiming nor initializing and is only held for a few lines.
+ */
+#define METRICS_LOCK spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST + 2)
+
+/** A core's idle time in the current window. */
+typedef struct {
+    uint32_t idle_us;       // Idle spans that have ended (or been cut at a window's close)
+    uint32_t idle_since;    // time_us_32() when the span in progress began, if idle
+    bool idle;
+} core_idle_t;
+
+/** A timing's samples in the current window. */
+typedef struct {
+    uint32_t total_us;
+    uint32_t samples;
+    uint32_t longest_us;
+} timing_t;
+
+/** The current window. */
+static core_idle_t cores[NUM_CORES];
+static uint32_t counts[METRICS_NUM_COUNTS];
+static timing_t timings[METRICS_NUM_TIMINGS];
+static uint32_t levels[METRICS_NUM_LEVELS];
+static uint32_t window_start_us = 0;
+
+/** The last window that closed, packed. Only core 0's main loop touches it. */
+static uint8_t packed[METRICS_PACKED_LEN];
+
+void metrics_idle_begin(void)
+{
+    const uint32_t now = time_us_32();
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    core_idle_t *const core = &cores[get_core_num()];
+    core->idle_since = now;
+    core->idle = true;
+    spin_unlock(METRICS_LOCK, saved);
+}
+
+void metrics_idle_end(void)
+{
+    const uint32_t now = time_us_32();
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    core_idle_t *const core = &cores[get_core_num()];
+    if (core->idle)
+    {
+        core->idle_us += now - core->idle_since;
+        core->idle = false;
+    }
+    spin_unlock(METRICS_LOCK, saved);
+}
+
+void metrics_count(metrics_count_t id, uint32_t n)
+{
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    counts[id] += n;
+    spin_unlock(METRICS_LOCK, saved);
+}
+
+void metrics_timing(metrics_timing_t id, uint32_t us)
+{
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    timing_t *const timing = &timings[id];
+    timing->total_us += us;
+    timing->samples++;
+    timing->longest_us = (us > timing->longest_us) ? us : timing->longest_us;
+    spin_unlock(METRICS_LOCK, saved);
+}
+
+void metrics_level(metrics_level_t id, uint32_t value)
+{
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    levels[id] = (value > levels[id]) ? value : levels[id];
+    spin_unlock(METRICS_LOCK, saved);
+}
+
+static uint8_t *pack_u16(uint8_t *out, uint64_t value)
+{
+    const uint16_t saturated = (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+    out[0] = (uint8_t)(saturated & 0xFF);
+    out[1] = (uint8_t)(saturated >> 8);
+    return out + 2;
+}
+
+bool metrics_update(void)
+{
+    const uint32_t now = time_us_32();
+    const uint32_t window_us = now - window_start_us;
+    if (window_us < (METRICS_WINDOW_MS * 1000u))
+    {
+        return false;
+    }
+
+    // Take the window and start the next, then work the figures out without the lock
+    uint32_t idle_us[NUM_CORES];
+    uint32_t window_counts[METRICS_NUM_COUNTS];
+    timing_t window_timings[METRICS_NUM_TIMINGS];
+    uint32_t window_levels[METRICS_NUM_LEVELS];
+    const uint32_t saved = spin_lock_blocking(METRICS_LOCK);
+    for (uint i = 0; i < NUM_CORES; i++)
+    {
+        core_idle_t *const core = &cores[i];
+        idle_us[i] = core->idle_us;
+        if (core->idle)
+        {
+            // Cut the span in progress at the window's close
+            idle_us[i] += now - core->idle_since;
+            core->idle_since = now;
+        }
+        core->idle_us = 0;
+    }
+    memcpy(window_counts, counts, sizeof(counts));
+    memset(counts, 0, sizeof(counts));
+    memcpy(window_timings, timings, sizeof(timings));
+    memset(timings, 0, sizeof(timings));
+    memcpy(window_levels, levels, sizeof(levels));
+    memset(levels, 0, sizeof(levels));
+    window_start_us = now;
+    spin_unlock(METRICS_LOCK, saved);
+
+    uint8_t *out = pack_u16(packed, window_us / 1000);
+    for (uint i = 0; i < NUM_CORES; i++)
+    {
+        const uint32_t idle = (idle_us[i] > window_us) ? window_us : idle_us[i];
+        out = pack_u16(out, ((uint64_t)(window_us - idle) * 1000) / window_us);
+    }
+    for (uint i = 0; i < METRICS_NUM_COUNTS; i++)
+    {
+        out = pack_u16(out, ((uint64_t)window_counts[i] * 1000000) / window_us);
+    }
+    for (uint i = 0; i < METRICS_NUM_TIMINGS; i++)
+    {
+        const timing_t *const timing = &window_timings[i];
+        out = pack_u16(out, (timing->samples > 0) ? (timing->total_us / timing->samples) : 0);
+        out = pack_u16(out, timing->longest_us);
+    }
+    for (uint i = 0; i < METRICS_NUM_LEVELS; i++)
+    {
+        out = pack_u16(out, window_levels[i]);
+    }
+    return true;
+}
+
+size_t metrics_pack(uint8_t *buf, size_t len)
+{
+    if (len < sizeof(packed))
+    {
+        return 0;
+    }
+    memcpy(buf, packed, sizeof(packed));
+    return sizeof(packed);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file metrics.h
+ * @brief Metrics module.
+ * Keeps how busy each core is, counts and times of the firmware's main jobs, and how full its queues get, over
+ * windows of METRICS_WINDOW_MS, so the controller can see how close the MCU is to full.
+ * Unlike tracing, always on: each call costs a timer read and a spin lock.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef METRICS_WINDOW_MS
+    /** How long each window of metrics is, at least. A window closes at the first metrics_update() after this. */
+    #define METRICS_WINDOW_MS 1000
+#endif // METRICS_WINDOW_MS
+
+/** Things counted. Reported per second. */
+typedef enum {
+    METRICS_COUNT_COMMANDS = 0,     ///< Commands dispatched, from the controller or a sequence
+    METRICS_COUNT_FRAMES,           ///< Frames rendered by the graphics core
+    METRICS_COUNT_DROPS,            ///< Commands (or writes of them) turned away because a queue was full
+    METRICS_NUM_COUNTS
+} metrics_count_t;
+
+/** Things timed. Reported as their average and longest. */
+typedef enum {
+    METRICS_TIMING_LCD_FLUSH = 0,   ///< Sending a frame (or a band of one) to the LCD, until the transfer has started
+    METRICS_NUM_TIMINGS
+} metrics_timing_t;
+
+/** Things sampled. Reported as the highest sample. */
+typedef enum {
+    METRICS_LEVEL_CMD_QUEUE = 0,    ///< Bytes in the command queue (the cmds library's)
+    METRICS_LEVEL_GFX_QUEUE,        ///< Work items waiting for the graphics core
+    METRICS_NUM_LEVELS
+} metrics_level_t;
+
+/**
+ * Size of what metrics_pack() writes. Layout, all little-endian: the window's length in ms (2 bytes),
+ * each core's busy time in tenths of a percent (2 bytes each), each count per second (2 bytes each,
+ * in metrics_count_t order), each timing's average and longest in us (2 + 2 bytes each, in
+ * metrics_timing_t order), then each level's highest sample (2 bytes each, in metrics_level_t order).
+ * Everything saturates at 0xFFFF.
+ */
+#define METRICS_PACKED_LEN (2 + (2 * 2) + (2 * METRICS_NUM_COUNTS) + (4 * METRICS_NUM_TIMINGS) + (2 * METRICS_NUM_LEVELS))
+
+/**
+ * @brief The calling core is about to wait for work (sleep, or block on a queue or interrupt).
+ * Everything until metrics_idle_end() counts as idle.
+ */
+void metrics_idle_begin(void);
+
+/** The calling core has work again. */
+void metrics_idle_end(void);
+
+/** Add n to a count. Safe from either core. */
+void metrics_count(metrics_count_t id, uint32_t n);
+
+/** Record how long something took, in us. Safe from either core. */
+void metrics_timing(metrics_timing_t id, uint32_t us);
+
+/** Sample a level: how full a queue is right now, say. Safe from either core. */
+void metrics_level(metrics_level_t id, uint32_t value);
+
+/**
+ * @brief Close the window if it's been METRICS_WINDOW_MS, and start the next. Call from the main loop.
+ *
+ * @return true if a window closed, so metrics_pack() has new figures.
+ */
+bool metrics_update(void);
+
+/**
+ * @brief Pack the figures of the last window that closed (all zero before the first).
+ * See METRICS_PACKED_LEN for the layout.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least METRICS_PACKED_LEN, or nothing is written.
+ * @return size_t Number of bytes written.
+ */
+size_t metrics_pack(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,144 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "pico/time.h"
+// Library includes
+#include <bytestuff.h>
+#include <errors.h>
+#include <hotpaths.h>
+#include <rtacp.h>
+// Local includes
+#include "psacp.h"
+
+#if PSACP_MAX_PAYLOAD_LEN > BYTESTUFF_MAX_RUN
+    #error "PSACP_MAX_PAYLOAD_LEN must fit between two special bytes"
+#endif
+
+/** Frame types */
+#define TYPE_PUB            0x1
+#define TYPE_DATA           0x3
+
+/** After the shared fields (see RTACP_ID_SENDER_SHIFT), PSACP has the topic (8 bits), then six 1s. */
+#define ID_TOPIC_SHIFT      6
+#define ID_SUFFIX           0x3F
+
+/** Publishes dropped for a full queue. Not locked: it may miss one if both cores drop at once. */
+static volatile uint32_t dropped = 0;
+
+/** Error records in one publish, after the missed count. */
+#define ERRORS_PER_PUBLISH ((PSACP_MAX_PAYLOAD_LEN - 1) / PSACP_ERROR_RECORD_LEN)
+
+/** When errors may next be published. */
+static absolute_time_t errors_not_before;
+
+static inline uint32_t make_id(uint8_t type, psacp_band_t band, rtacp_priority_t priority, uint8_t topic)
+{
+    const uint32_t protocol = (band == PSACP_BAND_HIGH) ? RTACP_PROTOCOL_PSACP_HIGH : RTACP_PROTOCOL_PSACP_LOW;
+    return (protocol << RTACP_ID_PROTOCOL_SHIFT) |
+           ((uint32_t)type << RTACP_ID_TYPE_SHIFT) |
+           ((uint32_t)priority << RTACP_ID_PRIORITY_SHIFT) |
+           ((uint32_t)rtacp_get_address() << RTACP_ID_SENDER_SHIFT) |
+           ((uint32_t)topic << ID_TOPIC_SHIFT) |
+           ID_SUFFIX;
+}
+
+bool HOT_FUNC(psacp_publish)(uint8_t topic, psacp_band_t band, rtacp_priority_t priority, const uint8_t *data, size_t len)
+{
+    const bool topic_ok = (topic == PSACP_TOPIC_BROADCAST) || ((topic >= PSACP_TOPIC_FIRST) && (topic <= PSACP_TOPIC_LAST));
+    if (!topic_ok || (len > PSACP_MAX_PAYLOAD_LEN) || (priority >= RTACP_NUM_PRIORITIES))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return false;
+    }
+
+    // Stuff straight into the frames, after the PUB frame's CRC, which goes in last
+    mcp2515_frame_t frames[RTACP_TX_QUEUE_LEN];
+    bytestuff_encoder_t encoder;
+    bytestuff_encoder_init(&encoder, data, len);
+    uint16_t crc = CRC16_INIT;
+    size_t nframes = 0;
+    uint8_t n = PSACP_CRC_LEN;
+    uint8_t byte;
+    while (bytestuff_encoder_next(&encoder, &byte))
+    {
+        if (n == RTACP_MAX_DATA_LEN)
+        {
+            frames[nframes].len = n;
+            nframes++;
+            n = 0;
+        }
+        frames[nframes].data[n++] = byte;
+        crc = crc16_update(crc, byte);
+    }
+    frames[nframes].len = n;
+    nframes++;
+
+    for (size_t i = 0; i < nframes; i++)
+    {
+        frames[i].id = make_id((i == 0) ? TYPE_PUB : TYPE_DATA, band, priority, topic);
+    }
+    frames[0].data[0] = (uint8_t)(crc & 0xFF);
+    frames[0].data[1] = (uint8_t)(crc >> 8);
+
+    if (!rtacp_send_frames(frames, nframes))
+    {
+        // No ACKs in PSACP: missed data is simply lost
+        dropped++;
+        return false;
+    }
+    return true;
+}
+
+uint32_t psacp_get_dropped(void)
+{
+    return dropped;
+}
+
+size_t psacp_publish_errors(uint32_t *cursor)
+{
+    if (!time_reached(errors_not_before))
+    {
+        return 0;
+    }
+
+    // Read ahead on a copy, and only move the caller's cursor on once the publish has gone
+    uint32_t next = *cursor;
+    err_record_t record;
+    uint32_t missed;
+    uint8_t payload[1 + (ERRORS_PER_PUBLISH * PSACP_ERROR_RECORD_LEN)];
+    size_t nrecords = 0;
+    size_t pos = 1;
+    uint32_t total_missed = 0;
+    while ((nrecords < ERRORS_PER_PUBLISH) && errors_get_next(&next, &record, &missed))
+    {
+        total_missed += missed;
+        const uint32_t count = errors_get_count((err_module_id_t)(record.code & 0xFF00));
+        const uint16_t saturated = (count > 0xFFFF) ? 0xFFFF : (uint16_t)count;
+        payload[pos++] = (uint8_t)(record.timestamp_us & 0xFF);
+        payload[pos++] = (uint8_t)((record.timestamp_us >> 8) & 0xFF);
+        payload[pos++] = (uint8_t)((record.timestamp_us >> 16) & 0xFF);
+        payload[pos++] = (uint8_t)((record.timestamp_us >> 24) & 0xFF);
+        payload[pos++] = (uint8_t)(record.code & 0xFF);
+        payload[pos++] = (uint8_t)(record.code >> 8);
+        payload[pos++] = record.core;
+        payload[pos++] = (uint8_t)(saturated & 0xFF);
+        payload[pos++] = (uint8_t)(saturated >> 8);
+        nrecords++;
+    }
+    if (nrecords == 0)
+    {
+        return 0;
+    }
+    payload[0] = (total_missed > 0xFF) ? 0xFF : (uint8_t)total_missed;
+
+    // A full queue isn't an error of its own (that would only feed this): just try again next time
+    if (!psacp_publish(PSACP_TOPIC_ERRORS, PSACP_BAND_HIGH, RTACP_PRIORITY_MED_HIGH, payload, pos))
+    {
+        return 0;
+    }
+    *cursor = next;
+    errors_not_before = make_timeout_time_ms(PSACP_ERRORS_MIN_INTERVAL_MS);
+    return nrecords;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file psacp.h
+ * @brief Pub/Sub Artie CAN Protocol (PSACP) module, for publishers.
+ * A publish is stuffed, checksummed, and split into a PUB frame and DATA frames
+ * in one go, then queued all at once, so it's safe from interrupts. There are no
+ * ACKs: a publish that doesn't fit in the queue is dropped, and counted.
+ *
+ * Needs the rtacp module, which owns the CAN controller, started first.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <bytestuff.h>
+#include <rtacp.h>
+
+/** Topic that goes to every subscriber. */
+#define PSACP_TOPIC_BROADCAST 0x00
+
+/** The usable topic space. The rest is reserved. */
+#define PSACP_TOPIC_FIRST 0x0B
+#define PSACP_TOPIC_LAST 0xF4
+
+/**
+ * Topic every MCU publishes its errors to (see psacp_publish_errors()), at the top of the usable
+ * space, clear of the topics each firmware numbers up from PSACP_TOPIC_FIRST.
+ */
+#define PSACP_TOPIC_ERRORS PSACP_TOPIC_LAST
+
+/** Size of each record psacp_publish_errors() publishes, after the one-byte missed count. */
+#define PSACP_ERROR_RECORD_LEN 9
+
+#ifndef PSACP_ERRORS_MIN_INTERVAL_MS
+    /**
+     * Least time between error publishes, so a burst of errors can't take over the bus. Whatever
+     * comes in meanwhile waits in the error history, and what falls out of it is counted as missed.
+     */
+    #define PSACP_ERRORS_MIN_INTERVAL_MS 10
+#endif // PSACP_ERRORS_MIN_INTERVAL_MS
+
+/** Bytes of CRC16 at the start of a PUB frame's data. */
+#define PSACP_CRC_LEN 2
+
+/** How many frames publishing `len` bytes takes. */
+#define PSACP_FRAMES_FOR(len) ((PSACP_CRC_LEN + BYTESTUFF_STUFFED_LEN(len) + RTACP_MAX_DATA_LEN - 1) / RTACP_MAX_DATA_LEN)
+
+/**
+ * The most bytes one publish can carry: they have to fit in a priority's queue at once,
+ * after the CRC16 and the two special bytes around them.
+ */
+#define PSACP_MAX_PAYLOAD_LEN ((RTACP_TX_QUEUE_LEN * RTACP_MAX_DATA_LEN) - PSACP_CRC_LEN - 2)
+
+/**
+ * Which half of the CAN priority space a topic is in. The high half wins arbitration over
+ * block writes (BWACP), and the low half loses to them, so logging doesn't slow down firmware updates.
+ */
+typedef enum {
+    PSACP_BAND_HIGH = 0,    ///< Protocol 0b100
+    PSACP_BAND_LOW,         ///< Protocol 0b110
+} psacp_band_t;
+
+/**
+ * @brief Publish to a topic. Safe from either core and from IRQs. Doesn't block.
+ *
+ * @param topic PSACP_TOPIC_BROADCAST, or PSACP_TOPIC_FIRST to PSACP_TOPIC_LAST.
+ * @param band The topic's half of the priority space.
+ * @param priority Its priority within that half.
+ * @param data What to publish.
+ * @param len How many bytes, up to PSACP_MAX_PAYLOAD_LEN. PSACP_FRAMES_FOR() says
+ *            how many frames that takes, so batches can be sized to fill them.
+ * @return false if it was dropped because that priority's queue was full (see psacp_get_dropped()),
+ *         or (and sets errno) if the topic or length is out of range.
+ */
+bool psacp_publish(uint8_t topic, psacp_band_t band, rtacp_priority_t priority, const uint8_t *data, size_t len);
+
+/**
+ * @brief Publish the errors set since the last call to PSACP_TOPIC_ERRORS, at high priority, so the
+ * controller hears about them as they happen rather than when it next polls. Call from the main
+ * loop, with its own cursor into the error history (see errors_get_next()), starting at 0.
+ *
+ * Each publish is the number of errors that fell out of the history before they could be published
+ * (1 byte, saturating), then as many records as fit, oldest first, each as timestamp_us (4 bytes),
+ * code (2 bytes, err_module_id_t | err_t), core (1 byte), and the module's count since boot
+ * (2 bytes, saturating; see errors_get_count()), all little-endian. The sender's address is in
+ * the frames' IDs. Publishes at most every PSACP_ERRORS_MIN_INTERVAL_MS, and a publish that
+ * doesn't fit in the queue is tried again on the next call; neither loses any errors.
+ *
+ * @param cursor Where we're up to in the error history. Advanced past whatever was published.
+ * @return How many errors were published.
+ */
+size_t psacp_publish_errors(uint32_t *cursor);
+
+/** How many publishes have been dropped for a full queue since boot. */
+uint32_t psacp_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
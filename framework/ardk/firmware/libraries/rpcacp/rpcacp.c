@@ -0,0 +1,505 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <bytestuff.h>
+#include <errors.h>
+#include <hotpaths.h>
+#include <rtacp.h>
+// Local includes
+#include "rpcacp.h"
+
+/** Frame types */
+#define TYPE_ACK            0x0
+#define TYPE_NACK           0x1
+#define TYPE_START_RPC      0x2
+#define TYPE_START_RETURN   0x3
+#define TYPE_TX_DATA        0x4
+#define TYPE_RX_DATA        0x5
+
+/**
+ * After the shared fields (see RTACP_ID_SENDER_SHIFT), RPCACP has the target address (6 bits),
+ * then a random value (8 bits) the requester picks for each request. Every frame of that call carries it.
+ */
+#define ID_TARGET_SHIFT     8
+#define ID_TAG_MASK         0xFF
+
+/** First byte of a StartRPC or StartReturn frame: the synchronous bit and the procedure ID. Then the CRC16, little-endian. */
+#define HEADER_SYNCHRONOUS  0x80
+#define START_HEADER_LEN    3
+
+/** NACK code for a request that didn't arrive intact. Send it again. */
+#define NACK_RESEND         0x00
+
+/** Where a buffer is in a call's life. */
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_RECEIVING,     // The request's frames are arriving (CAN interrupt)
+    SLOT_QUEUED,        // The whole request is in, waiting for rpcacp_process()
+    SLOT_RUNNING,       // Its procedure is running, or pending
+    SLOT_RETURNING,     // Its return value is going out (rpcacp_process())
+} slot_state_t;
+
+/** One call and the buffer it lives in. */
+typedef struct {
+    rpcacp_call_t call;             // First, so procedures can hand it back to rpcacp_complete()
+    slot_state_t state;
+    uint8_t tag;                    // The requester's random value for this call
+    rtacp_priority_t priority;      // The request's priority, which the replies get too
+    uint32_t sequence;              // When it was queued, relative to the others, so the oldest runs first
+    uint32_t started_us;            // When its StartRPC frame arrived
+    uint16_t crc;                   // CRC16 of the request so far (then of the return value, while returning)
+    uint16_t request_crc;           // The CRC16 the requester sent. Identifies repeats of the request.
+    bool too_big;                   // Did the arguments overflow the buffer?
+    bool start_sent;                // While returning: has the StartReturn frame gone out?
+    bytestuff_decoder_t decoder;    // While receiving
+    bytestuff_encoder_t encoder;    // While returning
+    uint8_t buffer[RPCACP_BUFFER_LEN];
+} slot_t;
+
+/** The buffer pool. Slot states are guarded by rpcacp_lock; a slot's contents belong to whoever moved it to its state. */
+static slot_t slots[RPCACP_NUM_BUFFERS];
+
+/** The registration table. Filled in before requests arrive, so the CAN interrupt reads it without the lock. */
+static struct {
+    uint8_t id;
+    rpcacp_procedure_t function;
+} procedures[RPCACP_MAX_PROCEDURES];
+
+/** How many procedures are registered. */
+static size_t nprocedures = 0;
+
+/** Sequence number of the next call to be queued. */
+static uint32_t next_sequence = 0;
+
+/** Guards the slot states against the CAN interrupt and the other core. NULL until rpcacp_init(). */
+static spin_lock_t *rpcacp_lock = NULL;
+
+static inline uint32_t make_id(uint8_t type, rtacp_priority_t priority, uint8_t target, uint8_t tag)
+{
+    return ((uint32_t)RTACP_PROTOCOL_RPCACP << RTACP_ID_PROTOCOL_SHIFT) |
+           ((uint32_t)type << RTACP_ID_TYPE_SHIFT) |
+           ((uint32_t)priority << RTACP_ID_PRIORITY_SHIFT) |
+           ((uint32_t)rtacp_get_address() << RTACP_ID_SENDER_SHIFT) |
+           ((uint32_t)(target & RTACP_MAX_ADDRESS) << ID_TARGET_SHIFT) |
+           tag;
+}
+
+static rpcacp_procedure_t HOT_FUNC(find_procedure)(uint8_t id)
+{
+    for (size_t i = 0; i < nprocedures; i++)
+    {
+        if (procedures[i].id == id)
+        {
+            return procedures[i].function;
+        }
+    }
+    return NULL;
+}
+
+/** Send an ACK (ack) or a NACK with `code` for the call. If the queue is full, the requester's timeout resends it. */
+static void HOT_FUNC(send_reply)(uint8_t requester, rtacp_priority_t priority, uint8_t tag, bool ack, uint8_t code)
+{
+    mcp2515_frame_t frame;
+    frame.id = make_id(ack ? TYPE_ACK : TYPE_NACK, priority, requester, tag);
+    frame.len = ack ? 0 : 1;
+    frame.data[0] = code;
+    rtacp_send_frames(&frame, 1);
+}
+
+/** Find the slot a request's frames are arriving in. Call with rpcacp_lock held. */
+static slot_t *HOT_FUNC(find_receiving)(uint8_t requester, uint8_t tag)
+{
+    for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+    {
+        slot_t *slot = &slots[i];
+        if ((slot->state == SLOT_RECEIVING) && (slot->call.requester == requester) && (slot->tag == tag))
+        {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/** Take a free slot for a new request. Call with rpcacp_lock held. */
+static slot_t *HOT_FUNC(take_free)(void)
+{
+    for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+    {
+        if (slots[i].state == SLOT_FREE)
+        {
+            slots[i].state = SLOT_RECEIVING;
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Unstuff request bytes into the slot's buffer. Returns true once the request has ended,
+ * with the stuffing corrupt (`*corrupt`) or not.
+ */
+static bool HOT_FUNC(feed_request)(slot_t *slot, const uint8_t *bytes, size_t len, bool *corrupt)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        slot->crc = crc16_update(slot->crc, bytes[i]);
+        switch (bytestuff_decoder_feed(&slot->decoder, bytes[i]))
+        {
+        case BYTESTUFF_BYTE_DATA:
+            if (slot->call.len < RPCACP_BUFFER_LEN)
+            {
+                slot->buffer[slot->call.len] = bytes[i];
+                slot->call.len++;
+            }
+            else
+            {
+                slot->too_big = true;
+            }
+            break;
+        case BYTESTUFF_BYTE_SPECIAL:
+            break;
+        case BYTESTUFF_BYTE_END:
+            // Anything after the final special byte is padding
+            return true;
+        case BYTESTUFF_BYTE_INVALID:
+        default:
+            *corrupt = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * A request has all arrived. Queue it, or free its slot and return the NACK code it gets.
+ * Call with rpcacp_lock held.
+ */
+static int HOT_FUNC(finish_request)(slot_t *slot, bool corrupt)
+{
+    int nack = -1;
+    if (corrupt || (slot->crc != slot->request_crc))
+    {
+        nack = NACK_RESEND;
+    }
+    else if (slot->too_big)
+    {
+        nack = E2BIG;
+    }
+    else if (find_procedure(slot->call.procedure) == NULL)
+    {
+        nack = EPERM;
+    }
+    else
+    {
+        // A repeat (with a new random value) of a call that hasn't run yet, or is still running?
+        for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+        {
+            const slot_t *other = &slots[i];
+            if ((other != slot) && ((other->state == SLOT_QUEUED) || (other->state == SLOT_RUNNING)) &&
+                (other->call.requester == slot->call.requester) && (other->call.procedure == slot->call.procedure) &&
+                (other->request_crc == slot->request_crc))
+            {
+                nack = EALREADY;
+                break;
+            }
+        }
+    }
+
+    if (nack >= 0)
+    {
+        slot->state = SLOT_FREE;
+        return nack;
+    }
+
+    slot->sequence = next_sequence++;
+    slot->state = SLOT_QUEUED;
+
+    // Wake the main loop
+    __sev();
+    return -1;
+}
+
+/** Handler for RPCACP frames, from the CAN interrupt. */
+static void HOT_FUNC(frame_received)(const mcp2515_frame_t *frame)
+{
+    const uint8_t type = (uint8_t)((frame->id >> RTACP_ID_TYPE_SHIFT) & RTACP_ID_TYPE_MASK);
+    const rtacp_priority_t priority = (rtacp_priority_t)((frame->id >> RTACP_ID_PRIORITY_SHIFT) & RTACP_ID_PRIORITY_MASK);
+    const uint8_t requester = (uint8_t)((frame->id >> RTACP_ID_SENDER_SHIFT) & RTACP_MAX_ADDRESS);
+    const uint8_t target = (uint8_t)((frame->id >> ID_TARGET_SHIFT) & RTACP_MAX_ADDRESS);
+    const uint8_t tag = (uint8_t)(frame->id & ID_TAG_MASK);
+
+    // We don't make calls, so only requests are for us
+    if ((target != rtacp_get_address()) || ((type != TYPE_START_RPC) && (type != TYPE_TX_DATA)))
+    {
+        return;
+    }
+
+    int nack = -1;
+    bool ended = false;
+    bool corrupt = false;
+
+    const uint32_t saved = spin_lock_blocking(rpcacp_lock);
+    slot_t *slot = find_receiving(requester, tag);
+    if (type == TYPE_START_RPC)
+    {
+        if (slot == NULL)
+        {
+            slot = take_free();
+        }
+
+        if (slot == NULL)
+        {
+            // Every buffer is in use. Try again later.
+            nack = EAGAIN;
+        }
+        else if (frame->len < START_HEADER_LEN)
+        {
+            slot->state = SLOT_FREE;
+            slot = NULL;
+            nack = NACK_RESEND;
+        }
+        else
+        {
+            // (Re)start the call in this slot
+            slot->call.requester = requester;
+            slot->call.procedure = frame->data[0] & RPCACP_MAX_PROCEDURE_ID;
+            slot->call.synchronous = (frame->data[0] & HEADER_SYNCHRONOUS) != 0;
+            slot->call.data = slot->buffer;
+            slot->call.len = 0;
+            slot->tag = tag;
+            slot->priority = priority;
+            slot->started_us = time_us_32();
+            slot->request_crc = (uint16_t)(frame->data[1] | (frame->data[2] << 8));
+            slot->crc = crc16_update(CRC16_INIT, frame->data[0]);
+            slot->too_big = false;
+            bytestuff_decoder_init(&slot->decoder);
+            ended = feed_request(slot, &frame->data[START_HEADER_LEN], frame->len - START_HEADER_LEN, &corrupt);
+        }
+    }
+    else if (slot != NULL)
+    {
+        ended = feed_request(slot, frame->data, frame->len, &corrupt);
+    }
+
+    if (ended)
+    {
+        nack = finish_request(slot, corrupt);
+    }
+    spin_unlock(rpcacp_lock, saved);
+
+    if (nack >= 0)
+    {
+        send_reply(requester, priority, tag, false, (uint8_t)nack);
+    }
+}
+
+/** Set a slot's state. */
+static inline void set_state(slot_t *slot, slot_state_t state)
+{
+    const uint32_t saved = spin_lock_blocking(rpcacp_lock);
+    slot->state = state;
+    spin_unlock(rpcacp_lock, saved);
+}
+
+/** The call's procedure has finished. Get its return value ready to go out, if it has one. */
+static void finish_call(slot_t *slot)
+{
+    if (!slot->call.synchronous)
+    {
+        set_state(slot, SLOT_FREE);
+        return;
+    }
+
+    if (slot->call.len > RPCACP_BUFFER_LEN)
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        slot->call.len = RPCACP_BUFFER_LEN;
+    }
+
+    // The CRC goes in the first frame, so stuff it once to work that out, then again as it goes out
+    uint8_t byte;
+    slot->crc = crc16_update(CRC16_INIT, HEADER_SYNCHRONOUS | slot->call.procedure);
+    bytestuff_encoder_init(&slot->encoder, slot->call.data, slot->call.len);
+    while (bytestuff_encoder_next(&slot->encoder, &byte))
+    {
+        slot->crc = crc16_update(slot->crc, byte);
+    }
+    bytestuff_encoder_init(&slot->encoder, slot->call.data, slot->call.len);
+    slot->start_sent = false;
+    set_state(slot, SLOT_RETURNING);
+}
+
+/** Queue as much of a return value as fits. Frees the slot once it has all gone. */
+static void send_return(slot_t *slot)
+{
+    while (true)
+    {
+        // Work on a copy, in case the frame doesn't fit in the queue
+        bytestuff_encoder_t encoder = slot->encoder;
+        mcp2515_frame_t frame;
+        uint8_t n = 0;
+        if (!slot->start_sent)
+        {
+            frame.id = make_id(TYPE_START_RETURN, slot->priority, slot->call.requester, slot->tag);
+            frame.data[n++] = HEADER_SYNCHRONOUS | slot->call.procedure;
+            frame.data[n++] = (uint8_t)(slot->crc & 0xFF);
+            frame.data[n++] = (uint8_t)(slot->crc >> 8);
+        }
+        else
+        {
+            frame.id = make_id(TYPE_RX_DATA, slot->priority, slot->call.requester, slot->tag);
+        }
+        while ((n < MCP2515_MAX_DATA_LEN) && bytestuff_encoder_next(&encoder, &frame.data[n]))
+        {
+            n++;
+        }
+        frame.len = n;
+
+        if (!rtacp_send_frames(&frame, 1))
+        {
+            // The queue is full. Carry on next time.
+            return;
+        }
+        slot->encoder = encoder;
+        slot->start_sent = true;
+
+        if (encoder.done)
+        {
+            set_state(slot, SLOT_FREE);
+            return;
+        }
+    }
+}
+
+/** Take the call that was queued first, if any, and mark it running. */
+static slot_t *take_oldest_queued(void)
+{
+    slot_t *oldest = NULL;
+    const uint32_t saved = spin_lock_blocking(rpcacp_lock);
+    for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+    {
+        slot_t *slot = &slots[i];
+        if ((slot->state == SLOT_QUEUED) && ((oldest == NULL) || ((int32_t)(slot->sequence - oldest->sequence) < 0)))
+        {
+            oldest = slot;
+        }
+    }
+    if (oldest != NULL)
+    {
+        oldest->state = SLOT_RUNNING;
+    }
+    spin_unlock(rpcacp_lock, saved);
+    return oldest;
+}
+
+/** Take back the buffers of requests that stopped arriving partway. */
+static void reclaim_stale(void)
+{
+    bool reclaimed = false;
+    const uint32_t now = time_us_32();
+    const uint32_t saved = spin_lock_blocking(rpcacp_lock);
+    for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+    {
+        slot_t *slot = &slots[i];
+        if ((slot->state == SLOT_RECEIVING) && ((now - slot->started_us) > RPCACP_REQUEST_TIMEOUT_US))
+        {
+            slot->state = SLOT_FREE;
+            reclaimed = true;
+        }
+    }
+    spin_unlock(rpcacp_lock, saved);
+
+    if (reclaimed)
+    {
+        set_errno(ERR_ID_CAN_MODULE, ETIME);
+    }
+}
+
+bool rpcacp_init(void)
+{
+    log_info("Init RPCACP with %u buffers of %u bytes\n", (uint)RPCACP_NUM_BUFFERS, (uint)RPCACP_BUFFER_LEN);
+
+    if (rtacp_get_address() == RTACP_BROADCAST_ADDRESS)
+    {
+        // No CAN controller (or it isn't started yet)
+        set_errno(ERR_ID_CAN_MODULE, EINIT);
+        return false;
+    }
+
+    // Before the interrupt can take it
+    rpcacp_lock = spin_lock_init(spin_lock_claim_unused(true));
+    rtacp_set_frame_callback(RTACP_PROTOCOL_RPCACP, &frame_received);
+    return true;
+}
+
+bool rpcacp_register(uint8_t procedure, rpcacp_procedure_t function)
+{
+    if ((nprocedures >= RPCACP_MAX_PROCEDURES) || (procedure > RPCACP_MAX_PROCEDURE_ID) ||
+        (function == NULL) || (find_procedure(procedure) != NULL))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return false;
+    }
+
+    procedures[nprocedures].id = procedure;
+    procedures[nprocedures].function = function;
+    nprocedures++;
+    return true;
+}
+
+void rpcacp_process(void)
+{
+    if (rpcacp_lock == NULL)
+    {
+        return;
+    }
+
+    reclaim_stale();
+
+    slot_t *slot;
+    while ((slot = take_oldest_queued()) != NULL)
+    {
+        const rpcacp_procedure_t function = find_procedure(slot->call.procedure);
+        const int status = function(&slot->call);
+        if ((status != 0) && (status != RPCACP_PENDING))
+        {
+            send_reply(slot->call.requester, slot->priority, slot->tag, false, (uint8_t)status);
+            set_state(slot, SLOT_FREE);
+            continue;
+        }
+
+        send_reply(slot->call.requester, slot->priority, slot->tag, true, 0);
+        if (status == 0)
+        {
+            finish_call(slot);
+        }
+    }
+
+    for (int i = 0; i < RPCACP_NUM_BUFFERS; i++)
+    {
+        if (slots[i].state == SLOT_RETURNING)
+        {
+            send_return(&slots[i]);
+        }
+    }
+}
+
+void rpcacp_complete(rpcacp_call_t *call)
+{
+    slot_t *slot = (slot_t *)call;
+    if (slot->state != SLOT_RUNNING)
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return;
+    }
+
+    finish_call(slot);
+
+    // Wake the main loop to send it
+    __sev();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file rpcacp.h
+ * @brief Remote Procedure Call Artie CAN Protocol (RPCACP) module, for the remote node's side.
+ * Requests are reassembled in the CAN interrupt, straight into a fixed pool of buffers,
+ * and run from the main loop through a table of registered procedures. Each call keeps
+ * its buffer until its return value has gone out, so several calls (from one requester
+ * or many) can be arriving, waiting, running, and returning at once.
+ *
+ * Needs the rtacp module, which owns the CAN controller, started first.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RPCACP_NUM_BUFFERS
+    /** How many calls can be in flight at once. */
+    #define RPCACP_NUM_BUFFERS 4
+#endif // RPCACP_NUM_BUFFERS
+
+#ifndef RPCACP_BUFFER_LEN
+    /** The most bytes of arguments (once unstuffed), or of return value, a call can have. */
+    #define RPCACP_BUFFER_LEN 128
+#endif // RPCACP_BUFFER_LEN
+
+#ifndef RPCACP_MAX_PROCEDURES
+    /** How many procedures can be registered. */
+    #define RPCACP_MAX_PROCEDURES 16
+#endif // RPCACP_MAX_PROCEDURES
+
+#ifndef RPCACP_REQUEST_TIMEOUT_US
+    /**
+     * How long a request has to finish arriving before its buffer is taken back. The requester
+     * resends the whole request if it hasn't had an ACK 30 ms after sending it anyway.
+     */
+    #define RPCACP_REQUEST_TIMEOUT_US 30000
+#endif // RPCACP_REQUEST_TIMEOUT_US
+
+/** Highest procedure ID. IDs are seven bits. */
+#define RPCACP_MAX_PROCEDURE_ID 0x7F
+
+/** A procedure returns this if it will finish the call later, with rpcacp_complete(). */
+#define RPCACP_PENDING (-1)
+
+/** One call to a procedure. */
+typedef struct {
+    uint8_t requester;      ///< Address of the node that made the call
+    uint8_t procedure;      ///< Procedure ID
+    bool synchronous;       ///< Does the requester want a return value?
+    uint8_t *data;          ///< The arguments (MsgPack), in the call's buffer. Overwrite them with the return value (MsgPack).
+    size_t len;             ///< Bytes of arguments. Set it to the length of the return value, up to RPCACP_BUFFER_LEN.
+} rpcacp_call_t;
+
+/**
+ * @brief A procedure, run from rpcacp_process().
+ *
+ * @return 0 once it has finished, RPCACP_PENDING if it finishes later with rpcacp_complete(),
+ *         or an errno value (see err_t) to refuse the call: EINVAL for bad arguments,
+ *         EAGAIN to have it retried later, and so on. The requester gets the errno in a NACK.
+ */
+typedef int (*rpcacp_procedure_t)(rpcacp_call_t *call);
+
+/**
+ * @brief Start taking RPC requests. Call after rtacp_init() (cmds_init(), for firmware built with CMDS_USE_CAN).
+ *
+ * @return false (and sets errno) if there's no CAN controller to take them from.
+ */
+bool rpcacp_init(void);
+
+/**
+ * @brief Add a procedure to the table. Do it before the requests for it can arrive. Calls to
+ * procedures that aren't registered are refused with EPERM.
+ *
+ * @param procedure Its ID, up to RPCACP_MAX_PROCEDURE_ID.
+ * @param function What to run.
+ * @return false (and sets errno) if the table is full or the ID is taken or out of range.
+ */
+bool rpcacp_register(uint8_t procedure, rpcacp_procedure_t function);
+
+/**
+ * @brief Run the calls that have arrived, oldest first, and send the return values of the ones
+ * that have finished. Call it from the main loop. Doesn't block.
+ */
+void rpcacp_process(void);
+
+/**
+ * @brief Finish a call whose procedure returned RPCACP_PENDING. Its return value (call->data and
+ * call->len) goes out from the next rpcacp_process(). Safe from either core and from IRQs.
+ */
+void rpcacp_complete(rpcacp_call_t *call);
+
+#ifdef __cplusplus
+}
+#endif
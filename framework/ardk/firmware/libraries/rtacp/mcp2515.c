@@ -0,0 +1,276 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+// SDK includes
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <hotpaths.h>
+#include <sysclock.h>
+// Local includes
+#include "mcp2515.h"
+
+/** SPI instructions */
+#define INSTRUCTION_RESET           0xC0
+#define INSTRUCTION_READ            0x03
+#define INSTRUCTION_WRITE           0x02
+#define INSTRUCTION_BIT_MODIFY      0x05
+#define INSTRUCTION_READ_RX_BUFFER  0x90    ///< | (buffer << 2), starting at RXBnSIDH
+#define INSTRUCTION_LOAD_TX_BUFFER  0x40    ///< | (buffer << 1), starting at TXBnSIDH
+#define INSTRUCTION_RTS             0x80    ///< | (1 << buffer)
+
+/** Registers */
+#define REG_CANSTAT     0x0E
+#define REG_CANCTRL     0x0F
+#define REG_CNF3        0x28    ///< CNF2, CNF1, CANINTE, CANINTF follow it
+#define REG_CANINTF     0x2C
+#define REG_EFLG        0x2D
+#define REG_TXBCTRL(n)  (0x30 + ((n) << 4))
+#define REG_RXB0CTRL    0x60
+#define REG_RXB1CTRL    0x70
+
+/** CANSTAT/CANCTRL operating modes (bits 7:5) */
+#define MODE_MASK       0xE0
+#define MODE_NORMAL     0x00
+#define MODE_CONFIG     0x80
+
+/** RXBnCTRL: receive any message (RXM = 11), and let RXB0 roll over into RXB1 (BUKT) */
+#define RXBCTRL_RXM_ANY 0x60
+#define RXB0CTRL_BUKT   0x04
+
+/** SIDL's extended identifier flag */
+#define SIDL_EXIDE      0x08
+
+/** DLC's remote frame flag */
+#define DLC_RTR         0x40
+
+/** EFLG's RX overflow flags */
+#define EFLG_RXOVR      0xC0
+
+/** How long to wait for a mode change before giving up. */
+#define MODE_CHANGE_TIMEOUT_US 10000
+
+static spi_inst_t *can_spi = NULL;
+static uint can_cs_pin = 0;
+
+static inline void chip_select(void)
+{
+    gpio_put(can_cs_pin, 0);
+}
+
+static inline void chip_deselect(void)
+{
+    gpio_put(can_cs_pin, 1);
+}
+
+static void write_registers(uint8_t address, const uint8_t *values, size_t len)
+{
+    const uint8_t header[2] = { INSTRUCTION_WRITE, address };
+    chip_select();
+    spi_write_blocking(can_spi, header, sizeof(header));
+    spi_write_blocking(can_spi, values, len);
+    chip_deselect();
+}
+
+static inline void write_register(uint8_t address, uint8_t value)
+{
+    write_registers(address, &value, 1);
+}
+
+static uint8_t HOT_FUNC(read_register)(uint8_t address)
+{
+    const uint8_t header[2] = { INSTRUCTION_READ, address };
+    uint8_t value = 0;
+    chip_select();
+    spi_write_blocking(can_spi, header, sizeof(header));
+    spi_read_blocking(can_spi, 0x00, &value, 1);
+    chip_deselect();
+    return value;
+}
+
+static void HOT_FUNC(modify_register)(uint8_t address, uint8_t mask, uint8_t value)
+{
+    const uint8_t msg[4] = { INSTRUCTION_BIT_MODIFY, address, mask, value };
+    chip_select();
+    spi_write_blocking(can_spi, msg, sizeof(msg));
+    chip_deselect();
+}
+
+/** Put the controller into the given mode and wait until it says it is there. */
+static bool set_mode(uint8_t mode)
+{
+    write_register(REG_CANCTRL, mode);
+    const uint32_t start = time_us_32();
+    while ((read_register(REG_CANSTAT) & MODE_MASK) != mode)
+    {
+        if ((time_us_32() - start) > MODE_CHANGE_TIMEOUT_US)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Work out CNF1-3 for the bit rate. Tries 16, 10, then 8 time quanta per bit,
+ * sampling at about 75%, with a synchronization jump width of 1.
+ */
+static bool compute_bit_timing(uint32_t osc_hz, uint32_t bitrate, uint8_t cnf[3])
+{
+    static const uint8_t QUANTA[] = { 16, 10, 8 };
+    for (size_t i = 0; i < (sizeof(QUANTA) / sizeof(QUANTA[0])); i++)
+    {
+        const uint32_t nquanta = QUANTA[i];
+        const uint32_t divisor = 2 * bitrate * nquanta;
+        if ((bitrate == 0) || ((osc_hz % divisor) != 0))
+        {
+            continue;
+        }
+
+        const uint32_t brp = (osc_hz / divisor) - 1;
+        if (brp > 0x3F)
+        {
+            continue;
+        }
+
+        const uint32_t phase2 = nquanta / 4;
+        const uint32_t prop = (nquanta - 1 - phase2) / 2;
+        const uint32_t phase1 = nquanta - 1 - phase2 - prop;
+        cnf[0] = (uint8_t)(phase2 - 1);                                     // CNF3
+        cnf[1] = (uint8_t)(0x80 | ((phase1 - 1) << 3) | (prop - 1));        // CNF2: BTLMODE, PHSEG1, PRSEG
+        cnf[2] = (uint8_t)brp;                                              // CNF1: SJW = 1
+        return true;
+    }
+    return false;
+}
+
+/** Derive the SPI divider for the rate in context from clk_peri, which follows the system clock. */
+static void set_spi_baudrate(uint32_t sys_hz, void *context)
+{
+    spi_set_baudrate(can_spi, (uint)(uintptr_t)context);
+}
+
+bool mcp2515_init(const mcp2515_config_t *config)
+{
+    can_spi = config->spi;
+    can_cs_pin = config->cs_pin;
+
+    spi_init(can_spi, config->spi_baudrate);
+    sysclock_register(&set_spi_baudrate, (void *)(uintptr_t)config->spi_baudrate);
+    spi_set_format(can_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_set_function(config->sck_pin, GPIO_FUNC_SPI);
+    gpio_set_function(config->mosi_pin, GPIO_FUNC_SPI);
+    gpio_set_function(config->miso_pin, GPIO_FUNC_SPI);
+
+    gpio_init(can_cs_pin);
+    gpio_set_dir(can_cs_pin, GPIO_OUT);
+    chip_deselect();
+
+    gpio_init(config->int_pin);
+    gpio_set_dir(config->int_pin, GPIO_IN);
+    gpio_pull_up(config->int_pin);
+
+    // Reset and give the oscillator time to start. It comes up in configuration mode.
+    const uint8_t reset = INSTRUCTION_RESET;
+    chip_select();
+    spi_write_blocking(can_spi, &reset, 1);
+    chip_deselect();
+    sleep_us(100);
+    if ((read_register(REG_CANSTAT) & MODE_MASK) != MODE_CONFIG)
+    {
+        return false;
+    }
+
+    // CNF3, CNF2, CNF1, CANINTE, CANINTF are consecutive
+    uint8_t config_regs[5];
+    if (!compute_bit_timing(config->osc_hz, config->bitrate, config_regs))
+    {
+        return false;
+    }
+    config_regs[3] = MCP2515_INT_ALL;
+    config_regs[4] = 0x00;
+    write_registers(REG_CNF3, config_regs, sizeof(config_regs));
+
+    write_register(REG_RXB0CTRL, RXBCTRL_RXM_ANY | RXB0CTRL_BUKT);
+    write_register(REG_RXB1CTRL, RXBCTRL_RXM_ANY);
+
+    return set_mode(MODE_NORMAL);
+}
+
+uint8_t HOT_FUNC(mcp2515_get_interrupts)(void)
+{
+    // The flags of disabled interrupts get set too. Leave them out, since they don't hold INT low.
+    return read_register(REG_CANINTF) & MCP2515_INT_ALL;
+}
+
+void HOT_FUNC(mcp2515_clear_interrupts)(uint8_t flags)
+{
+    modify_register(REG_CANINTF, flags, 0x00);
+}
+
+bool HOT_FUNC(mcp2515_read_rx)(uint buffer, mcp2515_frame_t *frame)
+{
+    // SIDH, SIDL, EID8, EID0, DLC, D0-D7. Raising CS clears the buffer's RXnIF.
+    uint8_t regs[5 + MCP2515_MAX_DATA_LEN];
+    const uint8_t instruction = (uint8_t)(INSTRUCTION_READ_RX_BUFFER | ((buffer & 0x01) << 2));
+    chip_select();
+    spi_write_blocking(can_spi, &instruction, 1);
+    spi_read_blocking(can_spi, 0x00, regs, sizeof(regs));
+    chip_deselect();
+
+    frame->id = ((uint32_t)regs[0] << 21) | ((uint32_t)(regs[1] >> 5) << 18) | ((uint32_t)(regs[1] & 0x03) << 16) |
+                ((uint32_t)regs[2] << 8) | regs[3];
+    frame->len = regs[4] & 0x0F;
+    if (frame->len > MCP2515_MAX_DATA_LEN)
+    {
+        frame->len = MCP2515_MAX_DATA_LEN;
+    }
+    for (uint8_t i = 0; i < frame->len; i++)
+    {
+        frame->data[i] = regs[5 + i];
+    }
+
+    return ((regs[1] & SIDL_EXIDE) != 0) && ((regs[4] & DLC_RTR) == 0);
+}
+
+void HOT_FUNC(mcp2515_transmit)(uint buffer, const mcp2515_frame_t *frame, uint8_t priority)
+{
+    // TXP first, while the buffer is idle
+    const uint8_t ctrl[3] = { INSTRUCTION_WRITE, REG_TXBCTRL(buffer), (uint8_t)(priority & 0x03) };
+    chip_select();
+    spi_write_blocking(can_spi, ctrl, sizeof(ctrl));
+    chip_deselect();
+
+    // SIDH, SIDL, EID8, EID0, DLC, D0-D7
+    const uint8_t len = (frame->len > MCP2515_MAX_DATA_LEN) ? MCP2515_MAX_DATA_LEN : frame->len;
+    uint8_t msg[6 + MCP2515_MAX_DATA_LEN];
+    msg[0] = (uint8_t)(INSTRUCTION_LOAD_TX_BUFFER | (buffer << 1));
+    msg[1] = (uint8_t)(frame->id >> 21);
+    msg[2] = (uint8_t)((((frame->id >> 18) & 0x07) << 5) | SIDL_EXIDE | ((frame->id >> 16) & 0x03));
+    msg[3] = (uint8_t)(frame->id >> 8);
+    msg[4] = (uint8_t)frame->id;
+    msg[5] = len;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        msg[6 + i] = frame->data[i];
+    }
+    chip_select();
+    spi_write_blocking(can_spi, msg, 6 + len);
+    chip_deselect();
+
+    const uint8_t rts = (uint8_t)(INSTRUCTION_RTS | (1u << buffer));
+    chip_select();
+    spi_write_blocking(can_spi, &rts, 1);
+    chip_deselect();
+}
+
+uint8_t mcp2515_take_errors(void)
+{
+    const uint8_t eflg = read_register(REG_EFLG);
+    if (eflg & EFLG_RXOVR)
+    {
+        modify_register(REG_EFLG, EFLG_RXOVR, 0x00);
+    }
+    return eflg;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file mcp2515.h
+ * @brief Driver for an MCP2515-class (MCP2515, MCP25625) SPI CAN controller.
+ * Just what RTACP needs: extended frames, the three TX buffers, both RX buffers
+ * (with rollover), and the interrupt line. The caller serializes access: every
+ * function here runs an SPI transaction, so call them with the controller's
+ * interrupt masked (see rtacp.c).
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/spi.h"
+
+/** Number of TX buffers. */
+#define MCP2515_NUM_TX_BUFFERS 3
+
+/** Most data bytes in a CAN frame. */
+#define MCP2515_MAX_DATA_LEN 8
+
+/** One CAN frame. Always extended (29-bit ID). */
+typedef struct {
+    uint32_t id;                            ///< 29-bit identifier
+    uint8_t len;                            ///< Data length code, 0 to MCP2515_MAX_DATA_LEN
+    uint8_t data[MCP2515_MAX_DATA_LEN];
+} mcp2515_frame_t;
+
+/** How the controller is wired up. */
+typedef struct {
+    spi_inst_t *spi;
+    uint sck_pin;
+    uint mosi_pin;
+    uint miso_pin;
+    uint cs_pin;
+    uint int_pin;           ///< Active-low interrupt output
+    uint32_t spi_baudrate;  ///< At most 10 MHz
+    uint32_t osc_hz;        ///< The controller's crystal (8 or 16 MHz on the usual modules)
+    uint32_t bitrate;       ///< CAN bit rate
+} mcp2515_config_t;
+
+/** What the interrupt is for. Bits of CANINTF. */
+#define MCP2515_INT_RX0     0x01
+#define MCP2515_INT_RX1     0x02
+#define MCP2515_INT_TX0     0x04
+#define MCP2515_INT_TX1     0x08
+#define MCP2515_INT_TX2     0x10
+#define MCP2515_INT_ERR     0x20
+
+/** Every interrupt the driver turns on. */
+#define MCP2515_INT_ALL     (MCP2515_INT_RX0 | MCP2515_INT_RX1 | MCP2515_INT_TX0 | MCP2515_INT_TX1 | MCP2515_INT_TX2 | MCP2515_INT_ERR)
+
+/** TX complete flag for the given buffer. */
+#define MCP2515_INT_TX(buffer) (MCP2515_INT_TX0 << (buffer))
+
+/**
+ * @brief Reset the controller, set its bit timing, and start it in normal mode,
+ * receiving every extended frame, with interrupts for RX, TX, and errors.
+ * Does not enable the RP2040's interrupt for int_pin.
+ *
+ * @return false if the controller doesn't answer or the bit rate can't be made from osc_hz.
+ */
+bool mcp2515_init(const mcp2515_config_t *config);
+
+/** Read the pending interrupt flags (MCP2515_INT_*). The INT pin is low while any are set. */
+uint8_t mcp2515_get_interrupts(void);
+
+/** Clear the given interrupt flags. */
+void mcp2515_clear_interrupts(uint8_t flags);
+
+/**
+ * @brief Read a received frame out of an RX buffer. Clears its MCP2515_INT_RXn flag.
+ *
+ * @param buffer 0 or 1.
+ * @return false if it wasn't an extended data frame (it is still taken out).
+ */
+bool mcp2515_read_rx(uint buffer, mcp2515_frame_t *frame);
+
+/**
+ * @brief Load a frame into a TX buffer and request its transmission.
+ * The buffer must be free (its MCP2515_INT_TXn flag seen since it was last loaded).
+ *
+ * @param buffer 0 to MCP2515_NUM_TX_BUFFERS - 1.
+ * @param frame The frame.
+ * @param priority 0 (lowest) to 3 (highest). Decides between our own pending buffers;
+ *                 the bus decides between nodes by ID.
+ */
+void mcp2515_transmit(uint buffer, const mcp2515_frame_t *frame, uint8_t priority);
+
+/** Read the error flags (EFLG), to report on MCP2515_INT_ERR. Clears the RX overflow flags. */
+uint8_t mcp2515_take_errors(void);
+
+#ifdef __cplusplus
+}
+#endif
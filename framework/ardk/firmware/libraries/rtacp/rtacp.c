@@ -0,0 +1,546 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+// SDK includes
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <errors.h>
+#include <hotpaths.h>
+// Local includes
+#include "mcp2515.h"
+#include "rtacp.h"
+
+#if (RTACP_TX_QUEUE_LEN & (RTACP_TX_QUEUE_LEN - 1)) != 0
+    #error "RTACP_TX_QUEUE_LEN must be a power of two"
+#endif
+
+/** After the shared fields (see RTACP_ID_SENDER_SHIFT), RTACP has the target address (6 bits), then eight set bits. */
+#define ID_TARGET_SHIFT     8
+#define ID_SUFFIX           0xFF
+
+/** Message types */
+#define TYPE_ACK            0x0
+#define TYPE_MSG            0x1
+
+/** Mask to turn a free-running queue counter into an index. */
+#define TX_QUEUE_MASK (RTACP_TX_QUEUE_LEN - 1)
+
+/** The ACKs we owe get their own queue, ahead of the one per priority. */
+#define ACK_LANE 0
+#define NUM_LANES (1 + RTACP_NUM_PRIORITIES)
+#define LANE_FOR_PRIORITY(priority) (1 + (int)(priority))
+
+/** The TX buffer priority (3 is the highest) each lane's frames go out with. */
+static const uint8_t LANE_TX_PRIORITY[NUM_LANES] = { 3, 3, 2, 1, 0 };
+
+/**
+ * @brief One queue of frames to send. Only the frame at the front (frames[tail]) is ever on
+ * its way: the next one isn't loaded until that one has been sent (and, if it needs it, acknowledged),
+ * so a lane's frames arrive in order even when one has to be resent.
+ */
+typedef struct {
+    mcp2515_frame_t frames[RTACP_TX_QUEUE_LEN];
+    uint32_t head;          // Free-running count of frames queued
+    uint32_t tail;          // Free-running count of frames done with
+    bool loaded;            // Is the front frame in a TX buffer?
+    bool awaiting_ack;      // Has the front frame gone out, and we're waiting for its ACK?
+    uint32_t deadline_us;   // When to resend the front frame, while awaiting_ack
+    uint8_t retries;        // How many times the front frame has been resent
+} tx_lane_t;
+
+/** Everything we're sending. Guarded by rtacp_lock. */
+static tx_lane_t lanes[NUM_LANES];
+
+/** Which lane each TX buffer's frame is from, or -1 if the buffer is free. Guarded by rtacp_lock. */
+static int8_t tx_buffer_lane[MCP2515_NUM_TX_BUFFERS];
+
+/** Is the alarm that resends unacknowledged frames scheduled? Guarded by rtacp_lock. */
+static bool ack_alarm_armed = false;
+
+/**
+ * Guards the lanes and the controller (every SPI transaction) against our IRQs and the other core.
+ * NULL until rtacp_init().
+ */
+static spin_lock_t *rtacp_lock = NULL;
+
+/** Our node address. */
+static uint8_t node_address = 0;
+
+/** The controller's interrupt pin. */
+static uint node_int_pin = 0;
+
+/** Gets the messages for us. */
+static rtacp_receive_callback_t receive_callback = NULL;
+
+/** Get the other protocols' frames, by protocol number. */
+static volatile rtacp_frame_callback_t frame_callbacks[RTACP_NUM_PROTOCOLS];
+
+static inline uint32_t make_id(uint8_t type, rtacp_priority_t priority, uint8_t sender, uint8_t target)
+{
+    return ((uint32_t)type << RTACP_ID_TYPE_SHIFT) |
+           ((uint32_t)priority << RTACP_ID_PRIORITY_SHIFT) |
+           ((uint32_t)(sender & RTACP_MAX_ADDRESS) << RTACP_ID_SENDER_SHIFT) |
+           ((uint32_t)(target & RTACP_MAX_ADDRESS) << ID_TARGET_SHIFT) |
+           ID_SUFFIX;
+}
+
+static inline uint8_t id_target(uint32_t id)
+{
+    return (uint8_t)((id >> ID_TARGET_SHIFT) & RTACP_MAX_ADDRESS);
+}
+
+static inline uint8_t id_sender(uint32_t id)
+{
+    return (uint8_t)((id >> RTACP_ID_SENDER_SHIFT) & RTACP_MAX_ADDRESS);
+}
+
+/** Does the frame have to be acknowledged (by RTACP) before the next one in its lane goes? */
+static inline bool needs_ack(uint32_t id)
+{
+    return ((id >> RTACP_ID_PROTOCOL_SHIFT) == RTACP_PROTOCOL_RTACP) &&
+           (((id >> RTACP_ID_TYPE_SHIFT) & RTACP_ID_TYPE_MASK) == TYPE_MSG) &&
+           (id_target(id) != RTACP_BROADCAST_ADDRESS);
+}
+
+static inline mcp2515_frame_t *lane_front(tx_lane_t *lane)
+{
+    return &lane->frames[lane->tail & TX_QUEUE_MASK];
+}
+
+/** Done with the frame at the front of the lane. Call with rtacp_lock held. */
+static inline void lane_pop(tx_lane_t *lane)
+{
+    lane->tail++;
+    lane->loaded = false;
+    lane->awaiting_ack = false;
+    lane->retries = 0;
+}
+
+/**
+ * Send the front frame of the lane again. Returns false (and drops it) if it has been
+ * resent too often already. Call with rtacp_lock held.
+ */
+static inline bool lane_retry(tx_lane_t *lane)
+{
+    if (lane->retries >= RTACP_MAX_RETRIES)
+    {
+        lane_pop(lane);
+        return false;
+    }
+    lane->retries++;
+    lane->awaiting_ack = false;
+    return true;
+}
+
+/**
+ * Load the front frame of each lane that's ready into a free TX buffer, ACKs first,
+ * then by priority. Call with rtacp_lock held.
+ * A frame that arrives while lower priority frames hold every buffer waits for one of
+ * them to go out (a frame time), since we don't abort them.
+ */
+static void HOT_FUNC(pump_tx)(void)
+{
+    for (int l = 0; l < NUM_LANES; l++)
+    {
+        tx_lane_t *lane = &lanes[l];
+        if ((lane->head == lane->tail) || lane->loaded || lane->awaiting_ack)
+        {
+            continue;
+        }
+
+        int buffer = -1;
+        for (int b = 0; b < MCP2515_NUM_TX_BUFFERS; b++)
+        {
+            if (tx_buffer_lane[b] < 0)
+            {
+                buffer = b;
+                break;
+            }
+        }
+        if (buffer < 0)
+        {
+            return;
+        }
+
+        mcp2515_transmit((uint)buffer, lane_front(lane), LANE_TX_PRIORITY[l]);
+        tx_buffer_lane[buffer] = (int8_t)l;
+        lane->loaded = true;
+    }
+}
+
+/** Resend (or give up on) the frames whose ACKs are overdue. Runs in the timer IRQ. */
+static int64_t HOT_FUNC(ack_alarm_callback)(alarm_id_t id, void *user_data)
+{
+    bool gave_up = false;
+    bool waiting = false;
+    int32_t next_us = RTACP_ACK_TIMEOUT_US;
+
+    const uint32_t saved = spin_lock_blocking(rtacp_lock);
+    const uint32_t now = time_us_32();
+    for (int l = 0; l < NUM_LANES; l++)
+    {
+        tx_lane_t *lane = &lanes[l];
+        if (!lane->awaiting_ack)
+        {
+            continue;
+        }
+
+        const int32_t remaining = (int32_t)(lane->deadline_us - now);
+        if (remaining <= 0)
+        {
+            gave_up |= !lane_retry(lane);
+            continue;
+        }
+
+        waiting = true;
+        next_us = (remaining < next_us) ? remaining : next_us;
+    }
+    pump_tx();
+
+    // Whatever we just resent arms a new alarm when it goes out, if this one isn't going to run again
+    ack_alarm_armed = waiting;
+    spin_unlock(rtacp_lock, saved);
+
+    if (gave_up)
+    {
+        set_errno(ERR_ID_CAN_MODULE, ETIME);
+    }
+
+    // Negative: that long from now
+    return waiting ? -(int64_t)next_us : 0;
+}
+
+/** Called when a TX buffer's frame has gone out. Call with rtacp_lock held. Returns false if we couldn't wait for its ACK. */
+static bool HOT_FUNC(tx_done)(uint buffer)
+{
+    const int l = tx_buffer_lane[buffer];
+    tx_buffer_lane[buffer] = -1;
+    if (l < 0)
+    {
+        return true;
+    }
+
+    tx_lane_t *lane = &lanes[l];
+    lane->loaded = false;
+    if (!needs_ack(lane_front(lane)->id))
+    {
+        lane_pop(lane);
+        return true;
+    }
+
+    lane->awaiting_ack = true;
+    lane->deadline_us = time_us_32() + RTACP_ACK_TIMEOUT_US;
+    if (ack_alarm_armed)
+    {
+        return true;
+    }
+
+    ack_alarm_armed = add_alarm_in_us(RTACP_ACK_TIMEOUT_US, &ack_alarm_callback, NULL, true) > 0;
+    if (!ack_alarm_armed)
+    {
+        // Out of alarms. Rather than wait forever, take it as delivered.
+        lane_pop(lane);
+        return false;
+    }
+    return true;
+}
+
+/** Handle an ACK from `sender`. */
+static void HOT_FUNC(ack_received)(uint8_t sender, rtacp_priority_t priority, const mcp2515_frame_t *frame)
+{
+    bool gave_up = false;
+    tx_lane_t *lane = &lanes[LANE_FOR_PRIORITY(priority)];
+
+    const uint32_t saved = spin_lock_blocking(rtacp_lock);
+    const mcp2515_frame_t *sent = lane_front(lane);
+    if (lane->awaiting_ack && (id_target(sent->id) == sender))
+    {
+        if ((sent->len == frame->len) && (memcmp(sent->data, frame->data, frame->len) == 0))
+        {
+            lane_pop(lane);
+        }
+        else
+        {
+            // It got something other than what we sent. Send it again.
+            gave_up = !lane_retry(lane);
+        }
+        pump_tx();
+    }
+    spin_unlock(rtacp_lock, saved);
+
+    if (gave_up)
+    {
+        set_errno(ERR_ID_CAN_MODULE, EIO);
+    }
+}
+
+/** Acknowledge a message from `sender`, by sending its data back. */
+static void HOT_FUNC(send_ack)(uint8_t sender, rtacp_priority_t priority, const mcp2515_frame_t *frame)
+{
+    tx_lane_t *lane = &lanes[ACK_LANE];
+
+    const uint32_t saved = spin_lock_blocking(rtacp_lock);
+    const bool fits = (lane->head - lane->tail) < RTACP_TX_QUEUE_LEN;
+    if (fits)
+    {
+        mcp2515_frame_t *ack = &lane->frames[lane->head & TX_QUEUE_MASK];
+        ack->id = make_id(TYPE_ACK, priority, node_address, sender);
+        ack->len = frame->len;
+        memcpy(ack->data, frame->data, frame->len);
+        lane->head++;
+        pump_tx();
+    }
+    spin_unlock(rtacp_lock, saved);
+
+    if (!fits)
+    {
+        // The sender will resend it
+        set_errno(ERR_ID_CAN_MODULE, ENOMEM);
+    }
+}
+
+/** Handle a received frame. */
+static void HOT_FUNC(frame_received)(const mcp2515_frame_t *frame)
+{
+    const uint8_t protocol = (uint8_t)(frame->id >> RTACP_ID_PROTOCOL_SHIFT);
+    if (protocol != RTACP_PROTOCOL_RTACP)
+    {
+        const rtacp_frame_callback_t callback = frame_callbacks[protocol & (RTACP_NUM_PROTOCOLS - 1)];
+        if (callback != NULL)
+        {
+            callback(frame);
+        }
+        return;
+    }
+
+    if ((frame->id & ID_SUFFIX) != ID_SUFFIX)
+    {
+        return;
+    }
+
+    const uint8_t type = (uint8_t)((frame->id >> RTACP_ID_TYPE_SHIFT) & RTACP_ID_TYPE_MASK);
+    const rtacp_priority_t priority = (rtacp_priority_t)((frame->id >> RTACP_ID_PRIORITY_SHIFT) & RTACP_ID_PRIORITY_MASK);
+    const uint8_t sender = id_sender(frame->id);
+    const uint8_t target = id_target(frame->id);
+    if (sender == node_address)
+    {
+        return;
+    }
+
+    if (type == TYPE_ACK)
+    {
+        if (target == node_address)
+        {
+            ack_received(sender, priority, frame);
+        }
+        return;
+    }
+
+    if ((type != TYPE_MSG) || ((target != node_address) && (target != RTACP_BROADCAST_ADDRESS)))
+    {
+        return;
+    }
+
+    if (target == node_address)
+    {
+        send_ack(sender, priority, frame);
+    }
+
+    if (receive_callback != NULL)
+    {
+        receive_callback(sender, target, priority, frame->data, frame->len);
+    }
+}
+
+/** Handler for the controller's interrupt pin. Shares the IO bank interrupt with the other GPIO users. */
+static void HOT_FUNC(rtacp_irq_handler)(void)
+{
+    // Level-triggered: it stays pending until the controller's flags are clear, so there's nothing to acknowledge
+    if ((gpio_get_irq_event_mask(node_int_pin) & GPIO_IRQ_LEVEL_LOW) == 0)
+    {
+        return;
+    }
+
+    while (true)
+    {
+        mcp2515_frame_t received[2];
+        size_t nreceived = 0;
+        bool bus_error = false;
+        bool ack_lost = false;
+
+        const uint32_t saved = spin_lock_blocking(rtacp_lock);
+        const uint8_t flags = mcp2515_get_interrupts();
+        if (flags == 0)
+        {
+            spin_unlock(rtacp_lock, saved);
+            return;
+        }
+
+        // Reading an RX buffer clears its flag. Anything that's not an extended data frame isn't for us.
+        if ((flags & MCP2515_INT_RX0) && mcp2515_read_rx(0, &received[nreceived]))
+        {
+            nreceived++;
+        }
+        if ((flags & MCP2515_INT_RX1) && mcp2515_read_rx(1, &received[nreceived]))
+        {
+            nreceived++;
+        }
+
+        for (uint b = 0; b < MCP2515_NUM_TX_BUFFERS; b++)
+        {
+            if (flags & MCP2515_INT_TX(b))
+            {
+                ack_lost |= !tx_done(b);
+            }
+        }
+
+        if (flags & MCP2515_INT_ERR)
+        {
+            bus_error = mcp2515_take_errors() != 0;
+        }
+
+        const uint8_t handled = flags & ~(MCP2515_INT_RX0 | MCP2515_INT_RX1);
+        if (handled != 0)
+        {
+            mcp2515_clear_interrupts(handled);
+        }
+        pump_tx();
+        spin_unlock(rtacp_lock, saved);
+
+        if (bus_error)
+        {
+            set_errno(ERR_ID_CAN_MODULE, EIO);
+        }
+        if (ack_lost)
+        {
+            set_errno(ERR_ID_CAN_MODULE, ENOMEM);
+        }
+
+        // Outside the lock, since the callback may send
+        for (size_t i = 0; i < nreceived; i++)
+        {
+            frame_received(&received[i]);
+        }
+    }
+}
+
+bool rtacp_init(uint8_t address, const mcp2515_config_t *config, rtacp_receive_callback_t callback)
+{
+    log_info("Init RTACP as node 0x%02X at %lu bit/s\n", address, (unsigned long)config->bitrate);
+
+    if ((address == RTACP_BROADCAST_ADDRESS) || (address > RTACP_MAX_ADDRESS))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return false;
+    }
+
+    node_address = address;
+    node_int_pin = config->int_pin;
+    receive_callback = callback;
+    for (int b = 0; b < MCP2515_NUM_TX_BUFFERS; b++)
+    {
+        tx_buffer_lane[b] = -1;
+    }
+
+    if (!mcp2515_init(config))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINIT);
+        return false;
+    }
+
+    // Before the interrupt can take it
+    rtacp_lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    gpio_add_raw_irq_handler(node_int_pin, &rtacp_irq_handler);
+    gpio_set_irq_enabled(node_int_pin, GPIO_IRQ_LEVEL_LOW, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
+
+bool HOT_FUNC(rtacp_send)(uint8_t target, rtacp_priority_t priority, const uint8_t *data, size_t len)
+{
+    if ((rtacp_lock == NULL) || (target > RTACP_MAX_ADDRESS) || (priority >= RTACP_NUM_PRIORITIES))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return false;
+    }
+
+    // An empty message is still one frame
+    const size_t nframes = (len == 0) ? 1 : ((len + RTACP_MAX_DATA_LEN - 1) / RTACP_MAX_DATA_LEN);
+    const uint32_t id = make_id(TYPE_MSG, priority, node_address, target);
+    tx_lane_t *lane = &lanes[LANE_FOR_PRIORITY(priority)];
+
+    const uint32_t saved = spin_lock_blocking(rtacp_lock);
+    const bool fits = nframes <= (RTACP_TX_QUEUE_LEN - (lane->head - lane->tail));
+    if (fits)
+    {
+        for (size_t i = 0; i < nframes; i++)
+        {
+            const size_t offset = i * RTACP_MAX_DATA_LEN;
+            const size_t n = ((len - offset) < RTACP_MAX_DATA_LEN) ? (len - offset) : RTACP_MAX_DATA_LEN;
+            mcp2515_frame_t *frame = &lane->frames[lane->head & TX_QUEUE_MASK];
+            frame->id = id;
+            frame->len = (uint8_t)n;
+            if (n > 0)
+            {
+                memcpy(frame->data, &data[offset], n);
+            }
+            lane->head++;
+        }
+        pump_tx();
+    }
+    spin_unlock(rtacp_lock, saved);
+
+    if (!fits)
+    {
+        set_errno(ERR_ID_CAN_MODULE, ENOMEM);
+    }
+    return fits;
+}
+
+void rtacp_set_frame_callback(uint8_t protocol, rtacp_frame_callback_t callback)
+{
+    if ((protocol == RTACP_PROTOCOL_RTACP) || (protocol >= RTACP_NUM_PROTOCOLS))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return;
+    }
+    frame_callbacks[protocol] = callback;
+}
+
+bool HOT_FUNC(rtacp_send_frames)(const mcp2515_frame_t *frames, size_t nframes)
+{
+    if ((rtacp_lock == NULL) || (nframes == 0))
+    {
+        set_errno(ERR_ID_CAN_MODULE, EINVAL);
+        return false;
+    }
+
+    const rtacp_priority_t priority = (rtacp_priority_t)((frames[0].id >> RTACP_ID_PRIORITY_SHIFT) & RTACP_ID_PRIORITY_MASK);
+    tx_lane_t *lane = &lanes[LANE_FOR_PRIORITY(priority)];
+
+    const uint32_t saved = spin_lock_blocking(rtacp_lock);
+    const bool fits = nframes <= (RTACP_TX_QUEUE_LEN - (lane->head - lane->tail));
+    if (fits)
+    {
+        for (size_t i = 0; i < nframes; i++)
+        {
+            lane->frames[lane->head & TX_QUEUE_MASK] = frames[i];
+            lane->head++;
+        }
+        pump_tx();
+    }
+    spin_unlock(rtacp_lock, saved);
+
+    // Not an error (yet): the other protocols have their own ways of trying again
+    return fits;
+}
+
+uint8_t rtacp_get_address(void)
+{
+    return node_address;
+}
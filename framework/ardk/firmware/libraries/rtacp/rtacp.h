@@ -0,0 +1,139 @@
+/**
+ * @file rtacp.h
+ * @brief Real Time Artie CAN Protocol (RTACP) module.
+ * Sends and receives RTACP messages (see docs/specifications/CANProtocol.md) through
+ * an MCP2515-class CAN controller. Reception is interrupt-driven. Messages wait in
+ * one queue per priority and go out highest priority first. A message to a single
+ * node is resent until that node acknowledges it.
+ *
+ * This module also owns the controller for the other Artie CAN protocols, which share the
+ * bus: it hands their frames to the callback registered for them and queues theirs with ours.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mcp2515.h"
+
+#ifndef RTACP_ACK_TIMEOUT_US
+    /** How long the target has to acknowledge a message before we resend it. */
+    #define RTACP_ACK_TIMEOUT_US 1000
+#endif // RTACP_ACK_TIMEOUT_US
+
+#ifndef RTACP_MAX_RETRIES
+    /** How many times to resend an unacknowledged message before giving up on it. */
+    #define RTACP_MAX_RETRIES 3
+#endif // RTACP_MAX_RETRIES
+
+#ifndef RTACP_TX_QUEUE_LEN
+    /** Messages each priority's queue holds (including the one being sent). Must be a power of two. */
+    #define RTACP_TX_QUEUE_LEN 8
+#endif // RTACP_TX_QUEUE_LEN
+
+/** Sending to this address broadcasts to every node. Broadcasts aren't acknowledged. */
+#define RTACP_BROADCAST_ADDRESS 0x00
+
+/** Highest node address. Addresses are six bits. */
+#define RTACP_MAX_ADDRESS 0x3F
+
+/** Most data bytes in one message. */
+#define RTACP_MAX_DATA_LEN MCP2515_MAX_DATA_LEN
+
+/**
+ * Identifier fields every Artie CAN protocol shares: the protocol (top three bits), a type
+ * (four bits), the priority (two bits), and the sender's address (six bits). What the lowest
+ * 14 bits hold depends on the protocol.
+ */
+#define RTACP_ID_PROTOCOL_SHIFT     26
+#define RTACP_ID_TYPE_SHIFT         22
+#define RTACP_ID_TYPE_MASK          0x0F
+#define RTACP_ID_PRIORITY_SHIFT     20
+#define RTACP_ID_PRIORITY_MASK      0x03
+#define RTACP_ID_SENDER_SHIFT       14
+
+/** Number of protocols the top three identifier bits can pick. */
+#define RTACP_NUM_PROTOCOLS         8
+
+/** Protocol numbers, in bus priority order. */
+#define RTACP_PROTOCOL_RTACP        0x0
+#define RTACP_PROTOCOL_RPCACP       0x2
+#define RTACP_PROTOCOL_PSACP_HIGH   0x4
+#define RTACP_PROTOCOL_BWACP        0x5
+#define RTACP_PROTOCOL_PSACP_LOW    0x6
+
+/** Message priorities, as in the identifier. Lower goes first, on the bus and in our queues. */
+typedef enum {
+    RTACP_PRIORITY_HIGH = 0,
+    RTACP_PRIORITY_MED_HIGH,
+    RTACP_PRIORITY_MED_LOW,
+    RTACP_PRIORITY_LOW,
+    RTACP_NUM_PRIORITIES
+} rtacp_priority_t;
+
+/**
+ * Called (from the controller's interrupt) with each message addressed to us or broadcast.
+ * Messages to us have already been acknowledged. A message whose acknowledgement was lost is
+ * delivered again when the sender resends it.
+ */
+typedef void (*rtacp_receive_callback_t)(uint8_t sender, uint8_t target, rtacp_priority_t priority, const uint8_t *data, size_t len);
+
+/** Called (from the controller's interrupt) with each frame of one of the other protocols. */
+typedef void (*rtacp_frame_callback_t)(const mcp2515_frame_t *frame);
+
+/**
+ * @brief Start the CAN controller and begin receiving. Uses one spin lock and the
+ * default alarm pool. Reception runs in the IO bank interrupt of the calling core.
+ *
+ * @param address Our node address, 1 to RTACP_MAX_ADDRESS.
+ * @param config How the controller is wired up.
+ * @param callback Called with each message for us.
+ * @return false (and sets errno) if the controller didn't start.
+ */
+bool rtacp_init(uint8_t address, const mcp2515_config_t *config, rtacp_receive_callback_t callback);
+
+/**
+ * @brief Queue data for a node (or for everyone). Longer than RTACP_MAX_DATA_LEN is split
+ * into consecutive messages, queued together so nothing else at that priority lands between them.
+ * Then we send them in order, each after the last is acknowledged.
+ * Safe from either core and from IRQs. Doesn't block.
+ *
+ * @param target Node address, or RTACP_BROADCAST_ADDRESS.
+ * @param priority The priority of every message.
+ * @param data The bytes. Copied.
+ * @param len How many. Up to RTACP_TX_QUEUE_LEN * RTACP_MAX_DATA_LEN, if the queue is empty.
+ * @return false (and sets errno) if they didn't fit in the queue; then none of them are sent.
+ */
+bool rtacp_send(uint8_t target, rtacp_priority_t priority, const uint8_t *data, size_t len);
+
+/**
+ * @brief Get frames of another protocol (their top three identifier bits) handed to a callback.
+ * Replaces any callback set for that protocol before. Frames of protocols with no callback are ignored.
+ *
+ * @param protocol RTACP_PROTOCOL_* other than RTACP_PROTOCOL_RTACP.
+ * @param callback The callback, or NULL to stop.
+ */
+void rtacp_set_frame_callback(uint8_t protocol, rtacp_frame_callback_t callback);
+
+/**
+ * @brief Queue another protocol's frames, in order, at the priority in the first one's identifier.
+ * They aren't acknowledged by this module; that is up to their protocol.
+ * Safe from either core and from IRQs. Doesn't block.
+ *
+ * @param frames The frames, with complete identifiers. Copied.
+ * @param nframes How many. Up to RTACP_TX_QUEUE_LEN, if the queue is empty.
+ * @return false if they didn't fit in the queue; then none of them are sent. This doesn't set
+ *         errno, since the caller can usually try again later.
+ */
+bool rtacp_send_frames(const mcp2515_frame_t *frames, size_t nframes);
+
+/** Our node address, as given to rtacp_init(). */
+uint8_t rtacp_get_address(void);
+
+#ifdef __cplusplus
+}
+#endif
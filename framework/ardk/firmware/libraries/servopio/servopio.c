@@ -0,0 +1,136 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stdint.h>
+// SDK includes
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+// Library includes
+#include <errors.h>
+#include <sysclock.h>
+// Local includes
+#include "servopio.h"
+#include "servopio.pio.h"
+
+/** The state machine's clock: one cycle per us. */
+#define SERVOPIO_TICK_HZ 1000000U
+
+/** Cycles each step takes on top of its hold count (the two OUTs, and the JMP's last pass). */
+#define STEP_OVERHEAD_US 3U
+
+/** A step: the pin levels, held for `us`. */
+static inline uint32_t make_step(uint32_t pins, uint32_t us)
+{
+    return ((us - STEP_OVERHEAD_US) << 8) | pins;
+}
+
+/** Spread what's left of the frame after the pulses over the steps that hold every pin low. */
+static void write_idle_steps(servopio_t *servos)
+{
+    uint32_t pulses_us = 0;
+    for (uint i = 0; i < servos->nservos; i++)
+    {
+        pulses_us += servos->widths_us[i];
+    }
+
+    const uint nidle = SERVOPIO_FRAME_STEPS - servos->nservos;
+    const uint32_t idle_us = servos->frame_us - pulses_us;
+    for (uint i = 0; i < nidle; i++)
+    {
+        // The last one takes the remainder
+        const uint32_t us = (i == (nidle - 1)) ? (idle_us - ((nidle - 1) * (idle_us / nidle))) : (idle_us / nidle);
+        servos->steps[servos->nservos + i] = make_step(0, us);
+    }
+}
+
+/** Divide the system clock down to the state machine's 1 MHz. */
+static void set_divider(uint32_t sys_hz, void *context)
+{
+    const servopio_t *servos = (const servopio_t *)context;
+
+    // In 256ths (the divider's fractional part). Exactly 125 at 125 MHz.
+    const uint32_t division_256ths = (uint32_t)((((uint64_t)sys_hz * 256U) + (SERVOPIO_TICK_HZ / 2U)) / SERVOPIO_TICK_HZ);
+    pio_sm_set_clkdiv_int_frac(servos->pio, servos->sm, (uint16_t)(division_256ths >> 8), (uint8_t)(division_256ths & 0xFFU));
+}
+
+bool servopio_init(servopio_t *servos, PIO pio, uint base_pin, uint nservos, uint32_t frame_us)
+{
+    const uint32_t longest_frame_us = (nservos * SERVOPIO_MAX_PULSE_US) + ((SERVOPIO_FRAME_STEPS - nservos) * STEP_OVERHEAD_US);
+    if ((nservos == 0) || (nservos > SERVOPIO_MAX_SERVOS) || (frame_us < longest_frame_us))
+    {
+        log_error("Can't drive %u servos with a %lu us frame\n", nservos, (unsigned long)frame_us);
+        set_errno(ERR_ID_SERVO_MODULE, EINVAL);
+        return false;
+    }
+
+    if (!pio_can_add_program(pio, &servopio_program))
+    {
+        log_error("No room for the servo program on the PIO\n");
+        set_errno(ERR_ID_SERVO_MODULE, ENOMEM);
+        return false;
+    }
+    const int sm = pio_claim_unused_sm(pio, false);
+    if (sm < 0)
+    {
+        log_error("No free PIO state machine for the servos\n");
+        set_errno(ERR_ID_SERVO_MODULE, ENOMEM);
+        return false;
+    }
+    const int channel = dma_claim_unused_channel(false);
+    if (channel < 0)
+    {
+        log_error("No free DMA channel for the servos\n");
+        set_errno(ERR_ID_SERVO_MODULE, ENOMEM);
+        pio_sm_unclaim(pio, (uint)sm);
+        return false;
+    }
+
+    servos->pio = pio;
+    servos->sm = (uint)sm;
+    servos->dma_channel = channel;
+    servos->nservos = nservos;
+    servos->frame_us = frame_us;
+    for (uint i = 0; i < nservos; i++)
+    {
+        servos->widths_us[i] = 1500;
+        servos->steps[i] = make_step(1u << i, servos->widths_us[i]);
+    }
+    write_idle_steps(servos);
+
+    // The divider is set for the clock we're at, and again whenever it changes
+    const uint offset = pio_add_program(pio, &servopio_program);
+    servopio_program_init(pio, servos->sm, offset, base_pin, nservos, 1, 0);
+    sysclock_register(&set_divider, servos);
+
+    // Round and round the frame, for as long as a 32-bit count lasts (years, at a few us a step at least)
+    dma_channel_config c = dma_channel_get_default_config((uint)channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_ring(&c, false, __builtin_ctz(sizeof(servos->steps)));
+    channel_config_set_dreq(&c, pio_get_dreq(pio, servos->sm, true));
+    dma_channel_configure((uint)channel, &c, &pio->txf[servos->sm], servos->steps, 0xFFFFFFFFu, true);
+
+    pio_sm_set_enabled(pio, servos->sm, true);
+    return true;
+}
+
+bool servopio_set_us(servopio_t *servos, uint index, uint16_t width_us)
+{
+    if ((index >= servos->nservos) || (width_us < SERVOPIO_MIN_PULSE_US) || (width_us > SERVOPIO_MAX_PULSE_US))
+    {
+        set_errno(ERR_ID_SERVO_MODULE, EINVAL);
+        return false;
+    }
+
+    // Each step is one word, so the DMA sees either its old value or its new one. The frame is
+    // off by the change for at most one time round, until the idle steps catch up.
+    servos->widths_us[index] = width_us;
+    servos->steps[index] = make_step(1u << index, width_us);
+    write_idle_steps(servos);
+    return true;
+}
+
+uint16_t servopio_get_us(const servopio_t *servos, uint index)
+{
+    return (index < servos->nservos) ? servos->widths_us[index] : 0;
+}
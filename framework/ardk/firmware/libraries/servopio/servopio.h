@@ -0,0 +1,69 @@
+/**
+ * @file servopio.h
+ * @brief Servos driven from PIO.
+ * One PIO state machine and one DMA channel pulse up to SERVOPIO_MAX_SERVOS servos, on consecutive
+ * pins, in turn, once a frame. Pulse widths are whole microseconds. Once started it needs no CPU time:
+ * setting a width just changes a word of the frame, which the DMA picks up the next time round.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/pio.h"
+
+/** The most servos one state machine drives. */
+#define SERVOPIO_MAX_SERVOS 8
+
+/** Steps in a frame: one per servo, and the rest hold every pin low. A power of two, for the DMA's ring. */
+#define SERVOPIO_FRAME_STEPS 16
+
+/** The pulse widths servos take, in us. */
+#define SERVOPIO_MIN_PULSE_US 500
+#define SERVOPIO_MAX_PULSE_US 2500
+
+/** A set of servos on one state machine. Set up with servopio_init(); the fields are the library's. */
+typedef struct {
+    uint32_t steps[SERVOPIO_FRAME_STEPS] __attribute__((aligned(SERVOPIO_FRAME_STEPS * sizeof(uint32_t))));  ///< The frame, as the DMA reads it
+    uint16_t widths_us[SERVOPIO_MAX_SERVOS];
+    PIO pio;
+    uint sm;
+    int dma_channel;
+    uint nservos;
+    uint32_t frame_us;
+} servopio_t;
+
+/**
+ * @brief Start pulsing servos, each at 1500 us (the middle of its range) to begin with.
+ *
+ * @param servos The servos. Must outlive them: the DMA reads the frame from it.
+ * @param pio The PIO block. A state machine and room for the program are claimed on it.
+ * @param base_pin The first servo's pin. The others follow it.
+ * @param nservos How many, up to SERVOPIO_MAX_SERVOS.
+ * @param frame_us How often each servo gets a pulse: 20000 for most analog servos; digital
+ *                 servos take much less. Must fit every servo's longest pulse.
+ * @return false if the arguments don't make sense or there's no state machine, program space, or
+ *         DMA channel free (and nothing is claimed).
+ */
+bool servopio_init(servopio_t *servos, PIO pio, uint base_pin, uint nservos, uint32_t frame_us);
+
+/**
+ * @brief Set a servo's pulse width. It takes effect from its next pulse.
+ *
+ * @param servos The servos.
+ * @param index Which one, from 0 (on base_pin).
+ * @param width_us SERVOPIO_MIN_PULSE_US to SERVOPIO_MAX_PULSE_US.
+ * @return false if index or width_us is out of range.
+ */
+bool servopio_set_us(servopio_t *servos, uint index, uint16_t width_us);
+
+/** A servo's pulse width, in us, or 0 if there's no such servo. */
+uint16_t servopio_get_us(const servopio_t *servos, uint index);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,323 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+// SDK includes
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+// Library includes
+#include <bytestuff.h>
+#include <errors.h>
+// Local includes
+#include "settings.h"
+
+#if SETTINGS_FLASH_SECTORS < 2
+    #error "The settings store needs at least two sectors, to compact one into the other"
+#endif
+
+/** Flash offset of the store's first sector. */
+#define SETTINGS_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - (SETTINGS_FLASH_SECTORS * FLASH_SECTOR_SIZE))
+
+/** The key of the entry that starts each sector. Its value is the sector's sequence number: higher is newer. */
+#define SETTINGS_KEY_HEADER 0xFFFE
+
+/** The key of a slot that hasn't been written. */
+#define SETTINGS_KEY_BLANK 0xFFFF
+
+/** How long we wait for the other core to stop running from flash before giving up on a write. */
+#define SETTINGS_LOCKOUT_TIMEOUT_US 100000U
+
+/** One entry, as it is in flash. */
+typedef struct {
+    uint16_t key;
+    uint16_t crc;       // CRC16 of key and value
+    uint32_t value;
+} settings_entry_t;
+
+/** Entries per sector, the header included. */
+#define SLOTS_PER_SECTOR (FLASH_SECTOR_SIZE / sizeof(settings_entry_t))
+
+/** Entries per flash page. */
+#define SLOTS_PER_PAGE (FLASH_PAGE_SIZE / sizeof(settings_entry_t))
+
+/** Which sector holds the store, or -1 if no sector has a header yet. */
+static int active_sector = -1;
+
+/** The active sector's sequence number. */
+static uint32_t active_sequence = 0;
+
+/** The first slot in the active sector that hasn't been written. */
+static uint32_t end_slot = 0;
+
+/** A page to program from. Erased flash is 0xFF, and programming 0xFF leaves a byte as it was, so it's padded with that. */
+static uint8_t page[FLASH_PAGE_SIZE];
+
+/** The entry in a slot of a sector, through XIP. */
+static inline const settings_entry_t *slot_at(int sector, uint32_t slot)
+{
+    return (const settings_entry_t *)(uintptr_t)(XIP_BASE + SETTINGS_FLASH_OFFSET + (sector * FLASH_SECTOR_SIZE) + (slot * sizeof(settings_entry_t)));
+}
+
+static uint16_t entry_crc(uint16_t key, uint32_t value)
+{
+    const uint8_t bytes[6] = {
+        (uint8_t)(key & 0xFF), (uint8_t)(key >> 8),
+        (uint8_t)(value & 0xFF), (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24),
+    };
+    return crc16_update_bytes(CRC16_INIT, bytes, sizeof(bytes));
+}
+
+/** Is this entry whole? A write cut short leaves one that isn't. */
+static inline bool entry_is_valid(const settings_entry_t *entry)
+{
+    return (entry->key != SETTINGS_KEY_BLANK) && (entry->crc == entry_crc(entry->key, entry->value));
+}
+
+/** Has nothing been written to this slot? */
+static inline bool slot_is_blank(const settings_entry_t *entry)
+{
+    return (entry->key == SETTINGS_KEY_BLANK) && (entry->crc == 0xFFFF) && (entry->value == 0xFFFFFFFF);
+}
+
+/** Does this sector start with a whole header? */
+static bool sector_header(int sector, uint32_t *sequence)
+{
+    const settings_entry_t *header = slot_at(sector, 0);
+    if ((header->key != SETTINGS_KEY_HEADER) || !entry_is_valid(header))
+    {
+        return false;
+    }
+    *sequence = header->value;
+    return true;
+}
+
+/** Stop everything that might run from flash. */
+static uint32_t flash_begin(bool *ok)
+{
+#if SETTINGS_PAUSE_OTHER_CORE
+    *ok = multicore_lockout_start_timeout_us(SETTINGS_LOCKOUT_TIMEOUT_US);
+#else
+    *ok = true;
+#endif // SETTINGS_PAUSE_OTHER_CORE
+    return *ok ? save_and_disable_interrupts() : 0;
+}
+
+/** Let it all run again. */
+static void flash_end(uint32_t interrupts)
+{
+    restore_interrupts(interrupts);
+#if SETTINGS_PAUSE_OTHER_CORE
+    multicore_lockout_end_timeout_us(SETTINGS_LOCKOUT_TIMEOUT_US);
+#endif // SETTINGS_PAUSE_OTHER_CORE
+}
+
+/** Erase a sector of the store. */
+static bool erase_sector(int sector)
+{
+    bool ok;
+    const uint32_t interrupts = flash_begin(&ok);
+    if (!ok)
+    {
+        return false;
+    }
+    flash_range_erase(SETTINGS_FLASH_OFFSET + (sector * FLASH_SECTOR_SIZE), FLASH_SECTOR_SIZE);
+    flash_end(interrupts);
+    return true;
+}
+
+/** Program `page` into the page of a sector that holds `slot`. */
+static bool program_page(int sector, uint32_t slot)
+{
+    const uint32_t offset = SETTINGS_FLASH_OFFSET + (sector * FLASH_SECTOR_SIZE) + ((slot / SLOTS_PER_PAGE) * FLASH_PAGE_SIZE);
+    bool ok;
+    const uint32_t interrupts = flash_begin(&ok);
+    if (!ok)
+    {
+        return false;
+    }
+    flash_range_program(offset, page, sizeof(page));
+    flash_end(interrupts);
+    return true;
+}
+
+/** Put an entry into `page`, where it goes for `slot`. */
+static void page_put(uint32_t slot, uint16_t key, uint32_t value)
+{
+    const settings_entry_t entry = {.key = key, .crc = entry_crc(key, value), .value = value};
+    memcpy(&page[(slot % SLOTS_PER_PAGE) * sizeof(entry)], &entry, sizeof(entry));
+}
+
+/** Write one entry into a slot that is blank. */
+static bool write_entry(int sector, uint32_t slot, uint16_t key, uint32_t value)
+{
+    memset(page, 0xFF, sizeof(page));
+    page_put(slot, key, value);
+    if (!program_page(sector, slot))
+    {
+        return false;
+    }
+    const settings_entry_t *entry = slot_at(sector, slot);
+    return (entry->key == key) && (entry->value == value) && entry_is_valid(entry);
+}
+
+/** The newest whole entry for a key in the active sector, at or after slot `from`, if there is one. */
+static const settings_entry_t *find_newest(uint16_t key, uint32_t from)
+{
+    if (active_sector < 0)
+    {
+        return NULL;
+    }
+    for (uint32_t slot = end_slot; slot > from; slot--)
+    {
+        const settings_entry_t *entry = slot_at(active_sector, slot - 1);
+        if ((entry->key == key) && entry_is_valid(entry))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Copy the newest entry for each key into the next sector, then give it a header, which makes it the
+ * active one. Until that header is written, the sector we're copying from is still the store.
+ */
+static bool compact(void)
+{
+    const int next = (active_sector < 0) ? 0 : ((active_sector + 1) % SETTINGS_FLASH_SECTORS);
+    if (!erase_sector(next))
+    {
+        return false;
+    }
+
+    uint32_t next_slot = 1;
+    memset(page, 0xFF, sizeof(page));
+    for (uint32_t slot = 1; (active_sector >= 0) && (slot < end_slot); slot++)
+    {
+        const settings_entry_t *entry = slot_at(active_sector, slot);
+        if (!entry_is_valid(entry) || (find_newest(entry->key, slot + 1) != NULL))
+        {
+            // Cut short, or not the newest
+            continue;
+        }
+
+        page_put(next_slot, entry->key, entry->value);
+        next_slot++;
+        if ((next_slot % SLOTS_PER_PAGE) == 0)
+        {
+            if (!program_page(next, next_slot - 1))
+            {
+                return false;
+            }
+            memset(page, 0xFF, sizeof(page));
+        }
+    }
+    if (((next_slot % SLOTS_PER_PAGE) != 0) && !program_page(next, next_slot))
+    {
+        return false;
+    }
+
+    const uint32_t sequence = (active_sector < 0) ? 0 : (active_sequence + 1);
+    if (!write_entry(next, 0, SETTINGS_KEY_HEADER, sequence))
+    {
+        return false;
+    }
+
+    active_sector = next;
+    active_sequence = sequence;
+    end_slot = next_slot;
+    log_info("Settings compacted into sector %d (%u entries)\n", next, (unsigned)(next_slot - 1));
+    return true;
+}
+
+void settings_init(void)
+{
+    // The sector with the newest whole header is the store
+    active_sector = -1;
+    for (int sector = 0; sector < SETTINGS_FLASH_SECTORS; sector++)
+    {
+        uint32_t sequence;
+        if (sector_header(sector, &sequence) && ((active_sector < 0) || ((int32_t)(sequence - active_sequence) > 0)))
+        {
+            active_sector = sector;
+            active_sequence = sequence;
+        }
+    }
+
+    // Entries are only ever appended, so it ends at the first blank slot
+    end_slot = SLOTS_PER_SECTOR;
+    for (uint32_t slot = 1; (active_sector >= 0) && (slot < SLOTS_PER_SECTOR); slot++)
+    {
+        if (slot_is_blank(slot_at(active_sector, slot)))
+        {
+            end_slot = slot;
+            break;
+        }
+    }
+}
+
+bool settings_get(uint16_t key, uint32_t *value)
+{
+    const settings_entry_t *entry = find_newest(key, 1);
+    if (entry == NULL)
+    {
+        return false;
+    }
+    *value = entry->value;
+    return true;
+}
+
+uint32_t settings_get_or(uint16_t key, uint32_t fallback)
+{
+    uint32_t value;
+    return settings_get(key, &value) ? value : fallback;
+}
+
+bool settings_set(uint16_t key, uint32_t value)
+{
+    if (key >= SETTINGS_KEY_RESERVED)
+    {
+        log_error("Setting 0x%04X is reserved\n", key);
+        set_errno(ERR_ID_SETTINGS_MODULE, EINVAL);
+        return false;
+    }
+
+    uint32_t current;
+    if (settings_get(key, &current) && (current == value))
+    {
+        return true;
+    }
+
+    // A new store, or a full one, starts over in the next sector with just the newest entries
+    if ((active_sector < 0) || (end_slot >= SLOTS_PER_SECTOR))
+    {
+        if (!compact())
+        {
+            log_error("Could not compact the settings store\n");
+            set_errno(ERR_ID_SETTINGS_MODULE, EIO);
+            return false;
+        }
+        if (end_slot >= SLOTS_PER_SECTOR)
+        {
+            log_error("Settings store is full\n");
+            set_errno(ERR_ID_SETTINGS_MODULE, ENOMEM);
+            return false;
+        }
+    }
+
+    const bool written = write_entry(active_sector, end_slot, key, value);
+    if (!slot_is_blank(slot_at(active_sector, end_slot)))
+    {
+        // Even a write that didn't take uses up the slot, if it changed it at all
+        end_slot++;
+    }
+    if (!written)
+    {
+        log_error("Setting 0x%04X did not save\n", key);
+        set_errno(ERR_ID_SETTINGS_MODULE, EIO);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file settings.h
+ * @brief A small store of settings (16-bit keys, 32-bit values) in flash, so a unit can be tuned
+ * without a rebuild.
+ *
+ * The store is a log: setting a key appends an entry, and the newest entry for a key is its value.
+ * Reads look the key up in flash where it is (through XIP), newest entry first, so nothing is
+ * copied into RAM at boot. When a sector fills up, the newest entry for each key is copied into
+ * the next sector, round-robin over SETTINGS_FLASH_SECTORS sectors, which spreads the erases
+ * across them. Each entry carries a CRC16, and a sector only takes over once all of it is written,
+ * so a power cut at any point leaves either the old value or the new one.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SETTINGS_FLASH_SECTORS
+    /** How many flash sectors the store takes, at the very end of flash. At least two. */
+    #define SETTINGS_FLASH_SECTORS 2
+#endif // SETTINGS_FLASH_SECTORS
+
+#ifndef SETTINGS_PAUSE_OTHER_CORE
+    /**
+     * Park the other core (with multicore_lockout) while flash is written, for firmware that runs
+     * code from flash on both cores. The other core must have called multicore_lockout_victim_init().
+     */
+    #define SETTINGS_PAUSE_OTHER_CORE 0
+#endif // SETTINGS_PAUSE_OTHER_CORE
+
+/** Keys from here up are the library's own. */
+#define SETTINGS_KEY_RESERVED 0xFF00
+
+/**
+ * @brief Find the store in flash. Call once, before anything else here.
+ * Only reads flash, so it's cheap enough to call first thing in main().
+ */
+void settings_init(void);
+
+/**
+ * @brief Get a setting.
+ *
+ * @param key Which one.
+ * @param value Gets its value, if it has one.
+ * @return false if it was never set.
+ */
+bool settings_get(uint16_t key, uint32_t *value);
+
+/** Get a setting, or `fallback` if it was never set. */
+uint32_t settings_get_or(uint16_t key, uint32_t fallback);
+
+/**
+ * @brief Set a setting. Does nothing (and writes nothing) if it already has this value.
+ * Not from an IRQ: flash is out of reach, and interrupts are off, while it is written
+ * (tens of ms if a sector has to be erased).
+ *
+ * @param key Which one. Not SETTINGS_KEY_RESERVED or above.
+ * @param value Its new value.
+ * @return false if it wasn't saved. Sets errno.
+ */
+bool settings_set(uint16_t key, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
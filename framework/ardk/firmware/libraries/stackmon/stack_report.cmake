@@ -0,0 +1,53 @@
+# Print the functions that take the most stack, from the .su files a build with -fstack-usage leaves
+# next to its objects. Each is one function's own frame; what it calls comes on top.
+#
+# cmake -DDIR=<a target's object directory> [-DTOP=<how many>] -P stack_report.cmake
+if (NOT DEFINED TOP)
+  set(TOP 15)
+endif()
+
+file(GLOB_RECURSE SU_FILES "${DIR}/*.su")
+if (NOT SU_FILES)
+  message("No stack usage files under ${DIR}; build with -fstack-usage")
+  return()
+endif()
+
+# Each line is: file:line:column:function<TAB>bytes<TAB>static, dynamic, or dynamic,bounded.
+# Sort on the size, zero padded, so the deepest come first.
+set(ENTRIES "")
+set(DYNAMIC "")
+foreach(SU_FILE ${SU_FILES})
+  file(STRINGS ${SU_FILE} LINES)
+  foreach(LINE ${LINES})
+    if (LINE MATCHES "^.*:([^:\t]+)\t([0-9]+)\t(.*)$")
+      set(FUNCTION ${CMAKE_MATCH_1})
+      set(SIZE ${CMAKE_MATCH_2})
+      set(QUALIFIER ${CMAKE_MATCH_3})
+      string(LENGTH "${SIZE}" DIGITS)
+      math(EXPR PAD "8 - ${DIGITS}")
+      string(REPEAT "0" ${PAD} ZEROS)
+      list(APPEND ENTRIES "${ZEROS}${SIZE} ${FUNCTION}")
+      if (QUALIFIER STREQUAL "dynamic")
+        list(APPEND DYNAMIC ${FUNCTION})
+      endif()
+    endif()
+  endforeach()
+endforeach()
+
+list(SORT ENTRIES ORDER DESCENDING)
+list(LENGTH ENTRIES COUNT)
+if (COUNT GREATER TOP)
+  list(SUBLIST ENTRIES 0 ${TOP} ENTRIES)
+endif()
+
+message("Largest stack frames (bytes):")
+foreach(ENTRY ${ENTRIES})
+  string(REGEX MATCH "^0*([0-9]+) (.*)$" MATCHED "${ENTRY}")
+  string(SUBSTRING "${CMAKE_MATCH_1}        " 0 8 SIZE)
+  message("  ${SIZE}${CMAKE_MATCH_2}")
+endforeach()
+if (DYNAMIC)
+  list(REMOVE_DUPLICATES DYNAMIC)
+  string(REPLACE ";" ", " DYNAMIC "${DYNAMIC}")
+  message("Unbounded frames (alloca or variable-length arrays): ${DYNAMIC}")
+endif()
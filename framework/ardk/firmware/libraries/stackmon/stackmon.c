@@ -0,0 +1,78 @@
+// Stdlib includes
+#include <stdint.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/platform.h"
+// Local includes
+#include "stackmon.h"
+
+/** Bytes left unpainted below the stack pointer, for paint()'s frame. The stack grows down. */
+#define PAINT_MARGIN 64
+
+/**
+ * The stacks' bounds, from the SDK's linker script. Core 0's is in SCRATCH_Y, and core 1's,
+ * which multicore_launch_core1() runs on, is in SCRATCH_X.
+ */
+extern uint32_t __StackBottom[], __StackTop[], __StackOneBottom[], __StackOneTop[];
+
+static uint32_t *stack_bottom(uint core)
+{
+    return (core == 0) ? __StackBottom : __StackOneBottom;
+}
+
+static uint32_t *stack_top(uint core)
+{
+    return (core == 0) ? __StackTop : __StackOneTop;
+}
+
+static void paint(uint32_t *from, uint32_t *to)
+{
+    for (volatile uint32_t *word = from; word < to; word++)
+    {
+        *word = STACKMON_CANARY;
+    }
+}
+
+void stackmon_init(void)
+{
+    // Core 1 hasn't started, so nothing is on its stack
+    paint(__StackOneBottom, __StackOneTop);
+
+    // Nothing on ours below this frame either, unless an interrupt comes in while we paint
+    const uint32_t saved = save_and_disable_interrupts();
+    uint8_t *sp;
+    __asm volatile ("mov %0, sp" : "=r"(sp));
+    paint(__StackBottom, (uint32_t *)(sp - PAINT_MARGIN));
+    restore_interrupts(saved);
+}
+
+size_t stackmon_size(uint core)
+{
+    return (size_t)((uint8_t *)stack_top(core) - (uint8_t *)stack_bottom(core));
+}
+
+size_t stackmon_used(uint core)
+{
+    const uint32_t *word = stack_bottom(core);
+    const uint32_t *const top = stack_top(core);
+    while ((word < top) && (*word == STACKMON_CANARY))
+    {
+        word++;
+    }
+    return (size_t)((const uint8_t *)top - (const uint8_t *)word);
+}
+
+size_t stackmon_pack(uint8_t *buf, size_t len)
+{
+    size_t pos = 0;
+    for (uint core = 0; (core < NUM_CORES) && ((len - pos) >= 4); core++)
+    {
+        const size_t size = stackmon_size(core);
+        const size_t used = stackmon_used(core);
+        buf[pos++] = (uint8_t)(size & 0xFF);
+        buf[pos++] = (uint8_t)(size >> 8);
+        buf[pos++] = (uint8_t)(used & 0xFF);
+        buf[pos++] = (uint8_t)(used >> 8);
+    }
+    return pos;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file stackmon.h
+ * @brief Stack watermarks.
+ * Fills the unused part of each core's stack with a known word at boot, so how deep each
+ * stack has ever gone can be read back later: the lowest word that isn't that any more.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/platform.h"
+
+/** What the unused stack is filled with. */
+#define STACKMON_CANARY 0xA5C3E1F0u
+
+/**
+ * @brief Fill core 0's stack below the caller's frame, and all of core 1's, with the canary.
+ * Call first thing in main() on core 0, before core 1 is launched.
+ */
+void stackmon_init(void);
+
+/** Size of a core's stack in bytes. */
+size_t stackmon_size(uint core);
+
+/**
+ * @brief The most of a core's stack that has been used since stackmon_init(), in bytes.
+ * Only as deep as was written to: a frame that reserved space it never wrote isn't counted.
+ * The whole stack means it has (probably) overflowed.
+ */
+size_t stackmon_used(uint core);
+
+/**
+ * @brief Pack each core's stack size and the most of it used for the command bus.
+ * Layout: for core 0, then core 1: size (2 bytes), most used (2 bytes), little-endian.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. At least 4 * NUM_CORES for both.
+ * @return size_t Number of bytes written.
+ */
+size_t stackmon_pack(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,126 @@
+// Stdlib includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+// SDK includes
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/scb.h"
+#include "hardware/vreg.h"
+// Library includes
+#include <errors.h>
+// Local includes
+#include "sysclock.h"
+
+/** How long to give the regulator to settle at a new voltage before the clock relies on it. */
+#define VREG_SETTLE_US 1000
+
+/** A profile: its clock, and the core voltage it runs at. */
+typedef struct {
+    sysclock_mhz_t mhz;
+    enum vreg_voltage voltage;
+} profile_t;
+
+static const profile_t PROFILES[] = {
+    { SYSCLOCK_125_MHZ, VREG_VOLTAGE_1_10 },
+    { SYSCLOCK_200_MHZ, VREG_VOLTAGE_1_15 },
+    { SYSCLOCK_250_MHZ, VREG_VOLTAGE_1_20 },
+};
+
+/** A registered hook, and what to pass it. */
+typedef struct {
+    sysclock_hook_t hook;
+    void *context;
+} hook_entry_t;
+
+static hook_entry_t hooks[SYSCLOCK_MAX_HOOKS];
+static size_t nhooks = 0;
+
+/** Where we are. The SDK's runtime init leaves us at the default. */
+static const profile_t *current = &PROFILES[0];
+
+bool sysclock_register(sysclock_hook_t hook, void *context)
+{
+    hook(clock_get_hz(clk_sys), context);
+    if (nhooks >= SYSCLOCK_MAX_HOOKS)
+    {
+        log_error("No room for another clock hook; it won't follow profile changes.\n");
+        return false;
+    }
+    hooks[nhooks++] = (hook_entry_t){ .hook = hook, .context = context };
+    return true;
+}
+
+bool sysclock_set(uint32_t mhz)
+{
+    const profile_t *profile = NULL;
+    for (size_t i = 0; i < (sizeof(PROFILES) / sizeof(PROFILES[0])); i++)
+    {
+        if ((uint32_t)PROFILES[i].mhz == mhz)
+        {
+            profile = &PROFILES[i];
+        }
+    }
+    if (profile == NULL)
+    {
+        log_error("No clock profile for %lu MHz\n", (unsigned long)mhz);
+        return false;
+    }
+    if (profile == current)
+    {
+        return true;
+    }
+
+    const bool faster = profile->mhz > current->mhz;
+    if (faster)
+    {
+        vreg_set_voltage(profile->voltage);
+        busy_wait_us(VREG_SETTLE_US);
+    }
+    if (!set_sys_clock_khz((uint32_t)profile->mhz * 1000U, false))
+    {
+        log_error("Could not set the system clock to %lu MHz\n", (unsigned long)mhz);
+        vreg_set_voltage(current->voltage);
+        return false;
+    }
+    if (!faster)
+    {
+        vreg_set_voltage(profile->voltage);
+    }
+    current = profile;
+
+    // set_sys_clock_khz() moved clk_peri along with clk_sys, so SPI needs its dividers again too
+    const uint32_t sys_hz = clock_get_hz(clk_sys);
+    for (size_t i = 0; i < nhooks; i++)
+    {
+        hooks[i].hook(sys_hz, hooks[i].context);
+    }
+    log_info("System clock at %lu MHz\n", (unsigned long)mhz);
+    return true;
+}
+
+sysclock_mhz_t sysclock_get(void)
+{
+    return current->mhz;
+}
+
+void sysclock_deep_sleep_init(void)
+{
+    // SCR is each core's own, so this only covers the one we're on. It has no atomic aliases.
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+}
+
+void sysclock_sleep_gate(uint32_t en0, uint32_t en1, bool gated)
+{
+    // The atomic aliases, so two modules (or cores) gating their own clocks don't undo each other
+    if (gated)
+    {
+        hw_clear_bits(&clocks_hw->sleep_en0, en0);
+        hw_clear_bits(&clocks_hw->sleep_en1, en1);
+    }
+    else
+    {
+        hw_set_bits(&clocks_hw->sleep_en0, en0);
+        hw_set_bits(&clocks_hw->sleep_en1, en1);
+    }
+}
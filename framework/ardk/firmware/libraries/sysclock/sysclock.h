@@ -0,0 +1,87 @@
+/**
+ * @file sysclock.h
+ * @brief System clock profiles. Each profile is a system clock and the core voltage it needs.
+ * Every module whose timing is derived from clk_sys (PWM and PIO dividers, SPI and I2C rates)
+ * registers a hook that derives it. The hook runs once when it is registered and again each
+ * time the profile changes, so a module works out its dividers in one place, whatever the clock.
+ *
+ * The timer (and so alarms, sleeps, and time_us_32()) and USB run from their own clocks, and
+ * aren't affected.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** The profiles, by system clock. */
+typedef enum {
+    SYSCLOCK_125_MHZ = 125,     ///< The SDK's default, at the default 1.10 V
+    SYSCLOCK_200_MHZ = 200,     ///< At 1.15 V
+    SYSCLOCK_250_MHZ = 250,     ///< At 1.20 V. Flash runs at half this (PICO_FLASH_SPI_CLKDIV 2), within its 133 MHz.
+} sysclock_mhz_t;
+
+#ifndef SYSCLOCK_MHZ
+    /** The profile a firmware switches to at boot, unless it has a setting saying otherwise. */
+    #define SYSCLOCK_MHZ SYSCLOCK_125_MHZ
+#endif // SYSCLOCK_MHZ
+
+#ifndef SYSCLOCK_MAX_HOOKS
+    /** Most hooks that can be registered. */
+    #define SYSCLOCK_MAX_HOOKS 8
+#endif // SYSCLOCK_MAX_HOOKS
+
+/**
+ * A module's hook: set up whatever it derives from clk_sys for a clock of sys_hz. context is what
+ * it was registered with. Runs on whichever core registered it or changed the profile, in the
+ * order the hooks were registered.
+ */
+typedef void (*sysclock_hook_t)(uint32_t sys_hz, void *context);
+
+/**
+ * @brief Register a hook, and run it straight away for the clock we're at.
+ * Call it from a module's init, in place of working out its dividers there.
+ *
+ * @return false (and logs) if there are already SYSCLOCK_MAX_HOOKS. The hook still runs once.
+ */
+bool sysclock_register(sysclock_hook_t hook, void *context);
+
+/**
+ * @brief Switch to a profile: raise the voltage before the clock, or lower the clock before the
+ * voltage, then run every hook. Peripherals run at the wrong rate between the switch and their
+ * hook, so do it at boot, before anything is moving, or while the buses are quiet.
+ * Call from core 0, with core 1 not using any of the peripherals the hooks reconfigure.
+ *
+ * @param mhz One of sysclock_mhz_t.
+ * @return false (and logs) if it isn't one, or the clock couldn't be set, in which case nothing changed.
+ */
+bool sysclock_set(uint32_t mhz);
+
+/** The profile we're at. */
+sysclock_mhz_t sysclock_get(void);
+
+/**
+ * @brief Make the calling core's sleeps (`__wfe()`, `__wfi()`) deep sleeps. Once both cores are in one,
+ * the clocks gated with sysclock_sleep_gate() stop until either wakes. Nothing else changes: a core
+ * still wakes on an event or an interrupt, and the crystal, PLLs, and timer keep running. Call once
+ * from each core, at boot.
+ */
+void sysclock_deep_sleep_init(void);
+
+/**
+ * @brief Have peripheral clocks stop, or not, while both cores are in deep sleep. Each module gates
+ * only the peripherals it owns, and only while they're quiet; the others' bits are left alone, so
+ * either core can call it.
+ *
+ * @param en0 CLOCKS_SLEEP_EN0_ bits of the clocks.
+ * @param en1 CLOCKS_SLEEP_EN1_ bits of the clocks.
+ * @param gated true to stop them in deep sleep, false to keep them running.
+ */
+void sysclock_sleep_gate(uint32_t en0, uint32_t en1, bool gated);
+
+#ifdef __cplusplus
+}
+#endif
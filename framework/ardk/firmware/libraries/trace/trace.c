@@ -0,0 +1,197 @@
+// Stdlib includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+// SDK includes
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// Library includes
+#include <hotpaths.h>
+// Local includes
+#include "trace.h"
+
+#if (TRACE_BUFFER_LEN & (TRACE_BUFFER_LEN - 1)) != 0
+    #error "TRACE_BUFFER_LEN must be a power of two"
+#endif
+
+/** Names of the events in trace_dump()'s output, by trace_id_t. */
+static const char *const TRACE_NAMES[NUM_TRACE_IDS] = {
+    [TRACE_ID_I2C_ISR] = "i2c_isr",
+    [TRACE_ID_CMD_DISPATCH] = "cmd_dispatch",
+    [TRACE_ID_GRAPHICS_CMD] = "graphics_cmd",
+    [TRACE_ID_SERVO_CMD] = "servo_cmd",
+    [TRACE_ID_SENSOR_READ_IMU] = "sensor_read_imu",
+    [TRACE_ID_SENSOR_READ_TEMP] = "sensor_read_temp",
+    [TRACE_ID_RENDER_FRAME] = "render_frame",
+    [TRACE_ID_LCD_FLUSH] = "lcd_flush",
+};
+
+#if TRACE_ENABLED
+/** The ring buffer. head and tail are free-running counts of events written and taken out. */
+static trace_event_t events[TRACE_BUFFER_LEN];
+static uint32_t events_head = 0;
+static uint32_t events_tail = 0;
+
+/** Events overwritten before anyone took them out. */
+static uint32_t events_dropped = 0;
+
+/** Guards the ring buffer against the other core (and, since it masks them, our own IRQs). NULL until trace_init(). */
+static spin_lock_t *events_lock = NULL;
+
+void trace_init(void)
+{
+    events_lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+void HOT_FUNC(trace_record)(trace_id_t id, uint8_t flags, uint16_t arg)
+{
+    if (events_lock == NULL)
+    {
+        return;
+    }
+
+    if (get_core_num() == 1)
+    {
+        flags |= TRACE_FLAG_CORE1;
+    }
+
+    uint32_t saved = spin_lock_blocking(events_lock);
+    trace_event_t *e = &events[events_head & (TRACE_BUFFER_LEN - 1)];
+    e->timestamp_us = time_us_32();
+    e->id = (uint8_t)id;
+    e->flags = flags;
+    e->arg = arg;
+    events_head++;
+    if ((events_head - events_tail) > TRACE_BUFFER_LEN)
+    {
+        // Overwrote the oldest one
+        events_tail++;
+        events_dropped++;
+    }
+    spin_unlock(events_lock, saved);
+}
+
+/** Take the oldest event out of the buffer. Returns false if there aren't any. */
+static bool take_event(trace_event_t *e)
+{
+    if (events_lock == NULL)
+    {
+        return false;
+    }
+
+    uint32_t saved = spin_lock_blocking(events_lock);
+    const bool available = events_head != events_tail;
+    if (available)
+    {
+        *e = events[events_tail & (TRACE_BUFFER_LEN - 1)];
+        events_tail++;
+    }
+    spin_unlock(events_lock, saved);
+    return available;
+}
+
+/** How many events were overwritten since the last call? */
+static uint32_t take_dropped(void)
+{
+    if (events_lock == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t saved = spin_lock_blocking(events_lock);
+    const uint32_t dropped = events_dropped;
+    events_dropped = 0;
+    spin_unlock(events_lock, saved);
+    return dropped;
+}
+#else
+void trace_init(void)
+{
+}
+
+void trace_record(trace_id_t id, uint8_t flags, uint16_t arg)
+{
+}
+
+static bool take_event(trace_event_t *e)
+{
+    return false;
+}
+
+static uint32_t take_dropped(void)
+{
+    return 0;
+}
+#endif // TRACE_ENABLED
+
+#if TRACE_PROBES_ENABLED
+/** Each probe's GPIO as a mask, by trace_probe_t. Zero (so toggling does nothing) until trace_probes_init(). */
+static uint32_t probe_masks[NUM_TRACE_PROBES];
+
+void trace_probes_init(const unsigned int pins[NUM_TRACE_PROBES])
+{
+    for (size_t i = 0; i < NUM_TRACE_PROBES; i++)
+    {
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_OUT);
+        gpio_put(pins[i], false);
+        probe_masks[i] = 1u << pins[i];
+    }
+}
+
+void HOT_FUNC(trace_probe_toggle)(trace_probe_t probe)
+{
+    // Each core has its own SIO toggle register, so no lock is needed
+    gpio_xor_mask(probe_masks[probe]);
+}
+#else
+void trace_probes_init(const unsigned int pins[NUM_TRACE_PROBES])
+{
+}
+
+void trace_probe_toggle(trace_probe_t probe)
+{
+}
+#endif // TRACE_PROBES_ENABLED
+
+size_t trace_pack(uint8_t *buf, size_t len)
+{
+    if (len < 2)
+    {
+        return 0;
+    }
+
+    const uint32_t dropped = take_dropped();
+    uint8_t count = 0;
+    size_t pos = 2;
+    trace_event_t e;
+    while (((pos + TRACE_PACKED_EVENT_LEN) <= len) && take_event(&e))
+    {
+        buf[pos++] = (uint8_t)(e.timestamp_us & 0xFF);
+        buf[pos++] = (uint8_t)((e.timestamp_us >> 8) & 0xFF);
+        buf[pos++] = (uint8_t)((e.timestamp_us >> 16) & 0xFF);
+        buf[pos++] = (uint8_t)((e.timestamp_us >> 24) & 0xFF);
+        buf[pos++] = e.id;
+        buf[pos++] = e.flags;
+        buf[pos++] = (uint8_t)(e.arg & 0xFF);
+        buf[pos++] = (uint8_t)(e.arg >> 8);
+        count++;
+    }
+    buf[0] = count;
+    buf[1] = (dropped > 0xFF) ? 0xFF : (uint8_t)dropped;
+    return pos;
+}
+
+void trace_dump(void)
+{
+    printf("# trace begin: enabled=%u dropped=%lu\n", TRACE_ENABLED, (unsigned long)take_dropped());
+    printf("timestamp_us,core,event,phase,arg\n");
+    trace_event_t e;
+    while (take_event(&e))
+    {
+        const char *name = (e.id < NUM_TRACE_IDS) ? TRACE_NAMES[e.id] : "unknown";
+        printf("%lu,%u,%s,%s,%u\n", (unsigned long)e.timestamp_us, (e.flags & TRACE_FLAG_CORE1) ? 1u : 0u,
+               name, (e.flags & TRACE_FLAG_END) ? "end" : "begin", e.arg);
+    }
+    printf("# trace end\n");
+}
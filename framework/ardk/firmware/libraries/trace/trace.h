@@ -0,0 +1,138 @@
+/**
+ * @file trace.h
+ * @brief Trace module.
+ * Records when the firmware's subsystems start and finish their work into a RAM
+ * ring buffer, so we can see where the time goes on the MCUs.
+ *
+ * Compiled out (the macros expand to nothing) unless built with TRACE_ENABLED.
+ *
+ * Separately, built with TRACE_PROBES_ENABLED, a few points on a command's way to
+ * the LCD each toggle a GPIO, so a logic analyzer (or the controller) can time them.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef TRACE_ENABLED
+    #define TRACE_ENABLED 0
+#endif // TRACE_ENABLED
+
+#ifndef TRACE_BUFFER_LEN
+    /** Number of events the ring buffer holds. Must be a power of two. Once full, the oldest are overwritten. */
+    #define TRACE_BUFFER_LEN 256
+#endif // TRACE_BUFFER_LEN
+
+#ifndef TRACE_PROBES_ENABLED
+    #define TRACE_PROBES_ENABLED 0
+#endif // TRACE_PROBES_ENABLED
+
+/** What an event is about. */
+typedef enum {
+    TRACE_ID_I2C_ISR = 0,       ///< Command bus interrupt (arg: i2c_slave_event_t)
+    TRACE_ID_CMD_DISPATCH,      ///< main() acting on one command (arg: the command)
+    TRACE_ID_GRAPHICS_CMD,      ///< graphics_cmd() (arg: the command)
+    TRACE_ID_SERVO_CMD,         ///< servo_cmd() (arg: the command)
+    TRACE_ID_SENSOR_READ_IMU,   ///< Draining the IMU FIFO, until the samples are in (end arg: number of samples)
+    TRACE_ID_SENSOR_READ_TEMP,  ///< Reading the environment sensor, until the values are in
+    TRACE_ID_RENDER_FRAME,      ///< One frame of the graphics core's render loop
+    TRACE_ID_LCD_FLUSH,         ///< Sending a frame to the LCD, until the transfer has started
+    NUM_TRACE_IDS
+} trace_id_t;
+
+/** Points on a command's way to the LCD that each toggle a GPIO (see trace_probes_init()). */
+typedef enum {
+    TRACE_PROBE_CMD_RECEIVED = 0,   ///< The command bus handed a frame of commands to the main loop
+    TRACE_PROBE_CMD_DISPATCH,       ///< main() is about to act on one command
+    TRACE_PROBE_RENDER_START,       ///< The graphics core starts a frame
+    TRACE_PROBE_FLUSH_END,          ///< That frame has been clocked out to the LCD
+    NUM_TRACE_PROBES
+} trace_probe_t;
+
+/** Set in trace_event_t.flags for the end of a span (otherwise it is the beginning). */
+#define TRACE_FLAG_END      0x01
+
+/** Set in trace_event_t.flags if the event happened on core 1. */
+#define TRACE_FLAG_CORE1    0x02
+
+/** One recorded event. */
+typedef struct {
+    uint32_t timestamp_us;  ///< time_us_32() when it happened. The timer is shared, so both cores' events line up.
+    uint8_t id;             ///< trace_id_t
+    uint8_t flags;          ///< TRACE_FLAG_*
+    uint16_t arg;           ///< Depends on the id
+} trace_event_t;
+
+/** Size of each event packed by trace_pack(). */
+#define TRACE_PACKED_EVENT_LEN 8
+
+#if TRACE_ENABLED
+    /** Record the start of a span of work. */
+    #define TRACE_BEGIN(id, arg) trace_record((id), 0, (uint16_t)(arg))
+
+    /** Record the end of a span of work. */
+    #define TRACE_END(id, arg) trace_record((id), TRACE_FLAG_END, (uint16_t)(arg))
+#else
+    #define TRACE_BEGIN(id, arg) ((void)0)
+    #define TRACE_END(id, arg) ((void)0)
+#endif // TRACE_ENABLED
+
+#if TRACE_PROBES_ENABLED
+    /** Toggle a probe's GPIO. Each edge is one event. */
+    #define TRACE_PROBE(probe) trace_probe_toggle(probe)
+#else
+    #define TRACE_PROBE(probe) ((void)0)
+#endif // TRACE_PROBES_ENABLED
+
+/**
+ * @brief Initialize the trace module. Events recorded before this are dropped.
+ * Safe to call when tracing is compiled out.
+ */
+void trace_init(void);
+
+/**
+ * @brief Record an event. Use TRACE_BEGIN/TRACE_END instead, so it compiles out.
+ * Safe from either core and from IRQs.
+ */
+void trace_record(trace_id_t id, uint8_t flags, uint16_t arg);
+
+/**
+ * @brief Make the probes' GPIOs outputs, starting low.
+ * Does nothing unless built with TRACE_PROBES_ENABLED.
+ *
+ * @param pins Each probe's GPIO, by trace_probe_t.
+ */
+void trace_probes_init(const unsigned int pins[NUM_TRACE_PROBES]);
+
+/**
+ * @brief Toggle a probe's GPIO. Use TRACE_PROBE() instead, so it compiles out.
+ * Safe from either core and from IRQs.
+ */
+void trace_probe_toggle(trace_probe_t probe);
+
+/**
+ * @brief Take the oldest events out of the buffer and pack them for the command bus.
+ * Layout: number of events (1 byte), events lost to overwriting since the last
+ * call (1 byte, saturating), then each event as timestamp_us (4 bytes), id, flags, arg (2 bytes),
+ * all little-endian.
+ *
+ * @param buf Where to put them.
+ * @param len Size of buf. Fits (len - 2) / TRACE_PACKED_EVENT_LEN events.
+ * @return size_t Number of bytes written.
+ */
+size_t trace_pack(uint8_t *buf, size_t len);
+
+/**
+ * @brief Take every event out of the buffer and print it over stdio as CSV,
+ * between a "# trace begin" and a "# trace end" line.
+ */
+void trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
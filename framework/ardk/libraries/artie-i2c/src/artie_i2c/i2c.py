@@ -5,11 +5,21 @@ or with simulating one for development purposes.
 from . import metrics
 from artie_util import artie_logging as alog
 from artie_util import util
+from concurrent.futures import Future
+import dataclasses
+import queue
 import smbus2
+import threading
 
 # The I2C bus
 bus = None
 
+# The rate (in Hz) we assume an I2C instance runs at if we can't find out
+DEFAULT_BUS_SPEED_HZ = 100_000
+
+# Rates (in Hz) that Artie's I2C targets support
+SUPPORTED_BUS_SPEEDS_HZ = (100_000, 400_000, 1_000_000)
+
 def public_i2c_function(func):
     """
     Initializes the i2c bus if not already initialized.
@@ -22,6 +32,39 @@ def public_i2c_function(func):
         return func(*args, **kwargs)
     return modified_function
 
+# Most messages the kernel takes in one I2C_RDWR call (I2C_RDWR_IOCTL_MAX_MSGS)
+I2C_RDWR_MAX_MSGS = 42
+
+@dataclasses.dataclass
+class Write:
+    """A message of a transfer (see `transfer()`): write `data` (bytes, or a list of ints) to `address`."""
+    address: int
+    data: bytes|list
+
+@dataclasses.dataclass
+class Read:
+    """A message of a transfer (see `transfer()`): read `nbytes` from `address`."""
+    address: int
+    nbytes: int
+
+def _as_bytes(data) -> bytes:
+    """
+    The data to write, as bytes. Raises a ValueError if there isn't any, or if a
+    value can't be interpreted as a single, unsigned byte.
+    """
+    if isinstance(data, int):
+        # bytes(n) would be n zeros
+        data = [data]
+    try:
+        data = bytes(data)
+    except (TypeError, ValueError):
+        errmsg = f"Each value in the `data` list should be a single, unsigned byte, but {data} can't be interpreted as bytes."
+        alog.error(errmsg)
+        raise ValueError(errmsg)
+    if len(data) == 0:
+        raise ValueError("Got an empty list of data bytes.")
+    return data
+
 class MockBus:
     """
     A mocked up smbus object for testing.
@@ -29,15 +72,49 @@ class MockBus:
     def __init__(self, instance: int) -> None:
         self.instance = instance
 
-    def write_i2c_block_data(self, addr, register, data):
-        alog.info(f"Mocking the write of some data to address {addr}, register {hex(register)} on i2c instance {self.instance}.")
+    def i2c_rdwr(self, *msgs):
+        alog.info(f"Mocking a combined transfer of {len(msgs)} messages on i2c instance {self.instance}. Reads come back as zeros.")
+
 
-    def write_byte(self, addr, data):
-        alog.info(f"Mocking the write of a single byte of data ({data}) to {hex(addr)} on i2c instance {self.instance}.")
+class _BusWorker:
+    """
+    Owns an I2C instance's smbus, and runs the transfers submitted for it one after
+    another, in the order they were submitted, on a thread of its own.
+    """
+    def __init__(self, instance: int, smbus) -> None:
+        self.instance = instance
+        self._smbus = smbus
+        self._queue = queue.Queue()
+        self._thread = threading.Thread(target=self._run, name=f"i2c-{instance}", daemon=True)
+        self._thread.start()
+
+    def submit(self, msgs: list) -> Future:
+        """Queue up `msgs` (smbus2 i2c_msgs). The future comes out True once they've gone, False if they failed."""
+        future = Future()
+        self._queue.put((msgs, future))
+        return future
 
+    def _run(self):
+        while True:
+            msgs, future = self._queue.get()
+            if not future.set_running_or_notify_cancel():
+                continue
+            try:
+                for first in range(0, len(msgs), I2C_RDWR_MAX_MSGS):
+                    self._smbus.i2c_rdwr(*msgs[first:first + I2C_RDWR_MAX_MSGS])
+            except OSError as e:
+                alog.error(f"Error transferring {len(msgs)} messages on I2C bus {self.instance}: {e}")
+                future.set_result(False)
+                continue
+            except Exception as e:
+                # Keep the worker going for everyone else sharing the instance
+                alog.error(f"Unexpected error transferring {len(msgs)} messages on I2C bus {self.instance}: {e}")
+                future.set_exception(e)
+                continue
+            future.set_result(True)
 
 class I2CBus:
-    def __init__(self, i2c_instances=None, instance_to_address_map=None) -> None:
+    def __init__(self, i2c_instances=None, instance_to_address_map=None, instance_to_speed_map=None) -> None:
         """
         Initialize the I2CBus object. By default, scans the I2C hardware bus
         to determine what addresses are present.
@@ -45,6 +122,9 @@ class I2CBus:
         For testing, pass in `i2c_instances` (list of int) and
         pass in the `instance_to_address_map` yourself.
         It should be a dict of the form {int: [addresses]}
+
+        You may also pass `instance_to_speed_map` ({int: Hz}). Any instance
+        not in it gets its rate from the kernel.
         """
         self.address_to_instance_map = None
 
@@ -64,6 +144,12 @@ class I2CBus:
         alog.info(f"Found i2c instances: {self.instance_to_address_map.keys()}")
         alog.info(f"i2c instances map to addresses: {self.instance_to_address_map}")
 
+        # Find out how fast each instance is clocked
+        self.instance_to_speed_map = {instance: _detect_bus_speed_hz(instance) for instance in self.i2c_instances}
+        if instance_to_speed_map is not None:
+            self.instance_to_speed_map.update(instance_to_speed_map)
+        alog.info(f"i2c instances run at (Hz): {self.instance_to_speed_map}")
+
         # Reverse the mapping as well
         self.address_to_instance_map = {}
         for instance, addresses in self.instance_to_address_map.items():
@@ -76,6 +162,95 @@ class I2CBus:
         except FileNotFoundError:
             self._instance_to_bus_map = {instance: MockBus(instance) for instance in self.i2c_instances}
 
+        # Each instance's smbus belongs to a worker thread, so instances work in parallel
+        self._instance_to_worker_map = {instance: _BusWorker(instance, smbus) for instance, smbus in self._instance_to_bus_map.items()}
+
+        # Address (an int) -> (instance, worker), filled in as each address is first used
+        self._address_to_bus = {}
+
+    def _bus_for(self, address: int) -> tuple[int, _BusWorker]:
+        """
+        The instance that has the address, and its worker. Cached by address, so the
+        hex-string lookup (and any warning about it) only happens the first time.
+        """
+        found = self._address_to_bus.get(address)
+        if found is not None:
+            return found
+
+        assert address >= 0 and address <= 255, f"Address must be a single byte, but is the value {address}"
+        hex_addr = hex(address)[2:]  # hex() leads with '0x', so strip that off as well
+        instance = self.address_to_instance_map.get(hex_addr, None)
+        if instance is None:
+            alog.warning(f"Cannot find address 0x{hex_addr} on i2c bus. Trying anyway on default I2C bus.")
+            instance = 1
+
+        found = (instance, self._instance_to_worker_map[instance])
+        self._address_to_bus[address] = found
+        return found
+
+    def submit(self, messages: list) -> Future:
+        """
+        Queue up `messages` (`Write`s and `Read`s, to one address or several) and return
+        without waiting for them. The messages for each I2C instance go out on its worker
+        in as few I2C_RDWR calls as the kernel allows: one, of up to I2C_RDWR_MAX_MSGS messages.
+        Each message after the first in a call starts with a repeated start instead of a stop
+        and a start. Instances work in parallel; on any one, batches go out in the order
+        they were submitted.
+
+        The future comes out as what each `Read` got, in order, or None if we experienced
+        an error (in which case other messages may or may not have gone out). Don't wait
+        on another transfer from the future's callbacks: they may run on a worker thread.
+        Raises a ValueError, before anything is queued, in the case of values that don't make sense.
+        """
+        if len(messages) == 0:
+            raise ValueError("Got an empty list of messages.")
+
+        by_instance = {}
+        reads = []
+        bytes_out = {}
+        for message in messages:
+            _, worker = self._bus_for(message.address)
+            if isinstance(message, Read):
+                if message.nbytes <= 0:
+                    raise ValueError(f"Need at least one byte to read, but got {message.nbytes}.")
+                msg = smbus2.i2c_msg.read(message.address, message.nbytes)
+                reads.append(msg)
+            else:
+                data = _as_bytes(message.data)
+                msg = smbus2.i2c_msg.write(message.address, data)
+                bytes_out[message.address] = bytes_out.get(message.address, 0) + len(data)
+            by_instance.setdefault(worker, []).append(msg)
+
+        for address, nbytes in bytes_out.items():
+            alog.update_counter(nbytes, "bytes-out", alog.MetricHWBusI2COrder.TRAFFIC, unit=alog.MetricUnits.BYTES, description="Number of bytes written to i2c bus", attributes={metrics.Attributes.I2C_ADDRESS: hex(address)})
+
+        # Done once every instance is done
+        result = Future()
+        result.set_running_or_notify_cancel()
+        pending = [len(by_instance), True]
+        lock = threading.Lock()
+
+        def instance_done(future: Future):
+            with lock:
+                pending[0] -= 1
+                pending[1] = pending[1] and future.exception() is None and future.result()
+                if pending[0] > 0:
+                    return
+            result.set_result([list(msg) for msg in reads] if pending[1] else None)
+
+        for worker, msgs in by_instance.items():
+            worker.submit(msgs).add_done_callback(instance_done)
+        return result
+
+    def transfer(self, messages: list) -> list[list[int]]|None:
+        """
+        Send `messages` (see `submit()`) and wait for them.
+
+        Returns what each `Read` got, in order, or None if we experienced an error.
+        Raises a ValueError in the case of values that don't make sense.
+        """
+        return self.submit(messages).result()
+
     def write(self, address: int, data: list) -> bool:
         """
         Write the data to the address.
@@ -84,42 +259,29 @@ class I2CBus:
         True if we wrote the bytes.
         Raises a ValueError in the case of values that don't make sense.
         """
-        nbytes = len(data)
-        if nbytes == 0:
-            raise ValueError("Got an empty list of data bytes.")
-
-        # Sanity check each int to make sure each one is a single byte and is positive
-        for b in data:
-            if b < 0 or b > 255:
-                errmsg = f"Each value in the `data` list should be a single, unsigned byte, but the value {b} cannot be interpreted as a single byte."
-                alog.error(errmsg)
-                raise ValueError(errmsg)
-
-        # Sanity check address and convert to hex string
-        assert address >= 0 and address <= 255, f"Address must be a single byte, but is the value {address}"
-        hex_addr = hex(address)[2:]  # hex() leads with '0x', so strip that off as well
+        return self.transfer([Write(address, data)]) is not None
 
-        # Get the bus instance that has the desired address
-        instance = self.address_to_instance_map.get(hex_addr, None)
-        if instance is None:
-            alog.warning(f"Cannot find address 0x{hex_addr} on i2c bus. Trying to write anyway on default I2C bus.")
-            instance = 1
+    def write_then_read(self, address: int, data: list, nbytes: int) -> list|None:
+        """
+        Write the data to the address, then read `nbytes` back from it after a repeated start,
+        in one transfer (e.g., to select a register and read it).
 
-        # Write to the given address on the i2c instance
-        # If data is more than one byte, we need to use the first byte as the register
-        # Otherwise, use the single byte write function
-        alog.update_counter(nbytes, "bytes-out", alog.MetricHWBusI2COrder.TRAFFIC, unit=alog.MetricUnits.BYTES, description="Number of bytes written to i2c bus", attributes={metrics.Attributes.I2C_ADDRESS: hex(address)})
-        try:
-            if nbytes > 1:
-                data_bytes = [int(b) for b in data.to_bytes(nbytes, 'big')]
-                self._instance_to_bus_map[instance].write_i2c_block_data(address, data_bytes[0], data_bytes[1:])
-            else:
-                assert nbytes == 1
-                self._instance_to_bus_map[instance].write_byte(address, data[0])
-        except OSError as e:
-            alog.error(f"Error writing {data} to {address} on I2C bus {instance}: {e}")
-            return False
-        return True
+        Returns the bytes read, or None if we experienced an error.
+        Raises a ValueError in the case of values that don't make sense.
+        """
+        read = self.transfer([Write(address, data), Read(address, nbytes)])
+        return None if read is None else read[0]
+
+    def read(self, address: int, nbytes: int) -> list|None:
+        """
+        Read `nbytes` from the address, without writing anything first (e.g., to read a device's
+        response to an earlier command).
+
+        Returns the bytes read, or None if we experienced an error.
+        Raises a ValueError in the case of values that don't make sense.
+        """
+        read = self.transfer([Read(address, nbytes)])
+        return None if read is None else read[0]
 
 
 def _detect_all_i2c_instances():
@@ -131,6 +293,25 @@ def _detect_all_i2c_instances():
     instances = [line.strip().split()[0] for line in lines]
     return [int(inst.split("-")[1]) for inst in instances]
 
+def _detect_bus_speed_hz(instance) -> int:
+    """
+    Return the SCL rate (in Hz) the kernel runs the given I2C instance at.
+    The rate is set by the device tree (e.g., `dtparam=i2c_arm_baudrate=400000`),
+    so we read it back from there. If we can't, we assume `DEFAULT_BUS_SPEED_HZ`.
+    """
+    path = f"/sys/class/i2c-adapter/i2c-{instance}/of_node/clock-frequency"
+    try:
+        with open(path, 'rb') as f:
+            raw = f.read(4)
+    except OSError:
+        return DEFAULT_BUS_SPEED_HZ
+
+    if len(raw) != 4:
+        return DEFAULT_BUS_SPEED_HZ
+
+    # Device tree cells are big-endian u32s
+    return int.from_bytes(raw, 'big')
+
 def _detect_all_addresses_on_i2c_instance(instance):
     """
     Return a list of addresses found on the given I2C instance.
@@ -144,15 +325,16 @@ def _detect_all_addresses_on_i2c_instance(instance):
                 addresses.append(val.strip())
     return addresses
 
-def manually_initialize(i2c_instances=None, instance_to_address_map=None):
+def manually_initialize(i2c_instances=None, instance_to_address_map=None, instance_to_speed_map=None):
     """
     For testing, pass in `i2c_instances` (list of int) and
     pass in the `instance_to_address_map` yourself.
     It should be a dict of the form {int: [addresses]}
+    Optionally pass `instance_to_speed_map` ({int: Hz}) too.
     """
     alog.info(f"Manually initializing i2c library.")
     global bus
-    bus = I2CBus(i2c_instances=i2c_instances, instance_to_address_map=instance_to_address_map)
+    bus = I2CBus(i2c_instances=i2c_instances, instance_to_address_map=instance_to_address_map, instance_to_speed_map=instance_to_speed_map)
 
 @public_i2c_function
 def check_for_address(address: int):
@@ -184,6 +366,43 @@ def list_all_addresses_on_instance(instance: int):
     else:
         return bus.instance_to_address_map[instance]
 
+@public_i2c_function
+def get_bus_speed(instance: int) -> int:
+    """
+    Return the rate (in Hz) the given I2C instance runs at.
+    """
+    if instance not in bus.i2c_instances:
+        raise ValueError(f"No i2c instance {instance} found.")
+    return bus.instance_to_speed_map[instance]
+
+@public_i2c_function
+def negotiate_bus_speed(address: int, target_speed_hz: int) -> int:
+    """
+    Agree on a bus rate with the target at `address`, which has been built
+    to expect `target_speed_hz` (one of `SUPPORTED_BUS_SPEEDS_HZ`).
+
+    The bus rate is fixed by the kernel, so all we can do is check it against what the
+    target expects. Returns the rate the bus actually runs at. Logs a warning if the target
+    expects a different rate: a target run faster than it was built for may
+    misread bytes; one run slower works, but gives up bandwidth.
+    """
+    if target_speed_hz not in SUPPORTED_BUS_SPEEDS_HZ:
+        errmsg = f"Target speed must be one of {SUPPORTED_BUS_SPEEDS_HZ} Hz, but is {target_speed_hz}"
+        alog.error(errmsg)
+        raise ValueError(errmsg)
+
+    instance = check_for_address(address)
+    if instance is None:
+        alog.warning(f"Cannot find address {hex(address)} on i2c bus. Assuming the default I2C bus.")
+        instance = 1
+
+    bus_speed_hz = bus.instance_to_speed_map.get(instance, DEFAULT_BUS_SPEED_HZ)
+    if bus_speed_hz > target_speed_hz:
+        alog.warning(f"I2C bus {instance} runs at {bus_speed_hz} Hz, but target {hex(address)} expects at most {target_speed_hz} Hz.")
+    elif bus_speed_hz < target_speed_hz:
+        alog.warning(f"I2C bus {instance} runs at {bus_speed_hz} Hz, below the {target_speed_hz} Hz target {hex(address)} supports.")
+    return bus_speed_hz
+
 @public_i2c_function
 def write_bytes_to_address(address: int, data: list) -> bool:
     """
@@ -198,3 +417,42 @@ def write_bytes_to_address(address: int, data: list) -> bool:
         data = [data]
 
     return bus.write(address, data)
+
+@public_i2c_function
+def write_then_read_bytes(address: int, data: list, nbytes: int) -> list|None:
+    """
+    Write the given bytes to the given address, then read `nbytes` back
+    after a repeated start. Returns the bytes read (a list of ints), or None on error.
+    """
+    try:
+        _ = iter(data)
+    except TypeError:
+        data = [data]
+
+    return bus.write_then_read(address, data, nbytes)
+
+@public_i2c_function
+def read_bytes_from_address(address: int, nbytes: int) -> list|None:
+    """
+    Read `nbytes` from the given address, without writing first: the response
+    to a command written earlier. Returns the bytes read (a list of ints), or None on error.
+    """
+    return bus.read(address, nbytes)
+
+@public_i2c_function
+def submit(messages: list) -> Future:
+    """
+    Queue up a batch of `Write`s and `Read`s (see `transfer()`) and return without waiting:
+    a `concurrent.futures.Future` that comes out as what each `Read` got, or None on error.
+    Ignore it to fire and forget (errors are still logged), or call `result()` to wait.
+    """
+    return bus.submit(messages)
+
+@public_i2c_function
+def transfer(messages: list) -> list[list[int]]|None:
+    """
+    Send a batch of `Write`s and `Read`s, to one address or several, as one combined
+    transfer per I2C instance rather than one transaction each. Returns what each `Read`
+    got (a list of ints each), in order, or None on error.
+    """
+    return bus.transfer(messages)
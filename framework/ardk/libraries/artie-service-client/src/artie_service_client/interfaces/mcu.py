@@ -12,6 +12,32 @@ class MCUInterfaceV1:
         """Return the name of this interface. All interfaces must implement this method."""
         return "mcu-interface-v1"
 
+    def mcu_batch(self, operations: tuple, latch: bool) -> tuple:
+        """
+        Carry out several operations on this service's MCUs together: the service sends them all in one
+        go (for an I2C service, one frame per MCU in a single transfer) instead of one at a time.
+
+        * *Parameters*:
+            * `operations`: A tuple of `(kind, which, value)` tuples (tuples, so that an RPC sends them by value,
+              all at once). `kind` is one of `'display'` (`value` as for `display_set`), `'display-clear'`,
+              `'servo'` (`value` in degrees, as for `servo_set`), or `'led'` (`value` as for `led_set`), and `which`
+              is the display, servo, or LED, as for those methods.
+            * `latch`: If `True`, the MCUs hold the operations until `mcu_commit()` instead of acting on them.
+              Each MCU holds one batch at a time: another latched batch replaces the one waiting.
+
+        *Returns*: A tuple of `bool`, one per operation: whether it was valid and sent.
+        """
+        raise NotImplementedError("MCUInterface services must implement the `mcu_batch` method.")
+
+    def mcu_commit(self) -> bool:
+        """
+        Have this service's MCUs act on the operations latched by `mcu_batch()`. Where the bus allows it,
+        every MCU that answers general calls acts on it at once, whichever service latched its operations.
+
+        *Returns*: `True` if the commit was sent, `False` otherwise.
+        """
+        raise NotImplementedError("MCUInterface services must implement the `mcu_commit` method.")
+
     def mcu_fw_load(self, mcu_id: str) -> bool:
         """
         Load firmware onto the given MCU ID.
@@ -25,6 +25,24 @@ class MCUClient(
             return errors.HTTPError(500, "Malformed response from server: missing 'mcu-names' field.")
         return response.json()['mcu-names']
 
+    def mcu_batch(self, operations: tuple, latch: bool) -> tuple | errors.HTTPError:
+        body = {
+            "latch": latch,
+            "operations": [{"service": self.service_name, "kind": kind, "which": which, "value": value} for kind, which, value in operations]
+        }
+        response = self.post("/mcu_batch", body=body)
+        if response.status_code != 200:
+            return errors.HTTPError(response.status_code, f"Error running MCU batch: {response.content.decode('utf-8')}")
+        elif 'results' not in response.json():
+            return errors.HTTPError(500, "Malformed response from server: missing 'results' field.")
+        return tuple(response.json()['results'])
+
+    def mcu_commit(self) -> bool | errors.HTTPError:
+        response = self.post(f"/{self.service_name}/mcu_commit")
+        if response.status_code != 200:
+            return errors.HTTPError(response.status_code, f"Error committing MCU batch: {response.content.decode('utf-8')}")
+        return response.json().get('success', True)
+
     def mcu_fw_load(self, mcu_id: str) -> bool | errors.HTTPError:
         params = {}
         if mcu_id:
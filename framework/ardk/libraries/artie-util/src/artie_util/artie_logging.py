@@ -240,6 +240,7 @@ class MetricUnits(enum.StrEnum):
     JOULES = "joules"
     GRAMS = "grams"
     CALLS = "calls"
+    HERTZ = "hertz"
 
 class KnownMetricAttributes(enum.StrEnum):
     ARTIE_ID = "artie.id"
@@ -482,6 +483,12 @@ class MetricHWActuatorDisplayOrder(_MetricEnumMixin, enum.Enum):
     BRIGHTNESS = "brightness", _parent
     """Display brightness metrics."""
 
+    FRAMES = "frames", _parent
+    """Display frame rate and drawing backlog metrics."""
+
+    FLUSH = "flush", _parent
+    """Time to send a frame to the display metrics."""
+
 class MetricHWActuatorServoOrder(_MetricEnumMixin, enum.Enum):
     """hw.actuators.servo.X: Servo actuator-related metrics orders."""
     _parent = MetricHWActuatorClass.SERVO
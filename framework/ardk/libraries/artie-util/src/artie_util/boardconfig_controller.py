@@ -67,4 +67,5 @@ I2C_SCL = 3  # GPIO 3 (BCM mode -> physical pin 5)
 I2C_ADDRESS_EYEBROWS_MCU_LEFT = 0x17
 I2C_ADDRESS_EYEBROWS_MCU_RIGHT = 0x18
 I2C_ADDRESS_MOUTH_MCU = 0x19
+I2C_ADDRESS_HEAD_SENSORS_MCU = 0x1A
 I2C_ADDRESS_RESET_MCU = 0x20
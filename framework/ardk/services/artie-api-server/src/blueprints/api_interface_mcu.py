@@ -8,6 +8,115 @@ import flask
 
 mcu_api = flask.Blueprint('mcu_api', __name__, url_prefix="/<service>")
 
+# Operations that span services, so they have no service in their path
+mcu_batch_api = flask.Blueprint('mcu_batch_api', __name__)
+
+# The kinds of operation a batch can hold (see MCUInterfaceV1.mcu_batch)
+BATCH_OPERATION_KINDS = ("display", "display-clear", "servo", "led")
+
+@mcu_batch_api.route("/mcu_batch", methods=["POST"])
+@alog.function_counter("mcu_batch", alog.MetricSWCodePathAPIOrder.CALLS)
+def mcu_batch():
+    """
+    Carry out operations on several services' MCUs together: one RPC per service instead of one request
+    per operation, and each service sends its share in one go. If latched, commit them once every service
+    has staged its share, so they all change together.
+    """
+    # Check the payload
+    data = r.get_json(silent=True)
+    if not data or not isinstance(data.get('operations', None), list):
+        errbody = {
+            "error": "Missing 'operations' list in JSON payload."
+        }
+        return errbody, 400
+
+    latch = bool(data.get('latch', False))
+    by_service = {}
+    for i, op in enumerate(data['operations']):
+        if not isinstance(op, dict) or 'service' not in op or 'which' not in op or op.get('kind', None) not in BATCH_OPERATION_KINDS:
+            errbody = {
+                "operation": i,
+                "error": f"Each operation needs a 'service', a 'which', and a 'kind' (one of {', '.join(BATCH_OPERATION_KINDS)})."
+            }
+            return errbody, 400
+        by_service.setdefault(op['service'], []).append((i, (op['kind'], op['which'], op.get('value', None))))
+
+    # Get every service first, so the batches go out as close together as they can
+    service = None
+    try:
+        connections = {}
+        for service in by_service:
+            connections[service] = asc.ServiceConnection(service)
+
+        results = [False] * len(data['operations'])
+        for service, ops in by_service.items():
+            sent = connections[service].mcu_batch(tuple(op for _, op in ops), latch)
+            for (i, _), worked in zip(ops, sent):
+                results[i] = bool(worked)
+
+        # Only commit if every service staged its share; otherwise nothing changes (until another latched batch replaces it)
+        committed = False
+        if latch and all(results):
+            committed = True
+            for service, s in connections.items():
+                committed &= bool(s.mcu_commit())
+
+        return {
+            "latch": latch,
+            "committed": committed,
+            "results": results
+        }
+    except KeyError as e:
+        errbody = {
+            "service": service,
+            "error": f"Service not found: {e}"
+        }
+        return errbody, 404
+    except TimeoutError as e:
+        errbody = {
+            "service": service,
+            "error": f"Timed out trying to run MCU batch: {e}"
+        }
+        return errbody, 504
+    except Exception as e:
+        errbody = {
+            "service": service,
+            "error": f"Error trying to run MCU batch: {e}"
+        }
+        return errbody, 500
+
+@mcu_api.route("/mcu_commit", methods=["POST"])
+@alog.function_counter("mcu_commit", alog.MetricSWCodePathAPIOrder.CALLS)
+def mcu_commit(service: str):
+    """
+    Have the given service's MCUs act on the operations latched by a batch.
+    """
+    try:
+        s = asc.ServiceConnection(service)
+        result = bool(s.mcu_commit())
+        return {
+            "service": service,
+            "success": result
+        }
+    except KeyError as e:
+        errbody = {
+            "service": service,
+            "error": f"Service not found: {e}"
+        }
+        return errbody, 404
+    except TimeoutError as e:
+        errbody = {
+            "service": service,
+            "error": f"Timed out trying to commit MCU batch: {e}"
+        }
+        return errbody, 504
+    except Exception as e:
+        errbody = {
+            "service": service,
+            "error": f"Error trying to commit MCU batch: {e}"
+        }
+        return errbody, 500
+
 @mcu_api.route("/mcu_reload_fw", methods=["POST"])
 @alog.function_counter("mcu_reload_fw", alog.MetricSWCodePathAPIOrder.CALLS)
 def mcu_reload_fw(service: str):
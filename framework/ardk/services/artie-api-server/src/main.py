@@ -21,6 +21,7 @@ app.register_blueprint(api_server_api.api_server_api)
 app.register_blueprint(logs_api.logs_api)
 app.register_blueprint(metrics_api.metrics_api)
 app.register_blueprint(api_interface_mcu.mcu_api)
+app.register_blueprint(api_interface_mcu.mcu_batch_api)
 app.register_blueprint(api_interface_display.display_api)
 app.register_blueprint(api_interface_driver.driver_api)
 app.register_blueprint(api_interface_servo.servo_api)
@@ -0,0 +1,181 @@
+"""
+Encodes pictures as delta frames for an eyebrow or mouth MCU built with CAN_FRAMES (see the
+firmware's can/canframes.h and gfx_delta_t in graphics/commongfx.h): each frame is the tiles of
+the paint buffer that changed since the one before, XORed with it and PackBits-encoded, so only
+what changed goes over the bus. Each frame is one BWACP block, written to CANFRAMES_BLOCK_ADDRESS.
+
+Pictures are binary PPMs the size of the MCU's paint buffer (see FORMATS), converted to its
+format: black and white at scale 2, four grays at scale 4, or RGB565 at scale 65.
+
+The MCU's RPC_ID_QUERY_FRAME_STREAM says which frame its paint buffer holds; if it isn't the
+last one sent (a face command drew in between, say), send a key frame next.
+"""
+from workbench.util import log
+import argparse
+import dataclasses
+import os
+import struct
+import sys
+
+# See commongfx.h and canframes.h
+GFX_DELTA_VERSION = 1
+GFX_DELTA_FLAG_KEY = 0x01
+CANFRAMES_BLOCK_ADDRESS = 0x47465801
+BWACP_BLOCK_LEN = 4096
+
+@dataclasses.dataclass
+class Format:
+    """What a frame must have been rendered at to suit an MCU's paint buffer."""
+    scale: int              # 2 (1 bpp), 4 (2 bpp grays), or 65 (RGB565)
+    width_memory: int
+    height_memory: int
+    rotate: int = 0
+
+    @property
+    def row_bytes(self) -> int:
+        bits = {2: 1, 4: 2, 65: 16}[self.scale]
+        return (self.width_memory * bits + 7) // 8
+
+# Paint buffer sizes (see PAINT_WIDTH_MEMORY in commongfx.c)
+FORMATS = {
+    "eyebrows": (240, 135),
+    "mouth": (320, 240),
+}
+
+def pack_bits(data: bytes) -> bytes:
+    """PackBits, as the firmware decodes it: n < 128 then n + 1 literals, or 257 - n then a byte to repeat."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out += bytes([257 - run, data[i]])
+            i += run
+            continue
+        start = i
+        while i < len(data) and i - start < 128 and not (i + 1 < len(data) and data[i + 1] == data[i]):
+            i += 1
+        if i == start:
+            i += 1
+        out += bytes([i - start - 1]) + data[start:i]
+    return bytes(out)
+
+def read_ppm(path: str) -> tuple[int, int, bytes]:
+    """A binary (P6) PPM with 8 bits a channel: width, height, and its RGB bytes."""
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError(f"{path} is not an 8-bit binary PPM")
+    width, height = int(fields[1]), int(fields[2])
+    return width, height, data[pos + 1:pos + 1 + width * height * 3]
+
+def to_paint_buffer(fmt: Format, rgb: bytes) -> bytes:
+    """RGB bytes, width_memory by height_memory, in the paint buffer's format (see GUI_Paint.c)."""
+    out = bytearray(fmt.row_bytes * fmt.height_memory)
+    for y in range(fmt.height_memory):
+        row = y * fmt.row_bytes
+        for x in range(fmt.width_memory):
+            r, g, b = rgb[(y * fmt.width_memory + x) * 3:(y * fmt.width_memory + x) * 3 + 3]
+            if fmt.scale == 65:
+                struct.pack_into(">H", out, row + x * 2, ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+                continue
+            luma = (r * 299 + g * 587 + b * 114) // 1000
+            if fmt.scale == 2:
+                # Palette index 0 is black, 1 white
+                if luma >= 128:
+                    out[row + x // 8] |= 0x80 >> (x % 8)
+            else:
+                # Four grays, from black (0) to white (3)
+                out[row + x // 4] |= ((luma * 3 + 127) // 255) << (6 - (x % 4) * 2)
+    return bytes(out)
+
+def background(fmt: Format) -> bytes:
+    """A paint buffer cleared to white."""
+    return b"\xFF" * (fmt.row_bytes * fmt.height_memory)
+
+def encode(fmt: Format, seq: int, picture: bytes, base: bytes | None, base_seq: int = 0, tile_rows: int = 8) -> bytes:
+    """
+    A delta frame taking the paint buffer from base (or, if None, from anything: a key frame) to picture.
+    Each band of tile_rows rows that changed is a tile, as wide as the bytes that changed in it.
+    """
+    key = base is None
+    reference = background(fmt) if key else base
+    tiles = bytearray()
+    ntiles = 0
+    for y in range(0, fmt.height_memory, tile_rows):
+        height = min(tile_rows, fmt.height_memory - y)
+        rows = [(picture[(y + i) * fmt.row_bytes:(y + i + 1) * fmt.row_bytes],
+                 reference[(y + i) * fmt.row_bytes:(y + i + 1) * fmt.row_bytes]) for i in range(height)]
+        changed = [x for x in range(fmt.row_bytes) if any(new[x] != old[x] for new, old in rows)]
+        if not changed:
+            continue
+        xbyte, xend = changed[0], changed[-1] + 1
+        if key:
+            data = b"".join(new[xbyte:xend] for new, _ in rows)
+        else:
+            data = b"".join(bytes(a ^ b for a, b in zip(new[xbyte:xend], old[xbyte:xend])) for new, old in rows)
+        packed = pack_bits(data)
+        tiles += struct.pack("<HHHHH", xbyte, y, xend - xbyte, height, len(packed)) + packed
+        ntiles += 1
+
+    header = struct.pack("<BBHHBBHHHH", GFX_DELTA_VERSION, GFX_DELTA_FLAG_KEY if key else 0, seq & 0xFFFF, base_seq & 0xFFFF,
+                         fmt.scale, 0, fmt.rotate, fmt.width_memory, fmt.height_memory, ntiles)
+    return header + bytes(tiles)
+
+def main():
+    parser = argparse.ArgumentParser(description="Encode pictures as delta frames for an MCU built with CAN_FRAMES, one BWACP block payload each.")
+    parser.add_argument("out_dir", type=str, help="Where to write the frames, as <seq>.bin")
+    parser.add_argument("pictures", type=str, nargs="+", help="Binary PPMs the size of the paint buffer, in order")
+    parser.add_argument("--face", type=str, default="eyebrows", choices=list(FORMATS), help="Which MCU's paint buffer")
+    parser.add_argument("--scale", type=int, default=2, choices=[2, 4, 65], help="The MCU's GFX_PAINT_SCALE")
+    parser.add_argument("--first-seq", type=int, default=0, help="Number of the first frame, which is a key frame")
+    parser.add_argument("--key-every", type=int, default=0, help="Send a key frame this often, to recover from a lost one. 0 for only the first.")
+    parser.add_argument("--tile-rows", type=int, default=8, help="Rows in each band a tile can cover")
+    parser.add_argument("--max-block", type=int, default=BWACP_BLOCK_LEN, help="The MCU's BWACP_BLOCK_LEN")
+    parser.add_argument("--loglevel", type=str, default="INFO", choices=["DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"], help="Logging level (default: INFO)")
+    args = parser.parse_args()
+    log.initialize_logger(getattr(log.logging, args.loglevel))
+
+    fmt = Format(args.scale, *FORMATS[args.face])
+    os.makedirs(args.out_dir, exist_ok=True)
+    previous = None
+    total = 0
+    too_big = 0
+    for i, path in enumerate(args.pictures):
+        width, height, rgb = read_ppm(path)
+        if (width, height) != (fmt.width_memory, fmt.height_memory):
+            log.error(f"{path} is {width} x {height}, not {fmt.width_memory} x {fmt.height_memory}")
+            sys.exit(1)
+        picture = to_paint_buffer(fmt, rgb)
+        seq = args.first_seq + i
+        key = previous is None or (args.key_every > 0 and i % args.key_every == 0)
+        frame = encode(fmt, seq, picture, None if key else previous, seq - 1, args.tile_rows)
+        if len(frame) > args.max_block:
+            log.warning(f"Frame {seq} ({path}) is {len(frame)} bytes, more than a block holds")
+            too_big += 1
+        with open(os.path.join(args.out_dir, f"{seq:04d}.bin"), "wb") as f:
+            f.write(frame)
+        print(f"{seq:04d} {'key  ' if key else 'delta'} {len(frame):5d} bytes  {path}")
+        total += len(frame)
+        previous = picture
+
+    raw = len(args.pictures) * fmt.row_bytes * fmt.height_memory
+    print(f"# {len(args.pictures)} frames, {total} bytes ({100 * total / raw:.1f}% of {raw} raw), {too_big} too big for a block")
+    print(f"# Write each to block address 0x{CANFRAMES_BLOCK_ADDRESS:08X}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,197 @@
+"""
+Load generator and soak test for an MCU's command queue (the cmds firmware library).
+
+Sends a mix of commands to one MCU over I2C through `artie_i2c`, at a series of rates,
+and after each rate reads back the queue's status register: the write transactions it
+has dropped and the most bytes it has ever held. Reports what each rate achieved, and
+the highest rate sustained without losing anything.
+
+The queue is CMDS_RING_SIZE bytes, and each write costs one byte plus its commands, so
+framing several commands per write (--frame-len) takes less of it than sending them one
+by one. The bus rate is set by the controller's device tree, so to compare bus rates,
+run it again after changing `dtparam=i2c_arm_baudrate`; each report says which rate it ran at.
+
+Runs on the controller.
+"""
+from workbench.util import log
+import argparse
+import csv
+import dataclasses
+import random
+import sys
+import time
+
+# See cmds.h
+CMDS_FRAME_HEADER = 0xC0
+CMDS_FRAME_MAX_LEN = 0x3F
+CMDS_REGISTER_SELECT = CMDS_FRAME_HEADER
+CMDS_REG_STATUS = 0x00
+CMDS_STATUS_LEN = 6
+CMDS_STATUS_BUSY = 0x01
+CMDS_STATUS_DROPPED = 0x02
+
+# Command mixes: (command byte, weight). None of these move anything. See the firmware's board/types.h.
+MIXES = {
+    "led": [(0x00, 1), (0x01, 1)],                                  # LED on, LED off
+    "draw": [(0x40 | 0x07, 1), (0x40 | 0x00, 1), (0x40 | 0x2A, 1)], # Eyebrow draws: HHH, LLL, MHM
+    "mouth": [(0x40 | 0x00, 1), (0x40 | 0x01, 1), (0x40 | 0x02, 1)],# Mouth smile, frown, line
+    "mixed": [(0x00, 2), (0x01, 2), (0x40 | 0x07, 1), (0x40 | 0x00, 1)],  # LED on and off, and eyebrow draws
+}
+
+@dataclasses.dataclass
+class QueueStatus:
+    """The command queue's status register (CMDS_REG_STATUS)."""
+    busy: bool
+    dropped_since_last: bool
+    free: int           # Bytes free in the queue, saturating at 255
+    high_water: int     # Most bytes ever queued at once
+    dropped: int        # Write transactions dropped since boot, saturating at 65535
+
+    @staticmethod
+    def unpack(raw: list[int]) -> 'QueueStatus':
+        return QueueStatus(
+            busy=bool(raw[0] & CMDS_STATUS_BUSY),
+            dropped_since_last=bool(raw[0] & CMDS_STATUS_DROPPED),
+            free=raw[1],
+            high_water=raw[2] | (raw[3] << 8),
+            dropped=raw[4] | (raw[5] << 8),
+        )
+
+@dataclasses.dataclass
+class StepResult:
+    """How one rate went."""
+    target_cmds_per_s: float
+    sent_cmds_per_s: float
+    commands: int
+    writes: int
+    write_errors: int
+    dropped: int
+    high_water: int
+
+    @property
+    def lossless(self) -> bool:
+        return self.write_errors == 0 and self.dropped == 0
+
+def parse_mix(mix: str) -> list[tuple[int, int]]:
+    """A named mix, or 'byte:weight,...' (e.g. '0x00:3,0x47:1')."""
+    if mix in MIXES:
+        return MIXES[mix]
+
+    parsed = []
+    for item in mix.split(','):
+        command, _, weight = item.partition(':')
+        parsed.append((int(command, 0), int(weight) if weight else 1))
+    return parsed
+
+def make_write(commands: list[int]) -> list[int]:
+    """The bytes of one write: a bare command, or a frame of several."""
+    if len(commands) == 1:
+        return commands
+    return [CMDS_FRAME_HEADER | len(commands)] + commands
+
+def read_status(i2c, address: int) -> QueueStatus|None:
+    raw = i2c.write_then_read_bytes(address, [CMDS_REGISTER_SELECT, CMDS_REG_STATUS], CMDS_STATUS_LEN)
+    if raw is None:
+        log.error(f"Could not read the status register of {hex(address)}")
+        return None
+    return QueueStatus.unpack(raw)
+
+def run_step(i2c, address: int, mix: list[tuple[int, int]], frame_len: int, rate: float, seconds: float, report_every_s: float, rng: random.Random) -> StepResult|None:
+    """Send at `rate` commands per second for `seconds`, then see what the queue made of it."""
+    before = read_status(i2c, address)
+    if before is None:
+        return None
+
+    commands, weights = zip(*mix)
+    write_interval_s = frame_len / rate
+    start = time.monotonic()
+    next_write = start
+    next_report = start + report_every_s if report_every_s > 0 else float('inf')
+    ncommands = 0
+    nwrites = 0
+    nerrors = 0
+    while True:
+        now = time.monotonic()
+        if now - start >= seconds:
+            break
+
+        if now < next_write:
+            time.sleep(next_write - now)
+        # If we've fallen behind (the bus can't go this fast), don't try to catch up in a burst
+        next_write = max(next_write + write_interval_s, time.monotonic())
+
+        batch = rng.choices(commands, weights=weights, k=frame_len)
+        if not i2c.write_bytes_to_address(address, make_write(list(batch))):
+            nerrors += 1
+        ncommands += frame_len
+        nwrites += 1
+
+        if time.monotonic() >= next_report:
+            status = read_status(i2c, address)
+            if status is not None:
+                elapsed = time.monotonic() - start
+                log.info(f"{elapsed:.0f} s at {rate:g} commands/s: sent {ncommands / elapsed:.0f}/s, {nerrors} write errors, "
+                         f"{status.dropped - before.dropped} dropped, high water {status.high_water}, {status.free} bytes free")
+            next_report += report_every_s
+
+    elapsed = time.monotonic() - start
+    # Let the main loop drain the queue before reading how it went
+    time.sleep(0.1)
+    after = read_status(i2c, address)
+    if after is None:
+        return None
+
+    # The drop count saturates at 0xFFFF, so it's only a difference while it hasn't
+    dropped = after.dropped - before.dropped
+    return StepResult(rate, ncommands / elapsed, ncommands, nwrites, nerrors, dropped, after.high_water)
+
+def report(results: list[StepResult], out=sys.stdout):
+    writer = csv.writer(out)
+    writer.writerow(["target_cmds_per_s", "sent_cmds_per_s", "commands", "writes", "write_errors", "dropped", "high_water"])
+    for r in results:
+        writer.writerow([f"{r.target_cmds_per_s:g}", f"{r.sent_cmds_per_s:.0f}", r.commands, r.writes, r.write_errors, r.dropped, r.high_water])
+
+def main():
+    parser = argparse.ArgumentParser(description="Push commands at an MCU's command queue over I2C, and report the rate it sustains without loss.")
+    parser.add_argument("address", type=lambda a: int(a, 0), help="The MCU's I2C address (e.g. 0x18)")
+    parser.add_argument("--mix", type=str, default="led", help=f"Commands to send: one of {', '.join(MIXES)}, or 'byte:weight,...'")
+    parser.add_argument("--frame-len", type=int, default=1, help=f"Commands per write (1 to {CMDS_FRAME_MAX_LEN}). 1 sends bare commands, more sends frames.")
+    parser.add_argument("--rates", type=str, default="100,200,500,1000,2000,5000", help="Command rates to try, in commands per second, in order")
+    parser.add_argument("--seconds", type=float, default=5.0, help="How long to hold each rate. Make it long (with a single rate) for a soak test.")
+    parser.add_argument("--report-every", type=float, default=0.0, help="While holding a rate, log how it's going this often (seconds). 0 for never.")
+    parser.add_argument("--stop-on-loss", action="store_true", help="Stop at the first rate that loses anything")
+    parser.add_argument("--seed", type=int, default=0, help="Seed for picking commands from the mix")
+    parser.add_argument("--loglevel", type=str, default="INFO", choices=["DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"], help="Logging level (default: INFO)")
+    args = parser.parse_args()
+    log.initialize_logger(getattr(log.logging, args.loglevel))
+
+    if not 1 <= args.frame_len <= CMDS_FRAME_MAX_LEN:
+        parser.error(f"--frame-len must be 1 to {CMDS_FRAME_MAX_LEN}")
+
+    # Only on the controller
+    from artie_i2c import i2c
+
+    instance = i2c.check_for_address(args.address)
+    bus_speed_hz = i2c.get_bus_speed(instance) if instance is not None else i2c.DEFAULT_BUS_SPEED_HZ
+    mix = parse_mix(args.mix)
+    print(f"# cmdload {hex(args.address)} bus={bus_speed_hz} Hz mix={args.mix} frame_len={args.frame_len}")
+
+    rng = random.Random(args.seed)
+    results = []
+    for rate in (float(r) for r in args.rates.split(',')):
+        result = run_step(i2c, args.address, mix, args.frame_len, rate, args.seconds, args.report_every, rng)
+        if result is None:
+            break
+        results.append(result)
+        if args.stop_on_loss and not result.lossless:
+            break
+
+    report(results)
+    sustained = max((r.sent_cmds_per_s for r in results if r.lossless), default=None)
+    if sustained is None:
+        print("# sustained: none (every rate lost commands)")
+    else:
+        print(f"# sustained: {sustained:.0f} commands/s without loss")
+
+if __name__ == "__main__":
+    main()
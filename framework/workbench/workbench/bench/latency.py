@@ -0,0 +1,246 @@
+"""
+Command-to-photon latency for the eyebrow LCDs.
+
+Firmware built with TRACE_PROBES (see the trace library) toggles a GPIO at each
+step of a command's way to the glass: received over the bus, dispatched by the
+main loop, the graphics core starting the frame that shows it, and that frame
+clocked out to the LCD. This tool sends LCD commands the way the eyebrows driver's
+`lcd.py` does and times each step from the moment the controller issued the write,
+giving percentiles per command type.
+
+There are two ways to catch the edges:
+
+* `run` on the controller, with the probe pins wired to its GPIOs. It sends the
+  commands and timestamps the edges itself. Convenient, but the edges are seen
+  through the kernel and Python, which adds tens to hundreds of microseconds of jitter.
+* `run --issue-pin` with a logic analyzer on the probe pins and on that controller
+  pin (which toggles as each write is issued) and `--log` to record what was sent.
+  Then `analyze` the analyzer's CSV export against the log, for timing to the
+  analyzer's resolution.
+"""
+from workbench.util import log
+import argparse
+import bisect
+import csv
+import dataclasses
+import math
+import sys
+import threading
+import time
+
+# The probes, in the order of trace_probe_t (and of a command's way to the glass)
+STAGES = ("received", "dispatched", "render_start", "flush_end")
+
+# LCD command module (see src-eyebrows/lcd.py and the firmware's board/types.h)
+CMD_MODULE_ID_LCD = 0x40
+
+# Eyebrow states cycled through by the 'draw' commands, so every draw changes what's on the glass
+DRAW_STATES = ("HHH", "LLL", "MHM", "LML", "HLH", "MMM")
+
+def encode_draw(eyebrow_state: str) -> int:
+    """The command byte for drawing an eyebrow state such as 'MHM', as in LcdSubmodule.draw()."""
+    command = CMD_MODULE_ID_LCD
+    for i, pos in enumerate(eyebrow_state):
+        if pos == 'H':
+            command |= (0x01 << i)
+        elif pos == 'M':
+            command |= (0x01 << (3 + i))
+    return command
+
+# Command types we can time: each takes the repetition number and gives the command byte
+COMMAND_TYPES = {
+    "draw": lambda i: encode_draw(DRAW_STATES[i % len(DRAW_STATES)]),
+    "test": lambda i: CMD_MODULE_ID_LCD | 0x11,
+    "off": lambda i: CMD_MODULE_ID_LCD | 0x22,
+}
+
+@dataclasses.dataclass
+class Sent:
+    """One command we sent, and when (in seconds, on whichever clock the edges are on)."""
+    command_type: str
+    command: int
+    issued_s: float
+
+def match_stages(sent: list[Sent], edges: dict[str, list[float]], timeout_s: float) -> list[list[float]|None]:
+    """
+    For each command sent, find when each stage happened: the first edge of each probe after the stage
+    before it (and the first 'received' edge after the command was issued). Returns the stages'
+    times after issue in seconds, by command, or None for a command whose stages didn't all
+    come within timeout_s (or before the next command was issued).
+    """
+    results = []
+    for n, s in enumerate(sent):
+        deadline = s.issued_s + timeout_s
+        if n + 1 < len(sent):
+            deadline = min(deadline, sent[n + 1].issued_s)
+
+        times = []
+        after = s.issued_s
+        for stage in STAGES:
+            stage_edges = edges.get(stage, [])
+            i = bisect.bisect_right(stage_edges, after)
+            if i >= len(stage_edges) or stage_edges[i] > deadline:
+                times = None
+                break
+            after = stage_edges[i]
+            times.append(after - s.issued_s)
+        results.append(times)
+    return results
+
+def percentile(values: list[float], p: float) -> float:
+    """The p'th percentile (0 to 100) of values, by nearest rank."""
+    ordered = sorted(values)
+    rank = max(0, math.ceil(p / 100.0 * len(ordered)) - 1)
+    return ordered[rank]
+
+def report(sent: list[Sent], results: list[list[float]|None], out=sys.stdout):
+    """Print each command type's latency percentiles, in microseconds from issue, for each stage."""
+    writer = csv.writer(out)
+    writer.writerow(["command", "stage", "samples", "lost", "p50_us", "p90_us", "p99_us", "max_us"])
+    for command_type in dict.fromkeys(s.command_type for s in sent):
+        mine = [r for s, r in zip(sent, results) if s.command_type == command_type]
+        complete = [r for r in mine if r is not None]
+        lost = len(mine) - len(complete)
+        for i, stage in enumerate(STAGES):
+            if not complete:
+                writer.writerow([command_type, stage, 0, lost, "-", "-", "-", "-"])
+                continue
+            us = [r[i] * 1e6 for r in complete]
+            writer.writerow([command_type, stage, len(us), lost] + [f"{percentile(us, p):.0f}" for p in (50, 90, 99)] + [f"{max(us):.0f}"])
+
+def write_log(path: str, sent: list[Sent]):
+    """Record what was sent, in order, for `analyze`."""
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(["command_type", "command", "issued_s"])
+        for s in sent:
+            writer.writerow([s.command_type, f"0x{s.command:02X}", f"{s.issued_s:.9f}"])
+
+def read_log(path: str) -> list[Sent]:
+    """Read back a log written by write_log()."""
+    with open(path, newline='') as f:
+        return [Sent(row["command_type"], int(row["command"], 16), float(row["issued_s"])) for row in csv.DictReader(f)]
+
+def read_analyzer_export(path: str, columns: list[str]) -> tuple[list[float], dict[str, list[float]]]:
+    """
+    Read a logic analyzer's CSV export (e.g. from PulseView or Saleae Logic): a header, then a time
+    in seconds and each channel's level (0 or 1) per row. columns names the channels for the
+    issue pin and each probe, in that order. Returns the issue pin's edges, and each stage's edges.
+    """
+    names = ["issue"] + list(STAGES)
+    edges = {name: [] for name in names}
+    with open(path, newline='') as f:
+        rows = csv.reader(row for row in f if not row.startswith(';'))
+        header = [h.strip() for h in next(rows)]
+        missing = [c for c in columns if c not in header]
+        if missing:
+            raise ValueError(f"No column(s) {missing} in {path}. Columns are: {header}")
+        indexes = [header.index(c) for c in columns]
+        last = [None] * len(names)
+        for row in rows:
+            if not row:
+                continue
+            t = float(row[0])
+            for k, i in enumerate(indexes):
+                level = int(float(row[i]))
+                if last[k] is not None and level != last[k]:
+                    edges[names[k]].append(t)
+                last[k] = level
+    return edges.pop("issue"), edges
+
+def run(args) -> list[Sent]:
+    """Send the commands from the controller, timing the probes on its GPIOs unless they go to an analyzer."""
+    # These only exist on the controller
+    from artie_i2c import i2c
+    from artie_util import boardconfig_controller as board
+    import RPi.GPIO as GPIO
+
+    address = board.I2C_ADDRESS_EYEBROWS_MCU_LEFT if args.side == "left" else board.I2C_ADDRESS_EYEBROWS_MCU_RIGHT
+    GPIO.setmode(GPIO.BCM)
+
+    edges = {stage: [] for stage in STAGES}
+    lock = threading.Lock()
+    if args.probe_pins:
+        pins = [int(p) for p in args.probe_pins.split(',')]
+        if len(pins) != len(STAGES):
+            raise ValueError(f"--probe-pins needs {len(STAGES)} pins ({', '.join(STAGES)})")
+
+        def on_edge(pin):
+            t = time.monotonic()
+            with lock:
+                edges[STAGES[pins.index(pin)]].append(t)
+
+        for pin in pins:
+            GPIO.setup(pin, GPIO.IN)
+            GPIO.add_event_detect(pin, GPIO.BOTH, callback=on_edge)
+
+    issue_level = False
+    if args.issue_pin is not None:
+        GPIO.setup(args.issue_pin, GPIO.OUT, initial=issue_level)
+
+    sent = []
+    try:
+        for command_type in args.commands:
+            for i in range(args.count):
+                command = COMMAND_TYPES[command_type](i)
+                if args.issue_pin is not None:
+                    issue_level = not issue_level
+                    GPIO.output(args.issue_pin, issue_level)
+                issued = time.monotonic()
+                if not i2c.write_bytes_to_address(address, command):
+                    log.error(f"Could not send 0x{command:02X} to the {args.side} eyebrow")
+                sent.append(Sent(command_type, command, issued))
+                time.sleep(args.interval_ms / 1000.0)
+    finally:
+        GPIO.cleanup()
+
+    if args.log:
+        write_log(args.log, sent)
+    if args.probe_pins:
+        with lock:
+            for stage in STAGES:
+                edges[stage].sort()
+            report(sent, match_stages(sent, edges, args.timeout_ms / 1000.0))
+    return sent
+
+def analyze(args):
+    """Time the commands in a log from a logic analyzer's capture of the issue pin and the probes."""
+    logged = read_log(args.log)
+    issues, edges = read_analyzer_export(args.capture, args.columns.split(','))
+    if len(issues) != len(logged):
+        log.warning(f"{len(logged)} commands in {args.log}, but {len(issues)} issue edges in {args.capture}. Matching the first ones.")
+
+    # The analyzer's clock isn't ours, so each command was issued at its edge on the issue pin
+    sent = [Sent(s.command_type, s.command, t) for s, t in zip(logged, issues)]
+    report(sent, match_stages(sent, edges, args.timeout_ms / 1000.0))
+
+def main():
+    parser = argparse.ArgumentParser(description="Time LCD commands from the controller's write to the eyebrow's glass. Needs firmware built with TRACE_PROBES.")
+    parser.add_argument("--loglevel", type=str, default="INFO", choices=["DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"], help="Logging level (default: INFO)")
+    subparsers = parser.add_subparsers(dest="mode", required=True)
+
+    run_parser = subparsers.add_parser("run", help="Send commands (on the controller), and time them if the probes are wired to its GPIOs")
+    run_parser.add_argument("--side", choices=["left", "right"], default="left", help="Which eyebrow to send to")
+    run_parser.add_argument("--commands", nargs='+', choices=list(COMMAND_TYPES), default=["draw"], help="Command types to time")
+    run_parser.add_argument("--count", type=int, default=200, help="Commands of each type to send")
+    run_parser.add_argument("--interval-ms", type=float, default=100.0, help="Time between commands. Leave room for a frame or two.")
+    run_parser.add_argument("--probe-pins", type=str, default=None, help=f"The controller's GPIOs (BCM) wired to the probes, in the order {','.join(STAGES)}")
+    run_parser.add_argument("--issue-pin", type=int, default=None, help="A controller GPIO (BCM) to toggle as each command is issued, for a logic analyzer")
+    run_parser.add_argument("--log", type=str, default=None, help="Write what was sent to this CSV, for 'analyze'")
+    run_parser.add_argument("--timeout-ms", type=float, default=500.0, help="Give up on a command whose stages haven't all happened by then")
+
+    analyze_parser = subparsers.add_parser("analyze", help="Time the commands in a run's log from a logic analyzer's CSV export")
+    analyze_parser.add_argument("log", type=str, help="The log written by 'run --log'")
+    analyze_parser.add_argument("capture", type=str, help="The analyzer's CSV export")
+    analyze_parser.add_argument("--columns", type=str, default="D0,D1,D2,D3,D4", help=f"The export's columns for the issue pin and the probes, in the order issue,{','.join(STAGES)}")
+    analyze_parser.add_argument("--timeout-ms", type=float, default=500.0, help="Give up on a command whose stages haven't all happened by then")
+
+    args = parser.parse_args()
+    log.initialize_logger(getattr(log.logging, args.loglevel))
+    if args.mode == "run":
+        run(args)
+    else:
+        analyze(args)
+
+if __name__ == "__main__":
+    main()
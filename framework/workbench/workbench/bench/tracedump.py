@@ -0,0 +1,241 @@
+"""
+Pulls the trace events an MCU has recorded (firmware built with TRACE_ENABLED, see the trace
+library) and writes them as a Chrome JSON trace, to open in Perfetto (ui.perfetto.dev) or
+chrome://tracing and see how the command bus ISR, dispatch, and rendering overlap.
+
+Three ways to get the events:
+
+* i2c: over the command bus, a few at a time (CMD_QUERY_TRACE), on the controller.
+* serial: from the MCU's USB stdio, where CMD_DUMP_TRACE prints them all as CSV. Sends the command
+  over I2C too if given --trigger-address (on the controller), or wait for someone else to.
+* file: from a capture of that output (e.g. `cat /dev/ttyACM0 > capture.txt`).
+
+Both cores stamp their events with the same microsecond timer, so their spans line up as they are;
+all that's needed is to undo the timer's wrapping every 71 minutes. Each MCU has its own timer,
+though, so several MCUs' traces can't be lined up with each other: each is its own process.
+"""
+from workbench.util import log
+import argparse
+import dataclasses
+import json
+import struct
+import sys
+import time
+
+# See trace.h, and the firmware's board/types.h
+TRACE_FLAG_END = 0x01
+TRACE_FLAG_CORE1 = 0x02
+TRACE_PACKED_EVENT_LEN = 8
+CMDS_REGISTER_MAX_LEN = 32
+CMD_QUERY_TRACE = 0x20
+CMD_DUMP_TRACE = 0x21
+
+# trace_id_t, as trace_dump() names them
+TRACE_NAMES = [
+    "i2c_isr",
+    "cmd_dispatch",
+    "graphics_cmd",
+    "servo_cmd",
+    "sensor_read_imu",
+    "sensor_read_temp",
+    "render_frame",
+    "lcd_flush",
+]
+
+# Events whose arg is a command byte, shown in hex
+COMMAND_EVENTS = {"cmd_dispatch", "graphics_cmd", "servo_cmd"}
+
+# Interrupts nest inside whatever their core was doing, so they get a track of their own
+IRQ_EVENTS = {"i2c_isr"}
+
+@dataclasses.dataclass
+class Event:
+    """One recorded event, as trace_event_t."""
+    timestamp_us: int
+    core: int
+    name: str
+    end: bool
+    arg: int
+
+@dataclasses.dataclass
+class Trace:
+    """An MCU's events, oldest first, and how many it lost to its ring buffer filling up."""
+    name: str
+    events: list[Event]
+    dropped: int = 0
+
+def unpack_events(raw: list[int]) -> tuple[list[Event], int]:
+    """What trace_pack() wrote: its events, and how many were dropped before them."""
+    count, dropped = raw[0], raw[1]
+    if 2 + count * TRACE_PACKED_EVENT_LEN > len(raw):
+        raise ValueError(f"Says it holds {count} events, but is only {len(raw)} bytes")
+    events = []
+    for i in range(count):
+        timestamp_us, id, flags, arg = struct.unpack_from("<IBBH", bytes(raw), 2 + i * TRACE_PACKED_EVENT_LEN)
+        name = TRACE_NAMES[id] if id < len(TRACE_NAMES) else f"unknown_{id}"
+        events.append(Event(timestamp_us, 1 if flags & TRACE_FLAG_CORE1 else 0, name, bool(flags & TRACE_FLAG_END), arg))
+    return events, dropped
+
+def parse_dump(lines, name: str) -> Trace|None:
+    """The first trace_dump() output in these lines of stdio, or None if there isn't a whole one."""
+    trace = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("# trace begin"):
+            fields = dict(field.split("=", 1) for field in line.split(":", 1)[1].split() if "=" in field)
+            if fields.get("enabled") == "0":
+                log.warning(f"{name} was built without TRACE_ENABLED, so it has nothing to dump")
+            trace = Trace(name, [], int(fields.get("dropped", 0)))
+        elif trace is None or not line or line.startswith("timestamp_us"):
+            continue
+        elif line.startswith("# trace end"):
+            return trace
+        else:
+            timestamp_us, core, event, phase, arg = line.split(",")
+            trace.events.append(Event(int(timestamp_us), int(core), event, phase == "end", int(arg)))
+    return None
+
+def pull_i2c(address: int, interval_s: float) -> Trace:
+    """Ask for the oldest events over the command bus until there are none left."""
+    # This only exists on the controller
+    from artie_i2c import i2c
+
+    trace = Trace(f"mcu {hex(address)}", [])
+    while True:
+        if not i2c.write_bytes_to_address(address, CMD_QUERY_TRACE):
+            raise RuntimeError(f"Could not send CMD_QUERY_TRACE to {hex(address)}")
+        # Give the main loop time to load the response before reading it
+        time.sleep(interval_s)
+        raw = i2c.read_bytes_from_address(address, CMDS_REGISTER_MAX_LEN)
+        if raw is None:
+            raise RuntimeError(f"Could not read trace events from {hex(address)}")
+        events, dropped = unpack_events(raw)
+        trace.events += events
+        trace.dropped += dropped
+        if not events:
+            return trace
+
+def pull_serial(port: str, baud: int, trigger_address: int|None, timeout_s: float) -> Trace:
+    """Read the MCU's stdio until a whole trace_dump() has gone by."""
+    import serial
+
+    with serial.Serial(port, baud, timeout=timeout_s) as stdio:
+        stdio.reset_input_buffer()
+        if trigger_address is not None:
+            from artie_i2c import i2c
+            if not i2c.write_bytes_to_address(trigger_address, CMD_DUMP_TRACE):
+                raise RuntimeError(f"Could not send CMD_DUMP_TRACE to {hex(trigger_address)}")
+        else:
+            log.info("Waiting for CMD_DUMP_TRACE to be sent to the MCU...")
+
+        def lines():
+            while True:
+                line = stdio.readline()
+                if not line:
+                    raise RuntimeError(f"Nothing from {port} for {timeout_s} s")
+                yield line.decode("utf-8", errors="replace")
+
+        return parse_dump(lines(), port)
+
+def unwrap(events: list[Event]):
+    """Turn the 32-bit timer's stamps into ones that don't wrap, as long as no gap is over half its range."""
+    offset = 0
+    last = None
+    for e in events:
+        if last is not None and e.timestamp_us + offset < last - (1 << 31):
+            offset += 1 << 32
+        e.timestamp_us += offset
+        last = e.timestamp_us
+
+def track(e: Event) -> int:
+    """The thread ID an event shows under: each core, and each core's interrupts."""
+    return e.core * 2 + (1 if e.name in IRQ_EVENTS else 0)
+
+def describe(name: str, arg: int) -> str:
+    return f"0x{arg:02X}" if name in COMMAND_EVENTS else str(arg)
+
+def to_chrome(traces: list[Trace]) -> dict:
+    """
+    The traces as Chrome JSON trace events: a complete event ("X") for each span, an instant ("i")
+    for an end whose beginning was overwritten, and a span to the end of the trace for one still going.
+    """
+    out = []
+    for pid, trace in enumerate(traces, start=1):
+        if not trace.events:
+            continue
+        unwrap(trace.events)
+        start = trace.events[0].timestamp_us
+        last = trace.events[-1].timestamp_us
+        out.append({"ph": "M", "pid": pid, "name": "process_name", "args": {"name": trace.name}})
+        for tid, thread in enumerate(["core 0", "core 0 irq", "core 1", "core 1 irq"]):
+            out.append({"ph": "M", "pid": pid, "tid": tid, "name": "thread_name", "args": {"name": thread}})
+
+        open_spans: dict[tuple[int, str], list[Event]] = {}
+        for e in trace.events:
+            key = (track(e), e.name)
+            if not e.end:
+                open_spans.setdefault(key, []).append(e)
+                continue
+            stack = open_spans.get(key)
+            if not stack:
+                out.append({"ph": "i", "s": "t", "pid": pid, "tid": key[0], "name": e.name, "ts": e.timestamp_us - start,
+                            "args": {"end_arg": describe(e.name, e.arg), "note": "its beginning was lost"}})
+                continue
+            begin = stack.pop()
+            out.append({"ph": "X", "pid": pid, "tid": key[0], "name": e.name, "ts": begin.timestamp_us - start,
+                        "dur": e.timestamp_us - begin.timestamp_us,
+                        "args": {"arg": describe(e.name, begin.arg), "end_arg": describe(e.name, e.arg)}})
+        for (tid, name), stack in open_spans.items():
+            for begin in stack:
+                out.append({"ph": "X", "pid": pid, "tid": tid, "name": name, "ts": begin.timestamp_us - start,
+                            "dur": last - begin.timestamp_us, "args": {"arg": describe(name, begin.arg), "note": "still going at the end of the trace"}})
+        if trace.dropped:
+            out.append({"ph": "i", "s": "p", "pid": pid, "tid": 0, "name": "events dropped", "ts": 0, "args": {"dropped": trace.dropped}})
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+def main():
+    parser = argparse.ArgumentParser(description="Pull an MCU's trace events and write them as a Chrome JSON trace for Perfetto.")
+    parser.add_argument("--out", type=str, default="trace.json", help="Where to write the trace")
+    parser.add_argument("--loglevel", type=str, default="INFO", choices=["DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"], help="Logging level (default: INFO)")
+    subparsers = parser.add_subparsers(dest="source", required=True)
+
+    i2c_parser = subparsers.add_parser("i2c", help="Over the command bus, on the controller")
+    i2c_parser.add_argument("addresses", type=lambda a: int(a, 0), nargs="+", help="The MCUs' I2C addresses (e.g. 0x17 0x18)")
+    i2c_parser.add_argument("--interval-ms", type=float, default=5.0, help="Time between asking for events and reading them")
+
+    serial_parser = subparsers.add_parser("serial", help="From the MCU's USB stdio")
+    serial_parser.add_argument("port", type=str, help="The MCU's serial port (e.g. /dev/ttyACM0)")
+    serial_parser.add_argument("--baud", type=int, default=115200)
+    serial_parser.add_argument("--trigger-address", type=lambda a: int(a, 0), default=None, help="Send CMD_DUMP_TRACE to this I2C address (on the controller)")
+    serial_parser.add_argument("--timeout", type=float, default=10.0, help="Give up after this long without output (seconds)")
+
+    file_parser = subparsers.add_parser("file", help="From captures of the MCUs' USB stdio")
+    file_parser.add_argument("captures", type=str, nargs="+", help="Captures holding a trace dump each")
+
+    args = parser.parse_args()
+    log.initialize_logger(getattr(log.logging, args.loglevel))
+
+    traces = []
+    if args.source == "i2c":
+        traces = [pull_i2c(address, args.interval_ms / 1000.0) for address in args.addresses]
+    elif args.source == "serial":
+        traces = [pull_serial(args.port, args.baud, args.trigger_address, args.timeout)]
+    else:
+        for path in args.captures:
+            with open(path, encoding="utf-8", errors="replace") as f:
+                traces.append(parse_dump(f, path))
+
+    for i, trace in enumerate(traces):
+        if trace is None:
+            log.error(f"No whole trace dump in {args.captures[i] if args.source == 'file' else args.port}")
+            sys.exit(1)
+        print(f"{trace.name}: {len(trace.events)} events, {trace.dropped} dropped")
+        if trace.dropped:
+            log.warning(f"{trace.name} overwrote {trace.dropped} events before they were read; pull more often, or build with a bigger TRACE_BUFFER_LEN")
+
+    with open(args.out, "w") as f:
+        json.dump(to_chrome(traces), f)
+    print(f"Wrote {args.out}; open it at ui.perfetto.dev")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+"""
+Sends pictures to an eyebrow or mouth LCD over USB, for firmware built with USB_FRAMES
+(see the firmware's usb/usbframes.h for the protocol), and measures how fast they go.
+
+The MCU is a composite USB device: its stdio serial port, and a vendor interface with a bulk
+endpoint each way. Rectangles are sent in the pixel format the MCU's INFO reply asks for,
+so the same images work whichever way the firmware was built.
+
+Runs wherever the MCU's USB port is plugged in. Needs pyusb (and libusb).
+"""
+from workbench.util import log
+import argparse
+import dataclasses
+import struct
+import sys
+import time
+
+# See usbframes.h
+USBFRAMES_VERSION = 1
+MSG_INFO = 0x01
+MSG_FRAME = 0x02
+MSG_RECT = 0x03
+MSG_SYNC = 0x04
+DEFAULT_VID = 0x2E8A
+DEFAULT_PID = 0x000A
+VENDOR_CLASS = 0xFF
+
+@dataclasses.dataclass
+class Info:
+    """The INFO reply: what the LCD takes."""
+    version: int
+    pixel_bits: int     # 16 (RGB565, high byte first) or 12 (RGB444, two pixels in three bytes)
+    scale: int          # The frame format: Paint_SetScale(), Paint_SetRotate(), and the paint buffer's size
+    rotate: int
+    width_memory: int
+    height_memory: int
+    width: int          # The LCD's size
+    height: int
+    max_frame: int      # Bytes in the biggest frame it takes
+
+    @staticmethod
+    def unpack(raw: bytes) -> 'Info':
+        if len(raw) != 18 or raw[0] != MSG_INFO:
+            raise ValueError(f"Not an INFO reply: {raw.hex()}")
+        return Info(raw[1], raw[2], *struct.unpack("<BHHHHHI", raw[3:]))
+
+def pixel_bytes(info: Info, pixels: int) -> int:
+    """Bytes that many pixels take in the LCD's format."""
+    return (pixels * 3 + 1) // 2 if info.pixel_bits == 12 else pixels * 2
+
+def encode_pixels(info: Info, rgb: list[tuple[int, int, int]]) -> bytes:
+    """8-bit RGB pixels, a row at a time, in the LCD's format."""
+    if info.pixel_bits == 12:
+        nibbles = []
+        for r, g, b in rgb:
+            nibbles += [r >> 4, g >> 4, b >> 4]
+        if len(nibbles) % 2:
+            nibbles.append(0)
+        return bytes((nibbles[i] << 4) | nibbles[i + 1] for i in range(0, len(nibbles), 2))
+    out = bytearray()
+    for r, g, b in rgb:
+        out += struct.pack(">H", ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return bytes(out)
+
+def read_ppm(path: str) -> tuple[int, int, list[tuple[int, int, int]]]:
+    """A binary (P6) PPM with 8 bits a channel, like gfxsim's dumps: width, height, and its pixels."""
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError(f"{path} is not an 8-bit binary PPM")
+    width, height = int(fields[1]), int(fields[2])
+    raw = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [tuple(raw[i:i + 3]) for i in range(0, len(raw), 3)]
+
+class UsbFrames:
+    """The MCU's vendor interface."""
+    def __init__(self, vid: int, pid: int, serial: str | None, timeout_ms: int):
+        import usb.core
+        import usb.util
+
+        matches = {"idVendor": vid, "idProduct": pid}
+        if serial is not None:
+            matches["serial_number"] = serial
+        self.dev = usb.core.find(**matches)
+        if self.dev is None:
+            raise RuntimeError(f"No device {vid:04x}:{pid:04x}" + (f" with serial {serial}" if serial else ""))
+
+        intf = next((i for i in self.dev.get_active_configuration() if i.bInterfaceClass == VENDOR_CLASS), None)
+        if intf is None:
+            raise RuntimeError("The device has no frames interface. Was the firmware built with USB_FRAMES?")
+        usb.util.claim_interface(self.dev, intf.bInterfaceNumber)
+        direction = usb.util.endpoint_direction
+        self.ep_out = next(e for e in intf if direction(e.bEndpointAddress) == usb.util.ENDPOINT_OUT)
+        self.ep_in = next(e for e in intf if direction(e.bEndpointAddress) == usb.util.ENDPOINT_IN)
+        self.timeout_ms = timeout_ms
+
+    def write(self, data: bytes):
+        self.ep_out.write(data, timeout=self.timeout_ms)
+
+    def read(self, n: int) -> bytes:
+        return bytes(self.ep_in.read(n, timeout=self.timeout_ms))
+
+    def info(self) -> Info:
+        self.write(bytes([MSG_INFO]))
+        info = Info.unpack(self.read(18))
+        if info.version != USBFRAMES_VERSION:
+            raise RuntimeError(f"The firmware speaks version {info.version} of the protocol; we speak {USBFRAMES_VERSION}")
+        return info
+
+    def rect(self, x: int, y: int, w: int, h: int, pixels: bytes):
+        self.write(struct.pack("<BHHHH", MSG_RECT, x, y, w, h) + pixels)
+
+    def frame(self, scale: int, rotate: int, width_memory: int, height_memory: int, bounds: tuple[int, int, int, int], data: bytes):
+        self.write(struct.pack("<BBHHHHHHHI", MSG_FRAME, scale, rotate, width_memory, height_memory, *bounds, len(data)) + data)
+
+    def sync(self) -> int:
+        """Wait for everything sent so far to be on the LCD. Returns how many messages it turned away since the last sync."""
+        self.write(bytes([MSG_SYNC]))
+        raw = self.read(3)
+        if len(raw) != 3 or raw[0] != MSG_SYNC:
+            raise RuntimeError(f"Not a SYNC reply: {raw.hex()}")
+        return raw[1] | (raw[2] << 8)
+
+def parse_color(color: str) -> tuple[int, int, int]:
+    """'#rrggbb' or 'rrggbb'."""
+    value = int(color.lstrip("#"), 16)
+    return (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF
+
+def cmd_info(dev: UsbFrames, args):
+    info = dev.info()
+    for field in dataclasses.fields(info):
+        print(f"{field.name}: {getattr(info, field.name)}")
+
+def cmd_rect(dev: UsbFrames, args):
+    info = dev.info()
+    if args.image is not None:
+        w, h, rgb = read_ppm(args.image)
+    else:
+        w = args.width if args.width is not None else info.width - args.x
+        h = args.height if args.height is not None else info.height - args.y
+        rgb = [parse_color(args.color)] * (w * h)
+    dev.rect(args.x, args.y, w, h, encode_pixels(info, rgb))
+    rejected = dev.sync()
+    if rejected:
+        log.error(f"The MCU turned away {rejected} message(s); see its log")
+        sys.exit(1)
+
+def cmd_throughput(dev: UsbFrames, args):
+    info = dev.info()
+    w = args.width if args.width is not None else info.width
+    h = args.height if args.height is not None else info.height
+    # Two colours, so every rectangle changes every pixel
+    pictures = [encode_pixels(info, [parse_color(c)] * (w * h)) for c in ("000000", "ffffff")]
+    print(f"# usbframes {w}x{h} at {info.pixel_bits} bits a pixel, {pixel_bytes(info, w * h)} bytes each")
+
+    sent = 0
+    rejected = 0
+    start = time.monotonic()
+    while time.monotonic() - start < args.seconds:
+        dev.rect(0, 0, w, h, pictures[sent % 2])
+        sent += 1
+        if sent % args.sync_every == 0:
+            rejected += dev.sync()
+    rejected += dev.sync()
+    elapsed = time.monotonic() - start
+
+    nbytes = sent * len(pictures[0])
+    print(f"rects: {sent} in {elapsed:.2f} s, {sent / elapsed:.1f}/s")
+    print(f"throughput: {nbytes / elapsed / 1024:.1f} KiB/s")
+    print(f"rejected: {rejected}")
+
+def main():
+    parser = argparse.ArgumentParser(description="Send pictures to an eyebrow or mouth LCD over USB (firmware built with USB_FRAMES).")
+    parser.add_argument("--vid", type=lambda v: int(v, 0), default=DEFAULT_VID, help="USB vendor ID")
+    parser.add_argument("--pid", type=lambda v: int(v, 0), default=DEFAULT_PID, help="USB product ID")
+    parser.add_argument("--serial", type=str, default=None, help="USB serial number, to pick one of several MCUs")
+    parser.add_argument("--timeout-ms", type=int, default=2000, help="USB transfer timeout")
+    parser.add_argument("--loglevel", type=str, default="INFO", choices=["DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"], help="Logging level (default: INFO)")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    subparsers.add_parser("info", help="Print what the LCD takes").set_defaults(func=cmd_info)
+
+    rect = subparsers.add_parser("rect", help="Send a rectangle of one colour, or a PPM image")
+    rect.add_argument("--x", type=int, default=0)
+    rect.add_argument("--y", type=int, default=0)
+    rect.add_argument("--width", type=int, default=None, help="Default: to the right edge")
+    rect.add_argument("--height", type=int, default=None, help="Default: to the bottom edge")
+    rect.add_argument("--color", type=str, default="ff0000", help="rrggbb")
+    rect.add_argument("--image", type=str, default=None, help="Binary PPM to send instead, at its own size")
+    rect.set_defaults(func=cmd_rect)
+
+    throughput = subparsers.add_parser("throughput", help="Send rectangles as fast as they go, and report the rate")
+    throughput.add_argument("--width", type=int, default=None, help="Default: the whole LCD")
+    throughput.add_argument("--height", type=int, default=None, help="Default: the whole LCD")
+    throughput.add_argument("--seconds", type=float, default=5.0)
+    throughput.add_argument("--sync-every", type=int, default=8, help="Rectangles between syncs")
+    throughput.set_defaults(func=cmd_throughput)
+
+    args = parser.parse_args()
+    log.initialize_logger(getattr(log.logging, args.loglevel))
+    args.func(UsbFrames(args.vid, args.pid, args.serial, args.timeout_ms), args)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+"""
+Streams the head sensors' IMU samples into a fixed-size ring, for the sensors tab to plot.
+
+The sensor MCU keeps every IMU sample in its history and hands them out a page (up to 10 samples)
+at a time (see the sensors firmware's README, History). A feed is anything that yields those pages
+as bytes. The ring is allocated once, and each page goes into it as one slice assignment per
+channel, so taking in samples at kHz rates costs a few copies per page rather than any work per
+sample. Plotting reads the ring back decimated to a min/max pair per pixel column, so a spike
+shorter than a column still shows.
+"""
+from PyQt6 import QtCore
+import array
+import sys
+import threading
+import time
+
+# See the sensors firmware's history.h, sensors.h, and the cmds library's cmds.h
+HISTORY_PAGE_VERSION = 0x01
+HISTORY_LEVEL_RAW = 0
+HISTORY_PAGE_HEADER_LEN = 8
+HISTORY_RAW_RECORD_LEN = 16
+CMD_SENSORS_READ_HISTORY = 0x9C
+CMDS_REGISTER_SELECT = 0xC0
+CMDS_REGISTER_MAX_LEN = 32
+SENSORS_REG_HISTORY = 0x50
+SENSORS_HISTORY_WINDOW_LEN = 176
+SENSORS_I2C_ADDRESS = 0x1A
+
+# A raw record as int16s: its timestamp (two of them), then accel X, Y, Z and gyro X, Y, Z
+RECORD_WORDS = HISTORY_RAW_RECORD_LEN // 2
+FIRST_CHANNEL_WORD = 2
+
+CHANNEL_NAMES = ["Accel X", "Accel Y", "Accel Z", "Gyro X", "Gyro Y", "Gyro Z"]
+NUM_CHANNELS = len(CHANNEL_NAMES)
+
+# Time between asking for a page and reading it, for the MCU's main loop to pack it
+RESPONSE_DELAY_S = 0.001
+
+# How long to wait after an empty page. The MCU keeps 256 samples, so this is well inside what it holds at kHz rates.
+EMPTY_PAGE_WAIT_S = 0.01
+
+class ImuRing:
+    """
+    The newest `capacity` IMU samples, a ring per channel, and their timestamps. One thread (the feed's)
+    adds pages while another (the GUI's) reads it, each holding the lock only for slice copies.
+    """
+    def __init__(self, capacity: int = 1 << 16):
+        self.capacity = capacity
+        self._channels = [array.array("h", bytes(2 * capacity)) for _ in range(NUM_CHANNELS)]
+        self._timestamps_ms = array.array("I", bytes(4 * capacity))
+        self._lock = threading.Lock()
+        self._written = 0           # Samples ever added. The newest is at (_written - 1) % capacity
+        self._lost = 0              # Samples the MCU overwrote before we read them, or that we skipped
+        self._next_sequence = None  # What the next page's first sequence number should be
+
+    def clear(self):
+        with self._lock:
+            self._written = 0
+            self._lost = 0
+            self._next_sequence = None
+
+    @property
+    def written(self) -> int:
+        return self._written
+
+    @property
+    def lost(self) -> int:
+        return self._lost
+
+    def add_page(self, page: bytes) -> int:
+        """Add a raw history page's samples and return how many it had. Raises ValueError if it isn't one."""
+        if len(page) < HISTORY_PAGE_HEADER_LEN or page[0] != HISTORY_PAGE_VERSION or page[1] != HISTORY_LEVEL_RAW:
+            raise ValueError("Not a raw history page")
+        count, lost = page[2], page[3]
+        sequence = int.from_bytes(page[4:8], "little")
+        end = HISTORY_PAGE_HEADER_LEN + count * HISTORY_RAW_RECORD_LEN
+        if len(page) < end:
+            raise ValueError(f"Says it holds {count} samples, but is only {len(page)} bytes")
+        if count == 0:
+            return 0
+
+        # The records as int16s and as uint32s, each channel (and the timestamps) a strided slice of one of them
+        records = bytes(page[HISTORY_PAGE_HEADER_LEN:end])
+        words = array.array("h", records)
+        stamps = array.array("I", records)
+        if sys.byteorder != "little":
+            words.byteswap()
+            stamps.byteswap()
+
+        with self._lock:
+            if self._next_sequence is not None:
+                # The header counts what the MCU overwrote; a gap past that is pages we never read
+                self._lost += max(lost, (sequence - self._next_sequence) & 0xFFFFFFFF)
+            self._next_sequence = (sequence + count) & 0xFFFFFFFF
+
+            start = self._written % self.capacity
+            first = min(count, self.capacity - start)
+            for ring, samples in zip(self._channels + [self._timestamps_ms],
+                                     [words[FIRST_CHANNEL_WORD + c::RECORD_WORDS] for c in range(NUM_CHANNELS)] + [stamps[::RECORD_WORDS // 2]]):
+                ring[start:start + first] = samples[:first]
+                if first < count:
+                    ring[:count - first] = samples[first:]
+            self._written += count
+        return count
+
+    def rate_hz(self, nsamples: int) -> float:
+        """The sample rate over the last `nsamples` (or as many as there are), by their timestamps. 0 if it can't tell."""
+        with self._lock:
+            n = min(nsamples, self._written, self.capacity)
+            if n < 2:
+                return 0.0
+            newest = (self._written - 1) % self.capacity
+            oldest = (self._written - n) % self.capacity
+            span_ms = (self._timestamps_ms[newest] - self._timestamps_ms[oldest]) & 0xFFFFFFFF
+        return (n - 1) * 1000.0 / span_ms if span_ms else 0.0
+
+    def decimate(self, channel: int, nsamples: int, out_min: array.array, out_max: array.array) -> int:
+        """
+        Fill `out_min` and `out_max` (one entry per column) with the least and greatest of `channel` over
+        each column's share of the last `nsamples`, oldest first. Returns how many columns got samples,
+        which is fewer than asked for when there aren't yet enough samples for one a column.
+        """
+        columns = len(out_min)
+        with self._lock:
+            n = min(nsamples, self._written, self.capacity)
+            used = min(columns, n)
+            if used == 0:
+                return 0
+            ring = memoryview(self._channels[channel])
+            first = self._written - n
+            for col in range(used):
+                # Positions in the ring, which a column's share may wrap around the end of
+                lo = (first + col * n // used) % self.capacity
+                hi = (first + (col + 1) * n // used - 1) % self.capacity + 1
+                if lo < hi:
+                    share = ring[lo:hi]
+                    out_min[col] = min(share)
+                    out_max[col] = max(share)
+                else:
+                    head, tail = ring[lo:], ring[:hi]
+                    out_min[col] = min(min(head), min(tail))
+                    out_max[col] = max(max(head), max(tail))
+            ring.release()
+        return used
+
+class I2CPageSource:
+    """
+    Raw history pages from the sensor MCU over the command bus, through artie_i2c, so only on the controller.
+    Returns each page as soon as it has one, and waits a little when the MCU has nothing new. Raises
+    OSError when the MCU doesn't answer.
+    """
+    def __init__(self, address: int = SENSORS_I2C_ADDRESS):
+        from artie_i2c import i2c
+        self._i2c = i2c
+        self._address = address
+
+    def __call__(self) -> bytes:
+        if not self._i2c.write_bytes_to_address(self._address, CMD_SENSORS_READ_HISTORY | HISTORY_LEVEL_RAW):
+            raise OSError(f"No answer from the sensor MCU at 0x{self._address:02X}")
+        time.sleep(RESPONSE_DELAY_S)
+        page = self._read(SENSORS_REG_HISTORY, HISTORY_PAGE_HEADER_LEN)
+        length = min(HISTORY_PAGE_HEADER_LEN + page[2] * HISTORY_RAW_RECORD_LEN, SENSORS_HISTORY_WINDOW_LEN)
+        for offset in range(len(page), length, CMDS_REGISTER_MAX_LEN):
+            page += self._read(SENSORS_REG_HISTORY + offset, min(CMDS_REGISTER_MAX_LEN, length - offset))
+        if page[2] == 0:
+            time.sleep(EMPTY_PAGE_WAIT_S)
+        return page
+
+    def _read(self, register: int, nbytes: int) -> bytes:
+        raw = self._i2c.write_then_read_bytes(self._address, [CMDS_REGISTER_SELECT, register], nbytes)
+        if raw is None or len(raw) != nbytes:
+            raise OSError(f"Short read from the sensor MCU at 0x{self._address:02X}")
+        return bytes(raw)
+
+class FilePageSource:
+    """
+    Raw history pages from a capture (pages back to back, as read), played back as fast as the samples'
+    own timestamps say they came in. Returns None at the end.
+    """
+    def __init__(self, fpath: str):
+        with open(fpath, "rb") as f:
+            self._data = f.read()
+        self._pos = 0
+        self._start_ms = None
+        self._start_s = None
+
+    def __call__(self) -> bytes|None:
+        if self._pos + HISTORY_PAGE_HEADER_LEN > len(self._data):
+            return None
+        end = self._pos + HISTORY_PAGE_HEADER_LEN + self._data[self._pos + 2] * HISTORY_RAW_RECORD_LEN
+        page = self._data[self._pos:end]
+        self._pos = end
+        if len(page) > HISTORY_PAGE_HEADER_LEN:
+            # Hold the page back until its last sample is due
+            last_ms = int.from_bytes(page[-HISTORY_RAW_RECORD_LEN:][:4], "little")
+            if self._start_ms is None:
+                self._start_ms, self._start_s = last_ms, time.monotonic()
+            wait_s = ((last_ms - self._start_ms) & 0xFFFFFFFF) / 1000.0 - (time.monotonic() - self._start_s)
+            if wait_s > 0:
+                time.sleep(wait_s)
+        return page
+
+class ImuStreamThread(QtCore.QThread):
+    """
+    Runs a page source (a callable returning the next page, or None once it has no more) into an ImuRing
+    until stopped or the source runs out. An OSError from the source is reported and tried again.
+    """
+    error_signal = QtCore.pyqtSignal(str)
+    """Emitted when the source fails or hands back something that isn't a page."""
+
+    stopped_signal = QtCore.pyqtSignal(str)
+    """Emitted when the thread is stopped."""
+
+    def __init__(self, parent, ring: ImuRing, source):
+        super().__init__(parent)
+        self.ring = ring
+        self.source = source
+        self._running = True
+
+    def stop(self):
+        """Stop the thread"""
+        self._running = False
+
+    def run(self):
+        """Run the thread."""
+        while self._running:
+            try:
+                page = self.source()
+            except OSError as e:
+                self.error_signal.emit(str(e))
+                time.sleep(EMPTY_PAGE_WAIT_S)
+                continue
+            if page is None:
+                break
+            try:
+                self.ring.add_page(page)
+            except ValueError as e:
+                self.error_signal.emit(f"Bad IMU page: {e}")
+
+        # Tell anyone who cares that the thread has exited
+        self.stopped_signal.emit(type(self).__name__)
@@ -0,0 +1,95 @@
+"""
+Plot widget for IMU samples streaming into an ImuRing
+"""
+from PyQt6 import QtWidgets, QtCore, QtGui
+from .. import colors
+from ..utils import imu_stream
+import array
+
+# How often the plot redraws. Samples come in far faster than this, so it never draws per page.
+REDRAW_INTERVAL_MS = 33
+
+# Colors of each channel's trace, in x, y, z order (accel and gyro alike)
+TRACE_COLORS = [colors.BasePalette.RED, colors.BasePalette.GREEN, "#2196F3"]
+
+
+class ImuPlot(QtWidgets.QWidget):
+    """
+    Plots three of an ImuRing's channels (accel or gyro) over a window of the newest samples, as a
+    min/max band per pixel column. Everything it draws from is allocated when its width changes.
+    """
+
+    def __init__(self, ring: imu_stream.ImuRing, parent=None):
+        super().__init__(parent)
+        self.ring = ring
+        self.first_channel = 0
+        self.window_samples = 4096
+        self._mins = []
+        self._maxes = []
+        self._columns = 0
+
+        self.setMinimumHeight(200)
+        self.setSizePolicy(QtWidgets.QSizePolicy.Policy.Expanding, QtWidgets.QSizePolicy.Policy.Expanding)
+
+        self._timer = QtCore.QTimer(self)
+        self._timer.timeout.connect(self.update)
+
+    def start(self):
+        """Start redrawing as samples come in."""
+        self._timer.start(REDRAW_INTERVAL_MS)
+
+    def stop(self):
+        """Stop redrawing (and keep showing what was last drawn)."""
+        self._timer.stop()
+        self.update()
+
+    def set_channels(self, first_channel: int):
+        """Plot channels `first_channel` to `first_channel + 2` (0 for accel, 3 for gyro)."""
+        self.first_channel = first_channel
+        self.update()
+
+    def set_window(self, nsamples: int):
+        """Plot the newest `nsamples` samples across the width of the widget."""
+        self.window_samples = min(nsamples, self.ring.capacity)
+        self.update()
+
+    def _ensure_columns(self, columns: int):
+        if columns != self._columns:
+            self._mins = [array.array("h", bytes(2 * columns)) for _ in TRACE_COLORS]
+            self._maxes = [array.array("h", bytes(2 * columns)) for _ in TRACE_COLORS]
+            self._columns = columns
+
+    def paintEvent(self, event):
+        """Draw the traces, scaled to the largest magnitude on show."""
+        painter = QtGui.QPainter(self)
+        painter.fillRect(self.rect(), QtGui.QColor(colors.BasePalette.DARKEST))
+        width, height = self.width(), self.height()
+        if width <= 0 or height <= 0:
+            return
+        self._ensure_columns(width)
+
+        used = [self.ring.decimate(self.first_channel + i, self.window_samples, self._mins[i], self._maxes[i])
+                for i in range(len(TRACE_COLORS))]
+        peak = 1
+        for i, n in enumerate(used):
+            if n:
+                peak = max(peak, -min(self._mins[i][:n]), max(self._maxes[i][:n]))
+        scale = (height / 2 - 1) / peak
+        mid = height / 2
+
+        painter.setPen(QtGui.QPen(QtGui.QColor(colors.BasePalette.GRAY)))
+        painter.drawLine(0, int(mid), width, int(mid))
+
+        for i, color in enumerate(TRACE_COLORS):
+            painter.setPen(QtGui.QPen(QtGui.QColor(color)))
+            mins, maxes = self._mins[i], self._maxes[i]
+            # Right-align, so the newest sample is always at the right edge
+            x0 = width - used[i]
+            for col in range(used[i]):
+                painter.drawLine(x0 + col, int(mid - maxes[col] * scale), x0 + col, int(mid - mins[col] * scale))
+
+        painter.setPen(QtGui.QPen(QtGui.QColor(colors.BasePalette.LIGHT)))
+        painter.drawText(4, 14, f"±{peak} (raw)")
+        for i, color in enumerate(TRACE_COLORS):
+            painter.setPen(QtGui.QPen(QtGui.QColor(color)))
+            painter.drawText(4 + 80 * i, height - 4, imu_stream.CHANNEL_NAMES[self.first_channel + i])
@@ -4,8 +4,16 @@ Sensors tab widget for Artie Workbench
 from artie_tooling import artie_profile
 from PyQt6 import QtWidgets, QtCore
 from model import settings
+from ..utils import imu_stream
+from .imu_plot import ImuPlot
 from .status_icon import StatusGrid
 
+# Sample windows to plot, in samples
+WINDOW_CHOICES = [1024, 4096, 16384, 65536]
+
+# How often the rate and loss figures update
+STATS_INTERVAL_MS = 500
+
 
 class SensorsTab(QtWidgets.QWidget):
     """Sensors tab for displaying live sensor data"""
@@ -17,6 +25,9 @@ class SensorsTab(QtWidgets.QWidget):
         super().__init__(parent)
         self.settings = settings
         self.profile = profile
+        self.imu_ring = imu_stream.ImuRing()
+        self.imu_thread: imu_stream.ImuStreamThread = None
+        self._stream_error = ""
         
         self._setup_ui()
 
@@ -83,15 +94,122 @@ class SensorsTab(QtWidgets.QWidget):
         
         layout.addWidget(status_group)
         
-        # Live sensor data section
-        data_group = QtWidgets.QGroupBox("Live Sensor Data Stream")
+        # Live IMU stream section
+        data_group = QtWidgets.QGroupBox("Live IMU Stream")
         data_layout = QtWidgets.QVBoxLayout(data_group)
-        
-        sensor_text = QtWidgets.QTextBrowser()
-        sensor_text.setPlaceholderText("Live sensor data will appear here...")
-        data_layout.addWidget(sensor_text)
+
+        controls_layout = QtWidgets.QHBoxLayout()
+        self.source_combo = QtWidgets.QComboBox()
+        self.source_combo.addItems(["Command bus", "Capture file"])
+        self.source_combo.currentIndexChanged.connect(self._on_source_changed)
+        controls_layout.addWidget(self.source_combo)
+
+        self.source_edit = QtWidgets.QLineEdit(f"0x{imu_stream.SENSORS_I2C_ADDRESS:02X}")
+        controls_layout.addWidget(self.source_edit)
+        self.browse_button = QtWidgets.QPushButton("Browse...")
+        self.browse_button.clicked.connect(self._browse_capture)
+        self.browse_button.setVisible(False)
+        controls_layout.addWidget(self.browse_button)
+
+        self.stream_button = QtWidgets.QPushButton("Start")
+        self.stream_button.clicked.connect(self._toggle_stream)
+        controls_layout.addWidget(self.stream_button)
+
+        controls_layout.addWidget(QtWidgets.QLabel("Show:"))
+        self.channels_combo = QtWidgets.QComboBox()
+        self.channels_combo.addItems(["Accel", "Gyro"])
+        self.channels_combo.currentIndexChanged.connect(lambda i: self.imu_plot.set_channels(3 * i))
+        controls_layout.addWidget(self.channels_combo)
+
+        controls_layout.addWidget(QtWidgets.QLabel("Window:"))
+        self.window_combo = QtWidgets.QComboBox()
+        self.window_combo.addItems([f"{n} samples" for n in WINDOW_CHOICES])
+        self.window_combo.setCurrentIndex(1)
+        self.window_combo.currentIndexChanged.connect(lambda i: self.imu_plot.set_window(WINDOW_CHOICES[i]))
+        controls_layout.addWidget(self.window_combo)
+        controls_layout.addStretch()
+        data_layout.addLayout(controls_layout)
+
+        self.imu_plot = ImuPlot(self.imu_ring)
+        self.imu_plot.set_window(WINDOW_CHOICES[self.window_combo.currentIndex()])
+        data_layout.addWidget(self.imu_plot)
+
+        self.stream_stats_label = QtWidgets.QLabel("Not streaming")
+        data_layout.addWidget(self.stream_stats_label)
+        self._stats_timer = QtCore.QTimer(self)
+        self._stats_timer.timeout.connect(self._update_stream_stats)
         
         layout.addWidget(data_group)
+
+    def stop_stream(self):
+        """Stop the IMU stream, if it's running, and wait for its thread to finish."""
+        if self.imu_thread is not None:
+            self.imu_thread.stop()
+            self.imu_thread.wait()
+            self.imu_thread = None
+        self.imu_plot.stop()
+        self._stats_timer.stop()
+        self.stream_button.setText("Start")
+        self.source_combo.setEnabled(True)
+
+    def _on_source_changed(self, index: int):
+        """Switch between reading the command bus (an address) and a capture (a file)."""
+        from_file = index == 1
+        self.browse_button.setVisible(from_file)
+        self.source_edit.setText("" if from_file else f"0x{imu_stream.SENSORS_I2C_ADDRESS:02X}")
+
+    def _browse_capture(self):
+        """Choose a capture of raw history pages to play back."""
+        fpath, _ = QtWidgets.QFileDialog.getOpenFileName(self, "Open IMU Capture", "", "All Files (*)")
+        if fpath:
+            self.source_edit.setText(fpath)
+
+    def _toggle_stream(self):
+        """Start the IMU stream from the chosen source, or stop it."""
+        if self.imu_thread is not None:
+            self.stop_stream()
+            return
+
+        try:
+            if self.source_combo.currentIndex() == 0:
+                source = imu_stream.I2CPageSource(int(self.source_edit.text(), 0))
+            else:
+                source = imu_stream.FilePageSource(self.source_edit.text())
+        except ImportError:
+            self.stream_stats_label.setText("Streaming over the command bus needs artie_i2c, so only works on the controller.")
+            return
+        except (OSError, ValueError) as e:
+            self.stream_stats_label.setText(f"Can't open the stream: {e}")
+            return
+
+        self.imu_ring.clear()
+        self._stream_error = ""
+        self.imu_thread = imu_stream.ImuStreamThread(self, self.imu_ring, source)
+        self.imu_thread.error_signal.connect(self._on_stream_error)
+        self.imu_thread.finished.connect(self._on_stream_finished)
+        self.imu_thread.start()
+        self.imu_plot.start()
+        self._stats_timer.start(STATS_INTERVAL_MS)
+        self.stream_button.setText("Stop")
+        self.source_combo.setEnabled(False)
+
+    def _on_stream_error(self, error: str):
+        """Keep the stream's last error, to show with its figures."""
+        self._stream_error = error
+
+    def _on_stream_finished(self):
+        """The source ran out (the end of a capture)."""
+        if self.imu_thread is not None and self.imu_thread.isFinished():
+            self.stop_stream()
+            self._update_stream_stats()
+
+    def _update_stream_stats(self):
+        """Show the sample rate and how many samples were lost."""
+        rate = self.imu_ring.rate_hz(WINDOW_CHOICES[self.window_combo.currentIndex()])
+        text = f"{self.imu_ring.written} samples, {rate:.0f} Hz, {self.imu_ring.lost} lost"
+        if self._stream_error:
+            text += f" (last error: {self._stream_error})"
+        self.stream_stats_label.setText(text)
     
     def _refresh_status(self):
         """Force a status update."""
@@ -127,6 +127,9 @@ class MainWindow(QtWidgets.QMainWindow):
         progress.setMinimumDuration(0)  # Show immediately
         progress.show()
         
+        # Stop streaming sensor data
+        self.sensors_tab.stop_stream()
+
         # Close the status fetcher (may take time to stop threads)
         self.status_fetcher.close()
         while not self.status_fetcher_closed: